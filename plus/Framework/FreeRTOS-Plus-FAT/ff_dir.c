@@ -351,6 +351,14 @@ static BaseType_t FF_ShortNameExists( FF_IOManager_t * pxIOManager,
         BaseType_t xIndex;
     #endif /* ffconfigLFN_SUPPORT */
 
+    #if ( ffconfigEXFAT_SUPPORT != 0 )
+        if( pxIOManager->xPartition.ucType == FF_T_EXFAT )
+        {
+            /* exFAT entry sets are looked up by the hash of their name. */
+            return FF_exFATFindEntryInDir( pxIOManager, pxFindParams, pcName, pa_Attrib, pxDirEntry, pxError );
+        }
+    #endif
+
     #if ( ffconfigLFN_SUPPORT != 0 )
         {
             #if ( ffconfigUNICODE_UTF16_SUPPORT != 0 )
@@ -770,6 +778,20 @@ static BaseType_t FF_ShortNameExists( FF_IOManager_t * pxIOManager,
         #endif /* ffconfigPATH_CACHE */
     }
 
+    #if ( ffconfigEXFAT_SUPPORT != 0 )
+        {
+            /* A directory that is found in the path cache might not be in the
+             * location cache anymore, walk the path so that it is remembered. */
+            if( ( xFound != pdFALSE ) &&
+                ( pxIOManager->xPartition.ucType == FF_T_EXFAT ) &&
+                ( FF_exFATDirIsKnown( pxIOManager, xFindParams.ulDirCluster ) == pdFALSE ) )
+            {
+                xFound = pdFALSE;
+                xFindParams.ulDirCluster = pxIOManager->xPartition.ulRootDirCluster;
+            }
+        }
+    #endif
+
     if( xFound == pdFALSE )
     {
         pcToken = FF_strtok( pcPath, mytoken, &it, &last, pathLen );
@@ -1084,7 +1106,7 @@ FF_Error_t FF_InitEntryFetch( FF_IOManager_t * pxIOManager,
         pxContext->ulDirCluster = ulDirCluster;
         pxContext->ulCurrentClusterLCN = ulDirCluster;
 
-        if( pxIOManager->xPartition.ucType != FF_T_FAT32 )
+        if( FF_isFixedRootDirType( pxIOManager->xPartition.ucType ) )
         {
             /* Handle Root Dirs that don't have cluster chains! */
             if( pxContext->ulDirCluster == pxIOManager->xPartition.ulRootDirCluster )
@@ -1149,7 +1171,7 @@ static FF_Error_t FF_Traverse( FF_IOManager_t * pxIOManager,
     {
         xError = FF_ERR_DIR_END_OF_DIR | FF_TRAVERSE;   /* End of Dir was reached! */
     }
-    else if( ( pxIOManager->xPartition.ucType != FF_T_FAT32 ) &&
+    else if( FF_isFixedRootDirType( pxIOManager->xPartition.ucType ) &&
              ( pxContext->ulDirCluster == pxIOManager->xPartition.ulRootDirCluster ) )
     {
         /* Double-check if the entry number isn't too high. */
@@ -1204,7 +1226,7 @@ FF_Error_t FF_FetchEntryWithContext( FF_IOManager_t * pxIOManager,
         ulItemLBA = FF_Cluster2LBA( pxIOManager, pxContext->ulCurrentClusterLCN ) +
                     FF_getMajorBlockNumber( pxIOManager, ulEntry, ( uint32_t ) FF_SIZEOF_DIRECTORY_ENTRY );
 
-        if( ( pxIOManager->xPartition.ucType != FF_T_FAT32 ) &&
+        if( FF_isFixedRootDirType( pxIOManager->xPartition.ucType ) &&
             ( pxContext->ulDirCluster == pxIOManager->xPartition.ulRootDirCluster ) )
         {
             ulItemLBA += ( ulEntry / ( ( pxIOManager->xPartition.usBlkSize * pxIOManager->xPartition.ulSectorsPerCluster ) /
@@ -1262,7 +1284,7 @@ FF_Error_t FF_PushEntryWithContext( FF_IOManager_t * pxIOManager,
 
         ulItemLBA = FF_Cluster2LBA( pxIOManager, pxContext->ulCurrentClusterLCN ) + FF_getMajorBlockNumber( pxIOManager, ulEntry, ( uint32_t ) FF_SIZEOF_DIRECTORY_ENTRY );
 
-        if( ( pxIOManager->xPartition.ucType != FF_T_FAT32 ) &&
+        if( FF_isFixedRootDirType( pxIOManager->xPartition.ucType ) &&
             ( pxContext->ulDirCluster == pxIOManager->xPartition.ulRootDirCluster ) )
         {
             ulItemLBA += ( ulEntry /
@@ -1320,6 +1342,14 @@ FF_Error_t FF_GetEntry( FF_IOManager_t * pxIOManager,
     #if ( ffconfigLFN_SUPPORT == 0 )
         BaseType_t xLFNCount;
     #endif
+
+    #if ( ffconfigEXFAT_SUPPORT != 0 )
+        if( pxIOManager->xPartition.ucType == FF_T_EXFAT )
+        {
+            return FF_exFATGetEntry( pxIOManager, usEntry, ulDirCluster, pxDirEntry );
+        }
+    #endif
+
     xError = FF_InitEntryFetch( pxIOManager, ulDirCluster, &xFetchContext );
 
     if( FF_isERR( xError ) == pdFALSE )
@@ -1799,6 +1829,12 @@ FF_Error_t FF_FindNext( FF_IOManager_t * pxIOManager,
             xError = ( FF_Error_t ) ( FF_ERR_IOMAN_DRIVER_NOMEDIUM | FF_FINDNEXT );
         }
     #endif /* ffconfigREMOVABLE_MEDIA */
+    #if ( ffconfigEXFAT_SUPPORT != 0 )
+        else if( pxIOManager->xPartition.ucType == FF_T_EXFAT )
+        {
+            xError = FF_exFATFindNext( pxIOManager, pxDirEntry );
+        }
+    #endif
     else
     {
         xError = FF_ERR_NONE;
@@ -2125,6 +2161,14 @@ FF_Error_t FF_PutEntry( FF_IOManager_t * pxIOManager,
     uint8_t pucEntryBuffer[ FF_SIZEOF_DIRECTORY_ENTRY ];
     FF_FetchContext_t xFetchContext;
 
+    #if ( ffconfigEXFAT_SUPPORT != 0 )
+        if( pxIOManager->xPartition.ucType == FF_T_EXFAT )
+        {
+            /* exFAT has no "." and ".." entries, 'pucContents' is not used. */
+            return FF_exFATPutEntry( pxIOManager, usEntry, ulDirCluster, pxDirEntry );
+        }
+    #endif
+
     /* HT: use the standard access routine to get the same logic for root dirs. */
     xError = FF_InitEntryFetch( pxIOManager, ulDirCluster, &xFetchContext );
 
@@ -2807,7 +2851,7 @@ FF_Error_t FF_ExtendDirectory( FF_IOManager_t * pxIOManager,
     FF_FATBuffers_t xFATBuffers;
 
     if( ( ulDirCluster == pxIOManager->xPartition.ulRootDirCluster ) &&
-        ( pxIOManager->xPartition.ucType != FF_T_FAT32 ) )
+        FF_isFixedRootDirType( pxIOManager->xPartition.ucType ) )
     {
         /* root directories on FAT12 and FAT16 can not be extended. */
         xError = ( FF_Error_t ) ( FF_ERR_DIR_CANT_EXTEND_ROOT_DIR | FF_EXTENDDIRECTORY );
@@ -2938,6 +2982,13 @@ FF_Error_t FF_CreateDirent( FF_IOManager_t * pxIOManager,
         uint8_t ucCheckSum;
     #endif
 
+    #if ( ffconfigEXFAT_SUPPORT != 0 )
+        if( pxIOManager->xPartition.ucType == FF_T_EXFAT )
+        {
+            return FF_exFATCreateDirent( pxIOManager, pxFindParams, pxDirEntry );
+        }
+    #endif
+
     /* Round-up the number of LFN's needed: */
     xLFNCount = ( BaseType_t ) ( ( NameLen + 12 ) / 13 );
 
@@ -3126,7 +3177,18 @@ FF_Error_t FF_CreateDirent( FF_IOManager_t * pxIOManager,
     STRNCPY( xMyFile.pcFileName, pcFileName, ffconfigMAX_FILENAME  - 1 );
     xMyFile.pcFileName[ ffconfigMAX_FILENAME - 1 ] = 0;
 
-    xMyFile.ulObjectCluster = FF_CreateClusterChain( pxIOManager, &xError );
+    #if ( ffconfigEXFAT_SUPPORT != 0 )
+        if( pxIOManager->xPartition.ucType == FF_T_EXFAT )
+        {
+            /* An empty exFAT file has no clusters. The first write will
+             * allocate a contiguous run of clusters. */
+            xMyFile.ulObjectCluster = 0ul;
+        }
+        else
+    #endif
+    {
+        xMyFile.ulObjectCluster = FF_CreateClusterChain( pxIOManager, &xError );
+    }
 
     if( FF_isERR( xError ) == pdFALSE )
     {
@@ -3145,12 +3207,15 @@ FF_Error_t FF_CreateDirent( FF_IOManager_t * pxIOManager,
         {
             /* An error occurred in FF_CreateDirent().
              * Unlink the file's cluster chain: */
-            FF_LockFAT( pxIOManager );
+            if( xMyFile.ulObjectCluster != 0ul )
             {
-                FF_UnlinkClusterChain( pxIOManager, xMyFile.ulObjectCluster, 0 );
-                xMyFile.ulObjectCluster = 0ul;
+                FF_LockFAT( pxIOManager );
+                {
+                    FF_UnlinkClusterChain( pxIOManager, xMyFile.ulObjectCluster, 0 );
+                    xMyFile.ulObjectCluster = 0ul;
+                }
+                FF_UnlockFAT( pxIOManager );
             }
-            FF_UnlockFAT( pxIOManager );
         }
 
         /* Now flush all buffers to disk. */
@@ -3328,6 +3393,14 @@ FF_Error_t FF_CreateDirent( FF_IOManager_t * pxIOManager,
 
         xError = FF_ClearCluster( pxIOManager, xMyDirectory.ulObjectCluster );
 
+        #if ( ffconfigEXFAT_SUPPORT != 0 )
+            if( pxIOManager->xPartition.ucType == FF_T_EXFAT )
+            {
+                /* The length of an exFAT directory is stored in its entry. */
+                xMyDirectory.ulFileSize = ( uint32_t ) pxIOManager->xPartition.usBlkSize * pxIOManager->xPartition.ulSectorsPerCluster;
+            }
+        #endif
+
         if( FF_isERR( xError ) == pdFALSE )
         {
             xError = FF_CreateDirent( pxIOManager, &xFindParams, &xMyDirectory );
@@ -3344,6 +3417,17 @@ FF_Error_t FF_CreateDirent( FF_IOManager_t * pxIOManager,
             break;
         }
 
+        #if ( ffconfigEXFAT_SUPPORT != 0 )
+            if( pxIOManager->xPartition.ucType == FF_T_EXFAT )
+            {
+                /* exFAT directories have no "." and ".." entries. Remember
+                 * where the new entry is, so that the directory can grow. */
+                FF_exFATRememberDir( pxIOManager, xMyDirectory.ulObjectCluster, xFindParams.ulDirCluster, xMyDirectory.usCurrentItem );
+                FF_FlushCache( pxIOManager );
+                break;
+            }
+        #endif
+
         /* Write 8.3 entry "." */
         pucEntryBuffer[ 0 ] = '.';
         /* folowed by 10 spaces: */
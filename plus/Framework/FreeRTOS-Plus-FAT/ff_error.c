@@ -90,6 +90,7 @@
             { "FF_IncreaseFreeClusters",  FF_GETMOD_FUNC( FF_INCREASEFREECLUSTERS )  },
             { "FF_PartitionSearch",       FF_GETMOD_FUNC( FF_PARTITIONSEARCH )       },
             { "FF_ParseExtended",         FF_GETMOD_FUNC( FF_PARSEEXTENDED )         },
+            { "FF_exFATMount",            FF_GETMOD_FUNC( FF_EXFATMOUNT )            },
 
 
 /*----- FF_DIR - The FreeRTOS+FAT directory handling routines */
@@ -107,6 +108,8 @@
             { "FF_MkDir",                 FF_GETMOD_FUNC( FF_MKDIR )                 },
             { "FF_Traverse",              FF_GETMOD_FUNC( FF_TRAVERSE )              },
             { "FF_FindDir",               FF_GETMOD_FUNC( FF_FINDDIR )               },
+            { "FF_exFATFindEntry",        FF_GETMOD_FUNC( FF_EXFATFINDENTRY )        },
+            { "FF_exFATCreateDirent",     FF_GETMOD_FUNC( FF_EXFATCREATEDIRENT )     },
 
 /*----- FF_FILE - The FreeRTOS+FAT file handling routines */
             { "FF_GetModeBits",           FF_GETMOD_FUNC( FF_GETMODEBITS )           },
@@ -134,6 +137,7 @@
             { "FF_BytesLeft",             FF_GETMOD_FUNC( FF_BYTESLEFT )             },
             { "FF_SetFileTime",           FF_GETMOD_FUNC( FF_SETFILETIME )           },
             { "FF_InitBuf",               FF_GETMOD_FUNC( FF_INITBUF )               },
+            { "FF_DeferredDelete",        FF_GETMOD_FUNC( FF_DEFERREDDELETE )        },
 
 /*----- FF_FAT - The FreeRTOS+FAT FAT handling routines */
             { "FF_getFATEntry",           FF_GETMOD_FUNC( FF_GETFATENTRY )           },
@@ -141,6 +145,9 @@
             { "FF_putFATEntry",           FF_GETMOD_FUNC( FF_PUTFATENTRY )           },
             { "FF_FindFreeCluster",       FF_GETMOD_FUNC( FF_FINDFREECLUSTER )       },
             { "FF_CountFreeClusters",     FF_GETMOD_FUNC( FF_COUNTFREECLUSTERS )     },
+            { "FF_exFATFindFreeCluster",  FF_GETMOD_FUNC( FF_EXFATFINDFREECLUSTER )  },
+            { "FF_exFATSetBitmap",        FF_GETMOD_FUNC( FF_EXFATSETBITMAP )        },
+            { "FF_MirrorFATs",            FF_GETMOD_FUNC( FF_MIRRORFATS )            },
 
 /*----- FF_UNICODE - The FreeRTOS+FAT hashing routines */
             { "FF_Utf8ctoUtf16c",         FF_GETMOD_FUNC( FF_UTF8CTOUTF16C )         },
@@ -150,6 +157,7 @@
 
 /*----- FF_FORMAT - The FreeRTOS+FAT format routine */
             { "FF_FormatPartition",       FF_GETMOD_FUNC( FF_FORMATPARTITION )       },
+            { "FF_FormatExFAT",           FF_GETMOD_FUNC( FF_FORMATEXFAT )           },
 
 /*----- FF_STDIO - The FreeRTOS+FAT stdio front-end */
             { "ff_chmod",                 FF_GETMOD_FUNC( FF_CHMOD )                 },
@@ -210,6 +218,7 @@
         ERR_ENTRY( "Destination path (dir) was not found", FILE_DIR_NOT_FOUND ),
         ERR_ENTRY( "Failed to create the directory Entry", FILE_COULD_NOT_CREATE_DIRENT ),
         ERR_ENTRY( "A file handle was invalid", FILE_BAD_HANDLE ),
+        ERR_ENTRY( "The file is too large to be opened", FILE_TOO_LARGE ),
         #if ( ffconfigREMOVABLE_MEDIA != 0 )
             ERR_ENTRY( "File handle got invalid because media was removed", FILE_MEDIA_REMOVED ),
         #endif /* ffconfigREMOVABLE_MEDIA */
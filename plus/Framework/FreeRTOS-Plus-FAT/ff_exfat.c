@@ -0,0 +1,2200 @@
+/*
+ * FreeRTOS+FAT V2.3.3
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/**
+ *	@file		ff_exfat.c
+ *	@ingroup	EXFAT
+ *
+ *	@defgroup	EXFAT exFAT File-System
+ *	@brief		Mounting, the allocation bitmap, the up-case table and the
+ *              directory entry sets of exFAT volumes.
+ *
+ **/
+
+#include <string.h>
+
+#include "ff_headers.h"
+
+#if ( ffconfigEXFAT_SUPPORT != 0 )
+
+/* The attributes that can be stored in an exFAT file entry. */
+    #define exfatATTRIBUTE_MASK    ( FF_FAT_ATTR_READONLY | FF_FAT_ATTR_HIDDEN | FF_FAT_ATTR_SYSTEM | FF_FAT_ATTR_DIR | FF_FAT_ATTR_ARCHIVE )
+
+    #if ( ffconfigUNICODE_UTF16_SUPPORT != 0 )
+        typedef FF_T_WCHAR exFATChar_t;
+    #else
+        typedef char exFATChar_t;
+    #endif
+
+/* A complete entry set: the file entry, the stream extension entry and
+ * the name, which is collected from the file name entries. */
+    typedef struct
+    {
+        uint8_t ucFile[ FF_SIZEOF_DIRECTORY_ENTRY ];
+        uint8_t ucStream[ FF_SIZEOF_DIRECTORY_ENTRY ];
+        uint16_t usName[ ffconfigMAX_FILENAME ];
+        BaseType_t xNameLength; /* The number of characters stored in 'usName'. */
+        BaseType_t xValid;      /* pdTRUE when the types, the length and the checksum are correct. */
+    } exFATEntrySet_t;
+
+/*-----------------------------------------------------------*/
+
+    static FF_Error_t prvGetSector( FF_IOManager_t * pxIOManager,
+                                    FF_Buffer_t ** ppxBuffer,
+                                    uint32_t ulSector,
+                                    uint8_t ucMode,
+                                    FF_Error_t xFunction );
+
+    static FF_Error_t prvReleaseSector( FF_IOManager_t * pxIOManager,
+                                        FF_Buffer_t ** ppxBuffer,
+                                        FF_Error_t xError );
+
+    static uint32_t prvBitmapFind( FF_IOManager_t * pxIOManager,
+                                   uint32_t ulFrom,
+                                   uint32_t ulTo,
+                                   BaseType_t xInUse,
+                                   FF_Error_t * pxError );
+
+    static uint32_t prvBitmapFindRun( FF_IOManager_t * pxIOManager,
+                                      uint32_t ulFrom,
+                                      uint32_t ulTo,
+                                      uint32_t ulCount,
+                                      FF_Error_t * pxError );
+
+    static FF_Error_t prvReadUpcaseTable( FF_IOManager_t * pxIOManager,
+                                          uint32_t ulFirstChar,
+                                          uint16_t * pusTable,
+                                          uint32_t ulCount,
+                                          uint32_t * pulChecksum );
+
+    static uint16_t prvUpcase( FF_IOManager_t * pxIOManager,
+                               uint16_t usChar );
+
+    static uint16_t prvEntrySetChecksum( uint16_t usChecksum,
+                                         const uint8_t * pucEntry,
+                                         BaseType_t xIsPrimary );
+
+    static uint16_t prvNameHash( FF_IOManager_t * pxIOManager,
+                                 const uint16_t * pusName,
+                                 BaseType_t xLength );
+
+    static BaseType_t prvNameToUtf16( const exFATChar_t * pcName,
+                                      uint16_t * pusName );
+
+    static void prvNameFromUtf16( const uint16_t * pusName,
+                                  BaseType_t xLength,
+                                  exFATChar_t * pcName );
+
+    static FF_Error_t prvReadEntrySet( FF_IOManager_t * pxIOManager,
+                                       FF_FetchContext_t * pxContext,
+                                       uint32_t ulEntry,
+                                       exFATEntrySet_t * pxSet );
+
+    static void prvPopulateDirent( const exFATEntrySet_t * pxSet,
+                                   FF_DirEnt_t * pxDirEntry );
+
+    static BaseType_t prvFindDirLocation( FF_IOManager_t * pxIOManager,
+                                          uint32_t ulDirCluster,
+                                          FF_exFATDirLocation_t * pxLocation );
+
+    static FF_Error_t prvExtendDirectory( FF_IOManager_t * pxIOManager,
+                                          uint32_t ulDirCluster );
+
+    static FF_Error_t prvCheckBootRegion( FF_IOManager_t * pxIOManager );
+
+    static FF_Error_t prvScanRootDirectory( FF_IOManager_t * pxIOManager,
+                                            uint32_t * pulUpcaseChecksum );
+
+    static FF_Error_t prvCheckContiguous( FF_IOManager_t * pxIOManager,
+                                          uint32_t ulCluster,
+                                          uint32_t ulLength );
+
+    #if ( ffconfigTIME_SUPPORT != 0 )
+        static uint32_t prvPackTime( const FF_SystemTime_t * pxTime );
+        static void prvUnpackTime( FF_SystemTime_t * pxTime,
+                                   uint32_t ulTimeStamp );
+    #endif
+
+/*-----------------------------------------------------------*/
+
+/* Make sure that '*ppxBuffer' holds sector 'ulSector', in the mode 'ucMode'. */
+    static FF_Error_t prvGetSector( FF_IOManager_t * pxIOManager,
+                                    FF_Buffer_t ** ppxBuffer,
+                                    uint32_t ulSector,
+                                    uint8_t ucMode,
+                                    FF_Error_t xFunction )
+    {
+        FF_Error_t xError = FF_ERR_NONE;
+
+        if( ( *ppxBuffer != NULL ) && ( ( *ppxBuffer )->ulSector != ulSector ) )
+        {
+            xError = FF_ReleaseBuffer( pxIOManager, *ppxBuffer );
+            *ppxBuffer = NULL;
+        }
+
+        if( ( FF_isERR( xError ) == pdFALSE ) && ( *ppxBuffer == NULL ) )
+        {
+            *ppxBuffer = FF_GetBuffer( pxIOManager, ulSector, ucMode );
+
+            if( *ppxBuffer == NULL )
+            {
+                xError = ( FF_Error_t ) ( FF_ERR_DEVICE_DRIVER_FAILED | xFunction );
+            }
+        }
+
+        return xError;
+    }
+/*-----------------------------------------------------------*/
+
+/* Release the buffer obtained by prvGetSector(), without overwriting an earlier error. */
+    static FF_Error_t prvReleaseSector( FF_IOManager_t * pxIOManager,
+                                        FF_Buffer_t ** ppxBuffer,
+                                        FF_Error_t xError )
+    {
+        FF_Error_t xTempError;
+
+        if( *ppxBuffer != NULL )
+        {
+            xTempError = FF_ReleaseBuffer( pxIOManager, *ppxBuffer );
+            *ppxBuffer = NULL;
+
+            if( FF_isERR( xError ) == pdFALSE )
+            {
+                xError = xTempError;
+            }
+        }
+
+        return xError;
+    }
+/*-----------------------------------------------------------*/
+
+/*
+ * The rotating checksum of the boot region and of the up-case table.
+ * The volume flags and the percentage in use are left out of the boot
+ * sector, because they change while the volume is mounted.
+ */
+    uint32_t FF_exFATBootChecksum( uint32_t ulChecksum,
+                                   const uint8_t * pucSector,
+                                   size_t uxLength,
+                                   BaseType_t xIsBootSector )
+    {
+        size_t uxIndex;
+
+        for( uxIndex = 0; uxIndex < uxLength; uxIndex++ )
+        {
+            if( ( xIsBootSector != pdFALSE ) &&
+                ( ( uxIndex == FF_EXFAT_VOLUME_FLAGS ) ||
+                  ( uxIndex == ( FF_EXFAT_VOLUME_FLAGS + 1 ) ) ||
+                  ( uxIndex == FF_EXFAT_PERCENT_IN_USE ) ) )
+            {
+                continue;
+            }
+
+            ulChecksum = ( ( ( ulChecksum & 1UL ) != 0UL ) ? 0x80000000UL : 0UL ) + ( ulChecksum >> 1 ) + ( uint32_t ) pucSector[ uxIndex ];
+        }
+
+        return ulChecksum;
+    }
+/*-----------------------------------------------------------*/
+
+    uint32_t FF_exFATTableChecksum( uint32_t ulChecksum,
+                                    const uint8_t * pucData,
+                                    size_t uxLength )
+    {
+        return FF_exFATBootChecksum( ulChecksum, pucData, uxLength, pdFALSE );
+    }
+/*-----------------------------------------------------------*/
+
+/* The value of PercentInUse in the boot sector, rounded down. */
+    uint8_t FF_exFATPercentInUse( uint32_t ulUsedClusters,
+                                  uint32_t ulClusterCount )
+    {
+        uint8_t ucPercent = 0U;
+
+        if( ( ulClusterCount != 0UL ) && ( ulUsedClusters <= ulClusterCount ) )
+        {
+            ucPercent = ( uint8_t ) ( ( ( uint64_t ) ulUsedClusters * 100U ) / ulClusterCount );
+        }
+
+        return ucPercent;
+    }
+/*-----------------------------------------------------------*/
+
+/* The 16-bit checksum of an entry set, which leaves out the checksum field itself. */
+    static uint16_t prvEntrySetChecksum( uint16_t usChecksum,
+                                         const uint8_t * pucEntry,
+                                         BaseType_t xIsPrimary )
+    {
+        BaseType_t xIndex;
+
+        for( xIndex = 0; xIndex < FF_SIZEOF_DIRECTORY_ENTRY; xIndex++ )
+        {
+            if( ( xIsPrimary != pdFALSE ) &&
+                ( ( xIndex == FF_EXFAT_FILE_SET_CHECKSUM ) || ( xIndex == ( FF_EXFAT_FILE_SET_CHECKSUM + 1 ) ) ) )
+            {
+                continue;
+            }
+
+            usChecksum = ( uint16_t ) ( ( ( ( usChecksum & 1U ) != 0U ) ? 0x8000U : 0U ) + ( usChecksum >> 1 ) + pucEntry[ xIndex ] );
+        }
+
+        return usChecksum;
+    }
+/*-----------------------------------------------------------*/
+
+/* The hash of the up-cased name, stored in the stream extension entry.
+ * It allows to skip most entry sets without reading their names. */
+    static uint16_t prvNameHash( FF_IOManager_t * pxIOManager,
+                                 const uint16_t * pusName,
+                                 BaseType_t xLength )
+    {
+        uint16_t usHash = 0;
+        uint16_t usChar;
+        BaseType_t xIndex;
+
+        for( xIndex = 0; xIndex < xLength; xIndex++ )
+        {
+            usChar = prvUpcase( pxIOManager, pusName[ xIndex ] );
+            usHash = ( uint16_t ) ( ( ( ( usHash & 1U ) != 0U ) ? 0x8000U : 0U ) + ( usHash >> 1 ) + ( usChar & 0xFFU ) );
+            usHash = ( uint16_t ) ( ( ( ( usHash & 1U ) != 0U ) ? 0x8000U : 0U ) + ( usHash >> 1 ) + ( usChar >> 8 ) );
+        }
+
+        return usHash;
+    }
+/*-----------------------------------------------------------*/
+
+    #if ( ffconfigTIME_SUPPORT != 0 )
+
+/* An exFAT time stamp holds a FAT time in the low and a FAT date in the high 16 bits. */
+        static uint32_t prvPackTime( const FF_SystemTime_t * pxTime )
+        {
+            uint32_t ulYear = ( pxTime->Year >= 1980U ) ? ( uint32_t ) ( pxTime->Year - 1980U ) : 0UL;
+
+            return ( ulYear << 25 ) |
+                   ( ( uint32_t ) pxTime->Month << 21 ) |
+                   ( ( uint32_t ) pxTime->Day << 16 ) |
+                   ( ( uint32_t ) pxTime->Hour << 11 ) |
+                   ( ( uint32_t ) pxTime->Minute << 5 ) |
+                   ( ( uint32_t ) pxTime->Second / 2U );
+        }
+/*-----------------------------------------------------------*/
+
+        static void prvUnpackTime( FF_SystemTime_t * pxTime,
+                                   uint32_t ulTimeStamp )
+        {
+            pxTime->Year = ( uint16_t ) ( 1980U + ( ulTimeStamp >> 25 ) );
+            pxTime->Month = ( uint16_t ) ( ( ulTimeStamp >> 21 ) & 0x0FU );
+            pxTime->Day = ( uint16_t ) ( ( ulTimeStamp >> 16 ) & 0x1FU );
+            pxTime->Hour = ( uint16_t ) ( ( ulTimeStamp >> 11 ) & 0x1FU );
+            pxTime->Minute = ( uint16_t ) ( ( ulTimeStamp >> 5 ) & 0x3FU );
+            pxTime->Second = ( uint16_t ) ( ( ulTimeStamp & 0x1FU ) * 2U );
+        }
+    #endif /* ffconfigTIME_SUPPORT */
+/*-----------------------------------------------------------*/
+
+/*
+ * Convert a name to UTF-16. Returns the number of UTF-16 characters, or -1
+ * when the name does not fit in an exFAT entry set or in 'ffconfigMAX_FILENAME'.
+ */
+    static BaseType_t prvNameToUtf16( const exFATChar_t * pcName,
+                                      uint16_t * pusName )
+    {
+        BaseType_t xLength = 0;
+        BaseType_t xIndex = 0;
+
+        #if ( ffconfigUNICODE_UTF16_SUPPORT != 0 ) || ( ffconfigUNICODE_UTF8_SUPPORT != 0 )
+            int32_t lResult;
+        #endif
+
+        while( pcName[ xIndex ] != 0 )
+        {
+            if( xLength >= ( ffconfigMAX_FILENAME - 1 ) )
+            {
+                xLength = -1;
+                break;
+            }
+
+            #if ( ffconfigUNICODE_UTF16_SUPPORT != 0 )
+                {
+                    #if WCHAR_MAX <= 0xFFFF
+                        {
+                            pusName[ xLength ] = ( uint16_t ) pcName[ xIndex ];
+                            lResult = 1;
+                        }
+                    #else
+                        {
+                            lResult = FF_Utf32ctoUtf16c( &( pusName[ xLength ] ), ( uint32_t ) pcName[ xIndex ], ( uint32_t ) ( ffconfigMAX_FILENAME - 1 - xLength ) );
+                        }
+                    #endif
+
+                    if( FF_isERR( lResult ) )
+                    {
+                        xLength = -1;
+                        break;
+                    }
+
+                    xLength += lResult;
+                    xIndex++;
+                }
+            #elif ( ffconfigUNICODE_UTF8_SUPPORT != 0 )
+                {
+                    lResult = FF_Utf8ctoUtf16c( &( pusName[ xLength ] ), ( const uint8_t * ) &( pcName[ xIndex ] ), ( uint32_t ) ( ffconfigMAX_FILENAME - 1 - xLength ) );
+
+                    if( FF_isERR( lResult ) )
+                    {
+                        xLength = -1;
+                        break;
+                    }
+
+                    /* A 4-byte sequence becomes a surrogate pair. */
+                    xLength += ( lResult == 4 ) ? 2 : 1;
+                    xIndex += lResult;
+                }
+            #else /* if ( ffconfigUNICODE_UTF16_SUPPORT != 0 ) */
+                {
+                    pusName[ xLength ] = ( uint16_t ) ( uint8_t ) pcName[ xIndex ];
+                    xLength++;
+                    xIndex++;
+                }
+            #endif /* if ( ffconfigUNICODE_UTF16_SUPPORT != 0 ) */
+        }
+
+        if( xLength > FF_EXFAT_MAX_NAME_LENGTH )
+        {
+            xLength = -1;
+        }
+
+        return xLength;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvNameFromUtf16( const uint16_t * pusName,
+                                  BaseType_t xLength,
+                                  exFATChar_t * pcName )
+    {
+        BaseType_t xIndex = 0;
+        BaseType_t xOutput = 0;
+
+        #if ( ffconfigUNICODE_UTF8_SUPPORT != 0 )
+            int32_t lResult;
+        #endif
+
+        while( ( xIndex < xLength ) && ( xOutput < ( ffconfigMAX_FILENAME - 1 ) ) )
+        {
+            #if ( ffconfigUNICODE_UTF16_SUPPORT != 0 )
+                {
+                    pcName[ xOutput++ ] = ( FF_T_WCHAR ) pusName[ xIndex++ ];
+                }
+            #elif ( ffconfigUNICODE_UTF8_SUPPORT != 0 )
+                {
+                    if( ( ( pusName[ xIndex ] & 0xF800U ) == 0xD800U ) && ( ( xIndex + 1 ) >= xLength ) )
+                    {
+                        /* A surrogate pair was cut off. */
+                        break;
+                    }
+
+                    lResult = FF_Utf16ctoUtf8c( ( uint8_t * ) &( pcName[ xOutput ] ), &( pusName[ xIndex ] ), ( uint32_t ) ( ffconfigMAX_FILENAME - 1 - xOutput ) );
+
+                    if( FF_isERR( lResult ) )
+                    {
+                        break;
+                    }
+
+                    xIndex += ( ( pusName[ xIndex ] & 0xF800U ) == 0xD800U ) ? 2 : 1;
+                    xOutput += lResult;
+                }
+            #else /* if ( ffconfigUNICODE_UTF16_SUPPORT != 0 ) */
+                {
+                    /* Without Unicode support, only the low byte is kept, as is done for long file names. */
+                    pcName[ xOutput++ ] = ( char ) pusName[ xIndex++ ];
+                }
+            #endif /* if ( ffconfigUNICODE_UTF16_SUPPORT != 0 ) */
+        }
+
+        pcName[ xOutput ] = 0;
+    }
+/*-----------------------------------------------------------*/
+
+/*
+ * Walk through the compressed up-case table on the disk. The mappings of the
+ * characters 'ulFirstChar' up to 'ulFirstChar + ulCount' are stored in
+ * 'pusTable'. When 'pulChecksum' is not NULL, the complete table is read and
+ * its checksum is calculated.
+ */
+    static FF_Error_t prvReadUpcaseTable( FF_IOManager_t * pxIOManager,
+                                          uint32_t ulFirstChar,
+                                          uint16_t * pusTable,
+                                          uint32_t ulCount,
+                                          uint32_t * pulChecksum )
+    {
+        FF_Partition_t * pxPartition = &( pxIOManager->xPartition );
+        FF_Buffer_t * pxBuffer = NULL;
+        FF_Error_t xError = FF_ERR_NONE;
+        uint32_t ulLBA = FF_getRealLBA( pxIOManager, FF_Cluster2LBA( pxIOManager, pxPartition->ulUpcaseCluster ) );
+        uint32_t ulLastChar = ulFirstChar + ulCount;
+        uint32_t ulChar = 0;
+        uint32_t ulChecksum = 0;
+        uint32_t ulOffset;
+        uint32_t ulIndex;
+        const uint8_t * pucValue;
+        uint16_t usValue;
+        BaseType_t xSkipping = pdFALSE;
+
+        for( ulIndex = 0; ulIndex < ulCount; ulIndex++ )
+        {
+            pusTable[ ulIndex ] = ( uint16_t ) ( ulFirstChar + ulIndex );
+        }
+
+        for( ulOffset = 0; ( ulOffset + 1 ) < pxPartition->ulUpcaseLength; ulOffset += 2 )
+        {
+            if( ( pulChecksum == NULL ) && ( ulChar >= ulLastChar ) )
+            {
+                break;
+            }
+
+            xError = prvGetSector( pxIOManager, &pxBuffer, ulLBA + ( ulOffset / pxIOManager->usSectorSize ), FF_MODE_READ, FF_EXFATMOUNT );
+
+            if( FF_isERR( xError ) )
+            {
+                break;
+            }
+
+            pucValue = pxBuffer->pucBuffer + ( ulOffset % pxIOManager->usSectorSize );
+            usValue = FF_getShort( pucValue, 0 );
+
+            if( pulChecksum != NULL )
+            {
+                ulChecksum = FF_exFATTableChecksum( ulChecksum, pucValue, 2 );
+            }
+
+            if( xSkipping != pdFALSE )
+            {
+                /* 0xFFFF followed by a count: that many characters map to themselves. */
+                ulChar += usValue;
+                xSkipping = pdFALSE;
+            }
+            else if( usValue == 0xFFFFU )
+            {
+                xSkipping = pdTRUE;
+            }
+            else
+            {
+                if( ( ulChar >= ulFirstChar ) && ( ulChar < ulLastChar ) )
+                {
+                    pusTable[ ulChar - ulFirstChar ] = usValue;
+                }
+
+                ulChar++;
+            }
+        }
+
+        xError = prvReleaseSector( pxIOManager, &pxBuffer, xError );
+
+        if( pulChecksum != NULL )
+        {
+            *pulChecksum = ulChecksum;
+        }
+
+        return xError;
+    }
+/*-----------------------------------------------------------*/
+
+    static uint16_t prvUpcase( FF_IOManager_t * pxIOManager,
+                               uint16_t usChar )
+    {
+        uint16_t usResult;
+
+        if( usChar < ffconfigEXFAT_UPCASE_CACHE )
+        {
+            usResult = pxIOManager->xPartition.usUpcase[ usChar ];
+        }
+        else if( FF_isERR( prvReadUpcaseTable( pxIOManager, usChar, &usResult, 1, NULL ) ) )
+        {
+            /* The table can not be read, compare the character as it is. */
+            usResult = usChar;
+        }
+        else
+        {
+            /* The character was mapped by prvReadUpcaseTable(). */
+        }
+
+        return usResult;
+    }
+/*-----------------------------------------------------------*/
+
+/*
+ * Look for the first cluster in the range [ulFrom, ulTo) that is in use
+ * ( xInUse = pdTRUE ) or free ( xInUse = pdFALSE ). Returns 0 when there is
+ * no such cluster. Bytes that can not contain a match are skipped at once.
+ */
+    static uint32_t prvBitmapFind( FF_IOManager_t * pxIOManager,
+                                   uint32_t ulFrom,
+                                   uint32_t ulTo,
+                                   BaseType_t xInUse,
+                                   FF_Error_t * pxError )
+    {
+        FF_Buffer_t * pxBuffer = NULL;
+        FF_Error_t xError = FF_ERR_NONE;
+        const uint32_t ulBitsPerSector = ( uint32_t ) pxIOManager->usSectorSize * 8UL;
+        const uint8_t ucSkipValue = ( xInUse != pdFALSE ) ? 0x00U : 0xFFU;
+        uint32_t ulResult = 0;
+        uint32_t ulIndex;
+        uint8_t ucByte;
+
+        for( ulIndex = ulFrom - 2; ulIndex < ( ulTo - 2 ); )
+        {
+            xError = prvGetSector( pxIOManager, &pxBuffer, pxIOManager->xPartition.ulBitmapLBA + ( ulIndex / ulBitsPerSector ), FF_MODE_READ, FF_EXFATFINDFREECLUSTER );
+
+            if( FF_isERR( xError ) )
+            {
+                break;
+            }
+
+            ucByte = pxBuffer->pucBuffer[ ( ulIndex / 8UL ) % pxIOManager->usSectorSize ];
+
+            if( ( ( ulIndex % 8UL ) == 0UL ) && ( ucByte == ucSkipValue ) )
+            {
+                ulIndex += 8UL;
+                continue;
+            }
+
+            if( ( ( ucByte & ( 1U << ( ulIndex % 8UL ) ) ) != 0U ) == ( xInUse != pdFALSE ) )
+            {
+                ulResult = ulIndex + 2UL;
+                break;
+            }
+
+            ulIndex++;
+        }
+
+        *pxError = prvReleaseSector( pxIOManager, &pxBuffer, xError );
+
+        if( FF_isERR( *pxError ) )
+        {
+            ulResult = 0;
+        }
+
+        return ulResult;
+    }
+/*-----------------------------------------------------------*/
+
+/* Look for 'ulCount' free clusters in a row within [ulFrom, ulTo). Returns 0 when there is no such run. */
+    static uint32_t prvBitmapFindRun( FF_IOManager_t * pxIOManager,
+                                      uint32_t ulFrom,
+                                      uint32_t ulTo,
+                                      uint32_t ulCount,
+                                      FF_Error_t * pxError )
+    {
+        uint32_t ulStart = ulFrom;
+        uint32_t ulUsed;
+        uint32_t ulResult = 0;
+
+        *pxError = FF_ERR_NONE;
+
+        while( ( ulStart < ulTo ) && ( ulCount <= ( ulTo - ulStart ) ) )
+        {
+            ulStart = prvBitmapFind( pxIOManager, ulStart, ulTo, pdFALSE, pxError );
+
+            if( ( ulStart == 0UL ) || ( FF_isERR( *pxError ) ) || ( ulCount > ( ulTo - ulStart ) ) )
+            {
+                break;
+            }
+
+            ulUsed = prvBitmapFind( pxIOManager, ulStart, ulStart + ulCount, pdTRUE, pxError );
+
+            if( FF_isERR( *pxError ) )
+            {
+                break;
+            }
+
+            if( ulUsed == 0UL )
+            {
+                ulResult = ulStart;
+                break;
+            }
+
+            /* Continue behind the cluster that interrupted the run. */
+            ulStart = ulUsed + 1UL;
+        }
+
+        return ulResult;
+    }
+/*-----------------------------------------------------------*/
+
+/*
+ * Find a free cluster in the allocation bitmap, starting at the last free
+ * cluster that is known. The FAT must be locked.
+ */
+    uint32_t FF_exFATFindFreeCluster( FF_IOManager_t * pxIOManager,
+                                      FF_Error_t * pxError )
+    {
+        FF_Partition_t * pxPartition = &( pxIOManager->xPartition );
+        uint32_t ulStart = pxPartition->ulLastFreeCluster;
+        uint32_t ulCluster;
+
+        if( ( ulStart < 2UL ) || ( ulStart >= pxPartition->ulNumClusters ) )
+        {
+            ulStart = 2UL;
+        }
+
+        ulCluster = prvBitmapFind( pxIOManager, ulStart, pxPartition->ulNumClusters, pdFALSE, pxError );
+
+        if( ( ulCluster == 0UL ) && ( FF_isERR( *pxError ) == pdFALSE ) && ( ulStart > 2UL ) )
+        {
+            /* Wrap around to the start of the cluster heap. */
+            ulCluster = prvBitmapFind( pxIOManager, 2UL, ulStart, pdFALSE, pxError );
+        }
+
+        if( ( ulCluster == 0UL ) && ( FF_isERR( *pxError ) == pdFALSE ) )
+        {
+            *pxError = ( FF_Error_t ) ( FF_ERR_IOMAN_NOT_ENOUGH_FREE_SPACE | FF_EXFATFINDFREECLUSTER );
+        }
+
+        return ulCluster;
+    }
+/*-----------------------------------------------------------*/
+
+/* Count the clear bits of the allocation bitmap. The FAT must be locked. */
+    uint32_t FF_exFATCountFreeClusters( FF_IOManager_t * pxIOManager,
+                                        FF_Error_t * pxError )
+    {
+        FF_Buffer_t * pxBuffer = NULL;
+        FF_Error_t xError = FF_ERR_NONE;
+        const uint32_t ulClusters = pxIOManager->xPartition.ulNumClusters - 2UL;
+        const uint32_t ulBytes = ( ulClusters + 7UL ) / 8UL;
+        uint32_t ulUsed = 0;
+        uint32_t ulByte;
+        uint8_t ucByte;
+
+        for( ulByte = 0; ulByte < ulBytes; ulByte++ )
+        {
+            xError = prvGetSector( pxIOManager, &pxBuffer, pxIOManager->xPartition.ulBitmapLBA + ( ulByte / pxIOManager->usSectorSize ), FF_MODE_READ, FF_EXFATFINDFREECLUSTER );
+
+            if( FF_isERR( xError ) )
+            {
+                break;
+            }
+
+            ucByte = pxBuffer->pucBuffer[ ulByte % pxIOManager->usSectorSize ];
+
+            if( ( ulByte == ( ulBytes - 1UL ) ) && ( ( ulClusters % 8UL ) != 0UL ) )
+            {
+                /* Ignore the bits behind the last cluster. */
+                ucByte &= ( uint8_t ) ( ( 1U << ( ulClusters % 8UL ) ) - 1U );
+            }
+
+            while( ucByte != 0U )
+            {
+                ulUsed++;
+                ucByte &= ( uint8_t ) ( ucByte - 1U );
+            }
+        }
+
+        *pxError = prvReleaseSector( pxIOManager, &pxBuffer, xError );
+
+        return FF_isERR( *pxError ) ? 0UL : ( ulClusters - ulUsed );
+    }
+/*-----------------------------------------------------------*/
+
+/* Mark 'ulCount' clusters as used or as free. The FAT must be locked. */
+    FF_Error_t FF_exFATSetBitmap( FF_IOManager_t * pxIOManager,
+                                  uint32_t ulCluster,
+                                  uint32_t ulCount,
+                                  BaseType_t xInUse )
+    {
+        FF_Buffer_t * pxBuffer = NULL;
+        FF_Error_t xError = FF_ERR_NONE;
+        const uint32_t ulBitsPerSector = ( uint32_t ) pxIOManager->usSectorSize * 8UL;
+        uint32_t ulIndex;
+        uint32_t ulLast;
+        uint8_t * pucByte;
+
+        FF_Assert_Lock( pxIOManager, FF_FAT_LOCK );
+
+        if( ( ulCluster < 2UL ) || ( ulCluster >= pxIOManager->xPartition.ulNumClusters ) ||
+            ( ulCount > ( pxIOManager->xPartition.ulNumClusters - ulCluster ) ) )
+        {
+            xError = ( FF_Error_t ) ( FF_ERR_IOMAN_OUT_OF_BOUNDS_WRITE | FF_EXFATSETBITMAP );
+        }
+        else
+        {
+            ulLast = ulCluster - 2UL + ulCount;
+
+            for( ulIndex = ulCluster - 2UL; ulIndex < ulLast; )
+            {
+                xError = prvGetSector( pxIOManager, &pxBuffer, pxIOManager->xPartition.ulBitmapLBA + ( ulIndex / ulBitsPerSector ), FF_MODE_WRITE, FF_EXFATSETBITMAP );
+
+                if( FF_isERR( xError ) )
+                {
+                    break;
+                }
+
+                pucByte = &( pxBuffer->pucBuffer[ ( ulIndex / 8UL ) % pxIOManager->usSectorSize ] );
+
+                if( ( ( ulIndex % 8UL ) == 0UL ) && ( ( ulLast - ulIndex ) >= 8UL ) )
+                {
+                    /* A whole byte at once. */
+                    *pucByte = ( xInUse != pdFALSE ) ? 0xFFU : 0x00U;
+                    ulIndex += 8UL;
+                }
+                else
+                {
+                    if( xInUse != pdFALSE )
+                    {
+                        *pucByte |= ( uint8_t ) ( 1U << ( ulIndex % 8UL ) );
+                    }
+                    else
+                    {
+                        *pucByte &= ( uint8_t ) ~( 1U << ( ulIndex % 8UL ) );
+                    }
+
+                    ulIndex++;
+                }
+            }
+
+            xError = prvReleaseSector( pxIOManager, &pxBuffer, xError );
+        }
+
+        return xError;
+    }
+/*-----------------------------------------------------------*/
+
+/*
+ * Claim 'ulCount' contiguous clusters in the bitmap, without writing FAT
+ * entries. When 'ulCluster' is not zero, exactly those clusters are wanted,
+ * which is used to extend a contiguous file. Returns the first cluster, or
+ * zero when no run was found. The FAT must be locked, the caller will call
+ * FF_DecreaseFreeClusters().
+ */
+    uint32_t FF_exFATClaimContiguous( FF_IOManager_t * pxIOManager,
+                                      uint32_t ulCluster,
+                                      uint32_t ulCount,
+                                      FF_Error_t * pxError )
+    {
+        FF_Partition_t * pxPartition = &( pxIOManager->xPartition );
+        uint32_t ulResult = 0;
+        uint32_t ulStart;
+
+        *pxError = FF_ERR_NONE;
+
+        if( ulCluster != 0UL )
+        {
+            if( ( ulCluster >= 2UL ) && ( ulCluster < pxPartition->ulNumClusters ) &&
+                ( ulCount <= ( pxPartition->ulNumClusters - ulCluster ) ) &&
+                ( prvBitmapFind( pxIOManager, ulCluster, ulCluster + ulCount, pdTRUE, pxError ) == 0UL ) &&
+                ( FF_isERR( *pxError ) == pdFALSE ) )
+            {
+                ulResult = ulCluster;
+            }
+        }
+        else
+        {
+            ulStart = pxPartition->ulLastFreeCluster;
+
+            if( ( ulStart < 2UL ) || ( ulStart >= pxPartition->ulNumClusters ) )
+            {
+                ulStart = 2UL;
+            }
+
+            ulResult = prvBitmapFindRun( pxIOManager, ulStart, pxPartition->ulNumClusters, ulCount, pxError );
+
+            if( ( ulResult == 0UL ) && ( FF_isERR( *pxError ) == pdFALSE ) && ( ulStart > 2UL ) )
+            {
+                ulResult = prvBitmapFindRun( pxIOManager, 2UL, pxPartition->ulNumClusters, ulCount, pxError );
+            }
+        }
+
+        if( ( ulResult != 0UL ) && ( FF_isERR( *pxError ) == pdFALSE ) )
+        {
+            *pxError = FF_exFATSetBitmap( pxIOManager, ulResult, ulCount, pdTRUE );
+
+            if( FF_isERR( *pxError ) == pdFALSE )
+            {
+                pxPartition->ulLastFreeCluster = ulResult + ulCount;
+            }
+        }
+
+        if( FF_isERR( *pxError ) )
+        {
+            ulResult = 0;
+        }
+
+        return ulResult;
+    }
+/*-----------------------------------------------------------*/
+
+/* Free clusters of a contiguous file, which have no FAT entries. */
+    FF_Error_t FF_exFATFreeClusters( FF_IOManager_t * pxIOManager,
+                                     uint32_t ulCluster,
+                                     uint32_t ulCount )
+    {
+        FF_Error_t xError;
+        FF_Error_t xTempError;
+        BaseType_t xTakeLock = FF_Has_Lock( pxIOManager, FF_FAT_LOCK ) == pdFALSE;
+
+        if( xTakeLock )
+        {
+            FF_LockFAT( pxIOManager );
+        }
+
+        xError = FF_exFATSetBitmap( pxIOManager, ulCluster, ulCount, pdFALSE );
+
+        if( ( FF_isERR( xError ) == pdFALSE ) && ( pxIOManager->xPartition.ulLastFreeCluster > ulCluster ) )
+        {
+            pxIOManager->xPartition.ulLastFreeCluster = ulCluster;
+        }
+
+        if( xTakeLock )
+        {
+            FF_UnlockFAT( pxIOManager );
+        }
+
+        if( ( FF_isERR( xError ) == pdFALSE ) && ( ulCount != 0UL ) )
+        {
+            xTempError = FF_IncreaseFreeClusters( pxIOManager, ulCount );
+
+            if( FF_isERR( xError ) == pdFALSE )
+            {
+                xError = xTempError;
+            }
+        }
+
+        return xError;
+    }
+/*-----------------------------------------------------------*/
+
+/*
+ * Write the FAT chain of a contiguous run, which is needed when a contiguous
+ * file can not grow in place and gets fragmented.
+ */
+    FF_Error_t FF_exFATWriteChain( FF_IOManager_t * pxIOManager,
+                                   uint32_t ulCluster,
+                                   uint32_t ulCount )
+    {
+        FF_Error_t xError = FF_ERR_NONE;
+        FF_Error_t xTempError;
+        FF_FATBuffers_t xFATBuffers;
+        uint32_t ulIndex;
+        uint32_t ulNext;
+        BaseType_t xTakeLock = FF_Has_Lock( pxIOManager, FF_FAT_LOCK ) == pdFALSE;
+
+        if( xTakeLock )
+        {
+            FF_LockFAT( pxIOManager );
+        }
+
+        FF_InitFATBuffers( &xFATBuffers, FF_MODE_WRITE );
+
+        for( ulIndex = 0; ulIndex < ulCount; ulIndex++ )
+        {
+            ulNext = ( ( ulIndex + 1UL ) < ulCount ) ? ( ulCluster + ulIndex + 1UL ) : 0xFFFFFFFFUL;
+            xError = FF_putFATEntry( pxIOManager, ulCluster + ulIndex, ulNext, &xFATBuffers );
+
+            if( FF_isERR( xError ) )
+            {
+                break;
+            }
+        }
+
+        xTempError = FF_ReleaseFATBuffers( pxIOManager, &xFATBuffers );
+
+        if( FF_isERR( xError ) == pdFALSE )
+        {
+            xError = xTempError;
+        }
+
+        if( xTakeLock )
+        {
+            FF_UnlockFAT( pxIOManager );
+        }
+
+        return xError;
+    }
+/*-----------------------------------------------------------*/
+
+/*
+ * Read the entry set that starts with the file entry at 'ulEntry'. An entry set
+ * that is damaged or cut off is returned with 'xValid' = pdFALSE.
+ */
+    static FF_Error_t prvReadEntrySet( FF_IOManager_t * pxIOManager,
+                                       FF_FetchContext_t * pxContext,
+                                       uint32_t ulEntry,
+                                       exFATEntrySet_t * pxSet )
+    {
+        uint8_t ucEntry[ FF_SIZEOF_DIRECTORY_ENTRY ];
+        FF_Error_t xError;
+        BaseType_t xCount;
+        BaseType_t xIndex;
+        BaseType_t xChar;
+        BaseType_t xNameLength = 0;
+        uint16_t usChecksum;
+
+        pxSet->xValid = pdFALSE;
+        pxSet->xNameLength = 0;
+
+        xError = FF_FetchEntryWithContext( pxIOManager, ulEntry, pxContext, pxSet->ucFile );
+        xCount = ( BaseType_t ) pxSet->ucFile[ FF_EXFAT_FILE_SECONDARY_COUNT ];
+
+        if( ( FF_isERR( xError ) == pdFALSE ) &&
+            ( pxSet->ucFile[ 0 ] == FF_EXFAT_TYPE_FILE ) &&
+            ( xCount >= 2 ) &&
+            ( xCount <= 18 ) &&
+            ( ( ulEntry + ( uint32_t ) xCount ) < FF_MAX_ENTRIES_PER_DIRECTORY ) )
+        {
+            usChecksum = prvEntrySetChecksum( 0, pxSet->ucFile, pdTRUE );
+
+            for( xIndex = 1; xIndex <= xCount; xIndex++ )
+            {
+                xError = FF_FetchEntryWithContext( pxIOManager, ulEntry + ( uint32_t ) xIndex, pxContext, ucEntry );
+
+                if( FF_isERR( xError ) )
+                {
+                    break;
+                }
+
+                usChecksum = prvEntrySetChecksum( usChecksum, ucEntry, pdFALSE );
+
+                if( xIndex == 1 )
+                {
+                    if( ucEntry[ 0 ] != FF_EXFAT_TYPE_STREAM )
+                    {
+                        break;
+                    }
+
+                    memcpy( pxSet->ucStream, ucEntry, sizeof( pxSet->ucStream ) );
+                    xNameLength = ( BaseType_t ) ucEntry[ FF_EXFAT_STREAM_NAME_LENGTH ];
+                }
+                else if( ucEntry[ 0 ] == FF_EXFAT_TYPE_NAME )
+                {
+                    for( xChar = 0; xChar < FF_EXFAT_CHARS_PER_NAME_ENTRY; xChar++ )
+                    {
+                        if( ( pxSet->xNameLength >= xNameLength ) ||
+                            ( pxSet->xNameLength >= ( ffconfigMAX_FILENAME - 1 ) ) )
+                        {
+                            break;
+                        }
+
+                        pxSet->usName[ pxSet->xNameLength++ ] = FF_getShort( ucEntry, ( uint32_t ) ( FF_EXFAT_NAME_CHARS + ( 2 * xChar ) ) );
+                    }
+                }
+                else
+                {
+                    /* Other secondary entries are only part of the checksum. */
+                }
+            }
+
+            if( FF_GETERROR( xError ) == FF_ERR_DIR_END_OF_DIR )
+            {
+                /* The entry set is cut off by the end of the directory. */
+                xError = FF_ERR_NONE;
+            }
+            else if( ( FF_isERR( xError ) == pdFALSE ) &&
+                     ( xIndex > xCount ) &&
+                     ( usChecksum == FF_getShort( pxSet->ucFile, FF_EXFAT_FILE_SET_CHECKSUM ) ) )
+            {
+                pxSet->xValid = pdTRUE;
+            }
+            else
+            {
+                /* An invalid entry set, it will be skipped. */
+            }
+        }
+
+        return xError;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvPopulateDirent( const exFATEntrySet_t * pxSet,
+                                   FF_DirEnt_t * pxDirEntry )
+    {
+        uint32_t ulSizeHigh = FF_getLong( pxSet->ucStream, FF_EXFAT_STREAM_DATA_LENGTH + 4 );
+
+        pxDirEntry->ucAttrib = ( uint8_t ) ( FF_getShort( pxSet->ucFile, FF_EXFAT_FILE_ATTRIBUTES ) & exfatATTRIBUTE_MASK );
+        pxDirEntry->ulObjectCluster = FF_getLong( pxSet->ucStream, FF_EXFAT_STREAM_FIRST_CLUSTER );
+        pxDirEntry->ucStreamFlags = pxSet->ucStream[ FF_EXFAT_STREAM_FLAGS ];
+        pxDirEntry->ulFileSizeHigh = ulSizeHigh;
+
+        /* Files of 4 GB and more can be listed, but they can not be opened. */
+        if( ulSizeHigh != 0UL )
+        {
+            pxDirEntry->ulFileSize = 0xFFFFFFFFUL;
+        }
+        else
+        {
+            pxDirEntry->ulFileSize = FF_getLong( pxSet->ucStream, FF_EXFAT_STREAM_DATA_LENGTH );
+        }
+
+        if( FF_getLong( pxSet->ucStream, FF_EXFAT_STREAM_VALID_LENGTH + 4 ) != 0UL )
+        {
+            pxDirEntry->ulValidDataLength = 0xFFFFFFFFUL;
+        }
+        else
+        {
+            pxDirEntry->ulValidDataLength = FF_getLong( pxSet->ucStream, FF_EXFAT_STREAM_VALID_LENGTH );
+        }
+
+        #if ( ffconfigTIME_SUPPORT != 0 )
+            {
+                prvUnpackTime( &( pxDirEntry->xCreateTime ), FF_getLong( pxSet->ucFile, FF_EXFAT_FILE_CREATE_TIME ) );
+                prvUnpackTime( &( pxDirEntry->xModifiedTime ), FF_getLong( pxSet->ucFile, FF_EXFAT_FILE_MODIFY_TIME ) );
+                prvUnpackTime( &( pxDirEntry->xAccessedTime ), FF_getLong( pxSet->ucFile, FF_EXFAT_FILE_ACCESS_TIME ) );
+            }
+        #endif
+
+        prvNameFromUtf16( pxSet->usName, pxSet->xNameLength, pxDirEntry->pcFileName );
+
+        #if ( ffconfigLFN_SUPPORT != 0 ) && ( ffconfigINCLUDE_SHORT_NAME != 0 )
+            {
+                /* exFAT has no short names. */
+                pxDirEntry->pcShortName[ 0 ] = '\0';
+            }
+        #endif
+    }
+/*-----------------------------------------------------------*/
+
+/*
+ * Look up a name in a directory. The name hash in the stream extension
+ * entry is compared first, only matching sets are read completely.
+ * A directory that is stored as a contiguous run gets a FAT chain here,
+ * because the directory routines follow the FAT.
+ */
+    #if ( ffconfigUNICODE_UTF16_SUPPORT != 0 )
+        uint32_t FF_exFATFindEntryInDir( FF_IOManager_t * pxIOManager,
+                                         FF_FindParams_t * pxFindParams,
+                                         const FF_T_WCHAR * pcName,
+                                         uint8_t ucAttrib,
+                                         FF_DirEnt_t * pxDirEntry,
+                                         FF_Error_t * pxError )
+    #else
+        uint32_t FF_exFATFindEntryInDir( FF_IOManager_t * pxIOManager,
+                                         FF_FindParams_t * pxFindParams,
+                                         const char * pcName,
+                                         uint8_t ucAttrib,
+                                         FF_DirEnt_t * pxDirEntry,
+                                         FF_Error_t * pxError )
+    #endif
+    {
+        FF_FetchContext_t xFetchContext;
+        exFATEntrySet_t xSet;
+        uint16_t usSearch[ ffconfigMAX_FILENAME ];
+        uint8_t ucEntry[ FF_SIZEOF_DIRECTORY_ENTRY ];
+        FF_Error_t xError = FF_ERR_NONE;
+        FF_Error_t xTempError;
+        BaseType_t xLength;
+        BaseType_t xIndex;
+        BaseType_t xFound = pdFALSE;
+        uint32_t ulEntry;
+        uint32_t ulResult = 0;
+        uint32_t ulClusterSize;
+        uint16_t usHash;
+
+        pxDirEntry->pcFileName[ 0 ] = 0;
+        pxDirEntry->ucAttrib = 0;
+        pxFindParams->lFreeEntry = 0;
+
+        xLength = prvNameToUtf16( pcName, usSearch );
+
+        if( xLength > 0 )
+        {
+            usHash = prvNameHash( pxIOManager, usSearch, xLength );
+
+            for( xIndex = 0; xIndex < xLength; xIndex++ )
+            {
+                usSearch[ xIndex ] = prvUpcase( pxIOManager, usSearch[ xIndex ] );
+            }
+
+            xError = FF_InitEntryFetch( pxIOManager, pxFindParams->ulDirCluster, &xFetchContext );
+
+            if( FF_isERR( xError ) == pdFALSE )
+            {
+                for( ulEntry = 0; ulEntry < FF_MAX_ENTRIES_PER_DIRECTORY; ulEntry++ )
+                {
+                    xError = FF_FetchEntryWithContext( pxIOManager, ulEntry, &xFetchContext, ucEntry );
+
+                    if( FF_isERR( xError ) || ( ucEntry[ 0 ] == FF_EXFAT_TYPE_END ) )
+                    {
+                        break;
+                    }
+
+                    if( ( ucEntry[ 0 ] != FF_EXFAT_TYPE_FILE ) || ( ( ulEntry + 1UL ) >= FF_MAX_ENTRIES_PER_DIRECTORY ) )
+                    {
+                        continue;
+                    }
+
+                    /* Compare the length and the hash, before reading the whole set. */
+                    xError = FF_FetchEntryWithContext( pxIOManager, ulEntry + 1UL, &xFetchContext, ucEntry );
+
+                    if( FF_isERR( xError ) )
+                    {
+                        break;
+                    }
+
+                    if( ( ucEntry[ 0 ] != FF_EXFAT_TYPE_STREAM ) ||
+                        ( ucEntry[ FF_EXFAT_STREAM_NAME_LENGTH ] != ( uint8_t ) xLength ) ||
+                        ( FF_getShort( ucEntry, FF_EXFAT_STREAM_NAME_HASH ) != usHash ) )
+                    {
+                        continue;
+                    }
+
+                    xError = prvReadEntrySet( pxIOManager, &xFetchContext, ulEntry, &xSet );
+
+                    if( FF_isERR( xError ) )
+                    {
+                        break;
+                    }
+
+                    if( ( xSet.xValid == pdFALSE ) || ( xSet.xNameLength != xLength ) )
+                    {
+                        continue;
+                    }
+
+                    for( xIndex = 0; xIndex < xLength; xIndex++ )
+                    {
+                        if( prvUpcase( pxIOManager, xSet.usName[ xIndex ] ) != usSearch[ xIndex ] )
+                        {
+                            break;
+                        }
+                    }
+
+                    if( ( xIndex == xLength ) &&
+                        ( ( FF_getShort( xSet.ucFile, FF_EXFAT_FILE_ATTRIBUTES ) & ucAttrib ) == ucAttrib ) )
+                    {
+                        prvPopulateDirent( &xSet, pxDirEntry );
+                        pxDirEntry->usCurrentItem = ( uint16_t ) ( ulEntry + 1UL );
+                        ulResult = pxDirEntry->ulObjectCluster;
+                        xFound = pdTRUE;
+                        break;
+                    }
+                }
+
+                if( FF_GETERROR( xError ) == FF_ERR_DIR_END_OF_DIR )
+                {
+                    /* The end of the cluster chain was reached. */
+                    xError = FF_ERR_NONE;
+                }
+
+                xTempError = FF_CleanupEntryFetch( pxIOManager, &xFetchContext );
+
+                if( FF_isERR( xError ) == pdFALSE )
+                {
+                    xError = xTempError;
+                }
+            }
+
+            if( ( FF_isERR( xError ) == pdFALSE ) && ( xFound != pdFALSE ) &&
+                ( ( pxDirEntry->ucAttrib & FF_FAT_ATTR_DIR ) != 0U ) )
+            {
+                ulEntry = ( uint32_t ) pxDirEntry->usCurrentItem - 1UL;
+
+                if( ( ( pxDirEntry->ucStreamFlags & FF_EXFAT_FLAG_NO_FAT_CHAIN ) != 0U ) && ( ulResult != 0UL ) )
+                {
+                    ulClusterSize = ( uint32_t ) pxIOManager->xPartition.usBlkSize * pxIOManager->xPartition.ulSectorsPerCluster;
+                    xError = FF_exFATWriteChain( pxIOManager, ulResult, ( pxDirEntry->ulFileSize + ulClusterSize - 1UL ) / ulClusterSize );
+
+                    if( FF_isERR( xError ) == pdFALSE )
+                    {
+                        pxDirEntry->ucStreamFlags &= ( uint8_t ) ~FF_EXFAT_FLAG_NO_FAT_CHAIN;
+                        xError = FF_exFATPutEntry( pxIOManager, ( uint16_t ) ulEntry, pxFindParams->ulDirCluster, pxDirEntry );
+                    }
+                }
+
+                FF_exFATRememberDir( pxIOManager, ulResult, pxFindParams->ulDirCluster, ( uint16_t ) ulEntry );
+            }
+        }
+
+        if( FF_isERR( xError ) )
+        {
+            ulResult = 0;
+        }
+
+        if( pxError != NULL )
+        {
+            *pxError = xError;
+        }
+
+        return ulResult;
+    }
+/*-----------------------------------------------------------*/
+
+/* FF_FindNext() for exFAT: return the next valid entry set that matches the wild-card. */
+    FF_Error_t FF_exFATFindNext( FF_IOManager_t * pxIOManager,
+                                 FF_DirEnt_t * pxDirEntry )
+    {
+        exFATEntrySet_t xSet;
+        uint8_t ucEntry[ FF_SIZEOF_DIRECTORY_ENTRY ];
+        FF_Error_t xError = FF_ERR_NONE;
+        FF_Error_t xTempError;
+        uint32_t ulEntry;
+        BaseType_t xFound = pdFALSE;
+
+        #if ( ffconfigFINDAPI_ALLOW_WILDCARDS != 0 )
+            BaseType_t b;
+        #endif
+
+        for( ulEntry = pxDirEntry->usCurrentItem; ulEntry < FF_MAX_ENTRIES_PER_DIRECTORY; ulEntry++ )
+        {
+            xError = FF_FetchEntryWithContext( pxIOManager, ulEntry, &( pxDirEntry->xFetchContext ), ucEntry );
+
+            if( FF_isERR( xError ) )
+            {
+                break;
+            }
+
+            if( ucEntry[ 0 ] == FF_EXFAT_TYPE_END )
+            {
+                /* End of directory, generate a pseudo error 'DIR_END_OF_DIR'. */
+                xError = ( FF_Error_t ) ( FF_ERR_DIR_END_OF_DIR | FF_FINDNEXT );
+                break;
+            }
+
+            if( ucEntry[ 0 ] != FF_EXFAT_TYPE_FILE )
+            {
+                /* Secondary entries, deleted entries and the bitmap, up-case and label entries. */
+                continue;
+            }
+
+            xError = prvReadEntrySet( pxIOManager, &( pxDirEntry->xFetchContext ), ulEntry, &xSet );
+
+            if( FF_isERR( xError ) )
+            {
+                break;
+            }
+
+            if( xSet.xValid == pdFALSE )
+            {
+                continue;
+            }
+
+            prvPopulateDirent( &xSet, pxDirEntry );
+
+            #if ( ffconfigFINDAPI_ALLOW_WILDCARDS != 0 )
+                {
+                    if( pxDirEntry->pcWildCard[ 0 ] )
+                    {
+                        b = FF_wildcompare( pxDirEntry->pcWildCard, pxDirEntry->pcFileName );
+
+                        if( pxDirEntry->xInvertWildCard != pdFALSE )
+                        {
+                            b = !b;
+                        }
+
+                        if( b == 0 )
+                        {
+                            continue;
+                        }
+                    }
+                }
+            #endif /* ffconfigFINDAPI_ALLOW_WILDCARDS */
+
+            xFound = pdTRUE;
+            break;
+        }
+
+        if( ( FF_isERR( xError ) == pdFALSE ) && ( xFound == pdFALSE ) )
+        {
+            xError = ( FF_Error_t ) ( FF_ERR_DIR_END_OF_DIR | FF_FINDNEXT );
+        }
+
+        /* Like FF_FindNext(), 'usCurrentItem' points behind the primary entry. */
+        pxDirEntry->usCurrentItem = ( uint16_t ) ( ( ulEntry < FF_MAX_ENTRIES_PER_DIRECTORY ) ? ( ulEntry + 1UL ) : FF_MAX_ENTRIES_PER_DIRECTORY );
+
+        xTempError = FF_CleanupEntryFetch( pxIOManager, &( pxDirEntry->xFetchContext ) );
+
+        if( FF_isERR( xError ) == pdFALSE )
+        {
+            xError = xTempError;
+        }
+
+        return xError;
+    }
+/*-----------------------------------------------------------*/
+
+    FF_Error_t FF_exFATGetEntry( FF_IOManager_t * pxIOManager,
+                                 uint16_t usEntry,
+                                 uint32_t ulDirCluster,
+                                 FF_DirEnt_t * pxDirEntry )
+    {
+        FF_FetchContext_t xFetchContext;
+        exFATEntrySet_t xSet;
+        FF_Error_t xError;
+        FF_Error_t xTempError;
+
+        xError = FF_InitEntryFetch( pxIOManager, ulDirCluster, &xFetchContext );
+
+        if( FF_isERR( xError ) == pdFALSE )
+        {
+            xError = prvReadEntrySet( pxIOManager, &xFetchContext, usEntry, &xSet );
+
+            if( FF_isERR( xError ) == pdFALSE )
+            {
+                if( xSet.ucFile[ 0 ] == FF_EXFAT_TYPE_END )
+                {
+                    xError = ( FF_Error_t ) ( FF_ERR_DIR_END_OF_DIR | FF_GETENTRY );
+                }
+                else if( xSet.xValid == pdFALSE )
+                {
+                    xError = ( FF_Error_t ) ( FF_ERR_DIR_INVALID_PARAMETER | FF_GETENTRY );
+                }
+                else
+                {
+                    prvPopulateDirent( &xSet, pxDirEntry );
+                    pxDirEntry->usCurrentItem = ( uint16_t ) ( usEntry + 1U );
+                }
+            }
+
+            xTempError = FF_CleanupEntryFetch( pxIOManager, &xFetchContext );
+
+            if( FF_isERR( xError ) == pdFALSE )
+            {
+                xError = xTempError;
+            }
+        }
+
+        return xError;
+    }
+/*-----------------------------------------------------------*/
+
+/*
+ * Write the attributes, time stamps, first cluster and size of 'pxDirEntry'
+ * to the entry set at 'usEntry', and recalculate the checksum of the set.
+ */
+    FF_Error_t FF_exFATPutEntry( FF_IOManager_t * pxIOManager,
+                                 uint16_t usEntry,
+                                 uint32_t ulDirCluster,
+                                 FF_DirEnt_t * pxDirEntry )
+    {
+        FF_FetchContext_t xFetchContext;
+        uint8_t ucFile[ FF_SIZEOF_DIRECTORY_ENTRY ];
+        uint8_t ucStream[ FF_SIZEOF_DIRECTORY_ENTRY ];
+        uint8_t ucEntry[ FF_SIZEOF_DIRECTORY_ENTRY ];
+        FF_Error_t xError;
+        FF_Error_t xTempError;
+        BaseType_t xCount;
+        BaseType_t xIndex;
+        uint16_t usChecksum;
+        uint8_t ucFlags;
+
+        xError = FF_InitEntryFetch( pxIOManager, ulDirCluster, &xFetchContext );
+
+        if( FF_isERR( xError ) == pdFALSE )
+        {
+            do
+            {
+                /* All entries are fetched before the first one is written. */
+                xError = FF_FetchEntryWithContext( pxIOManager, usEntry, &xFetchContext, ucFile );
+
+                if( FF_isERR( xError ) )
+                {
+                    break;
+                }
+
+                xCount = ( BaseType_t ) ucFile[ FF_EXFAT_FILE_SECONDARY_COUNT ];
+
+                if( ( ucFile[ 0 ] != FF_EXFAT_TYPE_FILE ) || ( xCount < 2 ) ||
+                    ( ( ( uint32_t ) usEntry + ( uint32_t ) xCount ) >= FF_MAX_ENTRIES_PER_DIRECTORY ) )
+                {
+                    xError = ( FF_Error_t ) ( FF_ERR_DIR_INVALID_PARAMETER | FF_PUTENTRY );
+                    break;
+                }
+
+                xError = FF_FetchEntryWithContext( pxIOManager, ( uint32_t ) usEntry + 1UL, &xFetchContext, ucStream );
+
+                if( FF_isERR( xError ) )
+                {
+                    break;
+                }
+
+                if( ucStream[ 0 ] != FF_EXFAT_TYPE_STREAM )
+                {
+                    xError = ( FF_Error_t ) ( FF_ERR_DIR_INVALID_PARAMETER | FF_PUTENTRY );
+                    break;
+                }
+
+                ucFile[ FF_EXFAT_FILE_ATTRIBUTES ] = ( uint8_t ) ( pxDirEntry->ucAttrib & exfatATTRIBUTE_MASK );
+
+                #if ( ffconfigTIME_SUPPORT != 0 )
+                    {
+                        FF_GetSystemTime( &pxDirEntry->xAccessedTime ); /*/< Date of Last Access. */
+                        FF_putLong( ucFile, FF_EXFAT_FILE_CREATE_TIME, prvPackTime( &( pxDirEntry->xCreateTime ) ) );
+                        FF_putLong( ucFile, FF_EXFAT_FILE_MODIFY_TIME, prvPackTime( &( pxDirEntry->xModifiedTime ) ) );
+                        FF_putLong( ucFile, FF_EXFAT_FILE_ACCESS_TIME, prvPackTime( &( pxDirEntry->xAccessedTime ) ) );
+                        ucFile[ FF_EXFAT_FILE_CREATE_10MS ] = 0;
+                        ucFile[ FF_EXFAT_FILE_MODIFY_10MS ] = 0;
+                        ucFile[ FF_EXFAT_FILE_CREATE_UTC ] = 0;
+                        ucFile[ FF_EXFAT_FILE_MODIFY_UTC ] = 0;
+                        ucFile[ FF_EXFAT_FILE_ACCESS_UTC ] = 0;
+                    }
+                #endif
+
+                ucFlags = ( uint8_t ) ( pxDirEntry->ucStreamFlags | FF_EXFAT_FLAG_ALLOCATION_POSSIBLE );
+
+                if( pxDirEntry->ulObjectCluster == 0UL )
+                {
+                    ucFlags &= ( uint8_t ) ~FF_EXFAT_FLAG_NO_FAT_CHAIN;
+                }
+
+                ucStream[ FF_EXFAT_STREAM_FLAGS ] = ucFlags;
+                FF_putLong( ucStream, FF_EXFAT_STREAM_FIRST_CLUSTER, pxDirEntry->ulObjectCluster );
+
+                /* A file of 4 GB or more can not be opened, so its size never
+                 * changes.  Only its time stamps and attributes are written
+                 * here, e.g. by FF_SetTime() or FF_SetPerm(). */
+                if( FF_getLong( ucStream, FF_EXFAT_STREAM_DATA_LENGTH + 4 ) == 0UL )
+                {
+                    FF_putLong( ucStream, FF_EXFAT_STREAM_VALID_LENGTH, pxDirEntry->ulFileSize );
+                    FF_putLong( ucStream, FF_EXFAT_STREAM_VALID_LENGTH + 4, 0UL );
+                    FF_putLong( ucStream, FF_EXFAT_STREAM_DATA_LENGTH, pxDirEntry->ulFileSize );
+                }
+
+                usChecksum = prvEntrySetChecksum( 0, ucFile, pdTRUE );
+                usChecksum = prvEntrySetChecksum( usChecksum, ucStream, pdFALSE );
+
+                for( xIndex = 2; xIndex <= xCount; xIndex++ )
+                {
+                    xError = FF_FetchEntryWithContext( pxIOManager, ( uint32_t ) usEntry + ( uint32_t ) xIndex, &xFetchContext, ucEntry );
+
+                    if( FF_isERR( xError ) )
+                    {
+                        break;
+                    }
+
+                    usChecksum = prvEntrySetChecksum( usChecksum, ucEntry, pdFALSE );
+                }
+
+                if( FF_isERR( xError ) )
+                {
+                    break;
+                }
+
+                FF_putShort( ucFile, FF_EXFAT_FILE_SET_CHECKSUM, usChecksum );
+
+                xError = FF_PushEntryWithContext( pxIOManager, ( uint32_t ) usEntry + 1UL, &xFetchContext, ucStream );
+
+                if( FF_isERR( xError ) )
+                {
+                    break;
+                }
+
+                xError = FF_PushEntryWithContext( pxIOManager, usEntry, &xFetchContext, ucFile );
+            } while( pdFALSE );
+
+            xTempError = FF_CleanupEntryFetch( pxIOManager, &xFetchContext );
+
+            if( FF_isERR( xError ) == pdFALSE )
+            {
+                xError = xTempError;
+            }
+        }
+
+        return xError;
+    }
+/*-----------------------------------------------------------*/
+
+/*
+ * Create the entry set for 'pxDirEntry'. The name, attributes, first cluster
+ * and size are taken from 'pxDirEntry', the time stamps are set to now.
+ * On return, 'usCurrentItem' is the index of the file entry.
+ */
+    FF_Error_t FF_exFATCreateDirent( FF_IOManager_t * pxIOManager,
+                                     FF_FindParams_t * pxFindParams,
+                                     FF_DirEnt_t * pxDirEntry )
+    {
+        FF_FetchContext_t xFetchContext;
+        uint16_t usName[ ffconfigMAX_FILENAME ];
+        uint8_t ucEntry[ FF_SIZEOF_DIRECTORY_ENTRY ];
+        uint8_t ucFile[ FF_SIZEOF_DIRECTORY_ENTRY ];
+        uint8_t ucStream[ FF_SIZEOF_DIRECTORY_ENTRY ];
+        FF_Error_t xError = FF_ERR_NONE;
+        FF_Error_t xTempError;
+        uint32_t ulDirCluster = pxFindParams->ulDirCluster;
+        uint32_t ulEntry = 0;
+        uint32_t ulStart = 0;
+        uint32_t ulFree = 0;
+        BaseType_t xLength;
+        BaseType_t xCount;
+        BaseType_t xIndex;
+        BaseType_t xChar;
+        uint16_t usChecksum;
+
+        xLength = prvNameToUtf16( pxDirEntry->pcFileName, usName );
+
+        if( xLength <= 0 )
+        {
+            return ( FF_Error_t ) ( FF_ERR_DIR_NAME_TOO_LONG | FF_EXFATCREATEDIRENT );
+        }
+
+        /* Ensure we don't break the Dir tables. */
+        for( xIndex = 0; xIndex < xLength; xIndex++ )
+        {
+            if( ( usName[ xIndex ] < 0x20U ) || ( strchr( "\"*/:<>?\\|", ( int ) usName[ xIndex ] ) != NULL ) )
+            {
+                usName[ xIndex ] = ( uint16_t ) '_';
+            }
+        }
+
+        /* The stream extension entry and the file name entries. */
+        xCount = 1 + ( ( xLength + FF_EXFAT_CHARS_PER_NAME_ENTRY - 1 ) / FF_EXFAT_CHARS_PER_NAME_ENTRY );
+
+        FF_LockDirectory( pxIOManager );
+        {
+            xError = FF_InitEntryFetch( pxIOManager, ulDirCluster, &xFetchContext );
+
+            /* Look for 1 + xCount entries in a row that are not in use. */
+            while( FF_isERR( xError ) == pdFALSE )
+            {
+                if( ( ulEntry + 1UL ) >= FF_MAX_ENTRIES_PER_DIRECTORY )
+                {
+                    xError = ( FF_Error_t ) ( FF_ERR_DIR_DIRECTORY_FULL | FF_EXFATCREATEDIRENT );
+                    break;
+                }
+
+                xError = FF_FetchEntryWithContext( pxIOManager, ulEntry, &xFetchContext, ucEntry );
+
+                if( FF_GETERROR( xError ) == FF_ERR_DIR_END_OF_DIR )
+                {
+                    /* Add a cluster, which is filled with zeros, and continue with the same entry. */
+                    xError = FF_CleanupEntryFetch( pxIOManager, &xFetchContext );
+
+                    if( FF_isERR( xError ) == pdFALSE )
+                    {
+                        xError = prvExtendDirectory( pxIOManager, ulDirCluster );
+                    }
+
+                    if( FF_isERR( xError ) == pdFALSE )
+                    {
+                        xError = FF_InitEntryFetch( pxIOManager, ulDirCluster, &xFetchContext );
+                    }
+
+                    continue;
+                }
+
+                if( FF_isERR( xError ) )
+                {
+                    break;
+                }
+
+                if( ( ucEntry[ 0 ] & FF_EXFAT_TYPE_IN_USE ) == 0U )
+                {
+                    if( ulFree == 0UL )
+                    {
+                        ulStart = ulEntry;
+                    }
+
+                    ulFree++;
+
+                    if( ulFree == ( uint32_t ) ( xCount + 1 ) )
+                    {
+                        break;
+                    }
+                }
+                else
+                {
+                    ulFree = 0;
+                }
+
+                ulEntry++;
+            }
+
+            if( FF_isERR( xError ) == pdFALSE )
+            {
+                memset( ucFile, 0, sizeof( ucFile ) );
+                memset( ucStream, 0, sizeof( ucStream ) );
+
+                ucFile[ 0 ] = FF_EXFAT_TYPE_FILE;
+                ucFile[ FF_EXFAT_FILE_SECONDARY_COUNT ] = ( uint8_t ) xCount;
+                ucFile[ FF_EXFAT_FILE_ATTRIBUTES ] = ( uint8_t ) ( pxDirEntry->ucAttrib & exfatATTRIBUTE_MASK );
+
+                #if ( ffconfigTIME_SUPPORT != 0 )
+                    {
+                        FF_GetSystemTime( &pxDirEntry->xCreateTime );        /* Date and Time Created. */
+                        pxDirEntry->xModifiedTime = pxDirEntry->xCreateTime; /* Date and Time Modified. */
+                        pxDirEntry->xAccessedTime = pxDirEntry->xCreateTime; /* Date of Last Access. */
+                        FF_putLong( ucFile, FF_EXFAT_FILE_CREATE_TIME, prvPackTime( &( pxDirEntry->xCreateTime ) ) );
+                        FF_putLong( ucFile, FF_EXFAT_FILE_MODIFY_TIME, prvPackTime( &( pxDirEntry->xModifiedTime ) ) );
+                        FF_putLong( ucFile, FF_EXFAT_FILE_ACCESS_TIME, prvPackTime( &( pxDirEntry->xAccessedTime ) ) );
+                    }
+                #endif
+
+                ucStream[ 0 ] = FF_EXFAT_TYPE_STREAM;
+                ucStream[ FF_EXFAT_STREAM_FLAGS ] = ( uint8_t ) ( pxDirEntry->ucStreamFlags | FF_EXFAT_FLAG_ALLOCATION_POSSIBLE );
+
+                if( pxDirEntry->ulObjectCluster == 0UL )
+                {
+                    ucStream[ FF_EXFAT_STREAM_FLAGS ] &= ( uint8_t ) ~FF_EXFAT_FLAG_NO_FAT_CHAIN;
+                }
+
+                ucStream[ FF_EXFAT_STREAM_NAME_LENGTH ] = ( uint8_t ) xLength;
+                FF_putShort( ucStream, FF_EXFAT_STREAM_NAME_HASH, prvNameHash( pxIOManager, usName, xLength ) );
+                FF_putLong( ucStream, FF_EXFAT_STREAM_VALID_LENGTH, pxDirEntry->ulFileSize );
+                FF_putLong( ucStream, FF_EXFAT_STREAM_FIRST_CLUSTER, pxDirEntry->ulObjectCluster );
+                FF_putLong( ucStream, FF_EXFAT_STREAM_DATA_LENGTH, pxDirEntry->ulFileSize );
+
+                usChecksum = prvEntrySetChecksum( 0, ucFile, pdTRUE );
+                usChecksum = prvEntrySetChecksum( usChecksum, ucStream, pdFALSE );
+
+                /* The name entries are written first, the file entry makes the set valid. */
+                xError = FF_PushEntryWithContext( pxIOManager, ulStart + 1UL, &xFetchContext, ucStream );
+
+                for( xIndex = 2; ( xIndex <= xCount ) && ( FF_isERR( xError ) == pdFALSE ); xIndex++ )
+                {
+                    memset( ucEntry, 0, sizeof( ucEntry ) );
+                    ucEntry[ 0 ] = FF_EXFAT_TYPE_NAME;
+
+                    for( xChar = 0; xChar < FF_EXFAT_CHARS_PER_NAME_ENTRY; xChar++ )
+                    {
+                        BaseType_t xPosition = ( ( xIndex - 2 ) * FF_EXFAT_CHARS_PER_NAME_ENTRY ) + xChar;
+
+                        if( xPosition >= xLength )
+                        {
+                            break;
+                        }
+
+                        FF_putShort( ucEntry, ( uint32_t ) ( FF_EXFAT_NAME_CHARS + ( 2 * xChar ) ), usName[ xPosition ] );
+                    }
+
+                    usChecksum = prvEntrySetChecksum( usChecksum, ucEntry, pdFALSE );
+                    xError = FF_PushEntryWithContext( pxIOManager, ulStart + ( uint32_t ) xIndex, &xFetchContext, ucEntry );
+                }
+
+                if( FF_isERR( xError ) == pdFALSE )
+                {
+                    FF_putShort( ucFile, FF_EXFAT_FILE_SET_CHECKSUM, usChecksum );
+                    xError = FF_PushEntryWithContext( pxIOManager, ulStart, &xFetchContext, ucFile );
+                }
+            }
+
+            xTempError = FF_CleanupEntryFetch( pxIOManager, &xFetchContext );
+
+            if( FF_isERR( xError ) == pdFALSE )
+            {
+                xError = xTempError;
+            }
+        }
+        FF_UnlockDirectory( pxIOManager );
+
+        if( FF_isERR( xError ) == pdFALSE )
+        {
+            pxDirEntry->usCurrentItem = ( uint16_t ) ulStart;
+        }
+
+        return xError;
+    }
+/*-----------------------------------------------------------*/
+
+/* Mark the entry set at 'usEntry' as deleted. */
+    FF_Error_t FF_exFATRmEntrySet( FF_IOManager_t * pxIOManager,
+                                   uint16_t usEntry,
+                                   FF_FetchContext_t * pxContext )
+    {
+        uint8_t ucEntry[ FF_SIZEOF_DIRECTORY_ENTRY ];
+        FF_Error_t xError;
+        BaseType_t xCount;
+        BaseType_t xIndex;
+
+        xError = FF_FetchEntryWithContext( pxIOManager, usEntry, pxContext, ucEntry );
+
+        if( ( FF_isERR( xError ) == pdFALSE ) && ( ucEntry[ 0 ] != FF_EXFAT_TYPE_FILE ) )
+        {
+            xError = ( FF_Error_t ) ( FF_ERR_DIR_INVALID_PARAMETER | FF_EXFATFINDENTRY );
+        }
+
+        if( FF_isERR( xError ) == pdFALSE )
+        {
+            xCount = ( BaseType_t ) ucEntry[ FF_EXFAT_FILE_SECONDARY_COUNT ];
+
+            for( xIndex = 0; xIndex <= xCount; xIndex++ )
+            {
+                if( xIndex != 0 )
+                {
+                    xError = FF_FetchEntryWithContext( pxIOManager, ( uint32_t ) usEntry + ( uint32_t ) xIndex, pxContext, ucEntry );
+
+                    if( FF_isERR( xError ) )
+                    {
+                        break;
+                    }
+                }
+
+                ucEntry[ 0 ] &= ( uint8_t ) ~FF_EXFAT_TYPE_IN_USE;
+                xError = FF_PushEntryWithContext( pxIOManager, ( uint32_t ) usEntry + ( uint32_t ) xIndex, pxContext, ucEntry );
+
+                if( FF_isERR( xError ) )
+                {
+                    break;
+                }
+            }
+        }
+
+        return xError;
+    }
+/*-----------------------------------------------------------*/
+
+/*
+ * The length of a directory is stored in its entry set, in the parent
+ * directory. Remember where that entry set is, for the directories that
+ * were looked up or created most recently.
+ */
+    void FF_exFATRememberDir( FF_IOManager_t * pxIOManager,
+                              uint32_t ulDirCluster,
+                              uint32_t ulParentCluster,
+                              uint16_t usEntry )
+    {
+        FF_Partition_t * pxPartition = &( pxIOManager->xPartition );
+        FF_exFATDirLocation_t * pxLocation = NULL;
+        BaseType_t xIndex;
+
+        FF_PendSemaphore( pxIOManager->pvSemaphore );
+        {
+            for( xIndex = 0; xIndex < ffconfigEXFAT_DIR_CACHE_DEPTH; xIndex++ )
+            {
+                if( pxPartition->xDirLocations[ xIndex ].ulDirCluster == ulDirCluster )
+                {
+                    pxLocation = &( pxPartition->xDirLocations[ xIndex ] );
+                    break;
+                }
+            }
+
+            if( pxLocation == NULL )
+            {
+                pxLocation = &( pxPartition->xDirLocations[ pxPartition->ulDirLocationIndex ] );
+
+                pxPartition->ulDirLocationIndex += 1;
+
+                if( pxPartition->ulDirLocationIndex >= ffconfigEXFAT_DIR_CACHE_DEPTH )
+                {
+                    pxPartition->ulDirLocationIndex = 0;
+                }
+            }
+
+            pxLocation->ulDirCluster = ulDirCluster;
+            pxLocation->ulParentCluster = ulParentCluster;
+            pxLocation->usEntry = usEntry;
+        }
+        FF_ReleaseSemaphore( pxIOManager->pvSemaphore );
+    }
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvFindDirLocation( FF_IOManager_t * pxIOManager,
+                                          uint32_t ulDirCluster,
+                                          FF_exFATDirLocation_t * pxLocation )
+    {
+        FF_Partition_t * pxPartition = &( pxIOManager->xPartition );
+        BaseType_t xIndex;
+        BaseType_t xFound = pdFALSE;
+
+        FF_PendSemaphore( pxIOManager->pvSemaphore );
+        {
+            for( xIndex = 0; xIndex < ffconfigEXFAT_DIR_CACHE_DEPTH; xIndex++ )
+            {
+                if( ( ulDirCluster != 0UL ) && ( pxPartition->xDirLocations[ xIndex ].ulDirCluster == ulDirCluster ) )
+                {
+                    if( pxLocation != NULL )
+                    {
+                        *pxLocation = pxPartition->xDirLocations[ xIndex ];
+                    }
+
+                    xFound = pdTRUE;
+                    break;
+                }
+            }
+        }
+        FF_ReleaseSemaphore( pxIOManager->pvSemaphore );
+
+        return xFound;
+    }
+/*-----------------------------------------------------------*/
+
+/* The root directory has no entry set, its length follows from the FAT. */
+    BaseType_t FF_exFATDirIsKnown( FF_IOManager_t * pxIOManager,
+                                   uint32_t ulDirCluster )
+    {
+        BaseType_t xResult = pdTRUE;
+
+        if( ulDirCluster != pxIOManager->xPartition.ulRootDirCluster )
+        {
+            xResult = prvFindDirLocation( pxIOManager, ulDirCluster, NULL );
+        }
+
+        return xResult;
+    }
+/*-----------------------------------------------------------*/
+
+/* A cluster was added to a directory: add it to the length in its entry set. */
+    FF_Error_t FF_exFATDirectoryExtended( FF_IOManager_t * pxIOManager,
+                                          uint32_t ulDirCluster )
+    {
+        FF_exFATDirLocation_t xLocation;
+        FF_DirEnt_t xDirEntry;
+        FF_Error_t xError = FF_ERR_NONE;
+
+        if( ulDirCluster != pxIOManager->xPartition.ulRootDirCluster )
+        {
+            if( prvFindDirLocation( pxIOManager, ulDirCluster, &xLocation ) == pdFALSE )
+            {
+                xError = ( FF_Error_t ) ( FF_ERR_DIR_EXTEND_FAILED | FF_EXFATCREATEDIRENT );
+            }
+            else
+            {
+                xError = FF_exFATGetEntry( pxIOManager, xLocation.usEntry, xLocation.ulParentCluster, &xDirEntry );
+
+                if( ( FF_isERR( xError ) == pdFALSE ) && ( xDirEntry.ulObjectCluster != ulDirCluster ) )
+                {
+                    /* The remembered location is outdated. */
+                    xError = ( FF_Error_t ) ( FF_ERR_DIR_EXTEND_FAILED | FF_EXFATCREATEDIRENT );
+                }
+
+                if( FF_isERR( xError ) == pdFALSE )
+                {
+                    xDirEntry.ulFileSize += ( uint32_t ) pxIOManager->xPartition.usBlkSize * pxIOManager->xPartition.ulSectorsPerCluster;
+                    xError = FF_exFATPutEntry( pxIOManager, xLocation.usEntry, xLocation.ulParentCluster, &xDirEntry );
+                }
+            }
+        }
+
+        return xError;
+    }
+/*-----------------------------------------------------------*/
+
+/* Add a cluster to a directory, when its length can be updated. */
+    static FF_Error_t prvExtendDirectory( FF_IOManager_t * pxIOManager,
+                                          uint32_t ulDirCluster )
+    {
+        FF_Error_t xError;
+
+        if( FF_exFATDirIsKnown( pxIOManager, ulDirCluster ) == pdFALSE )
+        {
+            xError = ( FF_Error_t ) ( FF_ERR_DIR_EXTEND_FAILED | FF_EXFATCREATEDIRENT );
+        }
+        else
+        {
+            xError = FF_ExtendDirectory( pxIOManager, ulDirCluster );
+
+            if( FF_isERR( xError ) == pdFALSE )
+            {
+                xError = FF_exFATDirectoryExtended( pxIOManager, ulDirCluster );
+            }
+        }
+
+        return xError;
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t FF_exFATIsBootSector( const uint8_t * pucSector )
+    {
+        BaseType_t xResult = pdFALSE;
+
+        if( ( memcmp( pucSector + FF_EXFAT_FS_NAME, "EXFAT   ", 8 ) == 0 ) &&
+            ( FF_getShort( pucSector, FF_FAT_MBR_SIGNATURE ) == 0xAA55U ) )
+        {
+            xResult = pdTRUE;
+        }
+
+        return xResult;
+    }
+/*-----------------------------------------------------------*/
+
+/* Verify the checksum of the main boot region: the 11 sectors in front of the checksum sector. */
+    static FF_Error_t prvCheckBootRegion( FF_IOManager_t * pxIOManager )
+    {
+        FF_Buffer_t * pxBuffer = NULL;
+        FF_Error_t xError = FF_ERR_NONE;
+        const uint32_t ulCount = ( uint32_t ) FF_EXFAT_CHECKSUM_SECTOR * pxIOManager->xPartition.ucBlkFactor;
+        uint32_t ulChecksum = 0;
+        uint32_t ulSector;
+
+        for( ulSector = 0; ulSector <= ulCount; ulSector++ )
+        {
+            xError = prvGetSector( pxIOManager, &pxBuffer, pxIOManager->xPartition.ulBeginLBA + ulSector, FF_MODE_READ, FF_EXFATMOUNT );
+
+            if( FF_isERR( xError ) )
+            {
+                break;
+            }
+
+            if( ulSector < ulCount )
+            {
+                ulChecksum = FF_exFATBootChecksum( ulChecksum, pxBuffer->pucBuffer, pxIOManager->usSectorSize, ( ulSector == 0UL ) );
+            }
+            else if( FF_getLong( pxBuffer->pucBuffer, 0 ) != ulChecksum )
+            {
+                xError = ( FF_Error_t ) ( FF_ERR_IOMAN_INVALID_FORMAT | FF_EXFATMOUNT );
+            }
+            else
+            {
+                /* The checksum is correct. */
+            }
+        }
+
+        return prvReleaseSector( pxIOManager, &pxBuffer, xError );
+    }
+/*-----------------------------------------------------------*/
+
+/* Find the allocation bitmap, the up-case table and the volume label in the root directory. */
+    static FF_Error_t prvScanRootDirectory( FF_IOManager_t * pxIOManager,
+                                            uint32_t * pulUpcaseChecksum )
+    {
+        FF_Partition_t * pxPartition = &( pxIOManager->xPartition );
+        FF_FetchContext_t xFetchContext;
+        uint8_t ucEntry[ FF_SIZEOF_DIRECTORY_ENTRY ];
+        FF_Error_t xError;
+        FF_Error_t xTempError;
+        BaseType_t xBitmapFound = pdFALSE;
+        BaseType_t xUpcaseFound = pdFALSE;
+        BaseType_t xIndex;
+        uint32_t ulEntry;
+
+        xError = FF_InitEntryFetch( pxIOManager, pxPartition->ulRootDirCluster, &xFetchContext );
+
+        if( FF_isERR( xError ) == pdFALSE )
+        {
+            for( ulEntry = 0; ulEntry < FF_MAX_ENTRIES_PER_DIRECTORY; ulEntry++ )
+            {
+                xError = FF_FetchEntryWithContext( pxIOManager, ulEntry, &xFetchContext, ucEntry );
+
+                if( FF_GETERROR( xError ) == FF_ERR_DIR_END_OF_DIR )
+                {
+                    xError = FF_ERR_NONE;
+                    break;
+                }
+
+                if( FF_isERR( xError ) || ( ucEntry[ 0 ] == FF_EXFAT_TYPE_END ) )
+                {
+                    break;
+                }
+
+                if( ( ucEntry[ 0 ] == FF_EXFAT_TYPE_BITMAP ) && ( xBitmapFound == pdFALSE ) )
+                {
+                    /* The first bitmap belongs to the first FAT, which is the only one supported. */
+                    pxPartition->ulBitmapCluster = FF_getLong( ucEntry, FF_EXFAT_ALLOC_FIRST_CLUSTER );
+                    pxPartition->ulBitmapLength = FF_getLong( ucEntry, FF_EXFAT_ALLOC_DATA_LENGTH );
+                    xBitmapFound = pdTRUE;
+                }
+                else if( ucEntry[ 0 ] == FF_EXFAT_TYPE_UPCASE )
+                {
+                    pxPartition->ulUpcaseCluster = FF_getLong( ucEntry, FF_EXFAT_ALLOC_FIRST_CLUSTER );
+                    pxPartition->ulUpcaseLength = FF_getLong( ucEntry, FF_EXFAT_ALLOC_DATA_LENGTH );
+                    *pulUpcaseChecksum = FF_getLong( ucEntry, FF_EXFAT_UPCASE_CHECKSUM );
+                    xUpcaseFound = pdTRUE;
+                }
+                else if( ucEntry[ 0 ] == FF_EXFAT_TYPE_LABEL )
+                {
+                    /* The label is stored in UTF-16, keep the low bytes. */
+                    memset( pxPartition->pcVolumeLabel, '\0', sizeof( pxPartition->pcVolumeLabel ) );
+
+                    for( xIndex = 0; ( xIndex < ( BaseType_t ) ucEntry[ FF_EXFAT_LABEL_COUNT ] ) && ( xIndex < 11 ); xIndex++ )
+                    {
+                        pxPartition->pcVolumeLabel[ xIndex ] = ( char ) FF_getShort( ucEntry, ( uint32_t ) ( FF_EXFAT_LABEL_CHARS + ( 2 * xIndex ) ) );
+                    }
+                }
+                else if( ( ucEntry[ 0 ] == FF_EXFAT_TYPE_FILE ) && ( xBitmapFound != pdFALSE ) && ( xUpcaseFound != pdFALSE ) )
+                {
+                    break;
+                }
+                else
+                {
+                    /* Not interesting while mounting. */
+                }
+            }
+
+            xTempError = FF_CleanupEntryFetch( pxIOManager, &xFetchContext );
+
+            if( FF_isERR( xError ) == pdFALSE )
+            {
+                xError = xTempError;
+            }
+        }
+
+        if( ( FF_isERR( xError ) == pdFALSE ) &&
+            ( ( xBitmapFound == pdFALSE ) || ( xUpcaseFound == pdFALSE ) ||
+              ( pxPartition->ulBitmapLength < ( ( pxPartition->ulNumClusters - 2UL + 7UL ) / 8UL ) ) ) )
+        {
+            xError = ( FF_Error_t ) ( FF_ERR_IOMAN_INVALID_FORMAT | FF_EXFATMOUNT );
+        }
+
+        return xError;
+    }
+/*-----------------------------------------------------------*/
+
+/* The bitmap and the up-case table are accessed by sector number, they must be stored contiguously. */
+    static FF_Error_t prvCheckContiguous( FF_IOManager_t * pxIOManager,
+                                          uint32_t ulCluster,
+                                          uint32_t ulLength )
+    {
+        FF_Error_t xError = FF_ERR_NONE;
+        const uint32_t ulClusterSize = ( uint32_t ) pxIOManager->xPartition.usBlkSize * pxIOManager->xPartition.ulSectorsPerCluster;
+        uint32_t ulCount = ( ulLength + ulClusterSize - 1UL ) / ulClusterSize;
+        uint32_t ulIndex;
+        uint32_t ulNext;
+
+        if( ( ulCluster < 2UL ) || ( ulCount == 0UL ) || ( ulCount > ( pxIOManager->xPartition.ulNumClusters - ulCluster ) ) )
+        {
+            xError = ( FF_Error_t ) ( FF_ERR_IOMAN_INVALID_FORMAT | FF_EXFATMOUNT );
+        }
+        else
+        {
+            FF_LockFAT( pxIOManager );
+            {
+                for( ulIndex = 0; ulIndex < ( ulCount - 1UL ); ulIndex++ )
+                {
+                    ulNext = FF_getFATEntry( pxIOManager, ulCluster + ulIndex, &xError, NULL );
+
+                    if( FF_isERR( xError ) )
+                    {
+                        break;
+                    }
+
+                    if( ulNext != ( ulCluster + ulIndex + 1UL ) )
+                    {
+                        xError = ( FF_Error_t ) ( FF_ERR_IOMAN_INVALID_FORMAT | FF_EXFATMOUNT );
+                        break;
+                    }
+                }
+            }
+            FF_UnlockFAT( pxIOManager );
+        }
+
+        return xError;
+    }
+/*-----------------------------------------------------------*/
+
+/*
+ * Mount an exFAT volume, of which 'pxBuffer' holds the boot sector. The
+ * buffer will be released. TexFAT volumes, which have a second FAT and
+ * bitmap, are refused.
+ */
+    FF_Error_t FF_exFATMount( FF_IOManager_t * pxIOManager,
+                              FF_Buffer_t * pxBuffer )
+    {
+        FF_Partition_t * pxPartition = &( pxIOManager->xPartition );
+        const uint8_t * pucSector = pxBuffer->pucBuffer;
+        const uint8_t ucBytesShift = pucSector[ FF_EXFAT_BYTES_PER_SECTOR_SHIFT ];
+        const uint8_t ucClusterShift = pucSector[ FF_EXFAT_SECTORS_PER_CLUS_SHIFT ];
+        FF_Error_t xError = FF_ERR_NONE;
+        FF_Error_t xTempError;
+        uint32_t ulClusterCount;
+        uint32_t ulChecksum = 0;
+        uint32_t ulTableChecksum;
+
+        if( ( ucBytesShift < 9U ) || ( ucBytesShift > 12U ) || ( ( ucBytesShift + ucClusterShift ) > 25U ) ||
+            ( ( 1UL << ucBytesShift ) < pxIOManager->usSectorSize ) )
+        {
+            xError = ( FF_Error_t ) ( FF_ERR_IOMAN_INVALID_FORMAT | FF_EXFATMOUNT );
+        }
+        else if( pucSector[ FF_EXFAT_NUMBER_OF_FATS ] != 1U )
+        {
+            xError = ( FF_Error_t ) ( FF_ERR_IOMAN_NOT_FAT_FORMATTED | FF_EXFATMOUNT );
+        }
+        else if( FF_getLong( pucSector, FF_EXFAT_VOLUME_LENGTH + 4 ) != 0UL )
+        {
+            /* Sector numbers are 32-bit. */
+            xError = ( FF_Error_t ) ( FF_ERR_IOMAN_INVALID_FORMAT | FF_EXFATMOUNT );
+        }
+        else
+        {
+            ulClusterCount = FF_getLong( pucSector, FF_EXFAT_CLUSTER_COUNT );
+
+            pxPartition->ucType = FF_T_EXFAT;
+            pxPartition->ucNumFATS = 1;
+            pxPartition->usBlkSize = ( uint16_t ) ( 1U << ucBytesShift );
+            pxPartition->ucBlkFactor = ( uint8_t ) ( pxPartition->usBlkSize / pxIOManager->usSectorSize );
+            pxPartition->ulFATBeginLBA = pxPartition->ulBeginLBA + FF_getLong( pucSector, FF_EXFAT_FAT_OFFSET );
+            pxPartition->ulSectorsPerFAT = FF_getLong( pucSector, FF_EXFAT_FAT_LENGTH );
+            pxPartition->ulSectorsPerCluster = 1UL << ucClusterShift;
+            pxPartition->ulClusterBeginLBA = pxPartition->ulBeginLBA + FF_getLong( pucSector, FF_EXFAT_CLUSTER_HEAP_OFFSET );
+            pxPartition->ulFirstDataSector = pxPartition->ulClusterBeginLBA;
+            pxPartition->ulRootDirSectors = 0;
+            pxPartition->ulTotalSectors = FF_getLong( pucSector, FF_EXFAT_VOLUME_LENGTH );
+            pxPartition->ulDataSectors = ulClusterCount << ucClusterShift;
+            pxPartition->ulNumClusters = ulClusterCount + 2UL;
+            pxPartition->ulRootDirCluster = FF_getLong( pucSector, FF_EXFAT_ROOT_DIR_CLUSTER );
+            pxPartition->ucPercentInUse = pucSector[ FF_EXFAT_PERCENT_IN_USE ];
+            memset( pxPartition->pcVolumeLabel, '\0', sizeof( pxPartition->pcVolumeLabel ) );
+            memset( pxPartition->xDirLocations, '\0', sizeof( pxPartition->xDirLocations ) );
+            pxPartition->ulDirLocationIndex = 0;
+
+            if( ( ulClusterCount == 0UL ) || ( ulClusterCount > 0xFFFFFFF5UL ) ||
+                ( pxPartition->ulRootDirCluster < 2UL ) || ( pxPartition->ulRootDirCluster >= pxPartition->ulNumClusters ) )
+            {
+                xError = ( FF_Error_t ) ( FF_ERR_IOMAN_INVALID_FORMAT | FF_EXFATMOUNT );
+            }
+        }
+
+        /* An error here should override the current error, as its likely fatal. */
+        xTempError = FF_ReleaseBuffer( pxIOManager, pxBuffer );
+
+        if( FF_isERR( xTempError ) )
+        {
+            xError = xTempError;
+        }
+
+        do
+        {
+            if( FF_isERR( xError ) )
+            {
+                break;
+            }
+
+            xError = prvCheckBootRegion( pxIOManager );
+
+            if( FF_isERR( xError ) )
+            {
+                break;
+            }
+
+            xError = prvScanRootDirectory( pxIOManager, &ulChecksum );
+
+            if( FF_isERR( xError ) )
+            {
+                break;
+            }
+
+            xError = prvCheckContiguous( pxIOManager, pxPartition->ulBitmapCluster, pxPartition->ulBitmapLength );
+
+            if( FF_isERR( xError ) == pdFALSE )
+            {
+                xError = prvCheckContiguous( pxIOManager, pxPartition->ulUpcaseCluster, pxPartition->ulUpcaseLength );
+            }
+
+            if( FF_isERR( xError ) )
+            {
+                break;
+            }
+
+            pxPartition->ulBitmapLBA = FF_getRealLBA( pxIOManager, FF_Cluster2LBA( pxIOManager, pxPartition->ulBitmapCluster ) );
+
+            /* Keep the first part of the up-case table in RAM, and verify the table. */
+            xError = prvReadUpcaseTable( pxIOManager, 0, pxPartition->usUpcase, ffconfigEXFAT_UPCASE_CACHE, &ulTableChecksum );
+
+            if( ( FF_isERR( xError ) == pdFALSE ) && ( ulTableChecksum != ulChecksum ) )
+            {
+                xError = ( FF_Error_t ) ( FF_ERR_IOMAN_INVALID_FORMAT | FF_EXFATMOUNT );
+            }
+        } while( pdFALSE );
+
+        return xError;
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* ffconfigEXFAT_SUPPORT */
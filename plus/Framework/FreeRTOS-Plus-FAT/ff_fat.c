@@ -94,6 +94,18 @@ FF_Buffer_t * prvGetFromFATBuffers( FF_IOManager_t * pxIOManager,
 
 #if ( ffconfigFAT12_SUPPORT != 0 )
 
+/* A generic less-optimised way of freeing a chain of clusters.
+ * Used for FAT12 only.
+ */
+    static FF_Error_t prvUnlinkClusterChainSimple( FF_IOManager_t * pxIOManager,
+                                                   uint32_t ulStartCluster,
+                                                   BaseType_t xDoTruncate,
+                                                   uint32_t * pulLength,
+                                                   uint32_t * pulLastFree );
+#endif /* ffconfigFAT12_SUPPORT */
+
+#if ( ffconfigFAT12_SUPPORT != 0 )
+
 /* A generic less-optimised way of counting free clusters.
  * Used for FAT12 only.
  */
@@ -456,6 +468,13 @@ uint32_t FF_getFATEntry( FF_IOManager_t * pxIOManager,
         {
             ulFATOffset = ulCluster * 2;
         }
+
+        #if ( ffconfigEXFAT_SUPPORT != 0 )
+            else if( pxIOManager->xPartition.ucType == FF_T_EXFAT )
+            {
+                ulFATOffset = ulCluster * 4;
+            }
+        #endif
         else /* pxIOManager->xPartition.ucType == FF_T_FAT12 */
         {
             ulFATOffset = ulCluster + ( ulCluster / 2 );
@@ -521,6 +540,13 @@ uint32_t FF_getFATEntry( FF_IOManager_t * pxIOManager,
                     ulFATEntry = ( uint32_t ) FF_getShort( pxBuffer->pucBuffer, ulRelClusterEntry );
                     break;
 
+                    #if ( ffconfigEXFAT_SUPPORT != 0 )
+                        case FF_T_EXFAT:
+                            /* exFAT uses all 32 bits of an entry. */
+                            ulFATEntry = FF_getLong( pxBuffer->pucBuffer, ulRelClusterEntry );
+                            break;
+                    #endif
+
                     #if ( ffconfigFAT12_SUPPORT != 0 )
                         case FF_T_FAT12:
                             ulFATEntry = ( uint32_t ) FF_getShort( pxBuffer->pucBuffer, ulRelClusterEntry );
@@ -756,6 +782,16 @@ BaseType_t FF_isEndOfChain( FF_IOManager_t * pxIOManager,
             xResult = pdTRUE;
         }
     }
+
+    #if ( ffconfigEXFAT_SUPPORT != 0 )
+        else if( pxIOManager->xPartition.ucType == FF_T_EXFAT )
+        {
+            if( ulFATEntry >= 0xfffffff8 )
+            {
+                xResult = pdTRUE;
+            }
+        }
+    #endif
     else
     {
         if( ulFATEntry >= 0x00000ff8 )
@@ -773,6 +809,326 @@ BaseType_t FF_isEndOfChain( FF_IOManager_t * pxIOManager,
 }
 /*-----------------------------------------------------------*/
 
+#if ( ffconfigDEFER_FAT_MIRROR != 0 )
+
+/* The "clean shut-down" bit in the second entry of a FAT16 or a FAT32 table.
+ * It is cleared while the copies of the FAT may differ. */
+    #define fatFAT16_CLEAN_SHUTDOWN    0x8000UL
+    #define fatFAT32_CLEAN_SHUTDOWN    0x08000000UL
+
+/*
+ * Clear ( xDirty = pdTRUE ) or set the "clean shut-down" bit in the first FAT,
+ * and write the sector immediately.  When the volume becomes clean, the sector
+ * is also written to the other FAT(s).  FAT12 has no such bit.
+ * Must be called with the semaphore taken.
+ */
+    static FF_Error_t prvWriteVolumeDirty( FF_IOManager_t * pxIOManager,
+                                           BaseType_t xDirty )
+    {
+        FF_Partition_t * pxPartition = &( pxIOManager->xPartition );
+        const uint32_t ulFATSector = FF_getRealLBA( pxIOManager, pxPartition->ulFATBeginLBA );
+        const uint32_t ulFATSize = pxPartition->ulSectorsPerFAT * pxPartition->ucBlkFactor;
+        const FF_Buffer_t * pxLastBuffer = pxIOManager->pxBuffers + pxIOManager->usCacheSize;
+        FF_Buffer_t * pxBuffer;
+        uint8_t * pucSector = NULL;
+        uint32_t ulEntry;
+        int32_t lResult = 0;
+        BaseType_t xIndex;
+        BaseType_t xCount = ( xDirty != pdFALSE ) ? 1 : ( BaseType_t ) pxPartition->ucNumFATS;
+
+        if( pxPartition->ucType != FF_T_FAT12 )
+        {
+            /* The cached copies of the sector can be newer than the disk, and they must show the same bit. */
+            for( pxBuffer = pxIOManager->pxBuffers; pxBuffer < pxLastBuffer; pxBuffer++ )
+            {
+                if( ( pxBuffer->bValid != pdFALSE ) && ( pxBuffer->ulSector == ulFATSector ) )
+                {
+                    if( ( pxBuffer->ucMode & FF_MODE_WRITE ) != 0U )
+                    {
+                        pucSector = pxBuffer->pucBuffer;
+                        break;
+                    }
+
+                    if( ( pxBuffer->bModified == pdFALSE ) && ( pucSector == NULL ) )
+                    {
+                        pucSector = pxBuffer->pucBuffer;
+                    }
+                }
+            }
+
+            if( pucSector == NULL )
+            {
+                pucSector = pxPartition->pucMirrorBuffer;
+                lResult = FF_BlockRead( pxIOManager, ulFATSector, 1, pucSector, pdTRUE );
+            }
+
+            if( lResult >= 0 )
+            {
+                if( pxPartition->ucType == FF_T_FAT32 )
+                {
+                    ulEntry = FF_getLong( pucSector, 4 );
+                    ulEntry = ( xDirty != pdFALSE ) ? ( ulEntry & ~fatFAT32_CLEAN_SHUTDOWN ) : ( ulEntry | fatFAT32_CLEAN_SHUTDOWN );
+                    FF_putLong( pucSector, 4, ulEntry );
+                }
+                else
+                {
+                    ulEntry = FF_getShort( pucSector, 2 );
+                    ulEntry = ( xDirty != pdFALSE ) ? ( ulEntry & ~fatFAT16_CLEAN_SHUTDOWN ) : ( ulEntry | fatFAT16_CLEAN_SHUTDOWN );
+                    FF_putShort( pucSector, 2, ( uint16_t ) ulEntry );
+                }
+
+                for( pxBuffer = pxIOManager->pxBuffers; pxBuffer < pxLastBuffer; pxBuffer++ )
+                {
+                    if( ( pxBuffer->bValid != pdFALSE ) && ( pxBuffer->ulSector == ulFATSector ) && ( pxBuffer->pucBuffer != pucSector ) )
+                    {
+                        memcpy( pxBuffer->pucBuffer, pucSector, pxIOManager->usSectorSize );
+                    }
+                }
+
+                for( xIndex = 0; xIndex < xCount; xIndex++ )
+                {
+                    lResult = FF_BlockWrite( pxIOManager, ulFATSector + ( ( uint32_t ) xIndex * ulFATSize ), 1, pucSector, pdTRUE );
+
+                    if( lResult < 0 )
+                    {
+                        break;
+                    }
+                }
+            }
+        }
+
+        return ( lResult < 0 ) ? ( FF_Error_t ) ( FF_ERR_DEVICE_DRIVER_FAILED | FF_MIRRORFATS ) : FF_ERR_NONE;
+    }
+/*-----------------------------------------------------------*/
+
+/*
+ * Remember that a sector of the first FAT is about to change.  The first change
+ * after the FATs were made equal marks the volume as dirty, before the first
+ * FAT is written.  Must be called with the FAT locked.
+ */
+    static FF_Error_t prvMarkFATDirty( FF_IOManager_t * pxIOManager,
+                                       uint32_t ulFATSector )
+    {
+        FF_Partition_t * pxPartition = &( pxIOManager->xPartition );
+        uint32_t ulIndex = ulFATSector - FF_getRealLBA( pxIOManager, pxPartition->ulFATBeginLBA );
+        FF_Error_t xError = FF_ERR_NONE;
+
+        if( pxPartition->xFATMirrorDirty == pdFALSE )
+        {
+            FF_PendSemaphore( pxIOManager->pvSemaphore );
+            {
+                xError = prvWriteVolumeDirty( pxIOManager, pdTRUE );
+            }
+            FF_ReleaseSemaphore( pxIOManager->pvSemaphore );
+
+            if( FF_isERR( xError ) == pdFALSE )
+            {
+                pxPartition->xFATMirrorDirty = pdTRUE;
+            }
+        }
+
+        pxPartition->pucFATDirty[ ulIndex / 8 ] |= ( uint8_t ) ( 1U << ( ulIndex % 8 ) );
+
+        return xError;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ *	@private
+ *	@brief	Copies the changed sectors of the first FAT to the other FAT(s), in
+ *	@brief	runs of at most ffconfigFAT_MIRROR_BATCH_SECTORS sectors, and marks
+ *	@brief	the volume as clean.  Called by FF_FlushCache(), after the modified
+ *	@brief	buffers were written, with the FAT locked and the semaphore taken.
+ **/
+    FF_Error_t FF_MirrorFATs( FF_IOManager_t * pxIOManager )
+    {
+        FF_Partition_t * pxPartition = &( pxIOManager->xPartition );
+        const uint32_t ulFATSector = FF_getRealLBA( pxIOManager, pxPartition->ulFATBeginLBA );
+        const uint32_t ulFATSize = pxPartition->ulSectorsPerFAT * pxPartition->ucBlkFactor;
+        const FF_Buffer_t * pxLastBuffer = pxIOManager->pxBuffers + pxIOManager->usCacheSize;
+        const FF_Buffer_t * pxBuffer;
+        FF_Error_t xError = FF_ERR_NONE;
+        int32_t lResult = 0;
+        uint32_t ulIndex = 0;
+        uint32_t ulFirst;
+        uint32_t ulCount;
+        BaseType_t xIndex;
+
+        if( ( pxPartition->pucFATDirty == NULL ) || ( pxPartition->xFATMirrorDirty == pdFALSE ) )
+        {
+            return FF_ERR_NONE;
+        }
+
+        for( pxBuffer = pxIOManager->pxBuffers; pxBuffer < pxLastBuffer; pxBuffer++ )
+        {
+            if( ( pxBuffer->bValid != pdFALSE ) && ( pxBuffer->bModified != pdFALSE ) && ( ( pxBuffer->ucMode & FF_MODE_WRITE ) != 0U ) &&
+                ( pxBuffer->ulSector >= ulFATSector ) && ( pxBuffer->ulSector < ( ulFATSector + ulFATSize ) ) )
+            {
+                /* A FAT sector is still in use, and it has not been written yet.  Try again at the next flush. */
+                return FF_ERR_NONE;
+            }
+        }
+
+        while( ulIndex < ulFATSize )
+        {
+            if( ( ( ulIndex % 8 ) == 0 ) && ( pxPartition->pucFATDirty[ ulIndex / 8 ] == 0U ) )
+            {
+                ulIndex += 8;
+                continue;
+            }
+
+            if( ( pxPartition->pucFATDirty[ ulIndex / 8 ] & ( 1U << ( ulIndex % 8 ) ) ) == 0U )
+            {
+                ulIndex++;
+                continue;
+            }
+
+            /* Collect a run of changed sectors, in the order of their addresses. */
+            ulFirst = ulIndex;
+
+            for( ulCount = 0; ( ulCount < ffconfigFAT_MIRROR_BATCH_SECTORS ) && ( ulIndex < ulFATSize ); ulCount++, ulIndex++ )
+            {
+                if( ( pxPartition->pucFATDirty[ ulIndex / 8 ] & ( 1U << ( ulIndex % 8 ) ) ) == 0U )
+                {
+                    break;
+                }
+            }
+
+            lResult = FF_BlockRead( pxIOManager, ulFATSector + ulFirst, ulCount, pxPartition->pucMirrorBuffer, pdTRUE );
+
+            for( xIndex = 1; ( xIndex < ( BaseType_t ) pxPartition->ucNumFATS ) && ( lResult >= 0 ); xIndex++ )
+            {
+                lResult = FF_BlockWrite( pxIOManager, ulFATSector + ( ( uint32_t ) xIndex * ulFATSize ) + ulFirst, ulCount, pxPartition->pucMirrorBuffer, pdTRUE );
+            }
+
+            if( lResult < 0 )
+            {
+                xError = ( FF_Error_t ) ( FF_ERR_DEVICE_DRIVER_FAILED | FF_MIRRORFATS );
+                break;
+            }
+
+            #if ( ffconfigFAT_USES_STAT != 0 )
+                {
+                    fatStat.mirrorBatches++;
+                    fatStat.mirrorSectors += ulCount;
+                }
+            #endif
+
+            for( ulIndex = ulFirst; ulIndex < ( ulFirst + ulCount ); ulIndex++ )
+            {
+                pxPartition->pucFATDirty[ ulIndex / 8 ] &= ( uint8_t ) ~( 1U << ( ulIndex % 8 ) );
+            }
+        }
+
+        if( FF_isERR( xError ) == pdFALSE )
+        {
+            xError = prvWriteVolumeDirty( pxIOManager, pdFALSE );
+        }
+
+        if( FF_isERR( xError ) == pdFALSE )
+        {
+            pxPartition->xFATMirrorDirty = pdFALSE;
+        }
+
+        return xError;
+    } /* FF_MirrorFATs() */
+/*-----------------------------------------------------------*/
+
+/**
+ *	@private
+ *	@brief	Called while mounting a volume with more than one FAT.  When the
+ *	@brief	volume was not unmounted cleanly, the first FAT is copied to the
+ *	@brief	other FAT(s).  When there is not enough memory, all FATs will be
+ *	@brief	written directly, as if ffconfigDEFER_FAT_MIRROR were not defined.
+ **/
+    FF_Error_t FF_InitFATMirror( FF_IOManager_t * pxIOManager )
+    {
+        FF_Partition_t * pxPartition = &( pxIOManager->xPartition );
+        const uint32_t ulFATSize = pxPartition->ulSectorsPerFAT * pxPartition->ucBlkFactor;
+        FF_Error_t xError = FF_ERR_NONE;
+        BaseType_t xRepair = pdTRUE;
+        uint32_t ulEntry;
+
+        FF_FreeFATMirror( pxIOManager );
+
+        if( pxPartition->ucNumFATS > 1U )
+        {
+            pxPartition->pucFATDirty = ( uint8_t * ) ffconfigMALLOC( ( ulFATSize + 7 ) / 8 );
+            pxPartition->pucMirrorBuffer = ( uint8_t * ) ffconfigMALLOC_SECTOR( ffconfigFAT_MIRROR_BATCH_SECTORS * pxIOManager->usSectorSize );
+
+            if( ( pxPartition->pucFATDirty == NULL ) || ( pxPartition->pucMirrorBuffer == NULL ) )
+            {
+                FF_PRINTF( "FF_InitFATMirror: no memory, all FATs are written directly\n" );
+                FF_FreeFATMirror( pxIOManager );
+            }
+            else
+            {
+                if( pxPartition->ucType != FF_T_FAT12 )
+                {
+                    FF_LockFAT( pxIOManager );
+                    {
+                        ulEntry = FF_getFATEntry( pxIOManager, 1, &xError, NULL );
+                    }
+                    FF_UnlockFAT( pxIOManager );
+
+                    if( pxPartition->ucType == FF_T_FAT32 )
+                    {
+                        xRepair = ( ulEntry & fatFAT32_CLEAN_SHUTDOWN ) == 0UL;
+                    }
+                    else
+                    {
+                        xRepair = ( ulEntry & fatFAT16_CLEAN_SHUTDOWN ) == 0UL;
+                    }
+                }
+
+                /* FAT12 has no "clean shut-down" bit, but its FATs are small. */
+                if( ( FF_isERR( xError ) == pdFALSE ) && ( xRepair != pdFALSE ) )
+                {
+                    FF_PRINTF( "FF_InitFATMirror: volume not cleanly unmounted, copying the first FAT\n" );
+                    memset( pxPartition->pucFATDirty, 0xFF, ( ulFATSize + 7 ) / 8 );
+                    pxPartition->xFATMirrorDirty = pdTRUE;
+
+                    FF_LockFAT( pxIOManager );
+                    FF_PendSemaphore( pxIOManager->pvSemaphore );
+                    {
+                        xError = FF_MirrorFATs( pxIOManager );
+                    }
+                    FF_ReleaseSemaphore( pxIOManager->pvSemaphore );
+                    FF_UnlockFAT( pxIOManager );
+                }
+                else
+                {
+                    memset( pxPartition->pucFATDirty, 0x00, ( ulFATSize + 7 ) / 8 );
+                }
+            }
+        }
+
+        return xError;
+    } /* FF_InitFATMirror() */
+/*-----------------------------------------------------------*/
+
+    void FF_FreeFATMirror( FF_IOManager_t * pxIOManager )
+    {
+        FF_Partition_t * pxPartition = &( pxIOManager->xPartition );
+
+        if( pxPartition->pucFATDirty != NULL )
+        {
+            ffconfigFREE( pxPartition->pucFATDirty );
+            pxPartition->pucFATDirty = NULL;
+        }
+
+        if( pxPartition->pucMirrorBuffer != NULL )
+        {
+            ffconfigFREE( pxPartition->pucMirrorBuffer );
+            pxPartition->pucMirrorBuffer = NULL;
+        }
+
+        pxPartition->xFATMirrorDirty = pdFALSE;
+    } /* FF_FreeFATMirror() */
+/*-----------------------------------------------------------*/
+
+#endif /* ffconfigDEFER_FAT_MIRROR */
+
 #if ( ffconfigFAT12_SUPPORT != 0 )
     static FF_Error_t prvPutFAT12Entry( FF_IOManager_t * pxIOManager,
                                         uint32_t ulCluster,
@@ -788,7 +1144,10 @@ BaseType_t FF_isEndOfChain( FF_IOManager_t * pxIOManager,
         FF_Error_t xError = FF_ERR_NONE;
         BaseType_t xIndex;
 
-        #if ( ffconfigWRITE_BOTH_FATS != 0 )
+        #if ( ffconfigDEFER_FAT_MIRROR != 0 )
+            /* The other FAT(s) will be updated by FF_MirrorFATs(). */
+            const BaseType_t xNumFATs = ( pxIOManager->xPartition.pucFATDirty != NULL ) ? 1 : pxIOManager->xPartition.ucNumFATS;
+        #elif ( ffconfigWRITE_BOTH_FATS != 0 )
             const BaseType_t xNumFATs = pxIOManager->xPartition.ucNumFATS;
         #else
             const BaseType_t xNumFATs = 1;
@@ -886,7 +1245,10 @@ FF_Error_t FF_putFATEntry( FF_IOManager_t * pxIOManager,
     BaseType_t xIndex;
     FF_Error_t xError = FF_ERR_NONE;
 
-    #if ( ffconfigWRITE_BOTH_FATS != 0 )
+    #if ( ffconfigDEFER_FAT_MIRROR != 0 )
+        /* The other FAT(s) will be updated by FF_MirrorFATs(). */
+        const BaseType_t xNumFATs = ( pxIOManager->xPartition.pucFATDirty != NULL ) ? 1 : pxIOManager->xPartition.ucNumFATS;
+    #elif ( ffconfigWRITE_BOTH_FATS != 0 )
         const BaseType_t xNumFATs = pxIOManager->xPartition.ucNumFATS;
     #else
         const BaseType_t xNumFATs = 1;
@@ -911,6 +1273,13 @@ FF_Error_t FF_putFATEntry( FF_IOManager_t * pxIOManager,
         {
             ulFATOffset = ulCluster * 2;
         }
+
+        #if ( ffconfigEXFAT_SUPPORT != 0 )
+            else if( pxIOManager->xPartition.ucType == FF_T_EXFAT )
+            {
+                ulFATOffset = ulCluster * 4;
+            }
+        #endif
         else /* pxIOManager->xPartition.ucType == FF_T_FAT12 */
         {
             ulFATOffset = ulCluster + ( ulCluster / 2 );
@@ -924,6 +1293,19 @@ FF_Error_t FF_putFATEntry( FF_IOManager_t * pxIOManager,
 
         ulFATSector = FF_getRealLBA( pxIOManager, ulFATSector );
         ulFATSector += ulLBAAdjust;
+
+        #if ( ffconfigDEFER_FAT_MIRROR != 0 )
+            if( pxIOManager->xPartition.pucFATDirty != NULL )
+            {
+                xError = prvMarkFATDirty( pxIOManager, ulFATSector );
+
+                if( ( FF_isERR( xError ) == pdFALSE ) && ( ulRelClusterEntry == ( uint32_t ) ( pxIOManager->usSectorSize - 1 ) ) )
+                {
+                    /* A FAT12 entry may be divided over 2 sectors. */
+                    xError = prvMarkFATDirty( pxIOManager, ulFATSector + 1 );
+                }
+            }
+        #endif
     }
 
     #if ( ffconfigFAT12_SUPPORT != 0 )
@@ -964,6 +1346,13 @@ FF_Error_t FF_putFATEntry( FF_IOManager_t * pxIOManager,
             {
                 FF_putShort( pxBuffer->pucBuffer, ulRelClusterEntry, ( uint16_t ) ulValue );
             }
+
+            #if ( ffconfigEXFAT_SUPPORT != 0 )
+                else if( pxIOManager->xPartition.ucType == FF_T_EXFAT )
+                {
+                    FF_putLong( pxBuffer->pucBuffer, ulRelClusterEntry, ulValue );
+                }
+            #endif
             else
             {
                 ulFATEntry = ( uint32_t ) FF_getShort( pxBuffer->pucBuffer, ulRelClusterEntry );
@@ -1092,6 +1481,14 @@ uint32_t FF_FindFreeCluster( FF_IOManager_t * pxIOManager,
 
     ulCluster = pxIOManager->xPartition.ulLastFreeCluster;
 
+    #if ( ffconfigEXFAT_SUPPORT != 0 )
+        /* exFAT keeps track of the free clusters in an allocation bitmap. */
+        if( pxIOManager->xPartition.ucType == FF_T_EXFAT )
+        {
+            ulCluster = FF_exFATFindFreeCluster( pxIOManager, &xError );
+        }
+        else
+    #endif
     #if ( ffconfigFAT12_SUPPORT != 0 )
         /* FAT12 tables are too small to optimise, and would make it very complicated! */
         if( pxIOManager->xPartition.ucType == FF_T_FAT12 )
@@ -1220,6 +1617,14 @@ uint32_t FF_FindFreeCluster( FF_IOManager_t * pxIOManager,
 
         xTempError = FF_putFATEntry( pxIOManager, ulCluster, 0xFFFFFFFF, NULL );
 
+        #if ( ffconfigEXFAT_SUPPORT != 0 )
+            if( ( FF_isERR( xTempError ) == pdFALSE ) && ( pxIOManager->xPartition.ucType == FF_T_EXFAT ) )
+            {
+                /* The FAT entry only forms the chain, the bitmap tells that the cluster is in use. */
+                xTempError = FF_exFATSetBitmap( pxIOManager, ulCluster, 1, pdTRUE );
+            }
+        #endif
+
         if( FF_isERR( xError ) == pdFALSE )
         {
             xError = xTempError;
@@ -1315,6 +1720,300 @@ uint32_t FF_GetChainLength( FF_IOManager_t * pxIOManager,
 }
 /*-----------------------------------------------------------*/
 
+#if ( ffconfigFAT12_SUPPORT != 0 )
+    static FF_Error_t prvUnlinkClusterChainSimple( FF_IOManager_t * pxIOManager,
+                                                   uint32_t ulStartCluster,
+                                                   BaseType_t xDoTruncate,
+                                                   uint32_t * pulLength,
+                                                   uint32_t * pulLastFree )
+    {
+        uint32_t ulFATEntry;
+        uint32_t ulCurrentCluster;
+        FF_Error_t xTempError;
+        FF_Error_t xError = FF_ERR_NONE;
+        FF_FATBuffers_t xFATBuffers;
+
+        FF_InitFATBuffers( &xFATBuffers, FF_MODE_WRITE );
+
+        /* Free all clusters in the chain! */
+        ulCurrentCluster = ulStartCluster;
+        ulFATEntry = ulCurrentCluster;
+
+        do
+        {
+            /* Sector will now be fetched in write-mode. */
+            ulFATEntry = FF_getFATEntry( pxIOManager, ulFATEntry, &xError, &xFATBuffers );
+
+            if( FF_isERR( xError ) )
+            {
+                break;
+            }
+
+            if( ( xDoTruncate != pdFALSE ) && ( ulCurrentCluster == ulStartCluster ) )
+            {
+                xError = FF_putFATEntry( pxIOManager, ulCurrentCluster, 0xFFFFFFFF, &xFATBuffers );
+            }
+            else
+            {
+                xError = FF_putFATEntry( pxIOManager, ulCurrentCluster, 0x00000000, &xFATBuffers );
+                ( *pulLength )++;
+            }
+
+            if( FF_isERR( xError ) )
+            {
+                break;
+            }
+
+            if( *pulLastFree > ulCurrentCluster )
+            {
+                *pulLastFree = ulCurrentCluster;
+            }
+
+            ulCurrentCluster = ulFATEntry;
+        } while( FF_isEndOfChain( pxIOManager, ulFATEntry ) == pdFALSE );
+
+        xTempError = FF_ReleaseFATBuffers( pxIOManager, &xFATBuffers );
+
+        if( FF_isERR( xError ) == pdFALSE )
+        {
+            xError = xTempError;
+        }
+
+        return xError;
+    }
+#endif /* if ( ffconfigFAT12_SUPPORT != 0 ) */
+/*-----------------------------------------------------------*/
+
+/* Write a changed sector of the first FAT to the other FAT(s) as well, and
+ * release it. */
+static FF_Error_t prvReleaseUnlinkSector( FF_IOManager_t * pxIOManager,
+                                          FF_Buffer_t * pxBuffer,
+                                          BaseType_t xNumFATs )
+{
+    FF_Error_t xError = FF_ERR_NONE;
+    FF_Error_t xTempError;
+    FF_Buffer_t * pxCopy;
+    BaseType_t xIndex;
+
+    for( xIndex = 1; xIndex < xNumFATs; xIndex++ )
+    {
+        pxCopy = FF_GetBuffer( pxIOManager,
+                               pxBuffer->ulSector + ( ( uint32_t ) xIndex * pxIOManager->xPartition.ulSectorsPerFAT * pxIOManager->xPartition.ucBlkFactor ),
+                               FF_MODE_WRITE );
+
+        if( pxCopy == NULL )
+        {
+            xError = ( FF_Error_t ) ( FF_ERR_DEVICE_DRIVER_FAILED | FF_PUTFATENTRY );
+            break;
+        }
+
+        memcpy( pxCopy->pucBuffer, pxBuffer->pucBuffer, pxIOManager->usSectorSize );
+        xError = FF_ReleaseBuffer( pxIOManager, pxCopy );
+
+        if( FF_isERR( xError ) )
+        {
+            break;
+        }
+    }
+
+    xTempError = FF_ReleaseBuffer( pxIOManager, pxBuffer );
+
+    if( FF_isERR( xError ) == pdFALSE )
+    {
+        xError = xTempError;
+    }
+
+    return xError;
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Free a chain of FAT16, FAT32 or exFAT clusters.  Each sector of the FAT is
+ * fetched once for all entries of the chain that it holds, and a run of
+ * contiguous clusters within a sector is cleared at once.
+ */
+static FF_Error_t prvUnlinkClusterChainBySector( FF_IOManager_t * pxIOManager,
+                                                 uint32_t ulStartCluster,
+                                                 BaseType_t xDoTruncate,
+                                                 uint32_t * pulLength,
+                                                 uint32_t * pulLastFree )
+{
+    FF_Partition_t * pxPartition = &( pxIOManager->xPartition );
+    const uint32_t ulEntrySize = ( pxPartition->ucType == FF_T_FAT16 ) ? 2UL : 4UL;
+    const uint32_t ulEntriesPerSector = ( uint32_t ) pxIOManager->usSectorSize / ulEntrySize;
+    const uint32_t ulFATSector = FF_getRealLBA( pxIOManager, pxPartition->ulFATBeginLBA );
+    FF_Buffer_t * pxBuffer = NULL;
+    FF_Error_t xError = FF_ERR_NONE;
+    FF_Error_t xTempError;
+    uint32_t ulCurrentCluster = ulStartCluster;
+    uint32_t ulRunEnd;
+    uint32_t ulFATEntry;
+    uint32_t ulSector;
+    uint8_t * pucEntry;
+
+    #if ( ffconfigEXFAT_SUPPORT != 0 )
+        /* A run of neighbouring clusters that still has to be cleared in the bitmap. */
+        uint32_t ulRunStart = 0;
+        uint32_t ulRunLength = 0;
+    #endif
+
+    #if ( ffconfigDEFER_FAT_MIRROR != 0 )
+        /* The other FAT(s) will be updated by FF_MirrorFATs(). */
+        const BaseType_t xNumFATs = ( pxPartition->pucFATDirty != NULL ) ? 1 : pxPartition->ucNumFATS;
+    #elif ( ffconfigWRITE_BOTH_FATS != 0 )
+        const BaseType_t xNumFATs = pxPartition->ucNumFATS;
+    #else
+        const BaseType_t xNumFATs = 1;
+    #endif
+
+    do
+    {
+        if( ( ulCurrentCluster < 2UL ) || ( ulCurrentCluster >= pxPartition->ulNumClusters ) )
+        {
+            /* Avoid corrupting the disk. */
+            xError = ( FF_Error_t ) ( FF_ERR_IOMAN_NOT_ENOUGH_FREE_SPACE | FF_PUTFATENTRY );
+            break;
+        }
+
+        ulSector = ulFATSector + ( ulCurrentCluster / ulEntriesPerSector );
+
+        if( ( pxBuffer == NULL ) || ( pxBuffer->ulSector != ulSector ) )
+        {
+            if( pxBuffer != NULL )
+            {
+                xError = prvReleaseUnlinkSector( pxIOManager, pxBuffer, xNumFATs );
+                pxBuffer = NULL;
+
+                if( FF_isERR( xError ) )
+                {
+                    break;
+                }
+            }
+
+            #if ( ffconfigDEFER_FAT_MIRROR != 0 )
+                if( pxPartition->pucFATDirty != NULL )
+                {
+                    xError = prvMarkFATDirty( pxIOManager, ulSector );
+
+                    if( FF_isERR( xError ) )
+                    {
+                        break;
+                    }
+                }
+            #endif
+
+            pxBuffer = FF_GetBuffer( pxIOManager, ulSector, FF_MODE_WRITE );
+
+            if( pxBuffer == NULL )
+            {
+                xError = ( FF_Error_t ) ( FF_ERR_DEVICE_DRIVER_FAILED | FF_PUTFATENTRY );
+                break;
+            }
+        }
+
+        /* Follow the chain as long as it is contiguous, and stays within this sector. */
+        ulRunEnd = ulCurrentCluster;
+
+        for( ; ; )
+        {
+            pucEntry = pxBuffer->pucBuffer + ( ( ulRunEnd % ulEntriesPerSector ) * ulEntrySize );
+
+            if( ulEntrySize == 2UL )
+            {
+                ulFATEntry = ( uint32_t ) FF_getShort( pucEntry, 0 );
+            }
+            else if( pxPartition->ucType == FF_T_FAT32 )
+            {
+                ulFATEntry = FF_getLong( pucEntry, 0 ) & 0x0fffffffUL;
+            }
+            else
+            {
+                ulFATEntry = FF_getLong( pucEntry, 0 );
+            }
+
+            if( ( ulFATEntry != ( ulRunEnd + 1 ) ) || ( ( ulFATEntry % ulEntriesPerSector ) == 0UL ) ||
+                ( ulFATEntry >= pxPartition->ulNumClusters ) ||
+                ( ( xDoTruncate != pdFALSE ) && ( ulRunEnd == ulStartCluster ) ) )
+            {
+                break;
+            }
+
+            ulRunEnd = ulFATEntry;
+        }
+
+        if( ( xDoTruncate != pdFALSE ) && ( ulCurrentCluster == ulStartCluster ) )
+        {
+            /* The first cluster becomes the end of the chain. */
+            if( ulEntrySize == 2UL )
+            {
+                FF_putShort( pucEntry, 0, 0xFFFF );
+            }
+            else if( pxPartition->ucType == FF_T_FAT32 )
+            {
+                FF_putLong( pucEntry, 0, 0x0fffffffUL );
+            }
+            else
+            {
+                FF_putLong( pucEntry, 0, 0xffffffffUL );
+            }
+        }
+        else
+        {
+            memset( pxBuffer->pucBuffer + ( ( ulCurrentCluster % ulEntriesPerSector ) * ulEntrySize ),
+                    0,
+                    ( size_t ) ( ( ulRunEnd - ulCurrentCluster ) + 1UL ) * ulEntrySize );
+            *pulLength += ( ulRunEnd - ulCurrentCluster ) + 1UL;
+
+            if( *pulLastFree > ulCurrentCluster )
+            {
+                *pulLastFree = ulCurrentCluster;
+            }
+
+            #if ( ffconfigEXFAT_SUPPORT != 0 )
+                if( pxPartition->ucType == FF_T_EXFAT )
+                {
+                    if( ( ulRunLength != 0 ) && ( ulCurrentCluster == ( ulRunStart + ulRunLength ) ) )
+                    {
+                        ulRunLength += ( ulRunEnd - ulCurrentCluster ) + 1UL;
+                    }
+                    else
+                    {
+                        if( ulRunLength != 0 )
+                        {
+                            xError = FF_exFATSetBitmap( pxIOManager, ulRunStart, ulRunLength, pdFALSE );
+                        }
+
+                        ulRunStart = ulCurrentCluster;
+                        ulRunLength = ( ulRunEnd - ulCurrentCluster ) + 1UL;
+                    }
+                }
+            #endif
+        }
+
+        ulCurrentCluster = ulFATEntry;
+    } while( ( FF_isERR( xError ) == pdFALSE ) && ( FF_isEndOfChain( pxIOManager, ulFATEntry ) == pdFALSE ) );
+
+    #if ( ffconfigEXFAT_SUPPORT != 0 )
+        if( ( FF_isERR( xError ) == pdFALSE ) && ( ulRunLength != 0 ) )
+        {
+            xError = FF_exFATSetBitmap( pxIOManager, ulRunStart, ulRunLength, pdFALSE );
+        }
+    #endif
+
+    if( pxBuffer != NULL )
+    {
+        xTempError = prvReleaseUnlinkSector( pxIOManager, pxBuffer, xNumFATs );
+
+        if( FF_isERR( xError ) == pdFALSE )
+        {
+            xError = xTempError;
+        }
+    }
+
+    return xError;
+}
+/*-----------------------------------------------------------*/
+
 /**
  *	@private
  *	@brief Free's Disk space by freeing unused links on Cluster Chains
@@ -1333,13 +2032,10 @@ FF_Error_t FF_UnlinkClusterChain( FF_IOManager_t * pxIOManager,
                                   uint32_t ulStartCluster,
                                   BaseType_t xDoTruncate )
 {
-    uint32_t ulFATEntry;
-    uint32_t ulCurrentCluster;
     uint32_t ulLength = 0;
     uint32_t ulLastFree = ulStartCluster;
     FF_Error_t xTempError;
-    FF_Error_t xError = FF_ERR_NONE;
-    FF_FATBuffers_t xFATBuffers;
+    FF_Error_t xError;
 
     BaseType_t xTakeLock = FF_Has_Lock( pxIOManager, FF_FAT_LOCK ) == pdFALSE;
 
@@ -1348,46 +2044,17 @@ FF_Error_t FF_UnlinkClusterChain( FF_IOManager_t * pxIOManager,
         FF_LockFAT( pxIOManager );
     }
 
-    FF_InitFATBuffers( &xFATBuffers, FF_MODE_WRITE );
-
-    ulFATEntry = ulStartCluster;
-
-    /* Free all clusters in the chain! */
-    ulCurrentCluster = ulStartCluster;
-    ulFATEntry = ulCurrentCluster;
-
-    do
-    {
-        /* Sector will now be fetched in write-mode. */
-        ulFATEntry = FF_getFATEntry( pxIOManager, ulFATEntry, &xError, &xFATBuffers );
-
-        if( FF_isERR( xError ) )
-        {
-            break;
-        }
-
-        if( ( xDoTruncate != pdFALSE ) && ( ulCurrentCluster == ulStartCluster ) )
+    #if ( ffconfigFAT12_SUPPORT != 0 )
+        if( pxIOManager->xPartition.ucType == FF_T_FAT12 )
         {
-            xError = FF_putFATEntry( pxIOManager, ulCurrentCluster, 0xFFFFFFFF, &xFATBuffers );
+            /* A FAT12 entry may be divided over 2 sectors. */
+            xError = prvUnlinkClusterChainSimple( pxIOManager, ulStartCluster, xDoTruncate, &ulLength, &ulLastFree );
         }
         else
-        {
-            xError = FF_putFATEntry( pxIOManager, ulCurrentCluster, 0x00000000, &xFATBuffers );
-            ulLength++;
-        }
-
-        if( FF_isERR( xError ) )
-        {
-            break;
-        }
-
-        if( ulLastFree > ulCurrentCluster )
-        {
-            ulLastFree = ulCurrentCluster;
-        }
-
-        ulCurrentCluster = ulFATEntry;
-    } while( FF_isEndOfChain( pxIOManager, ulFATEntry ) == pdFALSE );
+    #endif
+    {
+        xError = prvUnlinkClusterChainBySector( pxIOManager, ulStartCluster, xDoTruncate, &ulLength, &ulLastFree );
+    }
 
     if( FF_isERR( xError ) == pdFALSE )
     {
@@ -1397,13 +2064,6 @@ FF_Error_t FF_UnlinkClusterChain( FF_IOManager_t * pxIOManager,
         }
     }
 
-    xTempError = FF_ReleaseFATBuffers( pxIOManager, &xFATBuffers );
-
-    if( FF_isERR( xError ) == pdFALSE )
-    {
-        xError = xTempError;
-    }
-
     if( xTakeLock )
     {
         FF_UnlockFAT( pxIOManager );
@@ -1475,6 +2135,13 @@ uint32_t FF_CountFreeClusters( FF_IOManager_t * pxIOManager,
         FF_LockFAT( pxIOManager );
     }
 
+    #if ( ffconfigEXFAT_SUPPORT != 0 )
+        if( pxIOManager->xPartition.ucType == FF_T_EXFAT )
+        {
+            ulFreeClusters = FF_exFATCountFreeClusters( pxIOManager, &xError );
+        }
+        else
+    #endif
     #if ( ffconfigFAT12_SUPPORT != 0 )
         /* FAT12 tables are too small to optimise, and would make it very complicated! */
         if( pxIOManager->xPartition.ucType == FF_T_FAT12 )
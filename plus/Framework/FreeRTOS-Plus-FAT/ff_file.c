@@ -36,6 +36,10 @@
 
 #include "ff_headers.h"
 
+#if ( ffconfigDEFERRED_DELETE != 0 )
+    #include <stdio.h>
+#endif
+
 #if ( ffconfigUNICODE_UTF16_SUPPORT != 0 )
     #include <wchar.h>
 #endif
@@ -64,6 +68,20 @@ static uint32_t FF_FileLBA( FF_FILE * pxFile );
 static FF_Error_t FF_ExtendFile( FF_FILE * pxFile,
                                  uint32_t ulSize );
 
+static uint32_t FF_TraverseFile( FF_FILE * pxFile,
+                                 uint32_t ulStart,
+                                 uint32_t ulCount,
+                                 FF_Error_t * pxError );
+
+static FF_Error_t FF_RmDirEntries( FF_IOManager_t * pxIOManager,
+                                   uint16_t usDirEntry,
+                                   FF_FetchContext_t * pxContext );
+
+#if ( ffconfigEXFAT_SUPPORT != 0 )
+    static FF_Error_t FF_ExtendContiguous( FF_FILE * pxFile,
+                                           uint32_t ulTotalClustersNeeded );
+#endif
+
 /*-----------------------------------------------------------*/
 
 /**
@@ -132,7 +150,7 @@ static FF_FILE * prvAllocFileHandle( FF_IOManager_t * pxIOManager,
 {
     FF_FILE * pxFile;
 
-    pxFile = ffconfigMALLOC( sizeof( FF_FILE ) );
+    pxFile = ffconfigMALLOC_CONTROL( sizeof( FF_FILE ) );
 
     if( pxFile == NULL )
     {
@@ -144,7 +162,7 @@ static FF_FILE * prvAllocFileHandle( FF_IOManager_t * pxIOManager,
 
         #if ( ffconfigOPTIMISE_UNALIGNED_ACCESS != 0 )
             {
-                pxFile->pucBuffer = ( uint8_t * ) ffconfigMALLOC( pxIOManager->usSectorSize );
+                pxFile->pucBuffer = ( uint8_t * ) ffconfigMALLOC_SECTOR( pxIOManager->usSectorSize );
 
                 if( pxFile->pucBuffer != NULL )
                 {
@@ -332,6 +350,15 @@ static FF_FILE * prvAllocFileHandle( FF_IOManager_t * pxIOManager,
 	/* See if the file does exist within the given directory. */
         ulFileCluster = FF_FindEntryInDir( pxIOManager, &xFindParams, pcFileName, 0x00, &xDirEntry, &xError );
 
+        #if ( ffconfigEXFAT_SUPPORT != 0 )
+            if( ( ulFileCluster == 0ul ) && ( FF_isERR( xError ) == pdFALSE ) &&
+                ( pxIOManager->xPartition.ucType == FF_T_EXFAT ) && ( xDirEntry.pcFileName[ 0 ] != 0 ) )
+            {
+                /* An empty exFAT file has no clusters, give it a pseudo cluster number '1'. */
+                ulFileCluster = 1;
+            }
+        #endif
+
         if( ulFileCluster == 0ul )
         {
             /* If cluster 0 was returned, it might be because the file has no allocated cluster,
@@ -383,6 +410,14 @@ static FF_FILE * prvAllocFileHandle( FF_IOManager_t * pxIOManager,
         {
             xError = ( FF_Error_t ) ( FF_ERR_FILE_IS_READ_ONLY | FF_OPEN );
         }
+
+        #if ( ffconfigEXFAT_SUPPORT != 0 )
+            else if( ( pxIOManager->xPartition.ucType == FF_T_EXFAT ) && ( xDirEntry.ulFileSizeHigh != 0ul ) )
+            {
+                /* File offsets are 32-bit, files of 4 GB and more can not be opened. */
+                xError = ( FF_Error_t ) ( FF_ERR_FILE_TOO_LARGE | FF_OPEN );
+            }
+        #endif
     }
 
     if( FF_isERR( xError ) == pdFALSE )
@@ -404,6 +439,35 @@ static FF_FILE * prvAllocFileHandle( FF_IOManager_t * pxIOManager,
         pxFile->ulEndOfChain = 0;
         pxFile->ulValidFlags &= ~( FF_VALID_FLAG_DELETED );
 
+        #if ( ffconfigEXFAT_SUPPORT != 0 )
+            {
+                pxFile->ucStreamFlags = 0U;
+
+                if( pxIOManager->xPartition.ucType == FF_T_EXFAT )
+                {
+                    pxFile->ucStreamFlags = xDirEntry.ucStreamFlags;
+
+                    /* The data behind the valid data length was never written. */
+                    pxFile->ulFileSize = xDirEntry.ulValidDataLength;
+
+                    if( ( ( pxFile->ucStreamFlags & FF_EXFAT_FLAG_NO_FAT_CHAIN ) != 0U ) && ( pxFile->ulObjectCluster != 0ul ) )
+                    {
+                        /* A contiguous file: the length of its chain follows from the allocated size. */
+                        uint32_t ulClusterSize = pxIOManager->xPartition.usBlkSize * pxIOManager->xPartition.ulSectorsPerCluster;
+
+                        pxFile->ulChainLength = ( xDirEntry.ulFileSize + ulClusterSize - 1 ) / ulClusterSize;
+
+                        if( pxFile->ulChainLength == 0ul )
+                        {
+                            pxFile->ulChainLength = 1ul;
+                        }
+
+                        pxFile->ulEndOfChain = pxFile->ulObjectCluster + pxFile->ulChainLength - 1ul;
+                    }
+                }
+            }
+        #endif /* ffconfigEXFAT_SUPPORT */
+
         /* Add pxFile onto the end of our linked list of FF_FILE objects.
          * But first make sure that there are not 2 handles with write access
          * to the same object. */
@@ -591,7 +655,6 @@ static FF_FILE * prvAllocFileHandle( FF_IOManager_t * pxIOManager,
 #endif
 {
     FF_FILE * pxFile;
-    uint8_t ucEntryBuffer[ 32 ];
     FF_FetchContext_t xFetchContext;
     FF_Error_t xError = FF_ERR_NONE;
 
@@ -669,26 +732,8 @@ static FF_FILE * prvAllocFileHandle( FF_IOManager_t * pxIOManager,
                     }
                 #endif /* ffconfigHASH_CACHE */
 
-                /* Edit the Directory Entry, so it will show as deleted.
-                 * First remove the LFN entries: */
-                xError = FF_RmLFNs( pxIOManager, pxFile->usDirEntry, &xFetchContext );
-
-                if( FF_isERR( xError ) )
-                {
-                    break;
-                }
-
-                /* And remove the Short file name entry: */
-                xError = FF_FetchEntryWithContext( pxIOManager, pxFile->usDirEntry, &xFetchContext, ucEntryBuffer );
-
-                if( FF_isERR( xError ) == pdFALSE )
-                {
-                    ucEntryBuffer[ 0 ] = FF_FAT_DELETED;
-                    FF_putShort( ucEntryBuffer, FF_FAT_DIRENT_CLUS_HIGH, ( uint32_t ) 0ul );
-                    FF_putShort( ucEntryBuffer, FF_FAT_DIRENT_CLUS_LOW, ( uint32_t ) 0ul );
-
-                    xError = FF_PushEntryWithContext( pxIOManager, pxFile->usDirEntry, &xFetchContext, ucEntryBuffer );
-                }
+                /* Edit the Directory Entry, so it will show as deleted. */
+                xError = FF_RmDirEntries( pxIOManager, pxFile->usDirEntry, &xFetchContext );
 
                 if( FF_isERR( xError ) )
                 {
@@ -748,7 +793,6 @@ static FF_FILE * prvAllocFileHandle( FF_IOManager_t * pxIOManager,
 {
     FF_FILE * pxFile;
     FF_Error_t xError = FF_ERR_NONE;
-    uint8_t ucEntryBuffer[ 32 ];
     FF_FetchContext_t xFetchContext;
 
     /* Opening the file-to-be-deleted in WR mode has two advantages:
@@ -765,13 +809,23 @@ static FF_FILE * prvAllocFileHandle( FF_IOManager_t * pxIOManager,
         /* Ensure there is actually a cluster chain to delete! */
         if( pxFile->ulObjectCluster != 0 )
         {
-            /* Lock the FAT so its thread-safe. */
-            FF_LockFAT( pxIOManager );
+            #if ( ffconfigEXFAT_SUPPORT != 0 )
+                if( ( pxFile->ucStreamFlags & FF_EXFAT_FLAG_NO_FAT_CHAIN ) != 0U )
+                {
+                    /* A contiguous exFAT file only occupies bits in the allocation bitmap. */
+                    xError = FF_exFATFreeClusters( pxIOManager, pxFile->ulObjectCluster, pxFile->ulChainLength );
+                }
+                else
+            #endif
             {
-                /* 0 to delete the entire chain! */
-                xError = FF_UnlinkClusterChain( pxIOManager, pxFile->ulObjectCluster, 0 );
+                /* Lock the FAT so its thread-safe. */
+                FF_LockFAT( pxIOManager );
+                {
+                    /* 0 to delete the entire chain! */
+                    xError = FF_UnlinkClusterChain( pxIOManager, pxFile->ulObjectCluster, 0 );
+                }
+                FF_UnlockFAT( pxIOManager );
             }
-            FF_UnlockFAT( pxIOManager );
         }
 
         if( FF_isERR( xError ) == pdFALSE )
@@ -798,25 +852,7 @@ static FF_FILE * prvAllocFileHandle( FF_IOManager_t * pxIOManager,
                         FF_UnHashDir( pxIOManager, pxFile->ulDirCluster );
                     }
                 #endif /* ffconfigHASH_CACHE */
-                /* Remove LFN entries, if any. */
-                xError = FF_RmLFNs( pxIOManager, ( uint16_t ) pxFile->usDirEntry, &xFetchContext );
-
-                if( FF_isERR( xError ) )
-                {
-                    break;
-                }
-
-                /* Remove the Short file name entry. */
-                xError = FF_FetchEntryWithContext( pxIOManager, pxFile->usDirEntry, &xFetchContext, ucEntryBuffer );
-
-                if( FF_isERR( xError ) == pdFALSE )
-                {
-                    ucEntryBuffer[ 0 ] = FF_FAT_DELETED;
-                    FF_putShort( ucEntryBuffer, FF_FAT_DIRENT_CLUS_HIGH, ( uint32_t ) 0ul );
-                    FF_putShort( ucEntryBuffer, FF_FAT_DIRENT_CLUS_LOW, ( uint32_t ) 0ul );
-
-                    xError = FF_PushEntryWithContext( pxIOManager, pxFile->usDirEntry, &xFetchContext, ucEntryBuffer );
-                }
+                xError = FF_RmDirEntries( pxIOManager, ( uint16_t ) pxFile->usDirEntry, &xFetchContext );
             } while( pdFALSE );
 
             {
@@ -852,6 +888,409 @@ static FF_FILE * prvAllocFileHandle( FF_IOManager_t * pxIOManager,
 }   /* FF_RmFile() */
 /*-----------------------------------------------------------*/
 
+#if ( ffconfigDEFERRED_DELETE != 0 )
+
+/**
+ *	@private
+ *	@brief	Free the first ffconfigDEFERRED_DELETE_BATCH clusters of one of the
+ *	@brief	files in ffconfigDEFERRED_DELETE_DIR, or delete the file when
+ *	@brief	little is left.
+ *
+ *	@return	pdTRUE when there may be more work to do.
+ **/
+    static BaseType_t prvDeferredDeleteStep( FF_IOManager_t * pxIOManager )
+    {
+        FF_DirEnt_t xDirEntry;
+        FF_FILE * pxFile;
+        FF_Error_t xError;
+        char pcPath[ ffconfigMAX_FILENAME ];
+        uint32_t ulBatchBytes;
+        uint32_t ulFirstCluster;
+        uint32_t ulLastCluster = 0UL;
+        uint32_t ulNextCluster = 0UL;
+        BaseType_t xRemoveFile = pdFALSE;
+        BaseType_t xMoreWork = pdFALSE;
+
+        if( FF_Mounted( pxIOManager ) == pdFALSE )
+        {
+            /* FF_DeferredDeleteStart() must be called again after mounting. */
+            return pdFALSE;
+        }
+
+        do
+        {
+            xError = FF_FindFirst( pxIOManager, &xDirEntry, ffconfigDEFERRED_DELETE_DIR "/" );
+
+            while( ( FF_isERR( xError ) == pdFALSE ) && ( ( xDirEntry.ucAttrib & FF_FAT_ATTR_DIR ) != 0U ) )
+            {
+                /* Skip the "." and ".." entries. */
+                xError = FF_FindNext( pxIOManager, &xDirEntry );
+            }
+
+            FF_CleanupEntryFetch( pxIOManager, &( xDirEntry.xFetchContext ) );
+
+            if( FF_isERR( xError ) )
+            {
+                /* The end of the directory was reached, or the directory was
+                 * never created: there is nothing to delete. */
+                xError = FF_ERR_NONE;
+                break;
+            }
+
+            snprintf( pcPath, sizeof( pcPath ), "%s/%s", ffconfigDEFERRED_DELETE_DIR, xDirEntry.pcFileName );
+
+            pxFile = FF_Open( pxIOManager, pcPath, FF_MODE_READ, &xError );
+
+            if( pxFile == NULL )
+            {
+                break;
+            }
+
+            ulBatchBytes = ( uint32_t ) pxIOManager->xPartition.usBlkSize * pxIOManager->xPartition.ulSectorsPerCluster * ffconfigDEFERRED_DELETE_BATCH;
+            ulFirstCluster = pxFile->ulObjectCluster;
+
+            if( ( ulFirstCluster == 0UL ) || ( pxFile->ulFileSize <= ulBatchBytes ) )
+            {
+                xRemoveFile = pdTRUE;
+            }
+
+            #if ( ffconfigEXFAT_SUPPORT != 0 )
+                else if( ( pxFile->ucStreamFlags & FF_EXFAT_FLAG_NO_FAT_CHAIN ) != 0U )
+                {
+                    /* Freeing a contiguous exFAT file only clears bits in the bitmap. */
+                    xRemoveFile = pdTRUE;
+                }
+            #endif
+            else
+            {
+                FF_LockFAT( pxIOManager );
+                {
+                    ulLastCluster = FF_TraverseFAT( pxIOManager, ulFirstCluster, ffconfigDEFERRED_DELETE_BATCH - 1, &xError );
+
+                    if( FF_isERR( xError ) == pdFALSE )
+                    {
+                        ulNextCluster = FF_getFATEntry( pxIOManager, ulLastCluster, &xError, NULL );
+                    }
+                }
+                FF_UnlockFAT( pxIOManager );
+
+                if( ( FF_isERR( xError ) == pdFALSE ) && ( FF_isEndOfChain( pxIOManager, ulNextCluster ) != pdFALSE ) )
+                {
+                    /* The chain is shorter than the file size suggests. */
+                    xRemoveFile = pdTRUE;
+                }
+            }
+
+            if( ( FF_isERR( xError ) == pdFALSE ) && ( xRemoveFile == pdFALSE ) )
+            {
+                /* Detach the batch from the file, and write the directory entry
+                 * to disk before the clusters are freed.  A reset can leave at
+                 * most one batch of lost clusters, but never a free cluster that
+                 * is still part of a file. */
+                xError = FF_GetEntry( pxIOManager, pxFile->usDirEntry, pxFile->ulDirCluster, &xDirEntry );
+
+                if( FF_isERR( xError ) == pdFALSE )
+                {
+                    xDirEntry.ulObjectCluster = ulNextCluster;
+                    xDirEntry.ulFileSize -= ulBatchBytes;
+
+                    FF_LockDirectory( pxIOManager );
+                    {
+                        xError = FF_PutEntry( pxIOManager, pxFile->usDirEntry, pxFile->ulDirCluster, &xDirEntry, NULL );
+                    }
+                    FF_UnlockDirectory( pxIOManager );
+                }
+
+                if( FF_isERR( xError ) == pdFALSE )
+                {
+                    xError = FF_FlushCache( pxIOManager );
+                }
+
+                if( FF_isERR( xError ) == pdFALSE )
+                {
+                    FF_LockFAT( pxIOManager );
+                    {
+                        xError = FF_putFATEntry( pxIOManager, ulLastCluster, 0xFFFFFFFF, NULL );
+
+                        if( FF_isERR( xError ) == pdFALSE )
+                        {
+                            xError = FF_UnlinkClusterChain( pxIOManager, ulFirstCluster, pdFALSE );
+                        }
+                    }
+                    FF_UnlockFAT( pxIOManager );
+                }
+
+                if( FF_isERR( xError ) == pdFALSE )
+                {
+                    xError = FF_FlushCache( pxIOManager );
+                }
+            }
+
+            {
+                FF_Error_t xTempError;
+
+                /* The file was opened for reading, closing it won't change the entry. */
+                xTempError = FF_Close( pxFile );
+
+                if( FF_isERR( xError ) == pdFALSE )
+                {
+                    xError = xTempError;
+                }
+            }
+
+            if( ( FF_isERR( xError ) == pdFALSE ) && ( xRemoveFile != pdFALSE ) )
+            {
+                xError = FF_RmFile( pxIOManager, pcPath );
+            }
+
+            /* After an error, the task waits until it is woken up again. */
+            xMoreWork = ( FF_isERR( xError ) == pdFALSE ) ? pdTRUE : pdFALSE;
+        } while( pdFALSE );
+
+        if( FF_isERR( xError ) )
+        {
+            FF_PRINTF( "prvDeferredDeleteStep: %s\n", ( const char * ) FF_GetErrMessage( xError ) );
+        }
+
+        return xMoreWork;
+    }   /* prvDeferredDeleteStep() */
+/*-----------------------------------------------------------*/
+
+    static void prvDeferredDeleteTask( void * pvParameters )
+    {
+        FF_IOManager_t * pxIOManager = ( FF_IOManager_t * ) pvParameters;
+
+        /* Start with a look in the directory, work may have been left before a reset. */
+        BaseType_t xMoreWork = pdTRUE;
+
+        while( pxIOManager->xDeleteStop == pdFALSE )
+        {
+            if( xMoreWork != pdFALSE )
+            {
+                /* Give other tasks access to the disk between two batches. */
+                vTaskDelay( pdMS_TO_TICKS( ffconfigDEFERRED_DELETE_DELAY_MS ) );
+            }
+            else
+            {
+                ( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+            }
+
+            if( pxIOManager->xDeleteStop == pdFALSE )
+            {
+                xMoreWork = prvDeferredDeleteStep( pxIOManager );
+            }
+        }
+
+        pxIOManager->xDeleteTask = NULL;
+        vTaskDelete( NULL );
+    }   /* prvDeferredDeleteTask() */
+/*-----------------------------------------------------------*/
+
+/**
+ *	@public
+ *	@brief	Delete a file, and free its clusters in the background.
+ *
+ *	The file is moved to ffconfigDEFERRED_DELETE_DIR, which takes as long as
+ *	deleting an empty file.  The task started by FF_DeferredDeleteStart() will
+ *	free its clusters in batches of ffconfigDEFERRED_DELETE_BATCH.  Small files,
+ *	and all files while the task is not running, are deleted by FF_RmFile().
+ *
+ *	@param	pxIOManager		FF_IOManager_t object that was created by FF_CreateIOManger().
+ *	@param	pcPath			Path to the file to delete.
+ *
+ *	@return	FF_ERR_NONE on success, or an error code from FF_Open(), FF_Move() or FF_RmFile().
+ **/
+    FF_Error_t FF_RmFileDeferred( FF_IOManager_t * pxIOManager,
+                                  const char * pcPath )
+    {
+        FF_FILE * pxFile;
+        FF_Error_t xError;
+        BaseType_t xDefer = pdFALSE;
+        BaseType_t xAttempt;
+        char pcDestination[ ffconfigMAX_FILENAME ];
+
+        pxFile = FF_Open( pxIOManager, pcPath, FF_MODE_READ, &xError );
+
+        if( pxFile != NULL )
+        {
+            if( ( pxIOManager->xDeleteTask != NULL ) &&
+                ( pxFile->ulObjectCluster != 0UL ) &&
+                ( pxFile->ulFileSize / ( ( uint32_t ) pxIOManager->xPartition.usBlkSize * pxIOManager->xPartition.ulSectorsPerCluster ) >= ffconfigDEFERRED_DELETE_BATCH ) )
+            {
+                xDefer = pdTRUE;
+            }
+
+            #if ( ffconfigEXFAT_SUPPORT != 0 )
+                if( ( pxFile->ucStreamFlags & FF_EXFAT_FLAG_NO_FAT_CHAIN ) != 0U )
+                {
+                    /* Freeing a contiguous exFAT file is fast already. */
+                    xDefer = pdFALSE;
+                }
+            #endif
+
+            xError = FF_Close( pxFile );
+        }
+
+        if( ( FF_isERR( xError ) == pdFALSE ) && ( xDefer != pdFALSE ) )
+        {
+            xError = FF_MkDir( pxIOManager, ffconfigDEFERRED_DELETE_DIR );
+
+            if( FF_isERR( xError ) == pdFALSE )
+            {
+                /* A new directory, keep it out of sight. */
+                ( void ) FF_SetPerm( pxIOManager, ffconfigDEFERRED_DELETE_DIR, FF_FAT_ATTR_HIDDEN | FF_FAT_ATTR_SYSTEM );
+            }
+            else if( FF_GETERROR( xError ) == FF_ERR_DIR_OBJECT_EXISTS )
+            {
+                xError = FF_ERR_NONE;
+            }
+
+            for( xAttempt = 0; ( FF_isERR( xError ) == pdFALSE ) && ( xAttempt < 16 ); xAttempt++ )
+            {
+                snprintf( pcDestination, sizeof( pcDestination ), "%s/%08lX.DEL",
+                          ffconfigDEFERRED_DELETE_DIR, ( unsigned long ) pxIOManager->ulDeleteCounter++ );
+
+                xError = FF_Move( pxIOManager, pcPath, pcDestination, pdFALSE );
+
+                if( FF_GETERROR( xError ) != FF_ERR_FILE_DESTINATION_EXISTS )
+                {
+                    break;
+                }
+
+                xError = FF_ERR_NONE;
+            }
+
+            if( ( FF_isERR( xError ) == pdFALSE ) && ( xAttempt < 16 ) )
+            {
+                xTaskNotifyGive( pxIOManager->xDeleteTask );
+            }
+            else
+            {
+                /* The file could not be moved, delete it right away. */
+                xDefer = pdFALSE;
+            }
+        }
+
+        if( xDefer == pdFALSE )
+        {
+            xError = FF_RmFile( pxIOManager, pcPath );
+        }
+
+        return xError;
+    }   /* FF_RmFileDeferred() */
+/*-----------------------------------------------------------*/
+
+/**
+ *	@public
+ *	@brief	Start the task that frees the clusters of files deleted by
+ *	@brief	FF_RmFileDeferred().  Call it after FF_Mount(), it will first
+ *	@brief	finish the work that was left before a reset.  Call
+ *	@brief	FF_DeferredDeleteStop() before the volume is unmounted.
+ *
+ *	@param	pxIOManager		FF_IOManager_t object that was created by FF_CreateIOManger().
+ *
+ *	@return	FF_ERR_NONE on success, or FF_ERR_NOT_ENOUGH_MEMORY if the task could not be created.
+ **/
+    FF_Error_t FF_DeferredDeleteStart( FF_IOManager_t * pxIOManager )
+    {
+        FF_Error_t xError = FF_ERR_NONE;
+
+        if( pxIOManager == NULL )
+        {
+            xError = ( FF_Error_t ) ( FF_ERR_NULL_POINTER | FF_DEFERREDDELETE );
+        }
+        else if( pxIOManager->xDeleteTask != NULL )
+        {
+            /* Already running, let it have a look at the directory. */
+            xTaskNotifyGive( pxIOManager->xDeleteTask );
+        }
+        else
+        {
+            pxIOManager->xDeleteStop = pdFALSE;
+
+            /* Make it unlikely that a new name is taken already. */
+            pxIOManager->ulDeleteCounter = ( uint32_t ) xTaskGetTickCount();
+
+            if( xTaskCreate( prvDeferredDeleteTask, "FF_Delete", ffconfigDEFERRED_DELETE_STACK_SIZE, ( void * ) pxIOManager,
+                             ffconfigDEFERRED_DELETE_PRIORITY, &( pxIOManager->xDeleteTask ) ) != pdPASS )
+            {
+                pxIOManager->xDeleteTask = NULL;
+                xError = ( FF_Error_t ) ( FF_ERR_NOT_ENOUGH_MEMORY | FF_DEFERREDDELETE );
+            }
+        }
+
+        return xError;
+    }   /* FF_DeferredDeleteStart() */
+/*-----------------------------------------------------------*/
+
+/**
+ *	@public
+ *	@brief	Stop the task that frees the clusters of deleted files, and wait
+ *	@brief	until it has finished its current batch.  The remaining work
+ *	@brief	stays on disk.
+ *
+ *	@param	pxIOManager		FF_IOManager_t object that was created by FF_CreateIOManger().
+ **/
+    void FF_DeferredDeleteStop( FF_IOManager_t * pxIOManager )
+    {
+        if( ( pxIOManager != NULL ) && ( pxIOManager->xDeleteTask != NULL ) )
+        {
+            pxIOManager->xDeleteStop = pdTRUE;
+            xTaskNotifyGive( pxIOManager->xDeleteTask );
+
+            while( pxIOManager->xDeleteTask != NULL )
+            {
+                vTaskDelay( pdMS_TO_TICKS( ffconfigDEFERRED_DELETE_DELAY_MS ) + 1 );
+            }
+        }
+    }   /* FF_DeferredDeleteStop() */
+/*-----------------------------------------------------------*/
+
+#endif /* ffconfigDEFERRED_DELETE */
+
+/**
+ *	@private
+ *	@brief	Mark the directory entries of an object as deleted: its LFN entries
+ *	@brief	and its short name entry, or its exFAT entry set.
+ **/
+static FF_Error_t FF_RmDirEntries( FF_IOManager_t * pxIOManager,
+                                   uint16_t usDirEntry,
+                                   FF_FetchContext_t * pxContext )
+{
+    FF_Error_t xError;
+    uint8_t ucEntryBuffer[ 32 ];
+
+    #if ( ffconfigEXFAT_SUPPORT != 0 )
+        if( pxIOManager->xPartition.ucType == FF_T_EXFAT )
+        {
+            xError = FF_exFATRmEntrySet( pxIOManager, usDirEntry, pxContext );
+        }
+        else
+    #endif
+    {
+        /* Remove LFN entries, if any. */
+        xError = FF_RmLFNs( pxIOManager, usDirEntry, pxContext );
+
+        if( FF_isERR( xError ) == pdFALSE )
+        {
+            /* Remove the Short file name entry. */
+            xError = FF_FetchEntryWithContext( pxIOManager, usDirEntry, pxContext, ucEntryBuffer );
+
+            if( FF_isERR( xError ) == pdFALSE )
+            {
+                ucEntryBuffer[ 0 ] = FF_FAT_DELETED;
+                FF_putShort( ucEntryBuffer, FF_FAT_DIRENT_CLUS_HIGH, ( uint32_t ) 0ul );
+                FF_putShort( ucEntryBuffer, FF_FAT_DIRENT_CLUS_LOW, ( uint32_t ) 0ul );
+
+                xError = FF_PushEntryWithContext( pxIOManager, usDirEntry, pxContext, ucEntryBuffer );
+            }
+        }
+    }
+
+    return xError;
+}   /* FF_RmDirEntries() */
+/*-----------------------------------------------------------*/
+
 /**
  *	@public
  *	@brief	Moves a file or directory from source to destination.
@@ -961,6 +1400,15 @@ static FF_FILE * prvAllocFileHandle( FF_IOManager_t * pxIOManager,
                     xMyFile.ucAttrib = FF_getChar( ucEntryBuffer, ( uint16_t ) ( FF_FAT_DIRENT_ATTRIB ) );
                     xMyFile.ulFileSize = pSrcFile->ulFileSize;
                     xMyFile.ulObjectCluster = pSrcFile->ulObjectCluster;
+
+                    #if ( ffconfigEXFAT_SUPPORT != 0 )
+                        if( pxIOManager->xPartition.ucType == FF_T_EXFAT )
+                        {
+                            /* The attributes, flags and allocated length are stored in the entry set. */
+                            xError = FF_GetEntry( pxIOManager, pSrcFile->usDirEntry, pSrcFile->ulDirCluster, &xMyFile );
+                        }
+                    #endif
+
                     xMyFile.usCurrentItem = 0;
 
                     xIndex = ( BaseType_t ) STRLEN( szDestinationFile );
@@ -986,7 +1434,10 @@ static FF_FILE * prvAllocFileHandle( FF_IOManager_t * pxIOManager,
 
                     /* Find the (cluster of the) directory in which the target file will be located.
                      * It must exist before calling FF_Move(). */
-                    ulDirCluster = FF_FindDir( pxIOManager, szDestinationFile, xIndex, &xError );
+                    if( FF_isERR( xError ) == pdFALSE )
+                    {
+                        ulDirCluster = FF_FindDir( pxIOManager, szDestinationFile, xIndex, &xError );
+                    }
                 }
             }
         }
@@ -1013,33 +1464,31 @@ static FF_FILE * prvAllocFileHandle( FF_IOManager_t * pxIOManager,
                     /* Edit the Directory Entry! (So it appears as deleted); */
                     FF_LockDirectory( pxIOManager );
                     {
-                        xError = FF_RmLFNs( pxIOManager, pSrcFile->usDirEntry, &xFetchContext );
-
-                        if( FF_isERR( xError ) == pdFALSE )
-                        {
-                            xError = FF_FetchEntryWithContext( pxIOManager, pSrcFile->usDirEntry, &xFetchContext, ucEntryBuffer );
+                        FF_Error_t xTempError;
 
-                            if( FF_isERR( xError ) == pdFALSE )
-                            {
-                                FF_Error_t xTempError;
-                                ucEntryBuffer[ 0 ] = FF_FAT_DELETED;
-                                FF_putShort( ucEntryBuffer, FF_FAT_DIRENT_CLUS_HIGH, ( uint32_t ) 0ul );
-                                FF_putShort( ucEntryBuffer, FF_FAT_DIRENT_CLUS_LOW, ( uint32_t ) 0ul );
+                        xError = FF_RmDirEntries( pxIOManager, pSrcFile->usDirEntry, &xFetchContext );
 
-                                xError = FF_PushEntryWithContext( pxIOManager, pSrcFile->usDirEntry, &xFetchContext, ucEntryBuffer );
-                                /* The contents of 'xFetchContext' has changed, flush it to disk now. */
-                                xTempError = FF_CleanupEntryFetch( pxIOManager, &xFetchContext );
+                        /* The contents of 'xFetchContext' has changed, flush it to disk now. */
+                        xTempError = FF_CleanupEntryFetch( pxIOManager, &xFetchContext );
 
-                                if( FF_isERR( xError ) == pdFALSE )
-                                {
-                                    xError = xTempError;
-                                }
-                            }
+                        if( FF_isERR( xError ) == pdFALSE )
+                        {
+                            xError = xTempError;
                         }
                     }
                     FF_UnlockDirectory( pxIOManager );
                 }
 
+                #if ( ffconfigEXFAT_SUPPORT != 0 )
+                    if( ( FF_isERR( xError ) == pdFALSE ) &&
+                        ( pxIOManager->xPartition.ucType == FF_T_EXFAT ) &&
+                        ( ( xMyFile.ucAttrib & FF_FAT_ATTR_DIR ) != 0U ) )
+                    {
+                        /* A moved directory has a new entry set, which holds its length. */
+                        FF_exFATRememberDir( pxIOManager, xMyFile.ulObjectCluster, ulDirCluster, xMyFile.usCurrentItem );
+                    }
+                #endif
+
                 #if ( ffconfigPATH_CACHE != 0 )
                     {
                         if( xIsDirectory != 0 )
@@ -1200,17 +1649,27 @@ int32_t FF_FileSize( FF_FILE * pxFile )
 }   /* FF_FileSize() */
 /*-----------------------------------------------------------*/
 
-static uint32_t FF_GetSequentialClusters( FF_IOManager_t * pxIOManager,
+static uint32_t FF_GetSequentialClusters( FF_FILE * pxFile,
                                           uint32_t ulStartCluster,
                                           uint32_t ulLimit,
                                           FF_Error_t * pxError )
 {
+    FF_IOManager_t * pxIOManager = pxFile->pxIOManager;
     uint32_t ulCurrentCluster;
     uint32_t ulNextCluster = ulStartCluster;
     uint32_t ulIndex = 0;
 
     FF_FATBuffers_t xFATBuffers;
 
+    #if ( ffconfigEXFAT_SUPPORT != 0 )
+        if( ( pxFile->ucStreamFlags & FF_EXFAT_FLAG_NO_FAT_CHAIN ) != 0U )
+        {
+            /* All clusters of a contiguous exFAT file are sequential. */
+            *pxError = FF_ERR_NONE;
+            return ulLimit;
+        }
+    #endif
+
     FF_InitFATBuffers( &xFATBuffers, FF_MODE_READ );
 
     *pxError = FF_ERR_NONE;
@@ -1266,7 +1725,7 @@ static FF_Error_t FF_ReadClusters( FF_FILE * pxFile,
         if( ( ulCount - 1 ) > 0 )
         {
             ulSequentialClusters =
-                FF_GetSequentialClusters( pxFile->pxIOManager, pxFile->ulAddrCurrentCluster, ulCount - 1, &xError );
+                FF_GetSequentialClusters( pxFile, pxFile->ulAddrCurrentCluster, ulCount - 1, &xError );
 
             if( FF_isERR( xError ) )
             {
@@ -1287,12 +1746,7 @@ static FF_Error_t FF_ReadClusters( FF_FILE * pxFile,
 
         ulCount -= ( ulSequentialClusters + 1 );
 
-        FF_LockFAT( pxFile->pxIOManager );
-        {
-            pxFile->ulAddrCurrentCluster =
-                FF_TraverseFAT( pxFile->pxIOManager, pxFile->ulAddrCurrentCluster, ulSequentialClusters + 1, &xError );
-        }
-        FF_UnlockFAT( pxFile->pxIOManager );
+        pxFile->ulAddrCurrentCluster = FF_TraverseFile( pxFile, pxFile->ulAddrCurrentCluster, ulSequentialClusters + 1, &xError );
 
         if( FF_isERR( xError ) )
         {
@@ -1327,7 +1781,15 @@ static FF_Error_t FF_ExtendFile( FF_FILE * pxFile,
     }
     else
     {
-        if( ( pxFile->ulFileSize == 0 ) && ( pxFile->ulObjectCluster == 0 ) )
+        #if ( ffconfigEXFAT_SUPPORT != 0 )
+            if( pxIOManager->xPartition.ucType == FF_T_EXFAT )
+            {
+                /* Try to keep the file contiguous, so that it needs no FAT chain. */
+                xError = FF_ExtendContiguous( pxFile, ulTotalClustersNeeded );
+            }
+        #endif
+
+        if( ( FF_isERR( xError ) == pdFALSE ) && ( pxFile->ulFileSize == 0 ) && ( pxFile->ulObjectCluster == 0 ) )
         {
             /* If there is no object cluster yet, create it.*/
             pxFile->ulAddrCurrentCluster = FF_CreateClusterChain( pxFile->pxIOManager, &xError );
@@ -1475,12 +1937,9 @@ static FF_Error_t FF_ExtendFile( FF_FILE * pxFile,
                 pxFile->ulValidFlags |= FF_VALID_FLAG_EXTENDED;
             	FF_Error_t xTempError = FF_ERR_NONE;
             	uint32_t ulNewCluster = FF_getClusterChainNumber( pxIOManager, pxFile->ulFilePointer, 1 );
-            	FF_LockFAT( pxIOManager );
-            	{
-	                pxFile->ulAddrCurrentCluster = FF_TraverseFAT( pxIOManager, pxFile->ulObjectCluster, ulNewCluster, &( xTempError ) );
-                	pxFile->ulCurrentCluster = ulNewCluster;
-            	}
-            	FF_UnlockFAT( pxIOManager );
+
+                pxFile->ulAddrCurrentCluster = FF_TraverseFile( pxFile, pxFile->ulObjectCluster, ulNewCluster, &( xTempError ) );
+                pxFile->ulCurrentCluster = ulNewCluster;
 
 	            if( FF_isERR( xError ) == pdFALSE )
             	{
@@ -1494,6 +1953,148 @@ static FF_Error_t FF_ExtendFile( FF_FILE * pxFile,
 }   /* FF_ExtendFile() */
 /*-----------------------------------------------------------*/
 
+#if ( ffconfigEXFAT_SUPPORT != 0 )
+
+/*
+ * exFAT: allocate the clusters of a file as one contiguous run, which is only
+ * recorded in the allocation bitmap. When the run can not grow in place, the
+ * FAT chain is written and FF_ExtendFile() continues in the usual way.
+ */
+    static FF_Error_t FF_ExtendContiguous( FF_FILE * pxFile,
+                                           uint32_t ulTotalClustersNeeded )
+    {
+        FF_IOManager_t * pxIOManager = pxFile->pxIOManager;
+        FF_DirEnt_t xOriginalEntry;
+        FF_Error_t xError = FF_ERR_NONE;
+        FF_Error_t xTempError;
+        uint32_t ulCluster = 0;
+        uint32_t ulCount = 0;
+
+        if( ( pxFile->ulObjectCluster == 0ul ) && ( ulTotalClustersNeeded != 0ul ) )
+        {
+            ulCount = ulTotalClustersNeeded;
+
+            FF_LockFAT( pxIOManager );
+            {
+                ulCluster = FF_exFATClaimContiguous( pxIOManager, 0ul, ulCount, &xError );
+            }
+            FF_UnlockFAT( pxIOManager );
+
+            if( ulCluster != 0ul )
+            {
+                pxFile->ulObjectCluster = ulCluster;
+                pxFile->ulChainLength = ulCount;
+                pxFile->ulEndOfChain = ulCluster + ulCount - 1ul;
+                pxFile->ulCurrentCluster = 0;
+                pxFile->ucStreamFlags |= FF_EXFAT_FLAG_NO_FAT_CHAIN;
+
+                /* The directory denotes the address of the first data cluster of every file. */
+                xError = FF_GetEntry( pxIOManager, pxFile->usDirEntry, pxFile->ulDirCluster, &xOriginalEntry );
+
+                if( FF_isERR( xError ) == pdFALSE )
+                {
+                    xOriginalEntry.ulObjectCluster = ulCluster;
+                    xOriginalEntry.ucStreamFlags = pxFile->ucStreamFlags;
+                    xError = FF_PutEntry( pxIOManager, pxFile->usDirEntry, pxFile->ulDirCluster, &xOriginalEntry, NULL );
+                }
+            }
+        }
+        else if( ( ( pxFile->ucStreamFlags & FF_EXFAT_FLAG_NO_FAT_CHAIN ) != 0U ) &&
+                 ( ulTotalClustersNeeded > pxFile->ulChainLength ) )
+        {
+            ulCount = ulTotalClustersNeeded - pxFile->ulChainLength;
+
+            FF_LockFAT( pxIOManager );
+            {
+                ulCluster = FF_exFATClaimContiguous( pxIOManager, pxFile->ulEndOfChain + 1ul, ulCount, &xError );
+
+                if( ( ulCluster == 0ul ) && ( FF_isERR( xError ) == pdFALSE ) )
+                {
+                    /* The clusters behind the file are in use: the file gets fragmented. */
+                    xError = FF_exFATWriteChain( pxIOManager, pxFile->ulObjectCluster, pxFile->ulChainLength );
+
+                    if( FF_isERR( xError ) == pdFALSE )
+                    {
+                        pxFile->ucStreamFlags &= ( uint8_t ) ~FF_EXFAT_FLAG_NO_FAT_CHAIN;
+
+                        /* Like FF_TraverseFAT(), stop at the last cluster of the chain. */
+                        if( pxFile->ulCurrentCluster >= pxFile->ulChainLength )
+                        {
+                            pxFile->ulCurrentCluster = pxFile->ulChainLength - 1ul;
+                        }
+
+                        pxFile->ulAddrCurrentCluster = pxFile->ulObjectCluster + pxFile->ulCurrentCluster;
+                    }
+                }
+            }
+            FF_UnlockFAT( pxIOManager );
+
+            if( ulCluster != 0ul )
+            {
+                pxFile->ulChainLength = ulTotalClustersNeeded;
+                pxFile->ulEndOfChain = ulCluster + ulCount - 1ul;
+            }
+        }
+        else
+        {
+            /* The file has enough clusters, or it has a FAT chain. */
+        }
+
+        if( ulCluster != 0ul )
+        {
+            xTempError = FF_DecreaseFreeClusters( pxIOManager, ulCount );
+
+            if( FF_isERR( xError ) == pdFALSE )
+            {
+                xError = xTempError;
+            }
+
+            /* Writing at the end of the file: point to the cluster that holds the file pointer. */
+            if( pxFile->ulFilePointer == pxFile->ulFileSize )
+            {
+                pxFile->ulCurrentCluster = FF_getClusterChainNumber( pxIOManager, pxFile->ulFilePointer, 1 );
+            }
+
+            pxFile->ulAddrCurrentCluster = pxFile->ulObjectCluster + pxFile->ulCurrentCluster;
+        }
+
+        return xError;
+    }   /* FF_ExtendContiguous() */
+#endif /* ffconfigEXFAT_SUPPORT */
+/*-----------------------------------------------------------*/
+
+/**
+ *	@private
+ *	@brief	Move 'ulCount' clusters forward in the chain of a file, starting at 'ulStart'.
+ **/
+static uint32_t FF_TraverseFile( FF_FILE * pxFile,
+                                 uint32_t ulStart,
+                                 uint32_t ulCount,
+                                 FF_Error_t * pxError )
+{
+    uint32_t ulResult;
+
+    #if ( ffconfigEXFAT_SUPPORT != 0 )
+        if( ( pxFile->ucStreamFlags & FF_EXFAT_FLAG_NO_FAT_CHAIN ) != 0U )
+        {
+            /* A contiguous exFAT file has no FAT chain to follow. */
+            *pxError = FF_ERR_NONE;
+            ulResult = ulStart + ulCount;
+        }
+        else
+    #endif
+    {
+        FF_LockFAT( pxFile->pxIOManager );
+        {
+            ulResult = FF_TraverseFAT( pxFile->pxIOManager, ulStart, ulCount, pxError );
+        }
+        FF_UnlockFAT( pxFile->pxIOManager );
+    }
+
+    return ulResult;
+}   /* FF_TraverseFile() */
+/*-----------------------------------------------------------*/
+
 static FF_Error_t FF_WriteClusters( FF_FILE * pxFile,
                                     uint32_t ulCount,
                                     uint8_t * buffer )
@@ -1508,7 +2109,7 @@ static FF_Error_t FF_WriteClusters( FF_FILE * pxFile,
         if( ulCount > 1U )
         {
             ulSequentialClusters =
-                FF_GetSequentialClusters( pxFile->pxIOManager, pxFile->ulAddrCurrentCluster, ulCount - 1, &xError );
+                FF_GetSequentialClusters( pxFile, pxFile->ulAddrCurrentCluster, ulCount - 1, &xError );
 
             if( FF_isERR( xError ) )
             {
@@ -1533,12 +2134,7 @@ static FF_Error_t FF_WriteClusters( FF_FILE * pxFile,
 
         ulCount -= ulSequentialClusters + 1;
 
-        FF_LockFAT( pxFile->pxIOManager );
-        {
-            pxFile->ulAddrCurrentCluster =
-                FF_TraverseFAT( pxFile->pxIOManager, pxFile->ulAddrCurrentCluster, ulSequentialClusters + 1, &xError );
-        }
-        FF_UnlockFAT( pxFile->pxIOManager );
+        pxFile->ulAddrCurrentCluster = FF_TraverseFile( pxFile, pxFile->ulAddrCurrentCluster, ulSequentialClusters + 1, &xError );
 
         if( FF_isERR( xError ) )
         {
@@ -1603,20 +2199,12 @@ static uint32_t FF_SetCluster( FF_FILE * pxFile,
 
     if( ulNewCluster > pxFile->ulCurrentCluster )
     {
-        FF_LockFAT( pxIOManager );
-        {
-            pxFile->ulAddrCurrentCluster = FF_TraverseFAT( pxIOManager, pxFile->ulAddrCurrentCluster,
-                                                           ulNewCluster - pxFile->ulCurrentCluster, &xResult );
-        }
-        FF_UnlockFAT( pxIOManager );
+        pxFile->ulAddrCurrentCluster = FF_TraverseFile( pxFile, pxFile->ulAddrCurrentCluster,
+                                                        ulNewCluster - pxFile->ulCurrentCluster, &xResult );
     }
     else if( ulNewCluster < pxFile->ulCurrentCluster )
     {
-        FF_LockFAT( pxIOManager );
-        {
-            pxFile->ulAddrCurrentCluster = FF_TraverseFAT( pxIOManager, pxFile->ulObjectCluster, ulNewCluster, &xResult );
-        }
-        FF_UnlockFAT( pxIOManager );
+        pxFile->ulAddrCurrentCluster = FF_TraverseFile( pxFile, pxFile->ulObjectCluster, ulNewCluster, &xResult );
     }
     else
     {
@@ -3120,6 +3708,17 @@ FF_Error_t FF_Close( FF_FILE * pxFile )
             /* File is not deleted and it was opened for writing or updating */
             ulClusterSize = pxFile->pxIOManager->xPartition.usBlkSize * pxFile->pxIOManager->xPartition.ulSectorsPerCluster;
 
+            #if ( ffconfigEXFAT_SUPPORT != 0 )
+                if( pxFile->pxIOManager->xPartition.ucType == FF_T_EXFAT )
+                {
+                    /* The allocation of an exFAT file must match its length exactly. */
+                    if( pxFile->ulObjectCluster != 0ul )
+                    {
+                        xError = FF_Truncate( pxFile, pdTRUE );
+                    }
+                }
+                else
+            #endif
             if( ( ( pxFile->ulFileSize % ulClusterSize ) == 0 ) && ( pxFile->ulObjectCluster != 0ul ) )
             {
                 /* The file's length is a multiple of cluster size.  This means
@@ -3132,6 +3731,18 @@ FF_Error_t FF_Close( FF_FILE * pxFile )
             {
                 xError = FF_GetEntry( pxFile->pxIOManager, pxFile->usDirEntry, pxFile->ulDirCluster, &xOriginalEntry );
 
+                #if ( ffconfigEXFAT_SUPPORT != 0 )
+                    if( ( FF_isERR( xError ) == pdFALSE ) && ( pxFile->pxIOManager->xPartition.ucType == FF_T_EXFAT ) )
+                    {
+                        /* The first cluster and the stream flags may have changed as well. */
+                        xOriginalEntry.ulObjectCluster = pxFile->ulObjectCluster;
+                        xOriginalEntry.ucStreamFlags = pxFile->ucStreamFlags;
+                        xOriginalEntry.ulFileSize = pxFile->ulFileSize;
+                        xError = FF_PutEntry( pxFile->pxIOManager, pxFile->usDirEntry, pxFile->ulDirCluster, &xOriginalEntry, NULL );
+                    }
+                    else
+                #endif
+
                 /* Now update the directory entry */
                 if( ( FF_isERR( xError ) == pdFALSE ) &&
                     ( ( pxFile->ulFileSize != xOriginalEntry.ulFileSize ) || ( pxFile->ulFileSize == 0UL ) ) )
@@ -3270,7 +3881,18 @@ static FF_Error_t FF_Truncate( FF_FILE * pxFile,
     ulClusterSize = pxIOManager->xPartition.usBlkSize * pxIOManager->xPartition.ulSectorsPerCluster;
 
     /* See how many clusters have been allocated. */
-    ulClusterCount = FF_GetChainLength( pxIOManager, pxFile->ulObjectCluster, NULL, &xError );
+    #if ( ffconfigEXFAT_SUPPORT != 0 )
+        if( ( pxFile->ucStreamFlags & FF_EXFAT_FLAG_NO_FAT_CHAIN ) != 0U )
+        {
+            /* A contiguous exFAT file has no chain to follow. */
+            xError = FF_ERR_NONE;
+            ulClusterCount = pxFile->ulChainLength;
+        }
+        else
+    #endif
+    {
+        ulClusterCount = FF_GetChainLength( pxIOManager, pxFile->ulObjectCluster, NULL, &xError );
+    }
 
     /* Calculate the actual number of clusters needed, rounding up */
     ulClustersNeeded = ( pxFile->ulFileSize + ulClusterSize - 1 ) / ulClusterSize;
@@ -3280,6 +3902,14 @@ static FF_Error_t FF_Truncate( FF_FILE * pxFile,
         /* The handle will be closed after truncating.  This function is called
          * because Filesize is an exact multiple of ulClusterSize. */
         ulClustersNeeded = pxFile->ulFileSize / ulClusterSize;
+
+        #if ( ffconfigEXFAT_SUPPORT != 0 )
+            if( pxIOManager->xPartition.ucType == FF_T_EXFAT )
+            {
+                /* exFAT: called for every file that is closed, to free the unused clusters. */
+                ulClustersNeeded = ( pxFile->ulFileSize + ulClusterSize - 1 ) / ulClusterSize;
+            }
+        #endif
     }
     else
     {
@@ -3293,12 +3923,21 @@ static FF_Error_t FF_Truncate( FF_FILE * pxFile,
     {
         if( ulClustersNeeded == 0ul )
         {
-            FF_LockFAT( pxIOManager );
+            #if ( ffconfigEXFAT_SUPPORT != 0 )
+                if( ( pxFile->ucStreamFlags & FF_EXFAT_FLAG_NO_FAT_CHAIN ) != 0U )
+                {
+                    xError = FF_exFATFreeClusters( pxIOManager, pxFile->ulObjectCluster, ulClusterCount );
+                }
+                else
+            #endif
             {
-                /* In FF_Truncate() */
-                xError = FF_UnlinkClusterChain( pxIOManager, pxFile->ulObjectCluster, 0 );
+                FF_LockFAT( pxIOManager );
+                {
+                    /* In FF_Truncate() */
+                    xError = FF_UnlinkClusterChain( pxIOManager, pxFile->ulObjectCluster, 0 );
+                }
+                FF_UnlockFAT( pxIOManager );
             }
-            FF_UnlockFAT( pxIOManager );
 
             if( FF_isERR( xError ) == pdFALSE )
             {
@@ -3319,10 +3958,28 @@ static FF_Error_t FF_Truncate( FF_FILE * pxFile,
                         pxFile->ulChainLength = 0ul;
                         pxFile->ulCurrentCluster = 0ul;
                         pxFile->ulEndOfChain = 0ul;
+                        #if ( ffconfigEXFAT_SUPPORT != 0 )
+                            {
+                                pxFile->ucStreamFlags &= ( uint8_t ) ~FF_EXFAT_FLAG_NO_FAT_CHAIN;
+                            }
+                        #endif
                     }
                 }
             }
         }
+        #if ( ffconfigEXFAT_SUPPORT != 0 )
+            else if( ( pxFile->ucStreamFlags & FF_EXFAT_FLAG_NO_FAT_CHAIN ) != 0U )
+            {
+                /* Free the clusters at the end of the contiguous run. */
+                xError = FF_exFATFreeClusters( pxIOManager, pxFile->ulObjectCluster + ulClustersNeeded, ulClusterCount - ulClustersNeeded );
+
+                if( FF_isERR( xError ) == pdFALSE )
+                {
+                    pxFile->ulChainLength = ulClustersNeeded;
+                    pxFile->ulEndOfChain = pxFile->ulObjectCluster + ulClustersNeeded - 1ul;
+                }
+            }
+        #endif
         else
         {
             FF_LockFAT( pxIOManager );
@@ -197,6 +197,17 @@ static FF_Error_t prvPartitionPrimary( struct xPartitionSet * pxSet );
 static FF_Error_t prvPartitionExtended( struct xPartitionSet * pxSet,
                                         FF_PartitionParameters_t * pParams );
 
+#if ( ffconfigEXFAT_SUPPORT != 0 )
+    /* And three helper functions for FF_FormatExFAT(). */
+    static FF_Error_t prvFormatExFATBootRegion( struct xFormatSet * pxSet );
+
+    static uint16_t prvFormatExFATUpcase( uint16_t usChar );
+
+    static FF_Error_t prvFormatExFATClusters( struct xFormatSet * pxSet,
+                                              uint32_t ulBitmapClusters,
+                                              const char * pcVolumeName );
+#endif
+
 /*-----------------------------------------------------------*/
 
 static portINLINE uint32_t ulMin32( uint32_t a,
@@ -660,7 +671,7 @@ FF_Error_t FF_FormatDisk( FF_Disk_t * pxDisk,
         xSet.ulClusterBeginLBA = xSet.ulHiddenSectors + xSet.ulFATReservedSectors + 2 * xSet.ulSectorsPerFAT;
 
         /* Allocate a buffer space to hold a full sector. */
-        xSet.pucSectorBuffer = ( uint8_t * ) ffconfigMALLOC( xSet.pxIOManager->usSectorSize );
+        xSet.pucSectorBuffer = ( uint8_t * ) ffconfigMALLOC_SECTOR( xSet.pxIOManager->usSectorSize );
 
         if( xSet.pucSectorBuffer == NULL )
         {
@@ -742,6 +753,397 @@ FF_Error_t FF_FormatDisk( FF_Disk_t * pxDisk,
 }
 /*-----------------------------------------------------------*/
 
+#if ( ffconfigEXFAT_SUPPORT != 0 )
+
+/**
+ * @brief Write the exFAT boot region: the boot sector, 8 extended boot sectors,
+ *        2 empty sectors and the checksum sector. The region is written twice.
+ * @param[in] pxSet: A set of parameters describing this format session.
+ * @return A standard +FAT error code.
+ */
+    static FF_Error_t prvFormatExFATBootRegion( struct xFormatSet * pxSet )
+    {
+        FF_Error_t xReturn = FF_ERR_NONE;
+        uint8_t * pucSector = pxSet->pucSectorBuffer;
+        const uint32_t ulSectorSize = pxSet->pxIOManager->usSectorSize;
+        uint32_t ulChecksum = 0;
+        uint32_t ulSector;
+        uint32_t ulOffset;
+        uint8_t ucShift;
+
+        for( ulSector = 0; ulSector < FF_EXFAT_BOOT_REGION_SECTORS; ulSector++ )
+        {
+            ( void ) memset( pucSector, 0, ulSectorSize );
+
+            if( ulSector == 0 )
+            {
+                ( void ) memcpy( pucSector, "\xEB\x76\x90" "EXFAT   ", 11 );
+                FF_putLong( pucSector, FF_EXFAT_PARTITION_OFFSET, pxSet->ulHiddenSectors );
+                FF_putLong( pucSector, FF_EXFAT_VOLUME_LENGTH, pxSet->ulSectorCount );
+                FF_putLong( pucSector, FF_EXFAT_FAT_OFFSET, pxSet->ulFATReservedSectors );
+                FF_putLong( pucSector, FF_EXFAT_FAT_LENGTH, pxSet->ulSectorsPerFAT );
+                FF_putLong( pucSector, FF_EXFAT_CLUSTER_HEAP_OFFSET, pxSet->ulClusterBeginLBA - pxSet->ulHiddenSectors );
+                FF_putLong( pucSector, FF_EXFAT_CLUSTER_COUNT, pxSet->ulUsableDataClusters );
+                FF_putLong( pucSector, FF_EXFAT_ROOT_DIR_CLUSTER, ( uint32_t ) pxSet->iFAT32RootClusters );
+                FF_putLong( pucSector, FF_EXFAT_VOLUME_SERIAL, pxSet->ulVolumeID );
+                FF_putShort( pucSector, FF_EXFAT_FS_REVISION, 0x0100 );
+
+                for( ucShift = 0; ( 1UL << ucShift ) < ulSectorSize; ucShift++ )
+                {
+                }
+
+                FF_putChar( pucSector, FF_EXFAT_BYTES_PER_SECTOR_SHIFT, ucShift );
+
+                for( ucShift = 0; ( 1UL << ucShift ) < pxSet->ulSectorsPerCluster; ucShift++ )
+                {
+                }
+
+                FF_putChar( pucSector, FF_EXFAT_SECTORS_PER_CLUS_SHIFT, ucShift );
+                FF_putChar( pucSector, FF_EXFAT_NUMBER_OF_FATS, 1 );
+                FF_putChar( pucSector, FF_EXFAT_DRIVE_SELECT, 0x80 );
+
+                /* In use are the bitmap, the up-case table and the root directory,
+                 * which are the clusters in front of the root directory's cluster. */
+                FF_putChar( pucSector, FF_EXFAT_PERCENT_IN_USE,
+                            FF_exFATPercentInUse( ( uint32_t ) pxSet->iFAT32RootClusters - 1U, pxSet->ulUsableDataClusters ) );
+                pucSector[ FF_FAT_MBR_SIGNATURE + 0 ] = 0x55;
+                pucSector[ FF_FAT_MBR_SIGNATURE + 1 ] = 0xAA;
+            }
+            else if( ulSector <= 8 )
+            {
+                /* The extended boot sectors only have a signature. */
+                FF_putLong( pucSector, ulSectorSize - 4, 0xAA550000 );
+            }
+            else if( ulSector == FF_EXFAT_CHECKSUM_SECTOR )
+            {
+                for( ulOffset = 0; ulOffset < ulSectorSize; ulOffset += 4 )
+                {
+                    FF_putLong( pucSector, ulOffset, ulChecksum );
+                }
+            }
+            else
+            {
+                /* The OEM parameters and a reserved sector stay empty. */
+            }
+
+            if( ulSector < FF_EXFAT_CHECKSUM_SECTOR )
+            {
+                ulChecksum = FF_exFATBootChecksum( ulChecksum, pucSector, ulSectorSize, ( ulSector == 0 ) );
+            }
+
+            xReturn = FF_BlockWrite( pxSet->pxIOManager, pxSet->ulHiddenSectors + ulSector, 1, pucSector, pdFALSE );
+
+            if( FF_isERR( xReturn ) == pdFALSE )
+            {
+                /* Store a backup copy of the boot region. */
+                xReturn = FF_BlockWrite( pxSet->pxIOManager, pxSet->ulHiddenSectors + FF_EXFAT_BOOT_REGION_SECTORS + ulSector, 1, pucSector, pdFALSE );
+            }
+
+            if( FF_isERR( xReturn ) )
+            {
+                break;
+            }
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/* The up-case table written by the formatter only covers ASCII and Latin-1,
+ * all other characters map to themselves. */
+    static uint16_t prvFormatExFATUpcase( uint16_t usChar )
+    {
+        uint16_t usResult = usChar;
+
+        if( ( usChar >= ( uint16_t ) 'a' ) && ( usChar <= ( uint16_t ) 'z' ) )
+        {
+            usResult = usChar - 0x20U;
+        }
+        else if( ( usChar >= 0xE0U ) && ( usChar <= 0xFEU ) && ( usChar != 0xF7U ) )
+        {
+            usResult = usChar - 0x20U;
+        }
+        else if( usChar == 0xFFU )
+        {
+            usResult = 0x178U;
+        }
+        else
+        {
+            /* No upper case. */
+        }
+
+        return usResult;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Write the clusters of the allocation bitmap, the up-case table and the
+ *        root directory, which are allocated in that order from cluster 2.
+ * @param[in] pxSet: A set of parameters describing this format session.
+ * @param[in] ulBitmapClusters: The number of clusters used by the bitmap.
+ * @param[in] pcVolumeName: The volume label.
+ * @return A standard +FAT error code.
+ */
+    static FF_Error_t prvFormatExFATClusters( struct xFormatSet * pxSet,
+                                              uint32_t ulBitmapClusters,
+                                              const char * pcVolumeName )
+    {
+        FF_Error_t xReturn = FF_ERR_NONE;
+        uint8_t * pucSector = pxSet->pucSectorBuffer;
+        const uint32_t ulSectorSize = pxSet->pxIOManager->usSectorSize;
+        const uint32_t ulUpcaseCluster = 2 + ulBitmapClusters;
+        const uint32_t ulRootCluster = ulUpcaseCluster + 1;
+        const uint32_t ulUpcaseLength = 0x180 * sizeof( uint16_t );
+        uint32_t ulUpcaseChecksum = 0;
+        uint32_t ulLBA = pxSet->ulClusterBeginLBA;
+        uint32_t ulSector;
+        uint32_t ulIndex;
+        uint32_t ulEntry;
+        uint16_t usChar;
+        uint8_t ucValue[ 2 ];
+
+        /* The bitmap: the first clusters are in use. */
+        for( ulSector = 0; ulSector < ( ulBitmapClusters * pxSet->ulSectorsPerCluster ); ulSector++ )
+        {
+            ( void ) memset( pucSector, 0, ulSectorSize );
+
+            if( ulSector == 0 )
+            {
+                for( ulIndex = 0; ulIndex < ( ulRootCluster - 1 ); ulIndex++ )
+                {
+                    pucSector[ ulIndex / 8 ] |= ( uint8_t ) ( 1U << ( ulIndex % 8 ) );
+                }
+            }
+
+            xReturn = FF_BlockWrite( pxSet->pxIOManager, ulLBA++, 1, pucSector, pdFALSE );
+
+            if( FF_isERR( xReturn ) )
+            {
+                break;
+            }
+        }
+
+        /* The up-case table, one cluster is enough. */
+        for( ulSector = 0; ( ulSector < pxSet->ulSectorsPerCluster ) && ( FF_isERR( xReturn ) == pdFALSE ); ulSector++ )
+        {
+            ( void ) memset( pucSector, 0, ulSectorSize );
+
+            for( ulIndex = 0; ulIndex < ulSectorSize; ulIndex += sizeof( uint16_t ) )
+            {
+                if( ( ( ulSector * ulSectorSize ) + ulIndex ) >= ulUpcaseLength )
+                {
+                    break;
+                }
+
+                usChar = prvFormatExFATUpcase( ( uint16_t ) ( ( ( ulSector * ulSectorSize ) + ulIndex ) / sizeof( uint16_t ) ) );
+                FF_putShort( ucValue, 0, usChar );
+                FF_putShort( pucSector, ulIndex, usChar );
+                ulUpcaseChecksum = FF_exFATTableChecksum( ulUpcaseChecksum, ucValue, sizeof( ucValue ) );
+            }
+
+            xReturn = FF_BlockWrite( pxSet->pxIOManager, ulLBA++, 1, pucSector, pdFALSE );
+        }
+
+        /* The root directory: the volume label, the bitmap and the up-case table. */
+        for( ulSector = 0; ( ulSector < pxSet->ulSectorsPerCluster ) && ( FF_isERR( xReturn ) == pdFALSE ); ulSector++ )
+        {
+            ( void ) memset( pucSector, 0, ulSectorSize );
+
+            if( ulSector == 0 )
+            {
+                ulEntry = 0;
+                ulIndex = 0;
+
+                while( ( pcVolumeName != NULL ) && ( ulIndex < 11 ) && ( pcVolumeName[ ulIndex ] != '\0' ) )
+                {
+                    FF_putShort( pucSector, FF_EXFAT_LABEL_CHARS + ( 2 * ulIndex ), ( uint8_t ) pcVolumeName[ ulIndex ] );
+                    ulIndex++;
+                }
+
+                /* FF_FormatDisk() takes a label that is padded with spaces. */
+                while( ( ulIndex > 0 ) && ( pcVolumeName[ ulIndex - 1 ] == ' ' ) )
+                {
+                    ulIndex--;
+                    FF_putShort( pucSector, FF_EXFAT_LABEL_CHARS + ( 2 * ulIndex ), 0 );
+                }
+
+                if( ulIndex != 0 )
+                {
+                    pucSector[ 0 ] = FF_EXFAT_TYPE_LABEL;
+                    pucSector[ FF_EXFAT_LABEL_COUNT ] = ( uint8_t ) ulIndex;
+                    ulEntry += FF_SIZEOF_DIRECTORY_ENTRY;
+                }
+
+                pucSector[ ulEntry ] = FF_EXFAT_TYPE_BITMAP;
+                FF_putLong( pucSector, ulEntry + FF_EXFAT_ALLOC_FIRST_CLUSTER, 2 );
+                FF_putLong( pucSector, ulEntry + FF_EXFAT_ALLOC_DATA_LENGTH, ( pxSet->ulUsableDataClusters + 7 ) / 8 );
+                ulEntry += FF_SIZEOF_DIRECTORY_ENTRY;
+
+                pucSector[ ulEntry ] = FF_EXFAT_TYPE_UPCASE;
+                FF_putLong( pucSector, ulEntry + FF_EXFAT_UPCASE_CHECKSUM, ulUpcaseChecksum );
+                FF_putLong( pucSector, ulEntry + FF_EXFAT_ALLOC_FIRST_CLUSTER, ulUpcaseCluster );
+                FF_putLong( pucSector, ulEntry + FF_EXFAT_ALLOC_DATA_LENGTH, ulUpcaseLength );
+            }
+
+            xReturn = FF_BlockWrite( pxSet->pxIOManager, ulLBA++, 1, pucSector, pdFALSE );
+        }
+
+        /* The FAT describes the three objects as chains. */
+        for( ulSector = 0; ( ulSector < pxSet->ulSectorsPerFAT ) && ( FF_isERR( xReturn ) == pdFALSE ); ulSector++ )
+        {
+            ( void ) memset( pucSector, 0, ulSectorSize );
+
+            for( ulIndex = 0; ulIndex < pxSet->ulClustersPerFATSector; ulIndex++ )
+            {
+                ulEntry = ( ulSector * pxSet->ulClustersPerFATSector ) + ulIndex;
+
+                if( ulEntry > ulRootCluster )
+                {
+                    break;
+                }
+
+                if( ulEntry == 0 )
+                {
+                    FF_putLong( pucSector, 0, 0xFFFFFFF8 );
+                }
+                else if( ( ulEntry == 1 ) || ( ulEntry == ( ulUpcaseCluster - 1 ) ) || ( ulEntry >= ulUpcaseCluster ) )
+                {
+                    FF_putLong( pucSector, 4 * ulIndex, 0xFFFFFFFF );
+                }
+                else
+                {
+                    FF_putLong( pucSector, 4 * ulIndex, ulEntry + 1 );
+                }
+            }
+
+            xReturn = FF_BlockWrite( pxSet->pxIOManager, pxSet->ulHiddenSectors + pxSet->ulFATReservedSectors + ulSector, 1, pucSector, pdFALSE );
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Format a partition of a disk as exFAT. It assumes that is has already
+ *        been partitioned. The cluster size is 4 KB up to 256 MB, 32 KB up to
+ *        32 GB and 128 KB for bigger volumes.
+ * @param[in] pxDisk: The disk object.
+ * @param[in] xPartitionNumber: the numer of the partitioned that must be formatted.
+ * @param[in] pcVolumeName: The volume label, at most 11 characters.
+ * @return A standard +FAT error code ( not an errno ).
+ */
+    FF_Error_t FF_FormatExFAT( FF_Disk_t * pxDisk,
+                               BaseType_t xPartitionNumber,
+                               const char * pcVolumeName )
+    {
+        struct xFormatSet xSet;
+        uint32_t ulSectorsPerMB;
+        uint32_t ulBitmapClusters;
+        FF_Error_t xReturn = FF_ERR_NONE;
+
+        memset( &( xSet ), 0, sizeof xSet );
+
+        xSet.ulFATReservedSectors = 128; /* The offset of the FAT, the boot regions and some alignment. */
+        xSet.xFATCount = 1;
+        xSet.ucFATType = FF_T_EXFAT;
+        xSet.pxIOManager = pxDisk->pxIOManager;
+
+        FF_PartitionSearch( xSet.pxIOManager, &xSet.xPartitionsFound );
+
+        do
+        {
+            if( xPartitionNumber >= xSet.xPartitionsFound.iCount )
+            {
+                xReturn = FF_ERR_IOMAN_INVALID_PARTITION_NUM | FF_FORMATEXFAT;
+                break;
+            }
+
+            xSet.pxMyPartition = xSet.xPartitionsFound.pxPartitions + xPartitionNumber;
+            xSet.ulSectorCount = xSet.pxMyPartition->ulSectorCount;
+            xSet.ulHiddenSectors = xSet.pxMyPartition->ulStartLBA;
+
+            /* Set start sector and length to allow FF_BlockRead/Write */
+            xSet.pxIOManager->xPartition.ulTotalSectors = xSet.pxMyPartition->ulSectorCount;
+            xSet.pxIOManager->xPartition.ulBeginLBA = xSet.pxMyPartition->ulStartLBA;
+
+            xSet.ulVolumeID = ( rand() << 16 ) | rand(); /*_RB_ rand() has proven problematic in some environments. */
+
+            ulSectorsPerMB = 0x100000UL / xSet.pxIOManager->usSectorSize;
+
+            if( xSet.ulSectorCount <= ( 256UL * ulSectorsPerMB ) )
+            {
+                xSet.ulSectorsPerCluster = 4096UL / xSet.pxIOManager->usSectorSize;
+            }
+            else if( xSet.ulSectorCount <= ( 32UL * 1024UL * ulSectorsPerMB ) )
+            {
+                xSet.ulSectorsPerCluster = 32768UL / xSet.pxIOManager->usSectorSize;
+            }
+            else
+            {
+                xSet.ulSectorsPerCluster = 131072UL / xSet.pxIOManager->usSectorSize;
+            }
+
+            /* Every cluster has a 32-bit FAT entry, also the 2 reserved entries. */
+            xSet.ulClustersPerFATSector = xSet.pxIOManager->usSectorSize / sizeof( uint32_t );
+            xSet.ulUsableDataClusters = ( xSet.ulSectorCount - xSet.ulFATReservedSectors ) / xSet.ulSectorsPerCluster;
+            xSet.ulSectorsPerFAT = ( xSet.ulUsableDataClusters + 2 + xSet.ulClustersPerFATSector - 1 ) / xSet.ulClustersPerFATSector;
+
+            /* Let the cluster heap start at a multiple of the cluster size. */
+            xSet.ulNonDataSectors = xSet.ulFATReservedSectors + xSet.ulSectorsPerFAT;
+            xSet.ulNonDataSectors = ( ( xSet.ulNonDataSectors + xSet.ulSectorsPerCluster - 1 ) / xSet.ulSectorsPerCluster ) * xSet.ulSectorsPerCluster;
+
+            if( xSet.ulSectorCount <= xSet.ulNonDataSectors )
+            {
+                xReturn = FF_ERR_IOMAN_INVALID_FORMAT | FF_FORMATEXFAT;
+                break;
+            }
+
+            xSet.ulUsableDataSectors = xSet.ulSectorCount - xSet.ulNonDataSectors;
+            xSet.ulUsableDataClusters = xSet.ulUsableDataSectors / xSet.ulSectorsPerCluster;
+            xSet.ulClusterBeginLBA = xSet.ulHiddenSectors + xSet.ulNonDataSectors;
+
+            ulBitmapClusters = ( ( ( xSet.ulUsableDataClusters + 7 ) / 8 ) + ( xSet.ulSectorsPerCluster * xSet.pxIOManager->usSectorSize ) - 1 ) /
+                               ( xSet.ulSectorsPerCluster * xSet.pxIOManager->usSectorSize );
+            xSet.iFAT32RootClusters = ( int32_t ) ( ulBitmapClusters + 3 );
+
+            if( xSet.ulUsableDataClusters < ( ulBitmapClusters + 2 ) )
+            {
+                xReturn = FF_ERR_IOMAN_INVALID_FORMAT | FF_FORMATEXFAT;
+                break;
+            }
+
+            FF_PRINTF( "FF_FormatExFAT: Secs %lu FAT %lu SecCluster %lu DataClus %lu Heap %lu\n",
+                       xSet.ulSectorCount, xSet.ulSectorsPerFAT, xSet.ulSectorsPerCluster, xSet.ulUsableDataClusters, xSet.ulNonDataSectors );
+
+            xSet.pucSectorBuffer = ( uint8_t * ) ffconfigMALLOC_SECTOR( xSet.pxIOManager->usSectorSize );
+
+            if( xSet.pucSectorBuffer == NULL )
+            {
+                xReturn = FF_ERR_NOT_ENOUGH_MEMORY | FF_FORMATEXFAT;
+                break;
+            }
+
+            /* The FAT, the bitmap and the root directory first, the boot region makes the volume valid. */
+            xReturn = prvFormatExFATClusters( &( xSet ), ulBitmapClusters, pcVolumeName );
+
+            if( FF_isERR( xReturn ) != pdFALSE )
+            {
+                break;
+            }
+
+            xReturn = prvFormatExFATBootRegion( &( xSet ) );
+        }
+        while( pdFALSE );
+
+        /* Free the sector buffer. */
+        ffconfigFREE( xSet.pucSectorBuffer );
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* ffconfigEXFAT_SUPPORT */
+
 /**
  * @brief Create primary and extended partitions.
  * @param[in] pxSet: A set of parameters describing this format session.
@@ -74,6 +74,18 @@ static FF_Error_t FF_GetEfiPartitionEntry( FF_IOManager_t * pxIOManager,
 
 static BaseType_t prvHasActiveHandles( FF_IOManager_t * pxIOManager );
 
+/* The last step of mounting a volume: find the first free cluster and count
+ * the free clusters, if ffconfigMOUNT_FIND_FREE is defined. */
+static FF_Error_t prvInitialiseFreeSpace( FF_IOManager_t * pxIOManager );
+
+#if ( ffconfigEXFAT_SUPPORT != 0 )
+
+/* exFAT: update PercentInUse in the boot sector after the number of free
+ * clusters has changed. */
+    static FF_Error_t prvUpdatePercentInUse( FF_IOManager_t * pxIOManager,
+                                             FF_Error_t xFunction );
+#endif
+
 
 /**
  *	@public
@@ -113,7 +125,7 @@ FF_IOManager_t * FF_CreateIOManger( FF_CreationParameters_t * pxParameters,
     }
     else
     {
-        pxIOManager = ( FF_IOManager_t * ) ffconfigMALLOC( sizeof( FF_IOManager_t ) );
+        pxIOManager = ( FF_IOManager_t * ) ffconfigMALLOC_CONTROL( sizeof( FF_IOManager_t ) );
 
         /* Ensure malloc() succeeded. */
         if( pxIOManager != NULL )
@@ -149,7 +161,7 @@ FF_IOManager_t * FF_CreateIOManger( FF_CreationParameters_t * pxParameters,
         else
         {
             /* No cache buffer provided, call malloc(). */
-            pxIOManager->pucCacheMem = ( uint8_t * ) ffconfigMALLOC( ulCacheSize );
+            pxIOManager->pucCacheMem = ( uint8_t * ) ffconfigMALLOC_SECTOR( ulCacheSize );
 
             if( pxIOManager->pucCacheMem != NULL )
             {
@@ -176,7 +188,7 @@ FF_IOManager_t * FF_CreateIOManger( FF_CreationParameters_t * pxParameters,
         /* Malloc() memory for buffer objects. FreeRTOS+FAT never refers to a
          * buffer directly but uses buffer objects instead. Allows for thread
          * safety. */
-        pxIOManager->pxBuffers = ( FF_Buffer_t * ) ffconfigMALLOC( sizeof( FF_Buffer_t ) * pxIOManager->usCacheSize );
+        pxIOManager->pxBuffers = ( FF_Buffer_t * ) ffconfigMALLOC_CONTROL( sizeof( FF_Buffer_t ) * pxIOManager->usCacheSize );
 
         if( pxIOManager->pxBuffers != NULL )
         {
@@ -256,6 +268,13 @@ FF_Error_t FF_DeleteIOManager( FF_IOManager_t * pxIOManager )
     {
         xError = FF_ERR_NONE;
 
+        #if ( ffconfigDEFERRED_DELETE != 0 )
+            {
+                /* The task may still be using the IO manager. */
+                FF_DeferredDeleteStop( pxIOManager );
+            }
+        #endif
+
         /* Ensure pxBuffers pointer was allocated. */
         if( ( pxIOManager->ucFlags & FF_IOMAN_ALLOC_BUFDESCR ) != 0 )
         {
@@ -277,6 +296,12 @@ FF_Error_t FF_DeleteIOManager( FF_IOManager_t * pxIOManager )
             }
         #endif
 
+        #if ( ffconfigDEFER_FAT_MIRROR != 0 )
+            {
+                FF_FreeFATMirror( pxIOManager );
+            }
+        #endif
+
         /* Delete the event group object within the IO manager before deleting
          * the manager. */
         FF_DeleteEvents( pxIOManager );
@@ -327,6 +352,11 @@ FF_Error_t FF_FlushCache( FF_IOManager_t * pxIOManager )
     BaseType_t xIndex, xIndex2;
     FF_Error_t xError;
 
+    #if ( ffconfigDEFER_FAT_MIRROR != 0 )
+        BaseType_t xMirror = pdFALSE;
+        BaseType_t xLocked = pdFALSE;
+    #endif
+
     if( pxIOManager == NULL )
     {
         xError = FF_ERR_NULL_POINTER | FF_FLUSHCACHE;
@@ -335,7 +365,25 @@ FF_Error_t FF_FlushCache( FF_IOManager_t * pxIOManager )
     {
         xError = FF_ERR_NONE;
 
+        #if ( ffconfigDEFER_FAT_MIRROR != 0 )
+            {
+                if( pxIOManager->xPartition.xFATMirrorDirty != pdFALSE )
+                {
+                    /* The FAT must not change while it is being copied.  The FAT lock
+                     * must be taken before the semaphore. */
+                    xMirror = pdTRUE;
+
+                    if( FF_Has_Lock( pxIOManager, FF_FAT_LOCK ) == pdFALSE )
+                    {
+                        FF_LockFAT( pxIOManager );
+                        xLocked = pdTRUE;
+                    }
+                }
+            }
+        #endif
+
         FF_PendSemaphore( pxIOManager->pvSemaphore );
+        ffconfigTRACE_FLUSH_CACHE_START( pxIOManager );
         {
             for( xIndex = 0; xIndex < pxIOManager->usCacheSize; xIndex++ )
             {
@@ -362,6 +410,16 @@ FF_Error_t FF_FlushCache( FF_IOManager_t * pxIOManager )
                     }
                 }
             }
+
+            #if ( ffconfigDEFER_FAT_MIRROR != 0 )
+                {
+                    if( xMirror != pdFALSE )
+                    {
+                        /* Now that the first FAT is up-to-date, copy the changed sectors. */
+                        xError = FF_MirrorFATs( pxIOManager );
+                    }
+                }
+            #endif
         }
 
         if( ( pxIOManager->xBlkDevice.pxDisk != NULL ) &&
@@ -372,7 +430,17 @@ FF_Error_t FF_FlushCache( FF_IOManager_t * pxIOManager )
             pxIOManager->xBlkDevice.pxDisk->fnFlushApplicationHook( pxIOManager->xBlkDevice.pxDisk );
         }
 
+        ffconfigTRACE_FLUSH_CACHE_END( pxIOManager );
         FF_ReleaseSemaphore( pxIOManager->pvSemaphore );
+
+        #if ( ffconfigDEFER_FAT_MIRROR != 0 )
+            {
+                if( xLocked != pdFALSE )
+                {
+                    FF_UnlockFAT( pxIOManager );
+                }
+            }
+        #endif
     }
 
     return xError;
@@ -1141,6 +1209,23 @@ FF_Error_t FF_PartitionSearch( FF_IOManager_t * pxIOManager,
         pxIOManager->xPartition.ulTotalSectors = 0;
         ucDataBuffer = pxBuffer->pucBuffer;
 
+        #if ( ffconfigEXFAT_SUPPORT != 0 )
+            if( FF_exFATIsBootSector( ucDataBuffer ) != pdFALSE )
+            {
+                /* An exFAT volume without a partition table. It has the 0x55AA
+                 * signature but no partition records, so test it first. */
+                FF_Part_t * p = pPartsFound->pxPartitions;
+
+                p->ulStartLBA = 0;
+                p->ulSectorCount = FF_getLong( ucDataBuffer, FF_EXFAT_VOLUME_LENGTH );
+                p->ucActive = 0x80;
+                p->ucPartitionID = 0x07; /* IFS/NTFS/exFAT partition. */
+                p->bIsExtended = 0;
+                pPartsFound->iCount = 1;
+                break;
+            }
+        #endif /* ffconfigEXFAT_SUPPORT */
+
         /* Check MBR (Master Boot Record) or
          * PBR (Partition Boot Record) signature. */
         if( ( FF_getChar( ucDataBuffer, FF_FAT_MBR_SIGNATURE ) != 0x55 ) ||
@@ -1401,6 +1486,59 @@ static FF_Error_t FF_GetEfiPartitionEntry( FF_IOManager_t * pxIOManager,
 } /* FF_GetEfiPartitionEntry() */
 /*-----------------------------------------------------------*/
 
+static FF_Error_t prvInitialiseFreeSpace( FF_IOManager_t * pxIOManager )
+{
+    FF_Partition_t * pxPartition = &( pxIOManager->xPartition );
+    FF_Error_t xError = FF_ERR_NONE;
+
+    pxPartition->ucPartitionMounted = pdTRUE;
+    pxPartition->ulLastFreeCluster = 0;
+    #if ( ffconfigDEFER_FAT_MIRROR != 0 )
+        {
+            /* Copy the first FAT in case the volume was not unmounted cleanly. */
+            xError = FF_InitFATMirror( pxIOManager );
+
+            if( FF_isERR( xError ) )
+            {
+                /* Do not mount a volume with FAT copies that disagree. */
+                FF_FreeFATMirror( pxIOManager );
+                pxPartition->ucPartitionMounted = pdFALSE;
+            }
+        }
+    #endif
+    #if ( ffconfigMOUNT_FIND_FREE != 0 )
+        {
+            if( FF_isERR( xError ) == pdFALSE )
+            {
+                FF_LockFAT( pxIOManager );
+                {
+                    /* The parameter 'pdFALSE' means: do not claim the free cluster found. */
+                    pxPartition->ulLastFreeCluster = FF_FindFreeCluster( pxIOManager, &xError, pdFALSE );
+                }
+                FF_UnlockFAT( pxIOManager );
+
+                if( FF_GETERROR( xError ) == FF_ERR_IOMAN_NOT_ENOUGH_FREE_SPACE )
+                {
+                    pxPartition->ulLastFreeCluster = 0;
+                    xError = FF_ERR_NONE;
+                }
+
+                if( FF_isERR( xError ) == pdFALSE )
+                {
+                    pxPartition->ulFreeClusterCount = FF_CountFreeClusters( pxIOManager, &xError );
+                }
+            }
+        }
+    #else /* if ( ffconfigMOUNT_FIND_FREE != 0 ) */
+        {
+            pxPartition->ulFreeClusterCount = 0;
+        }
+    #endif /* ffconfigMOUNT_FIND_FREE */
+
+    return xError;
+} /* prvInitialiseFreeSpace() */
+/*-----------------------------------------------------------*/
+
 /**
  *	@public
  *	@brief	Mounts the Specified partition, the volume specified by the FF_IOManager_t object provided.
@@ -1524,6 +1662,21 @@ FF_Error_t FF_Mount( FF_Disk_t * pxDisk,
             break;
         }
 
+        #if ( ffconfigEXFAT_SUPPORT != 0 )
+            if( FF_exFATIsBootSector( pxBuffer->pucBuffer ) != pdFALSE )
+            {
+                /* FF_exFATMount() will release the buffer. */
+                xError = FF_exFATMount( pxIOManager, pxBuffer );
+
+                if( FF_isERR( xError ) == pdFALSE )
+                {
+                    xError = prvInitialiseFreeSpace( pxIOManager );
+                }
+
+                break;
+            }
+        #endif /* ffconfigEXFAT_SUPPORT */
+
         pxPartition->usBlkSize = FF_getShort( pxBuffer->pucBuffer, FF_FAT_BYTES_PER_SECTOR );
 
         if( ( ( pxPartition->usBlkSize % 512 ) != 0 ) || ( pxPartition->usBlkSize == 0 ) )
@@ -1621,41 +1774,7 @@ FF_Error_t FF_Mount( FF_Disk_t * pxDisk,
             pxPartition->ucType = FF_T_FAT32;
         }
 
-        pxPartition->ucPartitionMounted = pdTRUE;
-        pxPartition->ulLastFreeCluster = 0;
-        #if ( ffconfigMOUNT_FIND_FREE != 0 )
-            {
-                FF_LockFAT( pxIOManager );
-                {
-                    /* The parameter 'pdFALSE' means: do not claim the free cluster found. */
-                    pxPartition->ulLastFreeCluster = FF_FindFreeCluster( pxIOManager, &xError, pdFALSE );
-                }
-                FF_UnlockFAT( pxIOManager );
-
-                if( FF_isERR( xError ) )
-                {
-                    if( FF_GETERROR( xError ) == FF_ERR_IOMAN_NOT_ENOUGH_FREE_SPACE )
-                    {
-                        pxPartition->ulLastFreeCluster = 0;
-                    }
-                    else
-                    {
-                        break;
-                    }
-                }
-
-                pxPartition->ulFreeClusterCount = FF_CountFreeClusters( pxIOManager, &xError );
-
-                if( FF_isERR( xError ) )
-                {
-                    break;
-                }
-            }
-        #else /* if ( ffconfigMOUNT_FIND_FREE != 0 ) */
-            {
-                pxPartition->ulFreeClusterCount = 0;
-            }
-        #endif /* ffconfigMOUNT_FIND_FREE */
+        xError = prvInitialiseFreeSpace( pxIOManager );
     }
     while( pdFALSE );
 
@@ -1759,6 +1878,12 @@ FF_Error_t FF_Unmount( FF_Disk_t * pxDisk )
                 {
                     pxIOManager->xPartition.ucPartitionMounted = pdFALSE;
 
+                    #if ( ffconfigDEFER_FAT_MIRROR != 0 )
+                        {
+                            FF_FreeFATMirror( pxIOManager );
+                        }
+                    #endif
+
                     #if ( ffconfigMIRROR_FATS_UMOUNT != 0 )
                         {
                             FF_ReleaseSemaphore( pxIOManager->pvSemaphore );
@@ -1794,6 +1919,56 @@ FF_Error_t FF_Unmount( FF_Disk_t * pxDisk )
 } /* FF_Unmount() */
 /*-----------------------------------------------------------*/
 
+#if ( ffconfigEXFAT_SUPPORT != 0 )
+    static FF_Error_t prvUpdatePercentInUse( FF_IOManager_t * pxIOManager,
+                                             FF_Error_t xFunction )
+    {
+        FF_Partition_t * pxPartition = &( pxIOManager->xPartition );
+        FF_Buffer_t * pxBuffer;
+        FF_Error_t xError = FF_ERR_NONE;
+        uint8_t ucPercent;
+
+        #if ( ffconfigWRITE_FREE_COUNT != 0 )
+            {
+                const uint32_t ulClusterCount = pxPartition->ulNumClusters - 2UL;
+
+                /* The free count comes from the allocation bitmap. */
+                ucPercent = FF_exFATPercentInUse( ulClusterCount - pxPartition->ulFreeClusterCount, ulClusterCount );
+            }
+        #else
+            {
+                /* The field is not kept up to date, so it must say that the
+                 * value is not available. */
+                ucPercent = FF_EXFAT_PERCENT_NOT_AVAILABLE;
+            }
+        #endif
+
+        /* The boot sector is only written when the value changes. */
+        if( ucPercent != pxPartition->ucPercentInUse )
+        {
+            pxBuffer = FF_GetBuffer( pxIOManager, pxPartition->ulBeginLBA, FF_MODE_WRITE );
+
+            if( pxBuffer == NULL )
+            {
+                xError = ( FF_Error_t ) ( FF_ERR_DEVICE_DRIVER_FAILED | xFunction );
+            }
+            else
+            {
+                if( FF_exFATIsBootSector( pxBuffer->pucBuffer ) != pdFALSE )
+                {
+                    pxBuffer->pucBuffer[ FF_EXFAT_PERCENT_IN_USE ] = ucPercent;
+                    pxPartition->ucPercentInUse = ucPercent;
+                }
+
+                xError = FF_ReleaseBuffer( pxIOManager, pxBuffer );
+            }
+        }
+
+        return xError;
+    }
+#endif /* ffconfigEXFAT_SUPPORT */
+/*-----------------------------------------------------------*/
+
 FF_Error_t FF_IncreaseFreeClusters( FF_IOManager_t * pxIOManager,
                                     uint32_t Count )
 {
@@ -1883,6 +2058,15 @@ FF_Error_t FF_IncreaseFreeClusters( FF_IOManager_t * pxIOManager,
                 }
             }
         #endif /* if ( ffconfigWRITE_FREE_COUNT != 0 ) */
+
+        #if ( ffconfigEXFAT_SUPPORT != 0 )
+            {
+                if( ( FF_isERR( xError ) == pdFALSE ) && ( pxIOManager->xPartition.ucType == FF_T_EXFAT ) )
+                {
+                    xError = prvUpdatePercentInUse( pxIOManager, FF_INCREASEFREECLUSTERS );
+                }
+            }
+        #endif
     }
     while( pdFALSE );
 
@@ -1951,6 +2135,15 @@ FF_Error_t FF_DecreaseFreeClusters( FF_IOManager_t * pxIOManager,
                 }
             }
         #endif /* if ( ffconfigWRITE_FREE_COUNT != 0 ) */
+
+        #if ( ffconfigEXFAT_SUPPORT != 0 )
+            {
+                if( ( FF_isERR( xError ) == pdFALSE ) && ( pxIOManager->xPartition.ucType == FF_T_EXFAT ) )
+                {
+                    xError = prvUpdatePercentInUse( pxIOManager, FF_DECREASEFREECLUSTERS );
+                }
+            }
+        #endif
     }
 
     return xError;
@@ -887,7 +887,16 @@ int ff_remove( const char * pcPath )
     }
     else
     {
-        xError = FF_RmFile( xHandler.pxManager, xHandler.pcPath );
+        #if ( ffconfigDEFERRED_DELETE != 0 )
+            {
+                /* Large files are freed in the background. */
+                xError = FF_RmFileDeferred( xHandler.pxManager, xHandler.pcPath );
+            }
+        #else
+            {
+                xError = FF_RmFile( xHandler.pxManager, xHandler.pcPath );
+            }
+        #endif
         ff_errno = prvFFErrorToErrno( xError );
 
         #if ffconfigUSE_NOTIFY
@@ -1950,6 +1959,9 @@ int prvFFErrorToErrno( FF_Error_t xError )
         case FF_ERR_FILE_SEEK_INVALID_ORIGIN:
             return pdFREERTOS_ERRNO_EINVAL;                                         /* Seeking beyond end of file. */
 
+        case FF_ERR_FILE_TOO_LARGE:
+            return pdFREERTOS_ERRNO_EFTYPE;                                         /* An exFAT file is larger than 4 GB. */
+
         /* Directory Error Codes                    50 +. */
         case FF_ERR_DIR_OBJECT_EXISTS:
             return pdFREERTOS_ERRNO_EEXIST;                                         /* A file or folder of the same name already exists in the current directory. */
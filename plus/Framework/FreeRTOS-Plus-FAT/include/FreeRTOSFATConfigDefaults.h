@@ -158,6 +158,38 @@
     #define ffconfigFAT12_SUPPORT    0
 #endif
 
+#if !defined( ffconfigEXFAT_SUPPORT )
+
+/* Set to 1 to include exFAT support: exFAT volumes can be mounted, read,
+ * written and formatted with FF_FormatExFAT().
+ *
+ * File offsets and sizes stay 32-bit. Files of 4 GB and more are listed with
+ * a size of 0xFFFFFFFF, but FF_Open() refuses them with FF_ERR_FILE_TOO_LARGE,
+ * so they can not be read, written, moved or deleted.
+ *
+ * Set to 0 to exclude exFAT support. */
+    #define ffconfigEXFAT_SUPPORT    0
+#endif
+
+#if !defined( ffconfigEXFAT_UPCASE_CACHE )
+
+/* Only used if ffconfigEXFAT_SUPPORT is 1.
+ *
+ * The number of characters of the exFAT up-case table that are kept in RAM,
+ * at a cost of two bytes each.  Characters above this number are looked up
+ * in the table on the disk, which is slow. */
+    #define ffconfigEXFAT_UPCASE_CACHE    256
+#endif
+
+#if !defined( ffconfigEXFAT_DIR_CACHE_DEPTH )
+
+/* Only used if ffconfigEXFAT_SUPPORT is 1.
+ *
+ * The number of exFAT directories of which the location of the directory
+ * entry is remembered.  The entry must be updated when a directory grows. */
+    #define ffconfigEXFAT_DIR_CACHE_DEPTH    4
+#endif
+
 #if !defined( ffconfigOPTIMISE_UNALIGNED_ACCESS )
 
 /* When writing and reading data, i/o becomes less efficient if sizes other
@@ -192,6 +224,93 @@
     #define ffconfigWRITE_BOTH_FATS    0
 #endif
 
+#if !defined( ffconfigDEFER_FAT_MIRROR )
+
+/* Only used if ffconfigWRITE_BOTH_FATS is 1.
+ *
+ * Set to 1 to have only the first FAT written while clusters are allocated
+ * or freed.  The changed sectors are remembered in a bitmap, and they are
+ * copied to the other FAT(s) when the cache is flushed, e.g. by ff_fclose()
+ * and FF_Unmount().  The "clean shut-down" bit in the FAT is cleared in the
+ * mean time, so the copy is repeated when mounting after a crash.
+ *
+ * Set to 0 to write every FAT sector to all FATs directly. */
+    #define ffconfigDEFER_FAT_MIRROR    0
+#endif
+
+#if !defined( ffconfigFAT_MIRROR_BATCH_SECTORS )
+
+/* Only used if ffconfigDEFER_FAT_MIRROR is 1.
+ *
+ * The maximum number of consecutive FAT sectors that are copied to the other
+ * FAT(s) with a single read and write.  A buffer of this size is allocated
+ * for every mounted volume. */
+    #define ffconfigFAT_MIRROR_BATCH_SECTORS    8
+#endif
+
+#if ( ffconfigDEFER_FAT_MIRROR != 0 ) && ( ffconfigWRITE_BOTH_FATS == 0 )
+    #error ffconfigDEFER_FAT_MIRROR can only be used together with ffconfigWRITE_BOTH_FATS
+#endif
+
+#if !defined( ffconfigDEFERRED_DELETE )
+
+/* Set to 1 to include FF_RmFileDeferred() and a task that frees the clusters
+ * of large files in the background, see FF_DeferredDeleteStart().  A file
+ * disappears immediately: it is moved to ffconfigDEFERRED_DELETE_DIR, so the
+ * remaining work survives a reset and is resumed when the task starts again.
+ * ff_remove() will call FF_RmFileDeferred().
+ *
+ * Set to 0 to have all files deleted by FF_RmFile(). */
+    #define ffconfigDEFERRED_DELETE    0
+#endif
+
+#if !defined( ffconfigDEFERRED_DELETE_DIR )
+
+/* Only used if ffconfigDEFERRED_DELETE is 1.
+ *
+ * The directory that holds the files that are being deleted.  It is created
+ * when it is needed. */
+    #define ffconfigDEFERRED_DELETE_DIR    "/FF_DEL"
+#endif
+
+#if !defined( ffconfigDEFERRED_DELETE_BATCH )
+
+/* Only used if ffconfigDEFERRED_DELETE is 1.
+ *
+ * The maximum number of clusters that the task frees while it holds the FAT
+ * lock.  Files that are not larger than this are deleted immediately. */
+    #define ffconfigDEFERRED_DELETE_BATCH    1024
+#endif
+
+#if !defined( ffconfigDEFERRED_DELETE_DELAY_MS )
+
+/* Only used if ffconfigDEFERRED_DELETE is 1.
+ *
+ * The time that the task sleeps between two batches, giving other tasks
+ * access to the disk. */
+    #define ffconfigDEFERRED_DELETE_DELAY_MS    10
+#endif
+
+#if !defined( ffconfigDEFERRED_DELETE_PRIORITY )
+
+/* Only used if ffconfigDEFERRED_DELETE is 1.
+ *
+ * The priority of the task that frees the clusters. */
+    #define ffconfigDEFERRED_DELETE_PRIORITY    ( tskIDLE_PRIORITY + 1 )
+#endif
+
+#if !defined( ffconfigDEFERRED_DELETE_STACK_SIZE )
+
+/* Only used if ffconfigDEFERRED_DELETE is 1.
+ *
+ * The stack size of the task that frees the clusters, in words. */
+    #define ffconfigDEFERRED_DELETE_STACK_SIZE    ( configMINIMAL_STACK_SIZE * 8 )
+#endif
+
+#if ( ffconfigDEFERRED_DELETE != 0 ) && ( ffconfigUNICODE_UTF16_SUPPORT != 0 )
+    #error ffconfigDEFERRED_DELETE can not be used together with ffconfigUNICODE_UTF16_SUPPORT
+#endif
+
 #if !defined( ffconfigWRITE_FREE_COUNT )
 
 /* Set to 1 to have the number of free clusters and the first free cluster
@@ -332,6 +451,28 @@
     #define ffconfigFREE( ptr )    vPortFree( ptr )
 #endif
 
+#if !defined( ffconfigMALLOC_SECTOR )
+
+/* Set to a function that allocates memory that is read or written by the
+ * disk driver: the sector cache, the sector buffer of a file handle, and the
+ * buffer used while formatting.  When the kernel uses heap_6.c, this memory
+ * can be placed in a region that the DMA of the disk controller can reach,
+ * for instance:
+ * #define ffconfigMALLOC_SECTOR( size )    pvPortMallocTagged( size, portHEAP_ATTR_DMA, 0U )
+ * The memory is freed with ffconfigFREE(). */
+    #define ffconfigMALLOC_SECTOR( size )    ffconfigMALLOC( size )
+#endif
+
+#if !defined( ffconfigMALLOC_CONTROL )
+
+/* Set to a function that allocates the control blocks that are accessed for
+ * every I/O operation: the I/O manager, the buffer descriptors and the file
+ * handles.  With heap_6.c, these may be placed in fast memory, for instance:
+ * #define ffconfigMALLOC_CONTROL( size )    pvPortMallocTagged( size, 0U, portHEAP_ATTR_FAST )
+ * The memory is freed with ffconfigFREE(). */
+    #define ffconfigMALLOC_CONTROL( size )    ffconfigMALLOC( size )
+#endif
+
 #if !defined( ffconfig64_NUM_SUPPORT )
 
 /* Set to 1 to calculate the free size and volume size as a 64-bit number.
@@ -496,6 +637,23 @@
     #define USE_SOFT_WDT    0
 #endif
 
+#ifndef ffconfigTRACE_FLUSH_CACHE_START
+
+/* Called by FF_FlushCache() when it starts writing modified sectors, while
+ * holding the I/O manager's semaphore.  Together with
+ * ffconfigTRACE_FLUSH_CACHE_END() it can be used to measure how long a
+ * flush takes, e.g. with the deadline monitor in
+ * FreeRTOS-Plus-TCP/tools/tcp_utilities/deadline_monitor.md */
+    #define ffconfigTRACE_FLUSH_CACHE_START( pxIOManager )
+#endif
+
+#ifndef ffconfigTRACE_FLUSH_CACHE_END
+
+/* Called by FF_FlushCache() when the flush is done, just before it
+ * releases the semaphore. */
+    #define ffconfigTRACE_FLUSH_CACHE_END( pxIOManager )
+#endif
+
 #ifndef ffconfigNOT_USED_FOR_NOW
 
 /* This macro was once used for debugging.
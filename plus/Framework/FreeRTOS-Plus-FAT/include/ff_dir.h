@@ -96,6 +96,11 @@ typedef struct
     #if ( ffconfigDEV_SUPPORT != 0 )
         uint8_t ucIsDeviceDir;
     #endif
+    #if ( ffconfigEXFAT_SUPPORT != 0 )
+        uint8_t ucStreamFlags;      /**< exFAT: flags of the stream extension entry. */
+        uint32_t ulValidDataLength; /**< exFAT: number of bytes that have been written. */
+        uint32_t ulFileSizeHigh;    /**< exFAT: upper 32 bits of the file's size. */
+    #endif
     FF_FetchContext_t xFetchContext;
 } FF_DirEnt_t;
 
@@ -94,6 +94,7 @@
 #define FF_INCREASEFREECLUSTERS     ( ( 13 << FF_FUNCTION_SHIFT ) | FF_MODULE_IOMAN )
 #define FF_PARTITIONSEARCH          ( ( 14 << FF_FUNCTION_SHIFT ) | FF_MODULE_IOMAN )
 #define FF_PARSEEXTENDED            ( ( 15 << FF_FUNCTION_SHIFT ) | FF_MODULE_IOMAN )
+#define FF_EXFATMOUNT               ( ( 16 << FF_FUNCTION_SHIFT ) | FF_MODULE_IOMAN )
 
 
 /*----- FreeRTOS+FAT Return codes for user Rd/Wr routines */
@@ -117,6 +118,8 @@
 #define FF_MKDIR                     ( ( 12 << FF_FUNCTION_SHIFT ) | FF_MODULE_DIR )
 #define FF_TRAVERSE                  ( ( 13 << FF_FUNCTION_SHIFT ) | FF_MODULE_DIR )
 #define FF_FINDDIR                   ( ( 14 << FF_FUNCTION_SHIFT ) | FF_MODULE_DIR )
+#define FF_EXFATFINDENTRY            ( ( 15 << FF_FUNCTION_SHIFT ) | FF_MODULE_DIR )
+#define FF_EXFATCREATEDIRENT         ( ( 16 << FF_FUNCTION_SHIFT ) | FF_MODULE_DIR )
 
 /*----- FF_FILE - The FreeRTOS+FAT file handling routines. */
 #define FF_GETMODEBITS               ( ( 1 << FF_FUNCTION_SHIFT ) | FF_MODULE_FILE )
@@ -145,6 +148,7 @@
 #define FF_SETFILETIME               ( ( 24 << FF_FUNCTION_SHIFT ) | FF_MODULE_FILE )
 #define FF_INITBUF                   ( ( 25 << FF_FUNCTION_SHIFT ) | FF_MODULE_FILE )
 #define FF_SETEOF                    ( ( 26 << FF_FUNCTION_SHIFT ) | FF_MODULE_FILE )
+#define FF_DEFERREDDELETE            ( ( 27 << FF_FUNCTION_SHIFT ) | FF_MODULE_FILE )
 
 /*----- FF_FAT - The FreeRTOS+FAT FAT handling routines. */
 #define FF_GETFATENTRY               ( ( 1 << FF_FUNCTION_SHIFT ) | FF_MODULE_FAT )
@@ -152,9 +156,13 @@
 #define FF_PUTFATENTRY               ( ( 3 << FF_FUNCTION_SHIFT ) | FF_MODULE_FAT )
 #define FF_FINDFREECLUSTER           ( ( 4 << FF_FUNCTION_SHIFT ) | FF_MODULE_FAT )
 #define FF_COUNTFREECLUSTERS         ( ( 5 << FF_FUNCTION_SHIFT ) | FF_MODULE_FAT )
+#define FF_EXFATFINDFREECLUSTER      ( ( 6 << FF_FUNCTION_SHIFT ) | FF_MODULE_FAT )
+#define FF_EXFATSETBITMAP            ( ( 7 << FF_FUNCTION_SHIFT ) | FF_MODULE_FAT )
+#define FF_MIRRORFATS                ( ( 8 << FF_FUNCTION_SHIFT ) | FF_MODULE_FAT )
 
 /*----- FF_FORMAT - The FreeRTOS+FAT format routine */
 #define FF_FORMATPARTITION           ( ( 1 << FF_FUNCTION_SHIFT ) | FF_MODULE_FORMAT )
+#define FF_FORMATEXFAT               ( ( 2 << FF_FUNCTION_SHIFT ) | FF_MODULE_FORMAT )
 
 /*----- FF_UNICODE - The FreeRTOS+FAT unicode routines. */
 #define FF_UTF8CTOUTF16C             ( ( 1 << FF_FUNCTION_SHIFT ) | FF_MODULE_STRING )
@@ -216,6 +224,7 @@
 #define FF_ERR_FILE_READ_ZERO                   44 /* Used internally. */
 #define FF_ERR_FILE_SEEK_INVALID_ORIGIN         45 /* Seeking beyond end of file. */
 #define FF_ERR_FILE_SEEK_INVALID_POSITION       46 /* Bad value for the 'whence' parameter. */
+#define FF_ERR_FILE_TOO_LARGE                   47 /* An exFAT file is larger than 4 GB and can not be opened. */
 
 /* Directory Error Codes                    50 + */
 #define FF_ERR_DIR_OBJECT_EXISTS                50 /* A file or folder of the same name already exists in the current directory. */
@@ -0,0 +1,199 @@
+/*
+ * FreeRTOS+FAT V2.3.3
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/**
+ *	@file		ff_exfat.h
+ *	@ingroup	EXFAT
+ **/
+
+#ifndef _FF_EXFAT_H_
+    #define _FF_EXFAT_H_
+
+    #ifndef PLUS_FAT_H
+        #error this header will be included from "ff_headers.h"
+    #endif
+
+    #ifdef  __cplusplus
+        extern "C" {
+    #endif
+
+    #if ( ffconfigEXFAT_SUPPORT != 0 )
+
+/*---------- BOOT SECTOR */
+        #define FF_EXFAT_FS_NAME                  3     /* "EXFAT   " */
+        #define FF_EXFAT_PARTITION_OFFSET         0x40  /* 64-bit, sectors in front of the volume. */
+        #define FF_EXFAT_VOLUME_LENGTH            0x48  /* 64-bit, size of the volume in sectors. */
+        #define FF_EXFAT_FAT_OFFSET               0x50
+        #define FF_EXFAT_FAT_LENGTH               0x54
+        #define FF_EXFAT_CLUSTER_HEAP_OFFSET      0x58
+        #define FF_EXFAT_CLUSTER_COUNT            0x5C
+        #define FF_EXFAT_ROOT_DIR_CLUSTER         0x60
+        #define FF_EXFAT_VOLUME_SERIAL            0x64
+        #define FF_EXFAT_FS_REVISION              0x68
+        #define FF_EXFAT_VOLUME_FLAGS             0x6A  /* Not part of the boot checksum. */
+        #define FF_EXFAT_BYTES_PER_SECTOR_SHIFT   0x6C
+        #define FF_EXFAT_SECTORS_PER_CLUS_SHIFT   0x6D
+        #define FF_EXFAT_NUMBER_OF_FATS           0x6E
+        #define FF_EXFAT_DRIVE_SELECT             0x6F
+        #define FF_EXFAT_PERCENT_IN_USE           0x70  /* Not part of the boot checksum. */
+        #define FF_EXFAT_PERCENT_NOT_AVAILABLE    0xFF  /* A value of PercentInUse. */
+
+        #define FF_EXFAT_BOOT_REGION_SECTORS      12    /* Followed by a backup of the same size. */
+        #define FF_EXFAT_CHECKSUM_SECTOR          11
+
+/*---------- DIRECTORY ENTRIES */
+        #define FF_EXFAT_TYPE_END                 0x00
+        #define FF_EXFAT_TYPE_IN_USE              0x80 /* Cleared when an entry is deleted. */
+        #define FF_EXFAT_TYPE_BITMAP              0x81
+        #define FF_EXFAT_TYPE_UPCASE              0x82
+        #define FF_EXFAT_TYPE_LABEL               0x83
+        #define FF_EXFAT_TYPE_FILE                0x85
+        #define FF_EXFAT_TYPE_STREAM              0xC0
+        #define FF_EXFAT_TYPE_NAME                0xC1
+
+/* The file entry, which is the primary entry of a set. */
+        #define FF_EXFAT_FILE_SECONDARY_COUNT     0x01
+        #define FF_EXFAT_FILE_SET_CHECKSUM        0x02
+        #define FF_EXFAT_FILE_ATTRIBUTES          0x04
+        #define FF_EXFAT_FILE_CREATE_TIME         0x08
+        #define FF_EXFAT_FILE_MODIFY_TIME         0x0C
+        #define FF_EXFAT_FILE_ACCESS_TIME         0x10
+        #define FF_EXFAT_FILE_CREATE_10MS         0x14
+        #define FF_EXFAT_FILE_MODIFY_10MS         0x15
+        #define FF_EXFAT_FILE_CREATE_UTC          0x16
+        #define FF_EXFAT_FILE_MODIFY_UTC          0x17
+        #define FF_EXFAT_FILE_ACCESS_UTC          0x18
+
+/* The stream extension entry. */
+        #define FF_EXFAT_STREAM_FLAGS             0x01
+        #define FF_EXFAT_STREAM_NAME_LENGTH       0x03
+        #define FF_EXFAT_STREAM_NAME_HASH         0x04
+        #define FF_EXFAT_STREAM_VALID_LENGTH      0x08 /* 64-bit */
+        #define FF_EXFAT_STREAM_FIRST_CLUSTER     0x14
+        #define FF_EXFAT_STREAM_DATA_LENGTH       0x18 /* 64-bit */
+
+/* The file name entries, 15 UTF-16 characters each. */
+        #define FF_EXFAT_NAME_CHARS               0x02
+        #define FF_EXFAT_CHARS_PER_NAME_ENTRY     15
+        #define FF_EXFAT_MAX_NAME_LENGTH          255
+
+/* The volume label, bitmap and up-case table entries. */
+        #define FF_EXFAT_LABEL_COUNT              0x01
+        #define FF_EXFAT_LABEL_CHARS              0x02
+        #define FF_EXFAT_UPCASE_CHECKSUM          0x04
+        #define FF_EXFAT_ALLOC_FIRST_CLUSTER      0x14
+        #define FF_EXFAT_ALLOC_DATA_LENGTH        0x18
+
+/* Values of the stream extension flags, also stored in 'ucStreamFlags'. */
+        #define FF_EXFAT_FLAG_ALLOCATION_POSSIBLE    0x01
+        #define FF_EXFAT_FLAG_NO_FAT_CHAIN           0x02
+
+/*---------- PROTOTYPES */
+
+/* Mounting and checksums. */
+        BaseType_t FF_exFATIsBootSector( const uint8_t * pucSector );
+        FF_Error_t FF_exFATMount( FF_IOManager_t * pxIOManager,
+                                  FF_Buffer_t * pxBuffer );
+        uint32_t FF_exFATBootChecksum( uint32_t ulChecksum,
+                                       const uint8_t * pucSector,
+                                       size_t uxLength,
+                                       BaseType_t xIsBootSector );
+        uint32_t FF_exFATTableChecksum( uint32_t ulChecksum,
+                                        const uint8_t * pucData,
+                                        size_t uxLength );
+        uint8_t FF_exFATPercentInUse( uint32_t ulUsedClusters,
+                                      uint32_t ulClusterCount );
+
+/* The allocation bitmap, these functions must be called with the FAT locked. */
+        uint32_t FF_exFATFindFreeCluster( FF_IOManager_t * pxIOManager,
+                                          FF_Error_t * pxError );
+        uint32_t FF_exFATCountFreeClusters( FF_IOManager_t * pxIOManager,
+                                            FF_Error_t * pxError );
+        FF_Error_t FF_exFATSetBitmap( FF_IOManager_t * pxIOManager,
+                                      uint32_t ulCluster,
+                                      uint32_t ulCount,
+                                      BaseType_t xInUse );
+        uint32_t FF_exFATClaimContiguous( FF_IOManager_t * pxIOManager,
+                                          uint32_t ulCluster,
+                                          uint32_t ulCount,
+                                          FF_Error_t * pxError );
+        FF_Error_t FF_exFATFreeClusters( FF_IOManager_t * pxIOManager,
+                                         uint32_t ulCluster,
+                                         uint32_t ulCount );
+        FF_Error_t FF_exFATWriteChain( FF_IOManager_t * pxIOManager,
+                                       uint32_t ulCluster,
+                                       uint32_t ulCount );
+
+/* Directory entries.  An object is known by the index of its file entry. */
+        #if ( ffconfigUNICODE_UTF16_SUPPORT != 0 )
+            uint32_t FF_exFATFindEntryInDir( FF_IOManager_t * pxIOManager,
+                                             FF_FindParams_t * pxFindParams,
+                                             const FF_T_WCHAR * pcName,
+                                             uint8_t ucAttrib,
+                                             FF_DirEnt_t * pxDirEntry,
+                                             FF_Error_t * pxError );
+        #else
+            uint32_t FF_exFATFindEntryInDir( FF_IOManager_t * pxIOManager,
+                                             FF_FindParams_t * pxFindParams,
+                                             const char * pcName,
+                                             uint8_t ucAttrib,
+                                             FF_DirEnt_t * pxDirEntry,
+                                             FF_Error_t * pxError );
+        #endif
+        FF_Error_t FF_exFATFindNext( FF_IOManager_t * pxIOManager,
+                                     FF_DirEnt_t * pxDirEntry );
+        FF_Error_t FF_exFATGetEntry( FF_IOManager_t * pxIOManager,
+                                     uint16_t usEntry,
+                                     uint32_t ulDirCluster,
+                                     FF_DirEnt_t * pxDirEntry );
+        FF_Error_t FF_exFATPutEntry( FF_IOManager_t * pxIOManager,
+                                     uint16_t usEntry,
+                                     uint32_t ulDirCluster,
+                                     FF_DirEnt_t * pxDirEntry );
+        FF_Error_t FF_exFATCreateDirent( FF_IOManager_t * pxIOManager,
+                                         FF_FindParams_t * pxFindParams,
+                                         FF_DirEnt_t * pxDirEntry );
+        FF_Error_t FF_exFATRmEntrySet( FF_IOManager_t * pxIOManager,
+                                       uint16_t usEntry,
+                                       FF_FetchContext_t * pxContext );
+
+/* Directories must know where their own entry is, because it holds their length. */
+        void FF_exFATRememberDir( FF_IOManager_t * pxIOManager,
+                                  uint32_t ulDirCluster,
+                                  uint32_t ulParentCluster,
+                                  uint16_t usEntry );
+        FF_Error_t FF_exFATDirectoryExtended( FF_IOManager_t * pxIOManager,
+                                              uint32_t ulDirCluster );
+        BaseType_t FF_exFATDirIsKnown( FF_IOManager_t * pxIOManager,
+                                       uint32_t ulDirCluster );
+
+    #endif /* ffconfigEXFAT_SUPPORT */
+
+    #ifdef  __cplusplus
+        } /* extern "C" */
+    #endif
+
+#endif /* _FF_EXFAT_H_ */
@@ -50,6 +50,10 @@
         unsigned getCount[ 2 ]; /* Index 0 for READ counts, index 1 for WRITE counts. */
         unsigned reuseCount[ 2 ];
         unsigned missCount[ 2 ];
+        #if ( ffconfigDEFER_FAT_MIRROR != 0 )
+            unsigned mirrorBatches; /* Number of writes to the other FAT(s). */
+            unsigned mirrorSectors; /* Number of sectors copied to the other FAT(s). */
+        #endif
     };
 
     extern struct SFatStat fatStat;
@@ -132,6 +136,12 @@ uint32_t FF_FindEndOfChain( FF_IOManager_t * pxIOManager,
 FF_Error_t FF_ClearCluster( FF_IOManager_t * pxIOManager,
                             uint32_t ulCluster );
 
+#if ( ffconfigDEFER_FAT_MIRROR != 0 )
+    FF_Error_t FF_MirrorFATs( FF_IOManager_t * pxIOManager );
+    FF_Error_t FF_InitFATMirror( FF_IOManager_t * pxIOManager );
+    void FF_FreeFATMirror( FF_IOManager_t * pxIOManager );
+#endif
+
 #if ( ffconfig64_NUM_SUPPORT != 0 )
     uint64_t FF_GetFreeSize( FF_IOManager_t * pxIOManager,
                              FF_Error_t * pxError );
@@ -71,6 +71,9 @@ typedef struct _FF_FILE
         uint8_t ucState;     /* State information about the buffer. */
     #endif
     uint8_t ucMode;          /* Mode that File Was opened in. */
+    #if ( ffconfigEXFAT_SUPPORT != 0 )
+        uint8_t ucStreamFlags; /* exFAT: flags of the stream extension entry. */
+    #endif
     uint16_t usDirEntry;     /* Dirent Entry Number describing this file. */
 
     #if ( ffconfigDEV_SUPPORT != 0 )
@@ -118,6 +121,13 @@ typedef struct _FF_FILE
                         BaseType_t bDeleteIfExists );
 #endif /* ffconfigUNICODE_UTF16_SUPPORT */
 
+#if ( ffconfigDEFERRED_DELETE != 0 )
+    FF_Error_t FF_RmFileDeferred( FF_IOManager_t * pxIOManager,
+                                  const char * pcPath );
+    FF_Error_t FF_DeferredDeleteStart( FF_IOManager_t * pxIOManager );
+    void FF_DeferredDeleteStop( FF_IOManager_t * pxIOManager );
+#endif
+
 #if ( ffconfigTIME_SUPPORT != 0 )
     enum
     {
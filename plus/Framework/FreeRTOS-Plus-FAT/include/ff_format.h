@@ -78,6 +78,12 @@
                               BaseType_t xSmallClusters,
                               const char * pcVolumeName );
 
+    #if ( ffconfigEXFAT_SUPPORT != 0 )
+        FF_Error_t FF_FormatExFAT( FF_Disk_t * pxDisk,
+                                   BaseType_t xPartitionNumber,
+                                   const char * pcVolumeName );
+    #endif
+
 /* Private : */
 
     #ifdef  __cplusplus
@@ -52,6 +52,7 @@
     #include "ff_crc.h"
     #include "ff_file.h"
     #include "ff_dir.h"
+    #include "ff_exfat.h"
     #include "ff_string.h"
     #include "ff_format.h"
     #include "ff_locking.h"
@@ -45,6 +45,12 @@
     #define FF_T_FAT12                      0x0A
     #define FF_T_FAT16                      0x0B
     #define FF_T_FAT32                      0x0C
+    #if ( ffconfigEXFAT_SUPPORT != 0 )
+        #define FF_T_EXFAT                  0x07
+    #endif
+
+/* FAT12 and FAT16 have a root directory of a fixed size, in front of the data area. */
+    #define FF_isFixedRootDirType( ucType )    ( ( ( ucType ) == FF_T_FAT12 ) || ( ( ucType ) == FF_T_FAT16 ) )
 
     #define FF_MODE_READ                    0x01                             /* Buffer / FILE Mode for Read Access. */
     #define FF_MODE_WRITE                   0x02                             /* Buffer / FILE Mode for Write Access. */
@@ -226,6 +232,18 @@
         uint32_t ulDirCluster;
     } FF_PathCache_t;
 
+    #if ( ffconfigEXFAT_SUPPORT != 0 )
+
+/* The location of the directory entry of an exFAT directory: the entry must
+ * be updated when the directory grows. */
+        typedef struct
+        {
+            uint32_t ulDirCluster;    /* The first cluster of the directory. */
+            uint32_t ulParentCluster; /* The first cluster of the directory that holds its entry. */
+            uint16_t usEntry;         /* The index of the primary (file) entry. */
+        } FF_exFATDirLocation_t;
+    #endif
+
 /**
  *	@private
  *	@brief	FreeRTOS+FAT identifies a partition with the following data.
@@ -264,6 +282,22 @@
             FF_PathCache_t pxPathCache[ ffconfigPATH_CACHE_DEPTH ];
             uint32_t ulPCIndex;
         #endif
+        #if ( ffconfigEXFAT_SUPPORT != 0 )
+            uint32_t ulBitmapLBA;     /* LBA of the allocation bitmap, which is stored contiguously. */
+            uint32_t ulBitmapCluster; /* First cluster of the allocation bitmap. */
+            uint32_t ulBitmapLength;  /* Length of the allocation bitmap in bytes. */
+            uint32_t ulUpcaseCluster; /* First cluster of the up-case table. */
+            uint32_t ulUpcaseLength;  /* Length of the up-case table in bytes. */
+            uint16_t usUpcase[ ffconfigEXFAT_UPCASE_CACHE ];
+            FF_exFATDirLocation_t xDirLocations[ ffconfigEXFAT_DIR_CACHE_DEPTH ];
+            uint32_t ulDirLocationIndex;
+            uint8_t ucPercentInUse;   /* PercentInUse as it was last read from or written to the boot sector. */
+        #endif
+        #if ( ffconfigDEFER_FAT_MIRROR != 0 )
+            uint8_t * pucFATDirty;      /* One bit for every sector of the first FAT that was changed, or NULL when all FATs are written directly. */
+            uint8_t * pucMirrorBuffer;  /* ffconfigFAT_MIRROR_BATCH_SECTORS sectors used to copy the FAT. */
+            BaseType_t xFATMirrorDirty; /* pdTRUE when the copies of the FAT may differ. */
+        #endif
     } FF_Partition_t;
 
 
@@ -303,6 +337,11 @@
             FF_HashTable_t xHashCache[ ffconfigHASH_CACHE_DEPTH ];
         #endif
         void * pvFATLockHandle;
+        #if ( ffconfigDEFERRED_DELETE != 0 )
+            TaskHandle_t xDeleteTask; /* The task that frees the clusters of deleted files. */
+            BaseType_t xDeleteStop;   /* Set by FF_DeferredDeleteStop() to stop the task. */
+            uint32_t ulDeleteCounter; /* Used to give every file in ffconfigDEFERRED_DELETE_DIR a unique name. */
+        #endif
     } FF_IOManager_t;
 
 /* Bit values for 'FF_IOManager_t::ucFlags': */
@@ -0,0 +1,522 @@
+/*
+ * FreeRTOS+TCP V2.3.2
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/*
+ * A CoAP client ( RFC 7252 ) that talks to a single server.
+ *
+ * Confirmable requests are retransmitted with an exponential back-off,
+ * both piggybacked and separate responses are accepted.  Request bodies
+ * larger than a block are sent with Block1, large responses are fetched
+ * with Block2 ( RFC 7959 ).  One resource can be observed ( RFC 7641 ).
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_Sockets.h"
+
+/* FreeRTOS Protocol includes. */
+#include "FreeRTOS_CoAP.h"
+
+/* ACK_RANDOM_FACTOR is 1.5: the first time-out is chosen between
+ * ACK_TIMEOUT and 1.5 * ACK_TIMEOUT. */
+#define coapACK_RANDOM_SPREAD_MS		( ipconfigCOAP_ACK_TIMEOUT_MS / 2U )
+
+/* After an empty ACK, wait this long for the separate response. */
+#define coapSEPARATE_RESPONSE_MS		( ipconfigCOAP_ACK_TIMEOUT_MS << ( ipconfigCOAP_MAX_RETRANSMIT + 1 ) )
+
+/* Observe sequence numbers are 24 bits. */
+#define coapOBSERVE_HALF_RANGE			0x00800000U
+#define coapOBSERVE_MASK				0x00FFFFFFU
+
+static void prvNewToken( CoAPClient_t * pxClient );
+static void prvSendEmpty( CoAPClient_t * pxClient,
+						  uint8_t ucType,
+						  uint16_t usMessageID );
+static BaseType_t prvHandleNotification( CoAPClient_t * pxClient );
+static BaseType_t prvExchange( CoAPClient_t * pxClient,
+							   size_t uxLength,
+							   BaseType_t xConfirmable,
+							   uint16_t usMessageID );
+static BaseType_t prvStartRequest( CoAPClient_t * pxClient,
+								   CoAPBuilder_t * pxBuilder,
+								   uint8_t ucMethod,
+								   BaseType_t xConfirmable );
+/*-----------------------------------------------------------*/
+
+BaseType_t FreeRTOS_CoAPClientInit( CoAPClient_t * pxClient,
+									const struct freertos_sockaddr * pxServer )
+{
+struct freertos_sockaddr xAddress;
+uint32_t ulRandom = 0U;
+
+	( void ) memset( pxClient, 0, sizeof( *pxClient ) );
+
+	pxClient->xSocket = FreeRTOS_socket( FREERTOS_AF_INET, FREERTOS_SOCK_DGRAM, FREERTOS_IPPROTO_UDP );
+
+	if( xSocketValid( pxClient->xSocket ) == pdFALSE )
+	{
+		FreeRTOS_printf( ( "FreeRTOS_CoAPClientInit: socket failed\n" ) );
+		return pdFAIL;
+	}
+
+	/* Bind to any free port. */
+	( void ) memset( &xAddress, 0, sizeof( xAddress ) );
+	xAddress.sin_family = FREERTOS_AF_INET;
+
+	if( FreeRTOS_bind( pxClient->xSocket, &xAddress, sizeof( xAddress ) ) != 0 )
+	{
+		FreeRTOS_printf( ( "FreeRTOS_CoAPClientInit: bind failed\n" ) );
+		( void ) FreeRTOS_closesocket( pxClient->xSocket );
+		pxClient->xSocket = FREERTOS_INVALID_SOCKET;
+		return pdFAIL;
+	}
+
+	( void ) memcpy( &( pxClient->xServer ), pxServer, sizeof( pxClient->xServer ) );
+
+	( void ) xApplicationGetRandomNumber( &ulRandom );
+	pxClient->usMessageID = ( uint16_t ) ulRandom;
+
+	return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+void FreeRTOS_CoAPClientClose( CoAPClient_t * pxClient )
+{
+	if( xSocketValid( pxClient->xSocket ) != pdFALSE )
+	{
+		( void ) FreeRTOS_closesocket( pxClient->xSocket );
+	}
+
+	pxClient->xSocket = FREERTOS_INVALID_SOCKET;
+	pxClient->xObserving = pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+static void prvNewToken( CoAPClient_t * pxClient )
+{
+uint32_t ulRandom = 0U;
+
+	( void ) xApplicationGetRandomNumber( &ulRandom );
+	( void ) memcpy( pxClient->ucToken, &ulRandom, sizeof( pxClient->ucToken ) );
+}
+/*-----------------------------------------------------------*/
+
+static void prvSendEmpty( CoAPClient_t * pxClient,
+						  uint8_t ucType,
+						  uint16_t usMessageID )
+{
+CoAPBuilder_t xBuilder;
+uint8_t ucBuffer[ 4 ];
+size_t uxLength;
+
+	vCoAPBuilderInit( &xBuilder, ucBuffer, sizeof( ucBuffer ), ucType, coapCODE_EMPTY, usMessageID, NULL, 0U );
+	uxLength = uxCoAPBuilderFinish( &xBuilder, 0U );
+	( void ) FreeRTOS_sendto( pxClient->xSocket, ucBuffer, uxLength, 0, &( pxClient->xServer ), sizeof( pxClient->xServer ) );
+}
+/*-----------------------------------------------------------*/
+
+/* Check if the message in 'xReply' is a notification for the observed
+ * resource, and pass it to the application. */
+static BaseType_t prvHandleNotification( CoAPClient_t * pxClient )
+{
+const CoAPMessage_t * pxMessage = &( pxClient->xReply );
+const CoAPOption_t * pxObserve;
+BaseType_t xResult = pdFALSE;
+
+	if( ( pxClient->xObserving != pdFALSE ) &&
+		( coapCODE_CLASS( pxMessage->ucCode ) >= 2U ) &&
+		( pxMessage->ucTokenLength == sizeof( pxClient->ucObserveToken ) ) &&
+		( memcmp( pxMessage->ucToken, pxClient->ucObserveToken, sizeof( pxClient->ucObserveToken ) ) == 0 ) )
+	{
+		xResult = pdTRUE;
+
+		if( pxMessage->ucType == coapTYPE_CON )
+		{
+			prvSendEmpty( pxClient, coapTYPE_ACK, pxMessage->usMessageID );
+		}
+
+		pxObserve = pxCoAPFindOption( pxMessage, coapOPTION_OBSERVE );
+
+		if( pxObserve == NULL )
+		{
+			/* Without an Observe option, the observation has ended. */
+			pxClient->xObserving = pdFALSE;
+		}
+		else
+		{
+		uint32_t ulSequence = ulCoAPOptionUint( pxObserve );
+
+			/* Drop notifications that arrive out of order ( RFC 7641, section 3.4 ). */
+			if( ( ( ulSequence - pxClient->ulLastSequence ) & coapOBSERVE_MASK ) >= coapOBSERVE_HALF_RANGE )
+			{
+				return xResult;
+			}
+
+			pxClient->ulLastSequence = ulSequence;
+		}
+
+		if( pxClient->fObserveData != NULL )
+		{
+			pxClient->fObserveData( pxClient->pvObserveContext, pxMessage->ucCode, 0U, pxMessage->pucPayload, pxMessage->uxPayloadLength );
+		}
+	}
+
+	return xResult;
+}
+/*-----------------------------------------------------------*/
+
+/* Send the message in 'ucTxBuffer' and wait for the response that has
+ * the current token.  The response is decoded in 'xReply'. */
+static BaseType_t prvExchange( CoAPClient_t * pxClient,
+							   size_t uxLength,
+							   BaseType_t xConfirmable,
+							   uint16_t usMessageID )
+{
+struct freertos_sockaddr xSource;
+socklen_t xSourceLength = sizeof( xSource );
+TickType_t xTimeout, xStart, xElapsed, xRemaining;
+BaseType_t xAcknowledged = ( xConfirmable == pdFALSE ) ? pdTRUE : pdFALSE;
+BaseType_t xRetransmissions = 0;
+BaseType_t xResult = coapERROR_TIMEOUT;
+uint32_t ulRandom = 0U;
+int32_t lBytes;
+
+	if( uxLength == 0U )
+	{
+		return coapERROR_NO_MEMORY;
+	}
+
+	( void ) xApplicationGetRandomNumber( &ulRandom );
+	xTimeout = pdMS_TO_TICKS( ipconfigCOAP_ACK_TIMEOUT_MS + ( ulRandom % coapACK_RANDOM_SPREAD_MS ) );
+
+	( void ) FreeRTOS_sendto( pxClient->xSocket, pxClient->ucTxBuffer, uxLength, 0, &( pxClient->xServer ), sizeof( pxClient->xServer ) );
+	xStart = xTaskGetTickCount();
+
+	for( ; ; )
+	{
+		xElapsed = xTaskGetTickCount() - xStart;
+
+		if( xElapsed >= xTimeout )
+		{
+			if( ( xAcknowledged != pdFALSE ) || ( xRetransmissions >= ipconfigCOAP_MAX_RETRANSMIT ) )
+			{
+				break;
+			}
+
+			/* Retransmit, doubling the time-out each time. */
+			xRetransmissions++;
+			xTimeout *= 2U;
+			( void ) FreeRTOS_sendto( pxClient->xSocket, pxClient->ucTxBuffer, uxLength, 0, &( pxClient->xServer ), sizeof( pxClient->xServer ) );
+			xStart = xTaskGetTickCount();
+			continue;
+		}
+
+		xRemaining = xTimeout - xElapsed;
+		( void ) FreeRTOS_setsockopt( pxClient->xSocket, 0, FREERTOS_SO_RCVTIMEO, &xRemaining, sizeof( xRemaining ) );
+		lBytes = FreeRTOS_recvfrom( pxClient->xSocket, pxClient->ucRxBuffer, sizeof( pxClient->ucRxBuffer ), 0, &xSource, &xSourceLength );
+
+		if( ( lBytes <= 0 ) ||
+			( xCoAPSameEndpoint( &xSource, &( pxClient->xServer ) ) == pdFALSE ) ||
+			( xCoAPParse( pxClient->ucRxBuffer, ( size_t ) lBytes, &( pxClient->xReply ) ) == pdFAIL ) )
+		{
+			continue;
+		}
+
+		if( pxClient->xReply.ucCode == coapCODE_EMPTY )
+		{
+			if( pxClient->xReply.usMessageID != usMessageID )
+			{
+				/* An ACK or RST of an older exchange. */
+			}
+			else if( pxClient->xReply.ucType == coapTYPE_RST )
+			{
+				xResult = coapERROR_RESET;
+				break;
+			}
+			else if( pxClient->xReply.ucType == coapTYPE_ACK )
+			{
+				/* The server will send a separate response later. */
+				xAcknowledged = pdTRUE;
+				xTimeout = pdMS_TO_TICKS( coapSEPARATE_RESPONSE_MS );
+				xStart = xTaskGetTickCount();
+			}
+			else
+			{
+				/* A ping from the server. */
+				prvSendEmpty( pxClient, coapTYPE_RST, pxClient->xReply.usMessageID );
+			}
+		}
+		else if( ( pxClient->xReply.ucTokenLength == sizeof( pxClient->ucToken ) ) &&
+				 ( memcmp( pxClient->xReply.ucToken, pxClient->ucToken, sizeof( pxClient->ucToken ) ) == 0 ) &&
+				 ( ( pxClient->xReply.ucType != coapTYPE_ACK ) || ( pxClient->xReply.usMessageID == usMessageID ) ) )
+		{
+			if( pxClient->xReply.ucType == coapTYPE_CON )
+			{
+				prvSendEmpty( pxClient, coapTYPE_ACK, pxClient->xReply.usMessageID );
+			}
+
+			xResult = pdPASS;
+			break;
+		}
+		else if( prvHandleNotification( pxClient ) == pdFALSE )
+		{
+			if( pxClient->xReply.ucType == coapTYPE_CON )
+			{
+				/* Not expected. */
+				prvSendEmpty( pxClient, coapTYPE_RST, pxClient->xReply.usMessageID );
+			}
+		}
+		else
+		{
+			/* A notification was handled. */
+		}
+	}
+
+	return xResult;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvStartRequest( CoAPClient_t * pxClient,
+								   CoAPBuilder_t * pxBuilder,
+								   uint8_t ucMethod,
+								   BaseType_t xConfirmable )
+{
+uint16_t usMessageID = pxClient->usMessageID++;
+
+	prvNewToken( pxClient );
+	vCoAPBuilderInit( pxBuilder, pxClient->ucTxBuffer, sizeof( pxClient->ucTxBuffer ),
+					  ( xConfirmable != pdFALSE ) ? coapTYPE_CON : coapTYPE_NON,
+					  ucMethod, usMessageID, pxClient->ucToken, ( uint8_t ) sizeof( pxClient->ucToken ) );
+
+	return ( BaseType_t ) usMessageID;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t FreeRTOS_CoAPClientRequest( CoAPClient_t * pxClient,
+									   uint8_t ucMethod,
+									   const char * pcPath,
+									   const uint8_t * pucPayload,
+									   size_t uxLength,
+									   BaseType_t xConfirmable,
+									   FCoAPClientData fOnData,
+									   void * pvContext )
+{
+CoAPBuilder_t xBuilder;
+CoAPBlock_t xBlock;
+uint8_t ucSZX = ucCoAPSizeToSZX( ipconfigCOAP_BLOCK_SIZE );
+size_t uxOffset = 0U;
+uint32_t ulReceived;
+BaseType_t xResult;
+uint16_t usMessageID;
+
+	/* Send the request, one block at a time if the body is large. */
+	for( ; ; )
+	{
+	size_t uxBlockSize = coapBLOCK_SIZE( ucSZX );
+	size_t uxChunk = uxLength - uxOffset;
+	size_t uxSpace;
+	uint8_t * pucSpace;
+
+		if( uxChunk > uxBlockSize )
+		{
+			uxChunk = uxBlockSize;
+		}
+
+		usMessageID = ( uint16_t ) prvStartRequest( pxClient, &xBuilder, ucMethod, xConfirmable );
+		vCoAPAddPath( &xBuilder, pcPath );
+
+		if( uxLength > uxBlockSize )
+		{
+			xBlock.ulNumber = ( uint32_t ) ( uxOffset / uxBlockSize );
+			xBlock.ucSZX = ucSZX;
+			xBlock.xMore = ( ( uxOffset + uxChunk ) < uxLength ) ? pdTRUE : pdFALSE;
+			vCoAPAddUintOption( &xBuilder, coapOPTION_BLOCK1, ulCoAPEncodeBlock( &xBlock ) );
+
+			if( uxOffset == 0U )
+			{
+				/* Tell the server the total size in advance. */
+				vCoAPAddUintOption( &xBuilder, coapOPTION_SIZE1, ( uint32_t ) uxLength );
+			}
+		}
+
+		pucSpace = pucCoAPPayloadSpace( &xBuilder, &uxSpace );
+
+		if( ( uxChunk != 0U ) && ( ( pucSpace == NULL ) || ( uxSpace < uxChunk ) ) )
+		{
+			return coapERROR_NO_MEMORY;
+		}
+
+		if( uxChunk != 0U )
+		{
+			( void ) memcpy( pucSpace, &( pucPayload[ uxOffset ] ), uxChunk );
+		}
+
+		xResult = prvExchange( pxClient, uxCoAPBuilderFinish( &xBuilder, uxChunk ), xConfirmable, usMessageID );
+
+		if( xResult != pdPASS )
+		{
+			return xResult;
+		}
+
+		uxOffset += uxChunk;
+
+		if( ( pxClient->xReply.ucCode != coapCODE_CONTINUE ) || ( uxOffset >= uxLength ) )
+		{
+			break;
+		}
+
+		/* The server may ask for smaller blocks. */
+		if( ( xCoAPGetBlock( &( pxClient->xReply ), coapOPTION_BLOCK1, &xBlock ) != pdFALSE ) && ( xBlock.ucSZX < ucSZX ) )
+		{
+			ucSZX = xBlock.ucSZX;
+		}
+	}
+
+	/* Pass the response to the application, fetching the other blocks if needed. */
+	ulReceived = 0U;
+
+	for( ; ; )
+	{
+	BaseType_t xMore = pdFALSE;
+
+		if( xCoAPGetBlock( &( pxClient->xReply ), coapOPTION_BLOCK2, &xBlock ) != pdFALSE )
+		{
+			ulReceived = xBlock.ulNumber * ( uint32_t ) coapBLOCK_SIZE( xBlock.ucSZX );
+			xMore = xBlock.xMore;
+		}
+
+		if( fOnData != NULL )
+		{
+			fOnData( pvContext, pxClient->xReply.ucCode, ulReceived, pxClient->xReply.pucPayload, pxClient->xReply.uxPayloadLength );
+		}
+
+		if( ( xMore == pdFALSE ) || ( coapCODE_CLASS( pxClient->xReply.ucCode ) != 2U ) )
+		{
+			break;
+		}
+
+		/* The next blocks of a response are always fetched with GET. */
+		xBlock.ulNumber++;
+		xBlock.xMore = pdFALSE;
+		usMessageID = ( uint16_t ) prvStartRequest( pxClient, &xBuilder, coapCODE_GET, xConfirmable );
+		vCoAPAddPath( &xBuilder, pcPath );
+		vCoAPAddUintOption( &xBuilder, coapOPTION_BLOCK2, ulCoAPEncodeBlock( &xBlock ) );
+
+		xResult = prvExchange( pxClient, uxCoAPBuilderFinish( &xBuilder, 0U ), xConfirmable, usMessageID );
+
+		if( xResult != pdPASS )
+		{
+			return xResult;
+		}
+	}
+
+	return ( BaseType_t ) pxClient->xReply.ucCode;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t FreeRTOS_CoAPClientObserve( CoAPClient_t * pxClient,
+									   const char * pcPath,
+									   FCoAPClientData fOnData,
+									   void * pvContext )
+{
+CoAPBuilder_t xBuilder;
+const CoAPOption_t * pxObserve;
+BaseType_t xResult;
+uint16_t usMessageID;
+
+	pxClient->xObserving = pdFALSE;
+
+	usMessageID = ( uint16_t ) prvStartRequest( pxClient, &xBuilder, coapCODE_GET, pdTRUE );
+	vCoAPAddUintOption( &xBuilder, coapOPTION_OBSERVE, 0U );
+	vCoAPAddPath( &xBuilder, pcPath );
+
+	xResult = prvExchange( pxClient, uxCoAPBuilderFinish( &xBuilder, 0U ), pdTRUE, usMessageID );
+
+	if( xResult == pdPASS )
+	{
+		pxObserve = pxCoAPFindOption( &( pxClient->xReply ), coapOPTION_OBSERVE );
+
+		if( pxObserve != NULL )
+		{
+			/* The server accepted the registration. */
+			( void ) memcpy( pxClient->ucObserveToken, pxClient->ucToken, sizeof( pxClient->ucObserveToken ) );
+			pxClient->ulLastSequence = ulCoAPOptionUint( pxObserve );
+			pxClient->fObserveData = fOnData;
+			pxClient->pvObserveContext = pvContext;
+			pxClient->xObserving = pdTRUE;
+		}
+
+		if( fOnData != NULL )
+		{
+			fOnData( pvContext, pxClient->xReply.ucCode, 0U, pxClient->xReply.pucPayload, pxClient->xReply.uxPayloadLength );
+		}
+
+		xResult = ( BaseType_t ) pxClient->xReply.ucCode;
+	}
+
+	return xResult;
+}
+/*-----------------------------------------------------------*/
+
+void FreeRTOS_CoAPClientWork( CoAPClient_t * pxClient,
+							  TickType_t xBlockingTime )
+{
+struct freertos_sockaddr xSource;
+socklen_t xSourceLength = sizeof( xSource );
+BaseType_t xFlags = 0;
+int32_t lBytes;
+
+	( void ) FreeRTOS_setsockopt( pxClient->xSocket, 0, FREERTOS_SO_RCVTIMEO, &xBlockingTime, sizeof( xBlockingTime ) );
+
+	for( ; ; )
+	{
+		lBytes = FreeRTOS_recvfrom( pxClient->xSocket, pxClient->ucRxBuffer, sizeof( pxClient->ucRxBuffer ), xFlags, &xSource, &xSourceLength );
+
+		if( lBytes <= 0 )
+		{
+			break;
+		}
+
+		xFlags = FREERTOS_MSG_DONTWAIT;
+
+		if( ( xCoAPSameEndpoint( &xSource, &( pxClient->xServer ) ) != pdFALSE ) &&
+			( xCoAPParse( pxClient->ucRxBuffer, ( size_t ) lBytes, &( pxClient->xReply ) ) == pdPASS ) &&
+			( prvHandleNotification( pxClient ) == pdFALSE ) &&
+			( pxClient->xReply.ucType == coapTYPE_CON ) )
+		{
+			/* Reject what is not a notification, so the server stops sending it. */
+			prvSendEmpty( pxClient, coapTYPE_RST, pxClient->xReply.usMessageID );
+		}
+	}
+}
+/*-----------------------------------------------------------*/
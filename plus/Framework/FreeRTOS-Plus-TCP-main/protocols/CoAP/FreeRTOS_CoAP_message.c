@@ -0,0 +1,525 @@
+/*
+ * FreeRTOS+TCP V2.3.2
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/*
+ * Encoding and decoding of CoAP messages ( RFC 7252, section 3 ).
+ * These functions are shared by the CoAP server and the client.
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_Sockets.h"
+
+/* FreeRTOS Protocol includes. */
+#include "FreeRTOS_CoAP.h"
+
+#define coapVERSION					1U
+#define coapHEADER_LENGTH			4U
+#define coapPAYLOAD_MARKER			0xFFU
+
+/* Option deltas and lengths from 13 onwards are extended. */
+#define coapEXTENDED_8_BIT			13U
+#define coapEXTENDED_16_BIT			14U
+#define coapEXTENDED_RESERVED		15U
+#define coapEXTENDED_16_OFFSET		269U
+
+static BaseType_t prvReadExtended( const uint8_t * pucBuffer,
+								   size_t uxLength,
+								   size_t * puxIndex,
+								   uint32_t * pulValue );
+static size_t uxWriteNibbleExtension( uint8_t * pucBuffer,
+									  uint32_t ulValue,
+									  uint8_t * pucNibble );
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvReadExtended( const uint8_t * pucBuffer,
+								   size_t uxLength,
+								   size_t * puxIndex,
+								   uint32_t * pulValue )
+{
+BaseType_t xResult = pdPASS;
+size_t uxIndex = *puxIndex;
+
+	if( *pulValue == coapEXTENDED_8_BIT )
+	{
+		if( uxIndex + 1U > uxLength )
+		{
+			xResult = pdFAIL;
+		}
+		else
+		{
+			*pulValue = ( uint32_t ) pucBuffer[ uxIndex ] + coapEXTENDED_8_BIT;
+			uxIndex++;
+		}
+	}
+	else if( *pulValue == coapEXTENDED_16_BIT )
+	{
+		if( uxIndex + 2U > uxLength )
+		{
+			xResult = pdFAIL;
+		}
+		else
+		{
+			*pulValue = ( ( ( uint32_t ) pucBuffer[ uxIndex ] << 8 ) | pucBuffer[ uxIndex + 1U ] ) + coapEXTENDED_16_OFFSET;
+			uxIndex += 2U;
+		}
+	}
+	else if( *pulValue == coapEXTENDED_RESERVED )
+	{
+		/* Only allowed as part of the payload marker. */
+		xResult = pdFAIL;
+	}
+	else
+	{
+		/* A value that fits in the nibble. */
+	}
+
+	*puxIndex = uxIndex;
+
+	return xResult;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xCoAPParse( const uint8_t * pucBuffer,
+					   size_t uxLength,
+					   CoAPMessage_t * pxMessage )
+{
+BaseType_t xResult = pdPASS;
+size_t uxIndex;
+uint32_t ulNumber = 0U;
+
+	( void ) memset( pxMessage, 0, sizeof( *pxMessage ) );
+
+	if( ( uxLength < coapHEADER_LENGTH ) || ( ( pucBuffer[ 0 ] >> 6 ) != coapVERSION ) )
+	{
+		return pdFAIL;
+	}
+
+	pxMessage->ucType = ( uint8_t ) ( ( pucBuffer[ 0 ] >> 4 ) & 0x03U );
+	pxMessage->ucTokenLength = ( uint8_t ) ( pucBuffer[ 0 ] & 0x0FU );
+	pxMessage->ucCode = pucBuffer[ 1 ];
+	pxMessage->usMessageID = ( uint16_t ) ( ( ( uint16_t ) pucBuffer[ 2 ] << 8 ) | pucBuffer[ 3 ] );
+
+	if( ( pxMessage->ucTokenLength > sizeof( pxMessage->ucToken ) ) ||
+		( ( coapHEADER_LENGTH + pxMessage->ucTokenLength ) > uxLength ) )
+	{
+		return pdFAIL;
+	}
+
+	( void ) memcpy( pxMessage->ucToken, &( pucBuffer[ coapHEADER_LENGTH ] ), pxMessage->ucTokenLength );
+	uxIndex = coapHEADER_LENGTH + pxMessage->ucTokenLength;
+
+	if( ( pxMessage->ucCode == coapCODE_EMPTY ) && ( ( uxLength != coapHEADER_LENGTH ) || ( pxMessage->ucTokenLength != 0U ) ) )
+	{
+		/* An empty message has nothing but a header. */
+		return pdFAIL;
+	}
+
+	while( uxIndex < uxLength )
+	{
+	uint8_t ucByte = pucBuffer[ uxIndex ];
+	uint32_t ulDelta = ( uint32_t ) ucByte >> 4;
+	uint32_t ulOptionLength = ( uint32_t ) ucByte & 0x0FU;
+
+		uxIndex++;
+
+		if( ucByte == coapPAYLOAD_MARKER )
+		{
+			if( uxIndex >= uxLength )
+			{
+				/* A marker followed by a zero-length payload is a format error. */
+				xResult = pdFAIL;
+			}
+			else
+			{
+				pxMessage->pucPayload = &( pucBuffer[ uxIndex ] );
+				pxMessage->uxPayloadLength = uxLength - uxIndex;
+			}
+			break;
+		}
+
+		if( ( prvReadExtended( pucBuffer, uxLength, &uxIndex, &ulDelta ) == pdFAIL ) ||
+			( prvReadExtended( pucBuffer, uxLength, &uxIndex, &ulOptionLength ) == pdFAIL ) )
+		{
+			xResult = pdFAIL;
+			break;
+		}
+
+		ulNumber += ulDelta;
+
+		if( ( ulNumber > 0xFFFFU ) || ( ( uxIndex + ulOptionLength ) > uxLength ) )
+		{
+			xResult = pdFAIL;
+			break;
+		}
+
+		if( pxMessage->uxOptionCount >= ( size_t ) ipconfigCOAP_MAX_OPTIONS )
+		{
+			FreeRTOS_printf( ( "xCoAPParse: too many options\n" ) );
+			xResult = pdFAIL;
+			break;
+		}
+
+		pxMessage->xOptions[ pxMessage->uxOptionCount ].usNumber = ( uint16_t ) ulNumber;
+		pxMessage->xOptions[ pxMessage->uxOptionCount ].usLength = ( uint16_t ) ulOptionLength;
+		pxMessage->xOptions[ pxMessage->uxOptionCount ].pucValue = &( pucBuffer[ uxIndex ] );
+		pxMessage->uxOptionCount++;
+		uxIndex += ulOptionLength;
+	}
+
+	return xResult;
+}
+/*-----------------------------------------------------------*/
+
+void vCoAPBuilderInit( CoAPBuilder_t * pxBuilder,
+					   uint8_t * pucBuffer,
+					   size_t uxSize,
+					   uint8_t ucType,
+					   uint8_t ucCode,
+					   uint16_t usMessageID,
+					   const uint8_t * pucToken,
+					   uint8_t ucTokenLength )
+{
+	pxBuilder->pucBuffer = pucBuffer;
+	pxBuilder->uxSize = uxSize;
+	pxBuilder->uxLength = 0U;
+	pxBuilder->usLastOption = 0U;
+	pxBuilder->xError = pdFALSE;
+
+	if( ( ucTokenLength > 8U ) || ( uxSize < ( coapHEADER_LENGTH + ucTokenLength ) ) )
+	{
+		pxBuilder->xError = pdTRUE;
+	}
+	else
+	{
+		pucBuffer[ 0 ] = ( uint8_t ) ( ( coapVERSION << 6 ) | ( ( ucType & 0x03U ) << 4 ) | ucTokenLength );
+		pucBuffer[ 1 ] = ucCode;
+		pucBuffer[ 2 ] = ( uint8_t ) ( usMessageID >> 8 );
+		pucBuffer[ 3 ] = ( uint8_t ) ( usMessageID & 0xFFU );
+
+		if( ucTokenLength != 0U )
+		{
+			( void ) memcpy( &( pucBuffer[ coapHEADER_LENGTH ] ), pucToken, ucTokenLength );
+		}
+
+		pxBuilder->uxLength = coapHEADER_LENGTH + ucTokenLength;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static size_t uxWriteNibbleExtension( uint8_t * pucBuffer,
+									  uint32_t ulValue,
+									  uint8_t * pucNibble )
+{
+size_t uxCount;
+
+	if( ulValue < coapEXTENDED_8_BIT )
+	{
+		*pucNibble = ( uint8_t ) ulValue;
+		uxCount = 0U;
+	}
+	else if( ulValue < coapEXTENDED_16_OFFSET )
+	{
+		*pucNibble = ( uint8_t ) coapEXTENDED_8_BIT;
+		pucBuffer[ 0 ] = ( uint8_t ) ( ulValue - coapEXTENDED_8_BIT );
+		uxCount = 1U;
+	}
+	else
+	{
+		ulValue -= coapEXTENDED_16_OFFSET;
+		*pucNibble = ( uint8_t ) coapEXTENDED_16_BIT;
+		pucBuffer[ 0 ] = ( uint8_t ) ( ulValue >> 8 );
+		pucBuffer[ 1 ] = ( uint8_t ) ( ulValue & 0xFFU );
+		uxCount = 2U;
+	}
+
+	return uxCount;
+}
+/*-----------------------------------------------------------*/
+
+void vCoAPAddOption( CoAPBuilder_t * pxBuilder,
+					 uint16_t usNumber,
+					 const void * pvValue,
+					 size_t uxLength )
+{
+uint8_t ucExtension[ 4 ];
+uint8_t ucDeltaNibble, ucLengthNibble;
+size_t uxCount;
+
+	if( ( pxBuilder->xError != pdFALSE ) || ( usNumber < pxBuilder->usLastOption ) || ( uxLength > 0xFFFFU ) )
+	{
+		pxBuilder->xError = pdTRUE;
+		return;
+	}
+
+	uxCount = uxWriteNibbleExtension( ucExtension, ( uint32_t ) usNumber - pxBuilder->usLastOption, &ucDeltaNibble );
+	uxCount += uxWriteNibbleExtension( &( ucExtension[ uxCount ] ), ( uint32_t ) uxLength, &ucLengthNibble );
+
+	if( ( pxBuilder->uxLength + 1U + uxCount + uxLength ) > pxBuilder->uxSize )
+	{
+		pxBuilder->xError = pdTRUE;
+		return;
+	}
+
+	pxBuilder->pucBuffer[ pxBuilder->uxLength ] = ( uint8_t ) ( ( ucDeltaNibble << 4 ) | ucLengthNibble );
+	pxBuilder->uxLength++;
+	( void ) memcpy( &( pxBuilder->pucBuffer[ pxBuilder->uxLength ] ), ucExtension, uxCount );
+	pxBuilder->uxLength += uxCount;
+
+	if( uxLength != 0U )
+	{
+		( void ) memcpy( &( pxBuilder->pucBuffer[ pxBuilder->uxLength ] ), pvValue, uxLength );
+		pxBuilder->uxLength += uxLength;
+	}
+
+	pxBuilder->usLastOption = usNumber;
+}
+/*-----------------------------------------------------------*/
+
+void vCoAPAddUintOption( CoAPBuilder_t * pxBuilder,
+						 uint16_t usNumber,
+						 uint32_t ulValue )
+{
+uint8_t ucValue[ 4 ];
+size_t uxLength = 0U;
+BaseType_t xShift;
+
+	/* Unsigned integers are sent big-endian without leading zero bytes. */
+	for( xShift = 24; xShift >= 0; xShift -= 8 )
+	{
+	uint8_t ucByte = ( uint8_t ) ( ( ulValue >> xShift ) & 0xFFU );
+
+		if( ( uxLength != 0U ) || ( ucByte != 0U ) )
+		{
+			ucValue[ uxLength ] = ucByte;
+			uxLength++;
+		}
+	}
+
+	vCoAPAddOption( pxBuilder, usNumber, ucValue, uxLength );
+}
+/*-----------------------------------------------------------*/
+
+void vCoAPAddPath( CoAPBuilder_t * pxBuilder,
+				   const char * pcPath )
+{
+const char * pcSegment = pcPath;
+
+	while( *pcSegment != '\0' )
+	{
+	const char * pcEnd = strchr( pcSegment, '/' );
+	size_t uxLength;
+
+		if( pcEnd == NULL )
+		{
+			uxLength = strlen( pcSegment );
+		}
+		else
+		{
+			uxLength = ( size_t ) ( pcEnd - pcSegment );
+		}
+
+		if( uxLength != 0U )
+		{
+			vCoAPAddOption( pxBuilder, coapOPTION_URI_PATH, pcSegment, uxLength );
+		}
+
+		pcSegment += uxLength;
+
+		if( *pcSegment == '/' )
+		{
+			pcSegment++;
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+uint8_t * pucCoAPPayloadSpace( CoAPBuilder_t * pxBuilder,
+							   size_t * puxSpace )
+{
+uint8_t * pucResult = NULL;
+
+	*puxSpace = 0U;
+
+	if( ( pxBuilder->xError == pdFALSE ) && ( ( pxBuilder->uxLength + 1U ) < pxBuilder->uxSize ) )
+	{
+		/* The marker is only counted when a payload is actually written. */
+		pxBuilder->pucBuffer[ pxBuilder->uxLength ] = coapPAYLOAD_MARKER;
+		pucResult = &( pxBuilder->pucBuffer[ pxBuilder->uxLength + 1U ] );
+		*puxSpace = pxBuilder->uxSize - pxBuilder->uxLength - 1U;
+	}
+
+	return pucResult;
+}
+/*-----------------------------------------------------------*/
+
+size_t uxCoAPBuilderFinish( CoAPBuilder_t * pxBuilder,
+							size_t uxPayloadLength )
+{
+size_t uxResult = 0U;
+
+	if( uxPayloadLength != 0U )
+	{
+		if( ( pxBuilder->uxLength + 1U + uxPayloadLength ) > pxBuilder->uxSize )
+		{
+			pxBuilder->xError = pdTRUE;
+		}
+		else
+		{
+			pxBuilder->uxLength += 1U + uxPayloadLength;
+		}
+	}
+
+	if( pxBuilder->xError == pdFALSE )
+	{
+		uxResult = pxBuilder->uxLength;
+	}
+
+	return uxResult;
+}
+/*-----------------------------------------------------------*/
+
+const CoAPOption_t * pxCoAPFindOption( const CoAPMessage_t * pxMessage,
+									   uint16_t usNumber )
+{
+const CoAPOption_t * pxResult = NULL;
+size_t uxIndex;
+
+	for( uxIndex = 0U; uxIndex < pxMessage->uxOptionCount; uxIndex++ )
+	{
+		if( pxMessage->xOptions[ uxIndex ].usNumber == usNumber )
+		{
+			pxResult = &( pxMessage->xOptions[ uxIndex ] );
+			break;
+		}
+	}
+
+	return pxResult;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulCoAPOptionUint( const CoAPOption_t * pxOption )
+{
+uint32_t ulValue = 0U;
+size_t uxIndex;
+
+	if( pxOption != NULL )
+	{
+		for( uxIndex = 0U; ( uxIndex < pxOption->usLength ) && ( uxIndex < 4U ); uxIndex++ )
+		{
+			ulValue = ( ulValue << 8 ) | pxOption->pucValue[ uxIndex ];
+		}
+	}
+
+	return ulValue;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xCoAPGetBlock( const CoAPMessage_t * pxMessage,
+						  uint16_t usNumber,
+						  CoAPBlock_t * pxBlock )
+{
+const CoAPOption_t * pxOption = pxCoAPFindOption( pxMessage, usNumber );
+BaseType_t xResult = pdFALSE;
+
+	if( ( pxOption != NULL ) && ( pxOption->usLength <= 3U ) )
+	{
+	uint32_t ulValue = ulCoAPOptionUint( pxOption );
+
+		pxBlock->ulNumber = ulValue >> 4;
+		pxBlock->xMore = ( ( ulValue & 0x08U ) != 0U ) ? pdTRUE : pdFALSE;
+		pxBlock->ucSZX = ( uint8_t ) ( ulValue & 0x07U );
+
+		/* SZX 7 is reserved. */
+		if( pxBlock->ucSZX != 7U )
+		{
+			xResult = pdTRUE;
+		}
+	}
+
+	return xResult;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulCoAPEncodeBlock( const CoAPBlock_t * pxBlock )
+{
+uint32_t ulValue = ( pxBlock->ulNumber << 4 ) | pxBlock->ucSZX;
+
+	if( pxBlock->xMore != pdFALSE )
+	{
+		ulValue |= 0x08U;
+	}
+
+	return ulValue;
+}
+/*-----------------------------------------------------------*/
+
+uint8_t ucCoAPSizeToSZX( size_t uxSize )
+{
+uint8_t ucSZX = 6U;
+
+	while( ( ucSZX > 0U ) && ( coapBLOCK_SIZE( ucSZX ) > uxSize ) )
+	{
+		ucSZX--;
+	}
+
+	return ucSZX;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xCoAPSameEndpoint( const struct freertos_sockaddr * pxLeft,
+							  const struct freertos_sockaddr * pxRight )
+{
+BaseType_t xResult = pdFALSE;
+
+	if( ( pxLeft->sin_family == pxRight->sin_family ) && ( pxLeft->sin_port == pxRight->sin_port ) )
+	{
+		if( pxLeft->sin_family == ( uint8_t ) FREERTOS_AF_INET6 )
+		{
+			if( memcmp( &( pxLeft->sin_address ), &( pxRight->sin_address ), sizeof( pxLeft->sin_address ) ) == 0 )
+			{
+				xResult = pdTRUE;
+			}
+		}
+		else if( pxLeft->sin_address.ulIP_IPv4 == pxRight->sin_address.ulIP_IPv4 )
+		{
+			xResult = pdTRUE;
+		}
+		else
+		{
+			/* A different IPv4 address. */
+		}
+	}
+
+	return xResult;
+}
+/*-----------------------------------------------------------*/
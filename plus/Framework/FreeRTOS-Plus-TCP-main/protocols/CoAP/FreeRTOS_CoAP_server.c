@@ -0,0 +1,942 @@
+/*
+ * FreeRTOS+TCP V2.3.2
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/*
+ * A CoAP server ( RFC 7252 ) running on a single UDP socket.
+ *
+ * Resources are kept in a hash table indexed by the FNV-1a hash of their path.
+ * Responses to recent requests are remembered, so that a retransmitted
+ * request is answered with the same response without calling the handler
+ * again.  Large representations are sent block-wise ( RFC 7959 ), and
+ * observable resources keep a list of observers ( RFC 7641 ).
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_Sockets.h"
+
+/* FreeRTOS Protocol includes. */
+#include "FreeRTOS_CoAP.h"
+
+#if ( ipconfigCOAP_USE_PLUS_FAT != 0 )
+	/* FreeRTOS+FAT includes. */
+	#include "ff_stdio.h"
+#endif
+
+#if !defined( ARRAY_SIZE )
+	#define ARRAY_SIZE( x )    ( BaseType_t ) ( sizeof( x ) / sizeof( x )[ 0 ] )
+#endif
+
+/* The handler writes its payload at this offset in the transmission buffer.
+ * The header, token and options are placed just in front of it. */
+#define coapRESPONSE_HEADROOM		64U
+
+#if ( ( ipconfigCOAP_BLOCK_SIZE + coapRESPONSE_HEADROOM ) > ipconfigCOAP_MAX_MESSAGE_SIZE )
+	#error ipconfigCOAP_BLOCK_SIZE is too large for ipconfigCOAP_MAX_MESSAGE_SIZE
+#endif
+
+#if ( ( ipconfigCOAP_RESOURCE_HASH_SIZE & ( ipconfigCOAP_RESOURCE_HASH_SIZE - 1 ) ) != 0 )
+	#error ipconfigCOAP_RESOURCE_HASH_SIZE must be a power of 2
+#endif
+
+#define coapFNV_OFFSET_BASIS		0x811C9DC5U
+#define coapFNV_PRIME				0x01000193U
+
+/* Observe sequence numbers are 24 bits. */
+#define coapOBSERVE_MASK			0x00FFFFFFU
+#define coapOBSERVE_REGISTER		0U
+#define coapOBSERVE_DEREGISTER		1U
+
+/* A response that was sent recently. */
+typedef struct xCOAP_DEDUP
+{
+	struct freertos_sockaddr xPeer;
+	uint16_t usMessageID;
+	TickType_t xTime;
+	uint8_t * pucResponse;	/* NULL when the entry is free. */
+	size_t uxResponseLength;
+} CoAPDedup_t;
+
+typedef struct xCOAP_OBSERVER
+{
+	CoAPResource_t * pxResource;	/* NULL when the entry is free. */
+	struct freertos_sockaddr xPeer;
+	uint8_t ucToken[ 8 ];
+	uint8_t ucTokenLength;
+	uint16_t usLastMessageID;	/* The ID of the last notification. */
+	BaseType_t xAwaitingAck;	/* A confirmable notification was not acknowledged yet. */
+	uint32_t ulCount;
+} CoAPObserver_t;
+
+struct xCOAP_SERVER
+{
+	Socket_t xSocket;
+	CoAPResource_t * pxBuckets[ ipconfigCOAP_RESOURCE_HASH_SIZE ];
+	CoAPDedup_t xDedup[ ipconfigCOAP_DEDUP_ENTRIES ];
+	CoAPObserver_t xObservers[ ipconfigCOAP_MAX_OBSERVERS ];
+	uint16_t usMessageID;
+	uint32_t ulObserveSequence;
+	CoAPMessage_t xMessage;
+	uint8_t ucRxBuffer[ ipconfigCOAP_MAX_MESSAGE_SIZE ];
+	uint8_t ucTxBuffer[ ipconfigCOAP_MAX_MESSAGE_SIZE ];
+};
+
+static uint32_t prvHashAdd( uint32_t ulHash,
+							const uint8_t * pucData,
+							size_t uxLength );
+static CoAPResource_t * prvFindResource( CoAPServer_t * pxServer,
+										 const CoAPMessage_t * pxMessage );
+static void prvSendMessage( CoAPServer_t * pxServer,
+							const struct freertos_sockaddr * pxPeer,
+							const uint8_t * pucMessage,
+							size_t uxLength );
+static void prvSendEmpty( CoAPServer_t * pxServer,
+						  const struct freertos_sockaddr * pxPeer,
+						  uint8_t ucType,
+						  uint16_t usMessageID );
+static BaseType_t prvCheckDuplicate( CoAPServer_t * pxServer,
+									 const struct freertos_sockaddr * pxPeer,
+									 uint16_t usMessageID );
+static void prvRememberResponse( CoAPServer_t * pxServer,
+								 const struct freertos_sockaddr * pxPeer,
+								 uint16_t usMessageID,
+								 const uint8_t * pucResponse,
+								 size_t uxLength );
+static CoAPObserver_t * prvFindObserver( CoAPServer_t * pxServer,
+										 const CoAPResource_t * pxResource,
+										 const struct freertos_sockaddr * pxPeer,
+										 const uint8_t * pucToken,
+										 uint8_t ucTokenLength );
+static void prvHandleEmpty( CoAPServer_t * pxServer,
+							const struct freertos_sockaddr * pxPeer,
+							const CoAPMessage_t * pxMessage );
+static void prvHandleRequest( CoAPServer_t * pxServer,
+							  const struct freertos_sockaddr * pxPeer,
+							  const CoAPMessage_t * pxMessage );
+/*-----------------------------------------------------------*/
+
+CoAPServer_t * FreeRTOS_CreateCoAPServer( uint16_t usPort )
+{
+CoAPServer_t * pxServer;
+struct freertos_sockaddr xAddress;
+uint32_t ulRandom = 0U;
+
+	pxServer = ( CoAPServer_t * ) pvPortMallocLarge( sizeof( *pxServer ) );
+
+	if( pxServer == NULL )
+	{
+		FreeRTOS_printf( ( "FreeRTOS_CreateCoAPServer: malloc failed\n" ) );
+		return NULL;
+	}
+
+	( void ) memset( pxServer, 0, sizeof( *pxServer ) );
+
+	pxServer->xSocket = FreeRTOS_socket( FREERTOS_AF_INET, FREERTOS_SOCK_DGRAM, FREERTOS_IPPROTO_UDP );
+
+	if( xSocketValid( pxServer->xSocket ) == pdFALSE )
+	{
+		FreeRTOS_printf( ( "FreeRTOS_CreateCoAPServer: socket failed\n" ) );
+		vPortFree( pxServer );
+		return NULL;
+	}
+
+	( void ) memset( &xAddress, 0, sizeof( xAddress ) );
+	xAddress.sin_family = FREERTOS_AF_INET;
+	xAddress.sin_port = FreeRTOS_htons( usPort );
+
+	if( FreeRTOS_bind( pxServer->xSocket, &xAddress, sizeof( xAddress ) ) != 0 )
+	{
+		FreeRTOS_printf( ( "FreeRTOS_CreateCoAPServer: bind port %u failed\n", usPort ) );
+		( void ) FreeRTOS_closesocket( pxServer->xSocket );
+		vPortFree( pxServer );
+		return NULL;
+	}
+
+	/* Start with an unpredictable message ID, as recommended by RFC 7252. */
+	( void ) xApplicationGetRandomNumber( &ulRandom );
+	pxServer->usMessageID = ( uint16_t ) ulRandom;
+
+	FreeRTOS_printf( ( "CoAP server listening on port %u\n", usPort ) );
+
+	return pxServer;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvHashAdd( uint32_t ulHash,
+							const uint8_t * pucData,
+							size_t uxLength )
+{
+size_t uxIndex;
+
+	for( uxIndex = 0U; uxIndex < uxLength; uxIndex++ )
+	{
+		ulHash ^= pucData[ uxIndex ];
+		ulHash *= coapFNV_PRIME;
+	}
+
+	return ulHash;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t FreeRTOS_CoAPAddResource( CoAPServer_t * pxServer,
+									 CoAPResource_t * pxResource )
+{
+const char * pcPath = pxResource->pcPath;
+size_t uxBucket;
+
+	while( *pcPath == '/' )
+	{
+		pcPath++;
+	}
+
+	pxResource->pcPath = pcPath;
+	pxResource->ulHash = prvHashAdd( coapFNV_OFFSET_BASIS, ( const uint8_t * ) pcPath, strlen( pcPath ) );
+
+	uxBucket = pxResource->ulHash & ( ipconfigCOAP_RESOURCE_HASH_SIZE - 1U );
+	pxResource->pxNextInBucket = pxServer->pxBuckets[ uxBucket ];
+	pxServer->pxBuckets[ uxBucket ] = pxResource;
+
+	return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+static CoAPResource_t * prvFindResource( CoAPServer_t * pxServer,
+										 const CoAPMessage_t * pxMessage )
+{
+uint32_t ulHash = coapFNV_OFFSET_BASIS;
+const uint8_t ucSlash = ( uint8_t ) '/';
+BaseType_t xFirst = pdTRUE;
+CoAPResource_t * pxResource;
+size_t uxIndex;
+
+	/* The path is hashed as if the Uri-Path options were joined with slashes. */
+	for( uxIndex = 0U; uxIndex < pxMessage->uxOptionCount; uxIndex++ )
+	{
+		if( pxMessage->xOptions[ uxIndex ].usNumber == coapOPTION_URI_PATH )
+		{
+			if( xFirst == pdFALSE )
+			{
+				ulHash = prvHashAdd( ulHash, &ucSlash, 1U );
+			}
+
+			ulHash = prvHashAdd( ulHash, pxMessage->xOptions[ uxIndex ].pucValue, pxMessage->xOptions[ uxIndex ].usLength );
+			xFirst = pdFALSE;
+		}
+	}
+
+	for( pxResource = pxServer->pxBuckets[ ulHash & ( ipconfigCOAP_RESOURCE_HASH_SIZE - 1U ) ];
+		 pxResource != NULL;
+		 pxResource = pxResource->pxNextInBucket )
+	{
+		if( pxResource->ulHash == ulHash )
+		{
+		const char * pcPath = pxResource->pcPath;
+		BaseType_t xMatch = pdTRUE;
+
+			/* Confirm the match segment by segment. */
+			xFirst = pdTRUE;
+
+			for( uxIndex = 0U; ( uxIndex < pxMessage->uxOptionCount ) && ( xMatch != pdFALSE ); uxIndex++ )
+			{
+			const CoAPOption_t * pxOption = &( pxMessage->xOptions[ uxIndex ] );
+
+				if( pxOption->usNumber != coapOPTION_URI_PATH )
+				{
+					continue;
+				}
+
+				if( xFirst == pdFALSE )
+				{
+					if( *pcPath != '/' )
+					{
+						xMatch = pdFALSE;
+						break;
+					}
+
+					pcPath++;
+				}
+
+				if( ( strncmp( pcPath, ( const char * ) pxOption->pucValue, pxOption->usLength ) != 0 ) ||
+					( strlen( pcPath ) < pxOption->usLength ) )
+				{
+					xMatch = pdFALSE;
+				}
+				else
+				{
+					pcPath += pxOption->usLength;
+				}
+
+				xFirst = pdFALSE;
+			}
+
+			if( ( xMatch != pdFALSE ) && ( *pcPath == '\0' ) )
+			{
+				break;
+			}
+		}
+	}
+
+	return pxResource;
+}
+/*-----------------------------------------------------------*/
+
+static void prvSendMessage( CoAPServer_t * pxServer,
+							const struct freertos_sockaddr * pxPeer,
+							const uint8_t * pucMessage,
+							size_t uxLength )
+{
+	if( uxLength != 0U )
+	{
+		( void ) FreeRTOS_sendto( pxServer->xSocket, pucMessage, uxLength, 0, pxPeer, sizeof( *pxPeer ) );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvSendEmpty( CoAPServer_t * pxServer,
+						  const struct freertos_sockaddr * pxPeer,
+						  uint8_t ucType,
+						  uint16_t usMessageID )
+{
+CoAPBuilder_t xBuilder;
+uint8_t ucBuffer[ 4 ];
+
+	vCoAPBuilderInit( &xBuilder, ucBuffer, sizeof( ucBuffer ), ucType, coapCODE_EMPTY, usMessageID, NULL, 0U );
+	prvSendMessage( pxServer, pxPeer, ucBuffer, uxCoAPBuilderFinish( &xBuilder, 0U ) );
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvCheckDuplicate( CoAPServer_t * pxServer,
+									 const struct freertos_sockaddr * pxPeer,
+									 uint16_t usMessageID )
+{
+TickType_t xNow = xTaskGetTickCount();
+BaseType_t xResult = pdFALSE;
+size_t uxIndex;
+
+	for( uxIndex = 0U; uxIndex < ( size_t ) ARRAY_SIZE( pxServer->xDedup ); uxIndex++ )
+	{
+	CoAPDedup_t * pxEntry = &( pxServer->xDedup[ uxIndex ] );
+
+		if( pxEntry->pucResponse == NULL )
+		{
+			continue;
+		}
+
+		if( ( xNow - pxEntry->xTime ) > pdMS_TO_TICKS( ipconfigCOAP_EXCHANGE_LIFETIME_MS ) )
+		{
+			vPortFree( pxEntry->pucResponse );
+			pxEntry->pucResponse = NULL;
+		}
+		else if( ( pxEntry->usMessageID == usMessageID ) && ( xCoAPSameEndpoint( &( pxEntry->xPeer ), pxPeer ) != pdFALSE ) )
+		{
+			/* A retransmission: send the same response again. */
+			prvSendMessage( pxServer, pxPeer, pxEntry->pucResponse, pxEntry->uxResponseLength );
+			xResult = pdTRUE;
+		}
+		else
+		{
+			/* A different exchange. */
+		}
+	}
+
+	return xResult;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRememberResponse( CoAPServer_t * pxServer,
+								 const struct freertos_sockaddr * pxPeer,
+								 uint16_t usMessageID,
+								 const uint8_t * pucResponse,
+								 size_t uxLength )
+{
+CoAPDedup_t * pxEntry = &( pxServer->xDedup[ 0 ] );
+size_t uxIndex;
+
+	/* Use a free entry, or else the oldest one. */
+	for( uxIndex = 0U; uxIndex < ( size_t ) ARRAY_SIZE( pxServer->xDedup ); uxIndex++ )
+	{
+		if( pxServer->xDedup[ uxIndex ].pucResponse == NULL )
+		{
+			pxEntry = &( pxServer->xDedup[ uxIndex ] );
+			break;
+		}
+
+		if( ( TickType_t ) ( pxServer->xDedup[ uxIndex ].xTime - pxEntry->xTime ) > ( portMAX_DELAY / 2U ) )
+		{
+			pxEntry = &( pxServer->xDedup[ uxIndex ] );
+		}
+	}
+
+	if( pxEntry->pucResponse != NULL )
+	{
+		vPortFree( pxEntry->pucResponse );
+	}
+
+	pxEntry->pucResponse = ( uint8_t * ) pvPortMalloc( uxLength );
+
+	if( pxEntry->pucResponse != NULL )
+	{
+		( void ) memcpy( pxEntry->pucResponse, pucResponse, uxLength );
+		( void ) memcpy( &( pxEntry->xPeer ), pxPeer, sizeof( pxEntry->xPeer ) );
+		pxEntry->uxResponseLength = uxLength;
+		pxEntry->usMessageID = usMessageID;
+		pxEntry->xTime = xTaskGetTickCount();
+	}
+}
+/*-----------------------------------------------------------*/
+
+static CoAPObserver_t * prvFindObserver( CoAPServer_t * pxServer,
+										 const CoAPResource_t * pxResource,
+										 const struct freertos_sockaddr * pxPeer,
+										 const uint8_t * pucToken,
+										 uint8_t ucTokenLength )
+{
+CoAPObserver_t * pxResult = NULL;
+size_t uxIndex;
+
+	for( uxIndex = 0U; uxIndex < ( size_t ) ARRAY_SIZE( pxServer->xObservers ); uxIndex++ )
+	{
+	CoAPObserver_t * pxObserver = &( pxServer->xObservers[ uxIndex ] );
+
+		if( pxObserver->pxResource == pxResource )
+		{
+			if( pxResource == NULL )
+			{
+				/* Looking for a free entry. */
+				pxResult = pxObserver;
+				break;
+			}
+
+			/* An observer is identified by its endpoint and token. */
+			if( ( pxObserver->ucTokenLength == ucTokenLength ) &&
+				( memcmp( pxObserver->ucToken, pucToken, ucTokenLength ) == 0 ) &&
+				( xCoAPSameEndpoint( &( pxObserver->xPeer ), pxPeer ) != pdFALSE ) )
+			{
+				pxResult = pxObserver;
+				break;
+			}
+		}
+	}
+
+	return pxResult;
+}
+/*-----------------------------------------------------------*/
+
+static void prvHandleEmpty( CoAPServer_t * pxServer,
+							const struct freertos_sockaddr * pxPeer,
+							const CoAPMessage_t * pxMessage )
+{
+size_t uxIndex;
+
+	if( pxMessage->ucType == coapTYPE_CON )
+	{
+		/* A "CoAP ping". */
+		prvSendEmpty( pxServer, pxPeer, coapTYPE_RST, pxMessage->usMessageID );
+		return;
+	}
+
+	/* An ACK or RST to a notification. */
+	for( uxIndex = 0U; uxIndex < ( size_t ) ARRAY_SIZE( pxServer->xObservers ); uxIndex++ )
+	{
+	CoAPObserver_t * pxObserver = &( pxServer->xObservers[ uxIndex ] );
+
+		if( ( pxObserver->pxResource != NULL ) &&
+			( pxObserver->usLastMessageID == pxMessage->usMessageID ) &&
+			( xCoAPSameEndpoint( &( pxObserver->xPeer ), pxPeer ) != pdFALSE ) )
+		{
+			if( pxMessage->ucType == coapTYPE_RST )
+			{
+				/* The client is no longer interested. */
+				pxObserver->pxResource = NULL;
+			}
+			else
+			{
+				pxObserver->xAwaitingAck = pdFALSE;
+			}
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvHandleRequest( CoAPServer_t * pxServer,
+							  const struct freertos_sockaddr * pxPeer,
+							  const CoAPMessage_t * pxMessage )
+{
+CoAPResource_t * pxResource;
+CoAPRequest_t xRequest;
+CoAPResponse_t xResponse;
+CoAPBuilder_t xBuilder;
+CoAPBlock_t xBlock1, xBlock2;
+BaseType_t xHasBlock1, xHasBlock2;
+const CoAPOption_t * pxObserveOption = NULL;
+uint8_t ucHeader[ coapRESPONSE_HEADROOM ];
+uint8_t * pucPayload = &( pxServer->ucTxBuffer[ coapRESPONSE_HEADROOM ] );
+uint8_t * pucMessage;
+uint8_t ucType;
+uint16_t usMessageID;
+size_t uxHeaderLength, uxLength;
+
+	if( prvCheckDuplicate( pxServer, pxPeer, pxMessage->usMessageID ) != pdFALSE )
+	{
+		return;
+	}
+
+	/* A confirmable request gets a piggybacked response in the ACK. */
+	if( pxMessage->ucType == coapTYPE_CON )
+	{
+		ucType = coapTYPE_ACK;
+		usMessageID = pxMessage->usMessageID;
+	}
+	else
+	{
+		ucType = coapTYPE_NON;
+		usMessageID = pxServer->usMessageID++;
+	}
+
+	( void ) memset( &xRequest, 0, sizeof( xRequest ) );
+	xRequest.pxMessage = pxMessage;
+	xRequest.pxPeer = pxPeer;
+	xRequest.ucMethod = pxMessage->ucCode;
+	xRequest.pucPayload = pxMessage->pucPayload;
+	xRequest.uxPayloadLength = pxMessage->uxPayloadLength;
+
+	( void ) memset( &xResponse, 0, sizeof( xResponse ) );
+	xResponse.usContentFormat = coapFORMAT_NONE;
+	xResponse.pucPayload = pucPayload;
+
+	switch( pxMessage->ucCode )
+	{
+		case coapCODE_GET:
+			xResponse.ucCode = coapCODE_CONTENT;
+			break;
+
+		case coapCODE_DELETE:
+			xResponse.ucCode = coapCODE_DELETED;
+			break;
+
+		default:
+			xResponse.ucCode = coapCODE_CHANGED;
+			break;
+	}
+
+	/* The size of a response block may be lowered by the client. */
+	xHasBlock2 = xCoAPGetBlock( pxMessage, coapOPTION_BLOCK2, &xBlock2 );
+	xBlock2.xMore = pdFALSE;
+
+	if( ( xHasBlock2 == pdFALSE ) || ( coapBLOCK_SIZE( xBlock2.ucSZX ) > ipconfigCOAP_BLOCK_SIZE ) )
+	{
+		uint32_t ulNumber = ( xHasBlock2 != pdFALSE ) ? xBlock2.ulNumber : 0U;
+		uint8_t ucSZX = ucCoAPSizeToSZX( ipconfigCOAP_BLOCK_SIZE );
+
+		/* Translate the block number to our block size. */
+		if( xHasBlock2 != pdFALSE )
+		{
+			ulNumber = ( uint32_t ) ( ( ulNumber * coapBLOCK_SIZE( xBlock2.ucSZX ) ) / coapBLOCK_SIZE( ucSZX ) );
+		}
+
+		xBlock2.ulNumber = ulNumber;
+		xBlock2.ucSZX = ucSZX;
+	}
+
+	xRequest.ulResponseOffset = xBlock2.ulNumber * ( uint32_t ) coapBLOCK_SIZE( xBlock2.ucSZX );
+	xResponse.uxPayloadSize = coapBLOCK_SIZE( xBlock2.ucSZX );
+
+	xHasBlock1 = xCoAPGetBlock( pxMessage, coapOPTION_BLOCK1, &xBlock1 );
+
+	if( xHasBlock1 != pdFALSE )
+	{
+		xRequest.ulPayloadOffset = xBlock1.ulNumber * ( uint32_t ) coapBLOCK_SIZE( xBlock1.ucSZX );
+		xRequest.xMorePayload = xBlock1.xMore;
+	}
+
+	pxResource = prvFindResource( pxServer, pxMessage );
+
+	if( pxResource == NULL )
+	{
+		xResponse.ucCode = coapCODE_NOT_FOUND;
+	}
+	else if( pxResource->fHandler == NULL )
+	{
+		xResponse.ucCode = coapCODE_METHOD_NOT_ALLOWED;
+	}
+	else
+	{
+		pxResource->fHandler( pxResource, &xRequest, &xResponse );
+
+		if( xResponse.uxPayloadLength > xResponse.uxPayloadSize )
+		{
+			xResponse.uxPayloadLength = xResponse.uxPayloadSize;
+		}
+
+		if( ( xHasBlock1 != pdFALSE ) && ( xBlock1.xMore != pdFALSE ) && ( coapCODE_CLASS( xResponse.ucCode ) == 2U ) )
+		{
+			/* Ask for the next block of the request body. */
+			xResponse.ucCode = coapCODE_CONTINUE;
+			xResponse.uxPayloadLength = 0U;
+			xResponse.xMore = pdFALSE;
+		}
+
+		/* Registration and deregistration only take place with the first block. */
+		if( ( pxResource->xObservable != pdFALSE ) && ( pxMessage->ucCode == coapCODE_GET ) && ( xBlock2.ulNumber == 0U ) )
+		{
+			pxObserveOption = pxCoAPFindOption( pxMessage, coapOPTION_OBSERVE );
+		}
+	}
+
+	vCoAPBuilderInit( &xBuilder, ucHeader, sizeof( ucHeader ), ucType, xResponse.ucCode, usMessageID,
+					  pxMessage->ucToken, pxMessage->ucTokenLength );
+
+	if( pxObserveOption != NULL )
+	{
+		CoAPObserver_t * pxObserver = prvFindObserver( pxServer, pxResource, pxPeer, pxMessage->ucToken, pxMessage->ucTokenLength );
+
+		if( ( ulCoAPOptionUint( pxObserveOption ) == coapOBSERVE_REGISTER ) && ( coapCODE_CLASS( xResponse.ucCode ) == 2U ) )
+		{
+			if( pxObserver == NULL )
+			{
+				pxObserver = prvFindObserver( pxServer, NULL, NULL, NULL, 0U );
+			}
+
+			if( pxObserver != NULL )
+			{
+				pxObserver->pxResource = pxResource;
+				( void ) memcpy( &( pxObserver->xPeer ), pxPeer, sizeof( pxObserver->xPeer ) );
+				( void ) memcpy( pxObserver->ucToken, pxMessage->ucToken, pxMessage->ucTokenLength );
+				pxObserver->ucTokenLength = pxMessage->ucTokenLength;
+				pxObserver->xAwaitingAck = pdFALSE;
+				pxObserver->ulCount = 0U;
+
+				/* Only a response with an Observe option tells the client that it was registered. */
+				pxServer->ulObserveSequence++;
+				vCoAPAddUintOption( &xBuilder, coapOPTION_OBSERVE, pxServer->ulObserveSequence & coapOBSERVE_MASK );
+			}
+			else
+			{
+				FreeRTOS_printf( ( "CoAP: no space for another observer\n" ) );
+			}
+		}
+		else if( pxObserver != NULL )
+		{
+			pxObserver->pxResource = NULL;
+		}
+		else
+		{
+			/* Deregistration of an unknown observer. */
+		}
+	}
+
+	if( ( xResponse.uxPayloadLength != 0U ) && ( xResponse.usContentFormat != coapFORMAT_NONE ) )
+	{
+		vCoAPAddUintOption( &xBuilder, coapOPTION_CONTENT_FORMAT, xResponse.usContentFormat );
+	}
+
+	if( ( pxMessage->ucCode == coapCODE_GET ) && ( ( xResponse.xMore != pdFALSE ) || ( xBlock2.ulNumber != 0U ) || ( xHasBlock2 != pdFALSE ) ) &&
+		( coapCODE_CLASS( xResponse.ucCode ) == 2U ) )
+	{
+		xBlock2.xMore = xResponse.xMore;
+		vCoAPAddUintOption( &xBuilder, coapOPTION_BLOCK2, ulCoAPEncodeBlock( &xBlock2 ) );
+	}
+
+	if( xHasBlock1 != pdFALSE )
+	{
+		/* Acknowledge the block that was received. */
+		vCoAPAddUintOption( &xBuilder, coapOPTION_BLOCK1, ulCoAPEncodeBlock( &xBlock1 ) );
+	}
+
+	uxHeaderLength = uxCoAPBuilderFinish( &xBuilder, 0U );
+
+	if( uxHeaderLength == 0U )
+	{
+		FreeRTOS_printf( ( "CoAP: response header too long\n" ) );
+		return;
+	}
+
+	/* Put the header in front of the payload, with a marker if needed. */
+	uxLength = uxHeaderLength + xResponse.uxPayloadLength;
+
+	if( xResponse.uxPayloadLength != 0U )
+	{
+		pucPayload--;
+		*pucPayload = 0xFFU;
+		uxLength++;
+	}
+
+	pucMessage = pucPayload - uxHeaderLength;
+	( void ) memcpy( pucMessage, ucHeader, uxHeaderLength );
+
+	prvSendMessage( pxServer, pxPeer, pucMessage, uxLength );
+	prvRememberResponse( pxServer, pxPeer, pxMessage->usMessageID, pucMessage, uxLength );
+}
+/*-----------------------------------------------------------*/
+
+void FreeRTOS_CoAPServerWork( CoAPServer_t * pxServer,
+							  TickType_t xBlockingTime )
+{
+struct freertos_sockaddr xPeer;
+socklen_t xPeerLength = sizeof( xPeer );
+BaseType_t xFlags = 0;
+int32_t lBytes;
+
+	( void ) FreeRTOS_setsockopt( pxServer->xSocket, 0, FREERTOS_SO_RCVTIMEO, &xBlockingTime, sizeof( xBlockingTime ) );
+
+	for( ; ; )
+	{
+		lBytes = FreeRTOS_recvfrom( pxServer->xSocket, pxServer->ucRxBuffer, sizeof( pxServer->ucRxBuffer ), xFlags, &xPeer, &xPeerLength );
+
+		if( lBytes <= 0 )
+		{
+			break;
+		}
+
+		/* Only wait for the first message, handle the others as long as they're queued. */
+		xFlags = FREERTOS_MSG_DONTWAIT;
+
+		if( xCoAPParse( pxServer->ucRxBuffer, ( size_t ) lBytes, &( pxServer->xMessage ) ) == pdFAIL )
+		{
+			/* Reject a malformed confirmable message, ignore anything else. */
+			if( ( lBytes >= 4 ) && ( ( ( pxServer->ucRxBuffer[ 0 ] >> 4 ) & 0x03U ) == coapTYPE_CON ) )
+			{
+				uint16_t usMessageID = ( uint16_t ) ( ( ( uint16_t ) pxServer->ucRxBuffer[ 2 ] << 8 ) | pxServer->ucRxBuffer[ 3 ] );
+				prvSendEmpty( pxServer, &xPeer, coapTYPE_RST, usMessageID );
+			}
+		}
+		else if( pxServer->xMessage.ucCode == coapCODE_EMPTY )
+		{
+			prvHandleEmpty( pxServer, &xPeer, &( pxServer->xMessage ) );
+		}
+		else if( coapCODE_CLASS( pxServer->xMessage.ucCode ) == 0U )
+		{
+			if( pxServer->xMessage.ucType <= coapTYPE_NON )
+			{
+				prvHandleRequest( pxServer, &xPeer, &( pxServer->xMessage ) );
+			}
+		}
+		else if( pxServer->xMessage.ucType == coapTYPE_CON )
+		{
+			/* A response was not expected. */
+			prvSendEmpty( pxServer, &xPeer, coapTYPE_RST, pxServer->xMessage.usMessageID );
+		}
+		else
+		{
+			/* Ignore it. */
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t FreeRTOS_CoAPNotify( CoAPServer_t * pxServer,
+								CoAPResource_t * pxResource )
+{
+BaseType_t xCount = 0;
+size_t uxIndex;
+
+	pxServer->ulObserveSequence++;
+
+	for( uxIndex = 0U; uxIndex < ( size_t ) ARRAY_SIZE( pxServer->xObservers ); uxIndex++ )
+	{
+	CoAPObserver_t * pxObserver = &( pxServer->xObservers[ uxIndex ] );
+	CoAPRequest_t xRequest;
+	CoAPResponse_t xResponse;
+	CoAPBuilder_t xBuilder;
+	CoAPBlock_t xBlock2;
+	uint8_t * pucPayload = &( pxServer->ucTxBuffer[ coapRESPONSE_HEADROOM ] );
+	uint8_t ucHeader[ coapRESPONSE_HEADROOM ];
+	uint8_t ucType = coapTYPE_NON;
+	size_t uxHeaderLength, uxLength;
+
+		if( ( pxObserver->pxResource != pxResource ) || ( pxResource == NULL ) )
+		{
+			continue;
+		}
+
+		pxObserver->ulCount++;
+
+		if( ( pxObserver->ulCount % ipconfigCOAP_NOTIFY_CON_INTERVAL ) == 0U )
+		{
+			if( pxObserver->xAwaitingAck != pdFALSE )
+			{
+				/* The previous confirmable notification was never acknowledged. */
+				FreeRTOS_printf( ( "CoAP: observer of '%s' went away\n", pxResource->pcPath ) );
+				pxObserver->pxResource = NULL;
+				continue;
+			}
+
+			ucType = coapTYPE_CON;
+			pxObserver->xAwaitingAck = pdTRUE;
+		}
+
+		/* The handler is asked for the first block of the current state,
+		 * 'pxMessage' is NULL for a notification. */
+		( void ) memset( &xRequest, 0, sizeof( xRequest ) );
+		xRequest.pxPeer = &( pxObserver->xPeer );
+		xRequest.ucMethod = coapCODE_GET;
+
+		( void ) memset( &xResponse, 0, sizeof( xResponse ) );
+		xResponse.ucCode = coapCODE_CONTENT;
+		xResponse.usContentFormat = coapFORMAT_NONE;
+		xResponse.pucPayload = pucPayload;
+		xResponse.uxPayloadSize = ipconfigCOAP_BLOCK_SIZE;
+
+		pxResource->fHandler( pxResource, &xRequest, &xResponse );
+
+		if( xResponse.uxPayloadLength > xResponse.uxPayloadSize )
+		{
+			xResponse.uxPayloadLength = xResponse.uxPayloadSize;
+		}
+
+		pxObserver->usLastMessageID = pxServer->usMessageID++;
+		vCoAPBuilderInit( &xBuilder, ucHeader, sizeof( ucHeader ), ucType, xResponse.ucCode, pxObserver->usLastMessageID,
+						  pxObserver->ucToken, pxObserver->ucTokenLength );
+
+		if( coapCODE_CLASS( xResponse.ucCode ) == 2U )
+		{
+			vCoAPAddUintOption( &xBuilder, coapOPTION_OBSERVE, pxServer->ulObserveSequence & coapOBSERVE_MASK );
+		}
+		else
+		{
+			/* An error response ends the observation. */
+			pxObserver->pxResource = NULL;
+		}
+
+		if( ( xResponse.uxPayloadLength != 0U ) && ( xResponse.usContentFormat != coapFORMAT_NONE ) )
+		{
+			vCoAPAddUintOption( &xBuilder, coapOPTION_CONTENT_FORMAT, xResponse.usContentFormat );
+		}
+
+		if( xResponse.xMore != pdFALSE )
+		{
+			/* The client will fetch the rest with normal GET requests. */
+			xBlock2.ulNumber = 0U;
+			xBlock2.ucSZX = ucCoAPSizeToSZX( ipconfigCOAP_BLOCK_SIZE );
+			xBlock2.xMore = pdTRUE;
+			vCoAPAddUintOption( &xBuilder, coapOPTION_BLOCK2, ulCoAPEncodeBlock( &xBlock2 ) );
+		}
+
+		uxHeaderLength = uxCoAPBuilderFinish( &xBuilder, 0U );
+
+		if( uxHeaderLength != 0U )
+		{
+			uxLength = uxHeaderLength + xResponse.uxPayloadLength;
+
+			if( xResponse.uxPayloadLength != 0U )
+			{
+				pucPayload--;
+				*pucPayload = 0xFFU;
+				uxLength++;
+			}
+
+			( void ) memcpy( pucPayload - uxHeaderLength, ucHeader, uxHeaderLength );
+			prvSendMessage( pxServer, &( pxObserver->xPeer ), pucPayload - uxHeaderLength, uxLength );
+			xCount++;
+		}
+	}
+
+	return xCount;
+}
+/*-----------------------------------------------------------*/
+
+#if ( ipconfigCOAP_USE_PLUS_FAT != 0 )
+
+	void vCoAPFileHandler( CoAPResource_t * pxResource,
+						   const CoAPRequest_t * pxRequest,
+						   CoAPResponse_t * pxResponse )
+	{
+	FF_FILE * pxFile;
+
+		if( pxRequest->ucMethod == coapCODE_GET )
+		{
+			pxFile = ff_fopen( pxResource->pcFileName, "rb" );
+
+			if( pxFile == NULL )
+			{
+				pxResponse->ucCode = coapCODE_NOT_FOUND;
+			}
+			else
+			{
+			size_t uxFileLength = ff_filelength( pxFile );
+
+				pxResponse->usContentFormat = coapFORMAT_OCTET_STREAM;
+
+				if( pxRequest->ulResponseOffset < uxFileLength )
+				{
+					( void ) ff_fseek( pxFile, ( long ) pxRequest->ulResponseOffset, FF_SEEK_SET );
+					pxResponse->uxPayloadLength = ff_fread( pxResponse->pucPayload, 1, pxResponse->uxPayloadSize, pxFile );
+					pxResponse->xMore = ( ( pxRequest->ulResponseOffset + pxResponse->uxPayloadLength ) < uxFileLength ) ? pdTRUE : pdFALSE;
+				}
+				else if( pxRequest->ulResponseOffset != 0U )
+				{
+					pxResponse->ucCode = coapCODE_BAD_OPTION;
+				}
+				else
+				{
+					/* An empty file. */
+				}
+
+				( void ) ff_fclose( pxFile );
+			}
+		}
+		else if( pxRequest->ucMethod == coapCODE_PUT )
+		{
+			/* The first block truncates the file, the next blocks must follow in order. */
+			pxFile = ff_fopen( pxResource->pcFileName, ( pxRequest->ulPayloadOffset == 0U ) ? "wb" : "ab" );
+
+			if( pxFile == NULL )
+			{
+				pxResponse->ucCode = coapCODE_INTERNAL_SERVER_ERROR;
+			}
+			else
+			{
+				if( ff_filelength( pxFile ) != pxRequest->ulPayloadOffset )
+				{
+					pxResponse->ucCode = coapCODE_REQUEST_ENTITY_INCOMPLETE;
+				}
+				else if( ff_fwrite( pxRequest->pucPayload, 1, pxRequest->uxPayloadLength, pxFile ) != pxRequest->uxPayloadLength )
+				{
+					pxResponse->ucCode = coapCODE_INTERNAL_SERVER_ERROR;
+				}
+				else
+				{
+					pxResponse->ucCode = ( pxRequest->ulPayloadOffset == 0U ) ? coapCODE_CREATED : coapCODE_CHANGED;
+				}
+
+				( void ) ff_fclose( pxFile );
+			}
+		}
+		else
+		{
+			pxResponse->ucCode = coapCODE_METHOD_NOT_ALLOWED;
+		}
+	}
+
+#endif /* ipconfigCOAP_USE_PLUS_FAT */
+/*-----------------------------------------------------------*/
@@ -0,0 +1,230 @@
+/*
+ * FreeRTOS+TCP V2.3.2
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_Sockets.h"
+#include "FreeRTOS_server_utils.h"
+
+static char prvToLower( char cChar );
+static BaseType_t prvEndOfWord( char cChar );
+static void prvTXReplyCommit( TXReply_t * pxReply );
+/*-----------------------------------------------------------*/
+
+static char prvToLower( char cChar )
+{
+	if( ( cChar >= 'A' ) && ( cChar <= 'Z' ) )
+	{
+		cChar = ( char ) ( cChar + ( 'a' - 'A' ) );
+	}
+
+	return cChar;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvEndOfWord( char cChar )
+{
+	return ( ( cChar == '\0' ) || ( cChar == ' ' ) || ( cChar == '\t' ) || ( cChar == '\r' ) || ( cChar == '\n' ) ) ? pdTRUE : pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulServerWordKey( const char * pcWord,
+						  size_t * puxLength )
+{
+	uint32_t ulKey = 0U;
+	size_t uxLength = 0U;
+
+	while( prvEndOfWord( pcWord[ uxLength ] ) == pdFALSE )
+	{
+		if( uxLength < 4U )
+		{
+			ulKey |= ( uint32_t ) ( uint8_t ) prvToLower( pcWord[ uxLength ] ) << ( 8U * uxLength );
+		}
+
+		uxLength++;
+	}
+
+	*puxLength = uxLength;
+
+	return ulKey;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xServerWordEquals( const char * pcWord,
+							  size_t uxLength,
+							  const char * pcName )
+{
+	size_t uxIndex;
+
+	for( uxIndex = 0U; uxIndex < uxLength; uxIndex++ )
+	{
+		if( ( pcName[ uxIndex ] == '\0' ) || ( prvToLower( pcWord[ uxIndex ] ) != prvToLower( pcName[ uxIndex ] ) ) )
+		{
+			return pdFALSE;
+		}
+	}
+
+	return ( pcName[ uxLength ] == '\0' ) ? pdTRUE : pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTXReplyInit( TXReply_t * pxReply,
+						 Socket_t xSocket,
+						 size_t uxMinimumSpace,
+						 TickType_t xBlockTime )
+{
+	BaseType_t xSpace = 0;
+	TimeOut_t xTimeOut;
+
+	( void ) memset( pxReply, 0, sizeof( *pxReply ) );
+	pxReply->xSocket = xSocket;
+
+	vTaskSetTimeOutState( &xTimeOut );
+
+	/* The IP-task makes space in the stream as the peer acknowledges data. */
+	while( FreeRTOS_tx_space( xSocket ) < ( BaseType_t ) uxMinimumSpace )
+	{
+		if( ( FreeRTOS_issocketconnected( xSocket ) != pdTRUE ) ||
+			( xTaskCheckForTimeOut( &xTimeOut, &xBlockTime ) != pdFALSE ) )
+		{
+			pxReply->xError = pdTRUE;
+			return pdFAIL;
+		}
+
+		vTaskDelay( 1U );
+	}
+
+	/* This also creates the TX stream in case it doesn't exist yet. */
+	pxReply->pucHead = FreeRTOS_get_tx_head( xSocket, &xSpace );
+
+	if( ( pxReply->pucHead == NULL ) || ( xSpace <= 0 ) )
+	{
+		pxReply->xError = pdTRUE;
+		return pdFAIL;
+	}
+
+	pxReply->uxSpace = ( size_t ) xSpace;
+
+	return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+/* Pass the bytes written so far to the socket, and continue at the new head. */
+static void prvTXReplyCommit( TXReply_t * pxReply )
+{
+	BaseType_t xSpace = 0;
+
+	if( pxReply->uxPending != 0U )
+	{
+		if( FreeRTOS_send( pxReply->xSocket, NULL, pxReply->uxPending, 0 ) != ( BaseType_t ) pxReply->uxPending )
+		{
+			pxReply->xError = pdTRUE;
+		}
+
+		pxReply->xTotal += ( BaseType_t ) pxReply->uxPending;
+		pxReply->uxPending = 0U;
+	}
+
+	pxReply->pucHead = FreeRTOS_get_tx_head( pxReply->xSocket, &xSpace );
+	pxReply->uxSpace = ( xSpace > 0 ) ? ( size_t ) xSpace : 0U;
+}
+/*-----------------------------------------------------------*/
+
+void vTXReplyAdd( TXReply_t * pxReply,
+				  const char * pcText,
+				  size_t uxLength )
+{
+	while( ( uxLength != 0U ) && ( pxReply->xError == pdFALSE ) )
+	{
+		size_t uxCount = pxReply->uxSpace - pxReply->uxPending;
+
+		if( uxCount == 0U )
+		{
+			/* The end of the circular buffer was reached, or the stream is full. */
+			prvTXReplyCommit( pxReply );
+
+			if( ( pxReply->pucHead == NULL ) || ( pxReply->uxSpace == 0U ) )
+			{
+				pxReply->xError = pdTRUE;
+			}
+
+			continue;
+		}
+
+		if( uxCount > uxLength )
+		{
+			uxCount = uxLength;
+		}
+
+		( void ) memcpy( &( pxReply->pucHead[ pxReply->uxPending ] ), pcText, uxCount );
+		pxReply->uxPending += uxCount;
+		pcText = &( pcText[ uxCount ] );
+		uxLength -= uxCount;
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vTXReplyString( TXReply_t * pxReply,
+					 const char * pcText )
+{
+	vTXReplyAdd( pxReply, pcText, strlen( pcText ) );
+}
+/*-----------------------------------------------------------*/
+
+void vTXReplyDecimal( TXReply_t * pxReply,
+					  uint32_t ulValue )
+{
+	char pcDigits[ 10 ];
+	size_t uxIndex = sizeof( pcDigits );
+
+	do
+	{
+		uxIndex--;
+		pcDigits[ uxIndex ] = ( char ) ( '0' + ( ulValue % 10U ) );
+		ulValue /= 10U;
+	} while( ulValue != 0U );
+
+	vTXReplyAdd( pxReply, &( pcDigits[ uxIndex ] ), sizeof( pcDigits ) - uxIndex );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTXReplyFlush( TXReply_t * pxReply )
+{
+	if( pxReply->xError == pdFALSE )
+	{
+		prvTXReplyCommit( pxReply );
+	}
+
+	return ( pxReply->xError == pdFALSE ) ? pxReply->xTotal : -pdFREERTOS_ERRNO_ENOSPC;
+}
+/*-----------------------------------------------------------*/
@@ -27,7 +27,15 @@
 #include "FreeRTOS.h"
 
 /* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_Sockets.h"
 #include "FreeRTOS_FTP_commands.h"
+#include "FreeRTOS_server_utils.h"
+
+/* The parameters of the perfect hash of the command names in xFTPCommands[],
+ * see serverWORD_HASH(). */
+#define ftpCOMMAND_HASH_BITS          7U
+#define ftpCOMMAND_HASH_MULTIPLIER    0x819D7CA7U
 
 const FTPCommand_t xFTPCommands[ FTP_CMD_COUNT ] =
 {
@@ -74,3 +82,35 @@ const FTPCommand_t xFTPCommands[ FTP_CMD_COUNT ] =
 	{ 4, "CLOS", ECMD_CLOSE,   pdTRUE,	pdFALSE },
 	{ 4, "UNKN", ECMD_UNKNOWN, pdFALSE, pdFALSE },
 };
+
+/* Maps the hash of a command name to its index in xFTPCommands[]. */
+static const uint8_t ucFTPCommandHash[ 1U << ftpCOMMAND_HASH_BITS ] =
+{
+	16, 11, 0xFF, 3, 0xFF, 0xFF, 14, 0xFF, 0xFF, 0xFF, 0xFF, 37, 0xFF, 0xFF, 24, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 8, 0xFF, 32, 0xFF, 0xFF, 0xFF, 9, 0xFF, 26, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 22, 25, 0xFF, 0xFF, 0xFF, 0xFF, 33, 0xFF, 0xFF, 10, 0xFF, 0xFF,
+	0xFF, 0xFF, 1, 38, 0xFF, 13, 21, 18, 36, 0xFF, 0xFF, 27, 0xFF, 0xFF, 35, 0xFF,
+	0xFF, 5, 20, 0, 0xFF, 0xFF, 19, 0xFF, 0xFF, 0xFF, 0xFF, 12, 0xFF, 29, 0xFF, 0xFF,
+	39, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 4, 34, 0xFF, 15, 28, 0xFF, 0xFF, 0xFF, 7, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 31, 0xFF, 23, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 2, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 30, 0xFF, 17, 0xFF, 0xFF, 0xFF, 6, 0xFF,
+};
+
+BaseType_t xFTPCommandLookup( const char * pcLine,
+							  size_t * puxLength )
+{
+	size_t uxLength;
+	uint32_t ulKey = ulServerWordKey( pcLine, &uxLength );
+	uint8_t ucIndex = ucFTPCommandHash[ serverWORD_HASH( ulKey, ftpCOMMAND_HASH_MULTIPLIER, ftpCOMMAND_HASH_BITS ) ];
+	BaseType_t xResult = ECMD_UNKNOWN;
+
+	*puxLength = uxLength;
+
+	if( ( ucIndex != serverHASH_EMPTY ) && ( xServerWordEquals( pcLine, uxLength, xFTPCommands[ ucIndex ].pcCommandName ) != pdFALSE ) )
+	{
+		xResult = ( BaseType_t ) ucIndex;
+	}
+
+	return xResult;
+}
+/*-----------------------------------------------------------*/
@@ -50,6 +50,7 @@
 #include "FreeRTOS_FTP_commands.h"
 #include "FreeRTOS_TCP_server.h"
 #include "FreeRTOS_server_private.h"
+#include "FreeRTOS_server_utils.h"
 
 #include "eventLogging.h"
 
@@ -319,7 +320,7 @@
 		if( xRc > 0 )
 		{
 			BaseType_t xIndex;
-			const FTPCommand_t * pxCommand;
+			size_t uxLength;
 			char * pcRestCommand;
 
 			if( xRc < ( BaseType_t ) sizeof( pcCOMMAND_BUFFER ) )
@@ -332,30 +333,19 @@
 				pcCOMMAND_BUFFER[ --xRc ] = '\0';
 			}
 
-			/* Now iterate through a list of FTP commands, and look for a match. */
-			pxCommand = xFTPCommands;
+			/* Look up the command with a perfect hash of its name. */
+			xIndex = xFTPCommandLookup( pcCOMMAND_BUFFER, &uxLength );
 			pcRestCommand = pcCOMMAND_BUFFER;
 
-			for( xIndex = 0; xIndex < FTP_CMD_COUNT - 1; xIndex++, pxCommand++ )
+			if( xIndex != ECMD_UNKNOWN )
 			{
-				BaseType_t xLength;
-
-				/* The length of each command is stored as well, just to be a bit
-				 * quicker here. */
-				xLength = pxCommand->xCommandLength;
+				/* A match with an existing command is found.  Skip any
+				 * whitespace to get the first parameter. */
+				pcRestCommand += uxLength;
 
-				if( ( xRc >= xLength ) && ( memcmp( ( const void * ) pxCommand->pcCommandName, ( const void * ) pcCOMMAND_BUFFER, xLength ) == 0 ) )
+				while( ( *pcRestCommand == ' ' ) || ( *pcRestCommand == '\t' ) )
 				{
-					/* A match with an existing command is found.  Skip any
-					 * whitespace to get the first parameter. */
-					pcRestCommand += xLength;
-
-					while( ( *pcRestCommand == ' ' ) || ( *pcRestCommand == '\t' ) )
-					{
-						pcRestCommand++;
-					}
-
-					break;
+					pcRestCommand++;
 				}
 			}
 
@@ -2844,13 +2834,29 @@
 }
 					#endif /* if ( ffconfigTIME_SUPPORT != 0 ) */
 FreeRTOS_printf( ( "ftp::sizeDateFile: '%s' = %s\n", pxClient->pcFileName, pcCOMMAND_BUFFER ) );
+
+					prvSendReply( pxClient->xSocket, pcCOMMAND_BUFFER, xLength );
 				}
 				else
 				{
-					xLength = snprintf( pcCOMMAND_BUFFER, sizeof( pcCOMMAND_BUFFER ), "213 %lu\r\n", xStatBuf.st_size );
+					TXReply_t xReply;
+
+					/* "213 <size>", written directly to the TX stream when
+					 * the complete reply fits in it. */
+					if( xTXReplyInit( &xReply, pxClient->xSocket, sizeof( "213 4294967295\r\n" ) - 1U, pdMS_TO_TICKS( ipconfigSERVER_REPLY_BLOCK_TIME_MS ) ) == pdPASS )
+					{
+						vTXReplyString( &xReply, "213 " );
+						vTXReplyDecimal( &xReply, ( uint32_t ) xStatBuf.st_size );
+						vTXReplyString( &xReply, "\r\n" );
+						( void ) xTXReplyFlush( &xReply );
+					}
+					else
+					{
+						xLength = snprintf( pcCOMMAND_BUFFER, sizeof( pcCOMMAND_BUFFER ), "213 %lu\r\n", xStatBuf.st_size );
+						prvSendReply( pxClient->xSocket, pcCOMMAND_BUFFER, xLength );
+					}
 				}
 
-				prvSendReply( pxClient->xSocket, pcCOMMAND_BUFFER, xLength );
 				xResult = pdTRUE;
 			}
 			else
@@ -30,7 +30,17 @@
 /* FreeRTOS includes. */
 #include "FreeRTOS.h"
 
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_Sockets.h"
+
 #include "FreeRTOS_HTTP_commands.h"
+#include "FreeRTOS_server_utils.h"
+
+/* The parameters of the perfect hash of the method names in xWebCommands[],
+ * see serverWORD_HASH(). */
+#define webCOMMAND_HASH_BITS          4U
+#define webCOMMAND_HASH_MULTIPLIER    0xC9E9C617U
 
 const struct xWEB_COMMAND xWebCommands[ WEB_CMD_COUNT ] =
 {
@@ -46,6 +56,31 @@ const struct xWEB_COMMAND xWebCommands[ WEB_CMD_COUNT ] =
 	{ 4, "UNKN",	ECMD_UNK	 },
 };
 
+/* Maps the hash of a method name to its index in xWebCommands[]. */
+static const uint8_t ucWebCommandHash[ 1U << webCOMMAND_HASH_BITS ] =
+{
+	6, 2, 0xFF, 0, 1, 0xFF, 0xFF, 7, 5, 8, 0xFF, 4, 0xFF, 0xFF, 0xFF, 3
+};
+
+BaseType_t xWebCommandLookup( const char * pcLine,
+							  size_t * puxLength )
+{
+	size_t uxLength;
+	uint32_t ulKey = ulServerWordKey( pcLine, &uxLength );
+	uint8_t ucIndex = ucWebCommandHash[ serverWORD_HASH( ulKey, webCOMMAND_HASH_MULTIPLIER, webCOMMAND_HASH_BITS ) ];
+	BaseType_t xResult = ECMD_UNK;
+
+	*puxLength = uxLength;
+
+	if( ( ucIndex != serverHASH_EMPTY ) && ( xServerWordEquals( pcLine, uxLength, xWebCommands[ ucIndex ].pcCommandName ) != pdFALSE ) )
+	{
+		xResult = ( BaseType_t ) ucIndex;
+	}
+
+	return xResult;
+}
+/*-----------------------------------------------------------*/
+
 const char * webCodename( int aCode )
 {
 	switch( aCode )
@@ -39,6 +39,7 @@
 #include "FreeRTOS_HTTP_commands.h"
 #include "FreeRTOS_TCP_server.h"
 #include "FreeRTOS_server_private.h"
+#include "FreeRTOS_server_utils.h"
 
 /* FreeRTOS+FAT includes. */
 #include "ff_stdio.h"
@@ -64,6 +65,15 @@
 	#define ipconfigHTTP_REQUEST_CHARACTER	  '?'
 #endif
 
+/* The parameters of the perfect hash of the extensions in pxTypeCouples[],
+ * see serverWORD_HASH(). */
+#define httpTYPE_HASH_BITS					  4U
+#define httpTYPE_HASH_MULTIPLIER			  0xFF876919U
+
+/* The length of the status line and the headers of a reply without the
+ * code name and the contents type, with room for two 10-digit numbers. */
+#define httpREPLY_FIXED_LENGTH				  128U
+
 /*_RB_ Need comment block, although fairly self evident. */
 static void prvFileClose( HTTPClient_t * pxClient );
 static BaseType_t prvProcessCmd( HTTPClient_t * pxClient,
@@ -72,7 +82,9 @@ static const char * pcGetContentsType( const char * apFname );
 static BaseType_t prvOpenURL( HTTPClient_t * pxClient );
 static BaseType_t prvSendFile( HTTPClient_t * pxClient );
 static BaseType_t prvSendReply( HTTPClient_t * pxClient,
-								BaseType_t xCode );
+								BaseType_t xCode,
+								const char * pcContentsType,
+								size_t uxContentLength );
 
 static const char pcEmptyString[ 1 ] = { '\0' };
 
@@ -99,6 +111,12 @@ static TypeCouple_t pxTypeCouples[] =
 	{ "ttc",  "application/x-font-ttf" }
 };
 
+/* Maps the hash of an extension to its index in pxTypeCouples[]. */
+static const uint8_t ucTypeHash[ 1U << httpTYPE_HASH_BITS ] =
+{
+	11, 0xFF, 0xFF, 5, 3, 4, 9, 0, 8, 10, 2, 0xFF, 12, 1, 6, 7
+};
+
 void vHTTPClientDelete( TCPClient_t * pxTCPClient )
 {
 	HTTPClient_t * pxClient = ( HTTPClient_t * ) pxTCPClient;
@@ -127,31 +145,64 @@ static void prvFileClose( HTTPClient_t * pxClient )
 /*-----------------------------------------------------------*/
 
 static BaseType_t prvSendReply( HTTPClient_t * pxClient,
-								BaseType_t xCode )
+								BaseType_t xCode,
+								const char * pcContentsType,
+								size_t uxContentLength )
 {
-	struct xTCP_SERVER * pxParent = pxClient->pxParent;
+	TXReply_t xReply;
 	BaseType_t xRc;
+	const char * pcCodename = webCodename( xCode );
+	size_t uxMaximumLength;
+
+	if( pcContentsType == NULL )
+	{
+		pcContentsType = "text/html";
+	}
+
+	/* The reply will not be longer than the fixed text plus the two strings. */
+	uxMaximumLength = httpREPLY_FIXED_LENGTH + strlen( pcCodename ) + strlen( pcContentsType );
+
+	/* The status line and the headers are written directly into the TX
+	 * stream of the socket, there is no need to format them in a buffer. */
+	if( xTXReplyInit( &xReply, pxClient->xSocket, uxMaximumLength, pdMS_TO_TICKS( ipconfigSERVER_REPLY_BLOCK_TIME_MS ) ) == pdPASS )
+	{
+		vTXReplyString( &xReply, "HTTP/1.1 " );
+		vTXReplyDecimal( &xReply, ( uint32_t ) xCode );
+		vTXReplyString( &xReply, " " );
+		vTXReplyString( &xReply, pcCodename );
+		vTXReplyString( &xReply, "\r\n"
+						#if USE_HTML_CHUNKS
+							"Transfer-Encoding: chunked\r\n"
+						#endif
+						"Content-Type: " );
+		vTXReplyString( &xReply, pcContentsType );
+		vTXReplyString( &xReply, "\r\nConnection: keep-alive\r\nContent-Length: " );
+		vTXReplyDecimal( &xReply, ( uint32_t ) uxContentLength );
+		vTXReplyString( &xReply, "\r\n\r\n" );
+
+		xRc = xTXReplyFlush( &xReply );
+	}
+	else
+	{
+		/* The TX stream is still full, let FreeRTOS_send() wait for space. */
+		char * pcBuffer = pcFILE_BUFFER;
+
+		xRc = snprintf( pcBuffer, sizeof( pcFILE_BUFFER ),
+						"HTTP/1.1 %d %s\r\n"
+						#if USE_HTML_CHUNKS
+							"Transfer-Encoding: chunked\r\n"
+						#endif
+						"Content-Type: %s\r\n"
+						"Connection: keep-alive\r\n"
+						"Content-Length: %u\r\n\r\n",
+						( int ) xCode,
+						pcCodename,
+						pcContentsType,
+						( unsigned ) uxContentLength );
+
+		xRc = FreeRTOS_send( pxClient->xSocket, ( const void * ) pcBuffer, xRc, 0 );
+	}
 
-	/* A normal command reply on the main socket (port 21). */
-	char * pcBuffer = pxParent->pcFileBuffer;
-
-	xRc = snprintf( pcBuffer, sizeof( pxParent->pcFileBuffer ),
-					"HTTP/1.1 %d %s\r\n"
-					#if USE_HTML_CHUNKS
-						"Transfer-Encoding: chunked\r\n"
-					#endif
-					"Content-Type: %s\r\n"
-					"Connection: keep-alive\r\n"
-					"%s\r\n",
-					( int ) xCode,
-					webCodename( xCode ),
-					pxParent->pcContentsType[ 0 ] ? pxParent->pcContentsType : "text/html",
-					pxParent->pcExtraContents );
-
-	pxParent->pcContentsType[ 0 ] = '\0';
-	pxParent->pcExtraContents[ 0 ] = '\0';
-
-	xRc = FreeRTOS_send( pxClient->xSocket, ( const void * ) pcBuffer, xRc, 0 );
 	pxClient->bits.bReplySent = pdTRUE_UNSIGNED;
 
 	return xRc;
@@ -168,12 +219,8 @@ static BaseType_t prvSendFile( HTTPClient_t * pxClient )
 	{
 		pxClient->bits.bReplySent = pdTRUE_UNSIGNED;
 
-		strcpy( pxClient->pxParent->pcContentsType, pcGetContentsType( pxClient->pcCurrentFilename ) );
-		snprintf( pxClient->pxParent->pcExtraContents, sizeof( pxClient->pxParent->pcExtraContents ),
-				  "Content-Length: %d\r\n", ( int ) pxClient->uxBytesLeft );
-
 		/* "Requested file action OK". */
-		xRc = prvSendReply( pxClient, WEB_REPLY_OK );
+		xRc = prvSendReply( pxClient, WEB_REPLY_OK, pcGetContentsType( pxClient->pcCurrentFilename ), pxClient->uxBytesLeft );
 	}
 
 	if( xRc >= 0 )
@@ -244,10 +291,7 @@ static BaseType_t prvOpenURL( HTTPClient_t * pxClient )
 
 				if( xResult > 0 )
 				{
-					strcpy( pxClient->pxParent->pcContentsType, "text/html" );
-					snprintf( pxClient->pxParent->pcExtraContents, sizeof( pxClient->pxParent->pcExtraContents ),
-							  "Content-Length: %d\r\n", ( int ) xResult );
-					xRc = prvSendReply( pxClient, WEB_REPLY_OK ); /* "Requested file action OK" */
+					xRc = prvSendReply( pxClient, WEB_REPLY_OK, "text/html", xResult ); /* "Requested file action OK" */
 
 					if( xRc > 0 )
 					{
@@ -286,9 +330,8 @@ static BaseType_t prvOpenURL( HTTPClient_t * pxClient )
 
 	if( pxClient->pxFileHandle == NULL )
 	{
-		strcpy( pxClient->pxParent->pcExtraContents, "Content-Length: 0\r\n" );
 		/* "404 File not found". */
-		xRc = prvSendReply( pxClient, WEB_NOT_FOUND );
+		xRc = prvSendReply( pxClient, WEB_NOT_FOUND, NULL, 0U );
 	}
 	else
 	{
@@ -345,8 +388,8 @@ BaseType_t xHTTPClientWork( TCPClient_t * pxTCPClient )
 	if( xRc > 0 )
 	{
 		BaseType_t xIndex;
+		size_t uxLength;
 		const char * pcEndOfCmd;
-		const struct xWEB_COMMAND * curCmd;
 		char * pcBuffer = pcCOMMAND_BUFFER;
 
 		if( xRc < ( BaseType_t ) sizeof( pcCOMMAND_BUFFER ) )
@@ -361,45 +404,33 @@ BaseType_t xHTTPClientWork( TCPClient_t * pxTCPClient )
 
 		pcEndOfCmd = pcBuffer + xRc;
 
-		curCmd = xWebCommands;
-
 		/* Pointing to "/index.html HTTP/1.1". */
 		pxClient->pcUrlData = pcBuffer;
 
 		/* Pointing to "HTTP/1.1". */
 		pxClient->pcRestData = pcEmptyString;
 
-		/* Last entry is "ECMD_UNK". */
-		for( xIndex = 0; xIndex < WEB_CMD_COUNT - 1; xIndex++, curCmd++ )
+		/* Returns "ECMD_UNK" when the method is not known. */
+		xIndex = xWebCommandLookup( pcBuffer, &uxLength );
+
+		if( ( xIndex != ECMD_UNK ) && ( ( BaseType_t ) uxLength < xRc ) )
 		{
-			BaseType_t xLength;
+			char * pcLastPtr;
 
-			xLength = curCmd->xCommandLength;
+			pxClient->pcUrlData += uxLength + 1;
 
-			if( ( xRc >= xLength ) && ( memcmp( curCmd->pcCommandName, pcBuffer, xLength ) == 0 ) )
+			for( pcLastPtr = ( char * ) pxClient->pcUrlData; pcLastPtr < pcEndOfCmd; pcLastPtr++ )
 			{
-				char * pcLastPtr;
-
-				pxClient->pcUrlData += xLength + 1;
+				char ch = *pcLastPtr;
 
-				for( pcLastPtr = ( char * ) pxClient->pcUrlData; pcLastPtr < pcEndOfCmd; pcLastPtr++ )
+				if( ( ch == '\0' ) || ( strchr( "\n\r \t", ch ) != NULL ) )
 				{
-					char ch = *pcLastPtr;
-
-					if( ( ch == '\0' ) || ( strchr( "\n\r \t", ch ) != NULL ) )
-					{
-						*pcLastPtr = '\0';
-						pxClient->pcRestData = pcLastPtr + 1;
-						break;
-					}
+					*pcLastPtr = '\0';
+					pxClient->pcRestData = pcLastPtr + 1;
+					break;
 				}
-
-				break;
 			}
-		}
 
-		if( xIndex < WEB_CMD_COUNT - 1 )
-		{
 			xRc = prvProcessCmd( pxClient, xIndex );
 		}
 	}
@@ -419,7 +450,9 @@ static const char * pcGetContentsType( const char * apFname )
 	const char * dot = NULL;
 	const char * ptr;
 	const char * pcResult = "text/html";
-	BaseType_t x;
+	size_t uxLength;
+	uint32_t ulKey;
+	uint8_t ucIndex;
 
 	for( ptr = apFname; *ptr; ptr++ )
 	{
@@ -438,13 +471,12 @@ static const char * pcGetContentsType( const char * apFname )
 	{
 		dot++;
 
-		for( x = 0; x < ARRAY_SIZE( pxTypeCouples ); x++ )
+		ulKey = ulServerWordKey( dot, &uxLength );
+		ucIndex = ucTypeHash[ serverWORD_HASH( ulKey, httpTYPE_HASH_MULTIPLIER, httpTYPE_HASH_BITS ) ];
+
+		if( ( ucIndex != serverHASH_EMPTY ) && ( xServerWordEquals( dot, uxLength, pxTypeCouples[ ucIndex ].pcExtension ) != pdFALSE ) )
 		{
-			if( strcasecmp( dot, pxTypeCouples[ x ].pcExtension ) == 0 )
-			{
-				pcResult = pxTypeCouples[ x ].pcType;
-				break;
-			}
+			pcResult = pxTypeCouples[ ucIndex ].pcType;
 		}
 	}
 
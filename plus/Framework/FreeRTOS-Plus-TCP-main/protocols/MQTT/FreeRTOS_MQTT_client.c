@@ -0,0 +1,1421 @@
+/*
+ * FreeRTOS+TCP V2.3.2
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/*
+ * An MQTT 3.1.1 client, see FreeRTOS_MQTT_client.h.
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_Sockets.h"
+
+/* FreeRTOS Protocol includes. */
+#include "FreeRTOS_MQTT_client.h"
+
+#if ( ipconfigMQTT_USE_PLUS_FAT != 0 )
+	/* FreeRTOS+FAT includes. */
+	#include "ff_stdio.h"
+#endif
+
+#if !defined( ARRAY_SIZE )
+	#define ARRAY_SIZE( x )    ( BaseType_t ) ( sizeof( x ) / sizeof( x )[ 0 ] )
+#endif
+
+/* Control packet types, with the fixed flags where they are required. */
+#define mqttCONNECT					0x10U
+#define mqttCONNACK					0x20U
+#define mqttPUBLISH					0x30U
+#define mqttPUBACK					0x40U
+#define mqttPUBREC					0x50U
+#define mqttPUBREL					0x62U
+#define mqttPUBCOMP					0x70U
+#define mqttSUBSCRIBE				0x82U
+#define mqttSUBACK					0x90U
+#define mqttUNSUBSCRIBE				0xA2U
+#define mqttUNSUBACK				0xB0U
+#define mqttPINGREQ					0xC0U
+#define mqttPINGRESP				0xD0U
+#define mqttDISCONNECT				0xE0U
+
+#define mqttPUBLISH_DUP				0x08U
+#define mqttPUBLISH_RETAIN			0x01U
+
+/* CONNECT flags. */
+#define mqttCONNECT_USER_NAME		0x80U
+#define mqttCONNECT_PASSWORD		0x40U
+#define mqttCONNECT_WILL_RETAIN		0x20U
+#define mqttCONNECT_WILL			0x04U
+#define mqttCONNECT_CLEAN_SESSION	0x02U
+
+#define mqttPROTOCOL_LEVEL			4U
+
+/* The time to wait for the TCP connection and for the CONNACK. */
+#define mqttCONNECT_TIME_OUT_MS		10000U
+
+/* An entry in the offline queue: flags ( QoS and retain ), the length of the
+ * topic ( 2 bytes ) and of the payload ( 4 bytes ), followed by the topic and
+ * the payload. */
+#define mqttRECORD_HEADER_LENGTH	7U
+#define mqttRECORD_RETAIN			0x04U
+
+static BaseType_t prvTimeReached( TickType_t xTime );
+static size_t uxEncodeLength( uint8_t * pucBuffer,
+							  size_t uxLength );
+static BaseType_t prvTxWrite( MQTTClient_t * pxClient,
+							  const void * pvData,
+							  size_t uxLength );
+static BaseType_t prvSendSmall( MQTTClient_t * pxClient,
+								uint8_t ucType,
+								uint16_t usPacketID );
+static BaseType_t prvWriteString( MQTTClient_t * pxClient,
+								  const void * pvData,
+								  size_t uxLength );
+static uint16_t usNewPacketID( MQTTClient_t * pxClient );
+static MQTTInflight_t * pxFindInflight( MQTTClient_t * pxClient,
+										uint16_t usPacketID );
+static void prvBuildPublish( uint8_t * pucTarget,
+							 const uint8_t * pucHeader,
+							 size_t uxHeaderLength,
+							 const char * pcTopic,
+							 size_t uxTopicLength,
+							 uint16_t usPacketID,
+							 const uint8_t * pucPayload,
+							 size_t uxLength );
+static BaseType_t prvWritePublish( MQTTClient_t * pxClient,
+								   const char * pcTopic,
+								   size_t uxTopicLength,
+								   const uint8_t * pucPayload,
+								   size_t uxLength,
+								   uint8_t ucQoS,
+								   BaseType_t xRetain );
+static BaseType_t prvSendSubscribe( MQTTClient_t * pxClient,
+									uint8_t ucType,
+									const char * pcTopicFilter,
+									uint8_t ucQoS );
+static void prvQueueRead( const MQTTClient_t * pxClient,
+						  size_t uxOffset,
+						  uint8_t * pucTarget,
+						  size_t uxLength );
+static BaseType_t prvQueuePush( MQTTClient_t * pxClient,
+								const char * pcTopic,
+								size_t uxTopicLength,
+								const uint8_t * pucPayload,
+								size_t uxLength,
+								uint8_t ucQoS,
+								BaseType_t xRetain );
+static BaseType_t prvQueueIsEmpty( const MQTTClient_t * pxClient );
+static void prvQueueSend( MQTTClient_t * pxClient );
+static void prvConnect( MQTTClient_t * pxClient );
+static void prvCloseConnection( MQTTClient_t * pxClient,
+								const char * pcReason );
+static void prvHandlePacket( MQTTClient_t * pxClient,
+							 uint8_t ucHeader,
+							 const uint8_t * pucData,
+							 size_t uxLength );
+static void prvReceive( MQTTClient_t * pxClient,
+						TickType_t xBlockingTime );
+static void prvCheckTimers( MQTTClient_t * pxClient );
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvTimeReached( TickType_t xTime )
+{
+TickType_t xDifference = xTaskGetTickCount() - xTime;
+
+	/* The time was reached if the difference is "positive". */
+	return ( xDifference < ( portMAX_DELAY / 2U ) ) ? pdTRUE : pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+static size_t uxEncodeLength( uint8_t * pucBuffer,
+							  size_t uxLength )
+{
+size_t uxCount = 0U;
+
+	do
+	{
+		uint8_t ucByte = ( uint8_t ) ( uxLength & 0x7FU );
+
+		uxLength >>= 7;
+
+		if( uxLength != 0U )
+		{
+			ucByte |= 0x80U;
+		}
+
+		pucBuffer[ uxCount ] = ucByte;
+		uxCount++;
+	} while( ( uxLength != 0U ) && ( uxCount < 4U ) );
+
+	return uxCount;
+}
+/*-----------------------------------------------------------*/
+
+/* Copy data directly into the TX stream of the socket. The caller has
+ * checked that there is enough space. */
+static BaseType_t prvTxWrite( MQTTClient_t * pxClient,
+							  const void * pvData,
+							  size_t uxLength )
+{
+const uint8_t * pucSource = ( const uint8_t * ) pvData;
+BaseType_t xResult = pdPASS;
+
+	while( uxLength != 0U )
+	{
+	BaseType_t xSpace = 0;
+	uint8_t * pucHead = FreeRTOS_get_tx_head( pxClient->xSocket, &xSpace );
+	size_t uxCount;
+
+		if( ( pucHead == NULL ) || ( xSpace <= 0 ) )
+		{
+			xResult = pdFAIL;
+			break;
+		}
+
+		uxCount = FreeRTOS_min_size_t( uxLength, ( size_t ) xSpace );
+		( void ) memcpy( pucHead, pucSource, uxCount );
+
+		/* A NULL buffer only moves the head of the stream. */
+		if( FreeRTOS_send( pxClient->xSocket, NULL, uxCount, 0 ) != ( BaseType_t ) uxCount )
+		{
+			xResult = pdFAIL;
+			break;
+		}
+
+		pucSource = &( pucSource[ uxCount ] );
+		uxLength -= uxCount;
+	}
+
+	pxClient->xLastSend = xTaskGetTickCount();
+
+	return xResult;
+}
+/*-----------------------------------------------------------*/
+
+/* Send a packet of 2 or 4 bytes: PUBACK, PUBREC, PUBREL, PUBCOMP, PINGREQ or DISCONNECT. */
+static BaseType_t prvSendSmall( MQTTClient_t * pxClient,
+								uint8_t ucType,
+								uint16_t usPacketID )
+{
+uint8_t ucPacket[ 4 ];
+size_t uxLength = 2U;
+BaseType_t xResult = pdFAIL;
+
+	ucPacket[ 0 ] = ucType;
+	ucPacket[ 1 ] = 0U;
+
+	if( ( ucType != mqttPINGREQ ) && ( ucType != mqttDISCONNECT ) )
+	{
+		ucPacket[ 1 ] = 2U;
+		ucPacket[ 2 ] = ( uint8_t ) ( usPacketID >> 8 );
+		ucPacket[ 3 ] = ( uint8_t ) ( usPacketID & 0xFFU );
+		uxLength = 4U;
+	}
+
+	if( FreeRTOS_tx_space( pxClient->xSocket ) >= ( BaseType_t ) uxLength )
+	{
+		xResult = prvTxWrite( pxClient, ucPacket, uxLength );
+	}
+
+	return xResult;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvWriteString( MQTTClient_t * pxClient,
+								  const void * pvData,
+								  size_t uxLength )
+{
+uint8_t ucLength[ 2 ];
+
+	ucLength[ 0 ] = ( uint8_t ) ( uxLength >> 8 );
+	ucLength[ 1 ] = ( uint8_t ) ( uxLength & 0xFFU );
+
+	if( prvTxWrite( pxClient, ucLength, sizeof( ucLength ) ) == pdFAIL )
+	{
+		return pdFAIL;
+	}
+
+	return prvTxWrite( pxClient, pvData, uxLength );
+}
+/*-----------------------------------------------------------*/
+
+static uint16_t usNewPacketID( MQTTClient_t * pxClient )
+{
+	do
+	{
+		pxClient->usNextPacketID++;
+	} while( ( pxClient->usNextPacketID == 0U ) || ( pxFindInflight( pxClient, pxClient->usNextPacketID ) != NULL ) );
+
+	return pxClient->usNextPacketID;
+}
+/*-----------------------------------------------------------*/
+
+/* Find an outgoing message by its packet ID, or a free entry when the ID is zero. */
+static MQTTInflight_t * pxFindInflight( MQTTClient_t * pxClient,
+										uint16_t usPacketID )
+{
+MQTTInflight_t * pxResult = NULL;
+BaseType_t xIndex;
+
+	for( xIndex = 0; xIndex < ARRAY_SIZE( pxClient->xInflight ); xIndex++ )
+	{
+		if( pxClient->xInflight[ xIndex ].usPacketID == usPacketID )
+		{
+			pxResult = &( pxClient->xInflight[ xIndex ] );
+			break;
+		}
+	}
+
+	return pxResult;
+}
+/*-----------------------------------------------------------*/
+
+/* Serialise a complete PUBLISH packet into a contiguous buffer. */
+static void prvBuildPublish( uint8_t * pucTarget,
+							 const uint8_t * pucHeader,
+							 size_t uxHeaderLength,
+							 const char * pcTopic,
+							 size_t uxTopicLength,
+							 uint16_t usPacketID,
+							 const uint8_t * pucPayload,
+							 size_t uxLength )
+{
+uint8_t * pucCopy = pucTarget;
+
+	( void ) memcpy( pucCopy, pucHeader, uxHeaderLength );
+	pucCopy = &( pucCopy[ uxHeaderLength ] );
+	pucCopy[ 0 ] = ( uint8_t ) ( uxTopicLength >> 8 );
+	pucCopy[ 1 ] = ( uint8_t ) ( uxTopicLength & 0xFFU );
+	( void ) memcpy( &( pucCopy[ 2 ] ), pcTopic, uxTopicLength );
+	pucCopy = &( pucCopy[ 2U + uxTopicLength ] );
+
+	/* Only QoS 1 and 2 messages have a packet ID. */
+	if( usPacketID != 0U )
+	{
+		pucCopy[ 0 ] = ( uint8_t ) ( usPacketID >> 8 );
+		pucCopy[ 1 ] = ( uint8_t ) ( usPacketID & 0xFFU );
+		pucCopy = &( pucCopy[ 2 ] );
+	}
+
+	if( uxLength != 0U )
+	{
+		( void ) memcpy( pucCopy, pucPayload, uxLength );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvWritePublish( MQTTClient_t * pxClient,
+								   const char * pcTopic,
+								   size_t uxTopicLength,
+								   const uint8_t * pucPayload,
+								   size_t uxLength,
+								   uint8_t ucQoS,
+								   BaseType_t xRetain )
+{
+uint8_t ucHeader[ 7 ];
+size_t uxHeaderLength, uxRemaining, uxTotal;
+MQTTInflight_t * pxInflight = NULL;
+uint8_t * pucPacket = NULL;
+uint8_t * pucHead;
+BaseType_t xSpace = 0;
+BaseType_t xResult = pdFAIL;
+uint16_t usPacketID = 0U;
+
+	uxRemaining = 2U + uxTopicLength + uxLength + ( ( ucQoS != 0U ) ? 2U : 0U );
+
+	ucHeader[ 0 ] = ( uint8_t ) ( mqttPUBLISH | ( ucQoS << 1 ) );
+
+	if( xRetain != pdFALSE )
+	{
+		ucHeader[ 0 ] |= mqttPUBLISH_RETAIN;
+	}
+
+	uxHeaderLength = 1U + uxEncodeLength( &( ucHeader[ 1 ] ), uxRemaining );
+	uxTotal = uxHeaderLength + uxRemaining;
+
+	if( ( pxClient->eState != eMQTTConnected ) || ( FreeRTOS_tx_space( pxClient->xSocket ) < ( BaseType_t ) uxTotal ) )
+	{
+		return pdFAIL;
+	}
+
+	if( ucQoS != 0U )
+	{
+		/* The free entry is only claimed once the packet is in the TX stream,
+		 * so that a failure doesn't leave a message that would be sent again
+		 * next to the copy that the caller queues. */
+		pxInflight = pxFindInflight( pxClient, 0U );
+
+		if( pxInflight == NULL )
+		{
+			return pdFAIL;
+		}
+
+		/* Keep a copy of the packet for a retransmission. */
+		pucPacket = ( uint8_t * ) pvPortMalloc( uxTotal );
+
+		if( pucPacket == NULL )
+		{
+			return pdFAIL;
+		}
+
+		usPacketID = usNewPacketID( pxClient );
+	}
+
+	pucHead = FreeRTOS_get_tx_head( pxClient->xSocket, &xSpace );
+
+	if( ( pucHead != NULL ) && ( xSpace >= ( BaseType_t ) uxTotal ) )
+	{
+		/* The packet is built in the TX stream, and only committed when it
+		 * is complete: nothing has to be undone when it fails. */
+		prvBuildPublish( pucHead, ucHeader, uxHeaderLength, pcTopic, uxTopicLength, usPacketID, pucPayload, uxLength );
+
+		if( pucPacket != NULL )
+		{
+			( void ) memcpy( pucPacket, pucHead, uxTotal );
+		}
+
+		/* A NULL buffer only moves the head of the stream. */
+		if( FreeRTOS_send( pxClient->xSocket, NULL, uxTotal, 0 ) == ( BaseType_t ) uxTotal )
+		{
+			pxClient->xLastSend = xTaskGetTickCount();
+			xResult = pdPASS;
+		}
+	}
+	else if( pucPacket != NULL )
+	{
+		/* The packet wraps around the end of the TX stream. */
+		prvBuildPublish( pucPacket, ucHeader, uxHeaderLength, pcTopic, uxTopicLength, usPacketID, pucPayload, uxLength );
+		xResult = prvTxWrite( pxClient, pucPacket, uxTotal );
+	}
+	else
+	{
+		/* QoS 0: the topic and payload are copied straight into the TX stream. */
+		if( ( prvTxWrite( pxClient, ucHeader, uxHeaderLength ) == pdPASS ) &&
+			( prvWriteString( pxClient, pcTopic, uxTopicLength ) == pdPASS ) &&
+			( ( uxLength == 0U ) || ( prvTxWrite( pxClient, pucPayload, uxLength ) == pdPASS ) ) )
+		{
+			xResult = pdPASS;
+		}
+	}
+
+	if( xResult == pdFAIL )
+	{
+		if( pucPacket != NULL )
+		{
+			vPortFree( pucPacket );
+		}
+
+		/* There was enough space, so the connection must be broken. A part
+		 * of the packet may be in the stream: drop it together with the
+		 * socket, and start all over. */
+		prvCloseConnection( pxClient, "send" );
+	}
+	else if( pxInflight != NULL )
+	{
+		pxInflight->pucPacket = pucPacket;
+		pxInflight->uxLength = uxTotal;
+		pxInflight->usPacketID = usPacketID;
+		pxInflight->ucExpect = ( ucQoS == 1U ) ? mqttPUBACK : mqttPUBREC;
+		pxInflight->xSentTime = xTaskGetTickCount();
+	}
+	else
+	{
+		/* QoS 0 is not acknowledged. */
+	}
+
+	return xResult;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvSendSubscribe( MQTTClient_t * pxClient,
+									uint8_t ucType,
+									const char * pcTopicFilter,
+									uint8_t ucQoS )
+{
+uint8_t ucHeader[ 7 ];
+size_t uxTopicLength = strlen( pcTopicFilter );
+size_t uxRemaining = 2U + 2U + uxTopicLength + ( ( ucType == mqttSUBSCRIBE ) ? 1U : 0U );
+size_t uxHeaderLength;
+uint16_t usPacketID = usNewPacketID( pxClient );
+BaseType_t xResult;
+
+	ucHeader[ 0 ] = ucType;
+	uxHeaderLength = 1U + uxEncodeLength( &( ucHeader[ 1 ] ), uxRemaining );
+	ucHeader[ uxHeaderLength ] = ( uint8_t ) ( usPacketID >> 8 );
+	ucHeader[ uxHeaderLength + 1U ] = ( uint8_t ) ( usPacketID & 0xFFU );
+
+	if( FreeRTOS_tx_space( pxClient->xSocket ) < ( BaseType_t ) ( uxHeaderLength + uxRemaining ) )
+	{
+		return pdFAIL;
+	}
+
+	xResult = prvTxWrite( pxClient, ucHeader, uxHeaderLength + 2U );
+
+	if( xResult == pdPASS )
+	{
+		xResult = prvWriteString( pxClient, pcTopicFilter, uxTopicLength );
+	}
+
+	if( ( xResult == pdPASS ) && ( ucType == mqttSUBSCRIBE ) )
+	{
+		xResult = prvTxWrite( pxClient, &ucQoS, 1U );
+	}
+
+	return xResult;
+}
+/*-----------------------------------------------------------*/
+
+static void prvQueueRead( const MQTTClient_t * pxClient,
+						  size_t uxOffset,
+						  uint8_t * pucTarget,
+						  size_t uxLength )
+{
+size_t uxIndex = pxClient->uxQueueTail + uxOffset;
+size_t uxFirst;
+
+	if( uxIndex >= sizeof( pxClient->ucQueue ) )
+	{
+		uxIndex -= sizeof( pxClient->ucQueue );
+	}
+
+	uxFirst = FreeRTOS_min_size_t( uxLength, sizeof( pxClient->ucQueue ) - uxIndex );
+	( void ) memcpy( pucTarget, &( pxClient->ucQueue[ uxIndex ] ), uxFirst );
+
+	if( uxLength > uxFirst )
+	{
+		( void ) memcpy( &( pucTarget[ uxFirst ] ), pxClient->ucQueue, uxLength - uxFirst );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvQueuePush( MQTTClient_t * pxClient,
+								const char * pcTopic,
+								size_t uxTopicLength,
+								const uint8_t * pucPayload,
+								size_t uxLength,
+								uint8_t ucQoS,
+								BaseType_t xRetain )
+{
+uint8_t ucRecord[ mqttRECORD_HEADER_LENGTH ];
+size_t uxRecordLength = mqttRECORD_HEADER_LENGTH + uxTopicLength + uxLength;
+BaseType_t xUseRAM = pdTRUE;
+
+	ucRecord[ 0 ] = ( uint8_t ) ( ucQoS | ( ( xRetain != pdFALSE ) ? mqttRECORD_RETAIN : 0U ) );
+	ucRecord[ 1 ] = ( uint8_t ) ( uxTopicLength >> 8 );
+	ucRecord[ 2 ] = ( uint8_t ) ( uxTopicLength & 0xFFU );
+	ucRecord[ 3 ] = ( uint8_t ) ( ( uint32_t ) uxLength >> 24 );
+	ucRecord[ 4 ] = ( uint8_t ) ( ( ( uint32_t ) uxLength >> 16 ) & 0xFFU );
+	ucRecord[ 5 ] = ( uint8_t ) ( ( ( uint32_t ) uxLength >> 8 ) & 0xFFU );
+	ucRecord[ 6 ] = ( uint8_t ) ( uxLength & 0xFFU );
+
+	#if ( ipconfigMQTT_USE_PLUS_FAT != 0 )
+		{
+			/* Once messages overflow to the file, the newer ones must follow them. */
+			if( pxClient->uxSpillLength != 0U )
+			{
+				xUseRAM = pdFALSE;
+			}
+		}
+	#endif
+
+	if( ( xUseRAM != pdFALSE ) && ( ( sizeof( pxClient->ucQueue ) - pxClient->uxQueueUsed ) >= uxRecordLength ) )
+	{
+	const uint8_t * pucParts[ 3 ] = { ucRecord, ( const uint8_t * ) pcTopic, pucPayload };
+	size_t uxLengths[ 3 ] = { sizeof( ucRecord ), uxTopicLength, uxLength };
+	BaseType_t xPart;
+
+		for( xPart = 0; xPart < 3; xPart++ )
+		{
+		size_t uxCount = uxLengths[ xPart ];
+		size_t uxFirst = FreeRTOS_min_size_t( uxCount, sizeof( pxClient->ucQueue ) - pxClient->uxQueueHead );
+
+			if( uxCount == 0U )
+			{
+				continue;
+			}
+
+			( void ) memcpy( &( pxClient->ucQueue[ pxClient->uxQueueHead ] ), pucParts[ xPart ], uxFirst );
+
+			if( uxCount > uxFirst )
+			{
+				( void ) memcpy( pxClient->ucQueue, &( pucParts[ xPart ][ uxFirst ] ), uxCount - uxFirst );
+			}
+
+			pxClient->uxQueueHead += uxCount;
+
+			if( pxClient->uxQueueHead >= sizeof( pxClient->ucQueue ) )
+			{
+				pxClient->uxQueueHead -= sizeof( pxClient->ucQueue );
+			}
+		}
+
+		pxClient->uxQueueUsed += uxRecordLength;
+
+		return pdPASS;
+	}
+
+	#if ( ipconfigMQTT_USE_PLUS_FAT != 0 )
+		{
+		FF_FILE * pxFile = ff_fopen( ipconfigMQTT_SPILL_FILE_NAME, "ab" );
+
+			if( pxFile != NULL )
+			{
+			size_t uxWritten;
+
+				uxWritten = ff_fwrite( ucRecord, 1, sizeof( ucRecord ), pxFile );
+				uxWritten += ff_fwrite( pcTopic, 1, uxTopicLength, pxFile );
+
+				if( uxLength != 0U )
+				{
+					uxWritten += ff_fwrite( pucPayload, 1, uxLength, pxFile );
+				}
+
+				pxClient->uxSpillLength = ff_filelength( pxFile );
+				( void ) ff_fclose( pxFile );
+
+				if( uxWritten == uxRecordLength )
+				{
+					return pdPASS;
+				}
+
+				FreeRTOS_printf( ( "MQTT: writing %s failed\n", ipconfigMQTT_SPILL_FILE_NAME ) );
+			}
+		}
+	#endif /* ipconfigMQTT_USE_PLUS_FAT */
+
+	pxClient->ulDropped++;
+
+	return pdFAIL;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvQueueIsEmpty( const MQTTClient_t * pxClient )
+{
+BaseType_t xResult = ( pxClient->uxQueueUsed == 0U ) ? pdTRUE : pdFALSE;
+
+	#if ( ipconfigMQTT_USE_PLUS_FAT != 0 )
+		{
+			if( pxClient->uxSpillLength != 0U )
+			{
+				xResult = pdFALSE;
+			}
+		}
+	#endif
+
+	return xResult;
+}
+/*-----------------------------------------------------------*/
+
+/* Send queued messages as long as the in-flight window and the TX stream allow it. */
+static void prvQueueSend( MQTTClient_t * pxClient )
+{
+uint8_t ucRecord[ mqttRECORD_HEADER_LENGTH ];
+BaseType_t xFromRAM;
+
+	while( ( pxClient->eState == eMQTTConnected ) && ( prvQueueIsEmpty( pxClient ) == pdFALSE ) )
+	{
+	size_t uxTopicLength, uxLength, uxBodyLength;
+	uint8_t ucQoS;
+	uint8_t * pucBody;
+	BaseType_t xSent;
+
+		#if ( ipconfigMQTT_USE_PLUS_FAT != 0 )
+			FF_FILE * pxFile = NULL;
+		#endif
+
+		xFromRAM = ( pxClient->uxQueueUsed != 0U ) ? pdTRUE : pdFALSE;
+
+		if( xFromRAM != pdFALSE )
+		{
+			prvQueueRead( pxClient, 0U, ucRecord, sizeof( ucRecord ) );
+		}
+
+		#if ( ipconfigMQTT_USE_PLUS_FAT != 0 )
+			else
+			{
+				pxFile = ff_fopen( ipconfigMQTT_SPILL_FILE_NAME, "rb" );
+
+				if( ( pxFile == NULL ) ||
+					( ff_fseek( pxFile, ( long ) pxClient->uxSpillReadOffset, FF_SEEK_SET ) != 0 ) ||
+					( ff_fread( ucRecord, 1, sizeof( ucRecord ), pxFile ) != sizeof( ucRecord ) ) )
+				{
+					FreeRTOS_printf( ( "MQTT: reading %s failed\n", ipconfigMQTT_SPILL_FILE_NAME ) );
+
+					if( pxFile != NULL )
+					{
+						( void ) ff_fclose( pxFile );
+					}
+
+					( void ) ff_remove( ipconfigMQTT_SPILL_FILE_NAME );
+					pxClient->uxSpillLength = 0U;
+					pxClient->uxSpillReadOffset = 0U;
+					break;
+				}
+			}
+		#endif /* ipconfigMQTT_USE_PLUS_FAT */
+
+		ucQoS = ucRecord[ 0 ] & 0x03U;
+		uxTopicLength = ( ( size_t ) ucRecord[ 1 ] << 8 ) | ucRecord[ 2 ];
+		uxLength = ( ( size_t ) ucRecord[ 3 ] << 24 ) | ( ( size_t ) ucRecord[ 4 ] << 16 ) |
+				   ( ( size_t ) ucRecord[ 5 ] << 8 ) | ucRecord[ 6 ];
+		uxBodyLength = uxTopicLength + uxLength;
+
+		pucBody = NULL;
+
+		if( ( ucQoS == 0U ) || ( pxFindInflight( pxClient, 0U ) != NULL ) )
+		{
+			pucBody = ( uint8_t * ) pvPortMalloc( uxBodyLength + 1U );
+		}
+
+		if( pucBody != NULL )
+		{
+			if( xFromRAM != pdFALSE )
+			{
+				prvQueueRead( pxClient, sizeof( ucRecord ), pucBody, uxBodyLength );
+			}
+
+			#if ( ipconfigMQTT_USE_PLUS_FAT != 0 )
+				else
+				{
+					( void ) ff_fread( pucBody, 1, uxBodyLength, pxFile );
+				}
+			#endif
+		}
+
+		#if ( ipconfigMQTT_USE_PLUS_FAT != 0 )
+			if( pxFile != NULL )
+			{
+				( void ) ff_fclose( pxFile );
+			}
+		#endif
+
+		if( pucBody == NULL )
+		{
+			/* No room in the in-flight window, or no memory. */
+			break;
+		}
+
+		xSent = prvWritePublish( pxClient, ( const char * ) pucBody, uxTopicLength, &( pucBody[ uxTopicLength ] ), uxLength,
+								 ucQoS, ( ( ucRecord[ 0 ] & mqttRECORD_RETAIN ) != 0U ) ? pdTRUE : pdFALSE );
+		vPortFree( pucBody );
+
+		if( xSent == pdFAIL )
+		{
+			/* Try again later, the TX stream is full. */
+			break;
+		}
+
+		if( xFromRAM != pdFALSE )
+		{
+			pxClient->uxQueueTail += sizeof( ucRecord ) + uxBodyLength;
+
+			if( pxClient->uxQueueTail >= sizeof( pxClient->ucQueue ) )
+			{
+				pxClient->uxQueueTail -= sizeof( pxClient->ucQueue );
+			}
+
+			pxClient->uxQueueUsed -= sizeof( ucRecord ) + uxBodyLength;
+		}
+
+		#if ( ipconfigMQTT_USE_PLUS_FAT != 0 )
+			else
+			{
+				pxClient->uxSpillReadOffset += sizeof( ucRecord ) + uxBodyLength;
+
+				if( pxClient->uxSpillReadOffset >= pxClient->uxSpillLength )
+				{
+					( void ) ff_remove( ipconfigMQTT_SPILL_FILE_NAME );
+					pxClient->uxSpillLength = 0U;
+					pxClient->uxSpillReadOffset = 0U;
+				}
+			}
+		#endif
+	}
+}
+/*-----------------------------------------------------------*/
+
+void FreeRTOS_MQTTInit( MQTTClient_t * pxClient,
+						const struct freertos_sockaddr * pxBroker,
+						const MQTTConnectInfo_t * pxInfo,
+						FMQTTMessage fOnMessage,
+						void * pvContext )
+{
+uint32_t ulRandom = 0U;
+
+	( void ) memset( pxClient, 0, sizeof( *pxClient ) );
+	( void ) memcpy( &( pxClient->xBroker ), pxBroker, sizeof( pxClient->xBroker ) );
+	( void ) memcpy( &( pxClient->xInfo ), pxInfo, sizeof( pxClient->xInfo ) );
+	pxClient->fOnMessage = fOnMessage;
+	pxClient->pvContext = pvContext;
+	pxClient->xSocket = FREERTOS_INVALID_SOCKET;
+	pxClient->eState = eMQTTDisconnected;
+	pxClient->xReconnectTime = xTaskGetTickCount();
+	pxClient->ulBackoffMS = ipconfigMQTT_BACKOFF_MIN_MS;
+
+	( void ) xApplicationGetRandomNumber( &ulRandom );
+	pxClient->usNextPacketID = ( uint16_t ) ulRandom;
+
+	#if ( ipconfigMQTT_USE_PLUS_FAT != 0 )
+		{
+		FF_FILE * pxFile = ff_fopen( ipconfigMQTT_SPILL_FILE_NAME, "rb" );
+
+			/* Messages that were queued before a restart will be sent too. */
+			if( pxFile != NULL )
+			{
+				pxClient->uxSpillLength = ff_filelength( pxFile );
+				( void ) ff_fclose( pxFile );
+			}
+		}
+	#endif
+}
+/*-----------------------------------------------------------*/
+
+static void prvConnect( MQTTClient_t * pxClient )
+{
+TickType_t xTimeout = pdMS_TO_TICKS( mqttCONNECT_TIME_OUT_MS );
+const MQTTConnectInfo_t * pxInfo = &( pxClient->xInfo );
+uint8_t ucHeader[ 5 + 10 ];
+size_t uxRemaining, uxHeaderLength;
+uint8_t ucFlags = 0U;
+
+	pxClient->xSocket = FreeRTOS_socket( FREERTOS_AF_INET, FREERTOS_SOCK_STREAM, FREERTOS_IPPROTO_TCP );
+
+	if( xSocketValid( pxClient->xSocket ) == pdFALSE )
+	{
+		prvCloseConnection( pxClient, "socket" );
+		return;
+	}
+
+	( void ) FreeRTOS_setsockopt( pxClient->xSocket, 0, FREERTOS_SO_RCVTIMEO, &xTimeout, sizeof( xTimeout ) );
+
+	if( FreeRTOS_connect( pxClient->xSocket, &( pxClient->xBroker ), sizeof( pxClient->xBroker ) ) != 0 )
+	{
+		prvCloseConnection( pxClient, "connect" );
+		return;
+	}
+
+	uxRemaining = 10U + 2U + strlen( pxInfo->pcClientID );
+
+	if( pxInfo->xCleanSession != pdFALSE )
+	{
+		ucFlags |= mqttCONNECT_CLEAN_SESSION;
+	}
+
+	if( pxInfo->pcWillTopic != NULL )
+	{
+		ucFlags |= ( uint8_t ) ( mqttCONNECT_WILL | ( pxInfo->ucWillQoS << 3 ) );
+
+		if( pxInfo->xWillRetain != pdFALSE )
+		{
+			ucFlags |= mqttCONNECT_WILL_RETAIN;
+		}
+
+		uxRemaining += 2U + strlen( pxInfo->pcWillTopic ) + 2U + pxInfo->usWillLength;
+	}
+
+	if( pxInfo->pcUserName != NULL )
+	{
+		ucFlags |= mqttCONNECT_USER_NAME;
+		uxRemaining += 2U + strlen( pxInfo->pcUserName );
+
+		if( pxInfo->pcPassword != NULL )
+		{
+			ucFlags |= mqttCONNECT_PASSWORD;
+			uxRemaining += 2U + strlen( pxInfo->pcPassword );
+		}
+	}
+
+	/* Fixed header and variable header. */
+	ucHeader[ 0 ] = mqttCONNECT;
+	uxHeaderLength = 1U + uxEncodeLength( &( ucHeader[ 1 ] ), uxRemaining );
+	ucHeader[ uxHeaderLength++ ] = 0U;
+	ucHeader[ uxHeaderLength++ ] = 4U;
+	( void ) memcpy( &( ucHeader[ uxHeaderLength ] ), "MQTT", 4U );
+	uxHeaderLength += 4U;
+	ucHeader[ uxHeaderLength++ ] = mqttPROTOCOL_LEVEL;
+	ucHeader[ uxHeaderLength++ ] = ucFlags;
+	ucHeader[ uxHeaderLength++ ] = ( uint8_t ) ( pxInfo->usKeepAliveSeconds >> 8 );
+	ucHeader[ uxHeaderLength++ ] = ( uint8_t ) ( pxInfo->usKeepAliveSeconds & 0xFFU );
+
+	/* The new stream has plenty of space for a normal CONNECT packet. */
+	if( ( FreeRTOS_tx_space( pxClient->xSocket ) < ( BaseType_t ) ( uxRemaining + 5U ) ) ||
+		( prvTxWrite( pxClient, ucHeader, uxHeaderLength ) == pdFAIL ) ||
+		( prvWriteString( pxClient, pxInfo->pcClientID, strlen( pxInfo->pcClientID ) ) == pdFAIL ) ||
+		( ( pxInfo->pcWillTopic != NULL ) &&
+		  ( ( prvWriteString( pxClient, pxInfo->pcWillTopic, strlen( pxInfo->pcWillTopic ) ) == pdFAIL ) ||
+			( prvWriteString( pxClient, pxInfo->pucWillMessage, pxInfo->usWillLength ) == pdFAIL ) ) ) ||
+		( ( pxInfo->pcUserName != NULL ) &&
+		  ( prvWriteString( pxClient, pxInfo->pcUserName, strlen( pxInfo->pcUserName ) ) == pdFAIL ) ) ||
+		( ( pxInfo->pcUserName != NULL ) && ( pxInfo->pcPassword != NULL ) &&
+		  ( prvWriteString( pxClient, pxInfo->pcPassword, strlen( pxInfo->pcPassword ) ) == pdFAIL ) ) )
+	{
+		prvCloseConnection( pxClient, "CONNECT" );
+		return;
+	}
+
+	pxClient->eState = eMQTTWaitConnAck;
+	pxClient->xLastReceive = xTaskGetTickCount();
+	pxClient->uxRxLength = 0U;
+	pxClient->uxRxSkip = 0U;
+	pxClient->xPingOutstanding = pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+static void prvCloseConnection( MQTTClient_t * pxClient,
+								const char * pcReason )
+{
+uint32_t ulRandom = 0U;
+uint32_t ulDelayMS;
+
+	FreeRTOS_printf( ( "MQTT: connection closed (%s), retry in %u ms\n", pcReason, ( unsigned ) pxClient->ulBackoffMS ) );
+
+	if( xSocketValid( pxClient->xSocket ) != pdFALSE )
+	{
+		( void ) FreeRTOS_closesocket( pxClient->xSocket );
+	}
+
+	pxClient->xSocket = FREERTOS_INVALID_SOCKET;
+	pxClient->eState = eMQTTDisconnected;
+
+	/* Wait a little longer after every failure, with a random part to
+	 * prevent devices from reconnecting all at the same time. */
+	( void ) xApplicationGetRandomNumber( &ulRandom );
+	ulDelayMS = pxClient->ulBackoffMS + ( ulRandom % ( ( pxClient->ulBackoffMS / 4U ) + 1U ) );
+	pxClient->xReconnectTime = xTaskGetTickCount() + pdMS_TO_TICKS( ulDelayMS );
+
+	pxClient->ulBackoffMS *= 2U;
+
+	if( pxClient->ulBackoffMS > ipconfigMQTT_BACKOFF_MAX_MS )
+	{
+		pxClient->ulBackoffMS = ipconfigMQTT_BACKOFF_MAX_MS;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvHandlePacket( MQTTClient_t * pxClient,
+							 uint8_t ucHeader,
+							 const uint8_t * pucData,
+							 size_t uxLength )
+{
+uint8_t ucType = ucHeader & 0xF0U;
+uint16_t usPacketID = 0U;
+MQTTInflight_t * pxInflight;
+BaseType_t xIndex;
+
+	if( uxLength >= 2U )
+	{
+		usPacketID = ( uint16_t ) ( ( ( uint16_t ) pucData[ 0 ] << 8 ) | pucData[ 1 ] );
+	}
+
+	if( ( pxClient->eState == eMQTTWaitConnAck ) && ( ucType != mqttCONNACK ) )
+	{
+		prvCloseConnection( pxClient, "expected CONNACK" );
+		return;
+	}
+
+	switch( ucType )
+	{
+		case mqttCONNACK:
+
+			if( ( uxLength < 2U ) || ( pucData[ 1 ] != 0U ) )
+			{
+				FreeRTOS_printf( ( "MQTT: connection refused (%u)\n", ( uxLength >= 2U ) ? pucData[ 1 ] : 0xFFU ) );
+				prvCloseConnection( pxClient, "CONNACK" );
+				break;
+			}
+
+			pxClient->eState = eMQTTConnected;
+			pxClient->ulBackoffMS = ipconfigMQTT_BACKOFF_MIN_MS;
+
+			if( ( pucData[ 0 ] & 0x01U ) == 0U )
+			{
+				/* No session present: forget the incoming QoS 2 state. */
+				( void ) memset( pxClient->usInboundQoS2, 0, sizeof( pxClient->usInboundQoS2 ) );
+			}
+
+			for( xIndex = 0; xIndex < ARRAY_SIZE( pxClient->pcSubscriptions ); xIndex++ )
+			{
+				if( pxClient->pcSubscriptions[ xIndex ] != NULL )
+				{
+					( void ) prvSendSubscribe( pxClient, mqttSUBSCRIBE, pxClient->pcSubscriptions[ xIndex ], pxClient->ucSubscriptionQoS[ xIndex ] );
+				}
+			}
+
+			/* Unacknowledged messages are sent again right away. */
+			for( xIndex = 0; xIndex < ARRAY_SIZE( pxClient->xInflight ); xIndex++ )
+			{
+				pxClient->xInflight[ xIndex ].xSentTime = xTaskGetTickCount() - pdMS_TO_TICKS( ipconfigMQTT_RETRY_TIME_MS );
+			}
+
+			FreeRTOS_printf( ( "MQTT: connected\n" ) );
+			break;
+
+		case mqttPUBLISH:
+			{
+				uint8_t ucQoS = ( uint8_t ) ( ( ucHeader >> 1 ) & 0x03U );
+				size_t uxTopicLength = usPacketID;
+				size_t uxOffset = 2U + uxTopicLength + ( ( ucQoS != 0U ) ? 2U : 0U );
+				BaseType_t xDeliver = pdTRUE;
+				BaseType_t xAcknowledge = pdTRUE;
+
+				if( ( uxLength < 2U ) || ( uxOffset > uxLength ) || ( ucQoS > 2U ) )
+				{
+					prvCloseConnection( pxClient, "malformed PUBLISH" );
+					break;
+				}
+
+				if( ucQoS != 0U )
+				{
+					usPacketID = ( uint16_t ) ( ( ( uint16_t ) pucData[ uxOffset - 2U ] << 8 ) | pucData[ uxOffset - 1U ] );
+				}
+
+				if( ucQoS == 2U )
+				{
+					/* A QoS 2 message is delivered once, until the PUBREL arrives. */
+					for( xIndex = 0; xIndex < ARRAY_SIZE( pxClient->usInboundQoS2 ); xIndex++ )
+					{
+						if( pxClient->usInboundQoS2[ xIndex ] == usPacketID )
+						{
+							xDeliver = pdFALSE;
+							break;
+						}
+					}
+
+					if( xDeliver != pdFALSE )
+					{
+						for( xIndex = 0; xIndex < ARRAY_SIZE( pxClient->usInboundQoS2 ); xIndex++ )
+						{
+							if( pxClient->usInboundQoS2[ xIndex ] == 0U )
+							{
+								pxClient->usInboundQoS2[ xIndex ] = usPacketID;
+								break;
+							}
+						}
+
+						if( xIndex == ARRAY_SIZE( pxClient->usInboundQoS2 ) )
+						{
+							/* The message can not be recorded, so it would be
+							 * delivered again when the PUBLISH is repeated. Don't
+							 * deliver it and don't send a PUBREC: the broker will
+							 * send it again once a PUBREL has freed an entry. */
+							FreeRTOS_printf( ( "MQTT: QoS 2 message %u dropped, table full\n", usPacketID ) );
+							xDeliver = pdFALSE;
+							xAcknowledge = pdFALSE;
+						}
+					}
+				}
+
+				if( ( xDeliver != pdFALSE ) && ( pxClient->fOnMessage != NULL ) )
+				{
+					pxClient->fOnMessage( pxClient->pvContext, ( const char * ) &( pucData[ 2 ] ), uxTopicLength,
+										 &( pucData[ uxOffset ] ), uxLength - uxOffset, ucQoS );
+				}
+
+				if( ucQoS == 1U )
+				{
+					( void ) prvSendSmall( pxClient, mqttPUBACK, usPacketID );
+				}
+				else if( ( ucQoS == 2U ) && ( xAcknowledge != pdFALSE ) )
+				{
+					( void ) prvSendSmall( pxClient, mqttPUBREC, usPacketID );
+				}
+				else
+				{
+					/* QoS 0 is not acknowledged. */
+				}
+			}
+			break;
+
+		case mqttPUBACK:
+		case mqttPUBREC:
+		case mqttPUBCOMP:
+			pxInflight = pxFindInflight( pxClient, usPacketID );
+
+			if( ( usPacketID == 0U ) || ( pxInflight == NULL ) || ( pxInflight->ucExpect != ucType ) )
+			{
+				if( ucType == mqttPUBREC )
+				{
+					( void ) prvSendSmall( pxClient, mqttPUBREL, usPacketID );
+				}
+
+				break;
+			}
+
+			if( pxInflight->pucPacket != NULL )
+			{
+				vPortFree( pxInflight->pucPacket );
+				pxInflight->pucPacket = NULL;
+			}
+
+			if( ucType == mqttPUBREC )
+			{
+				/* The message won't be sent again, only the PUBREL. */
+				pxInflight->ucExpect = mqttPUBCOMP;
+				pxInflight->xSentTime = xTaskGetTickCount();
+				( void ) prvSendSmall( pxClient, mqttPUBREL, usPacketID );
+			}
+			else
+			{
+				pxInflight->usPacketID = 0U;
+			}
+
+			break;
+
+		case ( mqttPUBREL & 0xF0U ):
+
+			for( xIndex = 0; xIndex < ARRAY_SIZE( pxClient->usInboundQoS2 ); xIndex++ )
+			{
+				if( pxClient->usInboundQoS2[ xIndex ] == usPacketID )
+				{
+					pxClient->usInboundQoS2[ xIndex ] = 0U;
+				}
+			}
+
+			( void ) prvSendSmall( pxClient, mqttPUBCOMP, usPacketID );
+			break;
+
+		case mqttSUBACK:
+
+			if( ( uxLength > 2U ) && ( pucData[ 2 ] == 0x80U ) )
+			{
+				FreeRTOS_printf( ( "MQTT: subscription %u refused\n", usPacketID ) );
+			}
+
+			break;
+
+		case mqttPINGRESP:
+			pxClient->xPingOutstanding = pdFALSE;
+			break;
+
+		default:
+			/* UNSUBACK, or something unexpected. */
+			break;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvReceive( MQTTClient_t * pxClient,
+						TickType_t xBlockingTime )
+{
+BaseType_t xCount;
+
+	( void ) FreeRTOS_setsockopt( pxClient->xSocket, 0, FREERTOS_SO_RCVTIMEO, &xBlockingTime, sizeof( xBlockingTime ) );
+	xCount = FreeRTOS_recv( pxClient->xSocket, &( pxClient->ucRxBuffer[ pxClient->uxRxLength ] ),
+							sizeof( pxClient->ucRxBuffer ) - pxClient->uxRxLength, 0 );
+
+	if( xCount < 0 )
+	{
+		prvCloseConnection( pxClient, "recv" );
+		return;
+	}
+
+	if( xCount == 0 )
+	{
+		return;
+	}
+
+	pxClient->xLastReceive = xTaskGetTickCount();
+
+	if( pxClient->uxRxSkip != 0U )
+	{
+	size_t uxSkip = FreeRTOS_min_size_t( pxClient->uxRxSkip, ( size_t ) xCount );
+
+		/* Drop the rest of a packet that was too big for the buffer. */
+		( void ) memmove( &( pxClient->ucRxBuffer[ pxClient->uxRxLength ] ),
+						  &( pxClient->ucRxBuffer[ pxClient->uxRxLength + uxSkip ] ), ( size_t ) xCount - uxSkip );
+		pxClient->uxRxSkip -= uxSkip;
+		xCount -= ( BaseType_t ) uxSkip;
+	}
+
+	pxClient->uxRxLength += ( size_t ) xCount;
+
+	while( ( pxClient->uxRxLength >= 2U ) && ( pxClient->eState != eMQTTDisconnected ) )
+	{
+	size_t uxRemaining = 0U;
+	size_t uxHeaderLength = 1U;
+	size_t uxTotal;
+	BaseType_t xComplete = pdFALSE;
+
+		/* Decode the variable length of at most 4 bytes. */
+		while( uxHeaderLength < pxClient->uxRxLength )
+		{
+		uint8_t ucByte = pxClient->ucRxBuffer[ uxHeaderLength ];
+
+			uxRemaining |= ( size_t ) ( ucByte & 0x7FU ) << ( 7U * ( uxHeaderLength - 1U ) );
+			uxHeaderLength++;
+
+			if( ( ucByte & 0x80U ) == 0U )
+			{
+				xComplete = pdTRUE;
+				break;
+			}
+
+			if( uxHeaderLength > 4U )
+			{
+				prvCloseConnection( pxClient, "bad length" );
+				return;
+			}
+		}
+
+		if( xComplete == pdFALSE )
+		{
+			break;
+		}
+
+		uxTotal = uxHeaderLength + uxRemaining;
+
+		if( uxTotal > sizeof( pxClient->ucRxBuffer ) )
+		{
+			FreeRTOS_printf( ( "MQTT: skipping a packet of %u bytes\n", ( unsigned ) uxTotal ) );
+			pxClient->uxRxSkip = uxTotal - pxClient->uxRxLength;
+			pxClient->uxRxLength = 0U;
+			break;
+		}
+
+		if( uxTotal > pxClient->uxRxLength )
+		{
+			break;
+		}
+
+		prvHandlePacket( pxClient, pxClient->ucRxBuffer[ 0 ], &( pxClient->ucRxBuffer[ uxHeaderLength ] ), uxRemaining );
+
+		pxClient->uxRxLength -= uxTotal;
+		( void ) memmove( pxClient->ucRxBuffer, &( pxClient->ucRxBuffer[ uxTotal ] ), pxClient->uxRxLength );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckTimers( MQTTClient_t * pxClient )
+{
+TickType_t xKeepAlive = pdMS_TO_TICKS( ( uint32_t ) pxClient->xInfo.usKeepAliveSeconds * 1000U );
+TickType_t xNow = xTaskGetTickCount();
+BaseType_t xIndex;
+
+	if( pxClient->eState == eMQTTWaitConnAck )
+	{
+		if( ( xNow - pxClient->xLastReceive ) > pdMS_TO_TICKS( mqttCONNECT_TIME_OUT_MS ) )
+		{
+			prvCloseConnection( pxClient, "no CONNACK" );
+		}
+
+		return;
+	}
+
+	if( xKeepAlive != 0U )
+	{
+		if( pxClient->xPingOutstanding != pdFALSE )
+		{
+			if( ( xNow - pxClient->xLastReceive ) > xKeepAlive )
+			{
+				prvCloseConnection( pxClient, "no PINGRESP" );
+				return;
+			}
+		}
+		else if( ( xNow - pxClient->xLastSend ) >= xKeepAlive )
+		{
+			if( prvSendSmall( pxClient, mqttPINGREQ, 0U ) == pdPASS )
+			{
+				pxClient->xPingOutstanding = pdTRUE;
+				pxClient->xLastReceive = xNow;
+			}
+		}
+		else
+		{
+			/* Nothing to do yet. */
+		}
+	}
+
+	for( xIndex = 0; xIndex < ARRAY_SIZE( pxClient->xInflight ); xIndex++ )
+	{
+	MQTTInflight_t * pxInflight = &( pxClient->xInflight[ xIndex ] );
+
+		if( ( pxInflight->usPacketID == 0U ) || ( ( xNow - pxInflight->xSentTime ) < pdMS_TO_TICKS( ipconfigMQTT_RETRY_TIME_MS ) ) )
+		{
+			continue;
+		}
+
+		if( pxInflight->pucPacket != NULL )
+		{
+			if( FreeRTOS_tx_space( pxClient->xSocket ) < ( BaseType_t ) pxInflight->uxLength )
+			{
+				break;
+			}
+
+			/* Send the stored PUBLISH again with the DUP flag. */
+			pxInflight->pucPacket[ 0 ] |= mqttPUBLISH_DUP;
+			( void ) prvTxWrite( pxClient, pxInflight->pucPacket, pxInflight->uxLength );
+		}
+		else
+		{
+			( void ) prvSendSmall( pxClient, mqttPUBREL, pxInflight->usPacketID );
+		}
+
+		pxInflight->xSentTime = xNow;
+	}
+}
+/*-----------------------------------------------------------*/
+
+void FreeRTOS_MQTTWork( MQTTClient_t * pxClient,
+						TickType_t xBlockingTime )
+{
+	if( pxClient->eState == eMQTTDisconnected )
+	{
+		if( prvTimeReached( pxClient->xReconnectTime ) == pdFALSE )
+		{
+		TickType_t xWait = pxClient->xReconnectTime - xTaskGetTickCount();
+
+			vTaskDelay( FreeRTOS_min_uint32( xWait, xBlockingTime ) );
+			return;
+		}
+
+		prvConnect( pxClient );
+
+		if( pxClient->eState == eMQTTDisconnected )
+		{
+			return;
+		}
+	}
+
+	prvReceive( pxClient, xBlockingTime );
+
+	if( pxClient->eState != eMQTTDisconnected )
+	{
+		prvCheckTimers( pxClient );
+	}
+
+	prvQueueSend( pxClient );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t FreeRTOS_MQTTPublish( MQTTClient_t * pxClient,
+								 const char * pcTopic,
+								 const void * pvPayload,
+								 size_t uxLength,
+								 uint8_t ucQoS,
+								 BaseType_t xRetain )
+{
+size_t uxTopicLength = strlen( pcTopic );
+
+	if( ( ucQoS > 2U ) || ( uxTopicLength == 0U ) || ( uxTopicLength > 0xFFFFU ) )
+	{
+		return pdFAIL;
+	}
+
+	/* Older queued messages go first. */
+	if( ( pxClient->eState == eMQTTConnected ) && ( prvQueueIsEmpty( pxClient ) != pdFALSE ) &&
+		( prvWritePublish( pxClient, pcTopic, uxTopicLength, ( const uint8_t * ) pvPayload, uxLength, ucQoS, xRetain ) == pdPASS ) )
+	{
+		return pdPASS;
+	}
+
+	return prvQueuePush( pxClient, pcTopic, uxTopicLength, ( const uint8_t * ) pvPayload, uxLength, ucQoS, xRetain );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t FreeRTOS_MQTTSubscribe( MQTTClient_t * pxClient,
+								   const char * pcTopicFilter,
+								   uint8_t ucQoS )
+{
+BaseType_t xIndex, xFree = -1;
+
+	for( xIndex = 0; xIndex < ARRAY_SIZE( pxClient->pcSubscriptions ); xIndex++ )
+	{
+		if( ( pxClient->pcSubscriptions[ xIndex ] != NULL ) && ( strcmp( pxClient->pcSubscriptions[ xIndex ], pcTopicFilter ) == 0 ) )
+		{
+			xFree = xIndex;
+			break;
+		}
+
+		if( ( xFree < 0 ) && ( pxClient->pcSubscriptions[ xIndex ] == NULL ) )
+		{
+			xFree = xIndex;
+		}
+	}
+
+	if( ( xFree < 0 ) || ( ucQoS > 2U ) )
+	{
+		return pdFAIL;
+	}
+
+	pxClient->pcSubscriptions[ xFree ] = pcTopicFilter;
+	pxClient->ucSubscriptionQoS[ xFree ] = ucQoS;
+
+	/* When not connected, the subscription is sent after the CONNACK. */
+	if( pxClient->eState == eMQTTConnected )
+	{
+		return prvSendSubscribe( pxClient, mqttSUBSCRIBE, pcTopicFilter, ucQoS );
+	}
+
+	return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t FreeRTOS_MQTTUnsubscribe( MQTTClient_t * pxClient,
+									 const char * pcTopicFilter )
+{
+BaseType_t xIndex;
+
+	for( xIndex = 0; xIndex < ARRAY_SIZE( pxClient->pcSubscriptions ); xIndex++ )
+	{
+		if( ( pxClient->pcSubscriptions[ xIndex ] != NULL ) && ( strcmp( pxClient->pcSubscriptions[ xIndex ], pcTopicFilter ) == 0 ) )
+		{
+			pxClient->pcSubscriptions[ xIndex ] = NULL;
+		}
+	}
+
+	if( pxClient->eState == eMQTTConnected )
+	{
+		return prvSendSubscribe( pxClient, mqttUNSUBSCRIBE, pcTopicFilter, 0U );
+	}
+
+	return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+void FreeRTOS_MQTTDisconnect( MQTTClient_t * pxClient )
+{
+	if( pxClient->eState == eMQTTConnected )
+	{
+		( void ) prvSendSmall( pxClient, mqttDISCONNECT, 0U );
+		( void ) FreeRTOS_shutdown( pxClient->xSocket, FREERTOS_SHUT_RDWR );
+	}
+
+	if( xSocketValid( pxClient->xSocket ) != pdFALSE )
+	{
+		( void ) FreeRTOS_closesocket( pxClient->xSocket );
+	}
+
+	pxClient->xSocket = FREERTOS_INVALID_SOCKET;
+	pxClient->eState = eMQTTDisconnected;
+	pxClient->xReconnectTime = xTaskGetTickCount() + pdMS_TO_TICKS( pxClient->ulBackoffMS );
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,389 @@
+/*
+ * FreeRTOS+TCP V2.3.2
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/*
+ *  The Constrained Application Protocol ( CoAP, RFC 7252 ), running on
+ *  a FreeRTOS+TCP UDP socket.  Both a server and a client are provided.
+ *  Supported extensions are block-wise transfers ( RFC 7959 ) and
+ *  observing resources ( RFC 7641 ).
+ */
+
+#ifndef FREERTOS_COAP_H
+	#define FREERTOS_COAP_H
+
+	#ifdef __cplusplus
+		extern "C" {
+	#endif
+
+	/* The UDP port of the server. */
+	#ifndef ipconfigCOAP_PORT
+		#define ipconfigCOAP_PORT    5683
+	#endif
+
+	/* The largest message that can be sent or received, including the header.
+	 * RFC 7252 recommends 1152 bytes: a 1024-byte payload plus headers. */
+	#ifndef ipconfigCOAP_MAX_MESSAGE_SIZE
+		#define ipconfigCOAP_MAX_MESSAGE_SIZE    1152
+	#endif
+
+	/* The block size used for block-wise transfers, must be a power of two
+	 * between 16 and 1024. A peer may ask for a smaller size. */
+	#ifndef ipconfigCOAP_BLOCK_SIZE
+		#define ipconfigCOAP_BLOCK_SIZE    512
+	#endif
+
+	/* The maximum number of options that will be decoded in a message. */
+	#ifndef ipconfigCOAP_MAX_OPTIONS
+		#define ipconfigCOAP_MAX_OPTIONS    16
+	#endif
+
+	/* The number of buckets in the hash table of resources, a power of 2. */
+	#ifndef ipconfigCOAP_RESOURCE_HASH_SIZE
+		#define ipconfigCOAP_RESOURCE_HASH_SIZE    16
+	#endif
+
+	/* The number of recent confirmable requests for which the response is
+	 * remembered, so a retransmitted request gets the same response. */
+	#ifndef ipconfigCOAP_DEDUP_ENTRIES
+		#define ipconfigCOAP_DEDUP_ENTRIES    8
+	#endif
+
+	/* The time that a response is remembered, EXCHANGE_LIFETIME in RFC 7252. */
+	#ifndef ipconfigCOAP_EXCHANGE_LIFETIME_MS
+		#define ipconfigCOAP_EXCHANGE_LIFETIME_MS    247000U
+	#endif
+
+	/* The maximum number of observers, for all resources together. */
+	#ifndef ipconfigCOAP_MAX_OBSERVERS
+		#define ipconfigCOAP_MAX_OBSERVERS    8
+	#endif
+
+	/* Every n-th notification is sent as a confirmable message, so that
+	 * observers that went away will be detected. */
+	#ifndef ipconfigCOAP_NOTIFY_CON_INTERVAL
+		#define ipconfigCOAP_NOTIFY_CON_INTERVAL    16
+	#endif
+
+	/* Transmission parameters of RFC 7252, section 4.8. */
+	#ifndef ipconfigCOAP_ACK_TIMEOUT_MS
+		#define ipconfigCOAP_ACK_TIMEOUT_MS    2000U
+	#endif
+
+	#ifndef ipconfigCOAP_MAX_RETRANSMIT
+		#define ipconfigCOAP_MAX_RETRANSMIT    4
+	#endif
+
+	/* Serve files from +FAT with vCoAPFileHandler(). */
+	#ifndef ipconfigCOAP_USE_PLUS_FAT
+		#define ipconfigCOAP_USE_PLUS_FAT    0
+	#endif
+
+	/* Message types. */
+	#define coapTYPE_CON                             0U
+	#define coapTYPE_NON                             1U
+	#define coapTYPE_ACK                             2U
+	#define coapTYPE_RST                             3U
+
+	/* A code is written as "c.dd", e.g. 2.05 is coapCODE( 2, 5 ). */
+	#define coapCODE( ucClass, ucDetail )            ( ( uint8_t ) ( ( ( ucClass ) << 5 ) | ( ucDetail ) ) )
+	#define coapCODE_CLASS( ucCode )                 ( ( ucCode ) >> 5 )
+
+	#define coapCODE_EMPTY                           coapCODE( 0, 0 )
+	#define coapCODE_GET                             coapCODE( 0, 1 )
+	#define coapCODE_POST                            coapCODE( 0, 2 )
+	#define coapCODE_PUT                             coapCODE( 0, 3 )
+	#define coapCODE_DELETE                          coapCODE( 0, 4 )
+
+	#define coapCODE_CREATED                         coapCODE( 2, 1 )
+	#define coapCODE_DELETED                         coapCODE( 2, 2 )
+	#define coapCODE_VALID                           coapCODE( 2, 3 )
+	#define coapCODE_CHANGED                         coapCODE( 2, 4 )
+	#define coapCODE_CONTENT                         coapCODE( 2, 5 )
+	#define coapCODE_CONTINUE                        coapCODE( 2, 31 )
+	#define coapCODE_BAD_REQUEST                     coapCODE( 4, 0 )
+	#define coapCODE_BAD_OPTION                      coapCODE( 4, 2 )
+	#define coapCODE_NOT_FOUND                       coapCODE( 4, 4 )
+	#define coapCODE_METHOD_NOT_ALLOWED              coapCODE( 4, 5 )
+	#define coapCODE_REQUEST_ENTITY_INCOMPLETE       coapCODE( 4, 8 )
+	#define coapCODE_REQUEST_ENTITY_TOO_LARGE        coapCODE( 4, 13 )
+	#define coapCODE_INTERNAL_SERVER_ERROR           coapCODE( 5, 0 )
+	#define coapCODE_SERVICE_UNAVAILABLE             coapCODE( 5, 3 )
+
+	/* Option numbers. */
+	#define coapOPTION_IF_MATCH                      1U
+	#define coapOPTION_URI_HOST                      3U
+	#define coapOPTION_ETAG                          4U
+	#define coapOPTION_OBSERVE                       6U
+	#define coapOPTION_URI_PORT                      7U
+	#define coapOPTION_LOCATION_PATH                 8U
+	#define coapOPTION_URI_PATH                      11U
+	#define coapOPTION_CONTENT_FORMAT                12U
+	#define coapOPTION_MAX_AGE                       14U
+	#define coapOPTION_URI_QUERY                     15U
+	#define coapOPTION_ACCEPT                        17U
+	#define coapOPTION_BLOCK2                        23U
+	#define coapOPTION_BLOCK1                        27U
+	#define coapOPTION_SIZE2                         28U
+	#define coapOPTION_SIZE1                         60U
+
+	/* Some content formats. */
+	#define coapFORMAT_TEXT_PLAIN                    0U
+	#define coapFORMAT_LINK_FORMAT                   40U
+	#define coapFORMAT_OCTET_STREAM                  42U
+	#define coapFORMAT_JSON                          50U
+	#define coapFORMAT_CBOR                          60U
+	#define coapFORMAT_NONE                          0xFFFFU
+
+	/* The size of a block is 2 ^ ( SZX + 4 ). */
+	#define coapBLOCK_SIZE( ucSZX )                  ( ( size_t ) 16U << ( ucSZX ) )
+
+	/* Negative values returned by the client functions. */
+	#define coapERROR_NO_MEMORY                      ( -1 )
+	#define coapERROR_TIMEOUT                        ( -2 )
+	#define coapERROR_RESET                          ( -3 )
+	#define coapERROR_MESSAGE                        ( -4 )
+
+	/* A decoded option, 'pucValue' points into the message buffer. */
+	typedef struct xCOAP_OPTION
+	{
+		uint16_t usNumber;
+		uint16_t usLength;
+		const uint8_t * pucValue;
+	} CoAPOption_t;
+
+	/* A decoded message. */
+	typedef struct xCOAP_MESSAGE
+	{
+		uint8_t ucType;
+		uint8_t ucCode;
+		uint16_t usMessageID;
+		uint8_t ucTokenLength;
+		uint8_t ucToken[ 8 ];
+		size_t uxOptionCount;
+		CoAPOption_t xOptions[ ipconfigCOAP_MAX_OPTIONS ];
+		const uint8_t * pucPayload;
+		size_t uxPayloadLength;
+	} CoAPMessage_t;
+
+	/* Used to encode a message in a buffer. Options must be added in
+	 * ascending order of their number. */
+	typedef struct xCOAP_BUILDER
+	{
+		uint8_t * pucBuffer;
+		size_t uxSize;
+		size_t uxLength;
+		uint16_t usLastOption;
+		BaseType_t xError;
+	} CoAPBuilder_t;
+
+	/* The contents of a Block1 or Block2 option. */
+	typedef struct xCOAP_BLOCK
+	{
+		uint32_t ulNumber;
+		uint8_t ucSZX;
+		BaseType_t xMore;
+	} CoAPBlock_t;
+
+	/* Message encoding and decoding, used by both the server and the client. */
+	BaseType_t xCoAPParse( const uint8_t * pucBuffer,
+						   size_t uxLength,
+						   CoAPMessage_t * pxMessage );
+
+	void vCoAPBuilderInit( CoAPBuilder_t * pxBuilder,
+						   uint8_t * pucBuffer,
+						   size_t uxSize,
+						   uint8_t ucType,
+						   uint8_t ucCode,
+						   uint16_t usMessageID,
+						   const uint8_t * pucToken,
+						   uint8_t ucTokenLength );
+
+	void vCoAPAddOption( CoAPBuilder_t * pxBuilder,
+						 uint16_t usNumber,
+						 const void * pvValue,
+						 size_t uxLength );
+
+	void vCoAPAddUintOption( CoAPBuilder_t * pxBuilder,
+							 uint16_t usNumber,
+							 uint32_t ulValue );
+
+	/* Add each segment of a path like "sensors/temp" as a Uri-Path option. */
+	void vCoAPAddPath( CoAPBuilder_t * pxBuilder,
+					   const char * pcPath );
+
+	/* Write the payload marker and return a pointer to the space for the payload.
+	 * '*puxSpace' receives the number of bytes available. */
+	uint8_t * pucCoAPPayloadSpace( CoAPBuilder_t * pxBuilder,
+								   size_t * puxSpace );
+
+	/* Finish the message, 'uxPayloadLength' bytes were written to the payload space.
+	 * Returns the length of the message, or zero if it did not fit. */
+	size_t uxCoAPBuilderFinish( CoAPBuilder_t * pxBuilder,
+								size_t uxPayloadLength );
+
+	const CoAPOption_t * pxCoAPFindOption( const CoAPMessage_t * pxMessage,
+										   uint16_t usNumber );
+
+	uint32_t ulCoAPOptionUint( const CoAPOption_t * pxOption );
+
+	BaseType_t xCoAPGetBlock( const CoAPMessage_t * pxMessage,
+							  uint16_t usNumber,
+							  CoAPBlock_t * pxBlock );
+
+	uint32_t ulCoAPEncodeBlock( const CoAPBlock_t * pxBlock );
+
+	/* Compares the family, address and port of two endpoints. */
+	BaseType_t xCoAPSameEndpoint( const struct freertos_sockaddr * pxLeft,
+								  const struct freertos_sockaddr * pxRight );
+
+	/* Returns the largest SZX whose block size is not larger than 'uxSize'. */
+	uint8_t ucCoAPSizeToSZX( size_t uxSize );
+
+	/* A request, as passed to the handler of a resource. */
+	typedef struct xCOAP_REQUEST
+	{
+		const CoAPMessage_t * pxMessage;       /* The decoded message. */
+		const struct freertos_sockaddr * pxPeer;
+		uint8_t ucMethod;                      /* coapCODE_GET .. coapCODE_DELETE. */
+		const uint8_t * pucPayload;            /* The payload, or a block of it. */
+		size_t uxPayloadLength;
+		uint32_t ulPayloadOffset;              /* Block1: the offset of 'pucPayload'. */
+		BaseType_t xMorePayload;               /* Block1: more blocks will follow. */
+		uint32_t ulResponseOffset;             /* Block2: the part of the representation asked for. */
+	} CoAPRequest_t;
+
+	/* The response that is filled in by the handler. */
+	typedef struct xCOAP_RESPONSE
+	{
+		uint8_t ucCode;                        /* Defaults to coapCODE_CONTENT for GET. */
+		uint16_t usContentFormat;              /* coapFORMAT_NONE if not applicable. */
+		uint8_t * pucPayload;                  /* Write the ( part of the ) representation here. */
+		size_t uxPayloadSize;                  /* At most this many bytes. */
+		size_t uxPayloadLength;                /* The number of bytes written. */
+		BaseType_t xMore;                      /* Set when the representation continues after this block. */
+	} CoAPResponse_t;
+
+	struct xCOAP_RESOURCE;
+
+	typedef void ( * FCoAPHandler )( struct xCOAP_RESOURCE * pxResource,
+									 const CoAPRequest_t * pxRequest,
+									 CoAPResponse_t * pxResponse );
+
+	typedef struct xCOAP_RESOURCE
+	{
+		const char * pcPath;                   /* E.g. "sensors/temp", without a leading slash. */
+		FCoAPHandler fHandler;
+		BaseType_t xObservable;                /* Clients may observe this resource. */
+		const char * pcFileName;               /* Used by vCoAPFileHandler(). */
+		void * pvContext;                      /* For use by the application. */
+		/* Private fields. */
+		uint32_t ulHash;
+		struct xCOAP_RESOURCE * pxNextInBucket;
+	} CoAPResource_t;
+
+	struct xCOAP_SERVER;
+	typedef struct xCOAP_SERVER CoAPServer_t;
+
+	/* Create a server on port 'usPort' ( host-endian ), normally ipconfigCOAP_PORT. */
+	CoAPServer_t * FreeRTOS_CreateCoAPServer( uint16_t usPort );
+
+	/* Add a resource, the object must continue to exist. */
+	BaseType_t FreeRTOS_CoAPAddResource( CoAPServer_t * pxServer,
+										 CoAPResource_t * pxResource );
+
+	/* Handle all messages that arrive within 'xBlockingTime'. */
+	void FreeRTOS_CoAPServerWork( CoAPServer_t * pxServer,
+								  TickType_t xBlockingTime );
+
+	/* The state of an observable resource has changed, notify all observers.
+	 * Returns the number of notifications sent. */
+	BaseType_t FreeRTOS_CoAPNotify( CoAPServer_t * pxServer,
+									CoAPResource_t * pxResource );
+
+	#if ( ipconfigCOAP_USE_PLUS_FAT != 0 )
+
+		/* A handler that serves 'pcFileName' with GET, block by block,
+		 * and writes it with PUT, e.g. for firmware uploads. */
+		void vCoAPFileHandler( CoAPResource_t * pxResource,
+							   const CoAPRequest_t * pxRequest,
+							   CoAPResponse_t * pxResponse );
+	#endif
+
+	/* Called by the client for every ( block of a ) response or notification. */
+	typedef void ( * FCoAPClientData )( void * pvContext,
+										uint8_t ucCode,
+										uint32_t ulOffset,
+										const uint8_t * pucData,
+										size_t uxLength );
+
+	typedef struct xCOAP_CLIENT
+	{
+		Socket_t xSocket;
+		struct freertos_sockaddr xServer;
+		uint16_t usMessageID;
+		uint8_t ucToken[ 4 ];                  /* The token of the last request. */
+		uint8_t ucObserveToken[ 4 ];           /* The token of the observation, if any. */
+		BaseType_t xObserving;
+		FCoAPClientData fObserveData;
+		void * pvObserveContext;
+		uint32_t ulLastSequence;
+		CoAPMessage_t xReply;
+		uint8_t ucTxBuffer[ ipconfigCOAP_MAX_MESSAGE_SIZE ];
+		uint8_t ucRxBuffer[ ipconfigCOAP_MAX_MESSAGE_SIZE ];
+	} CoAPClient_t;
+
+	BaseType_t FreeRTOS_CoAPClientInit( CoAPClient_t * pxClient,
+										const struct freertos_sockaddr * pxServer );
+
+	void FreeRTOS_CoAPClientClose( CoAPClient_t * pxClient );
+
+	/* Send a request and wait for the complete response. Payloads larger than
+	 * a block are sent with Block1, large responses are fetched with Block2.
+	 * Returns the response code, or a negative coapERROR_ value. */
+	BaseType_t FreeRTOS_CoAPClientRequest( CoAPClient_t * pxClient,
+										   uint8_t ucMethod,
+										   const char * pcPath,
+										   const uint8_t * pucPayload,
+										   size_t uxLength,
+										   BaseType_t xConfirmable,
+										   FCoAPClientData fOnData,
+										   void * pvContext );
+
+	/* Start observing a resource. The first representation and all later
+	 * notifications are passed to 'fOnData'. */
+	BaseType_t FreeRTOS_CoAPClientObserve( CoAPClient_t * pxClient,
+										   const char * pcPath,
+										   FCoAPClientData fOnData,
+										   void * pvContext );
+
+	/* Receive notifications for 'xBlockingTime'. */
+	void FreeRTOS_CoAPClientWork( CoAPClient_t * pxClient,
+								  TickType_t xBlockingTime );
+
+	#ifdef __cplusplus
+		} /* extern "C" */
+	#endif
+
+#endif /* FREERTOS_COAP_H */
@@ -135,4 +135,10 @@ typedef struct xFTP_COMMAND
 
 extern const FTPCommand_t xFTPCommands[ FTP_CMD_COUNT ];
 
+/* Look up the command at the start of 'pcLine', ignoring case. Returns its
+ * index in xFTPCommands[], or ECMD_UNKNOWN. '*puxLength' receives the length
+ * of the command word. */
+extern BaseType_t xFTPCommandLookup( const char * pcLine,
+									 size_t * puxLength );
+
 #endif /* __FTPCMD_H__ */
@@ -65,4 +65,10 @@ extern const struct xWEB_COMMAND xWebCommands[ WEB_CMD_COUNT ];
 
 extern const char * webCodename( int aCode );
 
+/* Look up the method at the start of 'pcLine', ignoring case. Returns its
+ * index in xWebCommands[], or ECMD_UNK. '*puxLength' receives the length
+ * of the method name. */
+extern BaseType_t xWebCommandLookup( const char * pcLine,
+									 size_t * puxLength );
+
 #endif /* FREERTOS_HTTP_COMMANDS_H */
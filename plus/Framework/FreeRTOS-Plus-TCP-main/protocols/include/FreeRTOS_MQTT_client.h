@@ -0,0 +1,210 @@
+/*
+ * FreeRTOS+TCP V2.3.2
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/*
+ *  A small MQTT 3.1.1 client running on a FreeRTOS+TCP socket.
+ *
+ *  PUBLISH packets are written directly into the TX stream of the socket.
+ *  QoS 0, 1 and 2 are supported, with a limited number of outgoing messages
+ *  in flight.  While the connection is down, messages are kept in a RAM
+ *  ring buffer, which may overflow to a +FAT file.  The connection is
+ *  re-established with an exponential back-off.
+ *
+ *  All functions must be called from the same task, normally in a loop
+ *  that calls FreeRTOS_MQTTWork().
+ */
+
+#ifndef FREERTOS_MQTT_CLIENT_H
+	#define FREERTOS_MQTT_CLIENT_H
+
+	#ifdef __cplusplus
+		extern "C" {
+	#endif
+
+	/* The number of outgoing QoS 1 and QoS 2 messages that may be
+	 * waiting for an acknowledgement. */
+	#ifndef ipconfigMQTT_MAX_INFLIGHT
+		#define ipconfigMQTT_MAX_INFLIGHT    8
+	#endif
+
+	/* The number of incoming QoS 2 messages waiting for a PUBREL. When the
+	 * table is full, a new QoS 2 message is not acknowledged, and the broker
+	 * will send it again. */
+	#ifndef ipconfigMQTT_MAX_INBOUND_QOS2
+		#define ipconfigMQTT_MAX_INBOUND_QOS2    8
+	#endif
+
+	/* Topic filters that will be subscribed to again after a reconnect. */
+	#ifndef ipconfigMQTT_MAX_SUBSCRIPTIONS
+		#define ipconfigMQTT_MAX_SUBSCRIPTIONS    4
+	#endif
+
+	/* The size of the RAM ring in which messages are kept while offline. */
+	#ifndef ipconfigMQTT_OFFLINE_QUEUE_SIZE
+		#define ipconfigMQTT_OFFLINE_QUEUE_SIZE    4096
+	#endif
+
+	/* The largest incoming packet, larger packets will be skipped. */
+	#ifndef ipconfigMQTT_RX_BUFFER_SIZE
+		#define ipconfigMQTT_RX_BUFFER_SIZE    1024
+	#endif
+
+	/* The time after which an unacknowledged message is sent again. */
+	#ifndef ipconfigMQTT_RETRY_TIME_MS
+		#define ipconfigMQTT_RETRY_TIME_MS    10000U
+	#endif
+
+	/* The limits of the reconnect back-off. */
+	#ifndef ipconfigMQTT_BACKOFF_MIN_MS
+		#define ipconfigMQTT_BACKOFF_MIN_MS    1000U
+	#endif
+
+	#ifndef ipconfigMQTT_BACKOFF_MAX_MS
+		#define ipconfigMQTT_BACKOFF_MAX_MS    64000U
+	#endif
+
+	/* Let the offline queue overflow to a file on +FAT. */
+	#ifndef ipconfigMQTT_USE_PLUS_FAT
+		#define ipconfigMQTT_USE_PLUS_FAT    0
+	#endif
+
+	#ifndef ipconfigMQTT_SPILL_FILE_NAME
+		#define ipconfigMQTT_SPILL_FILE_NAME    "/mqtt_queue.bin"
+	#endif
+
+	/* The default MQTT port. */
+	#define mqttPORT    1883
+
+	typedef enum
+	{
+		eMQTTDisconnected,	/* Waiting for the next connection attempt. */
+		eMQTTWaitConnAck,	/* Connected with TCP, CONNECT sent. */
+		eMQTTConnected		/* The broker accepted the connection. */
+	} eMQTTState_t;
+
+	typedef struct xMQTT_CONNECT_INFO
+	{
+		const char * pcClientID;
+		const char * pcUserName;	/* NULL when not used. */
+		const char * pcPassword;	/* NULL when not used. */
+		uint16_t usKeepAliveSeconds;
+		BaseType_t xCleanSession;
+		const char * pcWillTopic;	/* NULL when there is no will. */
+		const uint8_t * pucWillMessage;
+		uint16_t usWillLength;
+		uint8_t ucWillQoS;
+		BaseType_t xWillRetain;
+	} MQTTConnectInfo_t;
+
+	/* Called for every incoming PUBLISH. The topic is not null-terminated. */
+	typedef void ( * FMQTTMessage )( void * pvContext,
+									 const char * pcTopic,
+									 size_t uxTopicLength,
+									 const uint8_t * pucPayload,
+									 size_t uxLength,
+									 uint8_t ucQoS );
+
+	/* An outgoing QoS 1 or QoS 2 message. */
+	typedef struct xMQTT_INFLIGHT
+	{
+		uint8_t * pucPacket;	/* A copy of the PUBLISH packet, NULL once PUBREC is received. */
+		size_t uxLength;
+		uint16_t usPacketID;	/* Zero when the entry is free. */
+		uint8_t ucExpect;		/* The packet type that is expected next. */
+		TickType_t xSentTime;
+	} MQTTInflight_t;
+
+	typedef struct xMQTT_CLIENT
+	{
+		Socket_t xSocket;
+		struct freertos_sockaddr xBroker;
+		MQTTConnectInfo_t xInfo;
+		FMQTTMessage fOnMessage;
+		void * pvContext;
+		eMQTTState_t eState;
+		TickType_t xLastSend;
+		TickType_t xLastReceive;
+		TickType_t xReconnectTime;
+		uint32_t ulBackoffMS;
+		BaseType_t xPingOutstanding;
+		uint16_t usNextPacketID;
+		MQTTInflight_t xInflight[ ipconfigMQTT_MAX_INFLIGHT ];
+		uint16_t usInboundQoS2[ ipconfigMQTT_MAX_INBOUND_QOS2 ];
+		const char * pcSubscriptions[ ipconfigMQTT_MAX_SUBSCRIPTIONS ];
+		uint8_t ucSubscriptionQoS[ ipconfigMQTT_MAX_SUBSCRIPTIONS ];
+		/* The offline queue. */
+		uint8_t ucQueue[ ipconfigMQTT_OFFLINE_QUEUE_SIZE ];
+		size_t uxQueueHead;
+		size_t uxQueueTail;
+		size_t uxQueueUsed;
+		#if ( ipconfigMQTT_USE_PLUS_FAT != 0 )
+			size_t uxSpillReadOffset;
+			size_t uxSpillLength;
+		#endif
+		uint32_t ulDropped;		/* Messages lost because the queue was full. */
+		/* Reception of packets. */
+		uint8_t ucRxBuffer[ ipconfigMQTT_RX_BUFFER_SIZE ];
+		size_t uxRxLength;
+		size_t uxRxSkip;
+	} MQTTClient_t;
+
+	/* Prepare the client, the first connection attempt is made by FreeRTOS_MQTTWork().
+	 * The strings in 'pxInfo' must remain valid. */
+	void FreeRTOS_MQTTInit( MQTTClient_t * pxClient,
+							const struct freertos_sockaddr * pxBroker,
+							const MQTTConnectInfo_t * pxInfo,
+							FMQTTMessage fOnMessage,
+							void * pvContext );
+
+	/* Connect when needed, handle incoming packets, send keep-alive pings,
+	 * retransmit messages and empty the offline queue. */
+	void FreeRTOS_MQTTWork( MQTTClient_t * pxClient,
+							TickType_t xBlockingTime );
+
+	/* Send a message, or queue it if it can not be sent now. */
+	BaseType_t FreeRTOS_MQTTPublish( MQTTClient_t * pxClient,
+									 const char * pcTopic,
+									 const void * pvPayload,
+									 size_t uxLength,
+									 uint8_t ucQoS,
+									 BaseType_t xRetain );
+
+	/* The topic filter string must remain valid, it is used again after a reconnect. */
+	BaseType_t FreeRTOS_MQTTSubscribe( MQTTClient_t * pxClient,
+									   const char * pcTopicFilter,
+									   uint8_t ucQoS );
+
+	BaseType_t FreeRTOS_MQTTUnsubscribe( MQTTClient_t * pxClient,
+										 const char * pcTopicFilter );
+
+	/* Send DISCONNECT and close the socket. Queued messages are kept, and
+	 * FreeRTOS_MQTTWork() will connect again after the back-off time. */
+	void FreeRTOS_MQTTDisconnect( MQTTClient_t * pxClient );
+
+	#ifdef __cplusplus
+		} /* extern "C" */
+	#endif
+
+#endif /* FREERTOS_MQTT_CLIENT_H */
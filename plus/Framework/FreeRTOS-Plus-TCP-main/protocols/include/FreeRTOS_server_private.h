@@ -185,10 +185,6 @@ struct xTCP_SERVER
 	#if ( ipconfigUSE_FTP != 0 )
 		char pcNewDir[ ffconfigMAX_FILENAME ];
 	#endif
-	#if ( ipconfigUSE_HTTP != 0 )
-		char pcContentsType[ 40 ];  /* Space for the msg: "text/javascript" */
-		char pcExtraContents[ 40 ]; /* Space for the msg: "Content-Length: 346500" */
-	#endif
 	BaseType_t xServerCount;
 	TCPClient_t * pxClients;
 	struct xSERVER
@@ -0,0 +1,109 @@
+/*
+ * FreeRTOS+TCP V2.3.2
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/*
+ *  Helpers shared by the protocol servers:
+ *  - A perfect hash over the first 4 characters of a word, used to look up
+ *    commands and file extensions in a table instead of comparing them one
+ *    by one.
+ *  - A reply builder that writes status lines and headers directly into the
+ *    TX stream of a TCP socket, without formatting them in a buffer first.
+ */
+
+#ifndef FREERTOS_SERVER_UTILS_H
+	#define FREERTOS_SERVER_UTILS_H
+
+	#ifdef __cplusplus
+		extern "C" {
+	#endif
+
+	/* A value in a hash table that does not refer to any entry. */
+	#define serverHASH_EMPTY    0xFFU
+
+	/* The tables are generated off-line: for a fixed set of words, a
+	 * multiplier is searched for which 'serverWORD_HASH()' gives a different
+	 * slot for every word.  When a word is added, both the multiplier and the
+	 * table must be generated again.  A hit must always be confirmed by
+	 * comparing the complete word. */
+	#define serverWORD_HASH( ulKey, ulMultiplier, uxBits ) \
+	( ( size_t ) ( ( uint32_t ) ( ( ulKey ) * ( ulMultiplier ) ) >> ( 32U - ( uxBits ) ) ) )
+
+	/* Returns the first 4 characters of a word in lower case, packed in a
+	 * 32-bit key, little-endian.  A word ends at a space, a tab, a CR, a LF
+	 * or a nul.  The length of the whole word is stored in '*puxLength'. */
+	uint32_t ulServerWordKey( const char * pcWord,
+							  size_t * puxLength );
+
+	/* Compare a word of 'uxLength' characters with a nul-terminated name,
+	 * ignoring case. */
+	BaseType_t xServerWordEquals( const char * pcWord,
+								  size_t uxLength,
+								  const char * pcName );
+
+	/* The maximum time to wait until a complete reply fits in the TX stream.
+	 * When it does not, the caller formats the reply in a buffer and passes
+	 * it to FreeRTOS_send(). */
+	#ifndef ipconfigSERVER_REPLY_BLOCK_TIME_MS
+		#define ipconfigSERVER_REPLY_BLOCK_TIME_MS	  100U
+	#endif
+
+	/* A reply that is written into the TX stream of a socket. */
+	typedef struct xTX_REPLY
+	{
+		Socket_t xSocket;
+		uint8_t * pucHead;	/* The current position in the TX stream. */
+		size_t uxSpace;		/* Contiguous space at 'pucHead'. */
+		size_t uxPending;	/* Bytes written but not yet passed to the socket. */
+		BaseType_t xTotal;	/* Bytes passed to the socket. */
+		BaseType_t xError;
+	} TXReply_t;
+
+	/* Waits at most 'xBlockTime' until the stream has 'uxMinimumSpace' bytes
+	 * free.  Returns pdFAIL when it still has less, the reply would then be
+	 * truncated. */
+	BaseType_t xTXReplyInit( TXReply_t * pxReply,
+							 Socket_t xSocket,
+							 size_t uxMinimumSpace,
+							 TickType_t xBlockTime );
+
+	void vTXReplyAdd( TXReply_t * pxReply,
+					  const char * pcText,
+					  size_t uxLength );
+
+	void vTXReplyString( TXReply_t * pxReply,
+						 const char * pcText );
+
+	void vTXReplyDecimal( TXReply_t * pxReply,
+						  uint32_t ulValue );
+
+	/* Hand the reply to the socket. Returns the number of bytes sent, or a
+	 * negative value when not everything could be written. */
+	BaseType_t xTXReplyFlush( TXReply_t * pxReply );
+
+	#ifdef __cplusplus
+		} /* extern "C" */
+	#endif
+
+#endif /* FREERTOS_SERVER_UTILS_H */
@@ -590,7 +590,7 @@ BaseType_t xCheckRequiresARPResolution( const NetworkBufferDescriptor_t * pxNetw
                                size_t uxNeededSize;
 
                                uxNeededSize = sizeof( ICMPPacket_IPv6_t );
-                               pxTempBuffer = pxGetNetworkBufferWithDescriptor( BUFFER_FROM_WHERE_CALL( 199 ) uxNeededSize, 0U );
+                               pxTempBuffer = pxGetNetworkBufferWithClass( BUFFER_FROM_WHERE_CALL( 199 ) uxNeededSize, 0U, eBufferClassControl );
 
                                if( pxTempBuffer != NULL )
                                {
@@ -1008,6 +1008,14 @@ static BaseType_t prvFindCacheEntry( const MACAddress_t * pxMACAddress,
 
             eReturn = eARPCacheHit;
         }
+        else if( ENDPOINT_IS_LOOPBACK( pxEndPoint ) != pdFALSE )
+        {
+            /* The address belongs to a loop-back end-point, which receives
+             * its own packets. */
+            ( void ) memcpy( pxMACAddress->ucBytes, pxEndPoint->xMACAddress.ucBytes, sizeof( MACAddress_t ) );
+            *( ppxEndPoint ) = pxEndPoint;
+            eReturn = eARPCacheHit;
+        }
         else
         {
             eReturn = eARPGetCacheEntryGateWay( pulIPAddress, pxMACAddress, ppxEndPoint );
@@ -1264,75 +1272,70 @@ static BaseType_t prvFindCacheEntry( const MACAddress_t * pxMACAddress,
 /*-----------------------------------------------------------*/
 
 /**
- * @brief Create and send an ARP request packet.
+ * @brief Create and send an ARP request packet from a single end-point.
  *
+ * @param[in] pxEndPoint The IPv4 end-point that sends the request.
  * @param[in] ulIPAddress A 32-bit representation of the IP-address whose
  *                         physical (MAC) address is required.
  */
-    void FreeRTOS_OutputARPRequest( uint32_t ulIPAddress )
+    void FreeRTOS_OutputARPRequest_Multi( NetworkEndPoint_t * pxEndPoint,
+                                          uint32_t ulIPAddress )
     {
         NetworkBufferDescriptor_t * pxNetworkBuffer;
-        NetworkEndPoint_t * pxEndPoint;
 
-        /* Send an ARP request to every end-point which has the type IPv4,
-         * and which already has an IP-address assigned. */
-        for( pxEndPoint = FreeRTOS_FirstEndPoint( NULL );
-             pxEndPoint != NULL;
-             pxEndPoint = FreeRTOS_NextEndPoint( NULL, pxEndPoint ) )
+        if( ( pxEndPoint->bits.bIPv6 == pdFALSE_UNSIGNED ) &&
+            ( pxEndPoint->ipv4_settings.ulIPAddress != 0U ) )
         {
-            if( ( pxEndPoint->bits.bIPv6 == pdFALSE_UNSIGNED ) &&
-                ( pxEndPoint->ipv4_settings.ulIPAddress != 0U ) )
+            /* This is called from the context of the IP event task, so a block time
+             * must not be used. */
+            pxNetworkBuffer = pxGetNetworkBufferWithClass( sizeof( ARPPacket_t ), ( TickType_t ) 0U, eBufferClassControl );
+
+            if( pxNetworkBuffer != NULL )
             {
-                /* This is called from the context of the IP event task, so a block time
-                 * must not be used. */
-                pxNetworkBuffer = pxGetNetworkBufferWithDescriptor( sizeof( ARPPacket_t ), ( TickType_t ) 0U );
+                pxNetworkBuffer->xIPAddress.ulIP_IPv4 = ulIPAddress;
+                pxNetworkBuffer->pxEndPoint = pxEndPoint;
+                pxNetworkBuffer->pxInterface = pxEndPoint->pxNetworkInterface;
+                vARPGenerateRequestPacket( pxNetworkBuffer );
 
-                if( pxNetworkBuffer != NULL )
+                #if ( ipconfigETHERNET_MINIMUM_PACKET_BYTES > 0 )
                 {
-                    pxNetworkBuffer->xIPAddress.ulIP_IPv4 = ulIPAddress;
-                    pxNetworkBuffer->pxEndPoint = pxEndPoint;
-                    pxNetworkBuffer->pxInterface = pxEndPoint->pxNetworkInterface;
-                    vARPGenerateRequestPacket( pxNetworkBuffer );
-
-                    #if ( ipconfigETHERNET_MINIMUM_PACKET_BYTES > 0 )
+                    if( pxNetworkBuffer->xDataLength < ( size_t ) ipconfigETHERNET_MINIMUM_PACKET_BYTES )
                     {
-                        if( pxNetworkBuffer->xDataLength < ( size_t ) ipconfigETHERNET_MINIMUM_PACKET_BYTES )
-                        {
-                            BaseType_t xIndex;
-
-                            for( xIndex = ( BaseType_t ) pxNetworkBuffer->xDataLength; xIndex < ( BaseType_t ) ipconfigETHERNET_MINIMUM_PACKET_BYTES; xIndex++ )
-                            {
-                                pxNetworkBuffer->pucEthernetBuffer[ xIndex ] = 0U;
-                            }
+                        BaseType_t xIndex;
 
-                            pxNetworkBuffer->xDataLength = ( size_t ) ipconfigETHERNET_MINIMUM_PACKET_BYTES;
+                        for( xIndex = ( BaseType_t ) pxNetworkBuffer->xDataLength; xIndex < ( BaseType_t ) ipconfigETHERNET_MINIMUM_PACKET_BYTES; xIndex++ )
+                        {
+                            pxNetworkBuffer->pucEthernetBuffer[ xIndex ] = 0U;
                         }
+
+                        pxNetworkBuffer->xDataLength = ( size_t ) ipconfigETHERNET_MINIMUM_PACKET_BYTES;
                     }
-                    #endif /* if( ipconfigETHERNET_MINIMUM_PACKET_BYTES > 0 ) */
+                }
+                #endif /* if( ipconfigETHERNET_MINIMUM_PACKET_BYTES > 0 ) */
 
-                    if( xIsCallingFromIPTask() != pdFALSE )
-                    {
-                        iptraceNETWORK_INTERFACE_OUTPUT( pxNetworkBuffer->xDataLength, pxNetworkBuffer->pucEthernetBuffer );
+                if( xIsCallingFromIPTask() != pdFALSE )
+                {
+                    iptraceNETWORK_INTERFACE_OUTPUT( pxNetworkBuffer->xDataLength, pxNetworkBuffer->pucEthernetBuffer );
 
-                        /* Only the IP-task is allowed to call this function directly. */
-                        if( pxEndPoint->pxNetworkInterface != NULL )
-                        {
-                            ( void ) pxEndPoint->pxNetworkInterface->pfOutput( pxEndPoint->pxNetworkInterface, pxNetworkBuffer, pdTRUE );
-                        }
-                    }
-                    else
+                    /* Only the IP-task is allowed to call this function directly. */
+                    if( pxEndPoint->pxNetworkInterface != NULL )
                     {
-                        IPStackEvent_t xSendEvent;
+                        ipCOUNT_IF_OUTPUT( pxEndPoint->pxNetworkInterface, pxNetworkBuffer );
+                        ( void ) pxEndPoint->pxNetworkInterface->pfOutput( pxEndPoint->pxNetworkInterface, pxNetworkBuffer, pdTRUE );
+                    }
+                }
+                else
+                {
+                    IPStackEvent_t xSendEvent;
 
-                        /* Send a message to the IP-task to send this ARP packet. */
-                        xSendEvent.eEventType = eNetworkTxEvent;
-                        xSendEvent.pvData = pxNetworkBuffer;
+                    /* Send a message to the IP-task to send this ARP packet. */
+                    xSendEvent.eEventType = eNetworkTxEvent;
+                    xSendEvent.pvData = pxNetworkBuffer;
 
-                        if( xSendEventStructToIPTask( &xSendEvent, ( TickType_t ) portMAX_DELAY ) == pdFAIL )
-                        {
-                            /* Failed to send the message, so release the network buffer. */
-                            vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
-                        }
+                    if( xSendEventStructToIPTask( &xSendEvent, ( TickType_t ) portMAX_DELAY ) == pdFAIL )
+                    {
+                        /* Failed to send the message, so release the network buffer. */
+                        vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
                     }
                 }
             }
@@ -1340,6 +1343,27 @@ static BaseType_t prvFindCacheEntry( const MACAddress_t * pxMACAddress,
     }
 /*-----------------------------------------------------------*/
 
+/**
+ * @brief Create and send an ARP request packet.
+ *
+ * @param[in] ulIPAddress A 32-bit representation of the IP-address whose
+ *                         physical (MAC) address is required.
+ */
+    void FreeRTOS_OutputARPRequest( uint32_t ulIPAddress )
+    {
+        NetworkEndPoint_t * pxEndPoint;
+
+        /* Send an ARP request to every end-point which has the type IPv4,
+         * and which already has an IP-address assigned. */
+        for( pxEndPoint = FreeRTOS_FirstEndPoint( NULL );
+             pxEndPoint != NULL;
+             pxEndPoint = FreeRTOS_NextEndPoint( NULL, pxEndPoint ) )
+        {
+            FreeRTOS_OutputARPRequest_Multi( pxEndPoint, ulIPAddress );
+        }
+    }
+/*-----------------------------------------------------------*/
+
 /**
  * @brief  Wait for address resolution: look-up the IP-address in the ARP-cache, and if
  *         needed send an ARP request, and wait for a reply.  This function is useful when
@@ -0,0 +1,566 @@
+/*
+ * FreeRTOS+TCP <DEVELOPMENT BRANCH>
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file FreeRTOS_Bonding.c
+ * @brief Let several network interfaces act as one, see ipconfigUSE_BONDING.
+ *
+ * A bond is a network interface without hardware. Its output function passes
+ * each packet to one of its members, and the frames received by the members
+ * are handed to the bond by the IP-task. The members share the end-points,
+ * and so the MAC address, of the bond.
+ * All functions, except the ones that fill in the bond, are called from the
+ * IP-task, so no locking is needed.
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_IP_Private.h"
+#include "FreeRTOS_ARP.h"
+#include "FreeRTOS_ND.h"
+#include "FreeRTOS_Routing.h"
+#include "FreeRTOS_Bonding.h"
+#include "NetworkBufferManagement.h"
+#include "NetworkInterface.h"
+
+/* Exclude the entire file if bonding is not used. */
+#if ( ipconfigUSE_BONDING != 0 )
+
+/** @brief Get the state of a bond from its network interface. */
+    #define bondGET_BOND( pxInterface )    ( ( Bonding_t * ) ( ( pxInterface )->pvArgument ) )
+
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvBonding_Initialise( NetworkInterface_t * pxInterface );
+
+    static BaseType_t prvBonding_Output( NetworkInterface_t * pxInterface,
+                                         NetworkBufferDescriptor_t * const pxDescriptor,
+                                         BaseType_t bReleaseAfterSend );
+
+    static BaseType_t prvBonding_GetPhyLinkStatus( NetworkInterface_t * pxInterface );
+
+    static void prvBondingUpdateLinks( NetworkInterface_t * pxBondInterface );
+
+    static void prvBondingAnnounce( NetworkInterface_t * pxBondInterface );
+
+    static uint32_t prvBondingHash( const uint8_t * pucEthernetBuffer,
+                                    size_t uxDataLength );
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Fill in and add a network interface that represents a bond.
+ *
+ * @param[in] pxBond The state of the bond, must be declared static or global.
+ * @param[in] eMode Either eBondingActiveBackup or eBondingBalanceXOR.
+ * @param[in] pxInterface The interface of the bond, must be declared static or global.
+ *
+ * @return The interface that was filled in.
+ */
+    NetworkInterface_t * pxBonding_FillInterfaceDescriptor( Bonding_t * pxBond,
+                                                            eBondingMode_t eMode,
+                                                            NetworkInterface_t * pxInterface )
+    {
+        configASSERT( pxBond != NULL );
+        configASSERT( pxInterface != NULL );
+
+        ( void ) memset( pxBond, 0, sizeof( *pxBond ) );
+        pxBond->eMode = eMode;
+
+        ( void ) memset( pxInterface, 0, sizeof( *pxInterface ) );
+        pxInterface->pcName = "Bond";                /* Just for logging, debugging. */
+        pxInterface->pvArgument = ( void * ) pxBond; /* The state of the bond. */
+        pxInterface->pfInitialise = prvBonding_Initialise;
+        pxInterface->pfOutput = prvBonding_Output;
+        pxInterface->pfGetPhyLinkStatus = prvBonding_GetPhyLinkStatus;
+
+        ( void ) FreeRTOS_AddNetworkInterface( pxInterface );
+
+        return pxInterface;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Add a member to a bond.
+ *
+ * @param[in] pxBondInterface The interface of the bond.
+ * @param[in] pxMember The interface that becomes a member. It must not have end-points.
+ *
+ * @return pdPASS when the member was added, otherwise pdFAIL.
+ */
+    BaseType_t xBondingAddMember( NetworkInterface_t * pxBondInterface,
+                                  NetworkInterface_t * pxMember )
+    {
+        BaseType_t xReturn = pdFAIL;
+        Bonding_t * pxBond;
+
+        if( ( pxBondInterface != NULL ) &&
+            ( pxBondInterface->pfOutput == prvBonding_Output ) &&
+            ( pxMember != NULL ) &&
+            ( pxMember != pxBondInterface ) &&
+            ( pxMember->pxBondMaster == NULL ) )
+        {
+            pxBond = bondGET_BOND( pxBondInterface );
+
+            if( pxBond->uxMemberCount < ( UBaseType_t ) ipconfigBONDING_MAX_MEMBERS )
+            {
+                pxBond->pxMembers[ pxBond->uxMemberCount ] = pxMember;
+                pxBond->uxMemberCount++;
+                pxMember->pxBondMaster = pxBondInterface;
+                xReturn = pdPASS;
+            }
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Get the member that carries the traffic of an active-backup bond.
+ *
+ * @param[in] pxBondInterface The interface of the bond.
+ *
+ * @return The active member, or NULL when no member has a link.
+ */
+    NetworkInterface_t * pxBondingGetActiveMember( const NetworkInterface_t * pxBondInterface )
+    {
+        NetworkInterface_t * pxReturn = NULL;
+        const Bonding_t * pxBond;
+
+        if( ( pxBondInterface != NULL ) && ( pxBondInterface->pfOutput == prvBonding_Output ) )
+        {
+            pxBond = bondGET_BOND( pxBondInterface );
+
+            if( ( pxBond->ulLinkUp & ( 1UL << pxBond->uxActive ) ) != 0U )
+            {
+                pxReturn = pxBond->pxMembers[ pxBond->uxActive ];
+            }
+        }
+
+        return pxReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Hand a frame that was received by a member to the bond.
+ *
+ * @param[in] pxNetworkBuffer The frame that was received.
+ *
+ * @return pdFALSE when the frame must be dropped, otherwise pdTRUE.
+ */
+    BaseType_t xBondingReceive( NetworkBufferDescriptor_t * pxNetworkBuffer )
+    {
+        BaseType_t xReturn = pdTRUE;
+        NetworkInterface_t * pxMember = pxNetworkBuffer->pxInterface;
+        const Bonding_t * pxBond;
+
+        if( pxMember->pxBondMaster != NULL )
+        {
+            pxBond = bondGET_BOND( pxMember->pxBondMaster );
+
+            if( ( pxBond->eMode == eBondingActiveBackup ) &&
+                ( pxBond->pxMembers[ pxBond->uxActive ] != pxMember ) )
+            {
+                /* A standby member may see the flooded traffic of the switch. */
+                xReturn = pdFALSE;
+            }
+            else
+            {
+                pxNetworkBuffer->pxInterface = pxMember->pxBondMaster;
+            }
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Handle the network-down event of a bond member.
+ *
+ * @param[in] pxInterface The interface that went down.
+ *
+ * @return pdTRUE when the event was handled, pdFALSE when 'pxInterface'
+ *         is not a member of a bond.
+ */
+    BaseType_t xBondingMemberDown( NetworkInterface_t * pxInterface )
+    {
+        BaseType_t xReturn = pdFALSE;
+
+        if( pxInterface->pxBondMaster != NULL )
+        {
+            if( pxInterface->pfInitialise( pxInterface ) == pdPASS )
+            {
+                pxInterface->bits.bInterfaceUp = pdTRUE_UNSIGNED;
+            }
+            else
+            {
+                /* The network timer will send a new network-down event. */
+                vSetAllNetworksUp( pdFALSE );
+            }
+
+            prvBondingUpdateLinks( pxInterface->pxBondMaster );
+            xReturn = pdTRUE;
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Check the links of the members of all bonds.
+ */
+    void vBondingCheckLinks( void )
+    {
+        NetworkInterface_t * pxInterface;
+
+        for( pxInterface = FreeRTOS_FirstNetworkInterface();
+             pxInterface != NULL;
+             pxInterface = FreeRTOS_NextNetworkInterface( pxInterface ) )
+        {
+            if( pxInterface->pfOutput == prvBonding_Output )
+            {
+                prvBondingUpdateLinks( pxInterface );
+            }
+        }
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief The members are initialised by their own network-down events, see
+ *        xBondingMemberDown(). The bond is up as soon as one member is up.
+ *
+ * @param[in] pxInterface The interface of the bond.
+ *
+ * @return pdPASS as soon as at least one member is up.
+ */
+    static BaseType_t prvBonding_Initialise( NetworkInterface_t * pxInterface )
+    {
+        BaseType_t xReturn = pdFAIL;
+        const Bonding_t * pxBond = bondGET_BOND( pxInterface );
+        UBaseType_t uxIndex;
+
+        for( uxIndex = 0U; uxIndex < pxBond->uxMemberCount; uxIndex++ )
+        {
+            if( pxBond->pxMembers[ uxIndex ]->bits.bInterfaceUp != pdFALSE_UNSIGNED )
+            {
+                xReturn = pdPASS;
+            }
+        }
+
+        prvBondingUpdateLinks( pxInterface );
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Send a packet through one of the members of a bond.
+ *
+ * @param[in] pxInterface The interface of the bond.
+ * @param[in] pxDescriptor The packet to be sent.
+ * @param[in] bReleaseAfterSend pdTRUE when the bond becomes the owner of the buffer.
+ *
+ * @return pdPASS when the packet was passed to a member, otherwise pdFAIL.
+ */
+    static BaseType_t prvBonding_Output( NetworkInterface_t * pxInterface,
+                                         NetworkBufferDescriptor_t * const pxDescriptor,
+                                         BaseType_t bReleaseAfterSend )
+    {
+        const Bonding_t * pxBond = bondGET_BOND( pxInterface );
+        NetworkInterface_t * pxMember = NULL;
+        BaseType_t xReturn = pdFAIL;
+
+        if( pxBond->eMode == eBondingActiveBackup )
+        {
+            pxMember = pxBondingGetActiveMember( pxInterface );
+        }
+        else if( pxBond->ulLinkUp != 0U )
+        {
+            UBaseType_t uxCount = 0U;
+            UBaseType_t uxIndex;
+            uint32_t ulChoice;
+
+            for( uxIndex = 0U; uxIndex < pxBond->uxMemberCount; uxIndex++ )
+            {
+                if( ( pxBond->ulLinkUp & ( 1UL << uxIndex ) ) != 0U )
+                {
+                    uxCount++;
+                }
+            }
+
+            /* All packets of a flow go through the same member, so they
+             * will not be reordered. */
+            ulChoice = prvBondingHash( pxDescriptor->pucEthernetBuffer, pxDescriptor->xDataLength ) % ( uint32_t ) uxCount;
+
+            for( uxIndex = 0U; uxIndex < pxBond->uxMemberCount; uxIndex++ )
+            {
+                if( ( pxBond->ulLinkUp & ( 1UL << uxIndex ) ) != 0U )
+                {
+                    if( ulChoice == 0U )
+                    {
+                        pxMember = pxBond->pxMembers[ uxIndex ];
+                        break;
+                    }
+
+                    ulChoice--;
+                }
+            }
+        }
+        else
+        {
+            /* No member has a link. */
+        }
+
+        if( pxMember != NULL )
+        {
+            xReturn = pxMember->pfOutput( pxMember, pxDescriptor, bReleaseAfterSend );
+        }
+        else if( bReleaseAfterSend != pdFALSE )
+        {
+            vReleaseNetworkBufferAndDescriptor( pxDescriptor );
+        }
+        else
+        {
+            /* The caller still owns the buffer. */
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief A bond has a link as long as one of its members has a link.
+ *
+ * @param[in] pxInterface The interface of the bond.
+ *
+ * @return pdTRUE when at least one member has a link.
+ */
+    static BaseType_t prvBonding_GetPhyLinkStatus( NetworkInterface_t * pxInterface )
+    {
+        const Bonding_t * pxBond = bondGET_BOND( pxInterface );
+
+        return ( pxBond->ulLinkUp != 0U ) ? pdTRUE : pdFALSE;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Read the link status of the members of a bond. In active-backup mode,
+ *        let the next member take over when the active member lost its link.
+ *
+ * @param[in] pxBondInterface The interface of the bond.
+ */
+    static void prvBondingUpdateLinks( NetworkInterface_t * pxBondInterface )
+    {
+        Bonding_t * pxBond = bondGET_BOND( pxBondInterface );
+        uint32_t ulLinkUp = 0U;
+        UBaseType_t uxIndex;
+
+        for( uxIndex = 0U; uxIndex < pxBond->uxMemberCount; uxIndex++ )
+        {
+            NetworkInterface_t * pxMember = pxBond->pxMembers[ uxIndex ];
+
+            /* The drivers keep their link status up-to-date, normally with
+             * xPhyCheckLinkStatus() from phyHandling.c. */
+            if( ( pxMember->bits.bInterfaceUp != pdFALSE_UNSIGNED ) &&
+                ( ( pxMember->pfGetPhyLinkStatus == NULL ) || ( pxMember->pfGetPhyLinkStatus( pxMember ) != pdFALSE ) ) )
+            {
+                ulLinkUp |= ( 1UL << uxIndex );
+            }
+        }
+
+        if( ulLinkUp != pxBond->ulLinkUp )
+        {
+            FreeRTOS_printf( ( "Bonding: %s links 0x%02X -> 0x%02X\n",
+                               pxBondInterface->pcName,
+                               ( unsigned ) pxBond->ulLinkUp,
+                               ( unsigned ) ulLinkUp ) );
+            pxBond->ulLinkUp = ulLinkUp;
+
+            if( ( pxBond->eMode == eBondingActiveBackup ) &&
+                ( ( ulLinkUp & ( 1UL << pxBond->uxActive ) ) == 0U ) &&
+                ( ulLinkUp != 0U ) )
+            {
+                /* The active member lost its link. The first member that is up
+                 * takes over, the members are stored in order of preference. */
+                for( uxIndex = 0U; uxIndex < pxBond->uxMemberCount; uxIndex++ )
+                {
+                    if( ( ulLinkUp & ( 1UL << uxIndex ) ) != 0U )
+                    {
+                        break;
+                    }
+                }
+
+                pxBond->uxActive = uxIndex;
+                pxBond->ulFailovers++;
+
+                FreeRTOS_printf( ( "Bonding: %s is now using %s\n",
+                                   pxBondInterface->pcName,
+                                   pxBond->pxMembers[ uxIndex ]->pcName ) );
+
+                /* Let the switches learn the new port of our MAC address. */
+                prvBondingAnnounce( pxBondInterface );
+            }
+        }
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Announce all end-points of a bond with a gratuitous ARP or an
+ *        unsolicited Neighbour Advertisement.
+ *
+ * @param[in] pxBondInterface The interface of the bond.
+ */
+    static void prvBondingAnnounce( NetworkInterface_t * pxBondInterface )
+    {
+        NetworkEndPoint_t * pxEndPoint;
+
+        for( pxEndPoint = FreeRTOS_FirstEndPoint( pxBondInterface );
+             pxEndPoint != NULL;
+             pxEndPoint = FreeRTOS_NextEndPoint( pxBondInterface, pxEndPoint ) )
+        {
+            #if ( ipconfigUSE_IPv6 != 0 )
+                if( pxEndPoint->bits.bEndPointUp == pdFALSE_UNSIGNED )
+                {
+                    /* Nothing to announce yet. */
+                }
+                else if( pxEndPoint->bits.bIPv6 != pdFALSE_UNSIGNED )
+                {
+                    FreeRTOS_OutputAdvertiseIPv6( pxEndPoint );
+                }
+                else
+            #endif /* ( ipconfigUSE_IPv6 != 0 ) */
+            {
+                #if ( ipconfigUSE_IPv4 != 0 )
+                    if( pxEndPoint->bits.bEndPointUp != pdFALSE_UNSIGNED )
+                    {
+                        /* A request for our own address. */
+                        FreeRTOS_OutputARPRequest_Multi( pxEndPoint, pxEndPoint->ipv4_settings.ulIPAddress );
+                    }
+                #endif /* ( ipconfigUSE_IPv4 != 0 ) */
+            }
+        }
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Calculate a hash of the MAC addresses, the IP addresses and the ports
+ *        of a packet, which selects the member in balance-xor mode.
+ *
+ * @param[in] pucEthernetBuffer The packet to be sent.
+ * @param[in] uxDataLength The length of the packet.
+ *
+ * @return The hash.
+ */
+    static uint32_t prvBondingHash( const uint8_t * pucEthernetBuffer,
+                                    size_t uxDataLength )
+    {
+        /* MISRA Ref 11.3.1 [Misaligned access] */
+        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+        /* coverity[misra_c_2012_rule_11_3_violation] */
+        const EthernetHeader_t * pxEthernetHeader = ( ( const EthernetHeader_t * ) pucEthernetBuffer );
+        uint32_t ulHash;
+        size_t uxPortOffset = 0U;
+        uint8_t ucProtocol = 0U;
+
+        ulHash = ( uint32_t ) pxEthernetHeader->xSourceAddress.ucBytes[ ipMAC_ADDRESS_LENGTH_BYTES - 1U ] ^
+                 ( uint32_t ) pxEthernetHeader->xDestinationAddress.ucBytes[ ipMAC_ADDRESS_LENGTH_BYTES - 1U ];
+
+        #if ( ipconfigUSE_IPv4 != 0 )
+            if( ( pxEthernetHeader->usFrameType == ipIPv4_FRAME_TYPE ) &&
+                ( uxDataLength >= ( ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER ) ) )
+            {
+                /* MISRA Ref 11.3.1 [Misaligned access] */
+                /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+                /* coverity[misra_c_2012_rule_11_3_violation] */
+                const IPHeader_t * pxIPHeader = ( ( const IPHeader_t * ) &( pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER ] ) );
+
+                ulHash ^= pxIPHeader->ulSourceIPAddress ^ pxIPHeader->ulDestinationIPAddress;
+
+                /* Only the first fragment has the ports. */
+                if( ( pxIPHeader->usFragmentOffset & ipFRAGMENT_OFFSET_BIT_MASK ) == 0U )
+                {
+                    ucProtocol = pxIPHeader->ucProtocol;
+                    uxPortOffset = ipSIZE_OF_ETH_HEADER + ( ( ( size_t ) pxIPHeader->ucVersionHeaderLength & 0x0FU ) << 2 );
+                }
+            }
+        #endif /* ( ipconfigUSE_IPv4 != 0 ) */
+
+        #if ( ipconfigUSE_IPv6 != 0 )
+            if( ( pxEthernetHeader->usFrameType == ipIPv6_FRAME_TYPE ) &&
+                ( uxDataLength >= ( ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv6_HEADER ) ) )
+            {
+                /* MISRA Ref 11.3.1 [Misaligned access] */
+                /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+                /* coverity[misra_c_2012_rule_11_3_violation] */
+                const IPHeader_IPv6_t * pxIPHeader = ( ( const IPHeader_IPv6_t * ) &( pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER ] ) );
+                size_t uxIndex;
+
+                for( uxIndex = 0U; uxIndex < ipSIZE_OF_IPv6_ADDRESS; uxIndex += 4U )
+                {
+                    ulHash ^= ( ( uint32_t ) pxIPHeader->xSourceAddress.ucBytes[ uxIndex ] << 24 ) |
+                              ( ( uint32_t ) pxIPHeader->xSourceAddress.ucBytes[ uxIndex + 1U ] << 16 ) |
+                              ( ( uint32_t ) pxIPHeader->xSourceAddress.ucBytes[ uxIndex + 2U ] << 8 ) |
+                              ( ( uint32_t ) pxIPHeader->xSourceAddress.ucBytes[ uxIndex + 3U ] );
+                    ulHash ^= ( ( uint32_t ) pxIPHeader->xDestinationAddress.ucBytes[ uxIndex ] << 24 ) |
+                              ( ( uint32_t ) pxIPHeader->xDestinationAddress.ucBytes[ uxIndex + 1U ] << 16 ) |
+                              ( ( uint32_t ) pxIPHeader->xDestinationAddress.ucBytes[ uxIndex + 2U ] << 8 ) |
+                              ( ( uint32_t ) pxIPHeader->xDestinationAddress.ucBytes[ uxIndex + 3U ] );
+                }
+
+                /* Extension headers are not followed, those packets are hashed
+                 * on their addresses only. */
+                ucProtocol = pxIPHeader->ucNextHeader;
+                uxPortOffset = ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv6_HEADER;
+            }
+        #endif /* ( ipconfigUSE_IPv6 != 0 ) */
+
+        if( ( ( ucProtocol == ( uint8_t ) ipPROTOCOL_TCP ) || ( ucProtocol == ( uint8_t ) ipPROTOCOL_UDP ) ) &&
+            ( uxDataLength >= ( uxPortOffset + 4U ) ) )
+        {
+            /* The source and destination ports. */
+            ulHash ^= ( ( uint32_t ) pucEthernetBuffer[ uxPortOffset ] << 24 ) |
+                      ( ( uint32_t ) pucEthernetBuffer[ uxPortOffset + 1U ] << 16 ) |
+                      ( ( uint32_t ) pucEthernetBuffer[ uxPortOffset + 2U ] << 8 ) |
+                      ( ( uint32_t ) pucEthernetBuffer[ uxPortOffset + 3U ] );
+        }
+
+        ulHash ^= ulHash >> 16;
+        ulHash ^= ulHash >> 8;
+
+        return ulHash;
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* ( ipconfigUSE_BONDING != 0 ) */
@@ -0,0 +1,736 @@
+/*
+ * FreeRTOS+TCP <DEVELOPMENT BRANCH>
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file FreeRTOS_Bridge.c
+ * @brief A layer-2 learning bridge between network interfaces, see ipconfigUSE_BRIDGE.
+ *
+ * A bridge is a network interface without hardware, its ports are the network
+ * interfaces of Ethernet drivers. The source address of every frame received
+ * by a port is learned. Frames for this host are handed to the bridge, which
+ * owns the end-points. Other frames are passed to the output function of the
+ * port behind which the destination lives, in the same network buffer.
+ * All functions, except the ones that fill in the bridge, are called from the
+ * IP-task, so no locking is needed.
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_IP_Private.h"
+#include "FreeRTOS_Routing.h"
+#include "FreeRTOS_Bridge.h"
+#include "NetworkBufferManagement.h"
+#include "NetworkInterface.h"
+
+/* Exclude the entire file if the bridge is not used. */
+#if ( ipconfigUSE_BRIDGE != 0 )
+
+/** @brief Get the state of a bridge from its network interface. */
+    #define bridgeGET_BRIDGE( pxInterface )    ( ( Bridge_t * ) ( ( pxInterface )->pvArgument ) )
+
+/** @brief The number of entries in a bucket of the MAC table. */
+    #define bridgeBUCKET_SIZE                  4U
+
+/** @brief The number of buckets in the MAC table. */
+    #define bridgeBUCKET_COUNT                 ( ( uint32_t ) ipconfigBRIDGE_MAC_TABLE_SIZE / bridgeBUCKET_SIZE )
+
+/** @brief The time after which a learned MAC address is forgotten. */
+    #define bridgeMAC_AGE_TICKS                pdMS_TO_TICKS( ( uint32_t ) ipconfigBRIDGE_MAC_AGE_SECONDS * 1000U )
+
+/** @brief Broadcast and multicast addresses have the group bit set. */
+    #define bridgeIS_GROUP_ADDRESS( pxMAC )    ( ( ( pxMAC )->ucBytes[ 0 ] & 0x01U ) != 0U )
+
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvBridge_Initialise( NetworkInterface_t * pxInterface );
+
+    static BaseType_t prvBridge_Output( NetworkInterface_t * pxInterface,
+                                        NetworkBufferDescriptor_t * const pxDescriptor,
+                                        BaseType_t bReleaseAfterSend );
+
+    static BaseType_t prvBridge_GetPhyLinkStatus( NetworkInterface_t * pxInterface );
+
+    static void prvBridgeUpdatePorts( NetworkInterface_t * pxBridgeInterface );
+
+    static UBaseType_t prvBridgePortIndex( const Bridge_t * pxBridge,
+                                           const NetworkInterface_t * pxInterface );
+
+    static BaseType_t prvBridgeIsLocal( const NetworkInterface_t * pxBridgeInterface,
+                                        const MACAddress_t * pxMACAddress );
+
+    static BaseType_t prvBridgeFlood( Bridge_t * pxBridge,
+                                      NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                      UBaseType_t uxInPort,
+                                      BaseType_t bReleaseAfterSend );
+
+    static BridgeMACEntry_t * prvBridgeBucket( Bridge_t * pxBridge,
+                                               const MACAddress_t * pxMACAddress );
+
+    static BridgeMACEntry_t * prvBridgeLookup( Bridge_t * pxBridge,
+                                               const MACAddress_t * pxMACAddress );
+
+    static void prvBridgeLearn( Bridge_t * pxBridge,
+                                const MACAddress_t * pxMACAddress,
+                                UBaseType_t uxPort );
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Fill in and add a network interface that represents a bridge.
+ *
+ * @param[in] pxBridge The state of the bridge, must be declared static or global.
+ * @param[in] pxInterface The interface of the bridge, must be declared static or global.
+ *
+ * @return The interface that was filled in.
+ */
+    NetworkInterface_t * pxBridge_FillInterfaceDescriptor( Bridge_t * pxBridge,
+                                                           NetworkInterface_t * pxInterface )
+    {
+        configASSERT( pxBridge != NULL );
+        configASSERT( pxInterface != NULL );
+
+        ( void ) memset( pxBridge, 0, sizeof( *pxBridge ) );
+
+        ( void ) memset( pxInterface, 0, sizeof( *pxInterface ) );
+        pxInterface->pcName = "Bridge";                /* Just for logging, debugging. */
+        pxInterface->pvArgument = ( void * ) pxBridge; /* The state of the bridge. */
+        pxInterface->pfInitialise = prvBridge_Initialise;
+        pxInterface->pfOutput = prvBridge_Output;
+        pxInterface->pfGetPhyLinkStatus = prvBridge_GetPhyLinkStatus;
+
+        ( void ) FreeRTOS_AddNetworkInterface( pxInterface );
+
+        return pxInterface;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Add a port to a bridge.
+ *
+ * @param[in] pxBridgeInterface The interface of the bridge.
+ * @param[in] pxPort The interface that becomes a port. It must not have end-points.
+ * @param[in] eRole The role of the port, see eBridgePortRole_t.
+ *
+ * @return pdPASS when the port was added, otherwise pdFAIL.
+ */
+    BaseType_t xBridgeAddPort( NetworkInterface_t * pxBridgeInterface,
+                               NetworkInterface_t * pxPort,
+                               eBridgePortRole_t eRole )
+    {
+        BaseType_t xReturn = pdFAIL;
+        Bridge_t * pxBridge;
+
+        if( ( pxBridgeInterface != NULL ) &&
+            ( pxBridgeInterface->pfOutput == prvBridge_Output ) &&
+            ( pxPort != NULL ) &&
+            ( pxPort != pxBridgeInterface ) &&
+            ( pxPort->pxBridge == NULL ) )
+        {
+            pxBridge = bridgeGET_BRIDGE( pxBridgeInterface );
+
+            if( pxBridge->uxPortCount < ( UBaseType_t ) ipconfigBRIDGE_MAX_PORTS )
+            {
+                pxBridge->xPorts[ pxBridge->uxPortCount ].pxInterface = pxPort;
+                pxBridge->xPorts[ pxBridge->uxPortCount ].eRole = eRole;
+                pxBridge->uxPortCount++;
+                pxPort->pxBridge = pxBridgeInterface;
+                xReturn = pdPASS;
+            }
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Forget all MAC addresses that were learned by a bridge.
+ *
+ * @param[in] pxBridgeInterface The interface of the bridge.
+ */
+    void vBridgeFlushMACTable( NetworkInterface_t * pxBridgeInterface )
+    {
+        Bridge_t * pxBridge = bridgeGET_BRIDGE( pxBridgeInterface );
+        size_t uxIndex;
+
+        for( uxIndex = 0U; uxIndex < ( size_t ) ipconfigBRIDGE_MAC_TABLE_SIZE; uxIndex++ )
+        {
+            pxBridge->xMACTable[ uxIndex ].ucInUse = pdFALSE_UNSIGNED;
+        }
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Forward a frame that was received by a port of a bridge, and/or
+ *        hand it to the bridge.
+ *
+ * @param[in] pxNetworkBuffer The frame that was received.
+ *
+ * @return eProcessBuffer when the frame must be processed by this host,
+ *         eFrameConsumed when it was forwarded, or eReleaseBuffer.
+ */
+    eFrameProcessingResult_t eBridgeReceive( NetworkBufferDescriptor_t * pxNetworkBuffer )
+    {
+        eFrameProcessingResult_t eReturn = eProcessBuffer;
+        NetworkInterface_t * pxBridgeInterface = pxNetworkBuffer->pxInterface->pxBridge;
+        Bridge_t * pxBridge;
+        UBaseType_t uxInPort;
+
+        if( pxBridgeInterface != NULL )
+        {
+            pxBridge = bridgeGET_BRIDGE( pxBridgeInterface );
+            uxInPort = prvBridgePortIndex( pxBridge, pxNetworkBuffer->pxInterface );
+
+            if( ( uxInPort >= pxBridge->uxPortCount ) ||
+                ( ( pxBridge->ulForwarding & ( 1UL << uxInPort ) ) == 0U ) ||
+                ( pxNetworkBuffer->xDataLength < sizeof( EthernetHeader_t ) ) )
+            {
+                /* A blocked port drops all frames, otherwise a loop would
+                 * deliver them twice. */
+                pxBridge->ulFiltered++;
+                eReturn = eReleaseBuffer;
+            }
+            else
+            {
+                /* MISRA Ref 11.3.1 [Misaligned access] */
+                /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+                /* coverity[misra_c_2012_rule_11_3_violation] */
+                const EthernetHeader_t * pxEthernetHeader = ( ( const EthernetHeader_t * ) pxNetworkBuffer->pucEthernetBuffer );
+                const BridgeMACEntry_t * pxEntry;
+
+                if( !bridgeIS_GROUP_ADDRESS( &( pxEthernetHeader->xSourceAddress ) ) )
+                {
+                    prvBridgeLearn( pxBridge, &( pxEthernetHeader->xSourceAddress ), uxInPort );
+                }
+
+                if( bridgeIS_GROUP_ADDRESS( &( pxEthernetHeader->xDestinationAddress ) ) )
+                {
+                    /* Broadcast and multicast frames go to all other ports, and
+                     * to this host. */
+                    ( void ) prvBridgeFlood( pxBridge, pxNetworkBuffer, uxInPort, pdFALSE );
+                }
+                else if( prvBridgeIsLocal( pxBridgeInterface, &( pxEthernetHeader->xDestinationAddress ) ) != pdFALSE )
+                {
+                    /* The frame is addressed to this host. */
+                }
+                else
+                {
+                    pxEntry = prvBridgeLookup( pxBridge, &( pxEthernetHeader->xDestinationAddress ) );
+
+                    if( pxEntry == NULL )
+                    {
+                        /* The destination is not known yet. */
+                        ( void ) prvBridgeFlood( pxBridge, pxNetworkBuffer, uxInPort, pdTRUE );
+                        eReturn = eFrameConsumed;
+                    }
+                    else if( ( ( UBaseType_t ) pxEntry->ucPort != uxInPort ) &&
+                             ( ( pxBridge->ulForwarding & ( 1UL << pxEntry->ucPort ) ) != 0U ) )
+                    {
+                        BridgePort_t * pxOutPort = &( pxBridge->xPorts[ pxEntry->ucPort ] );
+
+                        /* The same network buffer is passed to the other driver. */
+                        pxOutPort->ulForwarded++;
+                        ( void ) pxOutPort->pxInterface->pfOutput( pxOutPort->pxInterface, pxNetworkBuffer, pdTRUE );
+                        eReturn = eFrameConsumed;
+                    }
+                    else
+                    {
+                        /* The destination lives on the segment of the source, or
+                         * behind a blocked port. */
+                        pxBridge->ulFiltered++;
+                        eReturn = eReleaseBuffer;
+                    }
+                }
+
+                if( eReturn == eProcessBuffer )
+                {
+                    pxNetworkBuffer->pxInterface = pxBridgeInterface;
+                }
+            }
+        }
+
+        return eReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Handle the network-down event of a bridge port.
+ *
+ * @param[in] pxInterface The interface that went down.
+ *
+ * @return pdTRUE when the event was handled, pdFALSE when 'pxInterface'
+ *         is not a port of a bridge.
+ */
+    BaseType_t xBridgePortDown( NetworkInterface_t * pxInterface )
+    {
+        BaseType_t xReturn = pdFALSE;
+
+        if( pxInterface->pxBridge != NULL )
+        {
+            if( pxInterface->pfInitialise( pxInterface ) == pdPASS )
+            {
+                pxInterface->bits.bInterfaceUp = pdTRUE_UNSIGNED;
+            }
+            else
+            {
+                /* The network timer will send a new network-down event. */
+                vSetAllNetworksUp( pdFALSE );
+            }
+
+            prvBridgeUpdatePorts( pxInterface->pxBridge );
+            xReturn = pdTRUE;
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Check the links of the ports of all bridges, and remove the MAC
+ *        addresses that have aged.
+ */
+    void vBridgeCheckPorts( void )
+    {
+        NetworkInterface_t * pxInterface;
+        TickType_t xNow = xTaskGetTickCount();
+
+        for( pxInterface = FreeRTOS_FirstNetworkInterface();
+             pxInterface != NULL;
+             pxInterface = FreeRTOS_NextNetworkInterface( pxInterface ) )
+        {
+            if( pxInterface->pfOutput == prvBridge_Output )
+            {
+                Bridge_t * pxBridge = bridgeGET_BRIDGE( pxInterface );
+                size_t uxIndex;
+
+                prvBridgeUpdatePorts( pxInterface );
+
+                for( uxIndex = 0U; uxIndex < ( size_t ) ipconfigBRIDGE_MAC_TABLE_SIZE; uxIndex++ )
+                {
+                    BridgeMACEntry_t * pxEntry = &( pxBridge->xMACTable[ uxIndex ] );
+
+                    if( ( pxEntry->ucInUse != pdFALSE_UNSIGNED ) &&
+                        ( ( xNow - pxEntry->xLastSeen ) >= bridgeMAC_AGE_TICKS ) )
+                    {
+                        pxEntry->ucInUse = pdFALSE_UNSIGNED;
+                    }
+                }
+            }
+        }
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief The ports are initialised by their own network-down events, see
+ *        xBridgePortDown(). The bridge is up as soon as one port is up.
+ *
+ * @param[in] pxInterface The interface of the bridge.
+ *
+ * @return pdPASS as soon as at least one port is up.
+ */
+    static BaseType_t prvBridge_Initialise( NetworkInterface_t * pxInterface )
+    {
+        BaseType_t xReturn = pdFAIL;
+        const Bridge_t * pxBridge = bridgeGET_BRIDGE( pxInterface );
+        UBaseType_t uxIndex;
+
+        for( uxIndex = 0U; uxIndex < pxBridge->uxPortCount; uxIndex++ )
+        {
+            if( pxBridge->xPorts[ uxIndex ].pxInterface->bits.bInterfaceUp != pdFALSE_UNSIGNED )
+            {
+                xReturn = pdPASS;
+            }
+        }
+
+        prvBridgeUpdatePorts( pxInterface );
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Send a packet of this host to the port behind which its destination
+ *        lives, or to all ports when the destination is not known.
+ *
+ * @param[in] pxInterface The interface of the bridge.
+ * @param[in] pxDescriptor The packet to be sent.
+ * @param[in] bReleaseAfterSend pdTRUE when the bridge becomes the owner of the buffer.
+ *
+ * @return pdPASS when the packet was passed to at least one port, otherwise pdFAIL.
+ */
+    static BaseType_t prvBridge_Output( NetworkInterface_t * pxInterface,
+                                        NetworkBufferDescriptor_t * const pxDescriptor,
+                                        BaseType_t bReleaseAfterSend )
+    {
+        Bridge_t * pxBridge = bridgeGET_BRIDGE( pxInterface );
+        /* MISRA Ref 11.3.1 [Misaligned access] */
+        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+        /* coverity[misra_c_2012_rule_11_3_violation] */
+        const EthernetHeader_t * pxEthernetHeader = ( ( const EthernetHeader_t * ) pxDescriptor->pucEthernetBuffer );
+        const BridgeMACEntry_t * pxEntry = NULL;
+        BaseType_t xReturn;
+
+        if( !bridgeIS_GROUP_ADDRESS( &( pxEthernetHeader->xDestinationAddress ) ) )
+        {
+            pxEntry = prvBridgeLookup( pxBridge, &( pxEthernetHeader->xDestinationAddress ) );
+        }
+
+        if( ( pxEntry != NULL ) && ( ( pxBridge->ulForwarding & ( 1UL << pxEntry->ucPort ) ) != 0U ) )
+        {
+            NetworkInterface_t * pxPort = pxBridge->xPorts[ pxEntry->ucPort ].pxInterface;
+
+            xReturn = pxPort->pfOutput( pxPort, pxDescriptor, bReleaseAfterSend );
+        }
+        else
+        {
+            /* No port is excluded. */
+            xReturn = prvBridgeFlood( pxBridge, pxDescriptor, pxBridge->uxPortCount, bReleaseAfterSend );
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief A bridge has a link as long as one of its ports may forward.
+ *
+ * @param[in] pxInterface The interface of the bridge.
+ *
+ * @return pdTRUE when at least one port has a link.
+ */
+    static BaseType_t prvBridge_GetPhyLinkStatus( NetworkInterface_t * pxInterface )
+    {
+        const Bridge_t * pxBridge = bridgeGET_BRIDGE( pxInterface );
+
+        return ( pxBridge->ulForwarding != 0U ) ? pdTRUE : pdFALSE;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Read the link status of the ports of a bridge and decide which ports
+ *        may forward. A backup port only forwards while a forwarding port
+ *        has lost its link. The MAC table is flushed when the topology changes.
+ *
+ * @param[in] pxBridgeInterface The interface of the bridge.
+ */
+    static void prvBridgeUpdatePorts( NetworkInterface_t * pxBridgeInterface )
+    {
+        Bridge_t * pxBridge = bridgeGET_BRIDGE( pxBridgeInterface );
+        uint32_t ulLinkUp = 0U;
+        uint32_t ulForwarding = 0U;
+        BaseType_t xNeedBackup = pdFALSE;
+        UBaseType_t uxIndex;
+
+        for( uxIndex = 0U; uxIndex < pxBridge->uxPortCount; uxIndex++ )
+        {
+            NetworkInterface_t * pxPort = pxBridge->xPorts[ uxIndex ].pxInterface;
+
+            /* The drivers keep their link status up-to-date, normally with
+             * xPhyCheckLinkStatus() from phyHandling.c. */
+            if( ( pxPort->bits.bInterfaceUp != pdFALSE_UNSIGNED ) &&
+                ( ( pxPort->pfGetPhyLinkStatus == NULL ) || ( pxPort->pfGetPhyLinkStatus( pxPort ) != pdFALSE ) ) )
+            {
+                ulLinkUp |= ( 1UL << uxIndex );
+            }
+            else if( pxBridge->xPorts[ uxIndex ].eRole == eBridgePortForwarding )
+            {
+                xNeedBackup = pdTRUE;
+            }
+            else
+            {
+                /* A backup port without a link. */
+            }
+        }
+
+        for( uxIndex = 0U; uxIndex < pxBridge->uxPortCount; uxIndex++ )
+        {
+            if( ( ( ulLinkUp & ( 1UL << uxIndex ) ) != 0U ) &&
+                ( ( pxBridge->xPorts[ uxIndex ].eRole == eBridgePortForwarding ) || ( xNeedBackup != pdFALSE ) ) )
+            {
+                ulForwarding |= ( 1UL << uxIndex );
+            }
+        }
+
+        if( ( ulLinkUp != pxBridge->ulLinkUp ) || ( ulForwarding != pxBridge->ulForwarding ) )
+        {
+            FreeRTOS_printf( ( "Bridge: %s links 0x%02X forwarding 0x%02X -> 0x%02X\n",
+                               pxBridgeInterface->pcName,
+                               ( unsigned ) ulLinkUp,
+                               ( unsigned ) pxBridge->ulForwarding,
+                               ( unsigned ) ulForwarding ) );
+
+            /* The stations may now be reached through other ports. */
+            pxBridge->ulLinkUp = ulLinkUp;
+            pxBridge->ulForwarding = ulForwarding;
+            vBridgeFlushMACTable( pxBridgeInterface );
+        }
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Find the index of a port in a bridge.
+ *
+ * @param[in] pxBridge The state of the bridge.
+ * @param[in] pxInterface The interface of the port.
+ *
+ * @return The index of the port, or 'uxPortCount' when it was not found.
+ */
+    static UBaseType_t prvBridgePortIndex( const Bridge_t * pxBridge,
+                                           const NetworkInterface_t * pxInterface )
+    {
+        UBaseType_t uxIndex;
+
+        for( uxIndex = 0U; uxIndex < pxBridge->uxPortCount; uxIndex++ )
+        {
+            if( pxBridge->xPorts[ uxIndex ].pxInterface == pxInterface )
+            {
+                break;
+            }
+        }
+
+        return uxIndex;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Check if a MAC address belongs to one of the end-points of a bridge.
+ *
+ * @param[in] pxBridgeInterface The interface of the bridge.
+ * @param[in] pxMACAddress The destination address of a frame.
+ *
+ * @return pdTRUE when the frame is addressed to this host.
+ */
+    static BaseType_t prvBridgeIsLocal( const NetworkInterface_t * pxBridgeInterface,
+                                        const MACAddress_t * pxMACAddress )
+    {
+        BaseType_t xReturn = pdFALSE;
+        const NetworkEndPoint_t * pxEndPoint;
+
+        for( pxEndPoint = FreeRTOS_FirstEndPoint( pxBridgeInterface );
+             pxEndPoint != NULL;
+             pxEndPoint = FreeRTOS_NextEndPoint( pxBridgeInterface, ( NetworkEndPoint_t * ) pxEndPoint ) )
+        {
+            if( memcmp( pxEndPoint->xMACAddress.ucBytes, pxMACAddress->ucBytes, ipMAC_ADDRESS_LENGTH_BYTES ) == 0 )
+            {
+                xReturn = pdTRUE;
+                break;
+            }
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Send a frame to all ports that may forward, except to the port on
+ *        which it was received. Every port gets its own copy, except for the
+ *        last one, which gets the original buffer if the bridge owns it.
+ *
+ * @param[in] pxBridge The state of the bridge.
+ * @param[in] pxNetworkBuffer The frame to be sent.
+ * @param[in] uxInPort The port on which the frame was received, or 'uxPortCount'.
+ * @param[in] bReleaseAfterSend pdTRUE when the bridge owns the network buffer.
+ *
+ * @return pdPASS when the frame was passed to at least one port.
+ */
+    static BaseType_t prvBridgeFlood( Bridge_t * pxBridge,
+                                      NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                      UBaseType_t uxInPort,
+                                      BaseType_t bReleaseAfterSend )
+    {
+        BaseType_t xReturn = pdFAIL;
+        UBaseType_t uxLast = pxBridge->uxPortCount;
+        UBaseType_t uxIndex;
+
+        for( uxIndex = 0U; uxIndex < pxBridge->uxPortCount; uxIndex++ )
+        {
+            if( ( uxIndex != uxInPort ) && ( ( pxBridge->ulForwarding & ( 1UL << uxIndex ) ) != 0U ) )
+            {
+                uxLast = uxIndex;
+            }
+        }
+
+        for( uxIndex = 0U; uxIndex <= uxLast; uxIndex++ )
+        {
+            if( ( uxIndex < pxBridge->uxPortCount ) &&
+                ( uxIndex != uxInPort ) &&
+                ( ( pxBridge->ulForwarding & ( 1UL << uxIndex ) ) != 0U ) )
+            {
+                BridgePort_t * pxPort = &( pxBridge->xPorts[ uxIndex ] );
+                NetworkBufferDescriptor_t * pxBuffer = pxNetworkBuffer;
+
+                if( ( uxIndex != uxLast ) || ( bReleaseAfterSend == pdFALSE ) )
+                {
+                    pxBuffer = pxDuplicateNetworkBufferWithDescriptor( pxNetworkBuffer, pxNetworkBuffer->xDataLength );
+                }
+
+                if( pxBuffer != NULL )
+                {
+                    pxPort->ulForwarded++;
+                    ( void ) pxPort->pxInterface->pfOutput( pxPort->pxInterface, pxBuffer, pdTRUE );
+                    xReturn = pdPASS;
+                }
+            }
+        }
+
+        if( xReturn != pdFAIL )
+        {
+            pxBridge->ulFlooded++;
+        }
+
+        if( ( uxLast == pxBridge->uxPortCount ) && ( bReleaseAfterSend != pdFALSE ) )
+        {
+            /* No port may forward, the buffer is not needed anymore. */
+            vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Get the bucket of the MAC table in which an address is stored.
+ *
+ * @param[in] pxBridge The state of the bridge.
+ * @param[in] pxMACAddress The MAC address.
+ *
+ * @return The first entry of the bucket.
+ */
+    static BridgeMACEntry_t * prvBridgeBucket( Bridge_t * pxBridge,
+                                               const MACAddress_t * pxMACAddress )
+    {
+        uint32_t ulHash;
+
+        /* The last 4 bytes differ most between the devices of a vendor. */
+        ulHash = ( ( uint32_t ) pxMACAddress->ucBytes[ 2 ] << 24 ) |
+                 ( ( uint32_t ) pxMACAddress->ucBytes[ 3 ] << 16 ) |
+                 ( ( uint32_t ) pxMACAddress->ucBytes[ 4 ] << 8 ) |
+                 ( ( uint32_t ) pxMACAddress->ucBytes[ 5 ] );
+        ulHash ^= ( ( uint32_t ) pxMACAddress->ucBytes[ 0 ] << 8 ) | ( uint32_t ) pxMACAddress->ucBytes[ 1 ];
+
+        /* Fibonacci hashing, the upper bits are the best mixed. */
+        ulHash *= 0x9E3779B1U;
+        ulHash = ( ulHash >> 16 ) & ( bridgeBUCKET_COUNT - 1U );
+
+        return &( pxBridge->xMACTable[ ulHash * bridgeBUCKET_SIZE ] );
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Look up the port behind which a MAC address lives.
+ *
+ * @param[in] pxBridge The state of the bridge.
+ * @param[in] pxMACAddress The destination address of a frame.
+ *
+ * @return The entry that was learned, or NULL when the address is not known.
+ */
+    static BridgeMACEntry_t * prvBridgeLookup( Bridge_t * pxBridge,
+                                               const MACAddress_t * pxMACAddress )
+    {
+        BridgeMACEntry_t * pxBucket = prvBridgeBucket( pxBridge, pxMACAddress );
+        BridgeMACEntry_t * pxReturn = NULL;
+        TickType_t xNow = xTaskGetTickCount();
+        size_t uxIndex;
+
+        for( uxIndex = 0U; uxIndex < bridgeBUCKET_SIZE; uxIndex++ )
+        {
+            if( ( pxBucket[ uxIndex ].ucInUse != pdFALSE_UNSIGNED ) &&
+                ( memcmp( pxBucket[ uxIndex ].xMACAddress.ucBytes, pxMACAddress->ucBytes, ipMAC_ADDRESS_LENGTH_BYTES ) == 0 ) )
+            {
+                /* An entry may have aged since the last check. */
+                if( ( xNow - pxBucket[ uxIndex ].xLastSeen ) < bridgeMAC_AGE_TICKS )
+                {
+                    pxReturn = &( pxBucket[ uxIndex ] );
+                }
+
+                break;
+            }
+        }
+
+        return pxReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Learn or refresh the port behind which a MAC address lives.
+ *
+ * @param[in] pxBridge The state of the bridge.
+ * @param[in] pxMACAddress The source address of a received frame.
+ * @param[in] uxPort The port on which the frame was received.
+ */
+    static void prvBridgeLearn( Bridge_t * pxBridge,
+                                const MACAddress_t * pxMACAddress,
+                                UBaseType_t uxPort )
+    {
+        BridgeMACEntry_t * pxBucket = prvBridgeBucket( pxBridge, pxMACAddress );
+        BridgeMACEntry_t * pxEntry = NULL;
+        TickType_t xNow = xTaskGetTickCount();
+        TickType_t xOldestAge = 0U;
+        size_t uxIndex;
+
+        for( uxIndex = 0U; uxIndex < bridgeBUCKET_SIZE; uxIndex++ )
+        {
+            if( pxBucket[ uxIndex ].ucInUse == pdFALSE_UNSIGNED )
+            {
+                if( ( pxEntry == NULL ) || ( pxEntry->ucInUse != pdFALSE_UNSIGNED ) )
+                {
+                    /* Prefer a free entry over the oldest entry. */
+                    pxEntry = &( pxBucket[ uxIndex ] );
+                }
+            }
+            else if( memcmp( pxBucket[ uxIndex ].xMACAddress.ucBytes, pxMACAddress->ucBytes, ipMAC_ADDRESS_LENGTH_BYTES ) == 0 )
+            {
+                pxEntry = &( pxBucket[ uxIndex ] );
+                break;
+            }
+            else if( ( pxEntry == NULL ) ||
+                     ( ( pxEntry->ucInUse != pdFALSE_UNSIGNED ) && ( ( xNow - pxBucket[ uxIndex ].xLastSeen ) > xOldestAge ) ) )
+            {
+                pxEntry = &( pxBucket[ uxIndex ] );
+                xOldestAge = xNow - pxEntry->xLastSeen;
+            }
+            else
+            {
+                /* Keep the entry that was found. */
+            }
+        }
+
+        ( void ) memcpy( pxEntry->xMACAddress.ucBytes, pxMACAddress->ucBytes, ipMAC_ADDRESS_LENGTH_BYTES );
+        pxEntry->ucPort = ( uint8_t ) uxPort;
+        pxEntry->ucInUse = pdTRUE_UNSIGNED;
+        pxEntry->xLastSeen = xNow;
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* ( ipconfigUSE_BRIDGE != 0 ) */
@@ -1398,7 +1398,7 @@
 
         /* Obtain a network buffer with the required amount of storage.  It doesn't make much sense
          * to use a time-out here, because that would cause the IP-task to wait for itself. */
-        pxNetworkBuffer = pxGetNetworkBufferWithDescriptor( sizeof( UDPPacket_t ) + uxRequiredBufferSize, 0U );
+        pxNetworkBuffer = pxGetNetworkBufferWithClass( sizeof( UDPPacket_t ) + uxRequiredBufferSize, 0U, eBufferClassControl );
 
         if( pxNetworkBuffer != NULL )
         {
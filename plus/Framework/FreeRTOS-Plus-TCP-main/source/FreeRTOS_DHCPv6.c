@@ -529,6 +529,15 @@ static void vDHCPv6ProcessEndPoint_HandleReply( NetworkEndPoint_t * pxEndPoint,
 
     vDHCP_RATimerReload( ( struct xNetworkEndPoint * ) pxEndPoint, EP_DHCPData.ulLeaseTime );
 
+    #if ( ipconfigRA_PARALLEL_DHCPv6 != 0 )
+        if( END_POINT_USES_RA( pxEndPoint ) )
+        {
+            /* DHCPv6 was faster than RA/SLAAC, which is running in parallel. Stop it. */
+            vIPSetRATimerEnableState( pxEndPoint, pdFALSE );
+            pxEndPoint->xRAData.eRAState = eRAStateFailed;
+        }
+    #endif /* ( ipconfigRA_PARALLEL_DHCPv6 != 0 ) */
+
     /* DHCP failed, the default configured IP-address will be used
      * Now call vIPNetworkUpCalls() to send the network-up event and
      * start the ARP timer. */
@@ -802,19 +811,33 @@ static void vDHCPv6ProcessEndPoint( BaseType_t xReset,
 
         if( xGivingUp != pdFALSE )
         {
+            BaseType_t xUseDefaults = pdTRUE;
+
             FreeRTOS_debug_printf( ( "vDHCPv6ProcessEndPoint: Giving up\n" ) );
 
             /* xGivingUp became true either because of a time-out, or because
              * xApplicationDHCPHook_Multi() returned another value than 'eDHCPContinue',
              * meaning that the conversion is cancelled from here. */
 
-            /* Revert to static IP address. */
-            taskENTER_CRITICAL();
+            #if ( ipconfigRA_PARALLEL_DHCPv6 != 0 )
+                if( END_POINT_USES_RA( pxEndPoint ) && ( pxEndPoint->xRAData.eRAState != eRAStateFailed ) )
+                {
+                    /* RA/SLAAC, which runs in parallel, has supplied an address or
+                     * is still working on it. It will bring up the end-point. */
+                    xUseDefaults = pdFALSE;
+                }
+            #endif /* ( ipconfigRA_PARALLEL_DHCPv6 != 0 ) */
+
+            if( xUseDefaults != pdFALSE )
             {
-                ( void ) memcpy( EP_IPv6_SETTINGS.xIPAddress.ucBytes, pxEndPoint->ipv6_defaults.xIPAddress.ucBytes, ipSIZE_OF_IPv6_ADDRESS );
-                iptraceDHCP_REQUESTS_FAILED_USING_DEFAULT_IPv6_ADDRESS( EP_IPv6_SETTINGS.xIPAddress );
+                /* Revert to static IP address. */
+                taskENTER_CRITICAL();
+                {
+                    ( void ) memcpy( EP_IPv6_SETTINGS.xIPAddress.ucBytes, pxEndPoint->ipv6_defaults.xIPAddress.ucBytes, ipSIZE_OF_IPv6_ADDRESS );
+                    iptraceDHCP_REQUESTS_FAILED_USING_DEFAULT_IPv6_ADDRESS( EP_IPv6_SETTINGS.xIPAddress );
+                }
+                taskEXIT_CRITICAL();
             }
-            taskEXIT_CRITICAL();
 
             EP_DHCPData.eDHCPState = eNotUsingLeasedAddress;
             vIPSetDHCP_RATimerEnableState( pxEndPoint, pdFALSE );
@@ -822,10 +845,13 @@ static void vDHCPv6ProcessEndPoint( BaseType_t xReset,
             /* Close socket to ensure packets don't queue on it. */
             prvCloseDHCPv6Socket( pxEndPoint );
 
-            /* DHCP failed, the default configured IP-address will be used. Now
-             * call vIPNetworkUpCalls() to send the network-up event and start the ARP
-             * timer. */
-            vIPNetworkUpCalls( pxEndPoint );
+            if( ( xUseDefaults != pdFALSE ) && ( pxEndPoint->bits.bEndPointUp == pdFALSE_UNSIGNED ) )
+            {
+                /* DHCP failed, the default configured IP-address will be used. Now
+                 * call vIPNetworkUpCalls() to send the network-up event and start the ARP
+                 * timer. */
+                vIPNetworkUpCalls( pxEndPoint );
+            }
         }
     }
 }
@@ -813,9 +813,10 @@
         /* Get a buffer.  This uses a maximum delay, but the delay will be
          * capped to ipconfigUDP_MAX_SEND_BLOCK_TIME_TICKS so the return value
          * still needs to be tested. */
-        *ppxNetworkBuffer = pxGetNetworkBufferWithDescriptor( uxExpectedPayloadLength +
-                                                              uxHeaderBytes,
-                                                              0U );
+        *ppxNetworkBuffer = pxGetNetworkBufferWithClass( uxExpectedPayloadLength +
+                                                         uxHeaderBytes,
+                                                         0U,
+                                                         eBufferClassControl );
 
         if( *ppxNetworkBuffer != NULL )
         {
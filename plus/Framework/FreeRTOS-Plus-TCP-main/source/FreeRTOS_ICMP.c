@@ -98,9 +98,13 @@
             /* coverity[misra_c_2012_rule_11_3_violation] */
             ICMPPacket_t * pxICMPPacket = ( ( ICMPPacket_t * ) pxNetworkBuffer->pucEthernetBuffer );
 
+            ipCOUNT( ulIcmpInMsgs );
+
             switch( pxICMPPacket->xICMPHeader.ucTypeOfMessage )
             {
                 case ipICMP_ECHO_REQUEST:
+                    ipCOUNT( ulIcmpInEchos );
+
                     #if ( ipconfigREPLY_TO_INCOMING_PINGS == 1 )
                     {
                         eReturn = prvProcessICMPEchoRequest( pxICMPPacket, pxNetworkBuffer );
@@ -109,6 +113,8 @@
                     break;
 
                 case ipICMP_ECHO_REPLY:
+                    ipCOUNT( ulIcmpInEchoReps );
+
                     #if ( ipconfigSUPPORT_OUTGOING_PINGS == 1 )
                     {
                         prvProcessICMPEchoReply( pxICMPPacket );
@@ -191,6 +197,10 @@
         }
         #endif /* if ( ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM == 0 ) */
 
+        ipCOUNT( ulIcmpOutEchoReps );
+        ipCOUNT( ulIcmpOutMsgs );
+        ipCOUNT( ulIpOutRequests );
+
         return eReturnEthernetFrame;
     }
 
@@ -59,6 +59,9 @@
 #include "FreeRTOS_DNS.h"
 #include "FreeRTOS_Routing.h"
 #include "FreeRTOS_ND.h"
+#include "FreeRTOS_Bonding.h"
+#include "FreeRTOS_Bridge.h"
+#include "FreeRTOS_PacketSocket.h"
 
 /** @brief Time delay between repeated attempts to initialise the network hardware. */
 #ifndef ipINITIALISATION_RETRY_DELAY
@@ -167,17 +170,43 @@ static eFrameProcessingResult_t prvProcessIPPacket( const IPPacket_t * pxIPPacke
  */
 static void prvHandleEthernetPacket( NetworkBufferDescriptor_t * pxBuffer );
 
-/* Handle the 'eNetworkTxEvent': forward a packet from an application to the NIC. */
-static void prvForwardTxPacket( NetworkBufferDescriptor_t * pxNetworkBuffer,
-                                BaseType_t xReleaseAfterSend );
-
 static eFrameProcessingResult_t prvProcessUDPPacket( NetworkBufferDescriptor_t * const pxNetworkBuffer );
 
+/* Wait for the next event to be processed by the IP-task. */
+static BaseType_t prvReceiveIPEvent( IPStackEvent_t * pxEvent,
+                                     TickType_t xBlockTime );
+
+#if ( ipconfigUSE_EVENT_LANES != 0 )
+    /* Get the lane through which an event will be sent. */
+    static eIPEventLane_t prvEventLane( eIPEvent_t eEvent );
+
+    /* Make sure that an IP-task blocked on the bulk lane wakes up. */
+    static void prvWakeIPTask( BaseType_t * pxHigherPriorityTaskWoken );
+#endif
+
 /*-----------------------------------------------------------*/
 
 /** @brief The queue used to pass events into the IP-task for processing. */
 QueueHandle_t xNetworkEventQueue = NULL;
 
+#if ( ipconfigUSE_EVENT_LANES != 0 )
+
+/** @brief An event in the control or the transmit lane, with the time at which
+ *         it was posted. The bulk lane holds plain IPStackEvent_t's, because
+ *         drivers may post to 'xNetworkEventQueue' directly. */
+    typedef struct xIP_LANE_EVENT
+    {
+        IPStackEvent_t xEvent; /**< The event itself. */
+        TickType_t xPostTime;  /**< The tick count at which the event was posted. */
+    } IPLaneEvent_t;
+
+    /** @brief The event lanes, see ipconfigUSE_EVENT_LANES. The bulk lane is 'xNetworkEventQueue'. */
+    static QueueHandle_t xIPEventLanes[ eIPLaneCount ];
+
+    /** @brief The number of events taken from the higher lanes since the lower lanes had a turn. */
+    static UBaseType_t uxLaneBurstCount = 0U;
+#endif
+
 /** @brief The IP packet ID. */
 uint16_t usPacketIdentifier = 0U;
 
@@ -260,14 +289,18 @@ static void prvProcessIPEventsAndTimers( void )
     /* Calculate the acceptable maximum sleep time. */
     xNextIPSleep = xCalculateSleepTime();
 
+    iptraceIP_TASK_LOOP_END();
+
     /* Wait until there is something to do. If the following call exits
      * due to a time out rather than a message being received, set a
      * 'NoEvent' value. */
-    if( xQueueReceive( xNetworkEventQueue, ( void * ) &xReceivedEvent, xNextIPSleep ) == pdFALSE )
+    if( prvReceiveIPEvent( &( xReceivedEvent ), xNextIPSleep ) == pdFALSE )
     {
         xReceivedEvent.eEventType = eNoEvent;
     }
 
+    iptraceIP_TASK_LOOP_START( xReceivedEvent.eEventType );
+
     #if ( ipconfigCHECK_IP_QUEUE_SPACE != 0 )
     {
         if( xReceivedEvent.eEventType != eNoEvent )
@@ -289,8 +322,18 @@ static void prvProcessIPEventsAndTimers( void )
     switch( xReceivedEvent.eEventType )
     {
         case eNetworkDownEvent:
-            /* Attempt to establish a connection. */
-            prvProcessNetworkDownEvent( ( ( NetworkInterface_t * ) xReceivedEvent.pvData ) );
+            #if ( ipconfigUSE_BONDING != 0 )
+                /* When a member of a bond goes down, the bond stays up. */
+                if( xBondingMemberDown( ( NetworkInterface_t * ) xReceivedEvent.pvData ) == pdFALSE )
+            #endif
+            #if ( ipconfigUSE_BRIDGE != 0 )
+                /* When a port of a bridge goes down, the bridge stays up. */
+                if( xBridgePortDown( ( NetworkInterface_t * ) xReceivedEvent.pvData ) == pdFALSE )
+            #endif
+            {
+                /* Attempt to establish a connection. */
+                prvProcessNetworkDownEvent( ( ( NetworkInterface_t * ) xReceivedEvent.pvData ) );
+            }
             break;
 
         case eNetworkRxEvent:
@@ -305,7 +348,7 @@ static void prvProcessIPEventsAndTimers( void )
 
             /* Send a network packet. The ownership will  be transferred to
              * the driver, which will release it after delivery. */
-            prvForwardTxPacket( ( ( NetworkBufferDescriptor_t * ) xReceivedEvent.pvData ), pdTRUE );
+            vIPForwardTxPacket( ( ( NetworkBufferDescriptor_t * ) xReceivedEvent.pvData ), pdTRUE );
             break;
 
         case eARPTimerEvent:
@@ -373,6 +416,9 @@ static void prvProcessIPEventsAndTimers( void )
              * IP-task to actually close a socket. This is handled in
              * vSocketClose().  As the socket gets closed, there is no way to
              * report back to the API, so the API won't wait for the result */
+            #if ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_IP_COUNTERS != 0 ) )
+                vTCPCountSocketClose( ( ( FreeRTOS_Socket_t * ) xReceivedEvent.pvData ) );
+            #endif
             ( void ) vSocketClose( ( ( FreeRTOS_Socket_t * ) xReceivedEvent.pvData ) );
             break;
 
@@ -464,7 +510,8 @@ static void prvProcessIPEventsAndTimers( void )
             break;
 
         case eNoEvent:
-            /* xQueueReceive() returned because of a normal time-out. */
+            /* xQueueReceive() returned because of a normal time-out, or
+             * the IP-task was woken up to look at the event lanes. */
             break;
 
         default:
@@ -508,6 +555,20 @@ static void prvIPTask_Initialise( void )
     }
     #endif
 
+    #if ( ipconfigUSE_BONDING != 0 )
+    {
+        /* Start checking the links of the bond members. */
+        vBondingTimerReload( pdMS_TO_TICKS( ipconfigBONDING_MONITOR_PERIOD_MS ) );
+    }
+    #endif
+
+    #if ( ipconfigUSE_BRIDGE != 0 )
+    {
+        /* Start checking the bridge ports and the age of the learned addresses. */
+        vBridgeTimerReload( pdMS_TO_TICKS( ipconfigBRIDGE_MONITOR_PERIOD_MS ) );
+    }
+    #endif
+
     /* Mark the timer as inactive since we are not waiting on any ARP resolution as of now. */
     vIPSetARPResolutionTimerEnableState( pdFALSE );
 
@@ -531,6 +592,168 @@ static void prvIPTask_Initialise( void )
 }
 /*-----------------------------------------------------------*/
 
+/**
+ * @brief Wait for the next event to be processed by the IP-task.
+ *
+ * @param[out] pxEvent Where the event will be stored.
+ * @param[in] xBlockTime The maximum time to wait for an event.
+ *
+ * @return pdTRUE when an event was received, pdFALSE after a time-out.
+ */
+static BaseType_t prvReceiveIPEvent( IPStackEvent_t * pxEvent,
+                                     TickType_t xBlockTime )
+{
+    BaseType_t xReturn;
+
+    #if ( ipconfigUSE_EVENT_LANES != 0 )
+    {
+        BaseType_t xIndex;
+        BaseType_t xLane = ( BaseType_t ) eIPLaneCount;
+        BaseType_t xReverse = ( uxLaneBurstCount >= ( UBaseType_t ) ipconfigEVENT_LANE_BURST ) ? pdTRUE : pdFALSE;
+        IPLaneEvent_t xLaneEvent;
+        TickType_t xTicksWaited = 0U;
+
+        xReturn = pdFALSE;
+
+        /* Visit the lanes in order of priority, or once in reverse order
+         * when the higher lanes had their burst. */
+        for( xIndex = 0; xIndex < ( BaseType_t ) eIPLaneCount; xIndex++ )
+        {
+            xLane = ( xReverse != pdFALSE ) ? ( ( ( BaseType_t ) eIPLaneCount - 1 ) - xIndex ) : xIndex;
+
+            if( uxQueueMessagesWaiting( xIPEventLanes[ xLane ] ) != 0U )
+            {
+                if( xLane == ( BaseType_t ) eIPLaneBulk )
+                {
+                    xReturn = xQueueReceive( xIPEventLanes[ xLane ], ( void * ) pxEvent, 0U );
+                }
+                else if( xQueueReceive( xIPEventLanes[ xLane ], ( void * ) &( xLaneEvent ), 0U ) != pdFALSE )
+                {
+                    *pxEvent = xLaneEvent.xEvent;
+                    xTicksWaited = xTaskGetTickCount() - xLaneEvent.xPostTime;
+                    xReturn = pdTRUE;
+                }
+                else
+                {
+                    /* Nothing to do. */
+                }
+            }
+
+            if( xReturn != pdFALSE )
+            {
+                break;
+            }
+        }
+
+        if( xReturn == pdFALSE )
+        {
+            /* All lanes are empty, sleep on the bulk lane. The senders to
+             * the other lanes will post an eNoEvent to wake up the IP-task. */
+            xLane = ( BaseType_t ) eIPLaneBulk;
+            xReturn = xQueueReceive( xIPEventLanes[ eIPLaneBulk ], ( void * ) pxEvent, xBlockTime );
+        }
+
+        if( xReturn != pdFALSE )
+        {
+            if( xReverse != pdFALSE )
+            {
+                uxLaneBurstCount = 0U;
+            }
+            else if( ( xLane != ( BaseType_t ) eIPLaneBulk ) &&
+                     ( uxQueueMessagesWaiting( xIPEventLanes[ eIPLaneBulk ] ) != 0U ) )
+            {
+                /* Only count the events that overtook waiting events. */
+                uxLaneBurstCount++;
+            }
+            else
+            {
+                uxLaneBurstCount = 0U;
+            }
+
+            iptraceEVENT_LANE_RECEIVED( xLane, xTicksWaited );
+
+            /* In case the trace macro is not defined. */
+            ( void ) xTicksWaited;
+        }
+    }
+    #else /* if ( ipconfigUSE_EVENT_LANES != 0 ) */
+    {
+        xReturn = xQueueReceive( xNetworkEventQueue, ( void * ) pxEvent, xBlockTime );
+    }
+    #endif /* if ( ipconfigUSE_EVENT_LANES != 0 ) */
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+#if ( ipconfigUSE_EVENT_LANES != 0 )
+
+/**
+ * @brief Get the lane through which an event must be sent.
+ *
+ * @param[in] eEvent The type of the event.
+ *
+ * @return The lane of the event.
+ */
+    static eIPEventLane_t prvEventLane( eIPEvent_t eEvent )
+    {
+        eIPEventLane_t eLane;
+
+        switch( eEvent )
+        {
+            case eNetworkRxEvent:
+                eLane = eIPLaneBulk;
+                break;
+
+            case eNetworkTxEvent:
+            case eStackTxEvent:
+            case eTCPTimerEvent:
+                eLane = eIPLaneTransmit;
+                break;
+
+            default:
+                eLane = eIPLaneControl;
+                break;
+        }
+
+        return eLane;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief After an event was posted to the control or the transmit lane, make
+ *        sure that the IP-task wakes up. The IP-task sleeps on the bulk lane,
+ *        so an eNoEvent is posted there, unless the bulk lane has events already.
+ *
+ * @param[in,out] pxHigherPriorityTaskWoken NULL when called from a task,
+ *                otherwise the flag of the ISR.
+ */
+    static void prvWakeIPTask( BaseType_t * pxHigherPriorityTaskWoken )
+    {
+        IPStackEvent_t xWakeUpEvent;
+
+        xWakeUpEvent.eEventType = eNoEvent;
+        xWakeUpEvent.pvData = NULL;
+
+        if( pxHigherPriorityTaskWoken == NULL )
+        {
+            if( uxQueueMessagesWaiting( xIPEventLanes[ eIPLaneBulk ] ) == 0U )
+            {
+                ( void ) xQueueSendToBack( xIPEventLanes[ eIPLaneBulk ], &( xWakeUpEvent ), 0U );
+            }
+        }
+        else
+        {
+            if( uxQueueMessagesWaitingFromISR( xIPEventLanes[ eIPLaneBulk ] ) == 0U )
+            {
+                ( void ) xQueueSendToBackFromISR( xIPEventLanes[ eIPLaneBulk ], &( xWakeUpEvent ), pxHigherPriorityTaskWoken );
+            }
+        }
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* ipconfigUSE_EVENT_LANES */
+
 /**
  * @brief Check the value of 'xNetworkDownEventPending'. When non-zero, pending
  *        network-down events will be handled.
@@ -596,8 +819,9 @@ static void prvCallDHCP_RA_Handler( NetworkEndPoint_t * pxEndPoint )
         }
     }
     #endif /* ipconfigUSE_DHCPv6 */
-    #if ( ( ipconfigUSE_RA == 1 ) && ( ipconfigUSE_IPv6 != 0 ) )
+    #if ( ( ipconfigUSE_RA == 1 ) && ( ipconfigUSE_IPv6 != 0 ) && ( ipconfigRA_PARALLEL_DHCPv6 == 0 ) )
     {
+        /* When ipconfigRA_PARALLEL_DHCPv6 is enabled, RA is driven by its own timer. */
         if( ( xIsIPv6 == pdTRUE ) && ( pxEndPoint->bits.bWantRA != pdFALSE_UNSIGNED ) )
         {
             /* Process RA messages for a given end-point. */
@@ -706,18 +930,19 @@ static void prvHandleEthernetPacket( NetworkBufferDescriptor_t * pxBuffer )
 /*-----------------------------------------------------------*/
 
 /**
- * @brief Send a network packet.
+ * @brief Send a network packet, only called by the IP-task.
  *
  * @param[in] pxNetworkBuffer The message buffer.
  * @param[in] xReleaseAfterSend When true, the network interface will own the buffer and is responsible for it's release.
  */
-static void prvForwardTxPacket( NetworkBufferDescriptor_t * pxNetworkBuffer,
-                                BaseType_t xReleaseAfterSend )
+void vIPForwardTxPacket( NetworkBufferDescriptor_t * pxNetworkBuffer,
+                         BaseType_t xReleaseAfterSend )
 {
     iptraceNETWORK_INTERFACE_OUTPUT( pxNetworkBuffer->xDataLength, pxNetworkBuffer->pucEthernetBuffer );
 
     if( pxNetworkBuffer->pxInterface != NULL )
     {
+        ipCOUNT_IF_OUTPUT( pxNetworkBuffer->pxInterface, pxNetworkBuffer );
         ( void ) pxNetworkBuffer->pxInterface->pfOutput( pxNetworkBuffer->pxInterface, pxNetworkBuffer, xReleaseAfterSend );
     }
 }
@@ -775,7 +1000,7 @@ BaseType_t FreeRTOS_NetworkDownFromISR( struct xNetworkInterface * pxNetworkInte
     xNetworkDownEvent.pvData = pxNetworkInterface;
 
     /* Simply send the network task the appropriate event. */
-    if( xQueueSendToBackFromISR( xNetworkEventQueue, &xNetworkDownEvent, &xHigherPriorityTaskWoken ) != pdPASS )
+    if( xSendEventStructToIPTaskFromISR( &xNetworkDownEvent, &xHigherPriorityTaskWoken ) != pdPASS )
     {
         /* Could not send the message, so it is still pending. */
         pxNetworkInterface->bits.bCallDownEvent = pdTRUE;
@@ -872,7 +1097,7 @@ void * FreeRTOS_GetUDPPayloadBuffer_Multi( size_t uxRequestedSizeBytes,
     if( uxPayloadOffset != 0U )
     {
         /* Obtain a network buffer with the required amount of storage. */
-        pxNetworkBuffer = pxGetNetworkBufferWithDescriptor( uxPayloadOffset + uxRequestedSizeBytes, uxBlockTime );
+        pxNetworkBuffer = pxGetNetworkBufferWithClass( uxPayloadOffset + uxRequestedSizeBytes, uxBlockTime, eBufferClassUDP_TX );
 
         if( pxNetworkBuffer != NULL )
         {
@@ -969,6 +1194,38 @@ BaseType_t FreeRTOS_IPInit_Multi( void )
     }
     #endif /* configSUPPORT_STATIC_ALLOCATION */
 
+    #if ( ipconfigUSE_EVENT_LANES != 0 )
+    {
+        /* Create the control and the transmit lanes. */
+        #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+        {
+            static StaticQueue_t xControlLaneStaticQueue;
+            static StaticQueue_t xTransmitLaneStaticQueue;
+            static uint8_t ucControlLaneStorageArea[ ipconfigEVENT_LANE_LENGTH_CONTROL * sizeof( IPLaneEvent_t ) ];
+            static uint8_t ucTransmitLaneStorageArea[ ipconfigEVENT_LANE_LENGTH_TX * sizeof( IPLaneEvent_t ) ];
+
+            xIPEventLanes[ eIPLaneControl ] = xQueueCreateStatic( ipconfigEVENT_LANE_LENGTH_CONTROL,
+                                                                  sizeof( IPLaneEvent_t ),
+                                                                  ucControlLaneStorageArea,
+                                                                  &xControlLaneStaticQueue );
+            xIPEventLanes[ eIPLaneTransmit ] = xQueueCreateStatic( ipconfigEVENT_LANE_LENGTH_TX,
+                                                                   sizeof( IPLaneEvent_t ),
+                                                                   ucTransmitLaneStorageArea,
+                                                                   &xTransmitLaneStaticQueue );
+        }
+        #else
+        {
+            xIPEventLanes[ eIPLaneControl ] = xQueueCreate( ipconfigEVENT_LANE_LENGTH_CONTROL, sizeof( IPLaneEvent_t ) );
+            xIPEventLanes[ eIPLaneTransmit ] = xQueueCreate( ipconfigEVENT_LANE_LENGTH_TX, sizeof( IPLaneEvent_t ) );
+        }
+        #endif /* configSUPPORT_STATIC_ALLOCATION */
+
+        configASSERT( xIPEventLanes[ eIPLaneControl ] != NULL );
+        configASSERT( xIPEventLanes[ eIPLaneTransmit ] != NULL );
+        xIPEventLanes[ eIPLaneBulk ] = xNetworkEventQueue;
+    }
+    #endif /* ipconfigUSE_EVENT_LANES */
+
     if( xNetworkEventQueue != NULL )
     {
         #if ( configQUEUE_REGISTRY_SIZE > 0 )
@@ -977,6 +1234,13 @@ BaseType_t FreeRTOS_IPInit_Multi( void )
              * debugger.  If one is in use then it will be helpful for the debugger
              * to show information about the network event queue. */
             vQueueAddToRegistry( xNetworkEventQueue, "NetEvnt" );
+
+            #if ( ipconfigUSE_EVENT_LANES != 0 )
+            {
+                vQueueAddToRegistry( xIPEventLanes[ eIPLaneControl ], "NetCtrl" );
+                vQueueAddToRegistry( xIPEventLanes[ eIPLaneTransmit ], "NetTx" );
+            }
+            #endif
         }
         #endif /* configQUEUE_REGISTRY_SIZE */
 
@@ -1021,6 +1285,16 @@ BaseType_t FreeRTOS_IPInit_Multi( void )
             /* Clean up. */
             vQueueDelete( xNetworkEventQueue );
             xNetworkEventQueue = NULL;
+
+            #if ( ipconfigUSE_EVENT_LANES != 0 )
+            {
+                vQueueDelete( xIPEventLanes[ eIPLaneControl ] );
+                vQueueDelete( xIPEventLanes[ eIPLaneTransmit ] );
+                xIPEventLanes[ eIPLaneControl ] = NULL;
+                xIPEventLanes[ eIPLaneTransmit ] = NULL;
+                xIPEventLanes[ eIPLaneBulk ] = NULL;
+            }
+            #endif
         }
     }
     else
@@ -1293,7 +1567,7 @@ void FreeRTOS_ReleaseUDPPayloadBuffer( void const * pvBuffer )
 
         if( ( uxGetNumberOfFreeNetworkBuffers() >= 4U ) && ( uxNumberOfBytesToSend >= 1U ) && ( xEnoughSpace != pdFALSE ) )
         {
-            pxNetworkBuffer = pxGetNetworkBufferWithDescriptor( uxTotalLength, uxBlockTimeTicks );
+            pxNetworkBuffer = pxGetNetworkBufferWithClass( uxTotalLength, uxBlockTimeTicks, eBufferClassControl );
 
             if( pxNetworkBuffer != NULL )
             {
@@ -1402,7 +1676,7 @@ BaseType_t xSendEventStructToIPTask( const IPStackEvent_t * pxEvent,
                  * IP task is already awake processing other message. */
                 vIPSetTCPTimerExpiredState( pdTRUE );
 
-                if( uxQueueMessagesWaiting( xNetworkEventQueue ) != 0U )
+                if( uxIPEventsWaiting() != 0U )
                 {
                     /* Not actually going to send the message but this is not a
                      * failure as the message didn't need to be sent. */
@@ -1421,7 +1695,33 @@ BaseType_t xSendEventStructToIPTask( const IPStackEvent_t * pxEvent,
                 uxUseTimeout = ( TickType_t ) 0;
             }
 
-            xReturn = xQueueSendToBack( xNetworkEventQueue, pxEvent, uxUseTimeout );
+            #if ( ipconfigUSE_EVENT_LANES != 0 )
+            {
+                eIPEventLane_t eLane = prvEventLane( pxEvent->eEventType );
+
+                if( eLane == eIPLaneBulk )
+                {
+                    xReturn = xQueueSendToBack( xIPEventLanes[ eLane ], pxEvent, uxUseTimeout );
+                }
+                else
+                {
+                    IPLaneEvent_t xLaneEvent;
+
+                    xLaneEvent.xEvent = *pxEvent;
+                    xLaneEvent.xPostTime = xTaskGetTickCount();
+                    xReturn = xQueueSendToBack( xIPEventLanes[ eLane ], &( xLaneEvent ), uxUseTimeout );
+
+                    if( xReturn != pdFAIL )
+                    {
+                        prvWakeIPTask( NULL );
+                    }
+                }
+            }
+            #else
+            {
+                xReturn = xQueueSendToBack( xNetworkEventQueue, pxEvent, uxUseTimeout );
+            }
+            #endif /* ipconfigUSE_EVENT_LANES */
 
             if( xReturn == pdFAIL )
             {
@@ -1442,6 +1742,82 @@ BaseType_t xSendEventStructToIPTask( const IPStackEvent_t * pxEvent,
 }
 /*-----------------------------------------------------------*/
 
+/**
+ * @brief Send an event (in form of struct) to the IP task from an ISR.
+ *
+ * @param[in] pxEvent The event to be sent.
+ * @param[in,out] pxHigherPriorityTaskWoken Will be set to pdTRUE when a task
+ *                of a higher priority was woken up.
+ *
+ * @return pdPASS if the event was sent, or pdFAIL when the queue is full.
+ */
+BaseType_t xSendEventStructToIPTaskFromISR( const IPStackEvent_t * pxEvent,
+                                            BaseType_t * pxHigherPriorityTaskWoken )
+{
+    BaseType_t xReturn;
+
+    #if ( ipconfigUSE_EVENT_LANES != 0 )
+    {
+        eIPEventLane_t eLane = prvEventLane( pxEvent->eEventType );
+
+        if( eLane == eIPLaneBulk )
+        {
+            xReturn = xQueueSendToBackFromISR( xIPEventLanes[ eLane ], pxEvent, pxHigherPriorityTaskWoken );
+        }
+        else
+        {
+            IPLaneEvent_t xLaneEvent;
+
+            xLaneEvent.xEvent = *pxEvent;
+            xLaneEvent.xPostTime = xTaskGetTickCountFromISR();
+            xReturn = xQueueSendToBackFromISR( xIPEventLanes[ eLane ], &( xLaneEvent ), pxHigherPriorityTaskWoken );
+
+            if( xReturn != pdFAIL )
+            {
+                prvWakeIPTask( pxHigherPriorityTaskWoken );
+            }
+        }
+    }
+    #else
+    {
+        xReturn = xQueueSendToBackFromISR( xNetworkEventQueue, pxEvent, pxHigherPriorityTaskWoken );
+    }
+    #endif /* ipconfigUSE_EVENT_LANES */
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Get the number of events waiting to be processed by the IP-task.
+ *
+ * @return The number of events in the event queue, or in all event lanes.
+ */
+UBaseType_t uxIPEventsWaiting( void )
+{
+    UBaseType_t uxCount;
+
+    #if ( ipconfigUSE_EVENT_LANES != 0 )
+    {
+        BaseType_t xLane;
+
+        uxCount = 0U;
+
+        for( xLane = 0; xLane < ( BaseType_t ) eIPLaneCount; xLane++ )
+        {
+            uxCount += uxQueueMessagesWaiting( xIPEventLanes[ xLane ] );
+        }
+    }
+    #else
+    {
+        uxCount = uxQueueMessagesWaiting( xNetworkEventQueue );
+    }
+    #endif /* ipconfigUSE_EVENT_LANES */
+
+    return uxCount;
+}
+/*-----------------------------------------------------------*/
+
 /**
  * @brief Decide whether this packet should be processed or not based on the IP address in the packet.
  *
@@ -1553,6 +1929,38 @@ static void prvProcessEthernetPacket( NetworkBufferDescriptor_t * const pxNetwor
          * it is safe to break out of the do{}while() and let the second half of this
          * function handle the releasing of pxNetworkBuffer */
 
+        #if ( ipconfigUSE_BONDING != 0 )
+            /* A frame received by a member of a bond is handled by the bond. */
+            if( ( pxNetworkBuffer->pxInterface != NULL ) && ( xBondingReceive( pxNetworkBuffer ) == pdFALSE ) )
+            {
+                break;
+            }
+        #endif
+
+        #if ( ipconfigUSE_BRIDGE != 0 )
+            if( pxNetworkBuffer->pxInterface != NULL )
+            {
+                /* A frame received by a port of a bridge may have to be forwarded
+                 * to other ports, it does not need an end-point of this host. */
+                eReturned = eBridgeReceive( pxNetworkBuffer );
+
+                if( eReturned != eProcessBuffer )
+                {
+                    break;
+                }
+            }
+        #endif
+
+        #if ( ipconfigUSE_PACKET_SOCKETS != 0 )
+            /* Frames of other EtherTypes may be for a packet socket, which
+             * does not need an end-point. */
+            if( ( pxNetworkBuffer->pxInterface != NULL ) && ( xPacketSocketDeliver( pxNetworkBuffer ) != pdFALSE ) )
+            {
+                eReturned = eFrameConsumed;
+                break;
+            }
+        #endif
+
         if( ( pxNetworkBuffer->pxInterface == NULL ) || ( pxNetworkBuffer->pxEndPoint == NULL ) )
         {
             break;
@@ -1572,10 +1980,21 @@ static void prvProcessEthernetPacket( NetworkBufferDescriptor_t * const pxNetwor
         /* Interpret the Ethernet frame. */
         if( pxNetworkBuffer->xDataLength < sizeof( EthernetHeader_t ) )
         {
+            ipCOUNT_IF( pxNetworkBuffer->pxInterface, ulInErrors );
             break;
         }
 
-        eReturned = ipCONSIDER_FRAME_FOR_PROCESSING( pxNetworkBuffer->pucEthernetBuffer );
+        ipCOUNT_IF_INPUT( pxNetworkBuffer->pxInterface, pxNetworkBuffer );
+
+        if( INTERFACE_IS_LOOPBACK( pxNetworkBuffer->pxInterface ) != pdFALSE )
+        {
+            /* A loop-back frame was addressed by this host, to this host. */
+            eReturned = eProcessBuffer;
+        }
+        else
+        {
+            eReturned = ipCONSIDER_FRAME_FOR_PROCESSING( pxNetworkBuffer->pucEthernetBuffer );
+        }
 
         /* Map the buffer onto the Ethernet Header struct for easy access to the fields. */
 
@@ -1605,6 +2024,7 @@ static void prvProcessEthernetPacket( NetworkBufferDescriptor_t * const pxNetwor
                         }
                         else
                         {
+                            ipCOUNT_IF( pxNetworkBuffer->pxInterface, ulInErrors );
                             eReturned = eReleaseBuffer;
                         }
                         break;
@@ -1623,6 +2043,7 @@ static void prvProcessEthernetPacket( NetworkBufferDescriptor_t * const pxNetwor
                     }
                     else
                     {
+                        ipCOUNT_IF( pxNetworkBuffer->pxInterface, ulInErrors );
                         eReturned = eReleaseBuffer;
                     }
 
@@ -1634,6 +2055,7 @@ static void prvProcessEthernetPacket( NetworkBufferDescriptor_t * const pxNetwor
                         eReturned = eApplicationProcessCustomFrameHook( pxNetworkBuffer );
                     #else
                         /* No other packet types are handled.  Nothing to do. */
+                        ipCOUNT_IF( pxNetworkBuffer->pxInterface, ulInUnknownProtos );
                         eReturned = eReleaseBuffer;
                     #endif
                     break;
@@ -1673,6 +2095,7 @@ static void prvProcessEthernetPacket( NetworkBufferDescriptor_t * const pxNetwor
             else
             {
                 /* We are already waiting on one ARP resolution. This frame will be dropped. */
+                ipCOUNT_IF( pxNetworkBuffer->pxInterface, ulInDiscards );
                 vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
 
                 iptraceDELAYED_ARP_BUFFER_FULL();
@@ -1821,6 +2244,8 @@ static eFrameProcessingResult_t prvProcessIPPacket( const IPPacket_t * pxIPPacke
         const IPHeader_t * pxIPHeader = &( pxIPPacket->xIPHeader );
     #endif /* ( ipconfigUSE_IPv4 != 0 ) */
 
+    ipCOUNT( ulIpInReceives );
+
     switch( pxIPPacket->xEthernetHeader.usFrameType )
     {
         #if ( ipconfigUSE_IPv6 != 0 )
@@ -1829,6 +2254,7 @@ static eFrameProcessingResult_t prvProcessIPPacket( const IPPacket_t * pxIPPacke
                 if( pxNetworkBuffer->xDataLength < sizeof( IPPacket_IPv6_t ) )
                 {
                     /* The packet size is less than minimum IPv6 packet. */
+                    ipCOUNT( ulIpInHdrErrors );
                     eReturn = eReleaseBuffer;
                 }
                 else
@@ -1866,6 +2292,7 @@ static eFrameProcessingResult_t prvProcessIPPacket( const IPPacket_t * pxIPPacke
                    if( ( uxHeaderLength > ( pxNetworkBuffer->xDataLength - ipSIZE_OF_ETH_HEADER ) ) ||
                        ( uxHeaderLength < ipSIZE_OF_IPv4_HEADER ) )
                    {
+                       ipCOUNT( ulIpInHdrErrors );
                        eReturn = eReleaseBuffer;
                    }
                    else
@@ -1945,8 +2372,9 @@ static eFrameProcessingResult_t prvProcessIPPacket( const IPPacket_t * pxIPPacke
         {
             /* Add the IP and MAC addresses to the ARP table if they are not
              * already there - otherwise refresh the age of the existing
-             * entry. */
-            if( ucProtocol != ( uint8_t ) ipPROTOCOL_UDP )
+             * entry. The MAC address of a loop-back end-point is not cached. */
+            if( ( ucProtocol != ( uint8_t ) ipPROTOCOL_UDP ) &&
+                ( INTERFACE_IS_LOOPBACK( pxNetworkBuffer->pxInterface ) == pdFALSE ) )
             {
                 if( xCheckRequiresARPResolution( pxNetworkBuffer ) == pdTRUE )
                 {
@@ -1995,6 +2423,8 @@ static eFrameProcessingResult_t prvProcessIPPacket( const IPPacket_t * pxIPPacke
                              * also be returned, and the source of the ping will know something
                              * went wrong because it will not be able to validate what it
                              * receives. */
+                            ipCOUNT( ulIpInDelivers );
+
                             #if ( ipconfigREPLY_TO_INCOMING_PINGS == 1 ) || ( ipconfigSUPPORT_OUTGOING_PINGS == 1 )
                             {
                                 eReturn = ProcessICMPPacket( pxNetworkBuffer );
@@ -2005,18 +2435,21 @@ static eFrameProcessingResult_t prvProcessIPPacket( const IPPacket_t * pxIPPacke
 
                     #if ( ipconfigUSE_IPv6 != 0 )
                         case ipPROTOCOL_ICMP_IPv6:
+                            ipCOUNT( ulIpInDelivers );
                             eReturn = prvProcessICMPMessage_IPv6( pxNetworkBuffer );
                             break;
                     #endif /* ( ipconfigUSE_IPv6 != 0 ) */
 
                     case ipPROTOCOL_UDP:
                         /* The IP packet contained a UDP frame. */
+                        ipCOUNT( ulIpInDelivers );
 
                         eReturn = prvProcessUDPPacket( pxNetworkBuffer );
                         break;
 
                         #if ipconfigUSE_TCP == 1
                             case ipPROTOCOL_TCP:
+                                ipCOUNT( ulIpInDelivers );
 
                                 if( xProcessReceivedTCPPacket( pxNetworkBuffer ) == pdPASS )
                                 {
@@ -2030,6 +2463,7 @@ static eFrameProcessingResult_t prvProcessIPPacket( const IPPacket_t * pxIPPacke
                         #endif /* if ipconfigUSE_TCP == 1 */
                     default:
                         /* Not a supported frame type. */
+                        ipCOUNT( ulIpInUnknownProtos );
                         eReturn = eReleaseBuffer;
                         break;
                 }
@@ -2189,6 +2623,7 @@ void vReturnEthernetFrame( NetworkBufferDescriptor_t * pxNetworkBuffer,
             if( xIsCallingFromIPTask() == pdTRUE )
             {
                 iptraceNETWORK_INTERFACE_OUTPUT( pxNetworkBuffer->xDataLength, pxNetworkBuffer->pucEthernetBuffer );
+                ipCOUNT_IF_OUTPUT( pxInterface, pxNetworkBuffer );
                 ( void ) pxInterface->pfOutput( pxInterface, pxNetworkBuffer, xReleaseAfterSend );
             }
             else if( xReleaseAfterSend != pdFALSE )
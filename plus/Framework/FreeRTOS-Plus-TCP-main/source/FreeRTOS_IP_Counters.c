@@ -0,0 +1,126 @@
+/*
+ * FreeRTOS+TCP <DEVELOPMENT BRANCH>
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file FreeRTOS_IP_Counters.c
+ * @brief Implements the MIB-II style counters of the FreeRTOS+TCP network stack.
+ *
+ * The counters are incremented with the macros in FreeRTOS_IP_Counters.h.
+ * All increments take place in the IP-task, so they need no locking. A
+ * reader in another task gets a consistent copy by suspending the scheduler
+ * while copying.
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_Routing.h"
+#include "FreeRTOS_IP_Counters.h"
+
+/* Exclude the entire file if the counters are not used. */
+#if ( ipconfigUSE_IP_COUNTERS != 0 )
+
+/** @brief The protocol counters. */
+    IPCounters_t xIPCounters;
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Count a checksum failure of a transport protocol.
+ *
+ * @param[in] ucProtocol The protocol, as found in the IP header.
+ */
+    void vIPCountChecksumError( uint8_t ucProtocol )
+    {
+        switch( ucProtocol )
+        {
+            case ipPROTOCOL_TCP:
+                ipCOUNT( ulTcpInErrs );
+                break;
+
+            case ipPROTOCOL_UDP:
+                ipCOUNT( ulUdpInErrors );
+                break;
+
+            case ipPROTOCOL_ICMP:
+            #if ( ipconfigUSE_IPv6 != 0 )
+                case ipPROTOCOL_ICMP_IPv6:
+            #endif
+                ipCOUNT( ulIcmpInErrors );
+                break;
+
+            default:
+                ipCOUNT( ulIpInHdrErrors );
+                break;
+        }
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Take a consistent copy of the protocol counters.
+ *
+ * @param[out] pxCounters Where the copy will be stored.
+ */
+    void vGetIPCounters( IPCounters_t * pxCounters )
+    {
+        configASSERT( pxCounters != NULL );
+
+        vTaskSuspendAll();
+        {
+            ( void ) memcpy( pxCounters, &( xIPCounters ), sizeof( *pxCounters ) );
+        }
+        ( void ) xTaskResumeAll();
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Take a consistent copy of the counters of a network interface.
+ *
+ * @param[in] pxInterface The interface.
+ * @param[out] pxCounters Where the copy will be stored.
+ */
+    void vGetInterfaceCounters( const struct xNetworkInterface * pxInterface,
+                                IfCounters_t * pxCounters )
+    {
+        configASSERT( ( pxInterface != NULL ) && ( pxCounters != NULL ) );
+
+        vTaskSuspendAll();
+        {
+            ( void ) memcpy( pxCounters, &( pxInterface->xCounters ), sizeof( *pxCounters ) );
+        }
+        ( void ) xTaskResumeAll();
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* ipconfigUSE_IP_COUNTERS */
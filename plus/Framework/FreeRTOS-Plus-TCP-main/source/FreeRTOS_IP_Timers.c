@@ -55,6 +55,8 @@
 #include "NetworkBufferManagement.h"
 #include "FreeRTOS_Routing.h"
 #include "FreeRTOS_DNS.h"
+#include "FreeRTOS_Bonding.h"
+#include "FreeRTOS_Bridge.h"
 /*-----------------------------------------------------------*/
 
 /** @brief 'xAllNetworksUp' becomes pdTRUE when all network interfaces are initialised
@@ -109,6 +111,14 @@ static IPTimer_t xARPTimer;
     /** @brief DNS timer, to check for timeouts when looking-up a domain. */
     static IPTimer_t xDNSTimer;
 #endif
+#if ( ipconfigUSE_BONDING != 0 )
+    /** @brief Bonding timer, to check the links of the bond members. */
+    static IPTimer_t xBondingTimer;
+#endif
+#if ( ipconfigUSE_BRIDGE != 0 )
+    /** @brief Bridge timer, to check the ports and to age the learned addresses. */
+    static IPTimer_t xBridgeTimer;
+#endif
 
 /** @brief As long as not all networks are up, repeat initialisation by calling the
  * xNetworkInterfaceInitialise() function of the interfaces that are not ready. */
@@ -159,6 +169,16 @@ TickType_t xCalculateSleepTime( void )
                 }
             }
 
+            #if ( ipconfigRA_PARALLEL_DHCPv6 != 0 )
+                if( pxEndPoint->xRATimer.bActive != pdFALSE_UNSIGNED )
+                {
+                    if( pxEndPoint->xRATimer.ulRemainingTime < uxMaximumSleepTime )
+                    {
+                        uxMaximumSleepTime = pxEndPoint->xRATimer.ulRemainingTime;
+                    }
+                }
+            #endif /* ( ipconfigRA_PARALLEL_DHCPv6 != 0 ) */
+
             pxEndPoint = pxEndPoint->pxNext;
         }
     }
@@ -188,6 +208,30 @@ TickType_t xCalculateSleepTime( void )
     }
     #endif
 
+    #if ( ipconfigUSE_BONDING != 0 )
+    {
+        if( xBondingTimer.bActive != pdFALSE_UNSIGNED )
+        {
+            if( xBondingTimer.ulRemainingTime < uxMaximumSleepTime )
+            {
+                uxMaximumSleepTime = xBondingTimer.ulRemainingTime;
+            }
+        }
+    }
+    #endif
+
+    #if ( ipconfigUSE_BRIDGE != 0 )
+    {
+        if( xBridgeTimer.bActive != pdFALSE_UNSIGNED )
+        {
+            if( xBridgeTimer.ulRemainingTime < uxMaximumSleepTime )
+            {
+                uxMaximumSleepTime = xBridgeTimer.ulRemainingTime;
+            }
+        }
+    }
+    #endif
+
     return uxMaximumSleepTime;
 }
 /*-----------------------------------------------------------*/
@@ -245,7 +289,7 @@ void vCheckNetworkTimers( void )
                     }
                 #endif /* ( ipconfigUSE_DHCP == 1 ) */
 
-                #if ( ( ipconfigUSE_RA != 0 ) && ( ipconfigUSE_IPv6 != 0 ) )
+                #if ( ( ipconfigUSE_RA != 0 ) && ( ipconfigUSE_IPv6 != 0 ) && ( ipconfigRA_PARALLEL_DHCPv6 == 0 ) )
                     if( END_POINT_USES_RA( pxEndPoint ) )
                     {
                         vRAProcess( pdFALSE, pxEndPoint );
@@ -253,6 +297,17 @@ void vCheckNetworkTimers( void )
                 #endif /* ( ipconfigUSE_RA != 0 ) */
             }
 
+            #if ( ipconfigRA_PARALLEL_DHCPv6 != 0 )
+                /* RA/SLAAC has its own timer, it may run at the same time as DHCPv6. */
+                if( prvIPTimerCheck( &( pxEndPoint->xRATimer ) ) != pdFALSE )
+                {
+                    if( END_POINT_USES_RA( pxEndPoint ) )
+                    {
+                        vRAProcess( pdFALSE, pxEndPoint );
+                    }
+                }
+            #endif /* ( ipconfigRA_PARALLEL_DHCPv6 != 0 ) */
+
             pxEndPoint = pxEndPoint->pxNext;
         }
     }
@@ -268,6 +323,26 @@ void vCheckNetworkTimers( void )
     }
     #endif /* ipconfigDNS_USE_CALLBACKS */
 
+    #if ( ipconfigUSE_BONDING != 0 )
+    {
+        /* Is it time to check the links of the bond members? */
+        if( prvIPTimerCheck( &xBondingTimer ) != pdFALSE )
+        {
+            vBondingCheckLinks();
+        }
+    }
+    #endif /* ipconfigUSE_BONDING */
+
+    #if ( ipconfigUSE_BRIDGE != 0 )
+    {
+        /* Is it time to check the bridge ports? */
+        if( prvIPTimerCheck( &xBridgeTimer ) != pdFALSE )
+        {
+            vBridgeCheckPorts();
+        }
+    }
+    #endif /* ipconfigUSE_BRIDGE */
+
     #if ( ipconfigUSE_TCP == 1 )
     {
         BaseType_t xWillSleep;
@@ -276,7 +351,7 @@ void vCheckNetworkTimers( void )
 
         /* If the IP task has messages waiting to be processed then
          * it will not sleep in any case. */
-        if( uxQueueMessagesWaiting( xNetworkEventQueue ) == 0U )
+        if( uxIPEventsWaiting() == 0U )
         {
             xWillSleep = pdTRUE;
         }
@@ -426,6 +501,34 @@ void vARPTimerReload( TickType_t xTime )
 #endif /* ipconfigDNS_USE_CALLBACKS != 0 */
 /*-----------------------------------------------------------*/
 
+#if ( ipconfigUSE_BONDING != 0 )
+
+/**
+ * @brief Sets the reload time of the bonding timer and restarts it.
+ *
+ * @param[in] xTime Time to be reloaded into the bonding timer.
+ */
+    void vBondingTimerReload( TickType_t xTime )
+    {
+        prvIPTimerReload( &xBondingTimer, xTime );
+    }
+#endif /* ipconfigUSE_BONDING != 0 */
+/*-----------------------------------------------------------*/
+
+#if ( ipconfigUSE_BRIDGE != 0 )
+
+/**
+ * @brief Sets the reload time of the bridge timer and restarts it.
+ *
+ * @param[in] xTime Time to be reloaded into the bridge timer.
+ */
+    void vBridgeTimerReload( TickType_t xTime )
+    {
+        prvIPTimerReload( &xBridgeTimer, xTime );
+    }
+#endif /* ipconfigUSE_BRIDGE != 0 */
+/*-----------------------------------------------------------*/
+
 #if ( ipconfigUSE_DHCP == 1 ) || ( ipconfigUSE_RA == 1 )
 
 /**
@@ -444,6 +547,33 @@ void vARPTimerReload( TickType_t xTime )
 #endif /* ( ipconfigUSE_DHCP == 1 ) || ( ipconfigUSE_RA == 1 ) */
 /*-----------------------------------------------------------*/
 
+#if ( ipconfigUSE_RA == 1 )
+
+/**
+ * @brief Set the reload time of the timer that drives the RA/SLAAC state machine.
+ *        Unless ipconfigRA_PARALLEL_DHCPv6 is enabled, this is the shared
+ *        DHCP/DHCPv6/RA timer.
+ *
+ * @param[in] pxEndPoint The end-point that needs to acquire an IP-address.
+ * @param[in] uxClockTicks The number of clock-ticks after which the timer should expire.
+ */
+    void vRATimerReload( NetworkEndPoint_t * pxEndPoint,
+                         TickType_t uxClockTicks )
+    {
+        #if ( ipconfigRA_PARALLEL_DHCPv6 != 0 )
+        {
+            FreeRTOS_printf( ( "vRATimerReload: %lu\n", uxClockTicks ) );
+            prvIPTimerReload( &( pxEndPoint->xRATimer ), uxClockTicks );
+        }
+        #else
+        {
+            vDHCP_RATimerReload( pxEndPoint, uxClockTicks );
+        }
+        #endif
+    }
+#endif /* ( ipconfigUSE_RA == 1 ) */
+/*-----------------------------------------------------------*/
+
 /**
  * @brief Reload the Network timer.
  *
@@ -583,6 +713,39 @@ void vIPSetARPResolutionTimerEnableState( BaseType_t xEnableState )
 #endif /* if ( ipconfigUSE_DHCP == 1 ) || ( ipconfigUSE_RA == 1 ) || ( ipconfigUSE_DHCPv6 == 1 ) */
 /*-----------------------------------------------------------*/
 
+#if ( ipconfigUSE_RA == 1 )
+
+/**
+ * @brief Enable or disable the timer that drives the RA/SLAAC state machine.
+ *
+ * @param[in] pxEndPoint The end-point that needs to acquire an IP-address.
+ * @param[in] xEnableState pdTRUE if the timer must be enabled, pdFALSE otherwise.
+ */
+    void vIPSetRATimerEnableState( NetworkEndPoint_t * pxEndPoint,
+                                   BaseType_t xEnableState )
+    {
+        #if ( ipconfigRA_PARALLEL_DHCPv6 != 0 )
+        {
+            FreeRTOS_printf( ( "vIPSetRATimerEnableState: %s\n", ( xEnableState != 0 ) ? "On" : "Off" ) );
+
+            if( xEnableState != 0 )
+            {
+                pxEndPoint->xRATimer.bActive = pdTRUE_UNSIGNED;
+            }
+            else
+            {
+                pxEndPoint->xRATimer.bActive = pdFALSE_UNSIGNED;
+            }
+        }
+        #else
+        {
+            vIPSetDHCP_RATimerEnableState( pxEndPoint, xEnableState );
+        }
+        #endif
+    }
+#endif /* ( ipconfigUSE_RA == 1 ) */
+/*-----------------------------------------------------------*/
+
 #if ( ipconfigDNS_USE_CALLBACKS == 1 )
 
 /**
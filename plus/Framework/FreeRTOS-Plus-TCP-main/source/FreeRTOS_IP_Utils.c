@@ -90,6 +90,18 @@
     static UBaseType_t uxLastMinQueueSpace = 0;
 #endif
 
+#if ( ipconfigUSE_BUFFER_CLASSES != 0 )
+    /** @brief The accounting of each buffer class, indexed by eNetworkBufferClass_t. */
+    static NetworkBufferClassStats_t xBufferClasses[ eBufferClassCount ] =
+    {
+        { 0U, 0U, 0U,                             0U,                          0U, 0U }, /* eBufferClassNone, not accounted. */
+        { 0U, 0U, ipconfigBUFFER_RESERVE_RX,      ipconfigBUFFER_LIMIT_RX,      0U, 0U },
+        { 0U, 0U, ipconfigBUFFER_RESERVE_TCP_TX,  ipconfigBUFFER_LIMIT_TCP_TX,  0U, 0U },
+        { 0U, 0U, ipconfigBUFFER_RESERVE_UDP_TX,  ipconfigBUFFER_LIMIT_UDP_TX,  0U, 0U },
+        { 0U, 0U, ipconfigBUFFER_RESERVE_CONTROL, ipconfigBUFFER_LIMIT_CONTROL, 0U, 0U }
+    };
+#endif
+
 /**
  * Used in checksum calculation.
  */
@@ -244,6 +256,209 @@ static uint16_t prvGetChecksumFromPacket( const struct xPacketSummary * pxSet )
 #endif /* if ( ( ipconfigUSE_DHCPv6 == 1 ) || ( ipconfigUSE_DHCP == 1 ) || ( ipconfigUSE_RA == 1 ) ) */
 /*-----------------------------------------------------------*/
 
+#if ( ipconfigUSE_BUFFER_CLASSES != 0 )
+
+/**
+ * @brief Decide if a class may take one more network buffer. Must be called
+ *        with interrupts masked.
+ *
+ * @param[in] eClass The class that asks for a buffer.
+ *
+ * @return pdTRUE when the class stays within its limit and either within its
+ *         reserve, or when enough buffers remain free for the reserves of the
+ *         other classes.
+ */
+    static BaseType_t prvBufferClassAdmit( eNetworkBufferClass_t eClass )
+    {
+        BaseType_t xAdmit = pdFALSE;
+        const NetworkBufferClassStats_t * pxClass = &( xBufferClasses[ eClass ] );
+
+        if( pxClass->uxInUse < pxClass->uxLimit )
+        {
+            if( pxClass->uxInUse < pxClass->uxReserve )
+            {
+                xAdmit = pdTRUE;
+            }
+            else
+            {
+                UBaseType_t uxUnmet = 0U;
+                BaseType_t xIndex;
+
+                for( xIndex = ( BaseType_t ) eBufferClassRX; xIndex < ( BaseType_t ) eBufferClassCount; xIndex++ )
+                {
+                    if( ( xIndex != ( BaseType_t ) eClass ) &&
+                        ( xBufferClasses[ xIndex ].uxInUse < xBufferClasses[ xIndex ].uxReserve ) )
+                    {
+                        uxUnmet += xBufferClasses[ xIndex ].uxReserve - xBufferClasses[ xIndex ].uxInUse;
+                    }
+                }
+
+                if( uxGetNumberOfFreeNetworkBuffers() > uxUnmet )
+                {
+                    xAdmit = pdTRUE;
+                }
+            }
+        }
+
+        return xAdmit;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Obtain a network buffer on behalf of a buffer class.
+ *
+ * @param[in] xRequestedSizeBytes The size of the buffer, as for pxGetNetworkBufferWithDescriptor().
+ * @param[in] xBlockTimeTicks The time to wait for a buffer, only used when the class is admitted.
+ * @param[in] eClass The class that will own the buffer.
+ *
+ * @return A network buffer, or NULL when the class is not admitted or when
+ *         no buffer became available within the block time.
+ */
+    NetworkBufferDescriptor_t * pxGetNetworkBufferWithClass( size_t xRequestedSizeBytes,
+                                                             TickType_t xBlockTimeTicks,
+                                                             eNetworkBufferClass_t eClass )
+    {
+        NetworkBufferDescriptor_t * pxNetworkBuffer = NULL;
+        NetworkBufferClassStats_t * pxClass;
+        BaseType_t xAdmit;
+        UBaseType_t uxSavedInterruptStatus;
+
+        if( eClass == eBufferClassNone )
+        {
+            pxNetworkBuffer = pxGetNetworkBufferWithDescriptor( xRequestedSizeBytes, xBlockTimeTicks );
+        }
+        else
+        {
+            configASSERT( eClass < eBufferClassCount );
+            pxClass = &( xBufferClasses[ eClass ] );
+
+            /* Claim the buffer before obtaining it, so that concurrent
+             * requests see the new count. */
+            uxSavedInterruptStatus = ( UBaseType_t ) portSET_INTERRUPT_MASK_FROM_ISR();
+            {
+                xAdmit = prvBufferClassAdmit( eClass );
+
+                if( xAdmit != pdFALSE )
+                {
+                    pxClass->uxInUse++;
+                }
+                else
+                {
+                    pxClass->ulRefused++;
+                }
+            }
+            portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+            if( xAdmit != pdFALSE )
+            {
+                pxNetworkBuffer = pxGetNetworkBufferWithDescriptor( xRequestedSizeBytes, xBlockTimeTicks );
+
+                uxSavedInterruptStatus = ( UBaseType_t ) portSET_INTERRUPT_MASK_FROM_ISR();
+                {
+                    if( pxNetworkBuffer != NULL )
+                    {
+                        pxNetworkBuffer->ucBufferClass = ( uint8_t ) eClass;
+                        pxClass->ulGranted++;
+
+                        if( pxClass->uxMaxInUse < pxClass->uxInUse )
+                        {
+                            pxClass->uxMaxInUse = pxClass->uxInUse;
+                        }
+                    }
+                    else
+                    {
+                        pxClass->uxInUse--;
+                    }
+                }
+                portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+            }
+        }
+
+        return pxNetworkBuffer;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Check if a class would be allowed to take a network buffer now.
+ *
+ * @param[in] eClass The buffer class.
+ *
+ * @return pdTRUE when a call to pxGetNetworkBufferWithClass() would be admitted.
+ *         When pdFALSE is returned, the refusal is counted.
+ */
+    BaseType_t xNetworkBufferClassAdmit( eNetworkBufferClass_t eClass )
+    {
+        BaseType_t xAdmit = pdTRUE;
+        UBaseType_t uxSavedInterruptStatus;
+
+        if( ( eClass > eBufferClassNone ) && ( eClass < eBufferClassCount ) )
+        {
+            uxSavedInterruptStatus = ( UBaseType_t ) portSET_INTERRUPT_MASK_FROM_ISR();
+            {
+                xAdmit = prvBufferClassAdmit( eClass );
+
+                if( xAdmit == pdFALSE )
+                {
+                    xBufferClasses[ eClass ].ulRefused++;
+                }
+            }
+            portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+        }
+
+        return xAdmit;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Return a network buffer to its class. Called by the buffer allocation
+ *        scheme, also from an ISR.
+ *
+ * @param[in] pxNetworkBuffer The buffer that is being released.
+ */
+    void vNetworkBufferClassRelease( NetworkBufferDescriptor_t * const pxNetworkBuffer )
+    {
+        UBaseType_t uxSavedInterruptStatus;
+        uint8_t ucClass = pxNetworkBuffer->ucBufferClass;
+
+        if( ( ucClass != ( uint8_t ) eBufferClassNone ) && ( ucClass < ( uint8_t ) eBufferClassCount ) )
+        {
+            uxSavedInterruptStatus = ( UBaseType_t ) portSET_INTERRUPT_MASK_FROM_ISR();
+            {
+                if( xBufferClasses[ ucClass ].uxInUse > 0U )
+                {
+                    xBufferClasses[ ucClass ].uxInUse--;
+                }
+            }
+            portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+        }
+
+        pxNetworkBuffer->ucBufferClass = ( uint8_t ) eBufferClassNone;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Get a copy of the accounting of a buffer class.
+ *
+ * @param[in] eClass The buffer class.
+ * @param[out] pxStats Where the accounting will be copied to.
+ */
+    void vGetNetworkBufferClassStats( eNetworkBufferClass_t eClass,
+                                      NetworkBufferClassStats_t * pxStats )
+    {
+        UBaseType_t uxSavedInterruptStatus;
+
+        configASSERT( eClass < eBufferClassCount );
+
+        uxSavedInterruptStatus = ( UBaseType_t ) portSET_INTERRUPT_MASK_FROM_ISR();
+        {
+            *pxStats = xBufferClasses[ eClass ];
+        }
+        portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* ipconfigUSE_BUFFER_CLASSES */
+
 /**
  * @brief Duplicate the given network buffer descriptor with a modified length.
  *
@@ -883,7 +1098,7 @@ void prvProcessNetworkDownEvent( struct xNetworkInterface * pxInterface )
             if( END_POINT_USES_RA( pxEndPoint ) )
             {
                 /* Stop the RA/SLAAC process for this end-point. */
-                vIPSetDHCP_RATimerEnableState( pxEndPoint, pdFALSE );
+                vIPSetRATimerEnableState( pxEndPoint, pdFALSE );
             }
         #endif /* ( (ipconfigUSE_RA != 0) && ( ipconfigUSE_IPv6 != 0 )) */
     }
@@ -911,6 +1126,14 @@ void prvProcessNetworkDownEvent( struct xNetworkInterface * pxInterface )
                         if( pxEndPoint->bits.bIPv6 != pdFALSE_UNSIGNED )
                         {
                             vDHCPv6Process( pdTRUE, pxEndPoint );
+
+                            #if ( ipconfigRA_PARALLEL_DHCPv6 != 0 )
+                                if( END_POINT_USES_RA( pxEndPoint ) )
+                                {
+                                    /* Start RA/SLAAC at the same time, the first that succeeds wins. */
+                                    vRAProcess( pdTRUE, pxEndPoint );
+                                }
+                            #endif /* ( ipconfigRA_PARALLEL_DHCPv6 != 0 ) */
                         }
                         else
                     #endif /* (( ipconfigUSE_DHCPv6 != 0 ) && ( ipconfigUSE_IPv6 != 0 )) */
@@ -1782,3 +2005,273 @@ uint16_t usChar2u16( const uint8_t * pucPtr )
     /*-----------------------------------------------------------*/
 
 #endif /* ( ipconfigUSE_DHCPv6 == 1 ) || ( ipconfigUSE_DHCP == 1 ) */
+
+#if ( ipconfigUSE_RX_ADMISSION != 0 )
+
+/** @brief The number of entries in the map of bound TCP ports. */
+    #define ipRX_ADMISSION_PORT_MAP_SIZE    64U
+
+/** @brief For each hash of a port number, the number of TCP sockets bound to it.
+ * Written by the IP-task only, read by the network drivers. */
+    static volatile uint16_t usTCPPortMap[ ipRX_ADMISSION_PORT_MAP_SIZE ];
+
+/** @brief The priority of a received frame, see ipconfigUSE_RX_ADMISSION. */
+    typedef enum
+    {
+        eRxPriorityLow,    /**< Broadcast, multicast, or TCP to a port without a socket. */
+        eRxPriorityNormal, /**< Other unicast frames, and all ARP and ND frames. */
+        eRxPriorityHigh    /**< Unicast TCP to a bound port. */
+    } eRxPriority_t;
+
+/**
+ * @brief Get the entry in the port map for a port number.
+ *
+ * @param[in] usPort The port number, in any byte order, as long as it is used consistently.
+ *
+ * @return The index in usTCPPortMap[].
+ */
+    static size_t prvRxPortHash( uint16_t usPort )
+    {
+        return ( size_t ) ( ( ( uint32_t ) usPort ^ ( ( uint32_t ) usPort >> 6 ) ^ ( ( uint32_t ) usPort >> 12 ) ) & ( ipRX_ADMISSION_PORT_MAP_SIZE - 1U ) );
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Register that a TCP socket was bound to, or unbound from, a port.
+ *
+ * @param[in] usPort The port number in network byte order.
+ * @param[in] xBound pdTRUE when the socket gets bound, pdFALSE when it is unbound.
+ */
+    void vRxAdmissionSetPort( uint16_t usPort,
+                              BaseType_t xBound )
+    {
+        size_t uxIndex = prvRxPortHash( usPort );
+
+        if( xBound != pdFALSE )
+        {
+            usTCPPortMap[ uxIndex ]++;
+        }
+        else if( usTCPPortMap[ uxIndex ] > 0U )
+        {
+            usTCPPortMap[ uxIndex ]--;
+        }
+        else
+        {
+            /* MISRA 15.7 */
+        }
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Classify a received frame by looking at its headers only.
+ *
+ * @param[in] pucEthernetBuffer The received frame.
+ * @param[in] uxLength The length of the frame.
+ *
+ * @return The priority of the frame.
+ */
+    static eRxPriority_t prvRxClassify( const uint8_t * pucEthernetBuffer,
+                                        size_t uxLength )
+    {
+        eRxPriority_t ePriority = eRxPriorityNormal;
+        uint16_t usFrameType;
+        size_t uxTCPOffset = 0U;
+        BaseType_t xIsControl = pdFALSE;
+
+        if( uxLength < ipSIZE_OF_ETH_HEADER )
+        {
+            ePriority = eRxPriorityLow;
+        }
+        else
+        {
+            usFrameType = usChar2u16( &( pucEthernetBuffer[ 12 ] ) );
+
+            if( usFrameType == 0x0800U )
+            {
+                /* IPv4: only the first fragment contains the TCP header. */
+                if( ( uxLength >= ( ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER ) ) &&
+                    ( pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER + 9U ] == ipPROTOCOL_TCP ) &&
+                    ( ( usChar2u16( &( pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER + 6U ] ) ) & 0x1FFFU ) == 0U ) )
+                {
+                    uxTCPOffset = ipSIZE_OF_ETH_HEADER + ( ( size_t ) ( pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER ] & 0x0FU ) << 2 );
+                }
+            }
+            else if( usFrameType == 0x86DDU )
+            {
+                /* IPv6: extension headers are not followed. */
+                if( uxLength >= ( ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv6_HEADER ) )
+                {
+                    if( pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER + 6U ] == ipPROTOCOL_TCP )
+                    {
+                        uxTCPOffset = ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv6_HEADER;
+                    }
+                    else if( ( pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER + 6U ] == ipPROTOCOL_ICMP_IPv6 ) &&
+                             ( uxLength > ( ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv6_HEADER ) ) )
+                    {
+                        uint8_t ucType = pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv6_HEADER ];
+
+                        /* Router and neighbour discovery are needed to keep
+                         * the link working. */
+                        if( ( ucType >= ipICMP_ROUTER_SOLICITATION_IPv6 ) && ( ucType <= ipICMP_NEIGHBOR_ADVERTISEMENT_IPv6 ) )
+                        {
+                            xIsControl = pdTRUE;
+                        }
+                    }
+                    else
+                    {
+                        /* MISRA 15.7 */
+                    }
+                }
+            }
+            else if( usFrameType == 0x0806U )
+            {
+                /* ARP is needed to keep the link working. */
+                xIsControl = pdTRUE;
+            }
+            else
+            {
+                /* Neither IP nor ARP. */
+                ePriority = eRxPriorityLow;
+            }
+
+            if( xIsControl != pdFALSE )
+            {
+                /* ARP and ND keep normal priority, even when broadcast or
+                 * multicast: dropping them first would make the stack
+                 * unreachable under load. */
+            }
+            else if( ( pucEthernetBuffer[ 0 ] & 0x01U ) != 0U )
+            {
+                /* Broadcast or multicast destination MAC address. */
+                ePriority = eRxPriorityLow;
+            }
+            else if( ( uxTCPOffset != 0U ) && ( uxLength >= ( uxTCPOffset + 4U ) ) )
+            {
+                uint16_t usPort;
+
+                /* Read the destination port in network byte order, as it
+                 * was registered by vRxAdmissionSetPort(). */
+                ( void ) memcpy( &( usPort ), &( pucEthernetBuffer[ uxTCPOffset + 2U ] ), sizeof( usPort ) );
+
+                if( usTCPPortMap[ prvRxPortHash( usPort ) ] != 0U )
+                {
+                    ePriority = eRxPriorityHigh;
+                }
+                else
+                {
+                    ePriority = eRxPriorityLow;
+                }
+            }
+            else
+            {
+                /* MISRA 15.7 */
+            }
+        }
+
+        return ePriority;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Decide if a received frame may be passed to the IP-task.
+ *
+ * @param[in] pxInterface The interface that received the frame.
+ * @param[in] pucEthernetBuffer The received frame.
+ * @param[in] uxLength The length of the frame.
+ *
+ * @return pdTRUE when the frame is admitted, pdFALSE when it must be dropped.
+ */
+    BaseType_t xNetworkInterfaceRxAdmit( struct xNetworkInterface * pxInterface,
+                                         const uint8_t * pucEthernetBuffer,
+                                         size_t uxLength )
+    {
+        RxAdmission_t * pxAdmission = &( pxInterface->xRxAdmission );
+        eRxPriority_t ePriority = prvRxClassify( pucEthernetBuffer, uxLength );
+        TickType_t xNow = xTaskGetTickCount();
+        UBaseType_t uxPercent;
+        UBaseType_t uxLimit;
+        BaseType_t xAdmit = pdTRUE;
+        BaseType_t xQuotaUsed = pdFALSE;
+
+        /* Early drop, depending on the occupancy of the event queue. */
+        uxPercent = ( uxQueueMessagesWaiting( xNetworkEventQueue ) * 100U ) / ( UBaseType_t ) ipconfigEVENT_QUEUE_LENGTH;
+
+        switch( ePriority )
+        {
+            case eRxPriorityLow:
+                uxLimit = ipconfigRX_DROP_LOW_PERCENT;
+                break;
+
+            case eRxPriorityNormal:
+                uxLimit = ipconfigRX_DROP_NORMAL_PERCENT;
+                break;
+
+            default:
+                uxLimit = ipconfigRX_DROP_HIGH_PERCENT;
+                break;
+        }
+
+        if( uxPercent >= uxLimit )
+        {
+            pxAdmission->ulDroppedQueue++;
+            xAdmit = pdFALSE;
+        }
+        else
+        {
+            if( ( xNow - pxAdmission->xPeriodStart ) >= pdMS_TO_TICKS( ipconfigRX_QUOTA_PERIOD_MS ) )
+            {
+                pxAdmission->xPeriodStart = xNow;
+                pxAdmission->ulPeriodPackets = 0U;
+                pxAdmission->ulPeriodBytes = 0U;
+            }
+
+            #if ( ipconfigRX_QUOTA_PACKETS != 0 )
+                if( pxAdmission->ulPeriodPackets >= ( uint32_t ) ipconfigRX_QUOTA_PACKETS )
+                {
+                    xQuotaUsed = pdTRUE;
+                }
+            #endif
+
+            #if ( ipconfigRX_QUOTA_BYTES != 0 )
+                if( pxAdmission->ulPeriodBytes >= ( uint32_t ) ipconfigRX_QUOTA_BYTES )
+                {
+                    xQuotaUsed = pdTRUE;
+                }
+            #endif
+
+            /* Beyond the quota, only high priority frames are admitted. */
+            if( ( ePriority != eRxPriorityHigh ) && ( xQuotaUsed != pdFALSE ) )
+            {
+                pxAdmission->ulDroppedQuota++;
+                xAdmit = pdFALSE;
+            }
+            else
+            {
+                pxAdmission->ulPeriodPackets++;
+                pxAdmission->ulPeriodBytes += ( uint32_t ) uxLength;
+                pxAdmission->ulAdmitted++;
+            }
+        }
+
+        return xAdmit;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Get a copy of the RX admission counters of an interface.
+ *
+ * @param[in] pxInterface The interface.
+ * @param[out] pxStats Where the counters will be copied to.
+ */
+    void vNetworkInterfaceRxStats( const struct xNetworkInterface * pxInterface,
+                                   RxAdmission_t * pxStats )
+    {
+        taskENTER_CRITICAL();
+        {
+            *pxStats = pxInterface->xRxAdmission;
+        }
+        taskEXIT_CRITICAL();
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* ipconfigUSE_RX_ADMISSION */
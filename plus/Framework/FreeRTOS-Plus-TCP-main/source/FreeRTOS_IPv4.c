@@ -295,6 +295,7 @@ enum eFrameProcessingResult prvAllowIPPacketIPv4( const struct xIP_PACKET * cons
         if( ( ( pxIPHeader->usFragmentOffset & ipFRAGMENT_OFFSET_BIT_MASK ) != 0U ) || ( ( pxIPHeader->usFragmentOffset & ipFRAGMENT_FLAGS_MORE_FRAGMENTS ) != 0U ) )
         {
             /* Can not handle, fragmented packet. */
+            ipCOUNT( ulIpReasmFails );
             eReturn = eReleaseBuffer;
         }
 
@@ -304,6 +305,7 @@ enum eFrameProcessingResult prvAllowIPPacketIPv4( const struct xIP_PACKET * cons
                  ( pxIPHeader->ucVersionHeaderLength > ipIPV4_VERSION_HEADER_LENGTH_MAX ) )
         {
             /* Can not handle, unknown or invalid header version. */
+            ipCOUNT( ulIpInHdrErrors );
             eReturn = eReleaseBuffer;
         }
         else if( ( xIsIPv4Loopback( ulDestinationIPAddress ) == pdTRUE ) ||
@@ -314,6 +316,7 @@ enum eFrameProcessingResult prvAllowIPPacketIPv4( const struct xIP_PACKET * cons
             {
                 /* The local loopback addresses must never appear outside a host. See RFC 1122
                  * section 3.2.1.3. */
+                ipCOUNT( ulIpInAddrErrors );
                 eReturn = eReleaseBuffer;
             }
         }
@@ -326,6 +329,7 @@ enum eFrameProcessingResult prvAllowIPPacketIPv4( const struct xIP_PACKET * cons
             ( FreeRTOS_IsNetworkUp() != pdFALSE ) )
         {
             /* Packet is not for this node, release it */
+            ipCOUNT( ulIpInAddrErrors );
             eReturn = eReleaseBuffer;
         }
         /* Is the source address correct? */
@@ -333,6 +337,7 @@ enum eFrameProcessingResult prvAllowIPPacketIPv4( const struct xIP_PACKET * cons
         {
             /* The source address cannot be broadcast address. Replying to this
              * packet may cause network storms. Drop the packet. */
+            ipCOUNT( ulIpInAddrErrors );
             eReturn = eReleaseBuffer;
         }
         else if( ( memcmp( xBroadcastMACAddress.ucBytes,
@@ -342,6 +347,7 @@ enum eFrameProcessingResult prvAllowIPPacketIPv4( const struct xIP_PACKET * cons
         {
             /* Ethernet address is a broadcast address, but the IP address is not a
              * broadcast address. */
+            ipCOUNT( ulIpInAddrErrors );
             eReturn = eReleaseBuffer;
         }
         else if( memcmp( xBroadcastMACAddress.ucBytes,
@@ -349,11 +355,13 @@ enum eFrameProcessingResult prvAllowIPPacketIPv4( const struct xIP_PACKET * cons
                          sizeof( MACAddress_t ) ) == 0 )
         {
             /* Ethernet source is a broadcast address. Drop the packet. */
+            ipCOUNT( ulIpInAddrErrors );
             eReturn = eReleaseBuffer;
         }
         else if( xIsIPv4Multicast( ulSourceIPAddress ) == pdTRUE )
         {
             /* Source is a multicast IP address. Drop the packet in conformity with RFC 1112 section 7.2. */
+            ipCOUNT( ulIpInAddrErrors );
             eReturn = eReleaseBuffer;
         }
         else
@@ -367,8 +375,10 @@ enum eFrameProcessingResult prvAllowIPPacketIPv4( const struct xIP_PACKET * cons
     #if ( ipconfigDRIVER_INCLUDED_RX_IP_CHECKSUM == 0 )
     {
         /* Some drivers of NIC's with checksum-offloading will enable the above
-         * define, so that the checksum won't be checked again here */
-        if( eReturn == eProcessBuffer )
+         * define, so that the checksum won't be checked again here.
+         * Packets from a loop-back interface do not carry a checksum when
+         * ipconfigUSE_LOOPBACK_FAST_PATH is enabled. */
+        if( ( eReturn == eProcessBuffer ) && ( INTERFACE_IS_LOOPBACK( pxNetworkBuffer->pxInterface ) == pdFALSE ) )
         {
             const NetworkEndPoint_t * pxEndPoint = FreeRTOS_FindEndPointOnMAC( &( pxIPPacket->xEthernetHeader.xSourceAddress ), NULL );
 
@@ -386,12 +396,14 @@ enum eFrameProcessingResult prvAllowIPPacketIPv4( const struct xIP_PACKET * cons
                 if( usGenerateChecksum( 0U, ( const uint8_t * ) &( pxIPHeader->ucVersionHeaderLength ), ( size_t ) uxHeaderLength ) != ipCORRECT_CRC )
                 {
                     /* Check sum in IP-header not correct. */
+                    ipCOUNT( ulIpInHdrErrors );
                     eReturn = eReleaseBuffer;
                 }
                 /* Is the upper-layer checksum (TCP/UDP/ICMP) correct? */
                 else if( usGenerateProtocolChecksum( ( uint8_t * ) ( pxNetworkBuffer->pucEthernetBuffer ), pxNetworkBuffer->xDataLength, pdFALSE ) != ipCORRECT_CRC )
                 {
                     /* Protocol checksum not accepted. */
+                    ipCOUNT_CHECKSUM_ERROR( pxIPHeader->ucProtocol );
                     eReturn = eReleaseBuffer;
                 }
                 else
@@ -408,14 +420,16 @@ enum eFrameProcessingResult prvAllowIPPacketIPv4( const struct xIP_PACKET * cons
             if( xCheckIPv4SizeFields( pxNetworkBuffer->pucEthernetBuffer, pxNetworkBuffer->xDataLength ) != pdPASS )
             {
                 /* Some of the length checks were not successful. */
+                ipCOUNT( ulIpInHdrErrors );
                 eReturn = eReleaseBuffer;
             }
         }
 
         #if ( ipconfigUDP_PASS_ZERO_CHECKSUM_PACKETS == 0 )
         {
-            /* Check if this is a UDP packet without a checksum. */
-            if( eReturn == eProcessBuffer )
+            /* Check if this is a UDP packet without a checksum. Loop-back
+             * packets may have no checksum. */
+            if( ( eReturn == eProcessBuffer ) && ( INTERFACE_IS_LOOPBACK( pxNetworkBuffer->pxInterface ) == pdFALSE ) )
             {
                 uint8_t ucProtocol;
                 const ProtocolHeaders_t * pxProtocolHeaders;
@@ -526,6 +526,7 @@ eFrameProcessingResult_t prvAllowIPPacketIPv6( const IPHeader_IPv6_t * const pxI
         {
             /* Packet is not for this node, or the network is still not up,
              * release it */
+            ipCOUNT( ulIpInAddrErrors );
             eReturn = eReleaseBuffer;
             FreeRTOS_printf( ( "prvAllowIPPacketIPv6: drop %pip (from %pip)\n", pxDestinationIPAddress->ucBytes, pxIPv6Header->xSourceAddress.ucBytes ) );
         }
@@ -541,8 +542,10 @@ eFrameProcessingResult_t prvAllowIPPacketIPv6( const IPHeader_IPv6_t * const pxI
     #if ( ipconfigDRIVER_INCLUDED_RX_IP_CHECKSUM == 0 )
     {
         /* Some drivers of NIC's with checksum-offloading will enable the above
-         * define, so that the checksum won't be checked again here */
-        if( eReturn == eProcessBuffer )
+         * define, so that the checksum won't be checked again here.
+         * Packets from a loop-back interface do not carry a checksum when
+         * ipconfigUSE_LOOPBACK_FAST_PATH is enabled. */
+        if( ( eReturn == eProcessBuffer ) && ( INTERFACE_IS_LOOPBACK( pxNetworkBuffer->pxInterface ) == pdFALSE ) )
         {
             /* MISRA Ref 11.3.1 [Misaligned access] */
             /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
@@ -558,6 +561,7 @@ eFrameProcessingResult_t prvAllowIPPacketIPv6( const IPHeader_IPv6_t * const pxI
                 if( usGenerateProtocolChecksum( ( uint8_t * ) ( pxNetworkBuffer->pucEthernetBuffer ), pxNetworkBuffer->xDataLength, pdFALSE ) != ipCORRECT_CRC )
                 {
                     /* Protocol checksum not accepted. */
+                    ipCOUNT_CHECKSUM_ERROR( pxIPv6Header->ucNextHeader );
                     eReturn = eReleaseBuffer;
                 }
             }
@@ -570,6 +574,7 @@ eFrameProcessingResult_t prvAllowIPPacketIPv6( const IPHeader_IPv6_t * const pxI
             if( xCheckIPv6SizeFields( pxNetworkBuffer->pucEthernetBuffer, pxNetworkBuffer->xDataLength ) != pdPASS )
             {
                 /* Some of the length checks were not successful. */
+                ipCOUNT( ulIpInHdrErrors );
                 eReturn = eReleaseBuffer;
             }
         }
@@ -98,6 +98,19 @@
 /** @brief Find the first end-point of type IPv6. */
     static NetworkEndPoint_t * pxFindLocalEndpoint( void );
 
+/** @brief Copy a prefix into an IPv6 address and fill the remaining host bits. */
+    static void prvFillHostBits( IPv6_Address_t * pxIPAddress,
+                                 const IPv6_Address_t * pxPrefix,
+                                 size_t uxPrefixLength,
+                                 const uint8_t * pucSource );
+
+    #if ( ipconfigRA_STABLE_PRIVACY_ADDRESS != 0 )
+        /** @brief A keyed hash, used as the pseudo-random function of RFC 7217. */
+        static uint64_t prvSipHash24( const uint8_t * pucKey,
+                                      const uint8_t * pucData,
+                                      size_t uxLength );
+    #endif
+
 /** @brief The ND cache. */
     static NDCacheRow_t xNDCache[ ipconfigND_CACHE_ENTRIES ];
 
@@ -194,6 +207,28 @@
         /* Multi-cast addresses can be resolved immediately. */
         eReturn = prvMACResolve( pxIPAddress, pxMACAddress, ppxEndPoint );
 
+        #if ( ipconfigUSE_LOOPBACK_FAST_PATH != 0 )
+        {
+            if( ( eReturn == eARPCacheMiss ) && ( xIsIPv6Loopback( pxIPAddress ) != pdFALSE ) )
+            {
+                /* A loop-back end-point receives its own packets. */
+                pxEndPoint = FreeRTOS_FindEndPointOnIP_IPv6( pxIPAddress );
+
+                if( ENDPOINT_IS_LOOPBACK( pxEndPoint ) != pdFALSE )
+                {
+                    ( void ) memcpy( pxMACAddress->ucBytes, pxEndPoint->xMACAddress.ucBytes, sizeof( MACAddress_t ) );
+
+                    if( ppxEndPoint != NULL )
+                    {
+                        *( ppxEndPoint ) = pxEndPoint;
+                    }
+
+                    eReturn = eARPCacheHit;
+                }
+            }
+        }
+        #endif /* ( ipconfigUSE_LOOPBACK_FAST_PATH != 0 ) */
+
         if( eReturn == eARPCacheMiss )
         {
             /* See if the IP-address has an entry in the cache. */
@@ -401,7 +436,7 @@
                         NetworkBufferDescriptor_t * pxNetworkBuffer;
 
                         uxNeededSize = ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv6_HEADER + sizeof( ICMPHeader_IPv6_t );
-                        pxNetworkBuffer = pxGetNetworkBufferWithDescriptor( uxNeededSize, 0U );
+                        pxNetworkBuffer = pxGetNetworkBufferWithClass( uxNeededSize, 0U, eBufferClassControl );
 
                         if( pxNetworkBuffer != NULL )
                         {
@@ -763,7 +798,7 @@
                 /* MISRA Ref 11.3.1 [Misaligned access] */
                 /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
                 /* coverity[misra_c_2012_rule_11_3_violation] */
-                pxNetworkBuffer = pxGetNetworkBufferWithDescriptor( BUFFER_FROM_WHERE_CALL( 181 ) uxPacketLength, uxBlockTimeTicks );
+                pxNetworkBuffer = pxGetNetworkBufferWithClass( BUFFER_FROM_WHERE_CALL( 181 ) uxPacketLength, uxBlockTimeTicks, eBufferClassControl );
 
                 if( pxNetworkBuffer != NULL )
                 {
@@ -981,6 +1016,8 @@
         }
         #endif /* ( ipconfigHAS_PRINTF == 1 ) */
 
+        ipCOUNT( ulIcmpInMsgs );
+
         if( pxEndPoint->bits.bIPv6 != pdFALSE_UNSIGNED )
         {
             switch( pxICMPHeader_IPv6->ucTypeOfMessage )
@@ -997,6 +1034,8 @@
                        size_t uxICMPSize;
                        uint16_t usICMPSize;
 
+                       ipCOUNT( ulIcmpInEchos );
+
                        /* Lint would complain about casting '()' immediately. */
                        usICMPSize = FreeRTOS_ntohs( pxICMPPacket->xIPHeader.usPayloadLength );
                        uxICMPSize = ( size_t ) usICMPSize;
@@ -1009,6 +1048,7 @@
                        }
 
                        pxICMPHeader_IPv6->ucTypeOfMessage = ipICMP_PING_REPLY_IPv6;
+                       ipCOUNT( ulIcmpOutEchoReps );
 
                        /* MISRA Ref 4.14.1 [The validity of values received from external sources]. */
                        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#directive-414. */
@@ -1028,6 +1068,8 @@
                                size_t uxDataLength, uxCount;
                                const uint8_t * pucByte;
 
+                               ipCOUNT( ulIcmpInEchoReps );
+
                                /* Find the total length of the IP packet. */
                                uxDataLength = ipNUMERIC_CAST( size_t, FreeRTOS_ntohs( pxICMPPacket->xIPHeader.usPayloadLength ) );
                                uxDataLength = uxDataLength - sizeof( *pxICMPEchoHeader );
@@ -1159,7 +1201,7 @@
 
         /* This is called from the context of the IP event task, so a block time
          * must not be used. */
-        pxNetworkBuffer = pxGetNetworkBufferWithDescriptor( uxPacketSize, ndDONT_BLOCK );
+        pxNetworkBuffer = pxGetNetworkBufferWithClass( uxPacketSize, ndDONT_BLOCK, eBufferClassControl );
 
         if( pxNetworkBuffer != NULL )
         {
@@ -1220,6 +1262,10 @@
             }
             #endif
 
+            ipCOUNT( ulIcmpOutMsgs );
+            ipCOUNT( ulIpOutRequests );
+            ipCOUNT_IF_OUTPUT( pxInterface, pxNetworkBuffer );
+
             /* Set the parameter 'bReleaseAfterSend'. */
             ( void ) pxInterface->pfOutput( pxInterface, pxNetworkBuffer, pdTRUE );
         }
@@ -1269,37 +1315,233 @@
 
         if( xResult == pdPASS )
         {
-            /* A loopback IP-address has a prefix of 128. */
-            configASSERT( ( uxPrefixLength > 0U ) && ( uxPrefixLength <= ( 8U * ipSIZE_OF_IPv6_ADDRESS ) ) );
+            pucSource = ( uint8_t * ) pulRandom;
+            prvFillHostBits( pxIPAddress, pxPrefix, uxPrefixLength, pucSource );
+        }
+
+        return xResult;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Copy a prefix into an IPv6 address, and fill the bits after the prefix
+ *        with the bytes in 'pucSource'.
+ *
+ * @param[out] pxIPAddress The location where the new IPv6 address will be stored.
+ * @param[in] pxPrefix The prefix to be used.
+ * @param[in] uxPrefixLength The length of the prefix in bits.
+ * @param[in] pucSource At least 16 bytes that will be used as host bits.
+ */
+    static void prvFillHostBits( IPv6_Address_t * pxIPAddress,
+                                 const IPv6_Address_t * pxPrefix,
+                                 size_t uxPrefixLength,
+                                 const uint8_t * pucSource )
+    {
+        const uint8_t * pucHostBits = pucSource;
+        size_t uxIndex = uxPrefixLength / 8U;
+
+        /* A loopback IP-address has a prefix of 128. */
+        configASSERT( ( uxPrefixLength > 0U ) && ( uxPrefixLength <= ( 8U * ipSIZE_OF_IPv6_ADDRESS ) ) );
+
+        if( uxPrefixLength >= 8U )
+        {
+            ( void ) memcpy( pxIPAddress->ucBytes, pxPrefix->ucBytes, ( uxPrefixLength + 7U ) / 8U );
+        }
+
+        if( ( uxPrefixLength % 8U ) != 0U )
+        {
+            /* uxHostLen is between 1 and 7 bits long. */
+            size_t uxHostLen = 8U - ( uxPrefixLength % 8U );
+            uint32_t uxHostMask = ( ( ( uint32_t ) 1U ) << uxHostLen ) - 1U;
+            uint8_t ucNetMask = ( uint8_t ) ~( uxHostMask );
+
+            pxIPAddress->ucBytes[ uxIndex ] &= ucNetMask;
+            pxIPAddress->ucBytes[ uxIndex ] |= ( pucHostBits[ 0 ] & ( ( uint8_t ) uxHostMask ) );
+            pucHostBits = &( pucHostBits[ 1 ] );
+            uxIndex++;
+        }
+
+        if( uxIndex < ipSIZE_OF_IPv6_ADDRESS )
+        {
+            ( void ) memcpy( &( pxIPAddress->ucBytes[ uxIndex ] ), pucHostBits, ipSIZE_OF_IPv6_ADDRESS - uxIndex );
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    #if ( ipconfigRA_STABLE_PRIVACY_ADDRESS != 0 )
+
+/** @brief Rotate a 64-bit value to the left. */
+        #define ndROTL64( ullValue, uxBits )    ( ( ( ullValue ) << ( uxBits ) ) | ( ( ullValue ) >> ( 64U - ( uxBits ) ) ) )
+
+/**
+ * @brief Read 8 bytes in little-endian order.
+ *
+ * @param[in] pucBytes The bytes to be read.
+ *
+ * @return The 64-bit value.
+ */
+        static uint64_t prvReadLE64( const uint8_t * pucBytes )
+        {
+            uint64_t ullResult = 0U;
+            BaseType_t xIndex;
 
-            if( uxPrefixLength >= 8U )
+            for( xIndex = 7; xIndex >= 0; xIndex-- )
             {
-                ( void ) memcpy( pxIPAddress->ucBytes, pxPrefix->ucBytes, ( uxPrefixLength + 7U ) / 8U );
+                ullResult = ( ullResult << 8 ) | ( uint64_t ) pucBytes[ xIndex ];
             }
 
-            pucSource = ( uint8_t * ) pulRandom;
-            size_t uxIndex = uxPrefixLength / 8U;
+            return ullResult;
+        }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief One SipRound, applied to the four state variables.
+ *
+ * @param[in,out] pullV The SipHash state: v0..v3.
+ */
+        static void prvSipRound( uint64_t * pullV )
+        {
+            pullV[ 0 ] += pullV[ 1 ];
+            pullV[ 1 ] = ndROTL64( pullV[ 1 ], 13U );
+            pullV[ 1 ] ^= pullV[ 0 ];
+            pullV[ 0 ] = ndROTL64( pullV[ 0 ], 32U );
+            pullV[ 2 ] += pullV[ 3 ];
+            pullV[ 3 ] = ndROTL64( pullV[ 3 ], 16U );
+            pullV[ 3 ] ^= pullV[ 2 ];
+            pullV[ 0 ] += pullV[ 3 ];
+            pullV[ 3 ] = ndROTL64( pullV[ 3 ], 21U );
+            pullV[ 3 ] ^= pullV[ 0 ];
+            pullV[ 2 ] += pullV[ 1 ];
+            pullV[ 1 ] = ndROTL64( pullV[ 1 ], 17U );
+            pullV[ 1 ] ^= pullV[ 2 ];
+            pullV[ 2 ] = ndROTL64( pullV[ 2 ], 32U );
+        }
+/*-----------------------------------------------------------*/
 
-            if( ( uxPrefixLength % 8U ) != 0U )
+/**
+ * @brief Calculate SipHash-2-4 of a short message. It is cheap and it is
+ *        a proper keyed pseudo-random function, as required by RFC 7217.
+ *
+ * @param[in] pucKey A 16-byte secret key.
+ * @param[in] pucData The message.
+ * @param[in] uxLength The number of bytes in the message.
+ *
+ * @return The 64-bit hash value.
+ */
+        static uint64_t prvSipHash24( const uint8_t * pucKey,
+                                      const uint8_t * pucData,
+                                      size_t uxLength )
+        {
+            uint64_t pullV[ 4 ];
+            uint64_t ullBlock;
+            uint64_t ullKey0 = prvReadLE64( pucKey );
+            uint64_t ullKey1 = prvReadLE64( &( pucKey[ 8 ] ) );
+            size_t uxOffset = 0U;
+            size_t uxLeft;
+
+            pullV[ 0 ] = ullKey0 ^ 0x736f6d6570736575ULL;
+            pullV[ 1 ] = ullKey1 ^ 0x646f72616e646f6dULL;
+            pullV[ 2 ] = ullKey0 ^ 0x6c7967656e657261ULL;
+            pullV[ 3 ] = ullKey1 ^ 0x7465646279746573ULL;
+
+            while( ( uxOffset + 8U ) <= uxLength )
             {
-                /* uxHostLen is between 1 and 7 bits long. */
-                size_t uxHostLen = 8U - ( uxPrefixLength % 8U );
-                uint32_t uxHostMask = ( ( ( uint32_t ) 1U ) << uxHostLen ) - 1U;
-                uint8_t ucNetMask = ( uint8_t ) ~( uxHostMask );
-
-                pxIPAddress->ucBytes[ uxIndex ] &= ucNetMask;
-                pxIPAddress->ucBytes[ uxIndex ] |= ( pucSource[ 0 ] & ( ( uint8_t ) uxHostMask ) );
-                pucSource = &( pucSource[ 1 ] );
-                uxIndex++;
+                ullBlock = prvReadLE64( &( pucData[ uxOffset ] ) );
+                pullV[ 3 ] ^= ullBlock;
+                prvSipRound( pullV );
+                prvSipRound( pullV );
+                pullV[ 0 ] ^= ullBlock;
+                uxOffset += 8U;
             }
 
-            if( uxIndex < ipSIZE_OF_IPv6_ADDRESS )
+            /* The last block holds the remaining bytes and the message length. */
+            ullBlock = ( ( uint64_t ) uxLength ) << 56;
+
+            for( uxLeft = uxLength - uxOffset; uxLeft > 0U; uxLeft-- )
             {
-                ( void ) memcpy( &( pxIPAddress->ucBytes[ uxIndex ] ), pucSource, ipSIZE_OF_IPv6_ADDRESS - uxIndex );
+                ullBlock |= ( ( uint64_t ) pucData[ uxOffset + uxLeft - 1U ] ) << ( 8U * ( uxLeft - 1U ) );
             }
+
+            pullV[ 3 ] ^= ullBlock;
+            prvSipRound( pullV );
+            prvSipRound( pullV );
+            pullV[ 0 ] ^= ullBlock;
+
+            pullV[ 2 ] ^= 0xffU;
+            prvSipRound( pullV );
+            prvSipRound( pullV );
+            prvSipRound( pullV );
+            prvSipRound( pullV );
+
+            return pullV[ 0 ] ^ pullV[ 1 ] ^ pullV[ 2 ] ^ pullV[ 3 ];
         }
+/*-----------------------------------------------------------*/
 
-        return xResult;
-    }
+/**
+ * @brief Create a stable, semantically opaque IPv6 address as described in RFC 7217:
+ *        the host bits are F( Prefix, Net_Iface, DAD_Counter, secret_key ).
+ *        The same end-point will get the same address each time it is attached
+ *        to the same network, but addresses on different networks are unrelated.
+ *
+ * @param[out] pxIPAddress The location where the new IPv6 address will be stored.
+ * @param[in] pxPrefix The prefix to be used.
+ * @param[in] uxPrefixLength The length of the prefix.
+ * @param[in] pxEndPoint The end-point, its MAC-address identifies the interface.
+ * @param[in] ucDADCounter The number of times that a chosen address was already in use.
+ *
+ * @return pdPASS if the operation was successful. Or pdFAIL in case
+ *         xApplicationGetStablePrivacyKey() returned an error.
+ */
+        BaseType_t FreeRTOS_CreateStablePrivacyIPv6Address( IPv6_Address_t * pxIPAddress,
+                                                            const IPv6_Address_t * pxPrefix,
+                                                            size_t uxPrefixLength,
+                                                            const NetworkEndPoint_t * pxEndPoint,
+                                                            uint8_t ucDADCounter )
+        {
+            uint8_t ucKey[ ndSTABLE_PRIVACY_KEY_LENGTH ];
+            /* Prefix, MAC-address, DAD counter and a block number. */
+            uint8_t ucMessage[ ipSIZE_OF_IPv6_ADDRESS + ipMAC_ADDRESS_LENGTH_BYTES + 2U ];
+            uint8_t ucHostBits[ ipSIZE_OF_IPv6_ADDRESS ];
+            size_t uxPrefixBytes = ( uxPrefixLength + 7U ) / 8U;
+            size_t uxMessageLength;
+            BaseType_t xResult = pdFAIL;
+            BaseType_t xBlock;
+
+            if( xApplicationGetStablePrivacyKey( ucKey, sizeof( ucKey ) ) != pdFAIL )
+            {
+                /* Only the bytes of the prefix take part, so the result does not
+                 * depend on left-over host bits in 'pxPrefix'. */
+                ( void ) memset( ucMessage, 0, sizeof( ucMessage ) );
+                ( void ) memcpy( ucMessage, pxPrefix->ucBytes, uxPrefixBytes );
+                ( void ) memcpy( &( ucMessage[ uxPrefixBytes ] ), pxEndPoint->xMACAddress.ucBytes, ipMAC_ADDRESS_LENGTH_BYTES );
+                uxMessageLength = uxPrefixBytes + ipMAC_ADDRESS_LENGTH_BYTES;
+                ucMessage[ uxMessageLength ] = ucDADCounter;
+                uxMessageLength++;
+
+                /* Two blocks of 64 bits are enough for any prefix length. */
+                for( xBlock = 0; xBlock < 2; xBlock++ )
+                {
+                    uint64_t ullHash;
+                    BaseType_t xByte;
+
+                    ucMessage[ uxMessageLength ] = ( uint8_t ) xBlock;
+                    ullHash = prvSipHash24( ucKey, ucMessage, uxMessageLength + 1U );
+
+                    for( xByte = 0; xByte < 8; xByte++ )
+                    {
+                        ucHostBits[ ( xBlock * 8 ) + xByte ] = ( uint8_t ) ( ullHash >> ( 8 * xByte ) );
+                    }
+                }
+
+                prvFillHostBits( pxIPAddress, pxPrefix, uxPrefixLength, ucHostBits );
+                xResult = pdPASS;
+            }
+
+            /* Don't leave a copy of the secret on the stack. */
+            ( void ) memset( ucKey, 0, sizeof( ucKey ) );
+
+            return xResult;
+        }
 /*-----------------------------------------------------------*/
+    #endif /* ( ipconfigRA_STABLE_PRIVACY_ADDRESS != 0 ) */
 #endif /* ipconfigUSE_IPv6 */
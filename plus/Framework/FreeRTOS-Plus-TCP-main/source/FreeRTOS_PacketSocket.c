@@ -0,0 +1,937 @@
+/*
+ * FreeRTOS+TCP <DEVELOPMENT BRANCH>
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file FreeRTOS_PacketSocket.c
+ * @brief Packet sockets, which send and receive whole Ethernet frames of an
+ *        EtherType that the IP-stack does not handle, see ipconfigUSE_PACKET_SOCKETS.
+ *
+ * A received frame is handed to a socket in the network buffer in which the
+ * driver stored it. Frames are offered to the sockets by the IP-task, or
+ * earlier by a driver that calls xPacketSocketDriverDeliver() in its receive
+ * task. As both may run at the same time, the list of sockets is protected by
+ * a mutex.
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_IP_Private.h"
+#include "FreeRTOS_Routing.h"
+#include "FreeRTOS_PacketSocket.h"
+#include "NetworkBufferManagement.h"
+#include "NetworkInterface.h"
+
+/* Exclude the entire file if packet sockets are not used. */
+#if ( ipconfigUSE_PACKET_SOCKETS != 0 )
+
+/* The fields of the 'usCode' of a classic BPF instruction. */
+    #define packetBPF_CLASS( usCode )    ( ( usCode ) & 0x07U )
+    #define packetBPF_SIZE( usCode )     ( ( usCode ) & 0x18U )
+    #define packetBPF_MODE( usCode )     ( ( usCode ) & 0xE0U )
+    #define packetBPF_OP( usCode )       ( ( usCode ) & 0xF0U )
+    #define packetBPF_SRC( usCode )      ( ( usCode ) & 0x08U )
+    #define packetBPF_RVAL( usCode )     ( ( usCode ) & 0x18U )
+    #define packetBPF_MISCOP( usCode )   ( ( usCode ) & 0xF8U )
+
+/* Instruction classes. */
+    #define packetBPF_LD                 0x00U
+    #define packetBPF_LDX                0x01U
+    #define packetBPF_ST                 0x02U
+    #define packetBPF_STX                0x03U
+    #define packetBPF_ALU                0x04U
+    #define packetBPF_JMP                0x05U
+    #define packetBPF_RET                0x06U
+    #define packetBPF_MISC               0x07U
+
+/* Load sizes. */
+    #define packetBPF_W                  0x00U
+    #define packetBPF_H                  0x08U
+    #define packetBPF_B                  0x10U
+
+/* Load modes. */
+    #define packetBPF_IMM                0x00U
+    #define packetBPF_ABS                0x20U
+    #define packetBPF_IND                0x40U
+    #define packetBPF_MEM                0x60U
+    #define packetBPF_LEN                0x80U
+    #define packetBPF_MSH                0xA0U
+
+/* ALU operations. */
+    #define packetBPF_ADD                0x00U
+    #define packetBPF_SUB                0x10U
+    #define packetBPF_MUL                0x20U
+    #define packetBPF_DIV                0x30U
+    #define packetBPF_OR                 0x40U
+    #define packetBPF_AND                0x50U
+    #define packetBPF_LSH                0x60U
+    #define packetBPF_RSH                0x70U
+    #define packetBPF_NEG                0x80U
+    #define packetBPF_MOD                0x90U
+    #define packetBPF_XOR                0xA0U
+
+/* Jump operations. */
+    #define packetBPF_JA                 0x00U
+    #define packetBPF_JEQ                0x10U
+    #define packetBPF_JGT                0x20U
+    #define packetBPF_JGE                0x30U
+    #define packetBPF_JSET               0x40U
+
+/* Operand sources and return values. */
+    #define packetBPF_K                  0x00U
+    #define packetBPF_X                  0x08U
+    #define packetBPF_A                  0x10U
+
+/* Miscellaneous operations. */
+    #define packetBPF_TAX                0x00U
+    #define packetBPF_TXA                0x80U
+
+/** @brief The number of words of scratch memory of a filter program. */
+    #define packetBPF_MEMWORDS           16U
+
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvIsStackEtherType( uint16_t usEtherType );
+
+    static BaseType_t prvFilterCheck( const PacketFilterInstruction_t * pxFilter,
+                                      size_t uxLength );
+
+    static BaseType_t prvFilterLoad( const uint8_t * pucFrame,
+                                     size_t uxFrameLength,
+                                     uint32_t ulOffset,
+                                     uint32_t ulSize,
+                                     uint32_t * pulValue );
+
+    static BaseType_t prvSocketMatches( const PacketSocket_t * pxSocket,
+                                        const NetworkBufferDescriptor_t * pxDescriptor,
+                                        uint16_t usEtherType );
+
+    static void prvSocketReceive( PacketSocket_t * pxSocket,
+                                  NetworkBufferDescriptor_t * pxDescriptor );
+
+/*-----------------------------------------------------------*/
+
+/** @brief The open packet sockets. */
+    static List_t xPacketSocketList;
+
+/** @brief Protects 'xPacketSocketList', created when the first socket is opened. */
+    static SemaphoreHandle_t xPacketSocketMutex = NULL;
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Open a packet socket.
+ *
+ * @param[in] pxSocket The socket, must be declared static or global.
+ * @param[in] pxInterface The interface to bind to, or NULL for all interfaces.
+ * @param[in] usEtherType The EtherType in host byte order, or packetETHER_TYPE_ANY.
+ * @param[in] uxQueueLength The maximum number of frames that are queued.
+ *
+ * @return pdPASS when the socket was opened, otherwise pdFAIL.
+ */
+    BaseType_t FreeRTOS_PacketOpen( PacketSocket_t * pxSocket,
+                                    NetworkInterface_t * pxInterface,
+                                    uint16_t usEtherType,
+                                    UBaseType_t uxQueueLength )
+    {
+        BaseType_t xReturn = pdFAIL;
+        uint16_t usNetworkType = FreeRTOS_htons( usEtherType );
+
+        configASSERT( pxSocket != NULL );
+
+        if( ( uxQueueLength > 0U ) && ( prvIsStackEtherType( usNetworkType ) == pdFALSE ) )
+        {
+            vTaskSuspendAll();
+            {
+                if( xPacketSocketMutex == NULL )
+                {
+                    vListInitialise( &( xPacketSocketList ) );
+                    xPacketSocketMutex = xSemaphoreCreateMutex();
+                }
+            }
+            ( void ) xTaskResumeAll();
+
+            ( void ) memset( pxSocket, 0, sizeof( *pxSocket ) );
+            pxSocket->pxInterface = pxInterface;
+            pxSocket->usEtherType = usNetworkType;
+            pxSocket->xRxQueue = xQueueCreate( uxQueueLength, sizeof( NetworkBufferDescriptor_t * ) );
+
+            if( ( xPacketSocketMutex != NULL ) && ( pxSocket->xRxQueue != NULL ) )
+            {
+                vListInitialiseItem( &( pxSocket->xListItem ) );
+                listSET_LIST_ITEM_OWNER( &( pxSocket->xListItem ), ( void * ) pxSocket );
+
+                ( void ) xSemaphoreTake( xPacketSocketMutex, portMAX_DELAY );
+                vListInsertEnd( &( xPacketSocketList ), &( pxSocket->xListItem ) );
+                ( void ) xSemaphoreGive( xPacketSocketMutex );
+
+                xReturn = pdPASS;
+            }
+            else if( pxSocket->xRxQueue != NULL )
+            {
+                vQueueDelete( pxSocket->xRxQueue );
+                pxSocket->xRxQueue = NULL;
+            }
+            else
+            {
+                /* Out of memory. */
+            }
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Close a packet socket and release the frames that it still holds.
+ *
+ * @param[in] pxSocket The socket to close.
+ */
+    void FreeRTOS_PacketClose( PacketSocket_t * pxSocket )
+    {
+        NetworkBufferDescriptor_t * pxDescriptor;
+
+        if( ( pxSocket != NULL ) && ( pxSocket->xRxQueue != NULL ) )
+        {
+            ( void ) xSemaphoreTake( xPacketSocketMutex, portMAX_DELAY );
+            ( void ) uxListRemove( &( pxSocket->xListItem ) );
+            ( void ) xSemaphoreGive( xPacketSocketMutex );
+
+            while( xQueueReceive( pxSocket->xRxQueue, &( pxDescriptor ), 0U ) == pdPASS )
+            {
+                vReleaseNetworkBufferAndDescriptor( pxDescriptor );
+            }
+
+            vQueueDelete( pxSocket->xRxQueue );
+            pxSocket->xRxQueue = NULL;
+        }
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Attach a filter program to a packet socket.
+ *
+ * @param[in] pxSocket The socket.
+ * @param[in] pxFilter The classic BPF program, or NULL to remove the filter.
+ * @param[in] uxLength The number of instructions.
+ *
+ * @return pdPASS when the program is valid and attached, otherwise pdFAIL.
+ */
+    BaseType_t FreeRTOS_PacketSetFilter( PacketSocket_t * pxSocket,
+                                         const PacketFilterInstruction_t * pxFilter,
+                                         size_t uxLength )
+    {
+        BaseType_t xReturn = pdFAIL;
+
+        if( ( pxSocket != NULL ) && ( pxSocket->xRxQueue != NULL ) &&
+            ( ( pxFilter == NULL ) || ( prvFilterCheck( pxFilter, uxLength ) != pdFALSE ) ) )
+        {
+            ( void ) xSemaphoreTake( xPacketSocketMutex, portMAX_DELAY );
+            pxSocket->pxFilter = pxFilter;
+            pxSocket->uxFilterLength = ( pxFilter != NULL ) ? uxLength : 0U;
+            ( void ) xSemaphoreGive( xPacketSocketMutex );
+
+            xReturn = pdPASS;
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Install a receive handler, or remove it when 'pxHandler' is NULL.
+ *
+ * @param[in] pxSocket The socket.
+ * @param[in] pxHandler The handler.
+ */
+    void FreeRTOS_PacketSetReceiveHandler( PacketSocket_t * pxSocket,
+                                           FOnPacketReceive_t pxHandler )
+    {
+        if( ( pxSocket != NULL ) && ( pxSocket->xRxQueue != NULL ) )
+        {
+            ( void ) xSemaphoreTake( xPacketSocketMutex, portMAX_DELAY );
+            pxSocket->pxHandleReceive = pxHandler;
+            ( void ) xSemaphoreGive( xPacketSocketMutex );
+        }
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Wait for a frame on a packet socket.
+ *
+ * @param[in] pxSocket The socket.
+ * @param[in] xTicksToWait The maximum time to wait.
+ *
+ * @return The network buffer that holds the frame, or NULL on a time-out.
+ *         The caller must release it.
+ */
+    NetworkBufferDescriptor_t * FreeRTOS_PacketRecv( PacketSocket_t * pxSocket,
+                                                     TickType_t xTicksToWait )
+    {
+        NetworkBufferDescriptor_t * pxDescriptor = NULL;
+
+        if( ( pxSocket != NULL ) && ( pxSocket->xRxQueue != NULL ) )
+        {
+            if( xQueueReceive( pxSocket->xRxQueue, &( pxDescriptor ), xTicksToWait ) != pdPASS )
+            {
+                pxDescriptor = NULL;
+            }
+        }
+
+        return pxDescriptor;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Send a frame that was completely built by the caller.
+ *
+ * @param[in] pxSocket The socket, which must be bound to an interface.
+ * @param[in] pxDescriptor The frame. It is released when it can not be sent.
+ * @param[in] xTicksToWait The maximum time to wait for space in the queue of the IP-task.
+ *
+ * @return pdPASS when the frame was passed on, otherwise pdFAIL.
+ */
+    BaseType_t FreeRTOS_PacketSend( PacketSocket_t * pxSocket,
+                                    NetworkBufferDescriptor_t * pxDescriptor,
+                                    TickType_t xTicksToWait )
+    {
+        BaseType_t xReturn = pdFAIL;
+        NetworkInterface_t * pxInterface = ( pxSocket != NULL ) ? pxSocket->pxInterface : NULL;
+
+        configASSERT( pxDescriptor != NULL );
+
+        if( ( pxInterface != NULL ) &&
+            ( pxDescriptor->xDataLength >= ipSIZE_OF_ETH_HEADER ) &&
+            ( pxDescriptor->xDataLength <= ( size_t ) ipTOTAL_ETHERNET_FRAME_SIZE ) )
+        {
+            pxDescriptor->pxInterface = pxInterface;
+            pxDescriptor->pxEndPoint = FreeRTOS_FirstEndPoint( pxInterface );
+
+            if( xIsCallingFromIPTask() == pdTRUE )
+            {
+                vIPForwardTxPacket( pxDescriptor, pdTRUE );
+                xReturn = pdPASS;
+            }
+            else
+            {
+                IPStackEvent_t xSendEvent;
+
+                /* The output functions of the drivers are called by the IP-task. */
+                xSendEvent.eEventType = eNetworkTxEvent;
+                xSendEvent.pvData = pxDescriptor;
+
+                xReturn = xSendEventStructToIPTask( &xSendEvent, xTicksToWait );
+            }
+        }
+
+        if( xReturn != pdPASS )
+        {
+            vReleaseNetworkBufferAndDescriptor( pxDescriptor );
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Offer a received frame to the packet sockets. When several sockets
+ *        want the frame, all but the last one get a copy.
+ *
+ * @param[in] pxDescriptor The received frame, with 'pxInterface' set.
+ *
+ * @return pdTRUE when the frame was taken by the packet sockets, pdFALSE when
+ *         it must be processed as usual.
+ */
+    BaseType_t xPacketSocketDeliver( NetworkBufferDescriptor_t * pxDescriptor )
+    {
+        BaseType_t xReturn = pdFALSE;
+        const EthernetHeader_t * pxEthernetHeader;
+        uint16_t usEtherType;
+        const ListItem_t * pxIterator;
+        const ListItem_t * pxEnd;
+        PacketSocket_t * pxPrevious = NULL;
+
+        /* Most frames are IP or ARP, and most applications have no packet
+         * sockets: check that first without taking the mutex. */
+        if( ( xPacketSocketMutex != NULL ) &&
+            ( listCURRENT_LIST_LENGTH( &( xPacketSocketList ) ) != 0U ) &&
+            ( pxDescriptor->xDataLength >= ipSIZE_OF_ETH_HEADER ) )
+        {
+            /* MISRA Ref 11.3.1 [Misaligned access] */
+            /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+            /* coverity[misra_c_2012_rule_11_3_violation] */
+            pxEthernetHeader = ( ( const EthernetHeader_t * ) pxDescriptor->pucEthernetBuffer );
+            usEtherType = pxEthernetHeader->usFrameType;
+
+            if( prvIsStackEtherType( usEtherType ) == pdFALSE )
+            {
+                ( void ) xSemaphoreTake( xPacketSocketMutex, portMAX_DELAY );
+
+                pxEnd = listGET_END_MARKER( &( xPacketSocketList ) );
+
+                for( pxIterator = listGET_NEXT( pxEnd ); pxIterator != pxEnd; pxIterator = listGET_NEXT( pxIterator ) )
+                {
+                    PacketSocket_t * pxSocket = ( ( PacketSocket_t * ) listGET_LIST_ITEM_OWNER( pxIterator ) );
+
+                    if( prvSocketMatches( pxSocket, pxDescriptor, usEtherType ) != pdFALSE )
+                    {
+                        if( pxPrevious != NULL )
+                        {
+                            NetworkBufferDescriptor_t * pxCopy = pxDuplicateNetworkBufferWithDescriptor( pxDescriptor, pxDescriptor->xDataLength );
+
+                            if( pxCopy != NULL )
+                            {
+                                prvSocketReceive( pxPrevious, pxCopy );
+                            }
+                            else
+                            {
+                                pxPrevious->ulDropped++;
+                            }
+                        }
+
+                        pxPrevious = pxSocket;
+                    }
+                }
+
+                if( pxPrevious != NULL )
+                {
+                    /* The last socket gets the original buffer. */
+                    prvSocketReceive( pxPrevious, pxDescriptor );
+                    xReturn = pdTRUE;
+                }
+
+                ( void ) xSemaphoreGive( xPacketSocketMutex );
+            }
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Offer a received frame to the packet sockets from the receive task
+ *        of a driver, before it is sent to the IP-task.
+ *
+ * Frames of a member of a bond or a port of a bridge are left to the IP-task,
+ * they must first pass xBondingReceive() and eBridgeReceive(): a standby
+ * member receives duplicates of the frames of the active one, and a bridge
+ * may have to forward the frame to its other ports.
+ *
+ * @param[in] pxDescriptor The received frame, with 'pxInterface' set.
+ *
+ * @return pdTRUE when the frame was taken by the packet sockets, pdFALSE when
+ *         it must be sent to the IP-task.
+ */
+    BaseType_t xPacketSocketDriverDeliver( NetworkBufferDescriptor_t * pxDescriptor )
+    {
+        BaseType_t xReturn = pdFALSE;
+        BaseType_t xOwnFrame = ( pxDescriptor->pxInterface != NULL ) ? pdTRUE : pdFALSE;
+
+        #if ( ipconfigUSE_BONDING != 0 )
+            if( ( xOwnFrame != pdFALSE ) && ( pxDescriptor->pxInterface->pxBondMaster != NULL ) )
+            {
+                xOwnFrame = pdFALSE;
+            }
+        #endif
+
+        #if ( ipconfigUSE_BRIDGE != 0 )
+            if( ( xOwnFrame != pdFALSE ) && ( pxDescriptor->pxInterface->pxBridge != NULL ) )
+            {
+                xOwnFrame = pdFALSE;
+            }
+        #endif
+
+        if( xOwnFrame != pdFALSE )
+        {
+            xReturn = xPacketSocketDeliver( pxDescriptor );
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Run a classic BPF program. The program was checked by prvFilterCheck().
+ *
+ * @param[in] pxFilter The program.
+ * @param[in] uxLength The number of instructions.
+ * @param[in] pucFrame The frame, starting at the Ethernet header.
+ * @param[in] uxFrameLength The length of the frame.
+ *
+ * @return The value returned by the program, zero to reject the frame. A load
+ *         outside of the frame also rejects it.
+ */
+    uint32_t ulPacketFilterRun( const PacketFilterInstruction_t * pxFilter,
+                                size_t uxLength,
+                                const uint8_t * pucFrame,
+                                size_t uxFrameLength )
+    {
+        uint32_t ulA = 0U;
+        uint32_t ulX = 0U;
+        uint32_t ulMemory[ packetBPF_MEMWORDS ];
+        uint32_t ulResult = 0U;
+        size_t uxPC = 0U;
+        BaseType_t xRunning = pdTRUE;
+
+        ( void ) memset( ulMemory, 0, sizeof( ulMemory ) );
+
+        while( ( xRunning != pdFALSE ) && ( uxPC < uxLength ) )
+        {
+            const PacketFilterInstruction_t * pxInstruction = &( pxFilter[ uxPC ] );
+            uint32_t ulCode = pxInstruction->usCode;
+            uint32_t ulK = pxInstruction->ulK;
+            uint32_t ulOperand = ( packetBPF_SRC( ulCode ) == packetBPF_X ) ? ulX : ulK;
+            uint32_t ulSize;
+
+            uxPC++;
+
+            switch( packetBPF_CLASS( ulCode ) )
+            {
+                case packetBPF_LD:
+                case packetBPF_LDX:
+                   {
+                       uint32_t ulValue = 0U;
+                       uint32_t ulMode = packetBPF_MODE( ulCode );
+
+                       ulSize = ( packetBPF_SIZE( ulCode ) == packetBPF_W ) ? 4U : ( ( packetBPF_SIZE( ulCode ) == packetBPF_H ) ? 2U : 1U );
+
+                       switch( ulMode )
+                       {
+                           case packetBPF_IMM:
+                               ulValue = ulK;
+                               break;
+
+                           case packetBPF_LEN:
+                               ulValue = ( uint32_t ) uxFrameLength;
+                               break;
+
+                           case packetBPF_MEM:
+                               ulValue = ulMemory[ ulK ];
+                               break;
+
+                           case packetBPF_ABS:
+                               xRunning = prvFilterLoad( pucFrame, uxFrameLength, ulK, ulSize, &( ulValue ) );
+                               break;
+
+                           case packetBPF_IND:
+                               xRunning = prvFilterLoad( pucFrame, uxFrameLength, ulX + ulK, ulSize, &( ulValue ) );
+                               break;
+
+                           default:
+                               /* packetBPF_MSH: 4 * ( P[ k ] & 0x0F ), the length of an IPv4 header. */
+                               xRunning = prvFilterLoad( pucFrame, uxFrameLength, ulK, 1U, &( ulValue ) );
+                               ulValue = ( ulValue & 0x0FU ) << 2;
+                               break;
+                       }
+
+                       if( packetBPF_CLASS( ulCode ) == packetBPF_LD )
+                       {
+                           ulA = ulValue;
+                       }
+                       else
+                       {
+                           ulX = ulValue;
+                       }
+                   }
+                   break;
+
+                case packetBPF_ST:
+                    ulMemory[ ulK ] = ulA;
+                    break;
+
+                case packetBPF_STX:
+                    ulMemory[ ulK ] = ulX;
+                    break;
+
+                case packetBPF_ALU:
+
+                    switch( packetBPF_OP( ulCode ) )
+                    {
+                        case packetBPF_ADD:
+                            ulA += ulOperand;
+                            break;
+
+                        case packetBPF_SUB:
+                            ulA -= ulOperand;
+                            break;
+
+                        case packetBPF_MUL:
+                            ulA *= ulOperand;
+                            break;
+
+                        case packetBPF_DIV:
+                        case packetBPF_MOD:
+
+                            /* Division by a zero X rejects the frame. */
+                            if( ulOperand == 0U )
+                            {
+                                xRunning = pdFALSE;
+                            }
+                            else if( packetBPF_OP( ulCode ) == packetBPF_DIV )
+                            {
+                                ulA /= ulOperand;
+                            }
+                            else
+                            {
+                                ulA %= ulOperand;
+                            }
+
+                            break;
+
+                        case packetBPF_OR:
+                            ulA |= ulOperand;
+                            break;
+
+                        case packetBPF_AND:
+                            ulA &= ulOperand;
+                            break;
+
+                        case packetBPF_LSH:
+                            ulA = ( ulOperand < 32U ) ? ( ulA << ulOperand ) : 0U;
+                            break;
+
+                        case packetBPF_RSH:
+                            ulA = ( ulOperand < 32U ) ? ( ulA >> ulOperand ) : 0U;
+                            break;
+
+                        case packetBPF_NEG:
+                            ulA = 0U - ulA;
+                            break;
+
+                        default:
+                            /* packetBPF_XOR */
+                            ulA ^= ulOperand;
+                            break;
+                    }
+
+                    break;
+
+                case packetBPF_JMP:
+                   {
+                       BaseType_t xCondition;
+
+                       switch( packetBPF_OP( ulCode ) )
+                       {
+                           case packetBPF_JA:
+                               uxPC += ulK;
+                               break;
+
+                           default:
+
+                               if( packetBPF_OP( ulCode ) == packetBPF_JEQ )
+                               {
+                                   xCondition = ( ulA == ulOperand ) ? pdTRUE : pdFALSE;
+                               }
+                               else if( packetBPF_OP( ulCode ) == packetBPF_JGT )
+                               {
+                                   xCondition = ( ulA > ulOperand ) ? pdTRUE : pdFALSE;
+                               }
+                               else if( packetBPF_OP( ulCode ) == packetBPF_JGE )
+                               {
+                                   xCondition = ( ulA >= ulOperand ) ? pdTRUE : pdFALSE;
+                               }
+                               else
+                               {
+                                   /* packetBPF_JSET */
+                                   xCondition = ( ( ulA & ulOperand ) != 0U ) ? pdTRUE : pdFALSE;
+                               }
+
+                               uxPC += ( xCondition != pdFALSE ) ? pxInstruction->ucJumpTrue : pxInstruction->ucJumpFalse;
+                               break;
+                       }
+                   }
+                   break;
+
+                case packetBPF_RET:
+                    ulResult = ( packetBPF_RVAL( ulCode ) == packetBPF_A ) ? ulA : ( ( packetBPF_RVAL( ulCode ) == packetBPF_X ) ? ulX : ulK );
+                    xRunning = pdFALSE;
+                    break;
+
+                default:
+
+                    /* packetBPF_MISC */
+                    if( packetBPF_MISCOP( ulCode ) == packetBPF_TAX )
+                    {
+                        ulX = ulA;
+                    }
+                    else
+                    {
+                        ulA = ulX;
+                    }
+
+                    break;
+            }
+        }
+
+        return ulResult;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Check if an EtherType belongs to the IP-stack.
+ *
+ * @param[in] usEtherType The EtherType in network byte order.
+ *
+ * @return pdTRUE for ARP, IPv4 and IPv6.
+ */
+    static BaseType_t prvIsStackEtherType( uint16_t usEtherType )
+    {
+        BaseType_t xReturn = pdFALSE;
+
+        if( ( usEtherType == ipARP_FRAME_TYPE ) ||
+            ( usEtherType == ipIPv4_FRAME_TYPE ) ||
+            ( usEtherType == ipIPv6_FRAME_TYPE ) )
+        {
+            xReturn = pdTRUE;
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Check a filter program before it is used: every instruction must be
+ *        known, all jumps must land inside the program, scratch memory must
+ *        exist, and the program must end with a return instruction. Together
+ *        with the forward-only jumps this makes sure that it terminates.
+ *
+ * @param[in] pxFilter The program.
+ * @param[in] uxLength The number of instructions.
+ *
+ * @return pdTRUE when the program is valid.
+ */
+    static BaseType_t prvFilterCheck( const PacketFilterInstruction_t * pxFilter,
+                                      size_t uxLength )
+    {
+        BaseType_t xValid = pdTRUE;
+        size_t uxPC;
+
+        if( ( uxLength == 0U ) || ( uxLength > ( size_t ) ipconfigPACKET_FILTER_MAX_INSTRUCTIONS ) )
+        {
+            xValid = pdFALSE;
+        }
+
+        for( uxPC = 0U; ( xValid != pdFALSE ) && ( uxPC < uxLength ); uxPC++ )
+        {
+            uint32_t ulCode = pxFilter[ uxPC ].usCode;
+            uint32_t ulK = pxFilter[ uxPC ].ulK;
+            size_t uxRemaining = uxLength - uxPC - 1U;
+
+            switch( packetBPF_CLASS( ulCode ) )
+            {
+                case packetBPF_LD:
+                case packetBPF_LDX:
+
+                    if( packetBPF_MODE( ulCode ) == packetBPF_MEM )
+                    {
+                        xValid = ( ulK < packetBPF_MEMWORDS ) ? pdTRUE : pdFALSE;
+                    }
+                    else if( packetBPF_CLASS( ulCode ) == packetBPF_LD )
+                    {
+                        xValid = ( ( packetBPF_MODE( ulCode ) <= packetBPF_LEN ) && ( packetBPF_SIZE( ulCode ) != 0x18U ) ) ? pdTRUE : pdFALSE;
+                    }
+                    else
+                    {
+                        /* LDX knows IMM, MEM, LEN, and MSH with a byte size. */
+                        xValid = ( ( ulCode == ( packetBPF_LDX | packetBPF_W | packetBPF_IMM ) ) ||
+                                   ( ulCode == ( packetBPF_LDX | packetBPF_W | packetBPF_LEN ) ) ||
+                                   ( ulCode == ( packetBPF_LDX | packetBPF_B | packetBPF_MSH ) ) ) ? pdTRUE : pdFALSE;
+                    }
+
+                    break;
+
+                case packetBPF_ST:
+                case packetBPF_STX:
+                    xValid = ( ulK < packetBPF_MEMWORDS ) ? pdTRUE : pdFALSE;
+                    break;
+
+                case packetBPF_ALU:
+
+                    if( packetBPF_OP( ulCode ) > packetBPF_XOR )
+                    {
+                        xValid = pdFALSE;
+                    }
+                    else if( ( ( packetBPF_OP( ulCode ) == packetBPF_DIV ) || ( packetBPF_OP( ulCode ) == packetBPF_MOD ) ) &&
+                             ( packetBPF_SRC( ulCode ) == packetBPF_K ) && ( ulK == 0U ) )
+                    {
+                        xValid = pdFALSE;
+                    }
+                    else
+                    {
+                        /* A valid operation. */
+                    }
+
+                    break;
+
+                case packetBPF_JMP:
+
+                    if( packetBPF_OP( ulCode ) == packetBPF_JA )
+                    {
+                        xValid = ( ulK < uxRemaining ) ? pdTRUE : pdFALSE;
+                    }
+                    else if( packetBPF_OP( ulCode ) <= packetBPF_JSET )
+                    {
+                        xValid = ( ( pxFilter[ uxPC ].ucJumpTrue < uxRemaining ) &&
+                                   ( pxFilter[ uxPC ].ucJumpFalse < uxRemaining ) ) ? pdTRUE : pdFALSE;
+                    }
+                    else
+                    {
+                        xValid = pdFALSE;
+                    }
+
+                    break;
+
+                case packetBPF_RET:
+                    xValid = ( packetBPF_RVAL( ulCode ) != 0x18U ) ? pdTRUE : pdFALSE;
+                    break;
+
+                default:
+                    /* packetBPF_MISC */
+                    xValid = ( ( packetBPF_MISCOP( ulCode ) == packetBPF_TAX ) || ( packetBPF_MISCOP( ulCode ) == packetBPF_TXA ) ) ? pdTRUE : pdFALSE;
+                    break;
+            }
+        }
+
+        if( ( xValid != pdFALSE ) && ( packetBPF_CLASS( pxFilter[ uxLength - 1U ].usCode ) != packetBPF_RET ) )
+        {
+            xValid = pdFALSE;
+        }
+
+        return xValid;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Load a big-endian value from a frame, for a filter program.
+ *
+ * @param[in] pucFrame The frame.
+ * @param[in] uxFrameLength The length of the frame.
+ * @param[in] ulOffset The offset of the value.
+ * @param[in] ulSize The size of the value: 1, 2 or 4 bytes.
+ * @param[out] pulValue The value.
+ *
+ * @return pdFALSE when the value lies outside of the frame.
+ */
+    static BaseType_t prvFilterLoad( const uint8_t * pucFrame,
+                                     size_t uxFrameLength,
+                                     uint32_t ulOffset,
+                                     uint32_t ulSize,
+                                     uint32_t * pulValue )
+    {
+        BaseType_t xReturn = pdFALSE;
+        uint32_t ulValue = 0U;
+        uint32_t ulIndex;
+
+        if( ( ( size_t ) ulOffset < uxFrameLength ) && ( ( size_t ) ulSize <= ( uxFrameLength - ( size_t ) ulOffset ) ) )
+        {
+            for( ulIndex = 0U; ulIndex < ulSize; ulIndex++ )
+            {
+                ulValue = ( ulValue << 8 ) | pucFrame[ ulOffset + ulIndex ];
+            }
+
+            xReturn = pdTRUE;
+        }
+
+        *pulValue = ulValue;
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Check if a packet socket wants a frame.
+ *
+ * @param[in] pxSocket The socket.
+ * @param[in] pxDescriptor The frame.
+ * @param[in] usEtherType The EtherType of the frame, in network byte order.
+ *
+ * @return pdTRUE when the interface and the EtherType match, and the filter
+ *         accepts the frame.
+ */
+    static BaseType_t prvSocketMatches( const PacketSocket_t * pxSocket,
+                                        const NetworkBufferDescriptor_t * pxDescriptor,
+                                        uint16_t usEtherType )
+    {
+        BaseType_t xReturn = pdFALSE;
+        const NetworkInterface_t * pxInterface = pxDescriptor->pxInterface;
+
+        /* A socket bound to a bond or a bridge receives the frames of its members. */
+        if( ( ( pxSocket->pxInterface == NULL ) ||
+              ( pxSocket->pxInterface == pxInterface ) ||
+              ( pxSocket->pxInterface == INTERFACE_OWNER( pxInterface ) ) ) &&
+            ( ( pxSocket->usEtherType == packetETHER_TYPE_ANY ) || ( pxSocket->usEtherType == usEtherType ) ) )
+        {
+            if( ( pxSocket->pxFilter == NULL ) ||
+                ( ulPacketFilterRun( pxSocket->pxFilter, pxSocket->uxFilterLength, pxDescriptor->pucEthernetBuffer, pxDescriptor->xDataLength ) != 0U ) )
+            {
+                xReturn = pdTRUE;
+            }
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Hand a frame to a packet socket, which becomes its owner.
+ *
+ * @param[in] pxSocket The socket.
+ * @param[in] pxDescriptor The frame.
+ */
+    static void prvSocketReceive( PacketSocket_t * pxSocket,
+                                  NetworkBufferDescriptor_t * pxDescriptor )
+    {
+        BaseType_t xTaken = pdFALSE;
+
+        pxSocket->ulReceived++;
+
+        if( pxSocket->pxHandleReceive != NULL )
+        {
+            xTaken = pxSocket->pxHandleReceive( pxSocket, pxDescriptor );
+        }
+
+        if( xTaken == pdFALSE )
+        {
+            if( xQueueSendToBack( pxSocket->xRxQueue, &( pxDescriptor ), 0U ) != pdPASS )
+            {
+                pxSocket->ulDropped++;
+                vReleaseNetworkBufferAndDescriptor( pxDescriptor );
+            }
+        }
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* ( ipconfigUSE_PACKET_SOCKETS != 0 ) */
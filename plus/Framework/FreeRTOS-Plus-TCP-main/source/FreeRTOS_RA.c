@@ -46,6 +46,9 @@
 #include "FreeRTOS_UDP_IP.h"
 #include "FreeRTOS_Routing.h"
 #include "FreeRTOS_ND.h"
+#if ( ipconfigRA_PARALLEL_DHCPv6 != 0 )
+    #include "FreeRTOS_DHCPv6.h"
+#endif
 #if ( ipconfigUSE_LLMNR == 1 )
     #include "FreeRTOS_DNS.h"
 #endif /* ipconfigUSE_LLMNR */
@@ -85,6 +88,17 @@
     static TickType_t xRAProcess_HandleOtherStates( NetworkEndPoint_t * pxEndPoint,
                                                     TickType_t uxReloadTime );
 
+/* Choose a new IP-address, based on the prefix of the end-point. */
+    static void prvRACreateIPAddress( NetworkEndPoint_t * pxEndPoint );
+
+/* The end-point may be used, send the network-up event. */
+    static void prvRANetworkUp( NetworkEndPoint_t * pxEndPoint );
+
+    #if ( ipconfigRA_CACHE_PREFIX != 0 )
+/* Use the prefix of a previous Router Advertisement, if it is still valid. */
+        static BaseType_t xRAUseCachedPrefix( NetworkEndPoint_t * pxEndPoint );
+    #endif
+
 
 /*-----------------------------------------------------------*/
 
@@ -253,7 +267,7 @@
                 if( memcmp( pxPoint->ipv6_settings.xIPAddress.ucBytes, pxICMPHeader_IPv6->xIPv6Address.ucBytes, ipSIZE_OF_IPv6_ADDRESS ) == 0 )
                 {
                     pxPoint->xRAData.bits.bIPAddressInUse = pdTRUE_UNSIGNED;
-                    vDHCP_RATimerReload( pxPoint, 100U );
+                    vRATimerReload( pxPoint, 100U );
                 }
             }
         }
@@ -411,6 +425,20 @@
                             pxEndPoint->xRAData.bits.bRouterReplied = pdTRUE_UNSIGNED;
                             pxEndPoint->xRAData.uxRetryCount = 0U;
                             pxEndPoint->xRAData.ulPreferredLifeTime = FreeRTOS_ntohl( pxPrefixOption->ulPreferredLifeTime );
+
+                            #if ( ipconfigRA_CACHE_PREFIX != 0 )
+                            {
+                                /* Remember the advertisement, so the next link-up does not have to wait for it. */
+                                ( void ) memcpy( pxEndPoint->xRAData.xCachedPrefix.ucBytes, pxPrefixOption->ucPrefix, ipSIZE_OF_IPv6_ADDRESS );
+                                ( void ) memcpy( pxEndPoint->xRAData.xCachedGateway.ucBytes, pxICMPPacket->xIPHeader.xSourceAddress.ucBytes, ipSIZE_OF_IPv6_ADDRESS );
+                                pxEndPoint->xRAData.uxCachedPrefixLength = pxPrefixOption->ucPrefixLength;
+                                pxEndPoint->xRAData.ulCachedLifeTime = pxEndPoint->xRAData.ulPreferredLifeTime;
+                                pxEndPoint->xRAData.xCachedTime = xTaskGetTickCount();
+                                /* The address will be stored once it has been tested. */
+                                pxEndPoint->xRAData.bits.bPrefixCached = pdFALSE_UNSIGNED;
+                            }
+                            #endif /* ( ipconfigRA_CACHE_PREFIX != 0 ) */
+
                             /* Force taking a new random IP-address. */
                             pxEndPoint->xRAData.bits.bIPAddressInUse = pdTRUE_UNSIGNED;
                             pxEndPoint->xRAData.eRAState = eRAStateIPTest;
@@ -475,6 +503,26 @@
                 pxEndPoint->xRAData.uxRetryCount = 0U;
                 pxEndPoint->xRAData.eRAState = eRAStateIPTest;
                 uxNewReloadTime = pdMS_TO_TICKS( ipconfigRA_IP_TEST_TIME_OUT_MSEC );
+
+                #if ( ipconfigRA_STABLE_PRIVACY_ADDRESS != 0 )
+                {
+                    /* RFC 7217: the next address will be calculated with a new DAD counter. */
+                    pxEndPoint->xRAData.ucDADCounter++;
+                }
+                #endif
+
+                #if ( ipconfigRA_OPTIMISTIC_DAD != 0 )
+                {
+                    if( pxEndPoint->xRAData.bits.bOptimistic != pdFALSE_UNSIGNED )
+                    {
+                        /* The optimistic address turned out to be a duplicate, withdraw it.
+                         * The end-point will go up again with the next address. */
+                        FreeRTOS_printf( ( "RA: optimistic address %pip is in use\n", ( void * ) pxEndPoint->ipv6_settings.xIPAddress.ucBytes ) );
+                        pxEndPoint->xRAData.bits.bOptimistic = pdFALSE_UNSIGNED;
+                        pxEndPoint->bits.bEndPointUp = pdFALSE_UNSIGNED;
+                    }
+                }
+                #endif /* ( ipconfigRA_OPTIMISTIC_DAD != 0 ) */
             }
             else if( pxEndPoint->xRAData.uxRetryCount < ( UBaseType_t ) ipconfigRA_IP_TEST_COUNT )
             {
@@ -508,9 +556,27 @@
                     uxNewReloadTime = 0U;
                 }
 
-                /* Now call vIPNetworkUpCalls() to send the network-up event and
-                 * start the ARP timer. */
-                vIPNetworkUpCalls( pxEndPoint );
+                #if ( ipconfigRA_CACHE_PREFIX != 0 )
+                    if( pxEndPoint->xRAData.bits.bRouterReplied != pdFALSE_UNSIGNED )
+                    {
+                        ( void ) memcpy( pxEndPoint->xRAData.xCachedAddress.ucBytes, pxEndPoint->ipv6_settings.xIPAddress.ucBytes, ipSIZE_OF_IPv6_ADDRESS );
+                        pxEndPoint->xRAData.bits.bPrefixCached = pdTRUE_UNSIGNED;
+                    }
+                #endif /* ( ipconfigRA_CACHE_PREFIX != 0 ) */
+
+                #if ( ipconfigRA_OPTIMISTIC_DAD != 0 )
+                    if( pxEndPoint->xRAData.bits.bOptimistic != pdFALSE_UNSIGNED )
+                    {
+                        /* The end-point went up already, the address is now "preferred". */
+                        pxEndPoint->xRAData.bits.bOptimistic = pdFALSE_UNSIGNED;
+                    }
+                    else
+                #endif /* ( ipconfigRA_OPTIMISTIC_DAD != 0 ) */
+                {
+                    /* Now call vIPNetworkUpCalls() to send the network-up event and
+                     * start the ARP timer. */
+                    prvRANetworkUp( pxEndPoint );
+                }
             }
         }
         else
@@ -549,7 +615,7 @@
                    xIPAddress.ucBytes[ 1 ] = 0x02U;
                    xIPAddress.ucBytes[ 15 ] = 0x02U;
                    uxNeededSize = ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv6_HEADER + sizeof( ICMPRouterSolicitation_IPv6_t );
-                   pxNetworkBuffer = pxGetNetworkBufferWithDescriptor( uxNeededSize, raDONT_BLOCK );
+                   pxNetworkBuffer = pxGetNetworkBufferWithClass( uxNeededSize, raDONT_BLOCK, eBufferClassControl );
 
                    if( pxNetworkBuffer != NULL )
                    {
@@ -576,15 +642,13 @@
                    {
                        pxEndPoint->xRAData.bits.bIPAddressInUse = pdFALSE_UNSIGNED;
 
-                       ( void ) FreeRTOS_CreateIPv6Address( &pxEndPoint->ipv6_settings.xIPAddress, &pxEndPoint->ipv6_settings.xPrefix, pxEndPoint->ipv6_settings.uxPrefixLength, pdTRUE );
-
-                       FreeRTOS_printf( ( "RA: Creating a random IP-address\n" ) );
+                       prvRACreateIPAddress( pxEndPoint );
                    }
 
                    FreeRTOS_printf( ( "RA: Neighbour solicitation for %pip\n", ( void * ) pxEndPoint->ipv6_settings.xIPAddress.ucBytes ) );
 
                    uxNeededSize = ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv6_HEADER + sizeof( ICMPHeader_IPv6_t );
-                   pxNetworkBuffer = pxGetNetworkBufferWithDescriptor( uxNeededSize, raDONT_BLOCK );
+                   pxNetworkBuffer = pxGetNetworkBufferWithClass( uxNeededSize, raDONT_BLOCK, eBufferClassControl );
 
                    if( pxNetworkBuffer != NULL )
                    {
@@ -594,6 +658,22 @@
 
                    uxNewReloadTime = pdMS_TO_TICKS( 1000U );
                    pxEndPoint->xRAData.eRAState = eRAStateIPWait;
+
+                   #if ( ipconfigRA_OPTIMISTIC_DAD != 0 )
+                   {
+                       /* RFC 4429: a new address may be used while it is being tested.
+                        * This is only done while bringing up the end-point, not when
+                        * the address is renewed. */
+                       if( ( pxEndPoint->bits.bEndPointUp == pdFALSE_UNSIGNED ) &&
+                           ( pxEndPoint->xRAData.uxRetryCount == 0U ) &&
+                           ( pxEndPoint->xRAData.bits.bOptimistic == pdFALSE_UNSIGNED ) )
+                       {
+                           FreeRTOS_printf( ( "RA: optimistic use of %pip\n", ( void * ) pxEndPoint->ipv6_settings.xIPAddress.ucBytes ) );
+                           pxEndPoint->xRAData.bits.bOptimistic = pdTRUE_UNSIGNED;
+                           prvRANetworkUp( pxEndPoint );
+                       }
+                   }
+                   #endif /* ( ipconfigRA_OPTIMISTIC_DAD != 0 ) */
                }
                break;
 
@@ -629,7 +709,107 @@
     {
         pxEndPoint->xRAData.uxRetryCount = 0U;
         pxEndPoint->xRAData.eRAState = eRAStateApply;
+        #if ( ipconfigRA_OPTIMISTIC_DAD != 0 )
+            pxEndPoint->xRAData.bits.bOptimistic = pdFALSE_UNSIGNED;
+        #endif
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Choose a new IP-address for the end-point, using its network prefix.
+ *        The host bits are either random, or derived as in RFC 7217.
+ *
+ * @param[in] pxEndPoint The end-point for which an IP-address is needed.
+ */
+    static void prvRACreateIPAddress( NetworkEndPoint_t * pxEndPoint )
+    {
+        #if ( ipconfigRA_STABLE_PRIVACY_ADDRESS != 0 )
+            if( FreeRTOS_CreateStablePrivacyIPv6Address( &( pxEndPoint->ipv6_settings.xIPAddress ),
+                                                         &( pxEndPoint->ipv6_settings.xPrefix ),
+                                                         pxEndPoint->ipv6_settings.uxPrefixLength,
+                                                         pxEndPoint,
+                                                         pxEndPoint->xRAData.ucDADCounter ) == pdPASS )
+            {
+                FreeRTOS_printf( ( "RA: Creating a stable privacy IP-address (DAD counter %u)\n", ( unsigned ) pxEndPoint->xRAData.ucDADCounter ) );
+            }
+            else
+        #endif /* ( ipconfigRA_STABLE_PRIVACY_ADDRESS != 0 ) */
+        {
+            ( void ) FreeRTOS_CreateIPv6Address( &pxEndPoint->ipv6_settings.xIPAddress, &pxEndPoint->ipv6_settings.xPrefix, pxEndPoint->ipv6_settings.uxPrefixLength, pdTRUE );
+
+            FreeRTOS_printf( ( "RA: Creating a random IP-address\n" ) );
+        }
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief The address of the end-point may be used. When DHCPv6 is running
+ *        in parallel, it will be stopped. Then vIPNetworkUpCalls() is called.
+ *
+ * @param[in] pxEndPoint The end-point that goes up.
+ */
+    static void prvRANetworkUp( NetworkEndPoint_t * pxEndPoint )
+    {
+        #if ( ipconfigRA_PARALLEL_DHCPv6 != 0 )
+            if( END_POINT_USES_DHCP( pxEndPoint ) )
+            {
+                /* RA/SLAAC was faster than DHCPv6. */
+                vDHCPv6Stop( pxEndPoint );
+            }
+        #endif /* ( ipconfigRA_PARALLEL_DHCPv6 != 0 ) */
+
+        vIPNetworkUpCalls( pxEndPoint );
     }
+/*-----------------------------------------------------------*/
+
+    #if ( ipconfigRA_CACHE_PREFIX != 0 )
+
+/**
+ * @brief When the link comes up, see if the prefix of the last Router Advertisement
+ *        is still valid. If so, skip the solicitation and test the cached address.
+ *
+ * @param[in] pxEndPoint The end-point for which RA is being reset.
+ *
+ * @return pdTRUE when the cached prefix will be used.
+ */
+        static BaseType_t xRAUseCachedPrefix( NetworkEndPoint_t * pxEndPoint )
+        {
+            BaseType_t xReturn = pdFALSE;
+            RAData_t * pxRAData = &( pxEndPoint->xRAData );
+
+            if( pxRAData->bits.bPrefixCached != pdFALSE_UNSIGNED )
+            {
+                /* Expressed in seconds, so large life-times do not overflow. */
+                uint32_t ulAge = ( uint32_t ) ( ( xTaskGetTickCount() - pxRAData->xCachedTime ) / ( TickType_t ) configTICK_RATE_HZ );
+
+                if( ulAge < pxRAData->ulCachedLifeTime )
+                {
+                    pxEndPoint->ipv6_settings.uxPrefixLength = pxRAData->uxCachedPrefixLength;
+                    ( void ) memcpy( pxEndPoint->ipv6_settings.xPrefix.ucBytes, pxRAData->xCachedPrefix.ucBytes, ipSIZE_OF_IPv6_ADDRESS );
+                    ( void ) memcpy( pxEndPoint->ipv6_settings.xGatewayAddress.ucBytes, pxRAData->xCachedGateway.ucBytes, ipSIZE_OF_IPv6_ADDRESS );
+                    ( void ) memcpy( pxEndPoint->ipv6_settings.xIPAddress.ucBytes, pxRAData->xCachedAddress.ucBytes, ipSIZE_OF_IPv6_ADDRESS );
+
+                    pxRAData->bits.bRouterReplied = pdTRUE_UNSIGNED;
+                    /* Test the cached address, in stead of creating a new one. */
+                    pxRAData->bits.bIPAddressInUse = pdFALSE_UNSIGNED;
+                    pxRAData->ulPreferredLifeTime = pxRAData->ulCachedLifeTime - ulAge;
+                    pxRAData->eRAState = eRAStateIPTest;
+                    xReturn = pdTRUE;
+
+                    FreeRTOS_printf( ( "RA: using cached prefix %pip, %u seconds left\n",
+                                       ( void * ) pxRAData->xCachedPrefix.ucBytes,
+                                       ( unsigned ) pxRAData->ulPreferredLifeTime ) );
+                }
+                else
+                {
+                    pxRAData->bits.bPrefixCached = pdFALSE_UNSIGNED;
+                }
+            }
+
+            return xReturn;
+        }
+    #endif /* ( ipconfigRA_CACHE_PREFIX != 0 ) */
+/*-----------------------------------------------------------*/
 
 /**
  * @brief Do a single cycle of the RA state machine.
@@ -652,6 +832,12 @@
         if( xDoReset != pdFALSE )
         {
             vRAProcessInit( pxEndPoint );
+
+            #if ( ipconfigRA_CACHE_PREFIX != 0 )
+            {
+                ( void ) xRAUseCachedPrefix( pxEndPoint );
+            }
+            #endif
         }
 
         /* First handle the states that are limited by a timer. See if some
@@ -676,13 +862,13 @@
         if( uxReloadTime != 0U )
         {
             FreeRTOS_printf( ( "RA: Reload %u seconds\n", ( unsigned ) ( uxReloadTime / 1000U ) ) );
-            vDHCP_RATimerReload( pxEndPoint, uxReloadTime );
+            vRATimerReload( pxEndPoint, uxReloadTime );
         }
         else
         {
             /* Disable the timer, this function vRAProcess() won't be called anymore for this end-point. */
             FreeRTOS_printf( ( "RA: Disabled timer.\n" ) );
-            vIPSetDHCP_RATimerEnableState( pxEndPoint, pdFALSE );
+            vIPSetRATimerEnableState( pxEndPoint, pdFALSE );
         }
     }
 /*-----------------------------------------------------------*/
@@ -325,6 +325,10 @@ struct xIPv6_Couple
     {
         NetworkEndPoint_t * pxEndPoint = pxNetworkEndPoints;
 
+        /* The members of a bond and the ports of a bridge use the end-points
+         * of the bond or the bridge. */
+        pxInterface = INTERFACE_OWNER( pxInterface );
+
         /* Find and return the NetworkEndPoint_t structure that is associated with
          * the pxInterface NetworkInterface_t. *//*_RB_ Could this be made a two way link, so the NetworkEndPoint_t can just be read from the NetworkInterface_t structure?  Looks like there is a pointer in the struct already. */
         while( pxEndPoint != NULL )
@@ -356,6 +360,8 @@ struct xIPv6_Couple
     {
         NetworkEndPoint_t * pxResult = pxEndPoint;
 
+        pxInterface = INTERFACE_OWNER( pxInterface );
+
         if( pxResult != NULL )
         {
             pxResult = pxResult->pxNext;
@@ -301,6 +301,25 @@ static BaseType_t prvMakeSureSocketIsBound( FreeRTOS_Socket_t * pxSocket );
 
 #endif /* ( ipconfigUSE_TCP != 0 ) */
 
+#if ( ipconfigUSE_TCP_NAGLE == 1 )
+
+/**
+ * @brief Handle the socket options FREERTOS_SO_TCP_NODELAY and FREERTOS_SO_TCP_CORK.
+ */
+    static BaseType_t prvSetOptionCoalesce( FreeRTOS_Socket_t * pxSocket,
+                                            int32_t lOptionName,
+                                            const void * pvOptionValue );
+
+#endif /* ( ipconfigUSE_TCP_NAGLE == 1 ) */
+
+#if ( ipconfigUSE_TCP_FAST_OPEN == 1 )
+
+/** @brief Handle the socket option FREERTOS_SO_TCP_FASTOPEN. */
+    static BaseType_t prvSetOptionFastOpen( FreeRTOS_Socket_t * pxSocket,
+                                            const void * pvOptionValue );
+
+#endif /* ( ipconfigUSE_TCP_FAST_OPEN == 1 ) */
+
 #if ( ipconfigUSE_TCP != 0 )
 
 /** @brief Handle the socket option FREERTOS_SO_STOP_RX. */
@@ -1508,7 +1527,7 @@ static int32_t prvSendTo_ActualSend( const FreeRTOS_Socket_t * pxSocket,
 
         /* Block until a buffer becomes available, or until a
          * timeout has been reached */
-        pxNetworkBuffer = pxGetNetworkBufferWithDescriptor( uxPayloadOffset + uxTotalDataLength, xTicksToWait );
+        pxNetworkBuffer = pxGetNetworkBufferWithClass( uxPayloadOffset + uxTotalDataLength, xTicksToWait, eBufferClassUDP_TX );
 
         if( pxNetworkBuffer != NULL )
         {
@@ -1863,6 +1882,13 @@ static BaseType_t prvSocketBindAdd( FreeRTOS_Socket_t * pxSocket,
             /* Add the socket to 'xBoundUDPSocketsList' or 'xBoundTCPSocketsList' */
             vListInsertEnd( pxSocketList, &( pxSocket->xBoundSocketListItem ) );
 
+            #if ( ( ipconfigUSE_RX_ADMISSION != 0 ) && ( ipconfigUSE_TCP == 1 ) )
+                if( pxSocket->ucProtocol == ( uint8_t ) FREERTOS_IPPROTO_TCP )
+                {
+                    vRxAdmissionSetPort( pxAddress->sin_port, pdTRUE );
+                }
+            #endif
+
             #if ( ipconfigETHERNET_DRIVER_FILTERS_PACKETS == 1 )
             {
                 ( void ) xTaskResumeAll();
@@ -2134,6 +2160,13 @@ void * vSocketClose( FreeRTOS_Socket_t * pxSocket )
 
         ( void ) uxListRemove( &( pxSocket->xBoundSocketListItem ) );
 
+        #if ( ( ipconfigUSE_RX_ADMISSION != 0 ) && ( ipconfigUSE_TCP == 1 ) )
+            if( pxSocket->ucProtocol == ( uint8_t ) FREERTOS_IPPROTO_TCP )
+            {
+                vRxAdmissionSetPort( FreeRTOS_htons( pxSocket->usLocalPort ), pdFALSE );
+            }
+        #endif
+
         #if ( ipconfigETHERNET_DRIVER_FILTERS_PACKETS == 1 )
         {
             ( void ) xTaskResumeAll();
@@ -2297,15 +2330,33 @@ void * vSocketClose( FreeRTOS_Socket_t * pxSocket )
 
                 if( ( pxOtherSocket->u.xTCP.eTCPState != eTCP_LISTEN ) &&
                     ( pxOtherSocket->usLocalPort == usLocalPort ) &&
-                    ( ( pxOtherSocket->u.xTCP.bits.bPassQueued != pdFALSE_UNSIGNED ) ||
-                      ( pxOtherSocket->u.xTCP.bits.bPassAccept != pdFALSE_UNSIGNED ) ) )
+                    ( pxOtherSocket->u.xTCP.bits.bPassEarly != pdFALSE_UNSIGNED ) &&
+                    ( pxOtherSocket->u.xTCP.bits.bPassAccept == pdFALSE_UNSIGNED ) )
+                {
+                    /* The child was passed early and accepted, it is owned by
+                     * the application. Only forget the parent. */
+                    pxOtherSocket->u.xTCP.pxPeerSocket = NULL;
+                    pxOtherSocket->u.xTCP.bits.bPassQueued = pdFALSE_UNSIGNED;
+                    pxOtherSocket->u.xTCP.bits.bPassEarly = pdFALSE_UNSIGNED;
+                }
+                else if( ( pxOtherSocket->u.xTCP.eTCPState != eTCP_LISTEN ) &&
+                         ( pxOtherSocket->usLocalPort == usLocalPort ) &&
+                         ( ( pxOtherSocket->u.xTCP.bits.bPassQueued != pdFALSE_UNSIGNED ) ||
+                           ( pxOtherSocket->u.xTCP.bits.bPassAccept != pdFALSE_UNSIGNED ) ) )
                 {
                     /* MISRA Ref 17.2.1 [Sockets and limited recursion] */
                     /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-172 */
                     /* coverity[misra_c_2012_rule_17_2_violation] */
                     /* coverity[recursive_step] */
+                    #if ( ipconfigUSE_IP_COUNTERS != 0 )
+                        vTCPCountSocketClose( pxOtherSocket );
+                    #endif
                     ( void ) vSocketClose( pxOtherSocket );
                 }
+                else
+                {
+                    /* Nothing to do. */
+                }
             }
         }
         else
@@ -2630,6 +2681,91 @@ void * vSocketClose( FreeRTOS_Socket_t * pxSocket )
 #endif /* ( ipconfigUSE_TCP != 0 ) */
 /*-----------------------------------------------------------*/
 
+#if ( ipconfigUSE_TCP_NAGLE == 1 )
+
+/**
+ * @brief Handle the socket options FREERTOS_SO_TCP_NODELAY and FREERTOS_SO_TCP_CORK.
+ *        Disabling Nagle's algorithm or removing the cork lets the IP-task
+ *        send the data that was held back.
+ *
+ * @param[in] pxSocket The socket whose options are being set.
+ * @param[in] lOptionName Either FREERTOS_SO_TCP_NODELAY or FREERTOS_SO_TCP_CORK.
+ * @param[in] pvOptionValue Pointer to a BaseType_t, non-zero to set the option.
+ *
+ * @return 0 when the option was set, or -pdFREERTOS_ERRNO_EINVAL for a non-TCP socket.
+ */
+    static BaseType_t prvSetOptionCoalesce( FreeRTOS_Socket_t * pxSocket,
+                                            int32_t lOptionName,
+                                            const void * pvOptionValue )
+    {
+        BaseType_t xReturn = -pdFREERTOS_ERRNO_EINVAL;
+
+        if( pxSocket->ucProtocol == ( uint8_t ) FREERTOS_IPPROTO_TCP )
+        {
+            uint8_t ucValue = ( *( ( const BaseType_t * ) pvOptionValue ) != 0 ) ? pdTRUE_UNSIGNED : pdFALSE_UNSIGNED;
+
+            if( lOptionName == FREERTOS_SO_TCP_NODELAY )
+            {
+                pxSocket->u.xTCP.xTCPWindow.xCoalesce.bNoDelay = ucValue;
+            }
+            else
+            {
+                pxSocket->u.xTCP.xTCPWindow.xCoalesce.bCork = ucValue;
+            }
+
+            if( ( pxSocket->u.xTCP.eTCPState >= eESTABLISHED ) &&
+                ( FreeRTOS_outstanding( pxSocket ) != 0 ) )
+            {
+                /* A partial segment may have been held back, wake-up the
+                 * IP-task to check this. */
+                pxSocket->u.xTCP.usTimeout = 1U;
+                ( void ) xSendEventToIPTask( eTCPTimerEvent );
+            }
+
+            xReturn = 0;
+        }
+
+        return xReturn;
+    }
+#endif /* ( ipconfigUSE_TCP_NAGLE == 1 ) */
+/*-----------------------------------------------------------*/
+
+#if ( ipconfigUSE_TCP_FAST_OPEN == 1 )
+
+/**
+ * @brief Handle the socket option FREERTOS_SO_TCP_FASTOPEN. On a listening
+ *        socket, it allows data in a SYN from clients with a valid cookie.
+ *        On a client socket, it asks the server for a cookie.
+ *
+ * @param[in] pxSocket The socket whose options are being set.
+ * @param[in] pvOptionValue Pointer to a BaseType_t, non-zero to enable TFO.
+ *
+ * @return 0 when the option was set, or -pdFREERTOS_ERRNO_EINVAL for a non-TCP socket.
+ */
+    static BaseType_t prvSetOptionFastOpen( FreeRTOS_Socket_t * pxSocket,
+                                            const void * pvOptionValue )
+    {
+        BaseType_t xReturn = -pdFREERTOS_ERRNO_EINVAL;
+
+        if( pxSocket->ucProtocol == ( uint8_t ) FREERTOS_IPPROTO_TCP )
+        {
+            if( *( ( const BaseType_t * ) pvOptionValue ) != 0 )
+            {
+                pxSocket->u.xTCP.xFastOpen.bEnabled = pdTRUE_UNSIGNED;
+            }
+            else
+            {
+                pxSocket->u.xTCP.xFastOpen.bEnabled = pdFALSE_UNSIGNED;
+            }
+
+            xReturn = 0;
+        }
+
+        return xReturn;
+    }
+#endif /* ( ipconfigUSE_TCP_FAST_OPEN == 1 ) */
+/*-----------------------------------------------------------*/
+
 #if ( ipconfigUSE_TCP != 0 )
 
 /**
@@ -2938,6 +3074,19 @@ BaseType_t FreeRTOS_setsockopt( Socket_t xSocket,
                         break;
                 #endif /* ipconfigUSE_TCP == 1 */
 
+                #if ( ipconfigUSE_TCP_NAGLE == 1 )
+                    case FREERTOS_SO_TCP_NODELAY: /* Send small segments immediately. */
+                    case FREERTOS_SO_TCP_CORK:    /* Only send full-size segments. */
+                        xReturn = prvSetOptionCoalesce( pxSocket, lOptionName, pvOptionValue );
+                        break;
+                #endif /* ipconfigUSE_TCP_NAGLE == 1 */
+
+                #if ( ipconfigUSE_TCP_FAST_OPEN == 1 )
+                    case FREERTOS_SO_TCP_FASTOPEN: /* Use TCP Fast Open. */
+                        xReturn = prvSetOptionFastOpen( pxSocket, pvOptionValue );
+                        break;
+                #endif /* ipconfigUSE_TCP_FAST_OPEN == 1 */
+
             default:
                 /* No other options are handled. */
                 xReturn = -pdFREERTOS_ERRNO_ENOPROTOOPT;
@@ -3868,6 +4017,86 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
 #endif /* ipconfigUSE_TCP */
 /*-----------------------------------------------------------*/
 
+#if ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_FAST_OPEN == 1 )
+
+/**
+ * @brief Connect to a remote port, and queue data that may be sent along with
+ *        the SYN ( TCP Fast Open ). The data is sent in the SYN when a cookie
+ *        of the peer is known, otherwise it is sent as soon as the connection
+ *        is established.
+ *
+ * @param[in] xClientSocket The socket initiating the connection.
+ * @param[in] pxAddress The address of the remote socket.
+ * @param[in] xAddressLength This parameter is not used.
+ * @param[in] pvBuffer The data to be sent.
+ * @param[in] uxDataLength The number of bytes in pvBuffer.
+ *
+ * @return The number of bytes that were queued, which is limited by the size
+ *         of the TX stream, or a negative error code. A non-blocking socket
+ *         also returns the number of bytes queued while it is connecting.
+ */
+    BaseType_t FreeRTOS_connect_data( Socket_t xClientSocket,
+                                      const struct freertos_sockaddr * pxAddress,
+                                      socklen_t xAddressLength,
+                                      const void * pvBuffer,
+                                      size_t uxDataLength )
+    {
+        FreeRTOS_Socket_t * pxSocket = ( FreeRTOS_Socket_t * ) xClientSocket;
+        BaseType_t xResult = 0;
+        size_t uxQueued = 0U;
+
+        if( ( pvBuffer == NULL ) && ( uxDataLength > 0U ) )
+        {
+            xResult = -pdFREERTOS_ERRNO_EINVAL;
+        }
+        else if( prvValidSocket( pxSocket, FREERTOS_IPPROTO_TCP, pdFALSE ) == pdFALSE )
+        {
+            xResult = -pdFREERTOS_ERRNO_EBADF;
+        }
+        else
+        {
+            /* -EINPROGRESS, -EAGAIN, or 0 for OK */
+            xResult = bMayConnect( pxSocket );
+        }
+
+        if( ( xResult == 0 ) && ( uxDataLength > 0U ) )
+        {
+            if( pxSocket->u.xTCP.txStream == NULL )
+            {
+                ( void ) prvTCPCreateStream( pxSocket, pdFALSE );
+            }
+
+            if( pxSocket->u.xTCP.txStream == NULL )
+            {
+                xResult = -pdFREERTOS_ERRNO_ENOMEM;
+            }
+            else
+            {
+                /* The IP-task will not touch the stream before the socket
+                 * starts connecting. */
+                uxQueued = FreeRTOS_min_size_t( uxDataLength, uxStreamBufferGetSpace( pxSocket->u.xTCP.txStream ) );
+                uxQueued = uxStreamBufferAdd( pxSocket->u.xTCP.txStream, 0U, ( const uint8_t * ) pvBuffer, uxQueued );
+            }
+        }
+
+        if( xResult == 0 )
+        {
+            pxSocket->u.xTCP.xFastOpen.bEnabled = pdTRUE_UNSIGNED;
+
+            xResult = FreeRTOS_connect( xClientSocket, pxAddress, xAddressLength );
+
+            if( ( xResult == 0 ) || ( xResult == -pdFREERTOS_ERRNO_EWOULDBLOCK ) )
+            {
+                xResult = ( BaseType_t ) uxQueued;
+            }
+        }
+
+        return xResult;
+    }
+
+#endif /* ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_FAST_OPEN == 1 ) */
+/*-----------------------------------------------------------*/
+
 #if ( ipconfigUSE_TCP == 1 )
 
 /**
@@ -4479,7 +4708,7 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
  * @param[in] pxSocket  The socket owning the connection.
  * @param[in] pvBuffer  The buffer containing the data to be sent.
  * @param[in] uxDataLength  The number of bytes contained in the buffer.
- * @param[in] xFlags  Only the flag 'FREERTOS_MSG_DONTWAIT' will be tested.
+ * @param[in] xFlags  The flags 'FREERTOS_MSG_DONTWAIT' and 'FREERTOS_MSG_MORE' will be tested.
  *
  * @result The number of bytes queued for transmission.
  */
@@ -4499,6 +4728,21 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
         TimeOut_t xTimeOut;
         const uint8_t * pucSource = ( const uint8_t * ) pvBuffer;
 
+        #if ( ipconfigUSE_TCP_NAGLE == 1 )
+        {
+            /* With FREERTOS_MSG_MORE, the last partial segment will wait for
+             * the next call to FreeRTOS_send(). */
+            if( ( ( uint32_t ) xFlags & ( uint32_t ) FREERTOS_MSG_MORE ) != 0U )
+            {
+                pxSocket->u.xTCP.xTCPWindow.xCoalesce.bMore = pdTRUE_UNSIGNED;
+            }
+            else
+            {
+                pxSocket->u.xTCP.xTCPWindow.xCoalesce.bMore = pdFALSE_UNSIGNED;
+            }
+        }
+        #endif /* ipconfigUSE_TCP_NAGLE == 1 */
+
         /* While there are still bytes to be sent. */
         while( xBytesLeft > 0 )
         {
@@ -4638,7 +4882,7 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
  *                      may be NULL in case zero-copy transmissions are used.
  *                      It is used in combination with 'FreeRTOS_get_tx_head()'.
  * @param[in] uxDataLength The length of the data to be added.
- * @param[in] xFlags This parameter is not used. (zero or FREERTOS_MSG_DONTWAIT).
+ * @param[in] xFlags Zero, FREERTOS_MSG_DONTWAIT and/or FREERTOS_MSG_MORE.
  *
  * @return The number of bytes actually sent. Zero when nothing could be sent
  *         or a negative error code in case an error occurred.
@@ -4731,6 +4975,13 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
              * reused as it might have had a previous connection. */
             if( pxSocket->u.xTCP.bits.bReuseSocket != pdFALSE_UNSIGNED )
             {
+                #if ( ipconfigUSE_TCP_NAGLE == 1 )
+                    /* The socket options FREERTOS_SO_TCP_NODELAY and
+                     * FREERTOS_SO_TCP_CORK survive the cleaning of the window. */
+                    uint8_t ucNoDelay = pxSocket->u.xTCP.xTCPWindow.xCoalesce.bNoDelay;
+                    uint8_t ucCork = pxSocket->u.xTCP.xTCPWindow.xCoalesce.bCork;
+                #endif
+
                 if( pxSocket->u.xTCP.rxStream != NULL )
                 {
                     vStreamBufferClear( pxSocket->u.xTCP.rxStream );
@@ -4745,6 +4996,13 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
                 ( void ) memset( &pxSocket->u.xTCP.xTCPWindow, 0, sizeof( pxSocket->u.xTCP.xTCPWindow ) );
                 ( void ) memset( &pxSocket->u.xTCP.bits, 0, sizeof( pxSocket->u.xTCP.bits ) );
 
+                #if ( ipconfigUSE_TCP_NAGLE == 1 )
+                {
+                    pxSocket->u.xTCP.xTCPWindow.xCoalesce.bNoDelay = ucNoDelay;
+                    pxSocket->u.xTCP.xTCPWindow.xCoalesce.bCork = ucCork;
+                }
+                #endif /* ipconfigUSE_TCP_NAGLE == 1 */
+
                 /* Now set the bReuseSocket flag again, because the bits have
                  * just been cleared. */
                 pxSocket->u.xTCP.bits.bReuseSocket = pdTRUE;
@@ -5963,7 +6221,8 @@ BaseType_t FreeRTOS_GetIPType( ConstSocket_t xSocket )
             BaseType_t bAccepted = pdFALSE;
             EventBits_t xSocketBits = 0U;
 
-            if( pxSocket->u.xTCP.bits.bPassQueued == pdFALSE_UNSIGNED )
+            if( ( pxSocket->u.xTCP.bits.bPassQueued == pdFALSE_UNSIGNED ) ||
+                ( pxSocket->u.xTCP.bits.bPassEarly != pdFALSE_UNSIGNED ) )
             {
                 if( pxSocket->u.xTCP.bits.bPassAccept == pdFALSE_UNSIGNED )
                 {
@@ -6228,7 +6487,7 @@ BaseType_t FreeRTOS_GetIPType( ConstSocket_t xSocket )
         xEvent.pvData = pxSocket;
 
         /* The IP-task will call FreeRTOS_SignalSocket for this socket. */
-        xReturn = xQueueSendToBackFromISR( xNetworkEventQueue, &xEvent, pxHigherPriorityTaskWoken );
+        xReturn = xSendEventStructToIPTaskFromISR( &xEvent, pxHigherPriorityTaskWoken );
 
         return xReturn;
     }
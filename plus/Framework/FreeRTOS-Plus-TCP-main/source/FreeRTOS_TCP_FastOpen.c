@@ -0,0 +1,757 @@
+/*
+ * FreeRTOS+TCP <DEVELOPMENT BRANCH>
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file FreeRTOS_TCP_FastOpen.c
+ * @brief TCP Fast Open ( RFC 7413 ), see ipconfigUSE_TCP_FAST_OPEN.
+ *
+ * A server hands out cookies that are a SipHash-2-4 of the peer's IP address,
+ * keyed with a random number. A client keeps the cookies it received in a
+ * small cache, along with the peers that should not be offered TFO.
+ * All functions are called from the IP-task, so no locking is needed.
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_Sockets.h"
+#include "FreeRTOS_IP_Private.h"
+#include "FreeRTOS_Stream_Buffer.h"
+#include "NetworkBufferManagement.h"
+#include "FreeRTOS_TCP_IP.h"
+#include "FreeRTOS_TCP_Transmission.h"
+#include "FreeRTOS_TCP_FastOpen.h"
+
+/* Exclude the entire file if TCP Fast Open is not used. */
+#if ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_FAST_OPEN == 1 )
+
+/** @brief The length of the cookies handed out by this host. */
+    #define tcpTFO_COOKIE_LENGTH        8U
+
+/** @brief The shortest cookie that is valid. */
+    #define tcpTFO_COOKIE_MIN_LENGTH    4U
+
+/** @brief The maximum length of the TCP options. */
+    #define tcpTFO_MAX_OPTIONS_LENGTH   40U
+
+/** @brief The time that a peer will not be offered TFO, after it failed. */
+    #define tcpTFO_FAILED_TIME_MS       ( 5U * 60U * 1000U )
+
+/** @brief Rotate a 64-bit number to the left. */
+    #define tcpTFO_ROTL64( x, b )    ( ( ( x ) << ( b ) ) | ( ( x ) >> ( 64U - ( b ) ) ) )
+
+/** @brief An entry of the client's cookie cache. */
+    typedef struct xTFO_CACHE_ENTRY
+    {
+        IP_Address_t xAddress;                        /**< The IP address of the peer. */
+        TickType_t xLastUsed;                         /**< The last time the entry was used, the oldest entry will be replaced. */
+        TickType_t xFailTime;                         /**< The time of the last failure. */
+        uint8_t ucInUse;                              /**< pdTRUE when the entry is in use. */
+        uint8_t ucIsIPv6;                             /**< pdTRUE when xAddress is an IPv6 address. */
+        uint8_t ucFailed;                             /**< pdTRUE when TFO failed with this peer at xFailTime. */
+        uint8_t ucCookieLength;                       /**< The length of ucCookie, zero when no cookie is known. */
+        uint8_t ucCookie[ tcpTFO_COOKIE_MAX_LENGTH ]; /**< The cookie received from the peer. */
+    } TFOCacheEntry_t;
+
+/** @brief The cookies that a client has received. */
+    static TFOCacheEntry_t xTFOCache[ ipconfigTCP_FAST_OPEN_CACHE_SIZE ];
+
+/** @brief The key used to create the cookies of a server. */
+    static uint64_t ullTFOKey[ 2 ];
+
+/** @brief pdTRUE when ullTFOKey has been filled with random numbers. */
+    static BaseType_t xTFOKeyValid = pdFALSE;
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief One round of SipHash.
+ *
+ * @param[in,out] pullV The four state variables.
+ */
+    static void prvSipRound( uint64_t * pullV )
+    {
+        pullV[ 0 ] += pullV[ 1 ];
+        pullV[ 1 ] = tcpTFO_ROTL64( pullV[ 1 ], 13U );
+        pullV[ 1 ] ^= pullV[ 0 ];
+        pullV[ 0 ] = tcpTFO_ROTL64( pullV[ 0 ], 32U );
+        pullV[ 2 ] += pullV[ 3 ];
+        pullV[ 3 ] = tcpTFO_ROTL64( pullV[ 3 ], 16U );
+        pullV[ 3 ] ^= pullV[ 2 ];
+        pullV[ 0 ] += pullV[ 3 ];
+        pullV[ 3 ] = tcpTFO_ROTL64( pullV[ 3 ], 21U );
+        pullV[ 3 ] ^= pullV[ 0 ];
+        pullV[ 2 ] += pullV[ 1 ];
+        pullV[ 1 ] = tcpTFO_ROTL64( pullV[ 1 ], 17U );
+        pullV[ 1 ] ^= pullV[ 2 ];
+        pullV[ 2 ] = tcpTFO_ROTL64( pullV[ 2 ], 32U );
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Calculate SipHash-2-4 of a short message, using ullTFOKey.
+ *
+ * @param[in] pucData The message.
+ * @param[in] uxLength The length of the message in bytes.
+ *
+ * @return The 64-bit hash.
+ */
+    static uint64_t prvSipHash24( const uint8_t * pucData,
+                                  size_t uxLength )
+    {
+        uint64_t ullV[ 4 ];
+        uint64_t ullWord = 0U;
+        size_t uxIndex;
+        BaseType_t xRound;
+
+        ullV[ 0 ] = ullTFOKey[ 0 ] ^ 0x736f6d6570736575ULL;
+        ullV[ 1 ] = ullTFOKey[ 1 ] ^ 0x646f72616e646f6dULL;
+        ullV[ 2 ] = ullTFOKey[ 0 ] ^ 0x6c7967656e657261ULL;
+        ullV[ 3 ] = ullTFOKey[ 1 ] ^ 0x7465646279746573ULL;
+
+        /* The message is read as little-endian words of 8 bytes. The last
+         * word is padded with zeros, and has the length in its highest byte. */
+        for( uxIndex = 0U; uxIndex <= uxLength; uxIndex++ )
+        {
+            if( uxIndex < uxLength )
+            {
+                ullWord |= ( ( uint64_t ) pucData[ uxIndex ] ) << ( 8U * ( uxIndex & 7U ) );
+            }
+            else
+            {
+                ullWord |= ( ( uint64_t ) uxLength ) << 56;
+            }
+
+            if( ( ( uxIndex & 7U ) == 7U ) || ( uxIndex == uxLength ) )
+            {
+                ullV[ 3 ] ^= ullWord;
+
+                for( xRound = 0; xRound < 2; xRound++ )
+                {
+                    prvSipRound( ullV );
+                }
+
+                ullV[ 0 ] ^= ullWord;
+                ullWord = 0U;
+            }
+        }
+
+        ullV[ 2 ] ^= 0xffU;
+
+        for( xRound = 0; xRound < 4; xRound++ )
+        {
+            prvSipRound( ullV );
+        }
+
+        return ullV[ 0 ] ^ ullV[ 1 ] ^ ullV[ 2 ] ^ ullV[ 3 ];
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Create the cookie for the peer of a socket.
+ *
+ * @param[in] pxSocket The socket that received a SYN.
+ * @param[out] pucCookie Buffer of tcpTFO_COOKIE_LENGTH bytes.
+ *
+ * @return pdTRUE when a cookie was created, pdFALSE when no random key is
+ *         available.
+ */
+    static BaseType_t prvCreateCookie( const FreeRTOS_Socket_t * pxSocket,
+                                       uint8_t * pucCookie )
+    {
+        uint32_t ulRandom[ 4 ];
+        uint64_t ullHash;
+        BaseType_t xIndex;
+        BaseType_t xReturn = pdTRUE;
+
+        if( xTFOKeyValid == pdFALSE )
+        {
+            for( xIndex = 0; xIndex < 4; xIndex++ )
+            {
+                if( xApplicationGetRandomNumber( &( ulRandom[ xIndex ] ) ) == pdFALSE )
+                {
+                    xReturn = pdFALSE;
+                    break;
+                }
+            }
+
+            if( xReturn != pdFALSE )
+            {
+                ullTFOKey[ 0 ] = ( ( ( uint64_t ) ulRandom[ 0 ] ) << 32 ) | ( uint64_t ) ulRandom[ 1 ];
+                ullTFOKey[ 1 ] = ( ( ( uint64_t ) ulRandom[ 2 ] ) << 32 ) | ( uint64_t ) ulRandom[ 3 ];
+                xTFOKeyValid = pdTRUE;
+            }
+        }
+
+        if( xReturn != pdFALSE )
+        {
+            if( pxSocket->bits.bIsIPv6 != pdFALSE_UNSIGNED )
+            {
+                ullHash = prvSipHash24( pxSocket->u.xTCP.xRemoteIP.xIP_IPv6.ucBytes, ipSIZE_OF_IPv6_ADDRESS );
+            }
+            else
+            {
+                ullHash = prvSipHash24( ( const uint8_t * ) &( pxSocket->u.xTCP.xRemoteIP.ulIP_IPv4 ), sizeof( uint32_t ) );
+            }
+
+            for( xIndex = 0; xIndex < ( BaseType_t ) tcpTFO_COOKIE_LENGTH; xIndex++ )
+            {
+                pucCookie[ xIndex ] = ( uint8_t ) ( ullHash >> ( 8U * ( uint32_t ) xIndex ) );
+            }
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Find the cache entry of the peer of a connecting socket.
+ *
+ * @param[in] pxSocket The connecting socket.
+ * @param[in] xCreate pdTRUE to create the entry when it doesn't exist. The
+ *                    entry that was used least recently will be replaced.
+ *
+ * @return The entry found or created, or NULL.
+ */
+    static TFOCacheEntry_t * prvCacheLookup( const FreeRTOS_Socket_t * pxSocket,
+                                             BaseType_t xCreate )
+    {
+        TFOCacheEntry_t * pxReturn = NULL;
+        TFOCacheEntry_t * pxOldest = &( xTFOCache[ 0 ] );
+        TickType_t xNow = xTaskGetTickCount();
+        uint8_t ucIsIPv6 = ( pxSocket->bits.bIsIPv6 != pdFALSE_UNSIGNED ) ? pdTRUE_UNSIGNED : pdFALSE_UNSIGNED;
+        size_t uxIndex;
+
+        for( uxIndex = 0U; uxIndex < ( size_t ) ipconfigTCP_FAST_OPEN_CACHE_SIZE; uxIndex++ )
+        {
+            TFOCacheEntry_t * pxEntry = &( xTFOCache[ uxIndex ] );
+
+            if( pxEntry->ucInUse == pdFALSE_UNSIGNED )
+            {
+                /* A free entry is always preferred for replacement. */
+                if( pxOldest->ucInUse != pdFALSE_UNSIGNED )
+                {
+                    pxOldest = pxEntry;
+                }
+
+                continue;
+            }
+
+            if( pxEntry->ucIsIPv6 == ucIsIPv6 )
+            {
+                if( ucIsIPv6 != pdFALSE_UNSIGNED )
+                {
+                    if( memcmp( pxEntry->xAddress.xIP_IPv6.ucBytes, pxSocket->u.xTCP.xRemoteIP.xIP_IPv6.ucBytes, ipSIZE_OF_IPv6_ADDRESS ) == 0 )
+                    {
+                        pxReturn = pxEntry;
+                        break;
+                    }
+                }
+                else if( pxEntry->xAddress.ulIP_IPv4 == pxSocket->u.xTCP.xRemoteIP.ulIP_IPv4 )
+                {
+                    pxReturn = pxEntry;
+                    break;
+                }
+                else
+                {
+                    /* Another peer. */
+                }
+            }
+
+            if( ( pxOldest->ucInUse != pdFALSE_UNSIGNED ) &&
+                ( ( xNow - pxEntry->xLastUsed ) > ( xNow - pxOldest->xLastUsed ) ) )
+            {
+                pxOldest = pxEntry;
+            }
+        }
+
+        if( ( pxReturn == NULL ) && ( xCreate != pdFALSE ) )
+        {
+            pxReturn = pxOldest;
+            ( void ) memset( pxReturn, 0, sizeof( *pxReturn ) );
+            ( void ) memcpy( &( pxReturn->xAddress ), &( pxSocket->u.xTCP.xRemoteIP ), sizeof( pxReturn->xAddress ) );
+            pxReturn->ucIsIPv6 = ucIsIPv6;
+            pxReturn->ucInUse = pdTRUE_UNSIGNED;
+        }
+
+        if( pxReturn != NULL )
+        {
+            pxReturn->xLastUsed = xNow;
+
+            if( ( pxReturn->ucFailed != pdFALSE_UNSIGNED ) &&
+                ( ( xNow - pxReturn->xFailTime ) >= pdMS_TO_TICKS( tcpTFO_FAILED_TIME_MS ) ) )
+            {
+                /* Give the peer another chance. */
+                pxReturn->ucFailed = pdFALSE_UNSIGNED;
+            }
+        }
+
+        return pxReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Remember that TFO failed with the peer of a connecting socket. The
+ *        cookie is forgotten, and the peer will not be offered TFO for
+ *        tcpTFO_FAILED_TIME_MS.
+ *
+ * @param[in] pxSocket The connecting socket.
+ */
+    static void prvCacheFailed( const FreeRTOS_Socket_t * pxSocket )
+    {
+        TFOCacheEntry_t * pxEntry = prvCacheLookup( pxSocket, pdTRUE );
+
+        pxEntry->ucFailed = pdTRUE_UNSIGNED;
+        pxEntry->xFailTime = pxEntry->xLastUsed;
+        pxEntry->ucCookieLength = 0U;
+
+        FreeRTOS_debug_printf( ( "TFO: not using fast open with port %u for a while\n", pxSocket->u.xTCP.usRemotePort ) );
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Write a TFO option, preceded by NOP's so that the length of the
+ *        options remains a multiple of 4 bytes.
+ *
+ * @param[in] pucOptions The start of the TCP options.
+ * @param[in] uxOptionsLength The length of the options written so far.
+ * @param[in] pucCookie The cookie, or NULL for a cookie request.
+ * @param[in] ucCookieLength The length of the cookie.
+ *
+ * @return The new length of the options.
+ */
+    static UBaseType_t prvWriteOption( uint8_t * pucOptions,
+                                       UBaseType_t uxOptionsLength,
+                                       const uint8_t * pucCookie,
+                                       uint8_t ucCookieLength )
+    {
+        UBaseType_t uxLength = uxOptionsLength;
+        UBaseType_t uxOptionLength = 2U + ( UBaseType_t ) ucCookieLength;
+
+        while( ( ( uxLength + uxOptionLength ) & 3U ) != 0U )
+        {
+            pucOptions[ uxLength ] = tcpTCP_OPT_NOOP;
+            uxLength++;
+        }
+
+        pucOptions[ uxLength ] = ( uint8_t ) tcpTCP_OPT_FASTOPEN;
+        pucOptions[ uxLength + 1U ] = ( uint8_t ) uxOptionLength;
+
+        if( ucCookieLength != 0U )
+        {
+            ( void ) memcpy( &( pucOptions[ uxLength + 2U ] ), pucCookie, ucCookieLength );
+        }
+
+        return uxLength + uxOptionLength;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief A child socket has accepted data from a SYN: let FreeRTOS_accept()
+ *        return it now, and not wait for the handshake to complete. bPassQueued
+ *        and the reference to the parent are kept, vTCPStateChange() clears them
+ *        and calls the OnConnect handler of the parent when the connection is
+ *        established.
+ *
+ * @param[in] pxSocket The child socket.
+ */
+    static void prvPassToAccept( FreeRTOS_Socket_t * pxSocket )
+    {
+        FreeRTOS_Socket_t * pxParent = pxSocket;
+
+        /* When bPassQueued is false, the socket is passable already. */
+        if( ( pxSocket->u.xTCP.bits.bPassQueued != pdFALSE_UNSIGNED ) &&
+            ( pxSocket->u.xTCP.bits.bPassEarly == pdFALSE_UNSIGNED ) )
+        {
+            if( pxSocket->u.xTCP.bits.bReuseSocket == pdFALSE_UNSIGNED )
+            {
+                pxParent = pxSocket->u.xTCP.pxPeerSocket;
+            }
+
+            if( pxParent != NULL )
+            {
+                if( pxParent->u.xTCP.pxPeerSocket == NULL )
+                {
+                    pxParent->u.xTCP.pxPeerSocket = pxSocket;
+                }
+
+                pxParent->xEventBits |= ( EventBits_t ) eSOCKET_ACCEPT;
+
+                #if ( ipconfigSUPPORT_SELECT_FUNCTION == 1 )
+                {
+                    if( ( pxParent->xSelectBits & ( ( EventBits_t ) eSELECT_READ ) ) != 0U )
+                    {
+                        pxParent->xEventBits |= ( ( EventBits_t ) eSELECT_READ ) << SOCKET_EVENT_BIT_COUNT;
+                    }
+                }
+                #endif
+
+                vSocketWakeUpUser( pxParent );
+            }
+
+            pxSocket->u.xTCP.bits.bPassEarly = pdTRUE_UNSIGNED;
+            pxSocket->u.xTCP.bits.bPassAccept = pdTRUE_UNSIGNED;
+        }
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Remember the TFO option found in a SYN or a SYN+ACK.
+ *
+ * @param[in] pxSocket The socket that received the option.
+ * @param[in] pucPtr Pointer to the option type byte.
+ * @param[in] ucLength The length of the option, it has been checked against the
+ *                     length of the options already.
+ */
+    void vTCPFastOpenReadOption( FreeRTOS_Socket_t * pxSocket,
+                                 const uint8_t * pucPtr,
+                                 uint8_t ucLength )
+    {
+        TCPFastOpen_t * pxFastOpen = &( pxSocket->u.xTCP.xFastOpen );
+        uint8_t ucCookieLength = ( uint8_t ) ( ucLength - 2U );
+
+        pxFastOpen->bOptionSeen = pdTRUE_UNSIGNED;
+
+        if( ( ucCookieLength >= tcpTFO_COOKIE_MIN_LENGTH ) && ( ucCookieLength <= tcpTFO_COOKIE_MAX_LENGTH ) )
+        {
+            ( void ) memcpy( pxFastOpen->ucCookie, &( pucPtr[ 2 ] ), ucCookieLength );
+            pxFastOpen->ucCookieLength = ucCookieLength;
+        }
+        else
+        {
+            /* A cookie request, or a cookie with an invalid length that will be
+             * treated as a request. */
+            pxFastOpen->ucCookieLength = 0U;
+        }
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Server side: check the TFO option of a SYN that has been received.
+ *        The data of a SYN with a valid cookie is stored in the RX stream, and
+ *        the socket can be accepted immediately. Otherwise the data is ignored,
+ *        and a new cookie is added to the SYN+ACK.
+ *
+ * @param[in] pxSocket The child socket in state eSYN_FIRST.
+ * @param[in,out] ppxNetworkBuffer The SYN, which will be turned into the SYN+ACK.
+ *                                 It might be replaced with a bigger buffer.
+ * @param[in] pucRecvData The data carried by the SYN.
+ * @param[in] ulReceiveLength The number of bytes in pucRecvData.
+ * @param[in] uxOptionsLength The length of the options in the SYN+ACK so far.
+ *
+ * @return The length of the options in the SYN+ACK.
+ */
+    UBaseType_t uxTCPFastOpenHandleSyn( FreeRTOS_Socket_t * pxSocket,
+                                        NetworkBufferDescriptor_t ** ppxNetworkBuffer,
+                                        const uint8_t * pucRecvData,
+                                        uint32_t ulReceiveLength,
+                                        UBaseType_t uxOptionsLength )
+    {
+        TCPFastOpen_t * pxFastOpen = &( pxSocket->u.xTCP.xFastOpen );
+        UBaseType_t uxReturn = uxOptionsLength;
+        uint8_t ucCookie[ tcpTFO_COOKIE_LENGTH ];
+        uint8_t ucDifference = 0U;
+        NetworkBufferDescriptor_t * pxNewBuffer;
+        ProtocolHeaders_t * pxProtocolHeaders;
+        size_t uxIndex;
+        int32_t lStored;
+
+        if( ( pxFastOpen->bEnabled != pdFALSE_UNSIGNED ) &&
+            ( pxFastOpen->bOptionSeen != pdFALSE_UNSIGNED ) &&
+            ( prvCreateCookie( pxSocket, ucCookie ) != pdFALSE ) )
+        {
+            if( pxFastOpen->ucCookieLength == tcpTFO_COOKIE_LENGTH )
+            {
+                for( uxIndex = 0U; uxIndex < tcpTFO_COOKIE_LENGTH; uxIndex++ )
+                {
+                    ucDifference |= ( uint8_t ) ( ucCookie[ uxIndex ] ^ pxFastOpen->ucCookie[ uxIndex ] );
+                }
+            }
+
+            if( ( pxFastOpen->ucCookieLength == tcpTFO_COOKIE_LENGTH ) && ( ucDifference == 0U ) )
+            {
+                /* A valid cookie. When the SYN is a repetition, its data has
+                 * been stored already. */
+                if( ( ulReceiveLength > 0U ) && ( pxFastOpen->usSynDataLength == 0U ) )
+                {
+                    lStored = lTCPAddRxdata( pxSocket, 0U, pucRecvData, ulReceiveLength );
+
+                    if( lStored > 0 )
+                    {
+                        /* The caller will acknowledge these bytes in the SYN+ACK. */
+                        pxFastOpen->usSynDataLength = ( uint16_t ) lStored;
+                        prvPassToAccept( pxSocket );
+                    }
+                }
+            }
+            else
+            {
+                /* A cookie request or an invalid cookie: hand out a new cookie.
+                 * The received SYN might be too small to hold the extra option. */
+                pxNewBuffer = prvTCPBufferResize( pxSocket, *ppxNetworkBuffer, 0, uxOptionsLength + 2U + tcpTFO_COOKIE_LENGTH + 3U );
+
+                if( pxNewBuffer != NULL )
+                {
+                    *ppxNetworkBuffer = pxNewBuffer;
+
+                    /* MISRA Ref 11.3.1 [Misaligned access] */
+                    /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+                    /* coverity[misra_c_2012_rule_11_3_violation] */
+                    pxProtocolHeaders = ( ( ProtocolHeaders_t * )
+                                          &( pxNewBuffer->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER + uxIPHeaderSizeSocket( pxSocket ) ] ) );
+                    uxReturn = prvWriteOption( pxProtocolHeaders->xTCPHeader.ucOptdata, uxOptionsLength, ucCookie, ( uint8_t ) tcpTFO_COOKIE_LENGTH );
+                }
+            }
+        }
+
+        pxFastOpen->bOptionSeen = pdFALSE_UNSIGNED;
+
+        return uxReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Client side: when a cookie is known for the peer, and data has been
+ *        queued with FreeRTOS_connect_data(), the first SYN will carry data.
+ *        Such a SYN is built in a network buffer.
+ *
+ * @param[in] pxSocket The connecting socket.
+ *
+ * @return A network buffer that holds a copy of the headers in 'xPacket', or
+ *         NULL when the SYN will not carry data.
+ */
+    NetworkBufferDescriptor_t * pxTCPFastOpenGetSynBuffer( FreeRTOS_Socket_t * pxSocket )
+    {
+        TCPFastOpen_t * pxFastOpen = &( pxSocket->u.xTCP.xFastOpen );
+        NetworkBufferDescriptor_t * pxNetworkBuffer = NULL;
+        const TFOCacheEntry_t * pxEntry;
+        size_t uxLength;
+        size_t uxMaxLength;
+
+        pxFastOpen->usSynDataLength = 0U;
+
+        if( ( pxFastOpen->bEnabled != pdFALSE_UNSIGNED ) &&
+            ( pxSocket->u.xTCP.ucRepCount == 0U ) &&
+            ( pxSocket->u.xTCP.txStream != NULL ) )
+        {
+            pxEntry = prvCacheLookup( pxSocket, pdFALSE );
+
+            if( ( pxEntry != NULL ) && ( pxEntry->ucFailed == pdFALSE_UNSIGNED ) && ( pxEntry->ucCookieLength != 0U ) )
+            {
+                /* The MSS of the peer is not known yet, use the minimum. */
+                uxMaxLength = ( size_t ) FreeRTOS_min_uint32( ( uint32_t ) pxSocket->u.xTCP.usMSS, tcpMINIMUM_SEGMENT_LENGTH );
+                uxLength = FreeRTOS_min_size_t( uxStreamBufferGetSize( pxSocket->u.xTCP.txStream ), uxMaxLength );
+
+                if( uxLength > 0U )
+                {
+                    pxNetworkBuffer = prvTCPBufferResize( pxSocket, NULL, ( int32_t ) uxLength, tcpTFO_MAX_OPTIONS_LENGTH );
+
+                    if( pxNetworkBuffer != NULL )
+                    {
+                        pxFastOpen->usSynDataLength = ( uint16_t ) uxLength;
+                    }
+                }
+            }
+        }
+
+        return pxNetworkBuffer;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Client side: add the TFO option and the data to a SYN. The first SYN
+ *        asks for a cookie, or carries the cookie and data. When a SYN with the
+ *        option must be repeated, the option might be the reason that it got
+ *        lost: the repetitions are sent without it.
+ *
+ * @param[in] pxSocket The connecting socket.
+ * @param[in] pxTCPHeader The TCP header of the SYN. When data is sent, it is
+ *                        stored in a buffer from pxTCPFastOpenGetSynBuffer().
+ * @param[in] uxOptionsLength The length of the options in the SYN so far.
+ *
+ * @return The length of the options in the SYN.
+ */
+    UBaseType_t uxTCPFastOpenSynOptions( FreeRTOS_Socket_t * pxSocket,
+                                         TCPHeader_t * pxTCPHeader,
+                                         UBaseType_t uxOptionsLength )
+    {
+        TCPFastOpen_t * pxFastOpen = &( pxSocket->u.xTCP.xFastOpen );
+        uint8_t * pucOptions = pxTCPHeader->ucOptdata;
+        UBaseType_t uxReturn = uxOptionsLength;
+        const TFOCacheEntry_t * pxEntry;
+
+        if( pxFastOpen->bEnabled != pdFALSE_UNSIGNED )
+        {
+            if( pxSocket->u.xTCP.ucRepCount == 0U )
+            {
+                pxEntry = prvCacheLookup( pxSocket, pdFALSE );
+
+                if( pxFastOpen->usSynDataLength != 0U )
+                {
+                    /* pxTCPFastOpenGetSynBuffer() has checked the cookie. */
+                    uxReturn = prvWriteOption( pucOptions, uxOptionsLength, pxEntry->ucCookie, pxEntry->ucCookieLength );
+                    ( void ) uxStreamBufferGet( pxSocket->u.xTCP.txStream, 0U, &( pucOptions[ uxReturn ] ), pxFastOpen->usSynDataLength, pdTRUE );
+                    pxFastOpen->bOptionSent = pdTRUE_UNSIGNED;
+                }
+                else if( ( pxEntry == NULL ) || ( pxEntry->ucFailed == pdFALSE_UNSIGNED ) )
+                {
+                    /* Ask for a new cookie. This option fits in 'xPacket'. */
+                    uxReturn = prvWriteOption( pucOptions, uxOptionsLength, NULL, 0U );
+                    pxFastOpen->bOptionSent = pdTRUE_UNSIGNED;
+                }
+                else
+                {
+                    /* TFO failed with this peer recently. */
+                    pxFastOpen->bOptionSent = pdFALSE_UNSIGNED;
+                }
+            }
+            else if( pxFastOpen->bOptionSent != pdFALSE_UNSIGNED )
+            {
+                prvCacheFailed( pxSocket );
+                pxFastOpen->bOptionSent = pdFALSE_UNSIGNED;
+            }
+            else
+            {
+                /* The repetition of a SYN without TFO. */
+            }
+
+            pxFastOpen->bOptionSeen = pdFALSE_UNSIGNED;
+        }
+
+        return uxReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Client side: a SYN+ACK has been received. Update the cache, and
+ *        release the data that the peer acknowledged along with the SYN. Data
+ *        that was not acknowledged will be sent normally.
+ *
+ * @param[in] pxSocket The connecting socket. Its sliding window has just been
+ *                     initialised.
+ * @param[in] ulAckNumber The acknowledgement number of the SYN+ACK.
+ */
+    void vTCPFastOpenSynAckReceived( FreeRTOS_Socket_t * pxSocket,
+                                     uint32_t ulAckNumber )
+    {
+        TCPFastOpen_t * pxFastOpen = &( pxSocket->u.xTCP.xFastOpen );
+        TCPWindow_t * pxTCPWindow = &( pxSocket->u.xTCP.xTCPWindow );
+        TFOCacheEntry_t * pxEntry;
+        uint32_t ulAcked = 0U;
+
+        if( pxFastOpen->bEnabled != pdFALSE_UNSIGNED )
+        {
+            if( pxFastOpen->usSynDataLength != 0U )
+            {
+                ulAcked = ulAckNumber - ( pxTCPWindow->tx.ulFirstSequenceNumber + 1U );
+
+                if( ( ulAcked > 0U ) && ( ulAcked <= ( uint32_t ) pxFastOpen->usSynDataLength ) )
+                {
+                    /* The bytes were never passed to the sliding window. Skip
+                     * them in the stream, and in the sequence numbers. */
+                    vStreamBufferMoveMid( pxSocket->u.xTCP.txStream, ( size_t ) ulAcked );
+                    ( void ) uxStreamBufferGet( pxSocket->u.xTCP.txStream, 0U, NULL, ( size_t ) ulAcked, pdFALSE );
+                    pxTCPWindow->tx.ulCurrentSequenceNumber += ulAcked;
+                    pxTCPWindow->ulNextTxSequenceNumber += ulAcked;
+                    pxTCPWindow->ulOurSequenceNumber += ulAcked;
+
+                    pxSocket->xEventBits |= ( EventBits_t ) eSOCKET_SEND;
+
+                    #if ( ipconfigSUPPORT_SELECT_FUNCTION == 1 )
+                    {
+                        if( ( pxSocket->xSelectBits & ( EventBits_t ) eSELECT_WRITE ) != 0U )
+                        {
+                            pxSocket->xEventBits |= ( ( EventBits_t ) eSELECT_WRITE ) << SOCKET_EVENT_BIT_COUNT;
+                        }
+                    }
+                    #endif
+
+                    #if ( ipconfigUSE_CALLBACKS == 1 )
+                    {
+                        if( ipconfigIS_VALID_PROG_ADDRESS( pxSocket->u.xTCP.pxHandleSent ) )
+                        {
+                            pxSocket->u.xTCP.pxHandleSent( pxSocket, ulAcked );
+                        }
+                    }
+                    #endif /* ipconfigUSE_CALLBACKS */
+                }
+                else
+                {
+                    FreeRTOS_debug_printf( ( "TFO: the data in the SYN was not accepted by port %u\n", pxSocket->u.xTCP.usRemotePort ) );
+                    ulAcked = 0U;
+                }
+
+                pxFastOpen->usSynDataLength = 0U;
+            }
+
+            if( pxFastOpen->bOptionSent != pdFALSE_UNSIGNED )
+            {
+                if( pxFastOpen->bOptionSeen != pdFALSE_UNSIGNED )
+                {
+                    if( pxFastOpen->ucCookieLength != 0U )
+                    {
+                        /* A new cookie. */
+                        pxEntry = prvCacheLookup( pxSocket, pdTRUE );
+                        ( void ) memcpy( pxEntry->ucCookie, pxFastOpen->ucCookie, pxFastOpen->ucCookieLength );
+                        pxEntry->ucCookieLength = pxFastOpen->ucCookieLength;
+                        pxEntry->ucFailed = pdFALSE_UNSIGNED;
+                    }
+                }
+                else if( ulAcked == 0U )
+                {
+                    /* The peer does not do TFO, or the option was stripped on
+                     * the way. A server that accepted the data does not need
+                     * to repeat the option. */
+                    prvCacheFailed( pxSocket );
+                }
+                else
+                {
+                    /* The cookie has been accepted. */
+                }
+            }
+
+            pxFastOpen->bOptionSent = pdFALSE_UNSIGNED;
+            pxFastOpen->bOptionSeen = pdFALSE_UNSIGNED;
+
+            /* The remaining data will be sent as soon as the connection is
+             * established. */
+            if( pxSocket->u.xTCP.txStream != NULL )
+            {
+                prvTCPAddTxData( pxSocket );
+            }
+        }
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_FAST_OPEN == 1 ) */
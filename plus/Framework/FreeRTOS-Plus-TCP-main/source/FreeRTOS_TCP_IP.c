@@ -95,6 +95,15 @@
         const char * prvTCPFlagMeaning( UBaseType_t xFlags );
     #endif /* ipconfigHAS_DEBUG_PRINTF != 0 */
 
+    #if ( ipconfigUSE_IP_COUNTERS != 0 )
+
+/*
+ * Update the TCP-MIB counters for a change of state.
+ */
+        static void prvTCPCountStateChange( eIPTCPState_t xPreviousState,
+                                            eIPTCPState_t xNewState );
+    #endif
+
 
 /*-----------------------------------------------------------*/
 
@@ -108,6 +117,9 @@
     {
         if( ( xSocketToClose != NULL ) && ( xSocketToClose != pxSocket ) )
         {
+            #if ( ipconfigUSE_IP_COUNTERS != 0 )
+                vTCPCountSocketClose( xSocketToClose );
+            #endif
             ( void ) vSocketClose( xSocketToClose );
         }
 
@@ -272,6 +284,83 @@
     }
     /*-----------------------------------------------------------*/
 
+    #if ( ipconfigUSE_IP_COUNTERS != 0 )
+
+/**
+ * @brief Update the TCP-MIB counters for a change of state. The states of
+ *        FreeRTOS+TCP are mapped onto those of RFC 793: eCONNECT_SYN is
+ *        SYN-SENT, eSYN_FIRST and eSYN_RECEIVED are SYN-RCVD, and both eCLOSED
+ *        and eCLOSE_WAIT mean that the connection is gone.
+ *
+ * @param[in] xPreviousState The current state of the socket.
+ * @param[in] xNewState The state that the socket is moving to.
+ */
+        static void prvTCPCountStateChange( eIPTCPState_t xPreviousState,
+                                            eIPTCPState_t xNewState )
+        {
+            BaseType_t xWasOpening = ( ( xPreviousState == eCONNECT_SYN ) ||
+                                       ( xPreviousState == eSYN_FIRST ) ||
+                                       ( xPreviousState == eSYN_RECEIVED ) ) ? pdTRUE : pdFALSE;
+            BaseType_t xIsGone = ( ( xNewState == eCLOSED ) || ( xNewState == eCLOSE_WAIT ) ) ? pdTRUE : pdFALSE;
+
+            if( xPreviousState != xNewState )
+            {
+                if( xNewState == eCONNECT_SYN )
+                {
+                    ipCOUNT( ulTcpActiveOpens );
+                }
+                else if( ( xNewState == eSYN_FIRST ) && ( xPreviousState != eSYN_RECEIVED ) )
+                {
+                    /* A new child socket, or a reusable socket that leaves eTCP_LISTEN. */
+                    ipCOUNT( ulTcpPassiveOpens );
+                }
+                else if( ( xWasOpening == pdTRUE ) && ( ( xIsGone == pdTRUE ) || ( xNewState == eTCP_LISTEN ) ) )
+                {
+                    ipCOUNT( ulTcpAttemptFails );
+                }
+                else if( ( xPreviousState == eESTABLISHED ) && ( xIsGone == pdTRUE ) )
+                {
+                    ipCOUNT( ulTcpEstabResets );
+                }
+                else
+                {
+                    /* Not counted. */
+                }
+
+                if( xNewState == eESTABLISHED )
+                {
+                    ipCOUNT( ulTcpCurrEstab );
+                }
+                else if( xPreviousState == eESTABLISHED )
+                {
+                    ipUNCOUNT( ulTcpCurrEstab );
+                }
+                else
+                {
+                    /* The gauge does not change. */
+                }
+            }
+        }
+        /*-----------------------------------------------------------*/
+
+/**
+ * @brief Called by the IP-task just before it closes a TCP socket: a connection
+ *        that disappears without a state change leaves the gauge ulTcpCurrEstab.
+ *
+ * @param[in] pxSocket The socket that is about to be closed.
+ */
+        void vTCPCountSocketClose( const FreeRTOS_Socket_t * pxSocket )
+        {
+            if( ( pxSocket->ucProtocol == ( uint8_t ) FREERTOS_IPPROTO_TCP ) &&
+                ( pxSocket->u.xTCP.eTCPState == eESTABLISHED ) )
+            {
+                ipUNCOUNT( ulTcpCurrEstab );
+            }
+        }
+        /*-----------------------------------------------------------*/
+
+    #endif /* ipconfigUSE_IP_COUNTERS != 0 */
+
 /**
  * @brief Changing to a new state. Centralised here to do specific actions such as
  *        resetting the alive timer, calling the user's OnConnect handler to notify
@@ -294,6 +383,10 @@
             FreeRTOS_Socket_t * xConnected = NULL;
         #endif
 
+        #if ( ipconfigUSE_IP_COUNTERS != 0 )
+            prvTCPCountStateChange( xPreviousState, eTCPState );
+        #endif
+
         if( ( ( xPreviousState == eCONNECT_SYN ) ||
               ( xPreviousState == eSYN_FIRST ) ||
               ( xPreviousState == eSYN_RECEIVED ) ) &&
@@ -316,8 +409,11 @@
         /* Has the connected status changed? */
         if( bBefore != bAfter )
         {
-            /* if bPassQueued is true, this socket is an orphan until it gets connected. */
-            if( pxSocket->u.xTCP.bits.bPassQueued != pdFALSE_UNSIGNED )
+            /* if bPassQueued is true, this socket is an orphan until it gets connected.
+             * A socket that was passed early has an owner, who must learn that it
+             * failed to connect. */
+            if( ( pxSocket->u.xTCP.bits.bPassQueued != pdFALSE_UNSIGNED ) &&
+                ( ( bAfter != pdFALSE ) || ( pxSocket->u.xTCP.bits.bPassEarly == pdFALSE_UNSIGNED ) ) )
             {
                 /* Find it's parent if the reuse bit is not set. */
                 if( pxSocket->u.xTCP.bits.bReuseSocket == pdFALSE_UNSIGNED )
@@ -338,25 +434,29 @@
                         /* The child socket has got connected.  See if the parent
                          * ( the listening socket ) should be signalled, or if a
                          * call-back must be made, in which case 'xConnected' will
-                         * be set to the parent socket. */
+                         * be set to the parent socket.  A socket that was passed
+                         * early has been signalled to the parent already. */
 
-                        if( xParent->u.xTCP.pxPeerSocket == NULL )
+                        if( pxSocket->u.xTCP.bits.bPassEarly == pdFALSE_UNSIGNED )
                         {
-                            xParent->u.xTCP.pxPeerSocket = pxSocket;
-                        }
+                            if( xParent->u.xTCP.pxPeerSocket == NULL )
+                            {
+                                xParent->u.xTCP.pxPeerSocket = pxSocket;
+                            }
 
-                        xParent->xEventBits |= ( EventBits_t ) eSOCKET_ACCEPT;
+                            xParent->xEventBits |= ( EventBits_t ) eSOCKET_ACCEPT;
 
-                        #if ( ipconfigSUPPORT_SELECT_FUNCTION == 1 )
-                        {
-                            /* Library support FreeRTOS_select().  Receiving a new
-                             * connection is being translated as a READ event. */
-                            if( ( xParent->xSelectBits & ( ( EventBits_t ) eSELECT_READ ) ) != 0U )
+                            #if ( ipconfigSUPPORT_SELECT_FUNCTION == 1 )
                             {
-                                xParent->xEventBits |= ( ( EventBits_t ) eSELECT_READ ) << SOCKET_EVENT_BIT_COUNT;
+                                /* Library support FreeRTOS_select().  Receiving a new
+                                 * connection is being translated as a READ event. */
+                                if( ( xParent->xSelectBits & ( ( EventBits_t ) eSELECT_READ ) ) != 0U )
+                                {
+                                    xParent->xEventBits |= ( ( EventBits_t ) eSELECT_READ ) << SOCKET_EVENT_BIT_COUNT;
+                                }
                             }
+                            #endif
                         }
-                        #endif
 
                         #if ( ipconfigUSE_CALLBACKS == 1 )
                         {
@@ -372,13 +472,18 @@
                         #endif
                     }
 
+                    /* When true, this socket may be returned in a call to accept().
+                     * A socket that was passed early may have been accepted already. */
+                    if( pxSocket->u.xTCP.bits.bPassEarly == pdFALSE_UNSIGNED )
+                    {
+                        pxSocket->u.xTCP.bits.bPassAccept = pdTRUE_UNSIGNED;
+                    }
+
                     /* Don't need to access the parent socket anymore, so the
                      * reference 'pxPeerSocket' may be cleared. */
                     pxSocket->u.xTCP.pxPeerSocket = NULL;
                     pxSocket->u.xTCP.bits.bPassQueued = pdFALSE_UNSIGNED;
-
-                    /* When true, this socket may be returned in a call to accept(). */
-                    pxSocket->u.xTCP.bits.bPassAccept = pdTRUE_UNSIGNED;
+                    pxSocket->u.xTCP.bits.bPassEarly = pdFALSE_UNSIGNED;
                 }
                 else
                 {
@@ -442,13 +547,15 @@
              * When nobody owns the socket yet, delete it. */
             vTaskSuspendAll();
             {
-                if( ( pxSocket->u.xTCP.bits.bPassQueued != pdFALSE_UNSIGNED ) ||
+                if( ( ( pxSocket->u.xTCP.bits.bPassQueued != pdFALSE_UNSIGNED ) &&
+                      ( pxSocket->u.xTCP.bits.bPassEarly == pdFALSE_UNSIGNED ) ) ||
                     ( pxSocket->u.xTCP.bits.bPassAccept != pdFALSE_UNSIGNED ) )
                 {
                     if( pxSocket->u.xTCP.bits.bReuseSocket == pdFALSE_UNSIGNED )
                     {
                         pxSocket->u.xTCP.bits.bPassQueued = pdFALSE_UNSIGNED;
                         pxSocket->u.xTCP.bits.bPassAccept = pdFALSE_UNSIGNED;
+                        pxSocket->u.xTCP.bits.bPassEarly = pdFALSE_UNSIGNED;
                     }
 
                     ( void ) xTaskResumeAll();
@@ -463,6 +570,15 @@
                 }
                 else
                 {
+                    if( pxSocket->u.xTCP.bits.bPassEarly != pdFALSE_UNSIGNED )
+                    {
+                        /* The socket was passed early and accepted, it will never
+                         * get connected: detach it from the listening socket. */
+                        pxSocket->u.xTCP.pxPeerSocket = NULL;
+                        pxSocket->u.xTCP.bits.bPassQueued = pdFALSE_UNSIGNED;
+                        pxSocket->u.xTCP.bits.bPassEarly = pdFALSE_UNSIGNED;
+                    }
+
                     ( void ) xTaskResumeAll();
                 }
             }
@@ -656,6 +772,8 @@
 
         BaseType_t xResult;
 
+        ipCOUNT( ulTcpInSegs );
+
         /* MISRA Ref 11.3.1 [Misaligned access] */
         /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
         /* coverity[misra_c_2012_rule_11_3_violation] */
@@ -54,6 +54,7 @@
 #include "FreeRTOS_ARP.h"
 #include "FreeRTOS_TCP_Transmission.h"
 #include "FreeRTOS_TCP_Reception.h"
+#include "FreeRTOS_TCP_FastOpen.h"
 
 /* Just make sure the contents doesn't get compiled if TCP is not enabled. */
 #if ipconfigUSE_TCP == 1
@@ -346,6 +347,16 @@
                 }
                 #endif /* ipconfigUSE_TCP_WIN == 1 */
 
+                #if ( ipconfigUSE_TCP_FAST_OPEN == 1 )
+                {
+                    /* The TFO option is only meaningful in a SYN or a SYN+ACK. */
+                    if( ( pucPtr[ 0U ] == tcpTCP_OPT_FASTOPEN ) && ( xHasSYNFlag != pdFALSE ) )
+                    {
+                        vTCPFastOpenReadOption( pxSocket, pucPtr, ucLen );
+                    }
+                }
+                #endif /* ipconfigUSE_TCP_FAST_OPEN == 1 */
+
                 lIndex += ( int32_t ) ucLen;
             }
         }
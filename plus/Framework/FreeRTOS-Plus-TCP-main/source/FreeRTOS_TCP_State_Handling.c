@@ -57,6 +57,7 @@
 #include "FreeRTOS_TCP_Transmission.h"
 #include "FreeRTOS_TCP_State_Handling.h"
 #include "FreeRTOS_TCP_Utils.h"
+#include "FreeRTOS_TCP_FastOpen.h"
 
 /* Just make sure the contents doesn't get compiled if TCP is not enabled. */
 #if ipconfigUSE_TCP == 1
@@ -199,8 +200,9 @@
                     vTCPStateChange( pxSocket, eCLOSE_WAIT );
 
                     /* When 'bPassQueued' true, this socket is an orphan until it
-                     * gets connected. */
-                    if( pxSocket->u.xTCP.bits.bPassQueued != pdFALSE_UNSIGNED )
+                     * gets connected, unless it was passed early. */
+                    if( ( pxSocket->u.xTCP.bits.bPassQueued != pdFALSE_UNSIGNED ) &&
+                        ( pxSocket->u.xTCP.bits.bPassEarly == pdFALSE_UNSIGNED ) )
                     {
                         /* vTCPStateChange() has called vSocketCloseNextTime()
                          * in case the socket is not yet owned by the application.
@@ -388,6 +390,7 @@
             pxTCPWindow->rx.ulCurrentSequenceNumber = ulSequenceNumber;
 
             pxTCPHeader->ucTCPFlags |= tcpTCP_FLAG_RST;
+            ipCOUNT( ulTcpOutRsts );
 
             uxIntermediateResult = uxIPHeaderSizeSocket( pxSocket ) + ipSIZE_OF_TCP_HEADER + uxOptionsLength;
             xSendLength = ( BaseType_t ) uxIntermediateResult;
@@ -435,6 +438,16 @@
              * 1. */
             pxTCPWindow->ulOurSequenceNumber = pxTCPWindow->tx.ulFirstSequenceNumber + 1U;
 
+            #if ( ipconfigUSE_TCP_FAST_OPEN == 1 )
+            {
+                if( pxSocket->u.xTCP.eTCPState == eCONNECT_SYN )
+                {
+                    /* Store a new cookie, and skip the data that was sent in the SYN. */
+                    vTCPFastOpenSynAckReceived( pxSocket, FreeRTOS_ntohl( pxTCPHeader->ulAckNr ) );
+                }
+            }
+            #endif /* ipconfigUSE_TCP_FAST_OPEN */
+
             #if ( ipconfigUSE_TCP_WIN == 1 )
             {
                 char pcBuffer[ 40 ]; /* Space to print an IP-address. */
@@ -815,6 +828,22 @@
                      * Acknowledge with seq+1 because the SYN is seen as pseudo data
                      * with len = 1. */
                     uxOptionsLength = prvSetSynAckOptions( pxSocket, pxTCPHeader );
+
+                    #if ( ipconfigUSE_TCP_FAST_OPEN == 1 )
+                    {
+                        /* Check the cookie, this may store the data of the SYN, or
+                         * add a new cookie to the SYN+ACK in a bigger buffer. */
+                        uxOptionsLength = uxTCPFastOpenHandleSyn( pxSocket, ppxNetworkBuffer, pucRecvData, ulReceiveLength, uxOptionsLength );
+
+                        /* MISRA Ref 11.3.1 [Misaligned access] */
+                        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+                        /* coverity[misra_c_2012_rule_11_3_violation] */
+                        pxProtocolHeaders = ( ( ProtocolHeaders_t * )
+                                              &( ( *ppxNetworkBuffer )->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER + uxIPHeaderSizeSocket( pxSocket ) ] ) );
+                        pxTCPHeader = &( pxProtocolHeaders->xTCPHeader );
+                    }
+                    #endif /* ipconfigUSE_TCP_FAST_OPEN */
+
                     pxTCPHeader->ucTCPFlags = ( uint8_t ) tcpTCP_FLAG_SYN | ( uint8_t ) tcpTCP_FLAG_ACK;
 
                     uxIntermediateResult = uxIPHeaderSizeSocket( pxSocket ) + ipSIZE_OF_TCP_HEADER + uxOptionsLength;
@@ -828,6 +857,15 @@
 
                     pxTCPWindow->rx.ulHighestSequenceNumber = ulSequenceNumber + 1U;
                     pxTCPWindow->rx.ulCurrentSequenceNumber = ulSequenceNumber + 1U;
+
+                    #if ( ipconfigUSE_TCP_FAST_OPEN == 1 )
+                    {
+                        /* Acknowledge the data of the SYN, if it was accepted. */
+                        pxTCPWindow->rx.ulCurrentSequenceNumber += pxSocket->u.xTCP.xFastOpen.usSynDataLength;
+                        pxTCPWindow->rx.ulHighestSequenceNumber = pxTCPWindow->rx.ulCurrentSequenceNumber;
+                    }
+                    #endif /* ipconfigUSE_TCP_FAST_OPEN */
+
                     pxTCPWindow->ulNextTxSequenceNumber = pxTCPWindow->tx.ulFirstSequenceNumber + 1U;
                     pxTCPWindow->tx.ulCurrentSequenceNumber = pxTCPWindow->tx.ulFirstSequenceNumber + 1U; /* because we send a TCP_SYN. */
                     break;
@@ -962,6 +1000,19 @@
         pxNewSocket->u.xTCP.uxRxWinSize = pxSocket->u.xTCP.uxRxWinSize;
         pxNewSocket->u.xTCP.uxTxWinSize = pxSocket->u.xTCP.uxTxWinSize;
 
+        #if ( ipconfigUSE_TCP_NAGLE == 1 )
+        {
+            pxNewSocket->u.xTCP.xTCPWindow.xCoalesce.bNoDelay = pxSocket->u.xTCP.xTCPWindow.xCoalesce.bNoDelay;
+            pxNewSocket->u.xTCP.xTCPWindow.xCoalesce.bCork = pxSocket->u.xTCP.xTCPWindow.xCoalesce.bCork;
+        }
+        #endif /* ipconfigUSE_TCP_NAGLE */
+
+        #if ( ipconfigUSE_TCP_FAST_OPEN == 1 )
+        {
+            pxNewSocket->u.xTCP.xFastOpen.bEnabled = pxSocket->u.xTCP.xFastOpen.bEnabled;
+        }
+        #endif /* ipconfigUSE_TCP_FAST_OPEN */
+
         #if ( ipconfigSOCKET_HAS_USER_SEMAPHORE == 1 )
         {
             pxNewSocket->pxUserSemaphore = pxSocket->pxUserSemaphore;
@@ -60,6 +60,7 @@
 #include "FreeRTOS_TCP_Transmission.h"
 #include "FreeRTOS_TCP_State_Handling.h"
 #include "FreeRTOS_TCP_Utils.h"
+#include "FreeRTOS_TCP_FastOpen.h"
 
 /* Just make sure the contents doesn't get compiled if TCP is not enabled. */
 #if ipconfigUSE_TCP == 1
@@ -149,6 +150,22 @@
                 /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
                 /* coverity[misra_c_2012_rule_11_3_violation] */
                 pxProtocolHeaders = ( ( ProtocolHeaders_t * ) &( pxSocket->u.xTCP.xPacket.u.ucLastPacket[ ipSIZE_OF_ETH_HEADER + uxIPHeaderSizeSocket( pxSocket ) ] ) );
+                pxNetworkBuffer = NULL;
+
+                #if ( ipconfigUSE_TCP_FAST_OPEN == 1 )
+                {
+                    /* A SYN that carries data does not fit in 'xPacket'. */
+                    pxNetworkBuffer = pxTCPFastOpenGetSynBuffer( pxSocket );
+
+                    if( pxNetworkBuffer != NULL )
+                    {
+                        /* MISRA Ref 11.3.1 [Misaligned access] */
+                        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+                        /* coverity[misra_c_2012_rule_11_3_violation] */
+                        pxProtocolHeaders = ( ( ProtocolHeaders_t * ) &( pxNetworkBuffer->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER + uxIPHeaderSizeSocket( pxSocket ) ] ) );
+                    }
+                }
+                #endif /* ipconfigUSE_TCP_FAST_OPEN */
 
                 /* About to send a SYN packet.  Call prvSetSynAckOptions() to set
                  * the proper options: The size of MSS and whether SACK's are
@@ -157,6 +174,16 @@
 
                 /* Return the number of bytes to be sent. */
                 uxIntermediateResult = uxIPHeaderSizeSocket( pxSocket ) + ipSIZE_OF_TCP_HEADER + uxOptionsLength;
+
+                #if ( ipconfigUSE_TCP_FAST_OPEN == 1 )
+                {
+                    /* Add the TFO option, and the data that was queued before
+                     * connecting. */
+                    uxOptionsLength = uxTCPFastOpenSynOptions( pxSocket, &( pxProtocolHeaders->xTCPHeader ), uxOptionsLength );
+                    uxIntermediateResult = uxIPHeaderSizeSocket( pxSocket ) + ipSIZE_OF_TCP_HEADER + uxOptionsLength;
+                    uxIntermediateResult += pxSocket->u.xTCP.xFastOpen.usSynDataLength;
+                }
+                #endif /* ipconfigUSE_TCP_FAST_OPEN */
                 lResult = ( int32_t ) uxIntermediateResult;
 
                 /* Set the TCP offset field:  ipSIZE_OF_TCP_HEADER equals 20 and
@@ -172,7 +199,21 @@
                 /* Send the SYN message to make a connection.  The messages is
                  * stored in the socket field 'xPacket'.  It will be wrapped in a
                  * pseudo network buffer descriptor before it will be sent. */
-                prvTCPReturnPacket( pxSocket, NULL, ( uint32_t ) lResult, pdFALSE );
+                if( pxNetworkBuffer == NULL )
+                {
+                    prvTCPReturnPacket( pxSocket, NULL, ( uint32_t ) lResult, pdFALSE );
+                }
+                else
+                {
+                    /* A SYN with data, see pxTCPFastOpenGetSynBuffer(). */
+                    prvTCPReturnPacket( pxSocket, pxNetworkBuffer, ( uint32_t ) lResult, ipconfigZERO_COPY_TX_DRIVER );
+
+                    #if ( ipconfigZERO_COPY_TX_DRIVER == 0 )
+                    {
+                        vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+                    }
+                    #endif /* ipconfigZERO_COPY_TX_DRIVER */
+                }
             }
             else
             {
@@ -675,8 +716,10 @@
         {
             /* The caller didn't provide a network buffer or the provided buffer is
              * too small.  As we must send-out a data packet, a buffer will be created
-             * here. */
-            pxReturn = pxGetNetworkBufferWithDescriptor( uxNeeded, 0U );
+             * here.  Segments without data are accounted as control traffic,
+             * so that acknowledgements can still be sent when the TCP senders
+             * have used their share of the buffers. */
+            pxReturn = pxGetNetworkBufferWithClass( uxNeeded, 0U, ( lDataLen > 0 ) ? eBufferClassTCP_TX : eBufferClassControl );
 
             if( pxReturn != NULL )
             {
@@ -1366,6 +1409,8 @@
  */
     BaseType_t prvTCPSendReset( NetworkBufferDescriptor_t * pxNetworkBuffer )
     {
+        ipCOUNT( ulTcpOutRsts );
+
         return prvTCPSendSpecialPacketHelper( pxNetworkBuffer,
                                               ( uint8_t ) tcpTCP_FLAG_ACK | ( uint8_t ) tcpTCP_FLAG_RST );
     }
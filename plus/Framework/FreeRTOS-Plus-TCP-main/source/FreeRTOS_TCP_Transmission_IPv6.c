@@ -211,9 +211,13 @@ void prvTCPReturnPacket_IPV6( FreeRTOS_Socket_t * pxSocket,
 
             #if ( ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM == 0 )
             {
-                /* calculate the TCP checksum for an outgoing packet. */
-                uint32_t ulTotalLength = ulLen + ipSIZE_OF_ETH_HEADER;
-                ( void ) usGenerateProtocolChecksum( ( uint8_t * ) pxNetworkBuffer->pucEthernetBuffer, ulTotalLength, pdTRUE );
+                /* Loop-back packets are not verified when they're received. */
+                if( ENDPOINT_IS_LOOPBACK( pxNetworkBuffer->pxEndPoint ) == pdFALSE )
+                {
+                    /* calculate the TCP checksum for an outgoing packet. */
+                    uint32_t ulTotalLength = ulLen + ipSIZE_OF_ETH_HEADER;
+                    ( void ) usGenerateProtocolChecksum( ( uint8_t * ) pxNetworkBuffer->pucEthernetBuffer, ulTotalLength, pdTRUE );
+                }
             }
             #endif /* ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM == 0 */
 
@@ -280,6 +284,9 @@ void prvTCPReturnPacket_IPV6( FreeRTOS_Socket_t * pxSocket,
             configASSERT( pxNetworkBuffer->pxEndPoint->pxNetworkInterface->pfOutput != NULL );
 
             NetworkInterface_t * pxInterface = pxNetworkBuffer->pxEndPoint->pxNetworkInterface;
+            ipCOUNT( ulTcpOutSegs );
+            ipCOUNT( ulIpOutRequests );
+            ipCOUNT_IF_OUTPUT( pxInterface, pxNetworkBuffer );
             ( void ) pxInterface->pfOutput( pxInterface, pxNetworkBuffer, xDoRelease );
 
             if( xDoRelease == pdFALSE )
@@ -368,7 +375,7 @@ BaseType_t prvTCPPrepareConnect_IPV6( FreeRTOS_Socket_t * pxSocket )
                 NetworkBufferDescriptor_t * pxNetworkBuffer;
 
                 uxNeededSize = ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv6_HEADER + sizeof( ICMPHeader_IPv6_t );
-                pxNetworkBuffer = pxGetNetworkBufferWithDescriptor( uxNeededSize, 0U );
+                pxNetworkBuffer = pxGetNetworkBufferWithClass( uxNeededSize, 0U, eBufferClassControl );
 
                 if( pxNetworkBuffer != NULL )
                 {
@@ -187,6 +187,15 @@
                                                   uint32_t ulWindowSize );
     #endif /* ipconfigUSE_TCP_WIN == 1 */
 
+/*
+ * See if a partial segment must wait for more data before it is sent.
+ */
+    #if ( ipconfigUSE_TCP_NAGLE == 1 )
+        static BaseType_t prvTCPWindowTxCoalesce( TCPWindow_t const * pxWindow,
+                                                  TCPSegment_t const * pxSegment,
+                                                  TickType_t * pulDelay );
+    #endif /* ipconfigUSE_TCP_NAGLE == 1 */
+
 /*
  * An acknowledge was received.  See if some outstanding data may be removed
  * from the transmission queue(s).
@@ -1575,6 +1584,70 @@
     #endif /* ipconfigUSE_TCP_WIN == 1 */
 /*-----------------------------------------------------------*/
 
+    #if ( ipconfigUSE_TCP_NAGLE == 1 )
+
+/**
+ * @brief See if a partial segment at the head of the TX queue must wait for
+ *        more data. It waits while the socket is corked, while the user has
+ *        announced more data with FREERTOS_MSG_MORE, or, according to Nagle's
+ *        algorithm, while earlier data has not been acknowledged. It never
+ *        waits longer than ipconfigTCP_COALESCE_DELAY_MS.
+ *
+ * @param[in] pxWindow The descriptor of the TCP sliding windows.
+ * @param[in] pxSegment The first segment in the TX queue.
+ * @param[out] pulDelay The time after which the segment must be sent anyway.
+ *
+ * @return pdTRUE if the segment must be held back, else pdFALSE.
+ */
+        static BaseType_t prvTCPWindowTxCoalesce( TCPWindow_t const * pxWindow,
+                                                  TCPSegment_t const * pxSegment,
+                                                  TickType_t * pulDelay )
+        {
+            BaseType_t xHoldBack = pdFALSE;
+
+            *pulDelay = 0U;
+
+            if( pxSegment->lDataLength < pxSegment->lMaxLength )
+            {
+                if( ( pxWindow->xCoalesce.bCork != pdFALSE_UNSIGNED ) ||
+                    ( pxWindow->xCoalesce.bMore != pdFALSE_UNSIGNED ) )
+                {
+                    xHoldBack = pdTRUE;
+                }
+                else if( ( pxWindow->xCoalesce.bNoDelay == pdFALSE_UNSIGNED ) &&
+                         ( xSequenceGreaterThan( pxWindow->tx.ulHighestSequenceNumber, pxWindow->tx.ulCurrentSequenceNumber ) != pdFALSE ) )
+                {
+                    /* RFC 896: do not send a small segment as long as there
+                     * is unacknowledged data. */
+                    xHoldBack = pdTRUE;
+                }
+                else
+                {
+                    /* The segment may be sent now. */
+                }
+
+                if( xHoldBack != pdFALSE )
+                {
+                    /* The transmit timer of a new segment was set when the
+                     * first byte was added to it. */
+                    uint32_t ulAge = ulTimerGetAge( &( pxSegment->xTransmitTimer ) );
+
+                    if( ulAge < ( uint32_t ) ipconfigTCP_COALESCE_DELAY_MS )
+                    {
+                        *pulDelay = ( TickType_t ) ( ( uint32_t ) ipconfigTCP_COALESCE_DELAY_MS - ulAge );
+                    }
+                    else
+                    {
+                        xHoldBack = pdFALSE;
+                    }
+                }
+            }
+
+            return xHoldBack;
+        }
+    #endif /* ipconfigUSE_TCP_NAGLE == 1 */
+/*-----------------------------------------------------------*/
+
     #if ( ipconfigUSE_TCP_WIN == 1 )
 
 /**
@@ -1627,6 +1700,24 @@
                         *pulDelay = ulMaxAge - ulAge;
                     }
 
+                    #if ( ipconfigUSE_TCP_NAGLE == 1 )
+                    {
+                        TickType_t uxCoalesceDelay;
+
+                        pxSegment = xTCPWindowPeekHead( &( pxWindow->xTxQueue ) );
+
+                        /* A partial segment that is held back by Nagle's algorithm
+                         * must be sent after its maximum delay, even when no ACK
+                         * has been received. */
+                        if( ( pxSegment != NULL ) &&
+                            ( prvTCPWindowTxCoalesce( pxWindow, pxSegment, &( uxCoalesceDelay ) ) != pdFALSE ) &&
+                            ( uxCoalesceDelay < *pulDelay ) )
+                        {
+                            *pulDelay = uxCoalesceDelay;
+                        }
+                    }
+                    #endif /* ipconfigUSE_TCP_NAGLE == 1 */
+
                     xReturn = pdTRUE;
                 }
                 else
@@ -1653,6 +1744,15 @@
                          * bytes). */
                         xReturn = pdFALSE;
                     }
+
+                    #if ( ipconfigUSE_TCP_NAGLE == 1 )
+                        else if( prvTCPWindowTxCoalesce( pxWindow, pxSegment, pulDelay ) != pdFALSE )
+                        {
+                            /* The partial segment waits for more data, at most
+                             * '*pulDelay' ms. */
+                            xReturn = pdFALSE;
+                        }
+                    #endif
                     else
                     {
                         xReturn = pdTRUE;
@@ -1731,6 +1831,10 @@
         {
             TCPSegment_t * pxSegment = xTCPWindowPeekHead( &( pxWindow->xTxQueue ) );
 
+            #if ( ipconfigUSE_TCP_NAGLE == 1 )
+                TickType_t uxDelay;
+            #endif
+
             if( pxSegment == NULL )
             {
                 /* No segments queued. */
@@ -1742,6 +1846,14 @@
                  * has a full size of MSS. */
                 pxSegment = NULL;
             }
+
+            #if ( ipconfigUSE_TCP_NAGLE == 1 )
+                else if( prvTCPWindowTxCoalesce( pxWindow, pxSegment, &( uxDelay ) ) != pdFALSE )
+                {
+                    /* The segment is still partial and it waits for more data. */
+                    pxSegment = NULL;
+                }
+            #endif
             else if( prvTCPWindowTxHasSpace( pxWindow, ulWindowSize ) == pdFALSE )
             {
                 /* Peer has no more space at this moment. */
@@ -1852,6 +1964,11 @@
                  * retransmissions. */
                 ( pxSegment->u.bits.ucTransmitCount )++;
 
+                if( pxSegment->u.bits.ucTransmitCount > 1U )
+                {
+                    ipCOUNT( ulTcpRetransSegs );
+                }
+
                 /* If there have been several retransmissions (4), decrease the
                  * size of the transmission window to at most 2 times MSS. */
                 if( ( pxSegment->u.bits.ucTransmitCount == MAX_TRANSMIT_COUNT_USING_LARGE_WINDOW ) &&
@@ -232,16 +232,25 @@ void vProcessGeneratedUDPPacket_IPv4( NetworkBufferDescriptor_t * const pxNetwor
             #if ( ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM == 0 )
             {
                 pxIPHeader->usHeaderChecksum = 0U;
-                pxIPHeader->usHeaderChecksum = usGenerateChecksum( 0U, ( uint8_t * ) &( pxIPHeader->ucVersionHeaderLength ), uxIPHeaderSizePacket( pxNetworkBuffer ) );
-                pxIPHeader->usHeaderChecksum = ( uint16_t ) ~FreeRTOS_htons( pxIPHeader->usHeaderChecksum );
 
-                if( ( ucSocketOptions & ( uint8_t ) FREERTOS_SO_UDPCKSUM_OUT ) != 0U )
+                if( ENDPOINT_IS_LOOPBACK( pxNetworkBuffer->pxEndPoint ) != pdFALSE )
                 {
-                    ( void ) usGenerateProtocolChecksum( ( uint8_t * ) pxUDPPacket, pxNetworkBuffer->xDataLength, pdTRUE );
+                    /* Loop-back packets are not verified when they're received,
+                     * the UDP checksum was already cleared. */
                 }
                 else
                 {
-                    pxUDPPacket->xUDPHeader.usChecksum = 0U;
+                    pxIPHeader->usHeaderChecksum = usGenerateChecksum( 0U, ( uint8_t * ) &( pxIPHeader->ucVersionHeaderLength ), uxIPHeaderSizePacket( pxNetworkBuffer ) );
+                    pxIPHeader->usHeaderChecksum = ( uint16_t ) ~FreeRTOS_htons( pxIPHeader->usHeaderChecksum );
+
+                    if( ( ucSocketOptions & ( uint8_t ) FREERTOS_SO_UDPCKSUM_OUT ) != 0U )
+                    {
+                        ( void ) usGenerateProtocolChecksum( ( uint8_t * ) pxUDPPacket, pxNetworkBuffer->xDataLength, pdTRUE );
+                    }
+                    else
+                    {
+                        pxUDPPacket->xUDPHeader.usChecksum = 0U;
+                    }
                 }
             }
             #endif /* if ( ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM == 0 ) */
@@ -312,6 +321,17 @@ void vProcessGeneratedUDPPacket_IPv4( NetworkBufferDescriptor_t * const pxNetwor
 
             if( ( pxInterface != NULL ) && ( pxInterface->pfOutput != NULL ) )
             {
+                if( pxNetworkBuffer->usPort == ( uint16_t ) ipPACKET_CONTAINS_ICMP_DATA )
+                {
+                    ipCOUNT( ulIcmpOutMsgs );
+                }
+                else
+                {
+                    ipCOUNT( ulUdpOutDatagrams );
+                }
+
+                ipCOUNT( ulIpOutRequests );
+                ipCOUNT_IF_OUTPUT( pxInterface, pxNetworkBuffer );
                 ( void ) pxInterface->pfOutput( pxInterface, pxNetworkBuffer, pdTRUE );
             }
         }
@@ -368,7 +388,8 @@ BaseType_t xProcessReceivedUDPPacket_IPv4( NetworkBufferDescriptor_t * pxNetwork
     {
         if( pxSocket != NULL )
         {
-            if( ( pxEndpoint != NULL ) && ( pxEndpoint->ipv4_settings.ulIPAddress != 0U ) )
+            if( ( pxEndpoint != NULL ) && ( pxEndpoint->ipv4_settings.ulIPAddress != 0U ) &&
+                ( INTERFACE_IS_LOOPBACK( pxNetworkBuffer->pxInterface ) == pdFALSE ) )
             {
                 if( xCheckRequiresARPResolution( pxNetworkBuffer ) == pdTRUE )
                 {
@@ -388,9 +409,11 @@ BaseType_t xProcessReceivedUDPPacket_IPv4( NetworkBufferDescriptor_t * pxNetwork
             else
             {
                 /* During DHCP, IP address is not assigned and therefore ARP verification
-                 * is not possible. */
+                 * is not possible. A loop-back end-point does not use the ARP cache. */
             }
 
+            ipCOUNT( ulUdpInDatagrams );
+
             #if ( ipconfigUSE_CALLBACKS == 1 )
             {
                 /* Did the owner of this socket register a reception handler ? */
@@ -550,6 +573,7 @@ BaseType_t xProcessReceivedUDPPacket_IPv4( NetworkBufferDescriptor_t * pxNetwork
                 else
             #endif /* ipconfigUSE_NBNS */
             {
+                ipCOUNT( ulUdpNoPorts );
                 xReturn = pdFAIL;
             }
         }
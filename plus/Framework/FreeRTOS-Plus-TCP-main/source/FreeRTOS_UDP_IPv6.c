@@ -291,7 +291,12 @@ void vProcessGeneratedUDPPacket_IPv6( NetworkBufferDescriptor_t * const pxNetwor
 
             #if ( ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM == 0 )
             {
-                if( ( ucSocketOptions & ( uint8_t ) FREERTOS_SO_UDPCKSUM_OUT ) != 0U )
+                if( ENDPOINT_IS_LOOPBACK( pxNetworkBuffer->pxEndPoint ) != pdFALSE )
+                {
+                    /* Loop-back packets are not verified when they're received,
+                     * the UDP checksum was already cleared. */
+                }
+                else if( ( ucSocketOptions & ( uint8_t ) FREERTOS_SO_UDPCKSUM_OUT ) != 0U )
                 {
                     ( void ) usGenerateProtocolChecksum( ( uint8_t * ) pxUDPPacket_IPv6, pxNetworkBuffer->xDataLength, pdTRUE );
                 }
@@ -355,6 +360,17 @@ void vProcessGeneratedUDPPacket_IPv6( NetworkBufferDescriptor_t * const pxNetwor
             }
             #endif /* if( ipconfigETHERNET_MINIMUM_PACKET_BYTES > 0 ) */
             iptraceNETWORK_INTERFACE_OUTPUT( pxNetworkBuffer->xDataLength, pxNetworkBuffer->pucEthernetBuffer );
+            if( pxNetworkBuffer->usPort == ( uint16_t ) ipPACKET_CONTAINS_ICMP_DATA )
+            {
+                ipCOUNT( ulIcmpOutMsgs );
+            }
+            else
+            {
+                ipCOUNT( ulUdpOutDatagrams );
+            }
+
+            ipCOUNT( ulIpOutRequests );
+            ipCOUNT_IF_OUTPUT( pxInterface, pxNetworkBuffer );
             ( void ) pxInterface->pfOutput( pxInterface, pxNetworkBuffer, pdTRUE );
         }
         else
@@ -411,30 +427,38 @@ BaseType_t xProcessReceivedUDPPacket_IPv6( NetworkBufferDescriptor_t * pxNetwork
     do
     {
         /* UDPv6 doesn't allow zero-checksum, refer to RFC2460 - section 8.1.
-         * Some platforms (such as Zynq) pass the packet to upper layer for flexibility to allow zero-checksum. */
-        if( pxUDPPacket_IPv6->xUDPHeader.usChecksum == 0U )
+         * Some platforms (such as Zynq) pass the packet to upper layer for flexibility to allow zero-checksum.
+         * Loop-back packets may have no checksum, see ipconfigUSE_LOOPBACK_FAST_PATH. */
+        if( ( pxUDPPacket_IPv6->xUDPHeader.usChecksum == 0U ) && ( INTERFACE_IS_LOOPBACK( pxNetworkBuffer->pxInterface ) == pdFALSE ) )
         {
             FreeRTOS_debug_printf( ( "xProcessReceivedUDPPacket_IPv6: Drop packets with checksum %d\n",
                                      pxUDPPacket_IPv6->xUDPHeader.usChecksum ) );
 
+            ipCOUNT( ulUdpInErrors );
             xReturn = pdFAIL;
             break;
         }
 
         if( pxSocket != NULL )
         {
-            if( xCheckRequiresARPResolution( pxNetworkBuffer ) == pdTRUE )
+            /* A loop-back end-point does not use the ND cache. */
+            if( INTERFACE_IS_LOOPBACK( pxNetworkBuffer->pxInterface ) == pdFALSE )
             {
-                /* Mark this packet as waiting for ARP resolution. */
-                *pxIsWaitingForARPResolution = pdTRUE;
+                if( xCheckRequiresARPResolution( pxNetworkBuffer ) == pdTRUE )
+                {
+                    /* Mark this packet as waiting for ARP resolution. */
+                    *pxIsWaitingForARPResolution = pdTRUE;
 
-                /* Return a fail to show that the frame will not be processed right now. */
-                xReturn = pdFAIL;
-                break;
+                    /* Return a fail to show that the frame will not be processed right now. */
+                    xReturn = pdFAIL;
+                    break;
+                }
+
+                vNDRefreshCacheEntry( &( pxUDPPacket_IPv6->xEthernetHeader.xSourceAddress ), &( pxUDPPacket_IPv6->xIPHeader.xSourceAddress ),
+                                      pxNetworkBuffer->pxEndPoint );
             }
 
-            vNDRefreshCacheEntry( &( pxUDPPacket_IPv6->xEthernetHeader.xSourceAddress ), &( pxUDPPacket_IPv6->xIPHeader.xSourceAddress ),
-                                  pxNetworkBuffer->pxEndPoint );
+            ipCOUNT( ulUdpInDatagrams );
 
             #if ( ipconfigUSE_CALLBACKS == 1 )
             {
@@ -584,6 +608,7 @@ BaseType_t xProcessReceivedUDPPacket_IPv6( NetworkBufferDescriptor_t * pxNetwork
                 else
             #endif /* ipconfigUSE_NBNS */
             {
+                ipCOUNT( ulUdpNoPorts );
                 xReturn = pdFAIL;
             }
         }
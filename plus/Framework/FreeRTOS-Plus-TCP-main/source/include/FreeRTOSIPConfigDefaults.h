@@ -371,6 +371,100 @@
 
 /*---------------------------------------------------------------------------*/
 
+/*
+ * ipconfigRA_OPTIMISTIC_DAD
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * Use Optimistic Duplicate Address Detection ( RFC 4429 ). When enabled, an
+ * end-point that is brought up by RA/SLAAC may use its new address as soon as
+ * the first neighbour solicitation has been sent. The remaining
+ * ipconfigRA_IP_TEST_COUNT rounds of address testing continue in the
+ * background. If another device turns out to own the address, the end-point
+ * goes down again and a new address is tested in the normal, non-optimistic
+ * way.
+ */
+
+#ifndef ipconfigRA_OPTIMISTIC_DAD
+    #define ipconfigRA_OPTIMISTIC_DAD    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigRA_OPTIMISTIC_DAD != ipconfigDISABLE ) && ( ipconfigRA_OPTIMISTIC_DAD != ipconfigENABLE ) )
+    #error Invalid ipconfigRA_OPTIMISTIC_DAD configuration
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigRA_CACHE_PREFIX
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * Remember the prefix, the gateway and the address obtained from the last
+ * Router Advertisement. When the link comes up again while the preferred
+ * lifetime of that prefix has not yet expired, the RA process skips the
+ * Router Solicitation phase and immediately tests the cached address.
+ * A new solicitation is sent when the lifetime expires.
+ */
+
+#ifndef ipconfigRA_CACHE_PREFIX
+    #define ipconfigRA_CACHE_PREFIX    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigRA_CACHE_PREFIX != ipconfigDISABLE ) && ( ipconfigRA_CACHE_PREFIX != ipconfigENABLE ) )
+    #error Invalid ipconfigRA_CACHE_PREFIX configuration
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigRA_PARALLEL_DHCPv6
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * Normally an IPv6 end-point that has both 'bWantDHCP' and 'bWantRA' set
+ * will only run DHCPv6. When this option is enabled, both state machines
+ * are started at the same time, each with its own timer. The first one that
+ * obtains a usable address brings the end-point up and stops the other.
+ */
+
+#ifndef ipconfigRA_PARALLEL_DHCPv6
+    #define ipconfigRA_PARALLEL_DHCPv6    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigRA_PARALLEL_DHCPv6 != ipconfigDISABLE ) && ( ipconfigRA_PARALLEL_DHCPv6 != ipconfigENABLE ) )
+    #error Invalid ipconfigRA_PARALLEL_DHCPv6 configuration
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigRA_STABLE_PRIVACY_ADDRESS
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * Let SLAAC create "semantically opaque" interface identifiers as described
+ * in RFC 7217, in stead of purely random ones. The identifier is a keyed hash
+ * of the prefix, the MAC address of the end-point and a DAD counter. The same
+ * device will get the same address every time it joins the same network,
+ * while the address can not be used to track it across networks.
+ *
+ * The application must provide the secret key by implementing:
+ *
+ * BaseType_t xApplicationGetStablePrivacyKey( uint8_t * pucKey,
+ *                                             size_t uxLength );
+ */
+
+#ifndef ipconfigRA_STABLE_PRIVACY_ADDRESS
+    #define ipconfigRA_STABLE_PRIVACY_ADDRESS    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigRA_STABLE_PRIVACY_ADDRESS != ipconfigDISABLE ) && ( ipconfigRA_STABLE_PRIVACY_ADDRESS != ipconfigENABLE ) )
+    #error Invalid ipconfigRA_STABLE_PRIVACY_ADDRESS configuration
+#endif
+
+/*---------------------------------------------------------------------------*/
+
 /*
  * ipconfigENDPOINT_DNS_ADDRESS_COUNT
  *
@@ -737,6 +831,145 @@
 
 /*---------------------------------------------------------------------------*/
 
+/*
+ * ipconfigUSE_RX_ADMISSION
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * When enabled, network drivers ask xNetworkInterfaceRxAdmit() whether a
+ * received frame may be passed to the IP-task. This protects the IP-task and
+ * the application tasks against a flood of packets, e.g. a broadcast storm.
+ *
+ * Frames are classified cheaply, by looking at the Ethernet, IP and TCP
+ * headers only:
+ * - high priority: unicast TCP to a port that has a bound socket.
+ * - normal priority: other unicast frames, like ICMP and UDP, and all ARP
+ *   and IPv6 router/neighbour discovery frames, also when broadcast or
+ *   multicast.
+ * - low priority: other broadcast and multicast frames, and TCP to a port
+ *   without a socket.
+ *
+ * Each interface may pass ipconfigRX_QUOTA_PACKETS frames and
+ * ipconfigRX_QUOTA_BYTES bytes per ipconfigRX_QUOTA_PERIOD_MS. Beyond the
+ * quota only high priority frames are admitted. Independently of the quota,
+ * frames are dropped depending on the occupancy of the IP-task event queue,
+ * see ipconfigRX_DROP_LOW_PERCENT.
+ *
+ * The drop counters are kept in the NetworkInterface_t, see
+ * vNetworkInterfaceRxStats().
+ */
+
+#ifndef ipconfigUSE_RX_ADMISSION
+    #define ipconfigUSE_RX_ADMISSION    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigUSE_RX_ADMISSION != ipconfigDISABLE ) && ( ipconfigUSE_RX_ADMISSION != ipconfigENABLE ) )
+    #error Invalid ipconfigUSE_RX_ADMISSION configuration
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigRX_QUOTA_PERIOD_MS
+ *
+ * Type: uint32_t
+ * Unit: milliseconds
+ * Minimum: 1
+ *
+ * Only used when ipconfigUSE_RX_ADMISSION is enabled: the period after which
+ * the RX quota of an interface is renewed.
+ */
+
+#ifndef ipconfigRX_QUOTA_PERIOD_MS
+    #define ipconfigRX_QUOTA_PERIOD_MS    ( 10U )
+#endif
+
+#if ( ipconfigRX_QUOTA_PERIOD_MS < 1 )
+    #error ipconfigRX_QUOTA_PERIOD_MS must be at least 1
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigRX_QUOTA_PACKETS, ipconfigRX_QUOTA_BYTES
+ *
+ * Type: uint32_t
+ * Unit: count of frames, count of bytes
+ *
+ * Only used when ipconfigUSE_RX_ADMISSION is enabled: the number of frames
+ * and bytes that an interface may pass to the IP-task within one period of
+ * ipconfigRX_QUOTA_PERIOD_MS. Zero means: no limit.
+ */
+
+#ifndef ipconfigRX_QUOTA_PACKETS
+    #define ipconfigRX_QUOTA_PACKETS    ( ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS * 2U )
+#endif
+
+#ifndef ipconfigRX_QUOTA_BYTES
+    #define ipconfigRX_QUOTA_BYTES    ( 0U )
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigRX_DROP_LOW_PERCENT, ipconfigRX_DROP_NORMAL_PERCENT,
+ * ipconfigRX_DROP_HIGH_PERCENT
+ *
+ * Type: UBaseType_t
+ * Unit: percentage of ipconfigEVENT_QUEUE_LENGTH
+ * Minimum: 0
+ * Maximum: 100
+ *
+ * Only used when ipconfigUSE_RX_ADMISSION is enabled: a received frame of
+ * low, normal or high priority is dropped when the IP-task event queue is
+ * filled beyond this percentage.
+ */
+
+#ifndef ipconfigRX_DROP_LOW_PERCENT
+    #define ipconfigRX_DROP_LOW_PERCENT    ( 50U )
+#endif
+
+#ifndef ipconfigRX_DROP_NORMAL_PERCENT
+    #define ipconfigRX_DROP_NORMAL_PERCENT    ( 75U )
+#endif
+
+#ifndef ipconfigRX_DROP_HIGH_PERCENT
+    #define ipconfigRX_DROP_HIGH_PERCENT    ( 95U )
+#endif
+
+#if ( ( ipconfigRX_DROP_LOW_PERCENT > ipconfigRX_DROP_NORMAL_PERCENT ) || ( ipconfigRX_DROP_NORMAL_PERCENT > ipconfigRX_DROP_HIGH_PERCENT ) || ( ipconfigRX_DROP_HIGH_PERCENT > 100 ) )
+    #error The ipconfigRX_DROP_xxx_PERCENT values must be increasing and at most 100
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigUSE_IP_COUNTERS
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * When enabled, the IP-task keeps counters in the style of MIB-II: per
+ * interface ( IF-MIB: octets, unicast and non-unicast packets, discards and
+ * errors ) and per protocol ( IP-MIB, ICMP, UDP and TCP-MIB: receives,
+ * header and address errors, checksum failures, opens, resets and
+ * retransmissions ).
+ *
+ * The counters are only incremented from within the IP-task, so no locking
+ * is needed; each increment costs a single memory access. A consistent copy
+ * can be obtained with vGetIPCounters() and vGetInterfaceCounters(). The
+ * tool 'tcp_netstat.c' can print them as CSV or JSON, see vShowIPCounters().
+ */
+
+#ifndef ipconfigUSE_IP_COUNTERS
+    #define ipconfigUSE_IP_COUNTERS    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigUSE_IP_COUNTERS != ipconfigDISABLE ) && ( ipconfigUSE_IP_COUNTERS != ipconfigENABLE ) )
+    #error Invalid ipconfigUSE_IP_COUNTERS configuration
+#endif
+
+/*---------------------------------------------------------------------------*/
+
 /*
  * ipconfigETHERNET_MINIMUM_PACKET_BYTES
  *
@@ -854,6 +1087,103 @@
 
 /*---------------------------------------------------------------------------*/
 
+/*
+ * ipconfigUSE_BUFFER_CLASSES
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * When enabled, network buffers are accounted per class: driver reception,
+ * TCP transmission, UDP transmission and control traffic ( ARP, ICMP, ND,
+ * DHCP and DNS ). Each class has a guaranteed minimum number of buffers
+ * ( ipconfigBUFFER_RESERVE_xxx ) and a maximum ( ipconfigBUFFER_LIMIT_xxx ).
+ * A class that has reached its reserve can only take a buffer when enough
+ * buffers remain free for the unused reserves of the other classes.
+ *
+ * A request that is refused returns NULL immediately, without blocking.
+ * Network drivers ask for buffers of the reception class, so a burst of
+ * incoming packets is dropped by the driver before it can take the buffers
+ * needed to send ARP replies, TCP acknowledgements or DHCP renewals.
+ *
+ * Buffers obtained with pxGetNetworkBufferWithDescriptor() are not accounted.
+ */
+
+#ifndef ipconfigUSE_BUFFER_CLASSES
+    #define ipconfigUSE_BUFFER_CLASSES    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigUSE_BUFFER_CLASSES != ipconfigDISABLE ) && ( ipconfigUSE_BUFFER_CLASSES != ipconfigENABLE ) )
+    #error Invalid ipconfigUSE_BUFFER_CLASSES configuration
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigBUFFER_RESERVE_RX, ipconfigBUFFER_RESERVE_TCP_TX,
+ * ipconfigBUFFER_RESERVE_UDP_TX, ipconfigBUFFER_RESERVE_CONTROL
+ *
+ * Type: UBaseType_t
+ * Unit: count of network buffers
+ *
+ * Only used when ipconfigUSE_BUFFER_CLASSES is enabled: the number of
+ * network buffers that each class is guaranteed to obtain. The sum of the
+ * reserves must be less than ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS.
+ */
+
+#ifndef ipconfigBUFFER_RESERVE_RX
+    #define ipconfigBUFFER_RESERVE_RX    ( 2U )
+#endif
+
+#ifndef ipconfigBUFFER_RESERVE_TCP_TX
+    #define ipconfigBUFFER_RESERVE_TCP_TX    ( 2U )
+#endif
+
+#ifndef ipconfigBUFFER_RESERVE_UDP_TX
+    #define ipconfigBUFFER_RESERVE_UDP_TX    ( 0U )
+#endif
+
+#ifndef ipconfigBUFFER_RESERVE_CONTROL
+    #define ipconfigBUFFER_RESERVE_CONTROL    ( 2U )
+#endif
+
+#if ( ipconfigUSE_BUFFER_CLASSES != 0 )
+    #if ( ( ipconfigBUFFER_RESERVE_RX + ipconfigBUFFER_RESERVE_TCP_TX + ipconfigBUFFER_RESERVE_UDP_TX + ipconfigBUFFER_RESERVE_CONTROL ) >= ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS )
+        #error The buffer class reserves must be less than ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS
+    #endif
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigBUFFER_LIMIT_RX, ipconfigBUFFER_LIMIT_TCP_TX,
+ * ipconfigBUFFER_LIMIT_UDP_TX, ipconfigBUFFER_LIMIT_CONTROL
+ *
+ * Type: UBaseType_t
+ * Unit: count of network buffers
+ *
+ * Only used when ipconfigUSE_BUFFER_CLASSES is enabled: the maximum number
+ * of network buffers that a class may hold at any time. By default, received
+ * packets may use up to three quarters of the buffers, and UDP senders up to
+ * one half.
+ */
+
+#ifndef ipconfigBUFFER_LIMIT_RX
+    #define ipconfigBUFFER_LIMIT_RX    ( ( ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS * 3U ) / 4U )
+#endif
+
+#ifndef ipconfigBUFFER_LIMIT_TCP_TX
+    #define ipconfigBUFFER_LIMIT_TCP_TX    ( ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS )
+#endif
+
+#ifndef ipconfigBUFFER_LIMIT_UDP_TX
+    #define ipconfigBUFFER_LIMIT_UDP_TX    ( ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS / 2U )
+#endif
+
+#ifndef ipconfigBUFFER_LIMIT_CONTROL
+    #define ipconfigBUFFER_LIMIT_CONTROL    ( ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS )
+#endif
+
+/*---------------------------------------------------------------------------*/
+
 /*
  * ipconfigUSE_LINKED_RX_MESSAGES
  *
@@ -1073,6 +1403,105 @@
 
 /*---------------------------------------------------------------------------*/
 
+/*
+ * ipconfigUSE_EVENT_LANES
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * When enabled, the IP-task receives its events through three queues, called
+ * lanes, instead of one:
+ *
+ * - the control lane, for API calls ( bind, close, accept, select, signals ),
+ *   network-down, DHCP and ARP timer events.
+ * - the transmit lane, for packets sent by the stack or by the application,
+ *   and for TCP timer events.
+ * - the bulk lane, which is 'xNetworkEventQueue', for packets received by
+ *   the network drivers.
+ *
+ * The IP-task services the lanes in that order, so an API call or a UDP send
+ * does not wait behind a long list of received packets. To avoid starvation,
+ * after ipconfigEVENT_LANE_BURST events taken from the higher lanes, the
+ * lanes are visited once in reverse order.
+ *
+ * Drivers do not need to be changed: events that they post directly in
+ * 'xNetworkEventQueue' arrive in the bulk lane.
+ */
+
+#ifndef ipconfigUSE_EVENT_LANES
+    #define ipconfigUSE_EVENT_LANES    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigUSE_EVENT_LANES != ipconfigDISABLE ) && ( ipconfigUSE_EVENT_LANES != ipconfigENABLE ) )
+    #error Invalid ipconfigUSE_EVENT_LANES configuration
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigEVENT_LANE_LENGTH_CONTROL
+ *
+ * Type: size_t
+ * Unit: count of queue spaces
+ * Minimum: 1
+ *
+ * Only used when ipconfigUSE_EVENT_LANES is enabled: the length of the
+ * control lane.
+ */
+
+#ifndef ipconfigEVENT_LANE_LENGTH_CONTROL
+    #define ipconfigEVENT_LANE_LENGTH_CONTROL    ( 10U )
+#endif
+
+#if ( ipconfigEVENT_LANE_LENGTH_CONTROL < 1 )
+    #error ipconfigEVENT_LANE_LENGTH_CONTROL must be at least 1
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigEVENT_LANE_LENGTH_TX
+ *
+ * Type: size_t
+ * Unit: count of queue spaces
+ * Minimum: 1
+ *
+ * Only used when ipconfigUSE_EVENT_LANES is enabled: the length of the
+ * transmit lane. Every event in this lane holds a network buffer, so there
+ * is no point in making it longer than the number of network buffers.
+ */
+
+#ifndef ipconfigEVENT_LANE_LENGTH_TX
+    #define ipconfigEVENT_LANE_LENGTH_TX    ( ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS )
+#endif
+
+#if ( ipconfigEVENT_LANE_LENGTH_TX < 1 )
+    #error ipconfigEVENT_LANE_LENGTH_TX must be at least 1
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigEVENT_LANE_BURST
+ *
+ * Type: UBaseType_t
+ * Unit: count of events
+ * Minimum: 1
+ *
+ * Only used when ipconfigUSE_EVENT_LANES is enabled: the number of events
+ * that the IP-task takes from the control and transmit lanes, before it gives
+ * the lower lanes a turn.
+ */
+
+#ifndef ipconfigEVENT_LANE_BURST
+    #define ipconfigEVENT_LANE_BURST    ( 8U )
+#endif
+
+#if ( ipconfigEVENT_LANE_BURST < 1 )
+    #error ipconfigEVENT_LANE_BURST must be at least 1
+#endif
+
+/*---------------------------------------------------------------------------*/
+
 /*
  * ipconfigIP_TASK_PRIORITY
  *
@@ -1623,6 +2052,450 @@
 
 /*---------------------------------------------------------------------------*/
 
+/*
+ * ipconfigUSE_TCP_NAGLE
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * When enabled, small writes to a TCP socket are coalesced into full-size
+ * segments:
+ *
+ * - Nagle's algorithm ( RFC 896 ): a segment smaller than MSS is held back
+ *   as long as earlier data has not been acknowledged. It is active for
+ *   every TCP socket, unless the socket option FREERTOS_SO_TCP_NODELAY is
+ *   set.
+ * - The socket option FREERTOS_SO_TCP_CORK: while set, only full-size
+ *   segments are sent. Clearing the option sends the remaining data.
+ * - The flag FREERTOS_MSG_MORE for FreeRTOS_send(): more data will follow
+ *   soon, so the last partial segment is held back until a call to
+ *   FreeRTOS_send() without this flag.
+ *
+ * A partial segment is never held back for longer than
+ * ipconfigTCP_COALESCE_DELAY_MS. Sockets created by a listening socket
+ * inherit its FREERTOS_SO_TCP_NODELAY and FREERTOS_SO_TCP_CORK options.
+ *
+ * Requires ipconfigUSE_TCP_WIN: without sliding windows, a socket has only
+ * one outstanding segment anyway.
+ */
+
+#ifndef ipconfigUSE_TCP_NAGLE
+    #define ipconfigUSE_TCP_NAGLE    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigUSE_TCP_NAGLE != ipconfigDISABLE ) && ( ipconfigUSE_TCP_NAGLE != ipconfigENABLE ) )
+    #error Invalid ipconfigUSE_TCP_NAGLE configuration
+#endif
+
+#if ( ( ipconfigUSE_TCP_NAGLE != ipconfigDISABLE ) && ( ipconfigUSE_TCP_WIN == ipconfigDISABLE ) )
+    #error ipconfigUSE_TCP_NAGLE requires ipconfigUSE_TCP_WIN
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigTCP_COALESCE_DELAY_MS
+ *
+ * Type: uint32_t
+ * Unit: milliseconds
+ * Minimum: 1
+ *
+ * The longest time that a partial segment may be held back by Nagle's
+ * algorithm, by FREERTOS_SO_TCP_CORK or by FREERTOS_MSG_MORE. The time is
+ * measured from the moment that the first byte was added to the segment.
+ * Only used when ipconfigUSE_TCP_NAGLE is enabled.
+ */
+
+#ifndef ipconfigTCP_COALESCE_DELAY_MS
+    #define ipconfigTCP_COALESCE_DELAY_MS    ( 200U )
+#endif
+
+#if ( ipconfigTCP_COALESCE_DELAY_MS < 1 )
+    #error ipconfigTCP_COALESCE_DELAY_MS must be at least 1
+#endif
+
+#if ( ipconfigTCP_COALESCE_DELAY_MS > UINT32_MAX )
+    #error ipconfigTCP_COALESCE_DELAY_MS overflows a uint32_t
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigUSE_TCP_FAST_OPEN
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * Include support for TCP Fast Open ( RFC 7413 ). It is enabled per socket
+ * with the socket option FREERTOS_SO_TCP_FASTOPEN.
+ *
+ * - A listening socket hands out cookies to its peers. The cookie is a keyed
+ *   hash of the peer's IP address. A SYN that carries a valid cookie may
+ *   also carry data: the data is accepted and the new socket can be picked
+ *   up by FreeRTOS_accept() before the handshake has completed.
+ * - A client socket asks for a cookie in its SYN, and keeps the cookies in a
+ *   cache of ipconfigTCP_FAST_OPEN_CACHE_SIZE peers. FreeRTOS_connect_data()
+ *   connects and sends the first data in the SYN, when a cookie is known.
+ *
+ * When a peer does not answer the option, or when a SYN with the option has
+ * to be repeated, the next SYN's are sent without it and the peer will not
+ * be offered TFO for a while. Data that was not acknowledged in the SYN+ACK
+ * is sent normally once the connection is established.
+ */
+
+#ifndef ipconfigUSE_TCP_FAST_OPEN
+    #define ipconfigUSE_TCP_FAST_OPEN    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigUSE_TCP_FAST_OPEN != ipconfigDISABLE ) && ( ipconfigUSE_TCP_FAST_OPEN != ipconfigENABLE ) )
+    #error Invalid ipconfigUSE_TCP_FAST_OPEN configuration
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigTCP_FAST_OPEN_CACHE_SIZE
+ *
+ * Type: size_t
+ * Minimum: 1
+ *
+ * The number of peers for which a TCP client remembers a TFO cookie, or
+ * remembers that TFO should not be used. When the cache is full, the entry
+ * that was used least recently is replaced. Only used when
+ * ipconfigUSE_TCP_FAST_OPEN is enabled.
+ */
+
+#ifndef ipconfigTCP_FAST_OPEN_CACHE_SIZE
+    #define ipconfigTCP_FAST_OPEN_CACHE_SIZE    ( 8U )
+#endif
+
+#if ( ipconfigTCP_FAST_OPEN_CACHE_SIZE < 1 )
+    #error ipconfigTCP_FAST_OPEN_CACHE_SIZE must be at least 1
+#endif
+
+#if ( ipconfigTCP_FAST_OPEN_CACHE_SIZE > SIZE_MAX )
+    #error ipconfigTCP_FAST_OPEN_CACHE_SIZE overflows a size_t
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigUSE_LOOPBACK_FAST_PATH
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * Let packets that are sent to a loop-back interface skip the work that is
+ * only needed on a real network. A loop-back interface is one whose
+ * 'bits.bIsLoopback' is set, like the one in loopbackNetworkInterface.c.
+ *
+ * - No IP or protocol checksums are calculated for outgoing packets, and
+ *   they are not verified when the packets are received.
+ * - The MAC address of a loop-back end-point is resolved without the ARP or
+ *   ND cache, and received packets do not refresh those caches.
+ *
+ * Loop-back traffic never leaves the host, so a corrupt checksum can not be
+ * caused by the medium.
+ */
+
+#ifndef ipconfigUSE_LOOPBACK_FAST_PATH
+    #define ipconfigUSE_LOOPBACK_FAST_PATH    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigUSE_LOOPBACK_FAST_PATH != ipconfigDISABLE ) && ( ipconfigUSE_LOOPBACK_FAST_PATH != ipconfigENABLE ) )
+    #error Invalid ipconfigUSE_LOOPBACK_FAST_PATH configuration
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigUSE_BONDING
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * Let several network interfaces act as one logical interface, see
+ * FreeRTOS_Bonding.c. The end-points are bound to the logical interface and
+ * the members all use its MAC address. Two modes are supported:
+ *
+ * - eBondingActiveBackup: one member carries all traffic. When its link goes
+ *   down, the next member that is up takes over, and the end-points are
+ *   announced with a gratuitous ARP or an unsolicited Neighbour Advertisement.
+ * - eBondingBalanceXOR: every member that is up carries traffic. A hash of the
+ *   addresses and ports of a packet selects the member, so all packets of a
+ *   flow are sent in order through the same link.
+ *
+ * Needs the multi-interface API, so ipconfigCOMPATIBLE_WITH_SINGLE must be
+ * disabled.
+ */
+
+#ifndef ipconfigUSE_BONDING
+    #define ipconfigUSE_BONDING    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigUSE_BONDING != ipconfigDISABLE ) && ( ipconfigUSE_BONDING != ipconfigENABLE ) )
+    #error Invalid ipconfigUSE_BONDING configuration
+#endif
+
+#if ( ( ipconfigUSE_BONDING != 0 ) && ( ipconfigCOMPATIBLE_WITH_SINGLE != 0 ) )
+    #error ipconfigUSE_BONDING can not be used together with ipconfigCOMPATIBLE_WITH_SINGLE
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigBONDING_MAX_MEMBERS
+ *
+ * Type: size_t
+ * Minimum: 2
+ *
+ * The maximum number of network interfaces that can be a member of one bond.
+ * Only used when ipconfigUSE_BONDING is enabled.
+ */
+
+#ifndef ipconfigBONDING_MAX_MEMBERS
+    #define ipconfigBONDING_MAX_MEMBERS    ( 2U )
+#endif
+
+#if ( ipconfigBONDING_MAX_MEMBERS < 2 )
+    #error ipconfigBONDING_MAX_MEMBERS must be at least 2
+#endif
+
+#if ( ipconfigBONDING_MAX_MEMBERS > 32 )
+    #error ipconfigBONDING_MAX_MEMBERS can not be larger than 32
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigBONDING_MONITOR_PERIOD_MS
+ *
+ * Type: uint32_t
+ * Unit: milliseconds
+ * Minimum: 1
+ *
+ * The IP-task checks the link status of all bond members with this period,
+ * by calling their pfGetPhyLinkStatus() function. The drivers keep that
+ * status up-to-date with the PHY functions in phyHandling.c. A shorter
+ * period gives a faster failover. Only used when ipconfigUSE_BONDING is
+ * enabled.
+ */
+
+#ifndef ipconfigBONDING_MONITOR_PERIOD_MS
+    #define ipconfigBONDING_MONITOR_PERIOD_MS    ( 100U )
+#endif
+
+#if ( ipconfigBONDING_MONITOR_PERIOD_MS < 1 )
+    #error ipconfigBONDING_MONITOR_PERIOD_MS must be at least 1
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigUSE_BRIDGE
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * Add a layer-2 learning bridge between network interfaces, see
+ * FreeRTOS_Bridge.c. This lets a board with two Ethernet ports act as a switch
+ * in a daisy chain. The end-points are bound to the bridge interface, and
+ * frames for this host are delivered to the stack. Other frames are forwarded
+ * to the port behind which their destination was learned, or flooded to all
+ * ports when the destination is not known yet. A forwarded frame is passed
+ * to the other driver without copying it.
+ *
+ * Loops are avoided without STP: every port has a role. A port with the role
+ * eBridgePortBackup only forwards while one of the eBridgePortForwarding ports
+ * has lost its link, as the ring protection link of a ring. The drivers of the
+ * ports must receive all frames, not only the ones for their own MAC address.
+ *
+ * Needs the multi-interface API, so ipconfigCOMPATIBLE_WITH_SINGLE must be
+ * disabled.
+ */
+
+#ifndef ipconfigUSE_BRIDGE
+    #define ipconfigUSE_BRIDGE    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigUSE_BRIDGE != ipconfigDISABLE ) && ( ipconfigUSE_BRIDGE != ipconfigENABLE ) )
+    #error Invalid ipconfigUSE_BRIDGE configuration
+#endif
+
+#if ( ( ipconfigUSE_BRIDGE != 0 ) && ( ipconfigCOMPATIBLE_WITH_SINGLE != 0 ) )
+    #error ipconfigUSE_BRIDGE can not be used together with ipconfigCOMPATIBLE_WITH_SINGLE
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigBRIDGE_MAX_PORTS
+ *
+ * Type: size_t
+ * Minimum: 2
+ *
+ * The maximum number of ports of a bridge. Only used when ipconfigUSE_BRIDGE
+ * is enabled.
+ */
+
+#ifndef ipconfigBRIDGE_MAX_PORTS
+    #define ipconfigBRIDGE_MAX_PORTS    ( 2U )
+#endif
+
+#if ( ipconfigBRIDGE_MAX_PORTS < 2 )
+    #error ipconfigBRIDGE_MAX_PORTS must be at least 2
+#endif
+
+#if ( ipconfigBRIDGE_MAX_PORTS > 32 )
+    #error ipconfigBRIDGE_MAX_PORTS can not be larger than 32
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigBRIDGE_MAC_TABLE_SIZE
+ *
+ * Type: size_t
+ * Minimum: 4
+ *
+ * The number of MAC addresses that a bridge can learn. The table is divided
+ * into buckets of 4 entries, and a MAC address is hashed to one bucket. When
+ * the bucket is full, the entry that was seen least recently is replaced.
+ * Must be a power of 2. Only used when ipconfigUSE_BRIDGE is enabled.
+ */
+
+#ifndef ipconfigBRIDGE_MAC_TABLE_SIZE
+    #define ipconfigBRIDGE_MAC_TABLE_SIZE    ( 64U )
+#endif
+
+#if ( ipconfigBRIDGE_MAC_TABLE_SIZE < 4 )
+    #error ipconfigBRIDGE_MAC_TABLE_SIZE must be at least 4
+#endif
+
+#if ( ( ipconfigBRIDGE_MAC_TABLE_SIZE & ( ipconfigBRIDGE_MAC_TABLE_SIZE - 1 ) ) != 0 )
+    #error ipconfigBRIDGE_MAC_TABLE_SIZE must be a power of 2
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigBRIDGE_MAC_AGE_SECONDS
+ *
+ * Type: uint32_t
+ * Unit: seconds
+ * Minimum: 1
+ *
+ * A learned MAC address is forgotten when no frame was received from it for
+ * this time. The table is also emptied when the link of a port changes.
+ * Only used when ipconfigUSE_BRIDGE is enabled.
+ */
+
+#ifndef ipconfigBRIDGE_MAC_AGE_SECONDS
+    #define ipconfigBRIDGE_MAC_AGE_SECONDS    ( 300U )
+#endif
+
+#if ( ipconfigBRIDGE_MAC_AGE_SECONDS < 1 )
+    #error ipconfigBRIDGE_MAC_AGE_SECONDS must be at least 1
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigBRIDGE_MONITOR_PERIOD_MS
+ *
+ * Type: uint32_t
+ * Unit: milliseconds
+ * Minimum: 1
+ *
+ * The IP-task checks the link status of the bridge ports with this period,
+ * and removes the MAC addresses that have aged. Only used when
+ * ipconfigUSE_BRIDGE is enabled.
+ */
+
+#ifndef ipconfigBRIDGE_MONITOR_PERIOD_MS
+    #define ipconfigBRIDGE_MONITOR_PERIOD_MS    ( 100U )
+#endif
+
+#if ( ipconfigBRIDGE_MONITOR_PERIOD_MS < 1 )
+    #error ipconfigBRIDGE_MONITOR_PERIOD_MS must be at least 1
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigUSE_PACKET_SOCKETS
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * Add packet sockets, see FreeRTOS_PacketSocket.c. A packet socket is bound
+ * to an interface and an EtherType other than ARP, IPv4 or IPv6, for instance
+ * that of a field bus protocol. Received frames are handed to the socket in
+ * the network buffer of the driver, without copying, and an optional classic
+ * BPF program selects the frames. The application sends frames that it built
+ * itself, including the Ethernet header.
+ *
+ * The IP-task offers every frame with another EtherType to the packet sockets
+ * before eApplicationProcessCustomFrameHook() is called. A driver can call
+ * xPacketSocketDriverDeliver() in its receive task, so that these frames don't
+ * pass through the IP-task at all, unless the interface is a member of a bond
+ * or a port of a bridge.
+ */
+
+#ifndef ipconfigUSE_PACKET_SOCKETS
+    #define ipconfigUSE_PACKET_SOCKETS    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigUSE_PACKET_SOCKETS != ipconfigDISABLE ) && ( ipconfigUSE_PACKET_SOCKETS != ipconfigENABLE ) )
+    #error Invalid ipconfigUSE_PACKET_SOCKETS configuration
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigPACKET_FILTER_MAX_INSTRUCTIONS
+ *
+ * Type: size_t
+ * Minimum: 1
+ *
+ * The maximum number of instructions of a filter program that is attached to
+ * a packet socket. Only used when ipconfigUSE_PACKET_SOCKETS is enabled.
+ */
+
+#ifndef ipconfigPACKET_FILTER_MAX_INSTRUCTIONS
+    #define ipconfigPACKET_FILTER_MAX_INSTRUCTIONS    ( 64U )
+#endif
+
+#if ( ipconfigPACKET_FILTER_MAX_INSTRUCTIONS < 1 )
+    #error ipconfigPACKET_FILTER_MAX_INSTRUCTIONS must be at least 1
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigUSE_TAGGED_HEAP
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * Enable this when the kernel uses heap_6.c, in which each heap region has
+ * attributes. The objects of the IP-stack will then be placed according to
+ * their class:
+ *
+ * - sockets prefer fast memory ( portHEAP_ATTR_FAST ),
+ * - stream buffers and the TCP window segments prefer bulk memory
+ *   ( portHEAP_ATTR_BULK ),
+ * - the buffers of BufferAllocation_2.c require memory that can be
+ *   accessed by DMA ( portHEAP_ATTR_DMA ). xNetworkBuffersInitialise() fails
+ *   with a message when no heap region has this attribute.
+ *
+ * Each class can still be overridden by defining pvPortMallocSocket,
+ * pvPortMallocLarge or pvPortMallocNetworkBuffer.
+ */
+
+#ifndef ipconfigUSE_TAGGED_HEAP
+    #define ipconfigUSE_TAGGED_HEAP    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigUSE_TAGGED_HEAP != ipconfigDISABLE ) && ( ipconfigUSE_TAGGED_HEAP != ipconfigENABLE ) )
+    #error Invalid ipconfigUSE_TAGGED_HEAP configuration
+#endif
+
+/*---------------------------------------------------------------------------*/
+
 /*
  * pvPortMallocLarge / vPortFreeLarge
  *
@@ -1630,7 +2503,11 @@
  */
 
 #ifndef pvPortMallocLarge
-    #define pvPortMallocLarge( size )    pvPortMalloc( size )
+    #if ( ipconfigUSE_TAGGED_HEAP != 0 )
+        #define pvPortMallocLarge( size )    pvPortMallocTagged( size, 0U, portHEAP_ATTR_BULK )
+    #else
+        #define pvPortMallocLarge( size )    pvPortMalloc( size )
+    #endif
 #endif
 
 #ifndef vPortFreeLarge
@@ -2111,7 +2988,11 @@
  */
 
 #ifndef pvPortMallocSocket
-    #define pvPortMallocSocket( size )    pvPortMalloc( size )
+    #if ( ipconfigUSE_TAGGED_HEAP != 0 )
+        #define pvPortMallocSocket( size )    pvPortMallocTagged( size, 0U, portHEAP_ATTR_FAST )
+    #else
+        #define pvPortMallocSocket( size )    pvPortMalloc( size )
+    #endif
 #endif
 
 #ifndef vPortFreeSocket
@@ -2120,6 +3001,29 @@
 
 /*---------------------------------------------------------------------------*/
 
+/*
+ * pvPortMallocNetworkBuffer/vPortFreeNetworkBuffer
+ *
+ * Malloc functions for the Ethernet buffers of BufferAllocation_2.c. These
+ * buffers are accessed by the DMA of the network interface.
+ */
+
+#ifndef pvPortMallocNetworkBuffer
+    #if ( ipconfigUSE_TAGGED_HEAP != 0 )
+        #define pvPortMallocNetworkBuffer( size )    pvPortMallocTagged( size, portHEAP_ATTR_DMA, 0U )
+        /* Let xNetworkBuffersInitialise() check that a DMA region exists. */
+        #define ipNETWORK_BUFFER_NEEDS_DMA_REGION    1
+    #else
+        #define pvPortMallocNetworkBuffer( size )    pvPortMalloc( size )
+    #endif
+#endif
+
+#ifndef vPortFreeNetworkBuffer
+    #define vPortFreeNetworkBuffer( ptr )    vPortFree( ptr )
+#endif
+
+/*---------------------------------------------------------------------------*/
+
 /*===========================================================================*/
 /*                              SOCKET CONFIG                                */
 /*===========================================================================*/
@@ -2193,6 +3097,10 @@
     #error DHCPv6 Cannot be enabled without IPv6
 #endif
 
+#if ( ipconfigIS_ENABLED( ipconfigRA_PARALLEL_DHCPv6 ) && ( ipconfigIS_DISABLED( ipconfigUSE_RA ) || ipconfigIS_DISABLED( ipconfigUSE_DHCPv6 ) ) )
+    #error ipconfigRA_PARALLEL_DHCPv6 requires both ipconfigUSE_RA and ipconfigUSE_DHCPv6
+#endif
+
 /*---------------------------------------------------------------------------*/
 
 /*
@@ -3258,6 +4166,29 @@
 
 /*---------------------------------------------------------------------------*/
 
+/*
+ * ipconfigUSE_DEADLINE_MONITOR
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * See this utility: tools/tcp_utilities/deadline_monitor.md
+ *
+ * Allow inclusion of a software watchdog that measures how long the IP-task
+ * and the network driver tasks are busy in each round of their loop, and
+ * reports the rounds that exceeded their budget, or that did not finish at
+ * all.
+ */
+
+#ifndef ipconfigUSE_DEADLINE_MONITOR
+    #define ipconfigUSE_DEADLINE_MONITOR    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigUSE_DEADLINE_MONITOR != ipconfigDISABLE ) && ( ipconfigUSE_DEADLINE_MONITOR != ipconfigENABLE ) )
+    #error Invalid ipconfigUSE_DEADLINE_MONITOR configuration
+#endif
+
+/*---------------------------------------------------------------------------*/
+
 /*
  * ipconfigTCP_MEM_STATS_MAX_ALLOCATION
  *
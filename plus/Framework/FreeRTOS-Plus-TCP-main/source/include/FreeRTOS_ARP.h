@@ -165,6 +165,10 @@ void vARPGenerateRequestPacket( NetworkBufferDescriptor_t * const pxNetworkBuffe
 
 void FreeRTOS_OutputARPRequest( uint32_t ulIPAddress );
 
+/* Send an ARP request from one end-point only. */
+void FreeRTOS_OutputARPRequest_Multi( struct xNetworkEndPoint * pxEndPoint,
+                                      uint32_t ulIPAddress );
+
 /* Clear all entries in the ARp cache. */
 void FreeRTOS_ClearARP( const struct xNetworkEndPoint * pxEndPoint );
 
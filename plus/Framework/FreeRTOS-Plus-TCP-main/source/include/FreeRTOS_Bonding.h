@@ -0,0 +1,112 @@
+/*
+ * FreeRTOS+TCP <DEVELOPMENT BRANCH>
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+#ifndef FREERTOS_BONDING_H
+#define FREERTOS_BONDING_H
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+#include "FreeRTOS_Routing.h"
+
+#if ( ipconfigUSE_BONDING != 0 )
+
+/** @brief The way in which a bond uses its members, see ipconfigUSE_BONDING. */
+    typedef enum eBONDING_MODE
+    {
+        eBondingActiveBackup, /**< One member carries all traffic, the others are standing by. */
+        eBondingBalanceXOR    /**< Flows are spread over all members that are up. */
+    } eBondingMode_t;
+
+/** @brief The state of a bond. The object must be declared static or global,
+ *         it is stored in the field 'pvArgument' of the bond interface. */
+    typedef struct xBONDING
+    {
+        NetworkInterface_t * pxMembers[ ipconfigBONDING_MAX_MEMBERS ]; /**< The member interfaces, in order of preference. */
+        UBaseType_t uxMemberCount;                                     /**< The number of valid entries in 'pxMembers'. */
+        UBaseType_t uxActive;                                          /**< Active-backup: the index of the member that carries the traffic. */
+        uint32_t ulLinkUp;                                             /**< Bit 'n' is set while the link of 'pxMembers[ n ]' is up. */
+        uint32_t ulFailovers;                                          /**< The number of times that another member became active. */
+        eBondingMode_t eMode;                                          /**< The mode of the bond. */
+    } Bonding_t;
+
+/*
+ * Fill in and add a network interface that represents a bond. The end-points
+ * must be added to this interface, not to its members. The members are added
+ * with xBondingAddMember(), before FreeRTOS_IPInit_Multi() is called.
+ */
+    NetworkInterface_t * pxBonding_FillInterfaceDescriptor( Bonding_t * pxBond,
+                                                            eBondingMode_t eMode,
+                                                            NetworkInterface_t * pxInterface );
+
+/*
+ * Make 'pxMember' a member of the bond 'pxBondInterface'. The member has been
+ * filled in by its driver, but it must not have end-points of its own.
+ * Returns pdPASS on success.
+ */
+    BaseType_t xBondingAddMember( NetworkInterface_t * pxBondInterface,
+                                  NetworkInterface_t * pxMember );
+
+/*
+ * Return the member that carries the traffic in active-backup mode, or NULL
+ * when no member has a link.
+ */
+    NetworkInterface_t * pxBondingGetActiveMember( const NetworkInterface_t * pxBondInterface );
+
+/*
+ * Called by the IP-task for every received frame. When the frame was received
+ * by a member of a bond, it is handed to the bond. Returns pdFALSE when the
+ * frame must be dropped, because it was received by a standby member.
+ */
+    BaseType_t xBondingReceive( NetworkBufferDescriptor_t * pxNetworkBuffer );
+
+/*
+ * Called by the IP-task for a network-down event. When 'pxInterface' is the
+ * member of a bond, it is initialised again and another member takes over.
+ * The end-points of the bond stay up. Returns pdFALSE when 'pxInterface' is
+ * not a member of a bond.
+ */
+    BaseType_t xBondingMemberDown( NetworkInterface_t * pxInterface );
+
+/*
+ * Called by the IP-task every ipconfigBONDING_MONITOR_PERIOD_MS. Check the
+ * links of all members, and fail over when needed.
+ */
+    void vBondingCheckLinks( void );
+
+#endif /* ( ipconfigUSE_BONDING != 0 ) */
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    } /* extern "C" */
+#endif
+/* *INDENT-ON* */
+
+#endif /* FREERTOS_BONDING_H */
@@ -0,0 +1,132 @@
+/*
+ * FreeRTOS+TCP <DEVELOPMENT BRANCH>
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+#ifndef FREERTOS_BRIDGE_H
+#define FREERTOS_BRIDGE_H
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+
+#include "FreeRTOS_IP_Private.h"
+#include "FreeRTOS_Routing.h"
+
+#if ( ipconfigUSE_BRIDGE != 0 )
+
+/** @brief The role of a bridge port, used to avoid loops without STP. */
+    typedef enum eBRIDGE_PORT_ROLE
+    {
+        eBridgePortForwarding, /**< Frames are forwarded to and from this port. */
+        eBridgePortBackup      /**< Only forwards while an eBridgePortForwarding port has no link. */
+    } eBridgePortRole_t;
+
+/** @brief A port of a bridge. */
+    typedef struct xBRIDGE_PORT
+    {
+        NetworkInterface_t * pxInterface; /**< The network interface of the port. */
+        eBridgePortRole_t eRole;          /**< The role of the port. */
+        uint32_t ulForwarded;             /**< The number of frames forwarded to this port. */
+    } BridgePort_t;
+
+/** @brief A MAC address that was learned by a bridge. */
+    typedef struct xBRIDGE_MAC_ENTRY
+    {
+        MACAddress_t xMACAddress; /**< The source address of a received frame. */
+        uint8_t ucPort;           /**< The port on which the frame was received. */
+        uint8_t ucInUse;          /**< pdTRUE when the entry is in use. */
+        TickType_t xLastSeen;     /**< The time at which the address was seen for the last time. */
+    } BridgeMACEntry_t;
+
+/** @brief The state of a bridge. The object must be declared static or global,
+ *         it is stored in the field 'pvArgument' of the bridge interface. */
+    typedef struct xBRIDGE
+    {
+        BridgePort_t xPorts[ ipconfigBRIDGE_MAX_PORTS ];             /**< The ports of the bridge. */
+        UBaseType_t uxPortCount;                                     /**< The number of valid entries in 'xPorts'. */
+        uint32_t ulLinkUp;                                           /**< Bit 'n' is set while the link of 'xPorts[ n ]' is up. */
+        uint32_t ulForwarding;                                       /**< Bit 'n' is set while 'xPorts[ n ]' may forward frames. */
+        uint32_t ulFlooded;                                          /**< The number of frames sent to all ports. */
+        uint32_t ulFiltered;                                         /**< The number of frames dropped because of the port role or destination. */
+        BridgeMACEntry_t xMACTable[ ipconfigBRIDGE_MAC_TABLE_SIZE ]; /**< The learned MAC addresses. */
+    } Bridge_t;
+
+/*
+ * Fill in and add a network interface that represents a bridge. The end-points
+ * must be added to this interface, not to its ports. The ports are added
+ * with xBridgeAddPort(), before FreeRTOS_IPInit_Multi() is called.
+ */
+    NetworkInterface_t * pxBridge_FillInterfaceDescriptor( Bridge_t * pxBridge,
+                                                           NetworkInterface_t * pxInterface );
+
+/*
+ * Make 'pxPort' a port of the bridge 'pxBridgeInterface'. The port has been
+ * filled in by its driver, but it must not have end-points of its own.
+ * Returns pdPASS on success.
+ */
+    BaseType_t xBridgeAddPort( NetworkInterface_t * pxBridgeInterface,
+                               NetworkInterface_t * pxPort,
+                               eBridgePortRole_t eRole );
+
+/*
+ * Forget all MAC addresses that were learned by a bridge.
+ */
+    void vBridgeFlushMACTable( NetworkInterface_t * pxBridgeInterface );
+
+/*
+ * Called by the IP-task for every received frame. When the frame was received
+ * by a port of a bridge, it is forwarded to the other ports and/or handed to
+ * the bridge. Returns eProcessBuffer when the frame is for this host,
+ * eFrameConsumed when it was forwarded, and eReleaseBuffer when it must be
+ * dropped.
+ */
+    eFrameProcessingResult_t eBridgeReceive( NetworkBufferDescriptor_t * pxNetworkBuffer );
+
+/*
+ * Called by the IP-task for a network-down event. When 'pxInterface' is a port
+ * of a bridge, it is initialised again. The end-points of the bridge stay up.
+ * Returns pdFALSE when 'pxInterface' is not a port of a bridge.
+ */
+    BaseType_t xBridgePortDown( NetworkInterface_t * pxInterface );
+
+/*
+ * Called by the IP-task every ipconfigBRIDGE_MONITOR_PERIOD_MS. Check the
+ * links of all ports and remove the MAC addresses that have aged.
+ */
+    void vBridgeCheckPorts( void );
+
+#endif /* ( ipconfigUSE_BRIDGE != 0 ) */
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    } /* extern "C" */
+#endif
+/* *INDENT-ON* */
+
+#endif /* FREERTOS_BRIDGE_H */
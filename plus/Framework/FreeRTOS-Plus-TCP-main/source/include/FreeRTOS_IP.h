@@ -166,6 +166,9 @@ typedef struct xNETWORK_BUFFER
     struct xNetworkEndPoint * pxEndPoint;      /**< The end-point through which this packet shall be sent. */
     uint16_t usPort;                           /**< Source or destination port, depending on usage scenario. */
     uint16_t usBoundPort;                      /**< The port to which a transmitting socket is bound. */
+    #if ( ipconfigUSE_BUFFER_CLASSES != 0 )
+        uint8_t ucBufferClass;                 /**< The eNetworkBufferClass_t for which this buffer was obtained. */
+    #endif
     #if ( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
         struct xNETWORK_BUFFER * pxNextBuffer; /**< Possible optimisation for expert users - requires network driver support. */
     #endif
@@ -0,0 +1,189 @@
+/*
+ * FreeRTOS+TCP <DEVELOPMENT BRANCH>
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file FreeRTOS_IP_Counters.h
+ * @brief MIB-II style interface and protocol counters, see ipconfigUSE_IP_COUNTERS.
+ */
+
+#ifndef FREERTOS_IP_COUNTERS_H
+#define FREERTOS_IP_COUNTERS_H
+
+/* Standard includes. */
+#include <stdint.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOSIPConfig.h"
+#include "FreeRTOSIPConfigDefaults.h"
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+#if ( ipconfigUSE_IP_COUNTERS != 0 )
+
+/* Forward declarations. */
+    struct xNetworkInterface;
+
+/** @brief The counters of one network interface, modelled after the IF-MIB ifTable. */
+    typedef struct xIF_COUNTERS
+    {
+        uint32_t ulInOctets;        /**< Bytes received, Ethernet header included. */
+        uint32_t ulInUcastPkts;     /**< Unicast frames received. */
+        uint32_t ulInNUcastPkts;    /**< Broadcast and multicast frames received. */
+        uint32_t ulInDiscards;      /**< Frames that were dropped, although they had no errors. */
+        uint32_t ulInErrors;        /**< Frames that were dropped because they were malformed. */
+        uint32_t ulInUnknownProtos; /**< Frames with an unknown frame type. */
+        uint32_t ulOutOctets;       /**< Bytes sent, Ethernet header included. */
+        uint32_t ulOutUcastPkts;    /**< Unicast frames sent. */
+        uint32_t ulOutNUcastPkts;   /**< Broadcast and multicast frames sent. */
+    } IfCounters_t;
+
+/** @brief The protocol counters, modelled after the IP-MIB, ICMP, UDP-MIB and TCP-MIB groups.
+ *         IPv4 and IPv6 are counted together. */
+    typedef struct xIP_COUNTERS
+    {
+        /* IP */
+        uint32_t ulIpInReceives;      /**< IP packets received. */
+        uint32_t ulIpInHdrErrors;     /**< IP packets dropped because of a bad header or checksum. */
+        uint32_t ulIpInAddrErrors;    /**< IP packets dropped because they were not addressed to this node. */
+        uint32_t ulIpInUnknownProtos; /**< IP packets with an unsupported protocol. */
+        uint32_t ulIpInDelivers;      /**< IP packets passed to ICMP, UDP or TCP. */
+        uint32_t ulIpOutRequests;     /**< IP packets passed to a network interface. */
+        uint32_t ulIpReasmFails;      /**< Fragments dropped, because reassembly is not supported. */
+
+        /* ICMP */
+        uint32_t ulIcmpInMsgs;        /**< ICMP messages received. */
+        uint32_t ulIcmpInErrors;      /**< ICMP messages with a bad checksum. */
+        uint32_t ulIcmpInEchos;       /**< Echo requests received. */
+        uint32_t ulIcmpInEchoReps;    /**< Echo replies received. */
+        uint32_t ulIcmpOutMsgs;       /**< ICMP messages sent. */
+        uint32_t ulIcmpOutEchoReps;   /**< Echo replies sent. */
+
+        /* UDP */
+        uint32_t ulUdpInDatagrams;    /**< UDP datagrams delivered to a socket. */
+        uint32_t ulUdpNoPorts;        /**< UDP datagrams for a port without a socket. */
+        uint32_t ulUdpInErrors;       /**< UDP datagrams with a bad checksum. */
+        uint32_t ulUdpOutDatagrams;   /**< UDP datagrams sent. */
+
+        /* TCP */
+        uint32_t ulTcpActiveOpens;    /**< Transitions from CLOSED to SYN-SENT. */
+        uint32_t ulTcpPassiveOpens;   /**< Transitions from LISTEN to SYN-RCVD. */
+        uint32_t ulTcpAttemptFails;   /**< Connections that failed before being established. */
+        uint32_t ulTcpEstabResets;    /**< Transitions from ESTABLISHED to eCLOSED or eCLOSE_WAIT. */
+        uint32_t ulTcpCurrEstab;      /**< Connections in ESTABLISHED ( a gauge ). This stack only enters eCLOSE_WAIT once a
+                                       * connection has ended, so unlike RFC 1213 it is not counted. */
+        uint32_t ulTcpInSegs;         /**< TCP segments received. */
+        uint32_t ulTcpOutSegs;        /**< TCP segments sent. */
+        uint32_t ulTcpRetransSegs;    /**< TCP segments that were sent again. */
+        uint32_t ulTcpInErrs;         /**< TCP segments with a bad checksum. */
+        uint32_t ulTcpOutRsts;        /**< TCP segments sent with the RST flag. */
+    } IPCounters_t;
+
+/** @brief The protocol counters. Only the IP-task writes to it. */
+    extern IPCounters_t xIPCounters;
+
+/** @brief Increment a field of xIPCounters, e.g. ipCOUNT( ulIpInReceives ). */
+    #define ipCOUNT( xField )    ( ( xIPCounters.xField )++ )
+
+/** @brief Decrement a gauge in xIPCounters. */
+    #define ipUNCOUNT( xField )    ( ( xIPCounters.xField )-- )
+
+/** @brief Count an incoming or outgoing frame in the IF-MIB counters of an interface.
+ *         Bit 0 of the first octet of the destination MAC address tells whether
+ *         it is a group address. */
+    #define ipCOUNT_IF_INPUT( pxInterface, pxNetworkBuffer )                                    \
+    do {                                                                                        \
+        ( pxInterface )->xCounters.ulInOctets += ( uint32_t ) ( pxNetworkBuffer )->xDataLength; \
+        if( ( ( pxNetworkBuffer )->pucEthernetBuffer[ 0 ] & 0x01U ) != 0U )                     \
+        {                                                                                       \
+            ( pxInterface )->xCounters.ulInNUcastPkts++;                                        \
+        }                                                                                       \
+        else                                                                                    \
+        {                                                                                       \
+            ( pxInterface )->xCounters.ulInUcastPkts++;                                         \
+        }                                                                                       \
+    } while( ipFALSE_BOOL )
+
+    #define ipCOUNT_IF_OUTPUT( pxInterface, pxNetworkBuffer )                                    \
+    do {                                                                                         \
+        ( pxInterface )->xCounters.ulOutOctets += ( uint32_t ) ( pxNetworkBuffer )->xDataLength; \
+        if( ( ( pxNetworkBuffer )->pucEthernetBuffer[ 0 ] & 0x01U ) != 0U )                      \
+        {                                                                                        \
+            ( pxInterface )->xCounters.ulOutNUcastPkts++;                                        \
+        }                                                                                        \
+        else                                                                                     \
+        {                                                                                        \
+            ( pxInterface )->xCounters.ulOutUcastPkts++;                                         \
+        }                                                                                        \
+    } while( ipFALSE_BOOL )
+
+/** @brief Increment an IF-MIB counter of an interface, e.g. ipCOUNT_IF( pxInterface, ulInErrors ). */
+    #define ipCOUNT_IF( pxInterface, xField )    ( ( ( pxInterface )->xCounters.xField )++ )
+
+/** @brief Count a checksum failure of a transport protocol. */
+    #define ipCOUNT_CHECKSUM_ERROR( ucProtocol )    vIPCountChecksumError( ucProtocol )
+
+/**
+ * @brief Count a checksum failure of a transport protocol.
+ */
+    void vIPCountChecksumError( uint8_t ucProtocol );
+
+/**
+ * @brief Take a consistent copy of the protocol counters.
+ */
+    void vGetIPCounters( IPCounters_t * pxCounters );
+
+/**
+ * @brief Take a consistent copy of the counters of a network interface.
+ */
+    void vGetInterfaceCounters( const struct xNetworkInterface * pxInterface,
+                                IfCounters_t * pxCounters );
+
+#else /* if ( ipconfigUSE_IP_COUNTERS != 0 ) */
+
+    #define ipCOUNT( xField )                                   do {} while( ipFALSE_BOOL )
+    #define ipUNCOUNT( xField )                                 do {} while( ipFALSE_BOOL )
+    #define ipCOUNT_IF_INPUT( pxInterface, pxNetworkBuffer )    do {} while( ipFALSE_BOOL )
+    #define ipCOUNT_IF_OUTPUT( pxInterface, pxNetworkBuffer )   do {} while( ipFALSE_BOOL )
+    #define ipCOUNT_IF( pxInterface, xField )                   do {} while( ipFALSE_BOOL )
+    #define ipCOUNT_CHECKSUM_ERROR( ucProtocol )                do {} while( ipFALSE_BOOL )
+
+#endif /* ipconfigUSE_IP_COUNTERS */
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    } /* extern "C" */
+#endif
+/* *INDENT-ON* */
+
+#endif /* FREERTOS_IP_COUNTERS_H */
@@ -87,6 +87,19 @@ typedef enum
     eSocketSetDeleteEvent /*13: A socket set must be deleted. */
 } eIPEvent_t;
 
+#if ( ipconfigUSE_EVENT_LANES != 0 )
+
+/* The queues through which events reach the IP-task, in order of priority.
+ * See ipconfigUSE_EVENT_LANES. */
+    typedef enum
+    {
+        eIPLaneControl = 0, /* API calls, network-down, DHCP and ARP timer events. */
+        eIPLaneTransmit,    /* Packets to be sent and TCP timer events. */
+        eIPLaneBulk,        /* Packets received by the drivers, the queue 'xNetworkEventQueue'. */
+        eIPLaneCount
+    } eIPEventLane_t;
+#endif /* ipconfigUSE_EVENT_LANES */
+
 /**
  * Structure to hold the information about the Network parameters.
  */
@@ -516,6 +529,11 @@ BaseType_t xIPIsNetworkTaskReady( void );
  *    that called FreeRTOS_accept().
  * 3. When the socket is picked up by the task that called FreeRTOS_accept, the bPassAccept
  *    is cleared.
+ *
+ * With TCP Fast Open, a child socket that accepted data from the SYN is passed to accept()
+ * before the handshake is complete. bPassAccept and bPassEarly are set, and bPassQueued
+ * stays set, so that vTCPStateChange() still notifies the listening socket once the
+ * connection is established. Such a socket is not an orphan anymore.
  */
 
 /**
@@ -539,6 +557,26 @@ BaseType_t xIPIsNetworkTaskReady( void );
         } u; /**< The structure to give an alignment of 4 + 2 */
     } LastTCPPacket_t;
 
+    #if ( ipconfigUSE_TCP_FAST_OPEN == 1 )
+
+/** @brief The longest TFO cookie that will be stored, RFC 7413 allows 4 to 16 bytes. */
+        #define tcpTFO_COOKIE_MAX_LENGTH    16U
+
+/**
+ * The TCP Fast Open state of a TCP socket, see FreeRTOS_TCP_FastOpen.c.
+ */
+        typedef struct xTCP_FAST_OPEN
+        {
+            uint8_t
+                bEnabled : 1,                             /**< The socket option FREERTOS_SO_TCP_FASTOPEN was set. */
+                bOptionSeen : 1,                          /**< The last SYN or SYN+ACK received had a TFO option. */
+                bOptionSent : 1;                          /**< Client: the SYN being answered had a TFO option. */
+            uint8_t ucCookieLength;                       /**< The length of ucCookie, zero for a cookie request. */
+            uint8_t ucCookie[ tcpTFO_COOKIE_MAX_LENGTH ]; /**< The cookie from the last SYN or SYN+ACK received. */
+            uint16_t usSynDataLength;                     /**< Client: bytes sent along with the SYN. Server: bytes accepted from the SYN. */
+        } TCPFastOpen_t;
+    #endif /* ipconfigUSE_TCP_FAST_OPEN */
+
 /**
  * Note that the values of all short and long integers in these structs
  * are being stored in the native-endian way
@@ -556,6 +594,7 @@ BaseType_t xIPIsNetworkTaskReady( void );
                 bMssChange : 1,        /**< This socket has seen a change in MSS */
                 bPassAccept : 1,       /**< See comment here above. */
                 bPassQueued : 1,       /**< See comment here above. */
+                bPassEarly : 1,        /**< See comment here above. */
                 bReuseSocket : 1,      /**< When a listening socket gets a connection, do not create a new instance but keep on using it */
                 bCloseAfterSend : 1,   /**< As soon as the last byte has been transmitted, finalise the connection
                                         * Useful in e.g. FTP connections, where the last data bytes are sent along with the FIN flag */
@@ -604,6 +643,9 @@ BaseType_t xIPIsNetworkTaskReady( void );
         #if ( ipconfigUSE_TCP_WIN == 1 )
             NetworkBufferDescriptor_t * pxAckMessage; /**< The pointer to the ACK message */
         #endif /* ipconfigUSE_TCP_WIN */
+        #if ( ipconfigUSE_TCP_FAST_OPEN == 1 )
+            TCPFastOpen_t xFastOpen;                  /**< The TCP Fast Open state. */
+        #endif /* ipconfigUSE_TCP_FAST_OPEN */
         LastTCPPacket_t xPacket;                      /**< Buffer space to store the last TCP header received. */
         uint8_t tcpflags;                             /**< TCP flags */
         #if ( ipconfigUSE_TCP_WIN != 0 )
@@ -726,6 +768,14 @@ struct xSOCKET
  */
     void vSocketCloseNextTime( FreeRTOS_Socket_t * pxSocket );
 
+    #if ( ipconfigUSE_IP_COUNTERS != 0 )
+
+/*
+ * Update ulTcpCurrEstab for a socket that the IP-task is about to close.
+ */
+        void vTCPCountSocketClose( const FreeRTOS_Socket_t * pxSocket );
+    #endif
+
 /*
  * Postpone a call to listen() by the IP-task.
  */
@@ -829,6 +879,28 @@ BaseType_t xSendEventToIPTask( eIPEvent_t eEvent );
 BaseType_t xSendEventStructToIPTask( const IPStackEvent_t * pxEvent,
                                      TickType_t uxTimeout );
 
+/*
+ * The same as above, to be called from an ISR. The event is never dropped
+ * silently: pdFAIL is returned when the queue is full.
+ */
+BaseType_t xSendEventStructToIPTaskFromISR( const IPStackEvent_t * pxEvent,
+                                            BaseType_t * pxHigherPriorityTaskWoken );
+
+/*
+ * Returns the number of events waiting to be processed by the IP-task.
+ */
+UBaseType_t uxIPEventsWaiting( void );
+
+#if ( ipconfigUSE_RX_ADMISSION != 0 )
+
+/*
+ * Called by the IP-task when a TCP socket is bound to, or unbound from, a
+ * port ( in network byte order ), see xNetworkInterfaceRxAdmit().
+ */
+    void vRxAdmissionSetPort( uint16_t usPort,
+                              BaseType_t xBound );
+#endif
+
 /*
  * Returns a pointer to the original NetworkBuffer from a pointer to a UDP
  * payload buffer.
@@ -881,6 +953,10 @@ BaseType_t xIsCallingFromIPTask( void );
 /* Send the network-up event and start the ARP timer. */
 void vIPNetworkUpCalls( struct xNetworkEndPoint * pxEndPoint );
 
+/* Handle the 'eNetworkTxEvent': forward a packet from an application to the NIC. */
+void vIPForwardTxPacket( NetworkBufferDescriptor_t * pxNetworkBuffer,
+                         BaseType_t xReleaseAfterSend );
+
 /* Mark whether all interfaces are up or at least one interface is down. */
 void vSetAllNetworksUp( BaseType_t xIsAllNetworksUp );
 
@@ -128,6 +128,23 @@ void vTCPTimerReload( TickType_t xTime );
                               TickType_t uxClockTicks );
 #endif /* ( ipconfigUSE_DHCP == 1 ) || ( ipconfigUSE_RA == 1 ) */
 
+#if ( ipconfigUSE_RA == 1 )
+
+/**
+ * @brief Enable/disable the timer of the RA/SLAAC state machine.
+ * @param[in] pxEndPoint: The end-point for which the timer will be called.
+ * @param[in] xEnableState: pdTRUE - enable timer; pdFALSE - disable timer.
+ */
+    void vIPSetRATimerEnableState( NetworkEndPoint_t * pxEndPoint,
+                                   BaseType_t xEnableState );
+
+/**
+ * Sets the reload time of the RA/SLAAC timer and restarts it.
+ */
+    void vRATimerReload( NetworkEndPoint_t * pxEndPoint,
+                         TickType_t uxClockTicks );
+#endif /* ( ipconfigUSE_RA == 1 ) */
+
 #if ( ipconfigDNS_USE_CALLBACKS != 0 )
 
 /**
@@ -136,6 +153,22 @@ void vTCPTimerReload( TickType_t xTime );
     void vDNSTimerReload( uint32_t ulCheckTime );
 #endif /* ipconfigDNS_USE_CALLBACKS != 0 */
 
+#if ( ipconfigUSE_BONDING != 0 )
+
+/**
+ * Sets the reload time of the bonding timer and restarts it.
+ */
+    void vBondingTimerReload( TickType_t xTime );
+#endif /* ipconfigUSE_BONDING != 0 */
+
+#if ( ipconfigUSE_BRIDGE != 0 )
+
+/**
+ * Sets the reload time of the bridge timer and restarts it.
+ */
+    void vBridgeTimerReload( TickType_t xTime );
+#endif /* ipconfigUSE_BRIDGE != 0 */
+
 /**
  * Reload the Network timer.
  */
@@ -178,6 +178,41 @@
                                            size_t uxPrefixLength,
                                            BaseType_t xDoRandom );
 
+    #if ( ipconfigRA_STABLE_PRIVACY_ADDRESS != 0 )
+
+/** @brief The number of bytes in the secret key used for stable privacy addresses. */
+        #define ndSTABLE_PRIVACY_KEY_LENGTH    16U
+
+/**
+ * @brief Create a stable privacy IPv6 address ( RFC 7217 ), based on a prefix.
+ *
+ * @param[out] pxIPAddress: The location where the new IPv6 address
+ *                          will be stored.
+ * @param[in] pxPrefix: The prefix to be used.
+ * @param[in] uxPrefixLength: The length of the prefix.
+ * @param[in] pxEndPoint: The end-point that will use the address.
+ * @param[in] ucDADCounter: Incremented each time an address was found in use.
+ *
+ * @return pdPASS if the operation was successful. Or pdFAIL in
+ *         case xApplicationGetStablePrivacyKey() returned an error.
+ */
+        BaseType_t FreeRTOS_CreateStablePrivacyIPv6Address( IPv6_Address_t * pxIPAddress,
+                                                            const IPv6_Address_t * pxPrefix,
+                                                            size_t uxPrefixLength,
+                                                            const NetworkEndPoint_t * pxEndPoint,
+                                                            uint8_t ucDADCounter );
+
+/**
+ * @brief The application must provide a secret key of 'uxLength' bytes
+ *        ( ndSTABLE_PRIVACY_KEY_LENGTH ). It shall be random, and it shall
+ *        remain the same across reboots, e.g. stored in flash.
+ *
+ * @return pdPASS when the key was provided, pdFAIL otherwise.
+ */
+        BaseType_t xApplicationGetStablePrivacyKey( uint8_t * pucKey,
+                                                    size_t uxLength );
+    #endif /* ( ipconfigRA_STABLE_PRIVACY_ADDRESS != 0 ) */
+
 /* Receive a Neighbour Advertisement. */
 
     #if ( ipconfigUSE_RA != 0 )
@@ -0,0 +1,175 @@
+/*
+ * FreeRTOS+TCP <DEVELOPMENT BRANCH>
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+#ifndef FREERTOS_PACKET_SOCKET_H
+#define FREERTOS_PACKET_SOCKET_H
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+#include "FreeRTOS.h"
+#include "list.h"
+#include "queue.h"
+
+#include "FreeRTOS_Routing.h"
+
+#if ( ipconfigUSE_PACKET_SOCKETS != 0 )
+
+/** @brief Bind a packet socket to every EtherType that the IP-stack does not handle. */
+    #define packetETHER_TYPE_ANY    ( ( uint16_t ) 0x0000U )
+
+/** @brief One instruction of a packet filter. It has the layout and encoding
+ *         of a classic BPF instruction ( struct sock_filter ), so a program
+ *         produced by "tcpdump -dd" can be used as is. */
+    typedef struct xPACKET_FILTER_INSTRUCTION
+    {
+        uint16_t usCode;     /**< Instruction class, size, mode and operation. */
+        uint8_t ucJumpTrue;  /**< Conditional jumps: the offset when true. */
+        uint8_t ucJumpFalse; /**< Conditional jumps: the offset when false. */
+        uint32_t ulK;        /**< The constant operand. */
+    } PacketFilterInstruction_t;
+
+    struct xPACKET_SOCKET;
+
+/** @brief Called by the task that delivers a frame, which is either a driver
+ *         task or the IP-task. Return pdTRUE to take the ownership of the
+ *         network buffer, pdFALSE to have it queued for FreeRTOS_PacketRecv(). */
+    typedef BaseType_t (* FOnPacketReceive_t)( struct xPACKET_SOCKET * pxSocket,
+                                               NetworkBufferDescriptor_t * pxDescriptor );
+
+/** @brief A socket that sends and receives whole Ethernet frames of one
+ *         EtherType. The object must remain to exist while the socket is open. */
+    typedef struct xPACKET_SOCKET
+    {
+        ListItem_t xListItem;                       /**< Links the socket into the list of open packet sockets. */
+        NetworkInterface_t * pxInterface;           /**< The interface, or NULL for all interfaces. */
+        uint16_t usEtherType;                       /**< The EtherType in network byte order, or packetETHER_TYPE_ANY. */
+        QueueHandle_t xRxQueue;                     /**< The received network buffers. */
+        const PacketFilterInstruction_t * pxFilter; /**< The optional filter program. */
+        size_t uxFilterLength;                      /**< The number of instructions in 'pxFilter'. */
+        FOnPacketReceive_t pxHandleReceive;         /**< The optional receive handler. */
+        uint32_t ulReceived;                        /**< The number of frames delivered to the socket. */
+        uint32_t ulDropped;                         /**< The number of frames lost because the queue was full. */
+    } PacketSocket_t;
+
+/*
+ * Open a packet socket that receives the frames with EtherType 'usEtherType'
+ * ( in host byte order ) from 'pxInterface', or from all interfaces when it is
+ * NULL. The EtherTypes of ARP, IPv4 and IPv6 belong to the IP-stack and can
+ * not be bound. Up to 'uxQueueLength' frames are queued. Returns pdPASS when
+ * the socket was opened.
+ */
+    BaseType_t FreeRTOS_PacketOpen( PacketSocket_t * pxSocket,
+                                    NetworkInterface_t * pxInterface,
+                                    uint16_t usEtherType,
+                                    UBaseType_t uxQueueLength );
+
+/*
+ * Close a packet socket, and release the network buffers that are still
+ * queued. It must not be called from a receive handler.
+ */
+    void FreeRTOS_PacketClose( PacketSocket_t * pxSocket );
+
+/*
+ * Attach a classic BPF program to a packet socket, or remove it when
+ * 'pxFilter' is NULL. A frame is accepted when the program returns a non-zero
+ * value. The program is checked first, and it must remain to exist.
+ * Returns pdPASS when the program was accepted.
+ */
+    BaseType_t FreeRTOS_PacketSetFilter( PacketSocket_t * pxSocket,
+                                         const PacketFilterInstruction_t * pxFilter,
+                                         size_t uxLength );
+
+/*
+ * Install a handler that is called for every frame that passes the filter.
+ * The handler runs in the task that delivers the frame, and it must not
+ * block, nor open or close packet sockets. It is called while the mutex that
+ * protects the packet sockets is taken, which is not recursive: it must not
+ * call FreeRTOS_PacketSetFilter() or FreeRTOS_PacketSetReceiveHandler(),
+ * which would deadlock. When it calls FreeRTOS_PacketSend(), 'xTicksToWait'
+ * must be 0: in a driver task, a blocking send can wait for an IP-task that
+ * is waiting for the mutex.
+ */
+    void FreeRTOS_PacketSetReceiveHandler( PacketSocket_t * pxSocket,
+                                           FOnPacketReceive_t pxHandler );
+
+/*
+ * Wait at most 'xTicksToWait' for a frame. The network buffer is returned as
+ * it was received, without copying: the frame starts at 'pucEthernetBuffer'.
+ * The caller must release it with vReleaseNetworkBufferAndDescriptor().
+ * Returns NULL on a time-out.
+ */
+    NetworkBufferDescriptor_t * FreeRTOS_PacketRecv( PacketSocket_t * pxSocket,
+                                                     TickType_t xTicksToWait );
+
+/*
+ * Send a frame that was built by the caller, including its Ethernet header,
+ * through the interface of the socket. The network buffer is always passed
+ * on or released. Returns pdPASS when the frame was passed to the IP-task or
+ * to the driver.
+ */
+    BaseType_t FreeRTOS_PacketSend( PacketSocket_t * pxSocket,
+                                    NetworkBufferDescriptor_t * pxDescriptor,
+                                    TickType_t xTicksToWait );
+
+/*
+ * Offer a received frame to the packet sockets. 'pxInterface' of the buffer
+ * must be set. Returns pdTRUE when a socket took the buffer. The IP-task
+ * calls it for every frame that is not ARP, IPv4 or IPv6, after the bonding
+ * and bridge hooks.
+ */
+    BaseType_t xPacketSocketDeliver( NetworkBufferDescriptor_t * pxDescriptor );
+
+/*
+ * The same for a driver, which may call it in its receive task before the
+ * frame is sent to the IP-task, so that the frames of a packet socket bypass
+ * the IP-task. Frames of a bond member or a bridge port are not delivered
+ * here, they must pass the bonding and bridge hooks in the IP-task first.
+ */
+    BaseType_t xPacketSocketDriverDeliver( NetworkBufferDescriptor_t * pxDescriptor );
+
+/*
+ * Run a classic BPF program on a frame. Returns the value of the return
+ * instruction, zero means that the frame is rejected.
+ */
+    uint32_t ulPacketFilterRun( const PacketFilterInstruction_t * pxFilter,
+                                size_t uxLength,
+                                const uint8_t * pucFrame,
+                                size_t uxFrameLength );
+
+#endif /* ( ipconfigUSE_PACKET_SOCKETS != 0 ) */
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    } /* extern "C" */
+#endif
+/* *INDENT-ON* */
+
+#endif /* FREERTOS_PACKET_SOCKET_H */
@@ -28,6 +28,7 @@
 
     #include "FreeRTOS.h"
     #include "FreeRTOS_IP.h"
+    #include "FreeRTOS_IP_Counters.h"
 
     #if ( ipconfigUSE_DHCP != 0 )
         #include "FreeRTOS_DHCP.h"
@@ -55,6 +56,20 @@
     typedef BaseType_t ( * GetPhyLinkStatusFunction_t ) ( struct xNetworkInterface * pxDescriptor );
 
 /** @brief These NetworkInterface access functions are collected in a struct: */
+    #if ( ipconfigUSE_RX_ADMISSION != 0 )
+
+/** @brief The RX admission state and drop counters of an interface, see ipconfigUSE_RX_ADMISSION. */
+        typedef struct xRX_ADMISSION
+        {
+            TickType_t xPeriodStart;  /**< The time at which the current quota period started. */
+            uint32_t ulPeriodPackets; /**< The number of frames admitted in the current period. */
+            uint32_t ulPeriodBytes;   /**< The number of bytes admitted in the current period. */
+            uint32_t ulAdmitted;      /**< The total number of frames admitted. */
+            uint32_t ulDroppedQuota;  /**< Frames dropped because the quota was used. */
+            uint32_t ulDroppedQueue;  /**< Frames dropped because the IP-task event queue was too full. */
+        } RxAdmission_t;
+    #endif /* ipconfigUSE_RX_ADMISSION */
+
     typedef struct xNetworkInterface
     {
         const char * pcName;                               /**< Just for logging, debugging. */
@@ -66,11 +81,24 @@
         {
             uint32_t
                 bInterfaceUp : 1,             /**< Non-zero as soon as the interface is up. */
-                bCallDownEvent : 1;           /**< The down-event must be called. */
+                bCallDownEvent : 1,           /**< The down-event must be called. */
+                bIsLoopback : 1;              /**< Packets sent to this interface are received by this host, see ipconfigUSE_LOOPBACK_FAST_PATH. */
         } bits;                               /**< A collection of boolean flags. */
 
         struct xNetworkEndPoint * pxEndPoint; /**< A list of end-points bound to this interface. */
         struct xNetworkInterface * pxNext;    /**< The next interface in a linked list. */
+        #if ( ipconfigUSE_RX_ADMISSION != 0 )
+            RxAdmission_t xRxAdmission;       /**< The RX admission state, see xNetworkInterfaceRxAdmit(). */
+        #endif
+        #if ( ipconfigUSE_IP_COUNTERS != 0 )
+            IfCounters_t xCounters;           /**< The IF-MIB counters, see vGetInterfaceCounters(). */
+        #endif
+        #if ( ipconfigUSE_BONDING != 0 )
+            struct xNetworkInterface * pxBondMaster; /**< The bond of which this interface is a member, or NULL. */
+        #endif
+        #if ( ipconfigUSE_BRIDGE != 0 )
+            struct xNetworkInterface * pxBridge; /**< The bridge of which this interface is a port, or NULL. */
+        #endif
     } NetworkInterface_t;
 
 /*
@@ -126,11 +154,28 @@
             {
                 uint32_t
                     bRouterReplied : 1,
-                    bIPAddressInUse : 1;
+                #if ( ipconfigRA_CACHE_PREFIX != 0 )
+                    bPrefixCached : 1, /**< The fields 'xCached...' contain valid data. */
+                #endif
+                #if ( ipconfigRA_OPTIMISTIC_DAD != 0 )
+                    bOptimistic : 1,   /**< The end-point is up while its address is still being tested. */
+                #endif
+                bIPAddressInUse : 1;
             }
             bits;
             TickType_t ulPreferredLifeTime;
             UBaseType_t uxRetryCount;
+            #if ( ipconfigRA_STABLE_PRIVACY_ADDRESS != 0 )
+                uint8_t ucDADCounter; /**< RFC 7217: incremented each time a chosen address turns out to be in use. */
+            #endif
+            #if ( ipconfigRA_CACHE_PREFIX != 0 )
+                IPv6_Address_t xCachedPrefix;    /**< The prefix from the last Router Advertisement. */
+                IPv6_Address_t xCachedGateway;   /**< The router that sent the last advertisement. */
+                IPv6_Address_t xCachedAddress;   /**< The address that was obtained with that prefix. */
+                size_t uxCachedPrefixLength;     /**< The length of 'xCachedPrefix' in bits. */
+                TickType_t xCachedTime;          /**< The time at which the advertisement was received. */
+                uint32_t ulCachedLifeTime;       /**< The preferred life-time of the prefix, in seconds. */
+            #endif
             /* Maintains the RA state machine state. */
             eRAState_t eRAState;
         };
@@ -180,6 +225,9 @@
         #if ( ipconfigUSE_RA != 0 )
             RAData_t xRAData;                    /**< A description of the Router Advertisement ( RA ) client state machine. */
         #endif /* ( ipconfigUSE_RA != 0 ) */
+        #if ( ipconfigRA_PARALLEL_DHCPv6 != 0 )
+            IPTimer_t xRATimer; /**< RA has its own timer so it can run at the same time as DHCPv6. */
+        #endif /* ( ipconfigRA_PARALLEL_DHCPv6 != 0 ) */
         NetworkInterface_t * pxNetworkInterface; /**< The network interface that owns this end-point. */
         struct xNetworkEndPoint * pxNext;        /**< The next end-point in the chain. */
     } NetworkEndPoint_t;
@@ -190,6 +238,33 @@
     #define ENDPOINT_IS_IPv4( pxEndPoint )       ( ( ( pxEndPoint ) != NULL ) && ( ( pxEndPoint )->bits.bIPv6 == 0U ) )
     #define ENDPOINT_IS_IPv6( pxEndPoint )       ( ( ( pxEndPoint ) != NULL ) && ( ( pxEndPoint )->bits.bIPv6 != 0U ) )
 
+    #if ( ipconfigUSE_LOOPBACK_FAST_PATH != 0 )
+        #define INTERFACE_IS_LOOPBACK( pxInterface )    ( ( ( pxInterface ) != NULL ) && ( ( pxInterface )->bits.bIsLoopback != 0U ) )
+        #define ENDPOINT_IS_LOOPBACK( pxEndPoint )      ( ( ( pxEndPoint ) != NULL ) && INTERFACE_IS_LOOPBACK( ( pxEndPoint )->pxNetworkInterface ) )
+    #else
+        #define INTERFACE_IS_LOOPBACK( pxInterface )    ( pdFALSE )
+        #define ENDPOINT_IS_LOOPBACK( pxEndPoint )      ( pdFALSE )
+    #endif
+
+/* A member of a bond, or a port of a bridge, has no end-points of its own:
+ * it uses those of the bond or the bridge. */
+    #if ( ipconfigUSE_BONDING != 0 )
+        #define INTERFACE_BOND_MASTER( pxInterface ) \
+    ( ( ( ( pxInterface ) != NULL ) && ( ( pxInterface )->pxBondMaster != NULL ) ) ? ( pxInterface )->pxBondMaster : ( pxInterface ) )
+    #else
+        #define INTERFACE_BOND_MASTER( pxInterface )    ( pxInterface )
+    #endif
+
+    #if ( ipconfigUSE_BRIDGE != 0 )
+        #define INTERFACE_BRIDGE( pxInterface ) \
+    ( ( ( ( pxInterface ) != NULL ) && ( ( pxInterface )->pxBridge != NULL ) ) ? ( pxInterface )->pxBridge : ( pxInterface ) )
+    #else
+        #define INTERFACE_BRIDGE( pxInterface )    ( pxInterface )
+    #endif
+
+/* The interface that owns the end-points of 'pxInterface'. A bond may be a port of a bridge. */
+    #define INTERFACE_OWNER( pxInterface )    INTERFACE_BRIDGE( INTERFACE_BOND_MASTER( pxInterface ) )
+
 
 /*
  * Add a new physical Network Interface.  The object pointed to by 'pxInterface'
@@ -103,6 +103,7 @@
     #define FREERTOS_MSG_PEEK                ( 4 )  /* Can be used with recvfrom() and recv(). */
     #define FREERTOS_MSG_DONTROUTE           ( 8 )  /* Not used. */
     #define FREERTOS_MSG_DONTWAIT            ( 16 ) /* Can be used with recvfrom(), sendto(), recv() and send(). */
+    #define FREERTOS_MSG_MORE                ( 32 ) /* Can be used with send(): more data will follow, see ipconfigUSE_TCP_NAGLE. */
 
 /* Values that can be passed in the option name parameter of calls to
  * FreeRTOS_setsockopt(). */
@@ -150,6 +151,15 @@
     #if ( ipconfigUSE_TCP == 1 )
         #define FREERTOS_SO_SET_LOW_HIGH_WATER            ( 18 )
     #endif
+
+    #if ( ipconfigUSE_TCP_NAGLE == 1 )
+        #define FREERTOS_SO_TCP_NODELAY                   ( 19 ) /* Disable Nagle's algorithm, send small segments immediately. */
+        #define FREERTOS_SO_TCP_CORK                      ( 20 ) /* Only send full-size segments, until the option is cleared. */
+    #endif
+
+    #if ( ipconfigUSE_TCP_FAST_OPEN == 1 )
+        #define FREERTOS_SO_TCP_FASTOPEN                  ( 21 ) /* Use TCP Fast Open, for a listening or a connecting socket. */
+    #endif
     #define FREERTOS_INADDR_ANY                           ( 0U ) /* The 0.0.0.0 IPv4 address. */
 
     #if ( 0 )                                                    /* Not Used */
@@ -311,6 +321,15 @@
                                      const struct freertos_sockaddr * pxAddress,
                                      socklen_t xAddressLength );
 
+        #if ( ipconfigUSE_TCP_FAST_OPEN == 1 )
+/* Connect a TCP socket and send data in the SYN packet, see ipconfigUSE_TCP_FAST_OPEN. */
+            BaseType_t FreeRTOS_connect_data( Socket_t xClientSocket,
+                                              const struct freertos_sockaddr * pxAddress,
+                                              socklen_t xAddressLength,
+                                              const void * pvBuffer,
+                                              size_t uxDataLength );
+        #endif
+
 /* Places a TCP socket into a state where it is listening for and can accept
  * incoming connection requests from remote sockets. */
         BaseType_t FreeRTOS_listen( Socket_t xSocket,
@@ -0,0 +1,91 @@
+/*
+ * FreeRTOS+TCP <DEVELOPMENT BRANCH>
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+#ifndef FREERTOS_TCP_FAST_OPEN_H
+#define FREERTOS_TCP_FAST_OPEN_H
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+#if ( ipconfigUSE_TCP_FAST_OPEN == 1 )
+
+/*
+ * Called from prvCheckOptions(). Remember the TFO option found in a SYN or
+ * a SYN+ACK. 'ucLength' is the length of the option, including the type and
+ * length bytes.
+ */
+    void vTCPFastOpenReadOption( FreeRTOS_Socket_t * pxSocket,
+                                 const uint8_t * pucPtr,
+                                 uint8_t ucLength );
+
+/*
+ * Called from prvTCPHandleState() in the state eSYN_FIRST, after the options
+ * of the SYN+ACK have been set. Accept the data of a SYN with a valid cookie,
+ * or add a new cookie to the SYN+ACK. Returns the new length of the options.
+ */
+    UBaseType_t uxTCPFastOpenHandleSyn( FreeRTOS_Socket_t * pxSocket,
+                                        NetworkBufferDescriptor_t ** ppxNetworkBuffer,
+                                        const uint8_t * pucRecvData,
+                                        uint32_t ulReceiveLength,
+                                        UBaseType_t uxOptionsLength );
+
+/*
+ * Called from prvTCPSendPacket() before a SYN is sent. When the SYN may carry
+ * data, a network buffer is returned that holds the headers. Otherwise NULL
+ * is returned, and the SYN will be sent from the socket field 'xPacket'.
+ */
+    NetworkBufferDescriptor_t * pxTCPFastOpenGetSynBuffer( FreeRTOS_Socket_t * pxSocket );
+
+/*
+ * Called from prvTCPSendPacket() after the options of a SYN have been set.
+ * Add the TFO option and the data, if any. Returns the new length of the
+ * options. The number of data bytes is stored in 'xFastOpen.usSynDataLength'.
+ */
+    UBaseType_t uxTCPFastOpenSynOptions( FreeRTOS_Socket_t * pxSocket,
+                                         TCPHeader_t * pxTCPHeader,
+                                         UBaseType_t uxOptionsLength );
+
+/*
+ * Called from prvHandleSynReceived() when a SYN+ACK has been received by a
+ * connecting socket. Store the cookie, or remember that the peer does not
+ * do TFO, and release the data that was acknowledged along with the SYN.
+ */
+    void vTCPFastOpenSynAckReceived( FreeRTOS_Socket_t * pxSocket,
+                                     uint32_t ulAckNumber );
+
+#endif /* ipconfigUSE_TCP_FAST_OPEN */
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    } /* extern "C" */
+#endif
+/* *INDENT-ON* */
+
+#endif /* FREERTOS_TCP_FAST_OPEN_H */
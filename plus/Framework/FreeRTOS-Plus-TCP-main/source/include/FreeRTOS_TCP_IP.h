@@ -103,6 +103,7 @@ typedef enum eTCP_STATE
 #define tcpTCP_OPT_SACK_P            4U                  /**< Advertise that SACK is permitted. */
 #define tcpTCP_OPT_SACK_A            5U                  /**< SACK option with first/last. */
 #define tcpTCP_OPT_TIMESTAMP         8U                  /**< Time-stamp option. */
+#define tcpTCP_OPT_FASTOPEN          34U                 /**< TCP Fast Open cookie option ( RFC 7413 ). */
 
 
 #define tcpTCP_OPT_MSS_LEN           4U                  /**< Length of TCP MSS option. */
@@ -105,6 +105,15 @@ typedef struct xTCP_WINDOW
         } bits;                    /**< party which opens the connection */
         uint32_t ulFlags;
     } u;                           /**< A collection of boolean flags. */
+    #if ( ipconfigUSE_TCP_NAGLE == 1 )
+        struct
+        {
+            uint8_t
+                bNoDelay : 1,      /**< FREERTOS_SO_TCP_NODELAY: do not use Nagle's algorithm */
+                bCork : 1,         /**< FREERTOS_SO_TCP_CORK: only send segments with a size equal to MSS */
+                bMore : 1;         /**< The last call to FreeRTOS_send() had the flag FREERTOS_MSG_MORE */
+        } xCoalesce;               /**< Options for coalescing small writes, these are not cleared by vTCPWindowInit(). */
+    #endif
     TCPWinSize_t xSize;            /**< The TCP window sizes of the incoming and outgoing streams. */
     struct
     {
@@ -205,6 +205,21 @@
 
 /*---------------------------------------------------------------------------*/
 
+/*
+ * iptraceEVENT_LANE_RECEIVED
+ *
+ * Called by the IP-task when ipconfigUSE_EVENT_LANES is enabled, each time
+ * an event is taken from a lane. xLane is an eIPEventLane_t, xTicksWaited is
+ * the number of clock ticks between posting and receiving the event: the
+ * queueing latency of the lane. It is always zero for the bulk lane, whose
+ * events carry no time stamp.
+ */
+#ifndef iptraceEVENT_LANE_RECEIVED
+    #define iptraceEVENT_LANE_RECEIVED( xLane, xTicksWaited )
+#endif
+
+/*---------------------------------------------------------------------------*/
+
 /*===========================================================================*/
 /*                           NETWORK TRACE MACROS                            */
 /*===========================================================================*/
@@ -851,5 +866,66 @@
 /*===========================================================================*/
 /*---------------------------------------------------------------------------*/
 /*===========================================================================*/
+/*---------------------------------------------------------------------------*/
+/*===========================================================================*/
+/*                          DEADLINE MONITOR MACROS                          */
+/*===========================================================================*/
+
+/*-----------------------------------------------------------------------*/
+
+/*
+ * iptraceIP_TASK_LOOP_START
+ *
+ * Called by the IP-task as soon as it has woken up, either because of an
+ * event ( eEvent ) or because of a time-out ( eNoEvent ). The IP-task is busy
+ * until iptraceIP_TASK_LOOP_END() is called. See
+ * tools/tcp_utilities/deadline_monitor.md
+ */
+#ifndef iptraceIP_TASK_LOOP_START
+    #define iptraceIP_TASK_LOOP_START( eEvent )
+#endif
+
+/*-----------------------------------------------------------------------*/
+
+/*
+ * iptraceIP_TASK_LOOP_END
+ *
+ * Called by the IP-task just before it blocks on its event queue.
+ */
+#ifndef iptraceIP_TASK_LOOP_END
+    #define iptraceIP_TASK_LOOP_END()
+#endif
+
+/*-----------------------------------------------------------------------*/
+
+/*
+ * iptraceEMAC_TASK_LOOP_START
+ *
+ * Called by the handler task of a network driver when it has woken up to
+ * handle the events of EMAC number xEMACIndex.
+ */
+#ifndef iptraceEMAC_TASK_LOOP_START
+    #define iptraceEMAC_TASK_LOOP_START( xEMACIndex )
+#endif
+
+/*-----------------------------------------------------------------------*/
+
+/*
+ * iptraceEMAC_TASK_LOOP_END
+ *
+ * Called by the handler task of a network driver when it has handled all
+ * events of EMAC number xEMACIndex, before it blocks again.
+ */
+#ifndef iptraceEMAC_TASK_LOOP_END
+    #define iptraceEMAC_TASK_LOOP_END( xEMACIndex )
+#endif
+
+/*-----------------------------------------------------------------------*/
+
+/*===========================================================================*/
+/*                          DEADLINE MONITOR MACROS                          */
+/*===========================================================================*/
+/*---------------------------------------------------------------------------*/
+/*===========================================================================*/
 
 #endif /* IP_TRACE_MACRO_DEFAULTS_H */
@@ -70,6 +70,52 @@ NetworkBufferDescriptor_t * pxDuplicateNetworkBufferWithDescriptor( const Networ
 NetworkBufferDescriptor_t * pxResizeNetworkBufferWithDescriptor( NetworkBufferDescriptor_t * pxNetworkBuffer,
                                                                  size_t xNewSizeBytes );
 
+/* The classes of network buffers, see ipconfigUSE_BUFFER_CLASSES. */
+typedef enum eNETWORK_BUFFER_CLASS
+{
+    eBufferClassNone = 0, /**< Not accounted, obtained with pxGetNetworkBufferWithDescriptor(). */
+    eBufferClassRX,       /**< Reception by a network driver. */
+    eBufferClassTCP_TX,   /**< Transmission of TCP data. */
+    eBufferClassUDP_TX,   /**< Transmission of UDP messages by the application. */
+    eBufferClassControl,  /**< ARP, ICMP, ND, DHCP, DNS and empty TCP segments. */
+    eBufferClassCount
+} eNetworkBufferClass_t;
+
+#if ( ipconfigUSE_BUFFER_CLASSES != 0 )
+
+/* The accounting of a single buffer class. */
+    typedef struct xNETWORK_BUFFER_CLASS_STATS
+    {
+        UBaseType_t uxInUse;    /**< The number of buffers currently held. */
+        UBaseType_t uxMaxInUse; /**< The highest value of uxInUse. */
+        UBaseType_t uxReserve;  /**< The number of buffers guaranteed to this class. */
+        UBaseType_t uxLimit;    /**< The maximum number of buffers of this class. */
+        uint32_t ulGranted;     /**< The number of successful requests. */
+        uint32_t ulRefused;     /**< The number of requests refused by the admission control. */
+    } NetworkBufferClassStats_t;
+
+/* Obtain a network buffer for a class. Returns NULL without blocking when
+ * the class is not admitted. */
+    NetworkBufferDescriptor_t * pxGetNetworkBufferWithClass( size_t xRequestedSizeBytes,
+                                                             TickType_t xBlockTimeTicks,
+                                                             eNetworkBufferClass_t eClass );
+
+/* Check if a buffer of a class would be admitted now, without obtaining it.
+ * A network driver can use this to drop a packet early. */
+    BaseType_t xNetworkBufferClassAdmit( eNetworkBufferClass_t eClass );
+
+/* Called by the buffer allocation scheme when a buffer is released. */
+    void vNetworkBufferClassRelease( NetworkBufferDescriptor_t * const pxNetworkBuffer );
+
+/* Get a copy of the accounting of a class. */
+    void vGetNetworkBufferClassStats( eNetworkBufferClass_t eClass,
+                                      NetworkBufferClassStats_t * pxStats );
+#else
+    #define pxGetNetworkBufferWithClass( xRequestedSizeBytes, xBlockTimeTicks, eClass ) \
+    pxGetNetworkBufferWithDescriptor( xRequestedSizeBytes, xBlockTimeTicks )
+    #define xNetworkBufferClassAdmit( eClass )    ( pdTRUE )
+#endif /* ipconfigUSE_BUFFER_CLASSES */
+
 #if ipconfigTCP_IP_SANITY
 
 /*
@@ -52,6 +52,22 @@ void vNetworkInterfaceAllocateRAMToBuffers( NetworkBufferDescriptor_t pxNetworkB
 
 BaseType_t xGetPhyLinkStatus( struct xNetworkInterface * pxInterface );
 
+#if ( ipconfigUSE_RX_ADMISSION != 0 )
+
+/* Check if a received frame may be passed to the IP-task. To be called by
+ * the driver before it obtains a network buffer for the frame. Returns pdFALSE
+ * when the frame must be dropped, the drop is counted in the interface. */
+    BaseType_t xNetworkInterfaceRxAdmit( struct xNetworkInterface * pxInterface,
+                                         const uint8_t * pucEthernetBuffer,
+                                         size_t uxLength );
+
+/* Get a copy of the RX admission counters of an interface. */
+    void vNetworkInterfaceRxStats( const struct xNetworkInterface * pxInterface,
+                                   RxAdmission_t * pxStats );
+#else
+    #define xNetworkInterfaceRxAdmit( pxInterface, pucEthernetBuffer, uxLength )    ( pdTRUE )
+#endif /* ipconfigUSE_RX_ADMISSION */
+
 /* *INDENT-OFF* */
 #ifdef __cplusplus
     } /* extern "C" */
@@ -362,6 +362,10 @@ BaseType_t vNetworkBufferReleaseFromISR( NetworkBufferDescriptor_t * const pxNet
 {
     BaseType_t xHigherPriorityTaskWoken = pdFALSE;
 
+    #if ( ipconfigUSE_BUFFER_CLASSES != 0 )
+        vNetworkBufferClassRelease( pxNetworkBuffer );
+    #endif
+
     /* Ensure the buffer is returned to the list of free buffers before the
      * counting semaphore is 'given' to say a buffer is available. */
     ipconfigBUFFER_ALLOC_LOCK_FROM_ISR();
@@ -387,6 +391,11 @@ void vReleaseNetworkBufferAndDescriptor( NetworkBufferDescriptor_t * const pxNet
     }
     else
     {
+        #if ( ipconfigUSE_BUFFER_CLASSES != 0 )
+            /* A buffer that was released before has no class anymore. */
+            vNetworkBufferClassRelease( pxNetworkBuffer );
+        #endif
+
         /* Ensure the buffer is returned to the list of free buffers before the
          * counting semaphore is 'given' to say a buffer is available. */
         ipconfigBUFFER_ALLOC_LOCK();
@@ -82,8 +82,43 @@ const BaseType_t xBufferAllocFixedSize = pdFALSE;
 /* The semaphore used to obtain network buffers. */
 static SemaphoreHandle_t xNetworkBufferSemaphore = NULL;
 
+#if defined( ipNETWORK_BUFFER_NEEDS_DMA_REGION )
+
+/* Check that heap_6.c has a region from which pvPortMallocNetworkBuffer() can
+ * allocate. */
+    static BaseType_t prvHasDMARegion( void );
+#endif
+
 /*-----------------------------------------------------------*/
 
+#if defined( ipNETWORK_BUFFER_NEEDS_DMA_REGION )
+
+/**
+ * @brief Look for a heap region with the attribute portHEAP_ATTR_DMA.
+ *
+ * @return pdTRUE when such a region exists.
+ */
+    static BaseType_t prvHasDMARegion( void )
+    {
+        BaseType_t xIndex;
+        BaseType_t xReturn = pdFALSE;
+        uint32_t ulAttributes = 0U;
+        HeapStats_t xHeapStats;
+
+        for( xIndex = 0; xPortGetTaggedHeapStats( xIndex, &( ulAttributes ), &( xHeapStats ) ) != pdFAIL; xIndex++ )
+        {
+            if( ( ulAttributes & portHEAP_ATTR_DMA ) != 0U )
+            {
+                xReturn = pdTRUE;
+                break;
+            }
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+#endif /* ipNETWORK_BUFFER_NEEDS_DMA_REGION */
+
 BaseType_t xNetworkBuffersInitialise( void )
 {
     /* Declares the pool of NetworkBufferDescriptor_t structures that are available
@@ -156,6 +191,15 @@ BaseType_t xNetworkBuffersInitialise( void )
     {
         xReturn = pdFAIL;
     }
+
+    #if defined( ipNETWORK_BUFFER_NEEDS_DMA_REGION )
+        else if( prvHasDMARegion() == pdFALSE )
+        {
+            /* Every allocation of an Ethernet buffer would fail. */
+            FreeRTOS_printf( ( "xNetworkBuffersInitialise: ipconfigUSE_TAGGED_HEAP needs a heap region with portHEAP_ATTR_DMA\n" ) );
+            xReturn = pdFAIL;
+        }
+    #endif
     else
     {
         xReturn = pdPASS;
@@ -212,7 +256,7 @@ uint8_t * pucGetNetworkBuffer( size_t * pxRequestedSizeBytes )
         /* Allocate a buffer large enough to store the requested Ethernet frame size
          * and a pointer to a network buffer structure (hence the addition of
          * ipBUFFER_PADDING bytes). */
-        pucEthernetBuffer = ( uint8_t * ) pvPortMalloc( xAllocatedBytes );
+        pucEthernetBuffer = ( uint8_t * ) pvPortMallocNetworkBuffer( xAllocatedBytes );
         configASSERT( pucEthernetBuffer != NULL );
 
         if( pucEthernetBuffer != NULL )
@@ -245,7 +289,7 @@ void vReleaseNetworkBuffer( uint8_t * pucEthernetBuffer )
         /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-184. */
         /* coverity[misra_c_2012_rule_18_4_violation] */
         pucEthernetBufferCopy -= ipBUFFER_PADDING;
-        vPortFree( ( void * ) pucEthernetBufferCopy );
+        vPortFreeNetworkBuffer( ( void * ) pucEthernetBufferCopy );
     }
 }
 /*-----------------------------------------------------------*/
@@ -329,7 +373,7 @@ NetworkBufferDescriptor_t * pxGetNetworkBufferWithDescriptor( size_t xRequestedS
             {
                 /* Extra space is obtained so a pointer to the network buffer can
                  * be stored at the beginning of the buffer. */
-                pxReturn->pucEthernetBuffer = ( uint8_t * ) pvPortMalloc( xAllocatedBytes );
+                pxReturn->pucEthernetBuffer = ( uint8_t * ) pvPortMallocNetworkBuffer( xAllocatedBytes );
 
                 if( pxReturn->pucEthernetBuffer == NULL )
                 {
@@ -395,6 +439,11 @@ void vReleaseNetworkBufferAndDescriptor( NetworkBufferDescriptor_t * const pxNet
 {
     BaseType_t xListItemAlreadyInFreeList;
 
+    #if ( ipconfigUSE_BUFFER_CLASSES != 0 )
+        /* A buffer that was released before has no class anymore. */
+        vNetworkBufferClassRelease( pxNetworkBuffer );
+    #endif
+
     /* Ensure the buffer is returned to the list of free buffers before the
     * counting semaphore is 'given' to say a buffer is available.  Release the
     * storage allocated to the buffer payload.  THIS FILE SHOULD NOT BE USED
@@ -56,12 +56,12 @@
 /* The SAME70 family has the possibility of caching RAM.
  * 'NETWORK_BUFFERS_CACHED' can be defined in either "conf_eth.h"
  * or in "FreeRTOSIPConfig.h".
- * For now, NETWORK_BUFFERS_CACHED should be defined as zero.
+ * When NETWORK_BUFFERS_CACHED is non-zero, the network buffers may be located
+ * in cached RAM. The area of a buffer that is written by the DMA then starts
+ * at a cache line, see BUFFER_PADDING in gmac_SAM.h. After reception, only the
+ * lines that hold the frame will be invalidated.
  * D-cache may be enabled.
  */
-#if ( NETWORK_BUFFERS_CACHED != 0 )
-    #error please define this macro as zero
-#endif
 
 /* Interrupt events to process.  Currently only the Rx event is processed
  * although code for other events is included to allow for possible future
@@ -98,6 +98,22 @@
     #define niEMAC_HANDLER_TASK_PRIORITY    configMAX_PRIORITIES - 1
 #endif
 
+/* Received frames are passed to the IP-task in the buffer in which they were
+ * received. The empty RX descriptors get new buffers in batches, as soon as
+ * niEMAC_RX_REFILL_BATCH descriptors are empty, and also at the end of each
+ * poll. */
+#ifndef niEMAC_RX_REFILL_BATCH
+    #define niEMAC_RX_REFILL_BATCH    ( ( GMAC_RX_BUFFERS + 1U ) / 2U )
+#endif
+
+/* When niEMAC_RX_INTERRUPT_MODERATION is non-zero, the RX complete interrupt
+ * is disabled as soon as it fires. It will be enabled again when
+ * prvEMACHandlerTask() has emptied the RX descriptor ring. A burst of packets
+ * will therefore cause a single interrupt. */
+#ifndef niEMAC_RX_INTERRUPT_MODERATION
+    #define niEMAC_RX_INTERRUPT_MODERATION    1
+#endif
+
 #if ( NETWORK_BUFFERS_CACHED != 0 ) && ( __DCACHE_PRESENT != 0 ) && defined( CONF_BOARD_ENABLE_CACHE )
     #include "core_cm7.h"
 
@@ -106,7 +122,6 @@
     #endif
 
     #define     CACHE_LINE_SIZE               32
-    #define     NETWORK_BUFFER_HEADER_SIZE    ( ipconfigPACKET_FILLER_SIZE + 8 )
 
     static void cache_clean_invalidate()
     {
@@ -186,6 +201,11 @@ static BaseType_t prvGMACInit( NetworkInterface_t * pxInterface );
  */
 static uint32_t prvEMACRxPoll( void );
 
+/*
+ * Give new network buffers to the empty RX descriptors.
+ */
+static void prvEMACRxRefill( void );
+
 static BaseType_t prvSAM_NetworkInterfaceInitialise( NetworkInterface_t * pxInterface );
 static BaseType_t prvSAM_NetworkInterfaceOutput( NetworkInterface_t * pxInterface,
                                                  NetworkBufferDescriptor_t * const pxBuffer,
@@ -294,6 +314,13 @@ void xRxCallback( uint32_t ulStatus )
 {
     if( ( ( ulStatus & GMAC_RSR_REC ) != 0 ) && ( xEMACTaskHandle != NULL ) )
     {
+        #if ( niEMAC_RX_INTERRUPT_MODERATION != 0 )
+        {
+            /* prvEMACHandlerTask will enable it again when the RX ring is empty. */
+            gmac_disable_interrupt( GMAC, GMAC_IDR_RCOMP );
+        }
+        #endif
+
         /* let the prvEMACHandlerTask know that there was an RX event. */
         xTaskNotifyFromISR( xEMACTaskHandle, EMAC_IF_RX_EVENT, eSetBits, &( xGMACSwitchRequired ) );
     }
@@ -631,8 +658,9 @@ static BaseType_t prvSAM_NetworkInterfaceOutput( NetworkInterface_t * pxInterfac
 
         #if ( NETWORK_BUFFERS_CACHED != 0 )
         {
-            uint32_t xlength = CACHE_LINE_SIZE * ( ( ulTransmitSize + NETWORK_BUFFER_HEADER_SIZE + CACHE_LINE_SIZE - 1 ) / CACHE_LINE_SIZE );
-            uint32_t xAddress = ( uint32_t ) ( pxDescriptor->pucEthernetBuffer - NETWORK_BUFFER_HEADER_SIZE );
+            /* Clean the lines that will be read by the DMA. */
+            uint32_t xAddress = ( ( uint32_t ) pxDescriptor->pucEthernetBuffer ) & ~( CACHE_LINE_SIZE - 1U );
+            uint32_t xlength = ( ( uint32_t ) pxDescriptor->pucEthernetBuffer ) + ulTransmitSize - xAddress;
             cache_clean_invalidate_by_addr( xAddress, xlength );
         }
         #endif
@@ -957,39 +985,36 @@ void vGMACGenerateChecksum( uint8_t * pucBuffer,
 
 static uint32_t prvEMACRxPoll( void )
 {
-    unsigned char * pucUseBuffer;
     uint32_t ulReceiveCount, ulResult, ulReturnValue = 0;
-    static NetworkBufferDescriptor_t * pxNextNetworkBufferDescriptor = NULL;
-    const UBaseType_t xMinDescriptorsToLeave = 2UL;
+    NetworkBufferDescriptor_t * pxDescriptor;
     const TickType_t xBlockTime = pdMS_TO_TICKS( 100UL );
     IPStackEvent_t xRxEvent = { eNetworkRxEvent, NULL };
     uint8_t * pucDMABuffer = NULL;
+    uint8_t ** ppucDMABuffer;
 
     for( ; ; )
     {
         BaseType_t xRelease = pdFALSE;
 
-        /* If pxNextNetworkBufferDescriptor was not left pointing at a valid
-         * descriptor then allocate one now. */
-        if( ( pxNextNetworkBufferDescriptor == NULL ) && ( uxGetNumberOfFreeNetworkBuffers() > xMinDescriptorsToLeave ) )
+        if( gs_gmac_dev.ul_rx_empty_count >= niEMAC_RX_REFILL_BATCH )
         {
-            pxNextNetworkBufferDescriptor = pxGetNetworkBufferWithDescriptor( GMAC_RX_UNITSIZE, xBlockTime );
+            prvEMACRxRefill();
         }
 
-        if( pxNextNetworkBufferDescriptor != NULL )
+        /* A frame is only passed on when at least one other descriptor has a
+         * buffer, so the DMA can still receive packets and raise interrupts.
+         * Otherwise the frame is dropped, and its buffer will be re-used. */
+        if( ( gs_gmac_dev.ul_rx_empty_count + 1U ) < GMAC_RX_BUFFERS )
         {
-            /* Point pucUseBuffer to the buffer pointed to by the descriptor. */
-            pucUseBuffer = ( unsigned char * ) ( pxNextNetworkBufferDescriptor->pucEthernetBuffer - ipconfigPACKET_FILLER_SIZE );
+            ppucDMABuffer = &( pucDMABuffer );
         }
         else
         {
-            /* As long as pxNextNetworkBufferDescriptor is NULL, the incoming
-             * messages will be flushed and ignored. */
-            pucUseBuffer = NULL;
+            ppucDMABuffer = NULL;
         }
 
-        /* Read the next packet from the hardware into pucUseBuffer. */
-        ulResult = gmac_dev_read( &gs_gmac_dev, pucUseBuffer, GMAC_RX_UNITSIZE, &ulReceiveCount, &pucDMABuffer );
+        /* Read the next packet from the hardware. */
+        ulResult = gmac_dev_read( &gs_gmac_dev, NULL, GMAC_RX_UNITSIZE, &ulReceiveCount, ppucDMABuffer );
 
         if( ( ulResult != GMAC_OK ) || ( ulReceiveCount == 0 ) )
         {
@@ -997,7 +1022,7 @@ static uint32_t prvEMACRxPoll( void )
             break;
         }
 
-        if( pxNextNetworkBufferDescriptor == NULL )
+        if( ppucDMABuffer == NULL )
         {
             /* Data was read from the hardware, but no descriptor was available
              * for it, so it will be dropped. */
@@ -1006,30 +1031,26 @@ static uint32_t prvEMACRxPoll( void )
         }
 
         iptraceNETWORK_INTERFACE_RECEIVE();
-        #if ( ipconfigZERO_COPY_RX_DRIVER != 0 )
-        {
-            pxNextNetworkBufferDescriptor = pxPacketBuffer_to_NetworkBuffer( pucDMABuffer );
+        pxDescriptor = pxPacketBuffer_to_NetworkBuffer( pucDMABuffer );
 
-            if( pxNextNetworkBufferDescriptor == NULL )
-            {
-                /* Strange: can not translate from a DMA buffer to a Network Buffer. */
-                break;
-            }
+        if( pxDescriptor == NULL )
+        {
+            /* Strange: can not translate from a DMA buffer to a Network Buffer. */
+            break;
         }
-        #endif /* ipconfigZERO_COPY_RX_DRIVER */
 
-        pxNextNetworkBufferDescriptor->xDataLength = ( size_t ) ulReceiveCount;
-        pxNextNetworkBufferDescriptor->pxInterface = pxMyInterface;
-        pxNextNetworkBufferDescriptor->pxEndPoint = FreeRTOS_MatchingEndpoint( pxMyInterface, pxNextNetworkBufferDescriptor->pucEthernetBuffer );
+        pxDescriptor->xDataLength = ( size_t ) ulReceiveCount;
+        pxDescriptor->pxInterface = pxMyInterface;
+        pxDescriptor->pxEndPoint = FreeRTOS_MatchingEndpoint( pxMyInterface, pxDescriptor->pucEthernetBuffer );
 
-        if( pxNextNetworkBufferDescriptor->pxEndPoint == NULL )
+        if( pxDescriptor->pxEndPoint == NULL )
         {
             FreeRTOS_printf( ( "NetworkInterface: can not find a proper endpoint\n" ) );
             xRelease = pdTRUE;
         }
         else
         {
-            xRxEvent.pvData = ( void * ) pxNextNetworkBufferDescriptor;
+            xRxEvent.pvData = ( void * ) pxDescriptor;
 
             if( xSendEventStructToIPTask( &xRxEvent, xBlockTime ) != pdTRUE )
             {
@@ -1044,20 +1065,35 @@ static uint32_t prvEMACRxPoll( void )
         {
             /* The buffer could not be sent to the stack so must be released
              * again. */
-            vReleaseNetworkBufferAndDescriptor( pxNextNetworkBufferDescriptor );
+            vReleaseNetworkBufferAndDescriptor( pxDescriptor );
             iptraceETHERNET_RX_EVENT_LOST();
         }
 
         /* Now the buffer has either been passed to the IP-task,
          * or it has been released in the code above. */
-        pxNextNetworkBufferDescriptor = NULL;
         ulReturnValue++;
     }
 
+    /* Fill all empty descriptors before waiting for the next interrupt. */
+    prvEMACRxRefill();
+
     return ulReturnValue;
 }
 /*-----------------------------------------------------------*/
 
+static void prvEMACRxRefill( void )
+{
+    /* Leave some network buffers for the IP-task and the other tasks. */
+    const UBaseType_t xMinDescriptorsToLeave = 2UL;
+    UBaseType_t uxFreeCount = uxGetNumberOfFreeNetworkBuffers();
+
+    if( ( gs_gmac_dev.ul_rx_empty_count != 0U ) && ( uxFreeCount > xMinDescriptorsToLeave ) )
+    {
+        ( void ) gmac_dev_rx_refill( &gs_gmac_dev, ( uint32_t ) ( uxFreeCount - xMinDescriptorsToLeave ) );
+    }
+}
+/*-----------------------------------------------------------*/
+
 volatile UBaseType_t uxLastMinBufferCount = 0;
 #if ( ipconfigCHECK_IP_QUEUE_SPACE != 0 )
     volatile UBaseType_t uxLastMinQueueSpace;
@@ -1114,8 +1150,18 @@ void vNetworkInterfaceAllocateRAMToBuffers( NetworkBufferDescriptor_t pxNetworkB
 
     for( ulIndex = 0; ulIndex < ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS; ulIndex++ )
     {
-        pxNetworkBuffers[ ulIndex ].pucEthernetBuffer = ucRAMBuffer + ipBUFFER_PADDING;
-        *( ( unsigned * ) ucRAMBuffer ) = ( unsigned ) ( &( pxNetworkBuffers[ ulIndex ] ) );
+        #if ( NETWORK_BUFFERS_CACHED != 0 )
+        {
+            /* The DMA area starts at the second cache line of the slot. The
+             * pointer to the descriptor is stored in the first line. */
+            pxNetworkBuffers[ ulIndex ].pucEthernetBuffer = ucRAMBuffer + BUFFER_PADDING + ipconfigPACKET_FILLER_SIZE;
+        }
+        #else
+        {
+            pxNetworkBuffers[ ulIndex ].pucEthernetBuffer = ucRAMBuffer + ipBUFFER_PADDING;
+        }
+        #endif
+        *( ( unsigned * ) ( pxNetworkBuffers[ ulIndex ].pucEthernetBuffer - ipBUFFER_PADDING ) ) = ( unsigned ) ( &( pxNetworkBuffers[ ulIndex ] ) );
         ucRAMBuffer += NETWORK_BUFFER_SIZE;
     }
 
@@ -1153,11 +1199,33 @@ static void prvEMACHandlerTask( void * pvParameters )
                          &( ulISREvents ),  /* pulNotificationValue */
                          ulMaxBlockTime );
 
+        iptraceEMAC_TASK_LOOP_START( 0 );
+
         if( ( ulISREvents & EMAC_IF_RX_EVENT ) != 0 )
         {
             /* Wait for the EMAC interrupt to indicate that another packet has been
              * received. */
             xResult = prvEMACRxPoll();
+
+            #if ( niEMAC_RX_INTERRUPT_MODERATION != 0 )
+            {
+                /* The RX ring is empty, enable the interrupt again. A packet
+                 * that arrived just before will not raise an interrupt, so
+                 * check the ring once more. */
+                gmac_enable_interrupt( GMAC, GMAC_IER_RCOMP );
+
+                if( gmac_dev_rx_pending( &gs_gmac_dev ) != 0U )
+                {
+                    xTaskNotify( xEMACTaskHandle, EMAC_IF_RX_EVENT, eSetBits );
+                }
+            }
+            #endif
+        }
+        else
+        {
+            /* Retry to give buffers to empty descriptors, in case the network
+             * buffers were exhausted. */
+            prvEMACRxRefill();
         }
 
         if( ( ulISREvents & EMAC_IF_TX_EVENT ) != 0 )
@@ -1207,6 +1275,8 @@ static void prvEMACHandlerTask( void * pvParameters )
         }
 
         gmac_enable_management( GMAC, false );
+
+        iptraceEMAC_TASK_LOOP_END( 0 );
     }
 }
 /*-----------------------------------------------------------*/
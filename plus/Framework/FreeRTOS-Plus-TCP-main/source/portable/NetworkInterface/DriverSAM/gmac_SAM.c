@@ -76,6 +76,28 @@
     #include "core_cm7.h"
 #endif
 
+#if ( NETWORK_BUFFERS_CACHED != 0 ) && ( __DCACHE_PRESENT != 0 ) && defined( CONF_BOARD_ENABLE_CACHE )
+
+/* Invalidate the cache lines that cover 'ul_size' bytes at 'ul_address'.
+ * No barrier is issued here, so that a series of ranges can be invalidated
+ * before calling gmac_cache_sync() once. */
+    static void gmac_cache_invalidate_lines( uint32_t ul_address,
+                                             uint32_t ul_size )
+    {
+        uint32_t ul_end = ul_address + ul_size;
+
+        for( ul_address &= ~( GMAC_CACHE_LINE_SIZE - 1U ); ul_address < ul_end; ul_address += GMAC_CACHE_LINE_SIZE )
+        {
+            SCB->DCIMVAC = ul_address;
+        }
+    }
+
+    #define gmac_cache_sync()    do { __DSB(); __ISB(); } while( 0 )
+#else
+    #define gmac_cache_invalidate_lines( ul_address, ul_size )    do {} while( 0 )
+    #define gmac_cache_sync()                                      do {} while( 0 )
+#endif
+
 /*/ @cond 0 */
 /* *INDENT-OFF* */
 #ifdef __cplusplus
@@ -167,9 +189,9 @@ static gmac_rx_descriptor_t gs_rx_desc[ GMAC_RX_BUFFERS ];
 #endif /* ipconfigZERO_COPY_TX_DRIVER */
 
 #if ( ipconfigZERO_COPY_RX_DRIVER == 0 )
-    /** Receive Buffer */
+    /** Receive Buffer, aligned to a cache line, see gmac_cache_invalidate_lines(). */
     __attribute__( ( section( ".first_data" ) ) )
-    COMPILER_ALIGNED( 8 )
+    COMPILER_ALIGNED( 32 )
     static uint8_t gs_uc_rx_buffer[ GMAC_RX_BUFFERS * GMAC_RX_UNITSIZE ];
 #endif /* ipconfigZERO_COPY_RX_DRIVER */
 
@@ -322,6 +344,8 @@ static void gmac_reset_rx_mem( gmac_device_t * p_dev )
 
     /* Set up the RX descriptors */
     p_dev->ul_rx_idx = 0;
+    p_dev->ul_rx_refill_idx = 0;
+    p_dev->ul_rx_empty_count = 0;
 
     for( ul_index = 0; ul_index < GMAC_RX_BUFFERS; ul_index++ )
     {
@@ -332,6 +356,7 @@ static void gmac_reset_rx_mem( gmac_device_t * p_dev )
             pxNextNetworkBufferDescriptor = pxGetNetworkBufferWithDescriptor( GMAC_RX_UNITSIZE, 0ul );
             configASSERT( pxNextNetworkBufferDescriptor != NULL );
             ul_address = ( uint32_t ) ( pxNextNetworkBufferDescriptor->pucEthernetBuffer );
+            gmac_cache_invalidate_lines( ul_address & GMAC_RXD_ADDR_MASK, GMAC_RX_UNITSIZE );
         }
         #else
         {
@@ -344,6 +369,7 @@ static void gmac_reset_rx_mem( gmac_device_t * p_dev )
 
     /* Set the WRAP bit in the last descriptor. */
     gs_rx_desc[ GMAC_RX_BUFFERS - 1 ].addr.bm.b_wrap = 1;
+    gmac_cache_sync();
 
     /* Set receive buffer queue */
     gmac_set_rx_queue( p_hw, ( uint32_t ) gs_rx_desc );
@@ -572,6 +598,14 @@ static uint32_t gmac_dev_poll( gmac_device_t * p_gmac_dev )
         }
         #else /* ipconfigZERO_COPY_RX_DRIVER */
         {
+            if( ( p_gmac_dev->ul_rx_empty_count != 0U ) &&
+                ( ( uint32_t ) ulIndex == p_gmac_dev->ul_rx_refill_idx ) )
+            {
+                /* This descriptor is waiting for a new buffer, it is owned
+                 * by the CPU but it does not contain a frame. */
+                break;
+            }
+
             if( ( pxHead->status.val & ( GMAC_RXD_SOF | GMAC_RXD_EOF ) ) == ( GMAC_RXD_SOF | GMAC_RXD_EOF ) )
             {
                 /* Here a complete frame in a single segment. */
@@ -601,10 +635,19 @@ static uint32_t gmac_dev_poll( gmac_device_t * p_gmac_dev )
  * will be repeatedly called until the sum of all the ul_frame_size equals
  * the value of p_rcv_size.
  *
+ * In zero-copy mode, 'p_frame' is an optional new DMA buffer that replaces
+ * the buffer of the frame. When 'p_frame' is NULL and 'pp_recv_frame' is not,
+ * the descriptor is left empty, and it will get a new buffer from
+ * gmac_dev_rx_refill(). When both are NULL, the frame is dropped and its
+ * buffer is given back to the DMA.
+ *
+ * Only the cache lines of the frame that is read are invalidated.
+ *
  * \param p_gmac_dev Pointer to the GMAC device instance.
  * \param p_frame Address of the frame buffer.
  * \param ul_frame_size  Length of the frame.
  * \param p_rcv_size   Received frame size.
+ * \param pp_recv_frame Zero-copy only: receives the address of the frame.
  *
  * \return GMAC_OK if receiving frame successfully, otherwise failed.
  */
@@ -617,6 +660,7 @@ uint32_t gmac_dev_read( gmac_device_t * p_gmac_dev,
     int32_t nextIdx; /* A copy of the Rx-index 'ul_rx_idx' */
     int32_t bytesLeft = gmac_dev_poll( p_gmac_dev );
     gmac_rx_descriptor_t * pxHead;
+    BaseType_t xKeepDescriptor = pdFALSE;
 
     if( bytesLeft == 0 )
     {
@@ -631,10 +675,6 @@ uint32_t gmac_dev_read( gmac_device_t * p_gmac_dev,
      */
     nextIdx = p_gmac_dev->ul_rx_idx;
 
-    #if ( NETWORK_BUFFERS_CACHED != 0 ) && ( __DCACHE_PRESENT != 0 ) && defined( CONF_BOARD_ENABLE_CACHE )
-        SCB_InvalidateDCache();
-    #endif
-
     #if ( ipconfigZERO_COPY_RX_DRIVER == 0 )
     {
         /* The frame will be copied in 1 or 2 memcpy's */
@@ -660,6 +700,16 @@ uint32_t gmac_dev_read( gmac_device_t * p_gmac_dev,
                 toCopy = left;
             }
 
+            /* Invalidate the same one or two ranges that will be copied. */
+            gmac_cache_invalidate_lines( ( uint32_t ) source, toCopy );
+
+            if( left > toCopy )
+            {
+                gmac_cache_invalidate_lines( ( uint32_t ) gs_uc_rx_buffer, left - toCopy );
+            }
+
+            gmac_cache_sync();
+
             memcpy( p_frame, source, toCopy );
             left -= toCopy;
 
@@ -671,38 +721,181 @@ uint32_t gmac_dev_read( gmac_device_t * p_gmac_dev,
     }
     #else /* ipconfigZERO_COPY_RX_DRIVER */
     {
-        if( p_frame != NULL )
+        uint32_t ulDMABuffer = gs_rx_desc[ nextIdx ].addr.val & GMAC_RXD_ADDR_MASK;
+
+        if( ( p_frame != NULL ) || ( pp_recv_frame != NULL ) )
         {
+            /* The frame will be passed to the IP-task: invalidate the lines
+             * that were written by the DMA, including the 2 filler bytes. */
+            gmac_cache_invalidate_lines( ulDMABuffer, bytesLeft + 2 );
+
+            if( p_frame != NULL )
+            {
+                gmac_cache_invalidate_lines( ( uint32_t ) p_frame, GMAC_RX_UNITSIZE );
+            }
+
+            gmac_cache_sync();
+
             /* Return a pointer to the earlier DMA buffer. */
-            *( pp_recv_frame ) = ( uint8_t * )
-                                 ( ( ( gs_rx_desc[ nextIdx ].addr.val ) & ~( 0x03ul ) ) + 2 );
-            /* Set the new DMA-buffer. */
-            gs_rx_desc[ nextIdx ].addr.bm.addr_dw = ( ( uint32_t ) p_frame ) / 4;
+            *( pp_recv_frame ) = ( uint8_t * ) ( ulDMABuffer + 2 );
+
+            if( p_frame != NULL )
+            {
+                /* Set the new DMA-buffer. */
+                gs_rx_desc[ nextIdx ].addr.bm.addr_dw = ( ( uint32_t ) p_frame ) / 4;
+            }
+            else
+            {
+                /* The descriptor remains owned by the CPU, without a buffer,
+                 * until gmac_dev_rx_refill() is called. */
+                gs_rx_desc[ nextIdx ].addr.val &= ( GMAC_RXD_WRAP | GMAC_RXD_OWNERSHIP );
+                xKeepDescriptor = pdTRUE;
+            }
         }
         else
         {
-            /* The driver could not allocate a buffer to receive a packet.
+            /* The frame is dropped.
              * Leave the current DMA buffer in place. */
         }
     }
     #endif /* ipconfigZERO_COPY_RX_DRIVER */
 
-    do
+    if( xKeepDescriptor == pdFALSE )
     {
-        pxHead = &gs_rx_desc[ nextIdx ];
-        pxHead->addr.val &= ~( GMAC_RXD_OWNERSHIP );
+        do
+        {
+            pxHead = &gs_rx_desc[ nextIdx ];
+            pxHead->addr.val &= ~( GMAC_RXD_OWNERSHIP );
+            circ_inc32( &nextIdx, GMAC_RX_BUFFERS );
+
+            if( pxHead->addr.val )
+            {
+                /* Just read it back to make sure that
+                 * it was written to SRAM. */
+            }
+        } while( ( pxHead->status.val & GMAC_RXD_EOF ) == 0 );
+    }
+    else
+    {
+        /* In zero-copy mode, a frame always occupies a single descriptor. */
         circ_inc32( &nextIdx, GMAC_RX_BUFFERS );
+        p_gmac_dev->ul_rx_empty_count++;
+    }
+
+    p_gmac_dev->ul_rx_idx = nextIdx;
+
+    return GMAC_OK;
+}
 
-        if( pxHead->addr.val )
+/**
+ * \brief Zero-copy only: give new network buffers to at most 'ul_max_count'
+ * descriptors that were left empty by gmac_dev_read(). The buffers are
+ * attached to the descriptors first, and the lines of their DMA areas are
+ * invalidated, followed by a single barrier. After that, all descriptors of
+ * the batch are handed over to the DMA.
+ *
+ * \param p_gmac_dev Pointer to the GMAC device instance.
+ * \param ul_max_count The maximum number of buffers to be allocated.
+ *
+ * \return The number of descriptors that got a new buffer.
+ */
+uint32_t gmac_dev_rx_refill( gmac_device_t * p_gmac_dev,
+                             uint32_t ul_max_count )
+{
+    uint32_t ul_count = 0U;
+
+    #if ( ipconfigZERO_COPY_RX_DRIVER != 0 )
+    {
+        NetworkBufferDescriptor_t * pxDescriptor;
+        uint32_t ul_index = p_gmac_dev->ul_rx_refill_idx;
+        uint32_t ul_address;
+        uint32_t ul_last = ul_index;
+        uint32_t ul_loop;
+
+        if( ul_max_count > p_gmac_dev->ul_rx_empty_count )
         {
-            /* Just read it back to make sure that
-             * it was written to SRAM. */
+            ul_max_count = p_gmac_dev->ul_rx_empty_count;
         }
-    } while( ( pxHead->status.val & GMAC_RXD_EOF ) == 0 );
 
-    p_gmac_dev->ul_rx_idx = nextIdx;
+        /* Attach the buffers, the descriptors are still owned by the CPU. */
+        while( ul_count < ul_max_count )
+        {
+            pxDescriptor = pxGetNetworkBufferWithClass( GMAC_RX_UNITSIZE, 0U, eBufferClassRX );
 
-    return GMAC_OK;
+            if( pxDescriptor == NULL )
+            {
+                break;
+            }
+
+            ul_address = ( ( uint32_t ) pxDescriptor->pucEthernetBuffer ) & GMAC_RXD_ADDR_MASK;
+            gmac_cache_invalidate_lines( ul_address, GMAC_RX_UNITSIZE );
+
+            gs_rx_desc[ ul_index ].status.val = 0;
+            gs_rx_desc[ ul_index ].addr.val = ul_address |
+                                              ( gs_rx_desc[ ul_index ].addr.val & ( GMAC_RXD_WRAP | GMAC_RXD_OWNERSHIP ) );
+            ul_index = ( ul_index + 1U ) % GMAC_RX_BUFFERS;
+            ul_count++;
+        }
+
+        if( ul_count != 0U )
+        {
+            /* One barrier for the whole batch. */
+            gmac_cache_sync();
+
+            /* Now hand over the descriptors to the DMA. */
+            ul_index = p_gmac_dev->ul_rx_refill_idx;
+
+            for( ul_loop = 0U; ul_loop < ul_count; ul_loop++ )
+            {
+                gs_rx_desc[ ul_index ].addr.val &= ~( GMAC_RXD_OWNERSHIP );
+                ul_last = ul_index;
+                ul_index = ( ul_index + 1U ) % GMAC_RX_BUFFERS;
+            }
+
+            if( gs_rx_desc[ ul_last ].addr.val )
+            {
+                /* Just read it back to make sure that
+                 * it was written to SRAM. */
+            }
+
+            p_gmac_dev->ul_rx_refill_idx = ul_index;
+            p_gmac_dev->ul_rx_empty_count -= ul_count;
+        }
+    }
+    #else /* if ( ipconfigZERO_COPY_RX_DRIVER != 0 ) */
+    {
+        ( void ) p_gmac_dev;
+        ( void ) ul_max_count;
+    }
+    #endif /* ipconfigZERO_COPY_RX_DRIVER */
+
+    return ul_count;
+}
+
+/**
+ * \brief Check if the GMAC has passed a descriptor to the CPU, that has not
+ * been read yet.
+ *
+ * \param p_gmac_dev Pointer to the GMAC device instance.
+ *
+ * \return Non-zero when gmac_dev_read() has work to do.
+ */
+uint32_t gmac_dev_rx_pending( gmac_device_t * p_gmac_dev )
+{
+    uint32_t ulReturn = gs_rx_desc[ p_gmac_dev->ul_rx_idx ].addr.val & GMAC_RXD_OWNERSHIP;
+
+    #if ( ipconfigZERO_COPY_RX_DRIVER != 0 )
+    {
+        if( ( p_gmac_dev->ul_rx_empty_count != 0U ) &&
+            ( p_gmac_dev->ul_rx_idx == p_gmac_dev->ul_rx_refill_idx ) )
+        {
+            /* The descriptor is waiting for a new buffer. */
+            ulReturn = 0U;
+        }
+    }
+    #endif
+
+    return ulReturn;
 }
 
 /**
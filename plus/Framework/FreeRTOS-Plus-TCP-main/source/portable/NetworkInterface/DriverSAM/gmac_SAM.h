@@ -97,11 +97,21 @@
     #define GMAC_RX_UNITSIZE           GMAC_FRAME_LENTGH_MAX /**< Maximum size for RX buffer  */
     #define GMAC_TX_UNITSIZE           GMAC_FRAME_LENTGH_MAX /**< Maximum size for TX buffer  */
 
+/** The size of a line in the data cache of the Cortex-M7. */
+    #define GMAC_CACHE_LINE_SIZE     32U
+
 /* A network buffer starts with 10 hidden bytes (ipBUFFER_PADDING)
  * in which a pointer is stored. Round up this extra size to a multiple of 16,
- * in order to get well-aligned buffers. */
+ * in order to get well-aligned buffers.
+ * When the network buffers are cached, the hidden bytes get a cache line of
+ * their own, so that the area that is written by the DMA starts at a cache
+ * line boundary, and it can be invalidated without touching the pointer. */
 
-    #define BUFFER_PADDING           ( ( ipBUFFER_PADDING + 16U ) & ~0x0FU )
+    #if ( NETWORK_BUFFERS_CACHED != 0 )
+        #define BUFFER_PADDING       GMAC_CACHE_LINE_SIZE
+    #else
+        #define BUFFER_PADDING       ( ( ipBUFFER_PADDING + 16U ) & ~0x0FU )
+    #endif
     #define NETWORK_BUFFER_SIZE      ( GMAC_FRAME_LENTGH_MAX + BUFFER_PADDING )
 
 /** GMAC clock speed */
@@ -281,6 +291,10 @@
         #endif
         /** RX index for current processing TD */
         uint32_t ul_rx_idx;
+        /** Zero-copy only: index of the first RX TD that is waiting for a new buffer */
+        uint32_t ul_rx_refill_idx;
+        /** Zero-copy only: number of RX TD's that are waiting for a new buffer */
+        uint32_t ul_rx_empty_count;
         /** Circular buffer head pointer by upper layer (buffer to be sent) */
         int32_t l_tx_head;
         /** Circular buffer tail pointer incremented by handlers (buffer sent) */
@@ -1525,6 +1539,9 @@
                             uint32_t ul_frame_size,
                             uint32_t * p_rcv_size,
                             uint8_t ** pp_recv_frame );
+    uint32_t gmac_dev_rx_refill( gmac_device_t * p_gmac_dev,
+                                 uint32_t ul_max_count );
+    uint32_t gmac_dev_rx_pending( gmac_device_t * p_gmac_dev );
     uint32_t gmac_dev_write( gmac_device_t * p_gmac_dev,
                              void * p_buffer,
                              uint32_t ul_size );
@@ -0,0 +1,3307 @@
+/*
+ * FreeRTOS+TCP <DEVELOPMENT BRANCH>
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file PPPNetworkInterface.c
+ * @brief A network interface that runs PPP over a serial line (RFC 1661/1662).
+ *
+ * The IP-stack sees an Ethernet interface: outgoing frames lose their
+ * Ethernet header and are sent in HDLC-like frames, incoming packets get a
+ * fake Ethernet header. ARP requests and IPv6 neighbour solicitations are
+ * answered locally, the peer is the next hop for every address.
+ *
+ * LCP negotiates MRU, ACCM, magic number and protocol- and address-field
+ * compression. The peer may ask for PAP or CHAP-MD5. IPCP negotiates the IPv4
+ * address and two DNS servers, IPV6CP the interface identifier of a link-local
+ * IPv6 address.
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_IP_Private.h"
+#include "FreeRTOS_Routing.h"
+#include "FreeRTOS_ND.h"
+#include "NetworkBufferManagement.h"
+#include "NetworkInterface.h"
+
+#include "PPPNetworkInterface.h"
+
+#if ( ipconfigCOMPATIBLE_WITH_SINGLE != 0 )
+    #error The PPP interface needs the multi-interface API, define ipconfigCOMPATIBLE_WITH_SINGLE as 0
+#endif
+
+#if ( ipconfigDRIVER_INCLUDED_RX_IP_CHECKSUM != 0 ) || ( ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM != 0 )
+    #warning A serial line has no checksum offloading, define 'ipconfigDRIVER_INCLUDED_RX_IP_CHECKSUM' and 'ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM' as 0
+#endif
+
+/* The number of PPP interfaces, each has its own task and serial line. */
+#ifndef niPPP_MAX_INTERFACES
+    #define niPPP_MAX_INTERFACES    1
+#endif
+
+#ifndef niPPP_TASK_NAME
+    #define niPPP_TASK_NAME    "PPP"
+#endif
+
+#ifndef niPPP_TASK_STACK_SIZE
+    #define niPPP_TASK_STACK_SIZE    ( 4U * configMINIMAL_STACK_SIZE )
+#endif
+
+#ifndef niPPP_TASK_PRIORITY
+    #define niPPP_TASK_PRIORITY    ( configMAX_PRIORITIES - 1 )
+#endif
+
+/* The IP-task queues outgoing packets for a second task, which writes
+ * them to the serial line. */
+#ifndef niPPP_TX_TASK_NAME
+    #define niPPP_TX_TASK_NAME    "PPPTx"
+#endif
+
+#ifndef niPPP_TX_TASK_STACK_SIZE
+    #define niPPP_TX_TASK_STACK_SIZE    ( 2U * configMINIMAL_STACK_SIZE )
+#endif
+
+#ifndef niPPP_TX_TASK_PRIORITY
+    #define niPPP_TX_TASK_PRIORITY    niPPP_TASK_PRIORITY
+#endif
+
+#ifndef niPPP_TX_QUEUE_LENGTH
+    #define niPPP_TX_QUEUE_LENGTH    8U
+#endif
+
+/* The MRU that is requested from the peer. */
+#ifndef niPPP_MRU
+    #define niPPP_MRU    ipconfigNETWORK_MTU
+#endif
+
+#if ( niPPP_MRU > ipconfigNETWORK_MTU )
+    #error niPPP_MRU may not be larger than ipconfigNETWORK_MTU
+#endif
+
+/* Restart timer and counters, see RFC 1661 section 4.6. */
+#ifndef niPPP_RESTART_TIMER_MS
+    #define niPPP_RESTART_TIMER_MS    3000U
+#endif
+
+#ifndef niPPP_MAX_CONFIGURE
+    #define niPPP_MAX_CONFIGURE    10U
+#endif
+
+#ifndef niPPP_MAX_TERMINATE
+    #define niPPP_MAX_TERMINATE    2U
+#endif
+
+/* Send an LCP Echo-Request when the link was opened for this time, 0 disables it. */
+#ifndef niPPP_ECHO_INTERVAL_MS
+    #define niPPP_ECHO_INTERVAL_MS    30000U
+#endif
+
+/* The link is dead after this number of unanswered Echo-Requests. */
+#ifndef niPPP_ECHO_FAILURES
+    #define niPPP_ECHO_FAILURES    3U
+#endif
+
+/* The minimum time between the end of a link and the start of a new one. */
+#ifndef niPPP_HOLDOFF_MS
+    #define niPPP_HOLDOFF_MS    5000U
+#endif
+
+/* The number of bytes read from the serial line at once. */
+#ifndef niPPP_READ_SIZE
+    #define niPPP_READ_SIZE    64U
+#endif
+
+/* Encoded bytes are collected in a buffer of this size before they are written. */
+#ifndef niPPP_TX_CHUNK_SIZE
+    #define niPPP_TX_CHUNK_SIZE    256U
+#endif
+
+#if ( niPPP_TX_CHUNK_SIZE < 16U )
+    #error niPPP_TX_CHUNK_SIZE must be at least 16
+#endif
+
+/* The size of the buffer in which LCP, NCP and authentication packets are built. */
+#ifndef niPPP_CONTROL_BUFFER_SIZE
+    #define niPPP_CONTROL_BUFFER_SIZE    256U
+#endif
+
+/* HDLC-like framing, RFC 1662. */
+#define pppHDLC_FLAG                  ( ( uint8_t ) 0x7EU )
+#define pppHDLC_ESCAPE                ( ( uint8_t ) 0x7DU )
+#define pppHDLC_TRANSPARENT           ( ( uint8_t ) 0x20U )
+#define pppHDLC_ADDRESS               ( ( uint8_t ) 0xFFU )
+#define pppHDLC_CONTROL               ( ( uint8_t ) 0x03U )
+#define pppFCS_INIT                   ( ( uint16_t ) 0xFFFFU )
+#define pppFCS_GOOD                   ( ( uint16_t ) 0xF0B8U )
+#define pppFCS_LENGTH                 2U
+#define pppDEFAULT_ACCM               0xFFFFFFFFU
+
+/* Protocol numbers. */
+#define pppPROTOCOL_IPv4              ( ( uint16_t ) 0x0021U )
+#define pppPROTOCOL_IPv6              ( ( uint16_t ) 0x0057U )
+#define pppPROTOCOL_IPCP              ( ( uint16_t ) 0x8021U )
+#define pppPROTOCOL_IPV6CP            ( ( uint16_t ) 0x8057U )
+#define pppPROTOCOL_LCP               ( ( uint16_t ) 0xC021U )
+#define pppPROTOCOL_PAP               ( ( uint16_t ) 0xC023U )
+#define pppPROTOCOL_CHAP              ( ( uint16_t ) 0xC223U )
+
+/* Packet codes of LCP and the NCP's. */
+#define pppCONFIGURE_REQUEST          ( ( uint8_t ) 1U )
+#define pppCONFIGURE_ACK              ( ( uint8_t ) 2U )
+#define pppCONFIGURE_NAK              ( ( uint8_t ) 3U )
+#define pppCONFIGURE_REJECT           ( ( uint8_t ) 4U )
+#define pppTERMINATE_REQUEST          ( ( uint8_t ) 5U )
+#define pppTERMINATE_ACK              ( ( uint8_t ) 6U )
+#define pppCODE_REJECT                ( ( uint8_t ) 7U )
+#define pppPROTOCOL_REJECT            ( ( uint8_t ) 8U )
+#define pppECHO_REQUEST               ( ( uint8_t ) 9U )
+#define pppECHO_REPLY                 ( ( uint8_t ) 10U )
+#define pppDISCARD_REQUEST            ( ( uint8_t ) 11U )
+
+/* Packet codes of PAP and CHAP. */
+#define pppPAP_REQUEST                ( ( uint8_t ) 1U )
+#define pppPAP_ACK                    ( ( uint8_t ) 2U )
+#define pppPAP_NAK                    ( ( uint8_t ) 3U )
+#define pppCHAP_CHALLENGE             ( ( uint8_t ) 1U )
+#define pppCHAP_RESPONSE              ( ( uint8_t ) 2U )
+#define pppCHAP_SUCCESS               ( ( uint8_t ) 3U )
+#define pppCHAP_FAILURE               ( ( uint8_t ) 4U )
+#define pppCHAP_MD5                   ( ( uint8_t ) 5U )
+#define pppMD5_LENGTH                 16U
+
+/* Configuration options. */
+#define pppLCP_MRU                    ( ( uint8_t ) 1U )
+#define pppLCP_ACCM                   ( ( uint8_t ) 2U )
+#define pppLCP_AUTH                   ( ( uint8_t ) 3U )
+#define pppLCP_MAGIC                  ( ( uint8_t ) 5U )
+#define pppLCP_PFC                    ( ( uint8_t ) 7U )
+#define pppLCP_ACFC                   ( ( uint8_t ) 8U )
+#define pppIPCP_ADDRESS               ( ( uint8_t ) 3U )
+#define pppIPCP_DNS1                  ( ( uint8_t ) 129U )
+#define pppIPCP_DNS2                  ( ( uint8_t ) 131U )
+#define pppIPV6CP_IID                 ( ( uint8_t ) 1U )
+
+/* Bits in 'PPPFsm_t::ulWanted': the options that are still requested. */
+#define pppWANT_MRU                   0x01U
+#define pppWANT_ACCM                  0x02U
+#define pppWANT_MAGIC                 0x04U
+#define pppWANT_PFC                   0x08U
+#define pppWANT_ACFC                  0x10U
+#define pppWANT_ADDRESS               0x01U
+#define pppWANT_DNS1                  0x02U
+#define pppWANT_DNS2                  0x04U
+#define pppWANT_IID                   0x01U
+
+#define pppDEFAULT_MRU                1500U
+#define pppMIN_MRU                    128U
+#define pppHEADER_LENGTH              4U  /* Code, identifier and length. */
+#define pppIID_LENGTH                 8U
+#define pppMAX_NAK_LENGTH             16U /* The longest option that is suggested in a Configure-Nak. */
+#define pppPOLL_PERIOD_MS             100U
+
+/* The solicited and override flags of a neighbour advertisement. */
+#define pppNA_FLAGS                   0x60000000U
+
+/* Test if any byte of a word is zero, or less than 0x20. */
+#define pppHAS_ZERO_BYTE( ulWord )    ( ( ( ulWord ) - 0x01010101U ) & ~( ulWord ) & 0x80808080U )
+#define pppHAS_CONTROL( ulWord )      ( ( ( ulWord ) - 0x20202020U ) & ~( ulWord ) & 0x80808080U )
+
+/*-----------------------------------------------------------*/
+
+/** @brief The states of the option negotiation automaton, a subset of
+ *         RFC 1661 section 4.2 that is sufficient for an active open. */
+typedef enum ePPP_FSM_STATE
+{
+    eFsmClosed,  /**< Not negotiating, or the negotiation has finished. */
+    eFsmReqSent, /**< Configure-Request sent. */
+    eFsmAckRcvd, /**< Configure-Ack received for our request. */
+    eFsmAckSent, /**< Configure-Ack sent for the request of the peer. */
+    eFsmOpened,  /**< Both requests are acknowledged. */
+    eFsmClosing  /**< Terminate-Request sent. */
+} ePPPFsmState_t;
+
+/** @brief The verdict on a single option in the request of the peer. */
+typedef enum ePPP_OPTION_RESULT
+{
+    eOptionAck,
+    eOptionNak,
+    eOptionReject
+} ePPPOptionResult_t;
+
+/** @brief The negotiated options that the transmitter needs. */
+typedef struct xPPP_TX_SETTINGS
+{
+    uint32_t ulACCM;        /**< The characters that must be escaped for the peer. */
+    BaseType_t xNegotiated; /**< LCP is opened, the options below apply. */
+    BaseType_t xPFC;        /**< The peer accepts a compressed protocol field. */
+    BaseType_t xACFC;       /**< The peer accepts frames without address and control field. */
+    BaseType_t xIPv4Opened; /**< IPCP is opened. */
+    BaseType_t xIPv6Opened; /**< IPV6CP is opened. */
+} PPPTxSettings_t;
+
+struct xPPP_CONTEXT;
+
+/** @brief The option handling of LCP, IPCP or IPV6CP. */
+typedef struct xPPP_PROTOCOL
+{
+    uint16_t usProtocol;
+    const char * pcName;
+    /* Write our Configure-Request options, return their length. */
+    size_t ( * pfAddOptions )( struct xPPP_CONTEXT * pxContext,
+                               uint8_t * pucOptions );
+    /* Judge an option of the peer, write a suggestion to 'pucNak' when not NULL. */
+    ePPPOptionResult_t ( * pfCheckOption )( const struct xPPP_CONTEXT * pxContext,
+                                            const uint8_t * pucOption,
+                                            uint8_t * pucNak );
+    /* Store an acknowledged option of the peer, NULL restores the defaults. */
+    void ( * pfApplyOption )( struct xPPP_CONTEXT * pxContext,
+                              const uint8_t * pucOption );
+    /* Handle an option of ours that the peer nak'ed or rejected. */
+    void ( * pfNakOption )( struct xPPP_CONTEXT * pxContext,
+                            const uint8_t * pucOption,
+                            BaseType_t xIsReject );
+    void ( * pfUp )( struct xPPP_CONTEXT * pxContext );
+    void ( * pfDown )( struct xPPP_CONTEXT * pxContext );
+    void ( * pfFinished )( struct xPPP_CONTEXT * pxContext );
+} PPPProtocol_t;
+
+/** @brief The state of one automaton. */
+typedef struct xPPP_FSM
+{
+    const PPPProtocol_t * pxProtocol;
+    ePPPFsmState_t eState;
+    uint32_t ulWanted;        /**< The options that we still request, pppWANT_xxx. */
+    uint8_t ucRequestID;      /**< The identifier of our last request. */
+    uint8_t ucRetries;        /**< The restart counter. */
+    BaseType_t xTimerRunning; /**< The restart timer is running. */
+    TickType_t xTimerStart;
+} PPPFsm_t;
+
+/** @brief The state of a PPP interface. */
+typedef struct xPPP_CONTEXT
+{
+    NetworkInterface_t * pxInterface;
+    PPPConfig_t xConfig;
+    TaskHandle_t xTaskHandle;
+    TaskHandle_t xTxTaskHandle;
+    QueueHandle_t xTxQueue;            /**< Packets from the IP-task for the TX task. */
+    SemaphoreHandle_t xTxMutex;
+    volatile BaseType_t xOpenRequest;  /**< Set by the IP-task when the link must be opened. */
+    volatile BaseType_t xCloseRequest; /**< Set by vPPPClose(). */
+    volatile BaseType_t xNetworkUp;    /**< The NCP's are done, pfInitialise() may return pdPASS. */
+    volatile ePPPPhase_t ePhase;
+    TickType_t xDeadTime;              /**< The time at which the link went down. */
+
+    /* LCP */
+    PPPFsm_t xLCP;
+    uint16_t usMRU;          /**< The MRU that we request. */
+    uint16_t usPeerMRU;      /**< The MRU of the peer. */
+    uint32_t ulMagic;        /**< Our magic number. */
+    uint32_t ulRxACCM;       /**< The ACCM that we request. */
+    uint32_t ulTxACCM;       /**< The characters that must be escaped for the peer. */
+    uint16_t usAuthProtocol; /**< The protocol with which we must authenticate, or 0. */
+    BaseType_t xTxPFC;       /**< The peer accepts a compressed protocol field. */
+    BaseType_t xTxACFC;      /**< The peer accepts frames without address and control field. */
+    uint8_t ucEchoID;
+    uint8_t ucEchoMissed;
+    TickType_t xEchoTime;
+
+    /* PAP and CHAP */
+    uint8_t ucAuthID;
+    uint8_t ucAuthRetries;
+    TickType_t xAuthTime;
+
+    #if ( ipconfigUSE_IPv4 != 0 )
+        PPPFsm_t xIPCP;
+        NetworkEndPoint_t * pxEndPointIPv4;
+        uint32_t ulLocalIP; /* All addresses in network byte order. */
+        uint32_t ulPeerIP;
+        uint32_t ulDNS[ 2 ];
+    #endif
+
+    #if ( ipconfigUSE_IPv6 != 0 )
+        PPPFsm_t xIPV6CP;
+        NetworkEndPoint_t * pxEndPointIPv6;
+        uint8_t ucLocalIID[ pppIID_LENGTH ];
+        uint8_t ucPeerIID[ pppIID_LENGTH ];
+    #endif
+
+    /* The HDLC receiver, only used by the PPP task. The frame may be as
+     * long as the default MRU, also when we asked for a smaller one. */
+    uint8_t ucRxFrame[ ( ( niPPP_MRU > pppDEFAULT_MRU ) ? niPPP_MRU : pppDEFAULT_MRU ) + 6U ];
+    size_t uxRxLength;
+    BaseType_t xRxEscaped;
+    BaseType_t xRxOverflow;
+
+    /* The HDLC transmitter, protected by 'xTxMutex'. The TX task uses the
+     * copy of the options in 'xTxSettings', which only the PPP task updates. */
+    uint8_t ucTxChunk[ niPPP_TX_CHUNK_SIZE ];
+    size_t uxTxLength;
+    uint16_t usTxFCS;
+    PPPTxSettings_t xTxSettings;
+
+    /* Control packets are built here, only used by the PPP task. */
+    uint8_t ucPacket[ niPPP_CONTROL_BUFFER_SIZE ];
+} PPPContext_t;
+
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvPPP_Initialise( NetworkInterface_t * pxInterface );
+static BaseType_t prvPPP_Output( NetworkInterface_t * pxInterface,
+                                 NetworkBufferDescriptor_t * const pxDescriptor,
+                                 BaseType_t xReleaseAfterSend );
+static BaseType_t prvPPP_GetPhyLinkStatus( NetworkInterface_t * pxInterface );
+
+static void prvPPPTask( void * pvParameters );
+static void prvPPPTxTask( void * pvParameters );
+
+static size_t prvLCPAddOptions( PPPContext_t * pxContext,
+                                uint8_t * pucOptions );
+static ePPPOptionResult_t prvLCPCheckOption( const PPPContext_t * pxContext,
+                                             const uint8_t * pucOption,
+                                             uint8_t * pucNak );
+static void prvLCPApplyOption( PPPContext_t * pxContext,
+                               const uint8_t * pucOption );
+static void prvLCPNakOption( PPPContext_t * pxContext,
+                             const uint8_t * pucOption,
+                             BaseType_t xIsReject );
+static void prvLCPUp( PPPContext_t * pxContext );
+static void prvLCPDown( PPPContext_t * pxContext );
+static void prvLCPFinished( PPPContext_t * pxContext );
+
+#if ( ipconfigUSE_IPv4 != 0 )
+    static size_t prvIPCPAddOptions( PPPContext_t * pxContext,
+                                     uint8_t * pucOptions );
+    static ePPPOptionResult_t prvIPCPCheckOption( const PPPContext_t * pxContext,
+                                                  const uint8_t * pucOption,
+                                                  uint8_t * pucNak );
+    static void prvIPCPApplyOption( PPPContext_t * pxContext,
+                                    const uint8_t * pucOption );
+    static void prvIPCPNakOption( PPPContext_t * pxContext,
+                                  const uint8_t * pucOption,
+                                  BaseType_t xIsReject );
+    static void prvIPCPUp( PPPContext_t * pxContext );
+#endif
+
+#if ( ipconfigUSE_IPv6 != 0 )
+    static size_t prvIPV6CPAddOptions( PPPContext_t * pxContext,
+                                       uint8_t * pucOptions );
+    static ePPPOptionResult_t prvIPV6CPCheckOption( const PPPContext_t * pxContext,
+                                                    const uint8_t * pucOption,
+                                                    uint8_t * pucNak );
+    static void prvIPV6CPApplyOption( PPPContext_t * pxContext,
+                                      const uint8_t * pucOption );
+    static void prvIPV6CPNakOption( PPPContext_t * pxContext,
+                                    const uint8_t * pucOption,
+                                    BaseType_t xIsReject );
+    static void prvIPV6CPUp( PPPContext_t * pxContext );
+#endif
+
+static void prvNCPDown( PPPContext_t * pxContext );
+static void prvNCPFinished( PPPContext_t * pxContext );
+
+/*-----------------------------------------------------------*/
+
+static PPPContext_t xPPPContexts[ niPPP_MAX_INTERFACES ];
+
+/* The MAC-address of the peer, as seen by the IP-stack. */
+static const MACAddress_t xPeerMACAddress = { { 0x02U, 0x50U, 0x50U, 0x50U, 0x00U, 0x01U } };
+
+/* The FCS-16 of RFC 1662 section C.2, one entry for every byte value. */
+static const uint16_t usFCSTable[ 256 ] =
+{
+    0x0000U, 0x1189U, 0x2312U, 0x329BU, 0x4624U, 0x57ADU, 0x6536U, 0x74BFU,
+    0x8C48U, 0x9DC1U, 0xAF5AU, 0xBED3U, 0xCA6CU, 0xDBE5U, 0xE97EU, 0xF8F7U,
+    0x1081U, 0x0108U, 0x3393U, 0x221AU, 0x56A5U, 0x472CU, 0x75B7U, 0x643EU,
+    0x9CC9U, 0x8D40U, 0xBFDBU, 0xAE52U, 0xDAEDU, 0xCB64U, 0xF9FFU, 0xE876U,
+    0x2102U, 0x308BU, 0x0210U, 0x1399U, 0x6726U, 0x76AFU, 0x4434U, 0x55BDU,
+    0xAD4AU, 0xBCC3U, 0x8E58U, 0x9FD1U, 0xEB6EU, 0xFAE7U, 0xC87CU, 0xD9F5U,
+    0x3183U, 0x200AU, 0x1291U, 0x0318U, 0x77A7U, 0x662EU, 0x54B5U, 0x453CU,
+    0xBDCBU, 0xAC42U, 0x9ED9U, 0x8F50U, 0xFBEFU, 0xEA66U, 0xD8FDU, 0xC974U,
+    0x4204U, 0x538DU, 0x6116U, 0x709FU, 0x0420U, 0x15A9U, 0x2732U, 0x36BBU,
+    0xCE4CU, 0xDFC5U, 0xED5EU, 0xFCD7U, 0x8868U, 0x99E1U, 0xAB7AU, 0xBAF3U,
+    0x5285U, 0x430CU, 0x7197U, 0x601EU, 0x14A1U, 0x0528U, 0x37B3U, 0x263AU,
+    0xDECDU, 0xCF44U, 0xFDDFU, 0xEC56U, 0x98E9U, 0x8960U, 0xBBFBU, 0xAA72U,
+    0x6306U, 0x728FU, 0x4014U, 0x519DU, 0x2522U, 0x34ABU, 0x0630U, 0x17B9U,
+    0xEF4EU, 0xFEC7U, 0xCC5CU, 0xDDD5U, 0xA96AU, 0xB8E3U, 0x8A78U, 0x9BF1U,
+    0x7387U, 0x620EU, 0x5095U, 0x411CU, 0x35A3U, 0x242AU, 0x16B1U, 0x0738U,
+    0xFFCFU, 0xEE46U, 0xDCDDU, 0xCD54U, 0xB9EBU, 0xA862U, 0x9AF9U, 0x8B70U,
+    0x8408U, 0x9581U, 0xA71AU, 0xB693U, 0xC22CU, 0xD3A5U, 0xE13EU, 0xF0B7U,
+    0x0840U, 0x19C9U, 0x2B52U, 0x3ADBU, 0x4E64U, 0x5FEDU, 0x6D76U, 0x7CFFU,
+    0x9489U, 0x8500U, 0xB79BU, 0xA612U, 0xD2ADU, 0xC324U, 0xF1BFU, 0xE036U,
+    0x18C1U, 0x0948U, 0x3BD3U, 0x2A5AU, 0x5EE5U, 0x4F6CU, 0x7DF7U, 0x6C7EU,
+    0xA50AU, 0xB483U, 0x8618U, 0x9791U, 0xE32EU, 0xF2A7U, 0xC03CU, 0xD1B5U,
+    0x2942U, 0x38CBU, 0x0A50U, 0x1BD9U, 0x6F66U, 0x7EEFU, 0x4C74U, 0x5DFDU,
+    0xB58BU, 0xA402U, 0x9699U, 0x8710U, 0xF3AFU, 0xE226U, 0xD0BDU, 0xC134U,
+    0x39C3U, 0x284AU, 0x1AD1U, 0x0B58U, 0x7FE7U, 0x6E6EU, 0x5CF5U, 0x4D7CU,
+    0xC60CU, 0xD785U, 0xE51EU, 0xF497U, 0x8028U, 0x91A1U, 0xA33AU, 0xB2B3U,
+    0x4A44U, 0x5BCDU, 0x6956U, 0x78DFU, 0x0C60U, 0x1DE9U, 0x2F72U, 0x3EFBU,
+    0xD68DU, 0xC704U, 0xF59FU, 0xE416U, 0x90A9U, 0x8120U, 0xB3BBU, 0xA232U,
+    0x5AC5U, 0x4B4CU, 0x79D7U, 0x685EU, 0x1CE1U, 0x0D68U, 0x3FF3U, 0x2E7AU,
+    0xE70EU, 0xF687U, 0xC41CU, 0xD595U, 0xA12AU, 0xB0A3U, 0x8238U, 0x93B1U,
+    0x6B46U, 0x7ACFU, 0x4854U, 0x59DDU, 0x2D62U, 0x3CEBU, 0x0E70U, 0x1FF9U,
+    0xF78FU, 0xE606U, 0xD49DU, 0xC514U, 0xB1ABU, 0xA022U, 0x92B9U, 0x8330U,
+    0x7BC7U, 0x6A4EU, 0x58D5U, 0x495CU, 0x3DE3U, 0x2C6AU, 0x1EF1U, 0x0F78U
+};
+
+static const PPPProtocol_t xLCPProtocol =
+{
+    pppPROTOCOL_LCP,
+    "LCP",
+    prvLCPAddOptions,
+    prvLCPCheckOption,
+    prvLCPApplyOption,
+    prvLCPNakOption,
+    prvLCPUp,
+    prvLCPDown,
+    prvLCPFinished
+};
+
+#if ( ipconfigUSE_IPv4 != 0 )
+    static const PPPProtocol_t xIPCPProtocol =
+    {
+        pppPROTOCOL_IPCP,
+        "IPCP",
+        prvIPCPAddOptions,
+        prvIPCPCheckOption,
+        prvIPCPApplyOption,
+        prvIPCPNakOption,
+        prvIPCPUp,
+        prvNCPDown,
+        prvNCPFinished
+    };
+#endif
+
+#if ( ipconfigUSE_IPv6 != 0 )
+    static const PPPProtocol_t xIPV6CPProtocol =
+    {
+        pppPROTOCOL_IPV6CP,
+        "IPV6CP",
+        prvIPV6CPAddOptions,
+        prvIPV6CPCheckOption,
+        prvIPV6CPApplyOption,
+        prvIPV6CPNakOption,
+        prvIPV6CPUp,
+        prvNCPDown,
+        prvNCPFinished
+    };
+#endif
+
+/*-----------------------------------------------------------*/
+
+static uint16_t prvGet16( const uint8_t * pucSource )
+{
+    return ( uint16_t ) ( ( ( ( uint16_t ) pucSource[ 0 ] ) << 8 ) | ( ( uint16_t ) pucSource[ 1 ] ) );
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvGet32( const uint8_t * pucSource )
+{
+    return ( ( ( uint32_t ) pucSource[ 0 ] ) << 24 ) | ( ( ( uint32_t ) pucSource[ 1 ] ) << 16 ) |
+           ( ( ( uint32_t ) pucSource[ 2 ] ) << 8 ) | ( ( uint32_t ) pucSource[ 3 ] );
+}
+/*-----------------------------------------------------------*/
+
+static void prvPut16( uint8_t * pucTarget,
+                      uint16_t usValue )
+{
+    pucTarget[ 0 ] = ( uint8_t ) ( usValue >> 8 );
+    pucTarget[ 1 ] = ( uint8_t ) usValue;
+}
+/*-----------------------------------------------------------*/
+
+static void prvPut32( uint8_t * pucTarget,
+                      uint32_t ulValue )
+{
+    pucTarget[ 0 ] = ( uint8_t ) ( ulValue >> 24 );
+    pucTarget[ 1 ] = ( uint8_t ) ( ulValue >> 16 );
+    pucTarget[ 2 ] = ( uint8_t ) ( ulValue >> 8 );
+    pucTarget[ 3 ] = ( uint8_t ) ulValue;
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Add an option to a list of options.
+ *
+ * @param[in] pucOptions The list of options.
+ * @param[in] uxOffset The current length of the list.
+ * @param[in] ucType The option type.
+ * @param[in] pucValue The value of the option, may be NULL when 'uxValueLength' is zero.
+ * @param[in] uxValueLength The length of the value.
+ *
+ * @return The new length of the list.
+ */
+static size_t prvAddOption( uint8_t * pucOptions,
+                            size_t uxOffset,
+                            uint8_t ucType,
+                            const uint8_t * pucValue,
+                            size_t uxValueLength )
+{
+    pucOptions[ uxOffset ] = ucType;
+    pucOptions[ uxOffset + 1U ] = ( uint8_t ) ( uxValueLength + 2U );
+
+    if( uxValueLength > 0U )
+    {
+        ( void ) memcpy( &( pucOptions[ uxOffset + 2U ] ), pucValue, uxValueLength );
+    }
+
+    return uxOffset + 2U + uxValueLength;
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Add a 32-bit option to a list of options.
+ */
+static size_t prvAddOption32( uint8_t * pucOptions,
+                              size_t uxOffset,
+                              uint8_t ucType,
+                              uint32_t ulValue )
+{
+    uint8_t ucValue[ 4 ];
+
+    prvPut32( ucValue, ulValue );
+
+    return prvAddOption( pucOptions, uxOffset, ucType, ucValue, sizeof( ucValue ) );
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Check that a list of options is well-formed.
+ *
+ * @param[in] pucOptions The list of options.
+ * @param[in] uxLength The length of the list.
+ *
+ * @return pdTRUE when every option has a length of at least 2 and fits in the list.
+ */
+static BaseType_t prvOptionsValid( const uint8_t * pucOptions,
+                                   size_t uxLength )
+{
+    size_t uxOffset = 0U;
+    BaseType_t xValid = pdTRUE;
+
+    while( uxOffset < uxLength )
+    {
+        if( ( ( uxLength - uxOffset ) < 2U ) ||
+            ( pucOptions[ uxOffset + 1U ] < 2U ) ||
+            ( ( size_t ) pucOptions[ uxOffset + 1U ] > ( uxLength - uxOffset ) ) )
+        {
+            xValid = pdFALSE;
+            break;
+        }
+
+        uxOffset += pucOptions[ uxOffset + 1U ];
+    }
+
+    return xValid;
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Calculate the FCS-16 of a block of data, one table lookup per byte.
+ *
+ * @param[in] usFCS The FCS of the preceding data, or pppFCS_INIT.
+ * @param[in] pucData The data.
+ * @param[in] uxLength The length of the data.
+ *
+ * @return The FCS including the data.
+ */
+static uint16_t prvFCSUpdate( uint16_t usFCS,
+                              const uint8_t * pucData,
+                              size_t uxLength )
+{
+    uint16_t usResult = usFCS;
+    size_t uxIndex;
+
+    for( uxIndex = 0U; uxIndex < uxLength; uxIndex++ )
+    {
+        usResult = ( uint16_t ) ( ( usResult >> 8 ) ^ usFCSTable[ ( usResult ^ pucData[ uxIndex ] ) & 0xFFU ] );
+    }
+
+    return usResult;
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Check if any of the 4 bytes in a word must be escaped.
+ *
+ * @param[in] ulWord The 4 bytes, in any byte order.
+ * @param[in] ulACCM The async control character map, zero when no control
+ *                   character must be escaped.
+ *
+ * @return pdTRUE when a flag, an escape or possibly a mapped control character
+ *         was found. The bytes must then be looked at one by one.
+ */
+static BaseType_t prvWordNeedsEscape( uint32_t ulWord,
+                                      uint32_t ulACCM )
+{
+    uint32_t ulFound = pppHAS_ZERO_BYTE( ulWord ^ 0x7E7E7E7EU ) | pppHAS_ZERO_BYTE( ulWord ^ 0x7D7D7D7DU );
+
+    if( ulACCM != 0U )
+    {
+        ulFound |= pppHAS_CONTROL( ulWord );
+    }
+
+    return ( ulFound != 0U ) ? pdTRUE : pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Write the encoded bytes to the serial line.
+ */
+static void prvHDLCFlush( PPPContext_t * pxContext )
+{
+    if( pxContext->uxTxLength > 0U )
+    {
+        ( void ) pxContext->xConfig.pfWrite( pxContext->xConfig.pvSerial, pxContext->ucTxChunk, pxContext->uxTxLength );
+        pxContext->uxTxLength = 0U;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvHDLCPutRaw( PPPContext_t * pxContext,
+                           uint8_t ucByte )
+{
+    if( pxContext->uxTxLength >= sizeof( pxContext->ucTxChunk ) )
+    {
+        prvHDLCFlush( pxContext );
+    }
+
+    pxContext->ucTxChunk[ pxContext->uxTxLength ] = ucByte;
+    pxContext->uxTxLength++;
+}
+/*-----------------------------------------------------------*/
+
+static void prvHDLCPutByte( PPPContext_t * pxContext,
+                            uint8_t ucByte,
+                            uint32_t ulACCM )
+{
+    if( ( ucByte == pppHDLC_FLAG ) ||
+        ( ucByte == pppHDLC_ESCAPE ) ||
+        ( ( ucByte < 0x20U ) && ( ( ulACCM & ( 1UL << ucByte ) ) != 0U ) ) )
+    {
+        prvHDLCPutRaw( pxContext, pppHDLC_ESCAPE );
+        prvHDLCPutRaw( pxContext, ( uint8_t ) ( ucByte ^ pppHDLC_TRANSPARENT ) );
+    }
+    else
+    {
+        prvHDLCPutRaw( pxContext, ucByte );
+    }
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Encode a block of data. Words that need no escaping, which is the
+ *        vast majority, are copied as a whole.
+ */
+static void prvHDLCPutBytes( PPPContext_t * pxContext,
+                             const uint8_t * pucData,
+                             size_t uxLength,
+                             uint32_t ulACCM )
+{
+    size_t uxIndex = 0U;
+
+    pxContext->usTxFCS = prvFCSUpdate( pxContext->usTxFCS, pucData, uxLength );
+
+    while( ( uxLength - uxIndex ) >= sizeof( uint32_t ) )
+    {
+        uint32_t ulWord;
+
+        ( void ) memcpy( &ulWord, &( pucData[ uxIndex ] ), sizeof( ulWord ) );
+
+        if( prvWordNeedsEscape( ulWord, ulACCM ) == pdFALSE )
+        {
+            if( ( sizeof( pxContext->ucTxChunk ) - pxContext->uxTxLength ) < sizeof( ulWord ) )
+            {
+                prvHDLCFlush( pxContext );
+            }
+
+            ( void ) memcpy( &( pxContext->ucTxChunk[ pxContext->uxTxLength ] ), &ulWord, sizeof( ulWord ) );
+            pxContext->uxTxLength += sizeof( ulWord );
+            uxIndex += sizeof( ulWord );
+        }
+        else
+        {
+            size_t uxLast = uxIndex + sizeof( ulWord );
+
+            for( ; uxIndex < uxLast; uxIndex++ )
+            {
+                prvHDLCPutByte( pxContext, pucData[ uxIndex ], ulACCM );
+            }
+        }
+    }
+
+    for( ; uxIndex < uxLength; uxIndex++ )
+    {
+        prvHDLCPutByte( pxContext, pucData[ uxIndex ], ulACCM );
+    }
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Encode a PPP frame and write it to the serial line. The caller
+ *        holds 'xTxMutex'.
+ *
+ * @param[in] pxContext The PPP interface.
+ * @param[in] pxSettings The negotiated options.
+ * @param[in] usProtocol The protocol number.
+ * @param[in] pucData The information field.
+ * @param[in] uxLength The length of the information field.
+ */
+static void prvEncodeFrame( PPPContext_t * pxContext,
+                            const PPPTxSettings_t * pxSettings,
+                            uint16_t usProtocol,
+                            const uint8_t * pucData,
+                            size_t uxLength )
+{
+    uint8_t ucHeader[ 4 ];
+    uint8_t ucFCS[ pppFCS_LENGTH ];
+    size_t uxHeaderLength = 0U;
+    uint32_t ulACCM = pppDEFAULT_ACCM;
+    BaseType_t xNegotiated = pdFALSE;
+    uint16_t usFCS;
+
+    /* LCP packets are always sent with the default ACCM and without
+     * header compression, RFC 1662 section 7. */
+    if( ( usProtocol != pppPROTOCOL_LCP ) && ( pxSettings->xNegotiated != pdFALSE ) )
+    {
+        ulACCM = pxSettings->ulACCM;
+        xNegotiated = pdTRUE;
+    }
+
+    if( ( xNegotiated == pdFALSE ) || ( pxSettings->xACFC == pdFALSE ) )
+    {
+        ucHeader[ uxHeaderLength ] = pppHDLC_ADDRESS;
+        ucHeader[ uxHeaderLength + 1U ] = pppHDLC_CONTROL;
+        uxHeaderLength += 2U;
+    }
+
+    if( ( xNegotiated != pdFALSE ) && ( pxSettings->xPFC != pdFALSE ) && ( usProtocol < 0x0100U ) )
+    {
+        ucHeader[ uxHeaderLength ] = ( uint8_t ) usProtocol;
+        uxHeaderLength += 1U;
+    }
+    else
+    {
+        prvPut16( &( ucHeader[ uxHeaderLength ] ), usProtocol );
+        uxHeaderLength += 2U;
+    }
+
+    pxContext->usTxFCS = pppFCS_INIT;
+    prvHDLCPutRaw( pxContext, pppHDLC_FLAG );
+    prvHDLCPutBytes( pxContext, ucHeader, uxHeaderLength, ulACCM );
+    prvHDLCPutBytes( pxContext, pucData, uxLength, ulACCM );
+
+    /* The FCS is sent inverted, least significant byte first. */
+    usFCS = ( uint16_t ) ( pxContext->usTxFCS ^ 0xFFFFU );
+    ucFCS[ 0 ] = ( uint8_t ) usFCS;
+    ucFCS[ 1 ] = ( uint8_t ) ( usFCS >> 8 );
+    prvHDLCPutBytes( pxContext, ucFCS, sizeof( ucFCS ), ulACCM );
+    prvHDLCPutRaw( pxContext, pppHDLC_FLAG );
+    prvHDLCFlush( pxContext );
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Get the negotiated options, only called by the PPP task.
+ */
+static void prvGetTxSettings( const PPPContext_t * pxContext,
+                              PPPTxSettings_t * pxSettings )
+{
+    ( void ) memset( pxSettings, 0, sizeof( *pxSettings ) );
+    pxSettings->ulACCM = pxContext->ulTxACCM;
+    pxSettings->xNegotiated = ( pxContext->xLCP.eState == eFsmOpened ) ? pdTRUE : pdFALSE;
+    pxSettings->xPFC = pxContext->xTxPFC;
+    pxSettings->xACFC = pxContext->xTxACFC;
+
+    #if ( ipconfigUSE_IPv4 != 0 )
+        pxSettings->xIPv4Opened = ( pxContext->xIPCP.eState == eFsmOpened ) ? pdTRUE : pdFALSE;
+    #endif
+
+    #if ( ipconfigUSE_IPv6 != 0 )
+        pxSettings->xIPv6Opened = ( pxContext->xIPV6CP.eState == eFsmOpened ) ? pdTRUE : pdFALSE;
+    #endif
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Let the TX task see the options that the PPP task has negotiated.
+ */
+static void prvUpdateTxSettings( PPPContext_t * pxContext )
+{
+    PPPTxSettings_t xSettings;
+
+    prvGetTxSettings( pxContext, &( xSettings ) );
+
+    /* Only the PPP task writes 'xTxSettings', so it may compare without the
+     * mutex. The mutex is only taken when something has changed. */
+    if( memcmp( &( xSettings ), &( pxContext->xTxSettings ), sizeof( xSettings ) ) != 0 )
+    {
+        if( xSemaphoreTake( pxContext->xTxMutex, portMAX_DELAY ) == pdPASS )
+        {
+            ( void ) memcpy( &( pxContext->xTxSettings ), &( xSettings ), sizeof( xSettings ) );
+            ( void ) xSemaphoreGive( pxContext->xTxMutex );
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Send a PPP frame from the PPP task.
+ *
+ * @param[in] pxContext The PPP interface.
+ * @param[in] usProtocol The protocol number.
+ * @param[in] pucData The information field.
+ * @param[in] uxLength The length of the information field.
+ */
+static void prvSendFrame( PPPContext_t * pxContext,
+                          uint16_t usProtocol,
+                          const uint8_t * pucData,
+                          size_t uxLength )
+{
+    PPPTxSettings_t xSettings;
+
+    prvGetTxSettings( pxContext, &( xSettings ) );
+
+    if( xSemaphoreTake( pxContext->xTxMutex, portMAX_DELAY ) == pdPASS )
+    {
+        prvEncodeFrame( pxContext, &( xSettings ), usProtocol, pucData, uxLength );
+        ( void ) xSemaphoreGive( pxContext->xTxMutex );
+    }
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Send the control packet in 'pxContext->ucPacket', after filling in its header.
+ */
+static void prvSendControl( PPPContext_t * pxContext,
+                            uint16_t usProtocol,
+                            uint8_t ucCode,
+                            uint8_t ucIdentifier,
+                            size_t uxLength )
+{
+    pxContext->ucPacket[ 0 ] = ucCode;
+    pxContext->ucPacket[ 1 ] = ucIdentifier;
+    prvPut16( &( pxContext->ucPacket[ 2 ] ), ( uint16_t ) uxLength );
+
+    prvSendFrame( pxContext, usProtocol, pxContext->ucPacket, uxLength );
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Send a Code-Reject or Protocol-Reject, which carries the rejected packet.
+ */
+static void prvSendReject( PPPContext_t * pxContext,
+                           uint8_t ucCode,
+                           const uint8_t * pucPrefix,
+                           size_t uxPrefixLength,
+                           const uint8_t * pucRejected,
+                           size_t uxRejectedLength )
+{
+    size_t uxLength = pppHEADER_LENGTH;
+    size_t uxCopy = uxRejectedLength;
+    size_t uxSpace = sizeof( pxContext->ucPacket );
+
+    /* The reject may not exceed the MRU of the peer. */
+    if( uxSpace > pxContext->usPeerMRU )
+    {
+        uxSpace = pxContext->usPeerMRU;
+    }
+
+    if( uxPrefixLength > 0U )
+    {
+        ( void ) memcpy( &( pxContext->ucPacket[ uxLength ] ), pucPrefix, uxPrefixLength );
+        uxLength += uxPrefixLength;
+    }
+
+    if( uxCopy > ( uxSpace - uxLength ) )
+    {
+        uxCopy = uxSpace - uxLength;
+    }
+
+    ( void ) memcpy( &( pxContext->ucPacket[ uxLength ] ), pucRejected, uxCopy );
+    uxLength += uxCopy;
+
+    pxContext->xLCP.ucRequestID++;
+    prvSendControl( pxContext, pppPROTOCOL_LCP, ucCode, pxContext->xLCP.ucRequestID, uxLength );
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Pass a packet to the IP-task, as if it was received by this interface.
+ */
+static void prvPostToIPTask( PPPContext_t * pxContext,
+                             NetworkBufferDescriptor_t * pxDescriptor )
+{
+    IPStackEvent_t xRxEvent;
+
+    pxDescriptor->pxInterface = pxContext->pxInterface;
+    pxDescriptor->pxEndPoint = FreeRTOS_MatchingEndpoint( pxContext->pxInterface, pxDescriptor->pucEthernetBuffer );
+
+    xRxEvent.eEventType = eNetworkRxEvent;
+    xRxEvent.pvData = ( void * ) pxDescriptor;
+
+    if( xSendEventStructToIPTask( &xRxEvent, 0U ) != pdTRUE )
+    {
+        vReleaseNetworkBufferAndDescriptor( pxDescriptor );
+        iptraceETHERNET_RX_EVENT_LOST();
+        FreeRTOS_debug_printf( ( "prvPostToIPTask: Can not queue a packet\n" ) );
+    }
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Hand an IP packet from the peer to the IP-task, after giving it an Ethernet header.
+ */
+static void prvDeliverPacket( PPPContext_t * pxContext,
+                              uint16_t usFrameType,
+                              const uint8_t * pucData,
+                              size_t uxLength )
+{
+    NetworkBufferDescriptor_t * pxDescriptor = NULL;
+    NetworkEndPoint_t * pxEndPoint = FreeRTOS_FirstEndPoint( pxContext->pxInterface );
+
+    if( ( uxLength <= ipconfigNETWORK_MTU ) && ( pxEndPoint != NULL ) )
+    {
+        pxDescriptor = pxGetNetworkBufferWithDescriptor( uxLength + ipSIZE_OF_ETH_HEADER, 0U );
+    }
+
+    if( pxDescriptor != NULL )
+    {
+        EthernetHeader_t * pxEthernetHeader = ( ( EthernetHeader_t * ) pxDescriptor->pucEthernetBuffer );
+
+        ( void ) memcpy( pxEthernetHeader->xDestinationAddress.ucBytes, pxEndPoint->xMACAddress.ucBytes, sizeof( MACAddress_t ) );
+        ( void ) memcpy( pxEthernetHeader->xSourceAddress.ucBytes, xPeerMACAddress.ucBytes, sizeof( MACAddress_t ) );
+        pxEthernetHeader->usFrameType = usFrameType;
+        ( void ) memcpy( &( pxDescriptor->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER ] ), pucData, uxLength );
+        pxDescriptor->xDataLength = uxLength + ipSIZE_OF_ETH_HEADER;
+
+        prvPostToIPTask( pxContext, pxDescriptor );
+    }
+    else
+    {
+        iptraceETHERNET_RX_EVENT_LOST();
+    }
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief The first end-point of an interface with the given IP-type.
+ */
+static NetworkEndPoint_t * prvFindEndPoint( const PPPContext_t * pxContext,
+                                            BaseType_t xIPv6 )
+{
+    NetworkEndPoint_t * pxEndPoint;
+
+    for( pxEndPoint = FreeRTOS_FirstEndPoint( pxContext->pxInterface );
+         pxEndPoint != NULL;
+         pxEndPoint = FreeRTOS_NextEndPoint( pxContext->pxInterface, pxEndPoint ) )
+    {
+        if( ( ( pxEndPoint->bits.bIPv6 != pdFALSE_UNSIGNED ) ? pdTRUE : pdFALSE ) == xIPv6 )
+        {
+            break;
+        }
+    }
+
+    return pxEndPoint;
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Calculate the MD5 digest of a short message, RFC 1321.
+ *
+ * @param[in] pucData The message.
+ * @param[in] uxLength The length of the message.
+ * @param[out] pucDigest Receives the 16 bytes of the digest.
+ */
+static void prvMD5( const uint8_t * pucData,
+                    size_t uxLength,
+                    uint8_t * pucDigest )
+{
+    static const uint32_t ulSines[ 64 ] =
+    {
+        0xD76AA478U, 0xE8C7B756U, 0x242070DBU, 0xC1BDCEEEU,
+        0xF57C0FAFU, 0x4787C62AU, 0xA8304613U, 0xFD469501U,
+        0x698098D8U, 0x8B44F7AFU, 0xFFFF5BB1U, 0x895CD7BEU,
+        0x6B901122U, 0xFD987193U, 0xA679438EU, 0x49B40821U,
+        0xF61E2562U, 0xC040B340U, 0x265E5A51U, 0xE9B6C7AAU,
+        0xD62F105DU, 0x02441453U, 0xD8A1E681U, 0xE7D3FBC8U,
+        0x21E1CDE6U, 0xC33707D6U, 0xF4D50D87U, 0x455A14EDU,
+        0xA9E3E905U, 0xFCEFA3F8U, 0x676F02D9U, 0x8D2A4C8AU,
+        0xFFFA3942U, 0x8771F681U, 0x6D9D6122U, 0xFDE5380CU,
+        0xA4BEEA44U, 0x4BDECFA9U, 0xF6BB4B60U, 0xBEBFBC70U,
+        0x289B7EC6U, 0xEAA127FAU, 0xD4EF3085U, 0x04881D05U,
+        0xD9D4D039U, 0xE6DB99E5U, 0x1FA27CF8U, 0xC4AC5665U,
+        0xF4292244U, 0x432AFF97U, 0xAB9423A7U, 0xFC93A039U,
+        0x655B59C3U, 0x8F0CCC92U, 0xFFEFF47DU, 0x85845DD1U,
+        0x6FA87E4FU, 0xFE2CE6E0U, 0xA3014314U, 0x4E0811A1U,
+        0xF7537E82U, 0xBD3AF235U, 0x2AD7D2BBU, 0xEB86D391U
+    };
+    static const uint8_t ucShifts[ 16 ] = { 7U, 12U, 17U, 22U, 5U, 9U, 14U, 20U, 4U, 11U, 16U, 23U, 6U, 10U, 15U, 21U };
+    uint32_t ulState[ 4 ] = { 0x67452301U, 0xEFCDAB89U, 0x98BADCFEU, 0x10325476U };
+    uint8_t ucBlock[ 64 ];
+    size_t uxOffset = 0U;
+    size_t uxIndex;
+    BaseType_t xPadded = pdFALSE;
+    BaseType_t xDone = pdFALSE;
+    uint64_t ullBits = ( ( uint64_t ) uxLength ) * 8U;
+
+    while( xDone == pdFALSE )
+    {
+        uint32_t ulWords[ 16 ];
+        uint32_t ulA = ulState[ 0 ];
+        uint32_t ulB = ulState[ 1 ];
+        uint32_t ulC = ulState[ 2 ];
+        uint32_t ulD = ulState[ 3 ];
+        size_t uxCopy = 0U;
+
+        /* Fill the block with message bytes, followed by the padding. */
+        ( void ) memset( ucBlock, 0, sizeof( ucBlock ) );
+
+        if( uxOffset < uxLength )
+        {
+            uxCopy = ( ( uxLength - uxOffset ) < sizeof( ucBlock ) ) ? ( uxLength - uxOffset ) : sizeof( ucBlock );
+            ( void ) memcpy( ucBlock, &( pucData[ uxOffset ] ), uxCopy );
+            uxOffset += uxCopy;
+        }
+
+        if( ( uxCopy < sizeof( ucBlock ) ) && ( xPadded == pdFALSE ) )
+        {
+            ucBlock[ uxCopy ] = 0x80U;
+            uxCopy++;
+            xPadded = pdTRUE;
+        }
+
+        if( ( xPadded != pdFALSE ) && ( uxCopy <= ( sizeof( ucBlock ) - 8U ) ) )
+        {
+            for( uxIndex = 0U; uxIndex < 8U; uxIndex++ )
+            {
+                ucBlock[ 56U + uxIndex ] = ( uint8_t ) ( ullBits >> ( 8U * uxIndex ) );
+            }
+
+            xDone = pdTRUE;
+        }
+
+        for( uxIndex = 0U; uxIndex < 16U; uxIndex++ )
+        {
+            ulWords[ uxIndex ] = ( ( uint32_t ) ucBlock[ 4U * uxIndex ] ) |
+                                 ( ( ( uint32_t ) ucBlock[ ( 4U * uxIndex ) + 1U ] ) << 8 ) |
+                                 ( ( ( uint32_t ) ucBlock[ ( 4U * uxIndex ) + 2U ] ) << 16 ) |
+                                 ( ( ( uint32_t ) ucBlock[ ( 4U * uxIndex ) + 3U ] ) << 24 );
+        }
+
+        for( uxIndex = 0U; uxIndex < 64U; uxIndex++ )
+        {
+            uint32_t ulF;
+            size_t uxWord;
+            uint32_t ulShift = ucShifts[ ( ( uxIndex / 16U ) * 4U ) + ( uxIndex % 4U ) ];
+            uint32_t ulTemp;
+
+            if( uxIndex < 16U )
+            {
+                ulF = ( ulB & ulC ) | ( ~ulB & ulD );
+                uxWord = uxIndex;
+            }
+            else if( uxIndex < 32U )
+            {
+                ulF = ( ulD & ulB ) | ( ~ulD & ulC );
+                uxWord = ( ( 5U * uxIndex ) + 1U ) % 16U;
+            }
+            else if( uxIndex < 48U )
+            {
+                ulF = ulB ^ ulC ^ ulD;
+                uxWord = ( ( 3U * uxIndex ) + 5U ) % 16U;
+            }
+            else
+            {
+                ulF = ulC ^ ( ulB | ~ulD );
+                uxWord = ( 7U * uxIndex ) % 16U;
+            }
+
+            ulTemp = ulA + ulF + ulSines[ uxIndex ] + ulWords[ uxWord ];
+            ulA = ulD;
+            ulD = ulC;
+            ulC = ulB;
+            ulB = ulB + ( ( ulTemp << ulShift ) | ( ulTemp >> ( 32U - ulShift ) ) );
+        }
+
+        ulState[ 0 ] += ulA;
+        ulState[ 1 ] += ulB;
+        ulState[ 2 ] += ulC;
+        ulState[ 3 ] += ulD;
+    }
+
+    for( uxIndex = 0U; uxIndex < pppMD5_LENGTH; uxIndex++ )
+    {
+        pucDigest[ uxIndex ] = ( uint8_t ) ( ulState[ uxIndex / 4U ] >> ( 8U * ( uxIndex % 4U ) ) );
+    }
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * The option negotiation automaton, RFC 1661 section 4. It is shared by LCP,
+ * IPCP and IPV6CP, the options are handled by the functions in 'pxProtocol'.
+ */
+
+static void prvFsmStartTimer( PPPFsm_t * pxFsm )
+{
+    pxFsm->xTimerRunning = pdTRUE;
+    pxFsm->xTimerStart = xTaskGetTickCount();
+}
+/*-----------------------------------------------------------*/
+
+static void prvFsmSendRequest( PPPContext_t * pxContext,
+                               PPPFsm_t * pxFsm )
+{
+    size_t uxLength;
+
+    pxFsm->ucRequestID++;
+    uxLength = pxFsm->pxProtocol->pfAddOptions( pxContext, &( pxContext->ucPacket[ pppHEADER_LENGTH ] ) );
+    prvSendControl( pxContext, pxFsm->pxProtocol->usProtocol, pppCONFIGURE_REQUEST, pxFsm->ucRequestID, pppHEADER_LENGTH + uxLength );
+
+    if( pxFsm->ucRetries > 0U )
+    {
+        pxFsm->ucRetries--;
+    }
+
+    prvFsmStartTimer( pxFsm );
+}
+/*-----------------------------------------------------------*/
+
+static void prvFsmSendTerminate( PPPContext_t * pxContext,
+                                 PPPFsm_t * pxFsm )
+{
+    pxFsm->ucRequestID++;
+    prvSendControl( pxContext, pxFsm->pxProtocol->usProtocol, pppTERMINATE_REQUEST, pxFsm->ucRequestID, pppHEADER_LENGTH );
+
+    if( pxFsm->ucRetries > 0U )
+    {
+        pxFsm->ucRetries--;
+    }
+
+    prvFsmStartTimer( pxFsm );
+}
+/*-----------------------------------------------------------*/
+
+static void prvFsmThisLayerUp( PPPContext_t * pxContext,
+                               PPPFsm_t * pxFsm )
+{
+    pxFsm->eState = eFsmOpened;
+    pxFsm->xTimerRunning = pdFALSE;
+    FreeRTOS_printf( ( "PPP: %s opened\n", pxFsm->pxProtocol->pcName ) );
+    pxFsm->pxProtocol->pfUp( pxContext );
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Leave the opened state and send a new Configure-Request.
+ */
+static void prvFsmRenegotiate( PPPContext_t * pxContext,
+                               PPPFsm_t * pxFsm )
+{
+    if( pxFsm->eState == eFsmOpened )
+    {
+        pxFsm->pxProtocol->pfDown( pxContext );
+    }
+
+    pxFsm->eState = eFsmReqSent;
+    pxFsm->ucRetries = niPPP_MAX_CONFIGURE;
+    prvFsmSendRequest( pxContext, pxFsm );
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Start the negotiation. The caller has set the options that will be requested.
+ */
+static void prvFsmOpen( PPPContext_t * pxContext,
+                        PPPFsm_t * pxFsm )
+{
+    pxFsm->eState = eFsmReqSent;
+    pxFsm->ucRetries = niPPP_MAX_CONFIGURE;
+    prvFsmSendRequest( pxContext, pxFsm );
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Ask the peer to terminate the protocol.
+ */
+static void prvFsmClose( PPPContext_t * pxContext,
+                         PPPFsm_t * pxFsm )
+{
+    if( pxFsm->eState == eFsmOpened )
+    {
+        pxFsm->pxProtocol->pfDown( pxContext );
+    }
+
+    if( ( pxFsm->eState != eFsmClosed ) && ( pxFsm->eState != eFsmClosing ) )
+    {
+        pxFsm->eState = eFsmClosing;
+        pxFsm->ucRetries = niPPP_MAX_TERMINATE;
+        prvFsmSendTerminate( pxContext, pxFsm );
+    }
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief The layer below has gone, stop without sending anything.
+ */
+static void prvFsmLowerDown( PPPContext_t * pxContext,
+                             PPPFsm_t * pxFsm )
+{
+    if( pxFsm->eState == eFsmOpened )
+    {
+        pxFsm->pxProtocol->pfDown( pxContext );
+    }
+
+    pxFsm->eState = eFsmClosed;
+    pxFsm->xTimerRunning = pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief The restart timer has expired.
+ */
+static void prvFsmTimeout( PPPContext_t * pxContext,
+                           PPPFsm_t * pxFsm )
+{
+    pxFsm->xTimerRunning = pdFALSE;
+
+    if( pxFsm->ucRetries > 0U )
+    {
+        if( pxFsm->eState == eFsmClosing )
+        {
+            prvFsmSendTerminate( pxContext, pxFsm );
+        }
+        else
+        {
+            if( pxFsm->eState == eFsmAckRcvd )
+            {
+                pxFsm->eState = eFsmReqSent;
+            }
+
+            prvFsmSendRequest( pxContext, pxFsm );
+        }
+    }
+    else
+    {
+        FreeRTOS_printf( ( "PPP: %s gives up\n", pxFsm->pxProtocol->pcName ) );
+        pxFsm->eState = eFsmClosed;
+        pxFsm->pxProtocol->pfFinished( pxContext );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvFsmCheckTimer( PPPContext_t * pxContext,
+                              PPPFsm_t * pxFsm )
+{
+    if( ( pxFsm->xTimerRunning != pdFALSE ) &&
+        ( ( xTaskGetTickCount() - pxFsm->xTimerStart ) >= pdMS_TO_TICKS( niPPP_RESTART_TIMER_MS ) ) )
+    {
+        prvFsmTimeout( pxContext, pxFsm );
+    }
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Append an option to the reply in 'pxContext->ucPacket', if it fits.
+ */
+static size_t prvAppendOption( PPPContext_t * pxContext,
+                               size_t uxLength,
+                               const uint8_t * pucOption )
+{
+    size_t uxResult = uxLength;
+
+    if( ( uxLength + pucOption[ 1 ] ) <= sizeof( pxContext->ucPacket ) )
+    {
+        ( void ) memcpy( &( pxContext->ucPacket[ uxLength ] ), pucOption, pucOption[ 1 ] );
+        uxResult += pucOption[ 1 ];
+    }
+
+    return uxResult;
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Handle the Configure-Request of the peer: reject the options that
+ *        are not recognised, else nak the values that are not acceptable,
+ *        else acknowledge and apply all options.
+ */
+static void prvFsmReceiveRequest( PPPContext_t * pxContext,
+                                  PPPFsm_t * pxFsm,
+                                  uint8_t ucIdentifier,
+                                  const uint8_t * pucOptions,
+                                  size_t uxLength )
+{
+    const PPPProtocol_t * pxProtocol = pxFsm->pxProtocol;
+    uint8_t ucCode = pppCONFIGURE_ACK;
+    size_t uxReplyLength = pppHEADER_LENGTH;
+    size_t uxOffset;
+
+    if( prvOptionsValid( pucOptions, uxLength ) != pdFALSE )
+    {
+        for( uxOffset = 0U; uxOffset < uxLength; uxOffset += pucOptions[ uxOffset + 1U ] )
+        {
+            if( pxProtocol->pfCheckOption( pxContext, &( pucOptions[ uxOffset ] ), NULL ) == eOptionReject )
+            {
+                ucCode = pppCONFIGURE_REJECT;
+                uxReplyLength = prvAppendOption( pxContext, uxReplyLength, &( pucOptions[ uxOffset ] ) );
+            }
+        }
+
+        if( ucCode == pppCONFIGURE_ACK )
+        {
+            uint8_t ucNak[ pppMAX_NAK_LENGTH ];
+
+            for( uxOffset = 0U; uxOffset < uxLength; uxOffset += pucOptions[ uxOffset + 1U ] )
+            {
+                if( pxProtocol->pfCheckOption( pxContext, &( pucOptions[ uxOffset ] ), ucNak ) == eOptionNak )
+                {
+                    ucCode = pppCONFIGURE_NAK;
+                    uxReplyLength = prvAppendOption( pxContext, uxReplyLength, ucNak );
+                }
+            }
+        }
+
+        if( ucCode == pppCONFIGURE_ACK )
+        {
+            pxProtocol->pfApplyOption( pxContext, NULL );
+
+            for( uxOffset = 0U; uxOffset < uxLength; uxOffset += pucOptions[ uxOffset + 1U ] )
+            {
+                pxProtocol->pfApplyOption( pxContext, &( pucOptions[ uxOffset ] ) );
+                uxReplyLength = prvAppendOption( pxContext, uxReplyLength, &( pucOptions[ uxOffset ] ) );
+            }
+        }
+
+        prvSendControl( pxContext, pxProtocol->usProtocol, ucCode, ucIdentifier, uxReplyLength );
+
+        switch( pxFsm->eState )
+        {
+            case eFsmOpened:
+                prvFsmRenegotiate( pxContext, pxFsm );
+                pxFsm->eState = ( ucCode == pppCONFIGURE_ACK ) ? eFsmAckSent : eFsmReqSent;
+                break;
+
+            case eFsmReqSent:
+            case eFsmAckSent:
+                pxFsm->eState = ( ucCode == pppCONFIGURE_ACK ) ? eFsmAckSent : eFsmReqSent;
+                break;
+
+            case eFsmAckRcvd:
+
+                if( ucCode == pppCONFIGURE_ACK )
+                {
+                    prvFsmThisLayerUp( pxContext, pxFsm );
+                }
+
+                break;
+
+            default:
+                /* Closed or closing. */
+                break;
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvFsmReceiveAck( PPPContext_t * pxContext,
+                              PPPFsm_t * pxFsm )
+{
+    switch( pxFsm->eState )
+    {
+        case eFsmReqSent:
+            pxFsm->eState = eFsmAckRcvd;
+            pxFsm->ucRetries = niPPP_MAX_CONFIGURE;
+            break;
+
+        case eFsmAckSent:
+            prvFsmThisLayerUp( pxContext, pxFsm );
+            break;
+
+        case eFsmAckRcvd:
+        case eFsmOpened:
+            /* A crossed connection, start all over. */
+            prvFsmRenegotiate( pxContext, pxFsm );
+            break;
+
+        default:
+            /* Closed or closing. */
+            break;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvFsmReceiveNak( PPPContext_t * pxContext,
+                              PPPFsm_t * pxFsm,
+                              const uint8_t * pucOptions,
+                              size_t uxLength,
+                              BaseType_t xIsReject )
+{
+    size_t uxOffset;
+
+    if( ( pxFsm->eState != eFsmClosed ) &&
+        ( pxFsm->eState != eFsmClosing ) &&
+        ( prvOptionsValid( pucOptions, uxLength ) != pdFALSE ) )
+    {
+        for( uxOffset = 0U; uxOffset < uxLength; uxOffset += pucOptions[ uxOffset + 1U ] )
+        {
+            pxFsm->pxProtocol->pfNakOption( pxContext, &( pucOptions[ uxOffset ] ), xIsReject );
+        }
+
+        if( pxFsm->eState == eFsmAckSent )
+        {
+            /* Our request changed, the peer's request is still acknowledged. */
+            pxFsm->ucRetries = niPPP_MAX_CONFIGURE;
+            prvFsmSendRequest( pxContext, pxFsm );
+        }
+        else
+        {
+            prvFsmRenegotiate( pxContext, pxFsm );
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvFsmReceiveTerminate( PPPContext_t * pxContext,
+                                    PPPFsm_t * pxFsm,
+                                    uint8_t ucIdentifier )
+{
+    prvSendControl( pxContext, pxFsm->pxProtocol->usProtocol, pppTERMINATE_ACK, ucIdentifier, pppHEADER_LENGTH );
+
+    switch( pxFsm->eState )
+    {
+        case eFsmOpened:
+            FreeRTOS_printf( ( "PPP: %s terminated by the peer\n", pxFsm->pxProtocol->pcName ) );
+            pxFsm->pxProtocol->pfDown( pxContext );
+            pxFsm->eState = eFsmClosed;
+            pxFsm->xTimerRunning = pdFALSE;
+            pxFsm->pxProtocol->pfFinished( pxContext );
+            break;
+
+        case eFsmAckRcvd:
+        case eFsmAckSent:
+            pxFsm->eState = eFsmReqSent;
+            break;
+
+        default:
+            /* Nothing to do. */
+            break;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvFsmReceiveTerminateAck( PPPContext_t * pxContext,
+                                       PPPFsm_t * pxFsm )
+{
+    switch( pxFsm->eState )
+    {
+        case eFsmClosing:
+            pxFsm->eState = eFsmClosed;
+            pxFsm->xTimerRunning = pdFALSE;
+            pxFsm->pxProtocol->pfFinished( pxContext );
+            break;
+
+        case eFsmAckRcvd:
+            pxFsm->eState = eFsmReqSent;
+            break;
+
+        case eFsmOpened:
+            prvFsmRenegotiate( pxContext, pxFsm );
+            break;
+
+        default:
+            /* Nothing to do. */
+            break;
+    }
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Handle the LCP codes that are not part of the automaton.
+ *
+ * @return pdFALSE when the code is not known.
+ */
+static BaseType_t prvLCPReceiveExtra( PPPContext_t * pxContext,
+                                      uint8_t ucCode,
+                                      uint8_t ucIdentifier,
+                                      const uint8_t * pucData,
+                                      size_t uxLength )
+{
+    BaseType_t xKnown = pdTRUE;
+
+    switch( ucCode )
+    {
+        case pppPROTOCOL_REJECT:
+
+            if( uxLength >= 2U )
+            {
+                uint16_t usProtocol = prvGet16( pucData );
+
+                FreeRTOS_printf( ( "PPP: the peer rejects protocol %04X\n", ( unsigned ) usProtocol ) );
+
+                #if ( ipconfigUSE_IPv4 != 0 )
+                    if( usProtocol == pppPROTOCOL_IPCP )
+                    {
+                        prvFsmLowerDown( pxContext, &( pxContext->xIPCP ) );
+                        prvNCPFinished( pxContext );
+                    }
+                #endif
+
+                #if ( ipconfigUSE_IPv6 != 0 )
+                    if( usProtocol == pppPROTOCOL_IPV6CP )
+                    {
+                        prvFsmLowerDown( pxContext, &( pxContext->xIPV6CP ) );
+                        prvNCPFinished( pxContext );
+                    }
+                #endif
+            }
+
+            break;
+
+        case pppECHO_REQUEST:
+
+            if( pxContext->xLCP.eState == eFsmOpened )
+            {
+                size_t uxReplyLength = pppHEADER_LENGTH + 4U + uxLength;
+
+                if( uxReplyLength > sizeof( pxContext->ucPacket ) )
+                {
+                    uxReplyLength = sizeof( pxContext->ucPacket );
+                }
+
+                /* The data after the magic number is returned unchanged. */
+                if( uxLength > 4U )
+                {
+                    ( void ) memcpy( &( pxContext->ucPacket[ pppHEADER_LENGTH + 4U ] ), &( pucData[ 4 ] ), uxReplyLength - ( pppHEADER_LENGTH + 4U ) );
+                }
+                else
+                {
+                    uxReplyLength = pppHEADER_LENGTH + 4U;
+                }
+
+                prvPut32( &( pxContext->ucPacket[ pppHEADER_LENGTH ] ), pxContext->ulMagic );
+                prvSendControl( pxContext, pppPROTOCOL_LCP, pppECHO_REPLY, ucIdentifier, uxReplyLength );
+            }
+
+            break;
+
+        case pppECHO_REPLY:
+            pxContext->ucEchoMissed = 0U;
+            break;
+
+        case pppDISCARD_REQUEST:
+        case pppCODE_REJECT:
+            break;
+
+        default:
+            xKnown = pdFALSE;
+            break;
+    }
+
+    return xKnown;
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Handle a packet of LCP, IPCP or IPV6CP.
+ */
+static void prvFsmReceive( PPPContext_t * pxContext,
+                           PPPFsm_t * pxFsm,
+                           const uint8_t * pucPacket,
+                           size_t uxLength )
+{
+    if( uxLength >= pppHEADER_LENGTH )
+    {
+        uint8_t ucCode = pucPacket[ 0 ];
+        uint8_t ucIdentifier = pucPacket[ 1 ];
+        size_t uxPacketLength = prvGet16( &( pucPacket[ 2 ] ) );
+        const uint8_t * pucData = &( pucPacket[ pppHEADER_LENGTH ] );
+        size_t uxDataLength = uxPacketLength - pppHEADER_LENGTH;
+
+        /* Packets with a bad length are silently discarded, padding is ignored. */
+        if( ( uxPacketLength < pppHEADER_LENGTH ) || ( uxPacketLength > uxLength ) )
+        {
+            /* Drop it. */
+        }
+        else if( ( pxFsm->eState == eFsmClosed ) && ( ucCode <= pppTERMINATE_REQUEST ) )
+        {
+            /* Not negotiating, RFC 1661 section 4.3: answer with a Terminate-Ack. */
+            prvSendControl( pxContext, pxFsm->pxProtocol->usProtocol, pppTERMINATE_ACK, ucIdentifier, pppHEADER_LENGTH );
+        }
+        else
+        {
+            switch( ucCode )
+            {
+                case pppCONFIGURE_REQUEST:
+
+                    if( pxFsm->eState != eFsmClosing )
+                    {
+                        prvFsmReceiveRequest( pxContext, pxFsm, ucIdentifier, pucData, uxDataLength );
+                    }
+
+                    break;
+
+                case pppCONFIGURE_ACK:
+
+                    if( ucIdentifier == pxFsm->ucRequestID )
+                    {
+                        prvFsmReceiveAck( pxContext, pxFsm );
+                    }
+
+                    break;
+
+                case pppCONFIGURE_NAK:
+                case pppCONFIGURE_REJECT:
+
+                    if( ucIdentifier == pxFsm->ucRequestID )
+                    {
+                        prvFsmReceiveNak( pxContext, pxFsm, pucData, uxDataLength, ( ucCode == pppCONFIGURE_REJECT ) ? pdTRUE : pdFALSE );
+                    }
+
+                    break;
+
+                case pppTERMINATE_REQUEST:
+                    prvFsmReceiveTerminate( pxContext, pxFsm, ucIdentifier );
+                    break;
+
+                case pppTERMINATE_ACK:
+                    prvFsmReceiveTerminateAck( pxContext, pxFsm );
+                    break;
+
+                default:
+
+                    if( ( pxFsm != &( pxContext->xLCP ) ) ||
+                        ( prvLCPReceiveExtra( pxContext, ucCode, ucIdentifier, pucData, uxDataLength ) == pdFALSE ) )
+                    {
+                        prvSendReject( pxContext, pppCODE_REJECT, NULL, 0U, pucPacket, uxPacketLength );
+                    }
+
+                    break;
+            }
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * LCP, the link control protocol.
+ */
+
+static size_t prvLCPAddOptions( PPPContext_t * pxContext,
+                                uint8_t * pucOptions )
+{
+    size_t uxLength = 0U;
+    uint32_t ulWanted = pxContext->xLCP.ulWanted;
+
+    if( ( ulWanted & pppWANT_MRU ) != 0U )
+    {
+        uint8_t ucValue[ 2 ];
+
+        prvPut16( ucValue, pxContext->usMRU );
+        uxLength = prvAddOption( pucOptions, uxLength, pppLCP_MRU, ucValue, sizeof( ucValue ) );
+    }
+
+    if( ( ulWanted & pppWANT_ACCM ) != 0U )
+    {
+        uxLength = prvAddOption32( pucOptions, uxLength, pppLCP_ACCM, pxContext->ulRxACCM );
+    }
+
+    if( ( ulWanted & pppWANT_MAGIC ) != 0U )
+    {
+        uxLength = prvAddOption32( pucOptions, uxLength, pppLCP_MAGIC, pxContext->ulMagic );
+    }
+
+    if( ( ulWanted & pppWANT_PFC ) != 0U )
+    {
+        uxLength = prvAddOption( pucOptions, uxLength, pppLCP_PFC, NULL, 0U );
+    }
+
+    if( ( ulWanted & pppWANT_ACFC ) != 0U )
+    {
+        uxLength = prvAddOption( pucOptions, uxLength, pppLCP_ACFC, NULL, 0U );
+    }
+
+    return uxLength;
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Judge the authentication protocol that the peer asks for.
+ */
+static ePPPOptionResult_t prvLCPCheckAuth( const PPPContext_t * pxContext,
+                                           const uint8_t * pucOption,
+                                           uint8_t * pucNak )
+{
+    ePPPOptionResult_t eResult = eOptionNak;
+    uint16_t usProtocol = 0U;
+
+    if( pucOption[ 1 ] >= 4U )
+    {
+        usProtocol = prvGet16( &( pucOption[ 2 ] ) );
+    }
+
+    if( ( pxContext->xConfig.pcUser == NULL ) || ( pucOption[ 1 ] < 4U ) )
+    {
+        /* Without credentials we can not authenticate. */
+        eResult = eOptionReject;
+    }
+    else if( ( usProtocol == pppPROTOCOL_PAP ) && ( pucOption[ 1 ] == 4U ) )
+    {
+        eResult = eOptionAck;
+    }
+    else if( ( usProtocol == pppPROTOCOL_CHAP ) && ( pucOption[ 1 ] == 5U ) && ( pucOption[ 4 ] == pppCHAP_MD5 ) )
+    {
+        eResult = eOptionAck;
+    }
+    else if( pucNak != NULL )
+    {
+        /* Suggest CHAP-MD5, or PAP when the peer wants another CHAP algorithm. */
+        pucNak[ 0 ] = pppLCP_AUTH;
+
+        if( usProtocol == pppPROTOCOL_CHAP )
+        {
+            pucNak[ 1 ] = 4U;
+            prvPut16( &( pucNak[ 2 ] ), pppPROTOCOL_PAP );
+        }
+        else
+        {
+            pucNak[ 1 ] = 5U;
+            prvPut16( &( pucNak[ 2 ] ), pppPROTOCOL_CHAP );
+            pucNak[ 4 ] = pppCHAP_MD5;
+        }
+    }
+    else
+    {
+        /* Only the verdict was asked for. */
+    }
+
+    return eResult;
+}
+/*-----------------------------------------------------------*/
+
+static ePPPOptionResult_t prvLCPCheckOption( const PPPContext_t * pxContext,
+                                             const uint8_t * pucOption,
+                                             uint8_t * pucNak )
+{
+    ePPPOptionResult_t eResult = eOptionAck;
+    uint8_t ucLength = pucOption[ 1 ];
+
+    switch( pucOption[ 0 ] )
+    {
+        case pppLCP_MRU:
+
+            if( ucLength != 4U )
+            {
+                eResult = eOptionReject;
+            }
+            else if( prvGet16( &( pucOption[ 2 ] ) ) < pppMIN_MRU )
+            {
+                eResult = eOptionNak;
+
+                if( pucNak != NULL )
+                {
+                    pucNak[ 0 ] = pppLCP_MRU;
+                    pucNak[ 1 ] = 4U;
+                    prvPut16( &( pucNak[ 2 ] ), pppDEFAULT_MRU );
+                }
+            }
+            else
+            {
+                /* Acceptable. */
+            }
+
+            break;
+
+        case pppLCP_ACCM:
+
+            if( ucLength != 6U )
+            {
+                eResult = eOptionReject;
+            }
+
+            break;
+
+        case pppLCP_AUTH:
+            eResult = prvLCPCheckAuth( pxContext, pucOption, pucNak );
+            break;
+
+        case pppLCP_MAGIC:
+
+            if( ucLength != 6U )
+            {
+                eResult = eOptionReject;
+            }
+            else if( ( pxContext->ulMagic != 0U ) && ( prvGet32( &( pucOption[ 2 ] ) ) == pxContext->ulMagic ) )
+            {
+                /* The same number: either a coincidence or a looped-back line. */
+                eResult = eOptionNak;
+
+                if( pucNak != NULL )
+                {
+                    uint32_t ulNumber = 0U;
+
+                    ( void ) xApplicationGetRandomNumber( &( ulNumber ) );
+                    pucNak[ 0 ] = pppLCP_MAGIC;
+                    pucNak[ 1 ] = 6U;
+                    prvPut32( &( pucNak[ 2 ] ), ulNumber ^ pxContext->ulMagic );
+                }
+            }
+            else
+            {
+                /* Acceptable. */
+            }
+
+            break;
+
+        case pppLCP_PFC:
+        case pppLCP_ACFC:
+
+            if( ucLength != 2U )
+            {
+                eResult = eOptionReject;
+            }
+
+            break;
+
+        default:
+            eResult = eOptionReject;
+            break;
+    }
+
+    return eResult;
+}
+/*-----------------------------------------------------------*/
+
+static void prvLCPApplyOption( PPPContext_t * pxContext,
+                               const uint8_t * pucOption )
+{
+    if( pucOption == NULL )
+    {
+        pxContext->usPeerMRU = pppDEFAULT_MRU;
+        pxContext->ulTxACCM = pppDEFAULT_ACCM;
+        pxContext->usAuthProtocol = 0U;
+        pxContext->xTxPFC = pdFALSE;
+        pxContext->xTxACFC = pdFALSE;
+    }
+    else
+    {
+        switch( pucOption[ 0 ] )
+        {
+            case pppLCP_MRU:
+                pxContext->usPeerMRU = prvGet16( &( pucOption[ 2 ] ) );
+                break;
+
+            case pppLCP_ACCM:
+                pxContext->ulTxACCM = prvGet32( &( pucOption[ 2 ] ) );
+                break;
+
+            case pppLCP_AUTH:
+                pxContext->usAuthProtocol = prvGet16( &( pucOption[ 2 ] ) );
+                break;
+
+            case pppLCP_PFC:
+                pxContext->xTxPFC = pdTRUE;
+                break;
+
+            case pppLCP_ACFC:
+                pxContext->xTxACFC = pdTRUE;
+                break;
+
+            default:
+                /* The magic number of the peer is not stored. */
+                break;
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvLCPNakOption( PPPContext_t * pxContext,
+                             const uint8_t * pucOption,
+                             BaseType_t xIsReject )
+{
+    uint32_t ulFlag = 0U;
+
+    switch( pucOption[ 0 ] )
+    {
+        case pppLCP_MRU:
+            ulFlag = pppWANT_MRU;
+
+            if( ( xIsReject == pdFALSE ) && ( pucOption[ 1 ] == 4U ) )
+            {
+                uint16_t usMRU = prvGet16( &( pucOption[ 2 ] ) );
+
+                if( ( usMRU >= pppMIN_MRU ) && ( usMRU <= niPPP_MRU ) )
+                {
+                    pxContext->usMRU = usMRU;
+                }
+            }
+
+            break;
+
+        case pppLCP_ACCM:
+            ulFlag = pppWANT_ACCM;
+
+            if( ( xIsReject == pdFALSE ) && ( pucOption[ 1 ] == 6U ) )
+            {
+                pxContext->ulRxACCM = prvGet32( &( pucOption[ 2 ] ) );
+            }
+
+            break;
+
+        case pppLCP_MAGIC:
+            ulFlag = pppWANT_MAGIC;
+
+            if( xIsReject == pdFALSE )
+            {
+                ( void ) xApplicationGetRandomNumber( &( pxContext->ulMagic ) );
+            }
+
+            break;
+
+        case pppLCP_PFC:
+            /* A nak of a boolean option means the same as a reject. */
+            ulFlag = pppWANT_PFC;
+            xIsReject = pdTRUE;
+            break;
+
+        case pppLCP_ACFC:
+            ulFlag = pppWANT_ACFC;
+            xIsReject = pdTRUE;
+            break;
+
+        default:
+            /* We did not ask for it. */
+            break;
+    }
+
+    if( xIsReject != pdFALSE )
+    {
+        pxContext->xLCP.ulWanted &= ~ulFlag;
+
+        if( ulFlag == pppWANT_MAGIC )
+        {
+            pxContext->ulMagic = 0U;
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvPAPSendRequest( PPPContext_t * pxContext )
+{
+    size_t uxUserLength = strlen( pxContext->xConfig.pcUser );
+    size_t uxPasswordLength = ( pxContext->xConfig.pcPassword != NULL ) ? strlen( pxContext->xConfig.pcPassword ) : 0U;
+    size_t uxLength = pppHEADER_LENGTH;
+
+    if( ( pppHEADER_LENGTH + 2U + uxUserLength + uxPasswordLength ) <= sizeof( pxContext->ucPacket ) )
+    {
+        pxContext->ucPacket[ uxLength ] = ( uint8_t ) uxUserLength;
+        ( void ) memcpy( &( pxContext->ucPacket[ uxLength + 1U ] ), pxContext->xConfig.pcUser, uxUserLength );
+        uxLength += 1U + uxUserLength;
+        pxContext->ucPacket[ uxLength ] = ( uint8_t ) uxPasswordLength;
+
+        if( uxPasswordLength > 0U )
+        {
+            ( void ) memcpy( &( pxContext->ucPacket[ uxLength + 1U ] ), pxContext->xConfig.pcPassword, uxPasswordLength );
+        }
+
+        uxLength += 1U + uxPasswordLength;
+
+        pxContext->ucAuthID++;
+        prvSendControl( pxContext, pppPROTOCOL_PAP, pppPAP_REQUEST, pxContext->ucAuthID, uxLength );
+    }
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Start the network phase, open an NCP for every IP-type that has an end-point.
+ */
+static void prvNetworkPhase( PPPContext_t * pxContext )
+{
+    BaseType_t xStarted = pdFALSE;
+
+    pxContext->ePhase = ePPPNetwork;
+
+    #if ( ipconfigUSE_IPv4 != 0 )
+    {
+        pxContext->pxEndPointIPv4 = prvFindEndPoint( pxContext, pdFALSE );
+
+        if( pxContext->pxEndPointIPv4 != NULL )
+        {
+            pxContext->ulLocalIP = 0U;
+            pxContext->ulDNS[ 0 ] = 0U;
+            pxContext->ulDNS[ 1 ] = 0U;
+            pxContext->xIPCP.ulWanted = pppWANT_ADDRESS | pppWANT_DNS1 | pppWANT_DNS2;
+            prvFsmOpen( pxContext, &( pxContext->xIPCP ) );
+            xStarted = pdTRUE;
+        }
+    }
+    #endif /* if ( ipconfigUSE_IPv4 != 0 ) */
+
+    #if ( ipconfigUSE_IPv6 != 0 )
+    {
+        pxContext->pxEndPointIPv6 = prvFindEndPoint( pxContext, pdTRUE );
+
+        if( pxContext->pxEndPointIPv6 != NULL )
+        {
+            const uint8_t * pucMAC = pxContext->pxEndPointIPv6->xMACAddress.ucBytes;
+
+            /* A modified EUI-64 identifier, RFC 4291 appendix A. */
+            pxContext->ucLocalIID[ 0 ] = ( uint8_t ) ( pucMAC[ 0 ] ^ 0x02U );
+            pxContext->ucLocalIID[ 1 ] = pucMAC[ 1 ];
+            pxContext->ucLocalIID[ 2 ] = pucMAC[ 2 ];
+            pxContext->ucLocalIID[ 3 ] = 0xFFU;
+            pxContext->ucLocalIID[ 4 ] = 0xFEU;
+            pxContext->ucLocalIID[ 5 ] = pucMAC[ 3 ];
+            pxContext->ucLocalIID[ 6 ] = pucMAC[ 4 ];
+            pxContext->ucLocalIID[ 7 ] = pucMAC[ 5 ];
+            ( void ) memset( pxContext->ucPeerIID, 0, sizeof( pxContext->ucPeerIID ) );
+            pxContext->xIPV6CP.ulWanted = pppWANT_IID;
+            prvFsmOpen( pxContext, &( pxContext->xIPV6CP ) );
+            xStarted = pdTRUE;
+        }
+    }
+    #endif /* if ( ipconfigUSE_IPv6 != 0 ) */
+
+    if( xStarted == pdFALSE )
+    {
+        FreeRTOS_printf( ( "PPP: the interface has no end-points\n" ) );
+        prvFsmClose( pxContext, &( pxContext->xLCP ) );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvLCPUp( PPPContext_t * pxContext )
+{
+    pxContext->ucEchoMissed = 0U;
+    pxContext->xEchoTime = xTaskGetTickCount();
+
+    if( ( pxContext->usAuthProtocol == pppPROTOCOL_PAP ) || ( pxContext->usAuthProtocol == pppPROTOCOL_CHAP ) )
+    {
+        /* PAP requests are repeated, for CHAP this only limits the time
+         * that we wait for the challenge. */
+        pxContext->ePhase = ePPPAuthenticate;
+        pxContext->ucAuthRetries = niPPP_MAX_CONFIGURE;
+        pxContext->xAuthTime = xTaskGetTickCount();
+
+        if( pxContext->usAuthProtocol == pppPROTOCOL_PAP )
+        {
+            prvPAPSendRequest( pxContext );
+        }
+    }
+    else
+    {
+        prvNetworkPhase( pxContext );
+    }
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief The network can no longer be used, tell the IP-task.
+ */
+static void prvNetworkLost( PPPContext_t * pxContext )
+{
+    if( pxContext->xNetworkUp != pdFALSE )
+    {
+        pxContext->xNetworkUp = pdFALSE;
+        FreeRTOS_NetworkDown( pxContext->pxInterface );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvLCPDown( PPPContext_t * pxContext )
+{
+    #if ( ipconfigUSE_IPv4 != 0 )
+        prvFsmLowerDown( pxContext, &( pxContext->xIPCP ) );
+    #endif
+
+    #if ( ipconfigUSE_IPv6 != 0 )
+        prvFsmLowerDown( pxContext, &( pxContext->xIPV6CP ) );
+    #endif
+
+    pxContext->ePhase = ePPPEstablish;
+    prvNetworkLost( pxContext );
+}
+/*-----------------------------------------------------------*/
+
+static void prvLCPFinished( PPPContext_t * pxContext )
+{
+    FreeRTOS_printf( ( "PPP: the link is down\n" ) );
+    pxContext->ePhase = ePPPDead;
+    pxContext->xDeadTime = xTaskGetTickCount();
+    prvNetworkLost( pxContext );
+}
+/*-----------------------------------------------------------*/
+
+static void prvLinkStart( PPPContext_t * pxContext )
+{
+    pxContext->ePhase = ePPPEstablish;
+    pxContext->uxRxLength = 0U;
+    pxContext->xRxEscaped = pdFALSE;
+    pxContext->xRxOverflow = pdFALSE;
+
+    pxContext->xLCP.ulWanted = pppWANT_MRU | pppWANT_ACCM | pppWANT_MAGIC | pppWANT_PFC | pppWANT_ACFC;
+    pxContext->usMRU = niPPP_MRU;
+    pxContext->ulRxACCM = 0U;
+    ( void ) xApplicationGetRandomNumber( &( pxContext->ulMagic ) );
+    prvLCPApplyOption( pxContext, NULL );
+
+    prvFsmOpen( pxContext, &( pxContext->xLCP ) );
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * PAP and CHAP-MD5, we authenticate ourselves to the peer.
+ */
+
+static void prvPAPReceive( PPPContext_t * pxContext,
+                           const uint8_t * pucPacket,
+                           size_t uxLength )
+{
+    if( ( uxLength >= pppHEADER_LENGTH ) &&
+        ( pxContext->ePhase == ePPPAuthenticate ) &&
+        ( pxContext->usAuthProtocol == pppPROTOCOL_PAP ) &&
+        ( pucPacket[ 1 ] == pxContext->ucAuthID ) )
+    {
+        if( pucPacket[ 0 ] == pppPAP_ACK )
+        {
+            FreeRTOS_printf( ( "PPP: PAP authentication succeeded\n" ) );
+            prvNetworkPhase( pxContext );
+        }
+        else if( pucPacket[ 0 ] == pppPAP_NAK )
+        {
+            FreeRTOS_printf( ( "PPP: PAP authentication failed\n" ) );
+            prvFsmClose( pxContext, &( pxContext->xLCP ) );
+            pxContext->ePhase = ePPPTerminate;
+        }
+        else
+        {
+            /* We do not authenticate the peer. */
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvCHAPReceive( PPPContext_t * pxContext,
+                            const uint8_t * pucPacket,
+                            size_t uxLength )
+{
+    if( ( uxLength >= pppHEADER_LENGTH ) &&
+        ( pxContext->usAuthProtocol == pppPROTOCOL_CHAP ) &&
+        ( ( pxContext->ePhase == ePPPAuthenticate ) || ( pxContext->ePhase == ePPPNetwork ) ) )
+    {
+        switch( pucPacket[ 0 ] )
+        {
+            case pppCHAP_CHALLENGE:
+               {
+                   size_t uxValueLength = ( uxLength > pppHEADER_LENGTH ) ? pucPacket[ pppHEADER_LENGTH ] : 0U;
+                   size_t uxUserLength = strlen( pxContext->xConfig.pcUser );
+                   size_t uxSecretLength = ( pxContext->xConfig.pcPassword != NULL ) ? strlen( pxContext->xConfig.pcPassword ) : 0U;
+                   uint8_t * pucMessage = pxContext->ucPacket;
+                   uint8_t ucDigest[ pppMD5_LENGTH ];
+
+                   /* The response is MD5( identifier | secret | challenge ), RFC 1994 section 4.1.
+                    * The message is built in the packet buffer, before the response is. */
+                   if( ( uxValueLength > 0U ) &&
+                       ( ( pppHEADER_LENGTH + 1U + uxValueLength ) <= uxLength ) &&
+                       ( ( 1U + uxSecretLength + uxValueLength ) <= sizeof( pxContext->ucPacket ) ) &&
+                       ( ( pppHEADER_LENGTH + 1U + pppMD5_LENGTH + uxUserLength ) <= sizeof( pxContext->ucPacket ) ) )
+                   {
+                       pucMessage[ 0 ] = pucPacket[ 1 ];
+                       ( void ) memcpy( &( pucMessage[ 1 ] ), pxContext->xConfig.pcPassword, uxSecretLength );
+                       ( void ) memcpy( &( pucMessage[ 1U + uxSecretLength ] ), &( pucPacket[ pppHEADER_LENGTH + 1U ] ), uxValueLength );
+                       prvMD5( pucMessage, 1U + uxSecretLength + uxValueLength, ucDigest );
+
+                       pxContext->ucPacket[ pppHEADER_LENGTH ] = pppMD5_LENGTH;
+                       ( void ) memcpy( &( pxContext->ucPacket[ pppHEADER_LENGTH + 1U ] ), ucDigest, pppMD5_LENGTH );
+                       ( void ) memcpy( &( pxContext->ucPacket[ pppHEADER_LENGTH + 1U + pppMD5_LENGTH ] ), pxContext->xConfig.pcUser, uxUserLength );
+                       prvSendControl( pxContext, pppPROTOCOL_CHAP, pppCHAP_RESPONSE, pucPacket[ 1 ], pppHEADER_LENGTH + 1U + pppMD5_LENGTH + uxUserLength );
+                   }
+               }
+               break;
+
+            case pppCHAP_SUCCESS:
+
+                if( pxContext->ePhase == ePPPAuthenticate )
+                {
+                    FreeRTOS_printf( ( "PPP: CHAP authentication succeeded\n" ) );
+                    prvNetworkPhase( pxContext );
+                }
+
+                break;
+
+            case pppCHAP_FAILURE:
+                FreeRTOS_printf( ( "PPP: CHAP authentication failed\n" ) );
+                prvFsmClose( pxContext, &( pxContext->xLCP ) );
+                pxContext->ePhase = ePPPTerminate;
+                break;
+
+            default:
+                /* Not for a peer that authenticates itself. */
+                break;
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * The network control protocols.
+ */
+
+/**
+ * @brief Called when an NCP has opened or given up. When none is still
+ *        negotiating, let the IP-task bring up the end-points.
+ */
+static void prvNCPFinished( PPPContext_t * pxContext )
+{
+    BaseType_t xBusy = pdFALSE;
+    BaseType_t xOpened = pdFALSE;
+
+    #if ( ipconfigUSE_IPv4 != 0 )
+        if( pxContext->pxEndPointIPv4 != NULL )
+        {
+            if( pxContext->xIPCP.eState == eFsmOpened )
+            {
+                xOpened = pdTRUE;
+            }
+            else if( pxContext->xIPCP.eState != eFsmClosed )
+            {
+                xBusy = pdTRUE;
+            }
+            else
+            {
+                /* IPCP failed. */
+            }
+        }
+    #endif /* if ( ipconfigUSE_IPv4 != 0 ) */
+
+    #if ( ipconfigUSE_IPv6 != 0 )
+        if( pxContext->pxEndPointIPv6 != NULL )
+        {
+            if( pxContext->xIPV6CP.eState == eFsmOpened )
+            {
+                xOpened = pdTRUE;
+            }
+            else if( pxContext->xIPV6CP.eState != eFsmClosed )
+            {
+                xBusy = pdTRUE;
+            }
+            else
+            {
+                /* IPV6CP failed. */
+            }
+        }
+    #endif /* if ( ipconfigUSE_IPv6 != 0 ) */
+
+    if( ( xBusy == pdFALSE ) && ( pxContext->ePhase == ePPPNetwork ) )
+    {
+        if( xOpened == pdFALSE )
+        {
+            FreeRTOS_printf( ( "PPP: no network protocol could be opened\n" ) );
+            prvFsmClose( pxContext, &( pxContext->xLCP ) );
+            pxContext->ePhase = ePPPTerminate;
+        }
+        else if( pxContext->xNetworkUp == pdFALSE )
+        {
+            /* Let the IP-task initialise the interface again: pfInitialise()
+             * now returns pdPASS, and the end-points come up with the
+             * negotiated addresses. */
+            pxContext->xNetworkUp = pdTRUE;
+            FreeRTOS_NetworkDown( pxContext->pxInterface );
+        }
+        else
+        {
+            /* The network is up already. */
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvNCPDown( PPPContext_t * pxContext )
+{
+    prvNetworkLost( pxContext );
+}
+/*-----------------------------------------------------------*/
+
+#if ( ipconfigUSE_IPv4 != 0 )
+
+    static size_t prvIPCPAddOptions( PPPContext_t * pxContext,
+                                     uint8_t * pucOptions )
+    {
+        size_t uxLength = 0U;
+        uint32_t ulWanted = pxContext->xIPCP.ulWanted;
+
+        /* The addresses are in network byte order already. */
+        if( ( ulWanted & pppWANT_ADDRESS ) != 0U )
+        {
+            uxLength = prvAddOption( pucOptions, uxLength, pppIPCP_ADDRESS, ( const uint8_t * ) &( pxContext->ulLocalIP ), sizeof( uint32_t ) );
+        }
+
+        if( ( ulWanted & pppWANT_DNS1 ) != 0U )
+        {
+            uxLength = prvAddOption( pucOptions, uxLength, pppIPCP_DNS1, ( const uint8_t * ) &( pxContext->ulDNS[ 0 ] ), sizeof( uint32_t ) );
+        }
+
+        if( ( ulWanted & pppWANT_DNS2 ) != 0U )
+        {
+            uxLength = prvAddOption( pucOptions, uxLength, pppIPCP_DNS2, ( const uint8_t * ) &( pxContext->ulDNS[ 1 ] ), sizeof( uint32_t ) );
+        }
+
+        return uxLength;
+    }
+/*-----------------------------------------------------------*/
+
+    static ePPPOptionResult_t prvIPCPCheckOption( const PPPContext_t * pxContext,
+                                                  const uint8_t * pucOption,
+                                                  uint8_t * pucNak )
+    {
+        ePPPOptionResult_t eResult = eOptionReject;
+
+        ( void ) pxContext;
+        ( void ) pucNak;
+
+        /* The peer may tell its own address. An address of zero asks us to
+         * assign one, which we can't. Van Jacobson compression is rejected. */
+        if( ( pucOption[ 0 ] == pppIPCP_ADDRESS ) &&
+            ( pucOption[ 1 ] == 6U ) &&
+            ( prvGet32( &( pucOption[ 2 ] ) ) != 0U ) )
+        {
+            eResult = eOptionAck;
+        }
+
+        return eResult;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvIPCPApplyOption( PPPContext_t * pxContext,
+                                    const uint8_t * pucOption )
+    {
+        if( pucOption == NULL )
+        {
+            pxContext->ulPeerIP = 0U;
+        }
+        else if( pucOption[ 0 ] == pppIPCP_ADDRESS )
+        {
+            ( void ) memcpy( &( pxContext->ulPeerIP ), &( pucOption[ 2 ] ), sizeof( uint32_t ) );
+        }
+        else
+        {
+            /* Not accepted. */
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvIPCPNakOption( PPPContext_t * pxContext,
+                                  const uint8_t * pucOption,
+                                  BaseType_t xIsReject )
+    {
+        uint32_t ulFlag = 0U;
+        uint32_t * pulTarget = NULL;
+
+        switch( pucOption[ 0 ] )
+        {
+            case pppIPCP_ADDRESS:
+                ulFlag = pppWANT_ADDRESS;
+                pulTarget = &( pxContext->ulLocalIP );
+                break;
+
+            case pppIPCP_DNS1:
+                ulFlag = pppWANT_DNS1;
+                pulTarget = &( pxContext->ulDNS[ 0 ] );
+                break;
+
+            case pppIPCP_DNS2:
+                ulFlag = pppWANT_DNS2;
+                pulTarget = &( pxContext->ulDNS[ 1 ] );
+                break;
+
+            default:
+                /* We did not ask for it. */
+                break;
+        }
+
+        if( xIsReject != pdFALSE )
+        {
+            pxContext->xIPCP.ulWanted &= ~ulFlag;
+        }
+        else if( ( pulTarget != NULL ) && ( pucOption[ 1 ] == 6U ) )
+        {
+            /* The peer suggests the value that we should ask for. */
+            ( void ) memcpy( pulTarget, &( pucOption[ 2 ] ), sizeof( uint32_t ) );
+        }
+        else
+        {
+            /* Malformed. */
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvIPCPUp( PPPContext_t * pxContext )
+    {
+        IPV4Parameters_t * pxDefaults = &( pxContext->pxEndPointIPv4->ipv4_defaults );
+        uint32_t ulPeerIP = pxContext->ulPeerIP;
+        uint32_t ulDifference;
+        uint32_t ulNetMask = 0xFFFFFFFFU;
+        BaseType_t xIndex;
+
+        /* Some peers don't tell their address. Any address will do, the peer
+         * is the next hop for all of them. */
+        if( ulPeerIP == 0U )
+        {
+            ulPeerIP = FreeRTOS_htonl( 0x0A404040U ); /* 10.64.64.64 */
+        }
+
+        /* Use the longest netmask that contains both addresses, so that the
+         * peer can be the gateway. */
+        ulDifference = FreeRTOS_ntohl( pxContext->ulLocalIP ^ ulPeerIP );
+
+        while( ( ulDifference & ulNetMask ) != 0U )
+        {
+            ulNetMask <<= 1;
+        }
+
+        pxDefaults->ulIPAddress = pxContext->ulLocalIP;
+        pxDefaults->ulNetMask = FreeRTOS_htonl( ulNetMask );
+        pxDefaults->ulGatewayAddress = ulPeerIP;
+        pxDefaults->ulBroadcastAddress = pxContext->ulLocalIP | ~( pxDefaults->ulNetMask );
+
+        for( xIndex = 0; ( xIndex < 2 ) && ( ( size_t ) xIndex < ( size_t ) ipconfigENDPOINT_DNS_ADDRESS_COUNT ); xIndex++ )
+        {
+            pxDefaults->ulDNSServerAddresses[ xIndex ] = pxContext->ulDNS[ xIndex ];
+        }
+
+        FreeRTOS_printf( ( "PPP: IPCP address %xip peer %xip\n",
+                           ( unsigned ) FreeRTOS_ntohl( pxContext->ulLocalIP ),
+                           ( unsigned ) FreeRTOS_ntohl( ulPeerIP ) ) );
+
+        prvNCPFinished( pxContext );
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* ( ipconfigUSE_IPv4 != 0 ) */
+
+#if ( ipconfigUSE_IPv6 != 0 )
+
+    static size_t prvIPV6CPAddOptions( PPPContext_t * pxContext,
+                                       uint8_t * pucOptions )
+    {
+        size_t uxLength = 0U;
+
+        if( ( pxContext->xIPV6CP.ulWanted & pppWANT_IID ) != 0U )
+        {
+            uxLength = prvAddOption( pucOptions, uxLength, pppIPV6CP_IID, pxContext->ucLocalIID, pppIID_LENGTH );
+        }
+
+        return uxLength;
+    }
+/*-----------------------------------------------------------*/
+
+    static ePPPOptionResult_t prvIPV6CPCheckOption( const PPPContext_t * pxContext,
+                                                    const uint8_t * pucOption,
+                                                    uint8_t * pucNak )
+    {
+        static const uint8_t ucZeroIID[ pppIID_LENGTH ] = { 0U };
+        ePPPOptionResult_t eResult = eOptionReject;
+
+        if( ( pucOption[ 0 ] == pppIPV6CP_IID ) && ( pucOption[ 1 ] == ( 2U + pppIID_LENGTH ) ) )
+        {
+            eResult = eOptionAck;
+
+            /* The identifiers must be unique and non-zero, RFC 5072 section 4.1. */
+            if( ( memcmp( &( pucOption[ 2 ] ), ucZeroIID, pppIID_LENGTH ) == 0 ) ||
+                ( memcmp( &( pucOption[ 2 ] ), pxContext->ucLocalIID, pppIID_LENGTH ) == 0 ) )
+            {
+                eResult = eOptionNak;
+
+                if( pucNak != NULL )
+                {
+                    uint32_t ulNumber = 0U;
+
+                    ( void ) xApplicationGetRandomNumber( &( ulNumber ) );
+                    pucNak[ 0 ] = pppIPV6CP_IID;
+                    pucNak[ 1 ] = 2U + pppIID_LENGTH;
+                    ( void ) memcpy( &( pucNak[ 2 ] ), pxContext->ucLocalIID, pppIID_LENGTH );
+                    prvPut32( &( pucNak[ 6 ] ), ulNumber | 1U );
+                    /* Clear the universal/local bit: the identifier is local. */
+                    pucNak[ 2 ] = ( uint8_t ) ( pucNak[ 2 ] & ~0x02U );
+                }
+            }
+        }
+
+        return eResult;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvIPV6CPApplyOption( PPPContext_t * pxContext,
+                                      const uint8_t * pucOption )
+    {
+        if( pucOption == NULL )
+        {
+            ( void ) memset( pxContext->ucPeerIID, 0, sizeof( pxContext->ucPeerIID ) );
+        }
+        else if( pucOption[ 0 ] == pppIPV6CP_IID )
+        {
+            ( void ) memcpy( pxContext->ucPeerIID, &( pucOption[ 2 ] ), pppIID_LENGTH );
+        }
+        else
+        {
+            /* Not accepted. */
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvIPV6CPNakOption( PPPContext_t * pxContext,
+                                    const uint8_t * pucOption,
+                                    BaseType_t xIsReject )
+    {
+        if( pucOption[ 0 ] == pppIPV6CP_IID )
+        {
+            if( xIsReject != pdFALSE )
+            {
+                /* The peer doesn't care, keep our identifier. */
+                pxContext->xIPV6CP.ulWanted &= ~pppWANT_IID;
+            }
+            else if( pucOption[ 1 ] == ( 2U + pppIID_LENGTH ) )
+            {
+                ( void ) memcpy( pxContext->ucLocalIID, &( pucOption[ 2 ] ), pppIID_LENGTH );
+            }
+            else
+            {
+                /* Malformed. */
+            }
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvIPV6CPUp( PPPContext_t * pxContext )
+    {
+        IPV6Parameters_t * pxDefaults = &( pxContext->pxEndPointIPv6->ipv6_defaults );
+
+        /* A link-local address fe80::/64 with the negotiated identifiers. */
+        ( void ) memset( &( pxDefaults->xPrefix ), 0, sizeof( pxDefaults->xPrefix ) );
+        pxDefaults->xPrefix.ucBytes[ 0 ] = 0xFEU;
+        pxDefaults->xPrefix.ucBytes[ 1 ] = 0x80U;
+        pxDefaults->uxPrefixLength = 64U;
+
+        ( void ) memcpy( &( pxDefaults->xIPAddress ), &( pxDefaults->xPrefix ), sizeof( pxDefaults->xIPAddress ) );
+        ( void ) memcpy( &( pxDefaults->xIPAddress.ucBytes[ 8 ] ), pxContext->ucLocalIID, pppIID_LENGTH );
+
+        ( void ) memcpy( &( pxDefaults->xGatewayAddress ), &( pxDefaults->xPrefix ), sizeof( pxDefaults->xGatewayAddress ) );
+        ( void ) memcpy( &( pxDefaults->xGatewayAddress.ucBytes[ 8 ] ), pxContext->ucPeerIID, pppIID_LENGTH );
+
+        FreeRTOS_printf( ( "PPP: IPV6CP address %pip\n", ( void * ) pxDefaults->xIPAddress.ucBytes ) );
+
+        prvNCPFinished( pxContext );
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* ( ipconfigUSE_IPv6 != 0 ) */
+
+/**
+ * @brief Handle a frame that passed the FCS check.
+ *
+ * @param[in] pxContext The PPP interface.
+ * @param[in] pucFrame The frame, without flags and FCS.
+ * @param[in] uxLength The length of the frame.
+ */
+static void prvReceiveFrame( PPPContext_t * pxContext,
+                             const uint8_t * pucFrame,
+                             size_t uxLength )
+{
+    size_t uxOffset = 0U;
+    uint16_t usProtocol = 0U;
+
+    /* The address and control field are absent when the peer uses ACFC. */
+    if( ( uxLength >= 2U ) && ( pucFrame[ 0 ] == pppHDLC_ADDRESS ) && ( pucFrame[ 1 ] == pppHDLC_CONTROL ) )
+    {
+        uxOffset = 2U;
+    }
+
+    /* A protocol field with an odd first byte was compressed to one byte (PFC). */
+    if( ( uxOffset < uxLength ) && ( ( pucFrame[ uxOffset ] & 0x01U ) != 0U ) )
+    {
+        usProtocol = pucFrame[ uxOffset ];
+        uxOffset += 1U;
+    }
+    else if( ( uxOffset + 2U ) <= uxLength )
+    {
+        usProtocol = prvGet16( &( pucFrame[ uxOffset ] ) );
+        uxOffset += 2U;
+    }
+    else
+    {
+        /* Too short, usProtocol stays zero. */
+    }
+
+    if( usProtocol == pppPROTOCOL_LCP )
+    {
+        prvFsmReceive( pxContext, &( pxContext->xLCP ), &( pucFrame[ uxOffset ] ), uxLength - uxOffset );
+    }
+    else if( ( usProtocol == 0U ) || ( pxContext->xLCP.eState != eFsmOpened ) )
+    {
+        /* Only LCP is allowed before the link is opened. */
+    }
+    else
+    {
+        const uint8_t * pucData = &( pucFrame[ uxOffset ] );
+        size_t uxDataLength = uxLength - uxOffset;
+        BaseType_t xReject = pdFALSE;
+
+        switch( usProtocol )
+        {
+            case pppPROTOCOL_PAP:
+                prvPAPReceive( pxContext, pucData, uxDataLength );
+                break;
+
+            case pppPROTOCOL_CHAP:
+                prvCHAPReceive( pxContext, pucData, uxDataLength );
+                break;
+
+                #if ( ipconfigUSE_IPv4 != 0 )
+                    case pppPROTOCOL_IPCP:
+
+                        if( prvFindEndPoint( pxContext, pdFALSE ) == NULL )
+                        {
+                            xReject = pdTRUE;
+                        }
+                        else if( pxContext->ePhase == ePPPNetwork )
+                        {
+                            prvFsmReceive( pxContext, &( pxContext->xIPCP ), pucData, uxDataLength );
+                        }
+                        else
+                        {
+                            /* Still authenticating. */
+                        }
+
+                        break;
+
+                    case pppPROTOCOL_IPv4:
+
+                        if( pxContext->xIPCP.eState == eFsmOpened )
+                        {
+                            prvDeliverPacket( pxContext, ipIPv4_FRAME_TYPE, pucData, uxDataLength );
+                        }
+
+                        break;
+                #endif /* if ( ipconfigUSE_IPv4 != 0 ) */
+
+                #if ( ipconfigUSE_IPv6 != 0 )
+                    case pppPROTOCOL_IPV6CP:
+
+                        if( prvFindEndPoint( pxContext, pdTRUE ) == NULL )
+                        {
+                            xReject = pdTRUE;
+                        }
+                        else if( pxContext->ePhase == ePPPNetwork )
+                        {
+                            prvFsmReceive( pxContext, &( pxContext->xIPV6CP ), pucData, uxDataLength );
+                        }
+                        else
+                        {
+                            /* Still authenticating. */
+                        }
+
+                        break;
+
+                    case pppPROTOCOL_IPv6:
+
+                        if( pxContext->xIPV6CP.eState == eFsmOpened )
+                        {
+                            prvDeliverPacket( pxContext, ipIPv6_FRAME_TYPE, pucData, uxDataLength );
+                        }
+
+                        break;
+                #endif /* if ( ipconfigUSE_IPv6 != 0 ) */
+
+            default:
+                xReject = pdTRUE;
+                break;
+        }
+
+        if( xReject != pdFALSE )
+        {
+            uint8_t ucProtocol[ 2 ];
+
+            prvPut16( ucProtocol, usProtocol );
+            prvSendReject( pxContext, pppPROTOCOL_REJECT, ucProtocol, sizeof( ucProtocol ), pucData, uxDataLength );
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvHDLCStore( PPPContext_t * pxContext,
+                          const uint8_t * pucData,
+                          size_t uxLength )
+{
+    if( ( pxContext->uxRxLength + uxLength ) <= sizeof( pxContext->ucRxFrame ) )
+    {
+        ( void ) memcpy( &( pxContext->ucRxFrame[ pxContext->uxRxLength ] ), pucData, uxLength );
+        pxContext->uxRxLength += uxLength;
+    }
+    else
+    {
+        pxContext->xRxOverflow = pdTRUE;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvHDLCEndOfFrame( PPPContext_t * pxContext )
+{
+    /* Consecutive flags produce empty frames, which are ignored. An escape
+     * followed by a flag aborts the frame. */
+    if( pxContext->uxRxLength > 0U )
+    {
+        if( ( pxContext->xRxOverflow == pdFALSE ) &&
+            ( pxContext->xRxEscaped == pdFALSE ) &&
+            ( pxContext->uxRxLength > pppFCS_LENGTH ) &&
+            ( prvFCSUpdate( pppFCS_INIT, pxContext->ucRxFrame, pxContext->uxRxLength ) == pppFCS_GOOD ) )
+        {
+            prvReceiveFrame( pxContext, pxContext->ucRxFrame, pxContext->uxRxLength - pppFCS_LENGTH );
+        }
+        else
+        {
+            FreeRTOS_debug_printf( ( "PPP: dropped a bad frame of %u bytes\n", ( unsigned ) pxContext->uxRxLength ) );
+        }
+    }
+
+    pxContext->uxRxLength = 0U;
+    pxContext->xRxEscaped = pdFALSE;
+    pxContext->xRxOverflow = pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Decode the bytes read from the serial line. Outside of an escape
+ *        sequence, words without flag or escape byte are stored as a whole.
+ */
+static void prvHDLCReceive( PPPContext_t * pxContext,
+                            const uint8_t * pucData,
+                            size_t uxLength )
+{
+    size_t uxIndex = 0U;
+
+    while( uxIndex < uxLength )
+    {
+        uint32_t ulWord = 0U;
+        BaseType_t xWholeWord = pdFALSE;
+
+        if( ( pxContext->xRxEscaped == pdFALSE ) && ( ( uxLength - uxIndex ) >= sizeof( ulWord ) ) )
+        {
+            ( void ) memcpy( &ulWord, &( pucData[ uxIndex ] ), sizeof( ulWord ) );
+            xWholeWord = ( prvWordNeedsEscape( ulWord, 0U ) == pdFALSE ) ? pdTRUE : pdFALSE;
+        }
+
+        if( xWholeWord != pdFALSE )
+        {
+            prvHDLCStore( pxContext, &( pucData[ uxIndex ] ), sizeof( ulWord ) );
+            uxIndex += sizeof( ulWord );
+        }
+        else
+        {
+            uint8_t ucByte = pucData[ uxIndex ];
+
+            uxIndex++;
+
+            if( ucByte == pppHDLC_FLAG )
+            {
+                prvHDLCEndOfFrame( pxContext );
+            }
+            else if( ucByte == pppHDLC_ESCAPE )
+            {
+                pxContext->xRxEscaped = pdTRUE;
+            }
+            else
+            {
+                if( pxContext->xRxEscaped != pdFALSE )
+                {
+                    ucByte ^= pppHDLC_TRANSPARENT;
+                    pxContext->xRxEscaped = pdFALSE;
+                }
+
+                prvHDLCStore( pxContext, &ucByte, 1U );
+            }
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckTimers( PPPContext_t * pxContext )
+{
+    TickType_t xNow = xTaskGetTickCount();
+
+    prvFsmCheckTimer( pxContext, &( pxContext->xLCP ) );
+
+    #if ( ipconfigUSE_IPv4 != 0 )
+        prvFsmCheckTimer( pxContext, &( pxContext->xIPCP ) );
+    #endif
+
+    #if ( ipconfigUSE_IPv6 != 0 )
+        prvFsmCheckTimer( pxContext, &( pxContext->xIPV6CP ) );
+    #endif
+
+    if( ( pxContext->ePhase == ePPPAuthenticate ) &&
+        ( ( xNow - pxContext->xAuthTime ) >= pdMS_TO_TICKS( niPPP_RESTART_TIMER_MS ) ) )
+    {
+        pxContext->xAuthTime = xNow;
+
+        if( pxContext->ucAuthRetries > 0U )
+        {
+            pxContext->ucAuthRetries--;
+
+            if( pxContext->usAuthProtocol == pppPROTOCOL_PAP )
+            {
+                prvPAPSendRequest( pxContext );
+            }
+        }
+        else
+        {
+            FreeRTOS_printf( ( "PPP: authentication timed out\n" ) );
+            prvFsmClose( pxContext, &( pxContext->xLCP ) );
+            pxContext->ePhase = ePPPTerminate;
+        }
+    }
+
+    #if ( niPPP_ECHO_INTERVAL_MS != 0 )
+        if( ( pxContext->xLCP.eState == eFsmOpened ) &&
+            ( ( xNow - pxContext->xEchoTime ) >= pdMS_TO_TICKS( niPPP_ECHO_INTERVAL_MS ) ) )
+        {
+            pxContext->xEchoTime = xNow;
+
+            if( pxContext->ucEchoMissed >= niPPP_ECHO_FAILURES )
+            {
+                FreeRTOS_printf( ( "PPP: the peer does not answer Echo-Requests\n" ) );
+                prvFsmLowerDown( pxContext, &( pxContext->xLCP ) );
+                prvLCPFinished( pxContext );
+            }
+            else
+            {
+                pxContext->ucEchoMissed++;
+                pxContext->ucEchoID++;
+                prvPut32( &( pxContext->ucPacket[ pppHEADER_LENGTH ] ), pxContext->ulMagic );
+                prvSendControl( pxContext, pppPROTOCOL_LCP, pppECHO_REQUEST, pxContext->ucEchoID, pppHEADER_LENGTH + 4U );
+            }
+        }
+    #endif /* if ( niPPP_ECHO_INTERVAL_MS != 0 ) */
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief The task that reads the serial line and runs the protocols.
+ */
+static void prvPPPTask( void * pvParameters )
+{
+    PPPContext_t * pxContext = ( PPPContext_t * ) pvParameters;
+    uint8_t ucBuffer[ niPPP_READ_SIZE ];
+    size_t uxCount;
+
+    for( ; ; )
+    {
+        uxCount = pxContext->xConfig.pfRead( pxContext->xConfig.pvSerial, ucBuffer, sizeof( ucBuffer ), pdMS_TO_TICKS( pppPOLL_PERIOD_MS ) );
+
+        if( uxCount > 0U )
+        {
+            prvHDLCReceive( pxContext, ucBuffer, uxCount );
+        }
+
+        prvCheckTimers( pxContext );
+
+        if( pxContext->xCloseRequest != pdFALSE )
+        {
+            pxContext->xCloseRequest = pdFALSE;
+
+            if( pxContext->ePhase != ePPPDead )
+            {
+                prvFsmClose( pxContext, &( pxContext->xLCP ) );
+                pxContext->ePhase = ePPPTerminate;
+            }
+        }
+
+        if( ( pxContext->xOpenRequest != pdFALSE ) &&
+            ( pxContext->ePhase == ePPPDead ) &&
+            ( ( xTaskGetTickCount() - pxContext->xDeadTime ) >= pdMS_TO_TICKS( niPPP_HOLDOFF_MS ) ) )
+        {
+            pxContext->xOpenRequest = pdFALSE;
+            prvLinkStart( pxContext );
+        }
+
+        prvUpdateTxSettings( pxContext );
+    }
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief The task that writes the packets of the IP-task to the serial line.
+ */
+static void prvPPPTxTask( void * pvParameters )
+{
+    PPPContext_t * pxContext = ( PPPContext_t * ) pvParameters;
+    NetworkBufferDescriptor_t * pxDescriptor;
+
+    for( ; ; )
+    {
+        if( xQueueReceive( pxContext->xTxQueue, &( pxDescriptor ), portMAX_DELAY ) == pdPASS )
+        {
+            const EthernetHeader_t * pxEthernetHeader = ( ( const EthernetHeader_t * ) pxDescriptor->pucEthernetBuffer );
+            const uint8_t * pucPayload = &( pxDescriptor->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER ] );
+            size_t uxPayloadLength = pxDescriptor->xDataLength - ipSIZE_OF_ETH_HEADER;
+
+            if( xSemaphoreTake( pxContext->xTxMutex, portMAX_DELAY ) == pdPASS )
+            {
+                if( ( pxEthernetHeader->usFrameType == ipIPv4_FRAME_TYPE ) &&
+                    ( pxContext->xTxSettings.xIPv4Opened != pdFALSE ) )
+                {
+                    prvEncodeFrame( pxContext, &( pxContext->xTxSettings ), pppPROTOCOL_IPv4, pucPayload, uxPayloadLength );
+                }
+                else if( ( pxEthernetHeader->usFrameType == ipIPv6_FRAME_TYPE ) &&
+                         ( pxContext->xTxSettings.xIPv6Opened != pdFALSE ) )
+                {
+                    prvEncodeFrame( pxContext, &( pxContext->xTxSettings ), pppPROTOCOL_IPv6, pucPayload, uxPayloadLength );
+                }
+                else
+                {
+                    /* The NCP is not opened (any more). */
+                }
+
+                ( void ) xSemaphoreGive( pxContext->xTxMutex );
+            }
+
+            vReleaseNetworkBufferAndDescriptor( pxDescriptor );
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Queue a packet for the TX task, called by the IP-task.
+ */
+static void prvQueuePacket( PPPContext_t * pxContext,
+                            NetworkBufferDescriptor_t * pxDescriptor,
+                            BaseType_t xReleaseAfterSend )
+{
+    NetworkBufferDescriptor_t * pxToSend = pxDescriptor;
+
+    if( xReleaseAfterSend == pdFALSE )
+    {
+        /* The caller keeps its buffer, the TX task gets a copy. */
+        pxToSend = pxDuplicateNetworkBufferWithDescriptor( pxDescriptor, pxDescriptor->xDataLength );
+    }
+
+    if( pxToSend != NULL )
+    {
+        if( xQueueSendToBack( pxContext->xTxQueue, &( pxToSend ), 0U ) != pdPASS )
+        {
+            FreeRTOS_debug_printf( ( "prvQueuePacket: the TX queue is full\n" ) );
+            vReleaseNetworkBufferAndDescriptor( pxToSend );
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+#if ( ipconfigUSE_IPv4 != 0 )
+
+/**
+ * @brief Answer an ARP request on behalf of the peer, which owns every
+ *        address but ours.
+ */
+    static void prvReplyToARP( PPPContext_t * pxContext,
+                               const NetworkBufferDescriptor_t * pxDescriptor )
+    {
+        const ARPPacket_t * pxRequest = ( ( const ARPPacket_t * ) pxDescriptor->pucEthernetBuffer );
+        uint32_t ulSenderIP = 0U;
+        BaseType_t xAnswer = pdFALSE;
+
+        if( pxDescriptor->xDataLength >= sizeof( ARPPacket_t ) )
+        {
+            ( void ) memcpy( &( ulSenderIP ), pxRequest->xARPHeader.ucSenderProtocolAddress, sizeof( ulSenderIP ) );
+
+            /* Gratuitous requests are not answered, it would look like an IP clash. */
+            if( ( pxRequest->xARPHeader.usOperation == ( uint16_t ) ipARP_REQUEST ) &&
+                ( pxRequest->xARPHeader.ulTargetProtocolAddress != ulSenderIP ) )
+            {
+                xAnswer = pdTRUE;
+            }
+        }
+
+        if( xAnswer != pdFALSE )
+        {
+            NetworkBufferDescriptor_t * pxReply = pxGetNetworkBufferWithDescriptor( sizeof( ARPPacket_t ), 0U );
+
+            if( pxReply != NULL )
+            {
+                ARPPacket_t * pxARPPacket = ( ( ARPPacket_t * ) pxReply->pucEthernetBuffer );
+
+                ( void ) memcpy( pxARPPacket, pxRequest, sizeof( ARPPacket_t ) );
+                ( void ) memcpy( pxARPPacket->xEthernetHeader.xDestinationAddress.ucBytes, pxRequest->xEthernetHeader.xSourceAddress.ucBytes, sizeof( MACAddress_t ) );
+                ( void ) memcpy( pxARPPacket->xEthernetHeader.xSourceAddress.ucBytes, xPeerMACAddress.ucBytes, sizeof( MACAddress_t ) );
+
+                pxARPPacket->xARPHeader.usOperation = ( uint16_t ) ipARP_REPLY;
+                ( void ) memcpy( pxARPPacket->xARPHeader.xSenderHardwareAddress.ucBytes, xPeerMACAddress.ucBytes, sizeof( MACAddress_t ) );
+                ( void ) memcpy( pxARPPacket->xARPHeader.ucSenderProtocolAddress, &( pxRequest->xARPHeader.ulTargetProtocolAddress ), sizeof( uint32_t ) );
+                ( void ) memcpy( pxARPPacket->xARPHeader.xTargetHardwareAddress.ucBytes, pxRequest->xARPHeader.xSenderHardwareAddress.ucBytes, sizeof( MACAddress_t ) );
+                pxARPPacket->xARPHeader.ulTargetProtocolAddress = ulSenderIP;
+                pxReply->xDataLength = sizeof( ARPPacket_t );
+
+                prvPostToIPTask( pxContext, pxReply );
+            }
+        }
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* ( ipconfigUSE_IPv4 != 0 ) */
+
+#if ( ipconfigUSE_IPv6 != 0 )
+
+/**
+ * @brief Answer a neighbour solicitation on behalf of the peer.
+ *
+ * @return pdTRUE when the packet was a neighbour solicitation, which must
+ *         not be sent to the peer.
+ */
+    static BaseType_t prvReplyToNS( PPPContext_t * pxContext,
+                                    const NetworkBufferDescriptor_t * pxDescriptor )
+    {
+        const ICMPPacket_IPv6_t * pxRequest = ( ( const ICMPPacket_IPv6_t * ) pxDescriptor->pucEthernetBuffer );
+        const size_t uxNeededSize = ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv6_HEADER + sizeof( ICMPHeader_IPv6_t );
+        BaseType_t xIsSolicitation = pdFALSE;
+
+        if( ( pxDescriptor->xDataLength >= uxNeededSize ) &&
+            ( pxRequest->xIPHeader.ucNextHeader == ipPROTOCOL_ICMP_IPv6 ) &&
+            ( pxRequest->xICMPHeaderIPv6.ucTypeOfMessage == ipICMP_NEIGHBOR_SOLICITATION_IPv6 ) )
+        {
+            xIsSolicitation = pdTRUE;
+
+            /* A solicitation from the unspecified address checks for a
+             * duplicate address, it must stay unanswered. */
+            if( memcmp( pxRequest->xIPHeader.xSourceAddress.ucBytes, FreeRTOS_in6addr_any.ucBytes, ipSIZE_OF_IPv6_ADDRESS ) != 0 )
+            {
+                NetworkBufferDescriptor_t * pxReply = pxGetNetworkBufferWithDescriptor( uxNeededSize, 0U );
+
+                if( pxReply != NULL )
+                {
+                    ICMPPacket_IPv6_t * pxAdvertisement = ( ( ICMPPacket_IPv6_t * ) pxReply->pucEthernetBuffer );
+                    ICMPHeader_IPv6_t * pxICMPHeader = &( pxAdvertisement->xICMPHeaderIPv6 );
+
+                    ( void ) memcpy( pxAdvertisement, pxRequest, uxNeededSize );
+                    ( void ) memcpy( pxAdvertisement->xEthernetHeader.xDestinationAddress.ucBytes, pxRequest->xEthernetHeader.xSourceAddress.ucBytes, sizeof( MACAddress_t ) );
+                    ( void ) memcpy( pxAdvertisement->xEthernetHeader.xSourceAddress.ucBytes, xPeerMACAddress.ucBytes, sizeof( MACAddress_t ) );
+
+                    pxAdvertisement->xIPHeader.usPayloadLength = FreeRTOS_htons( sizeof( ICMPHeader_IPv6_t ) );
+                    pxAdvertisement->xIPHeader.ucHopLimit = 255U;
+                    ( void ) memcpy( pxAdvertisement->xIPHeader.xSourceAddress.ucBytes, pxRequest->xICMPHeaderIPv6.xIPv6Address.ucBytes, ipSIZE_OF_IPv6_ADDRESS );
+                    ( void ) memcpy( pxAdvertisement->xIPHeader.xDestinationAddress.ucBytes, pxRequest->xIPHeader.xSourceAddress.ucBytes, ipSIZE_OF_IPv6_ADDRESS );
+
+                    pxICMPHeader->ucTypeOfMessage = ipICMP_NEIGHBOR_ADVERTISEMENT_IPv6;
+                    pxICMPHeader->ucTypeOfService = 0U;
+                    pxICMPHeader->ulReserved = FreeRTOS_htonl( pppNA_FLAGS );
+                    pxICMPHeader->ucOptionType = ndICMP_TARGET_LINK_LAYER_ADDRESS;
+                    pxICMPHeader->ucOptionLength = 1U; /* In units of 8 bytes. */
+                    ( void ) memcpy( pxICMPHeader->ucOptionBytes, xPeerMACAddress.ucBytes, sizeof( MACAddress_t ) );
+                    pxICMPHeader->usChecksum = 0U;
+                    pxReply->xDataLength = uxNeededSize;
+
+                    ( void ) usGenerateProtocolChecksum( pxReply->pucEthernetBuffer, pxReply->xDataLength, pdTRUE );
+
+                    prvPostToIPTask( pxContext, pxReply );
+                }
+            }
+        }
+
+        return xIsSolicitation;
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* ( ipconfigUSE_IPv6 != 0 ) */
+
+static BaseType_t prvPPP_Initialise( NetworkInterface_t * pxInterface )
+{
+    PPPContext_t * pxContext = ( PPPContext_t * ) pxInterface->pvArgument;
+    BaseType_t xResult = pdFAIL;
+
+    if( pxContext->xTaskHandle == NULL )
+    {
+        pxContext->xTxMutex = xSemaphoreCreateMutex();
+        configASSERT( pxContext->xTxMutex != NULL );
+        pxContext->xTxQueue = xQueueCreate( niPPP_TX_QUEUE_LENGTH, sizeof( NetworkBufferDescriptor_t * ) );
+        configASSERT( pxContext->xTxQueue != NULL );
+
+        if( xTaskCreate( prvPPPTxTask, niPPP_TX_TASK_NAME, niPPP_TX_TASK_STACK_SIZE, ( void * ) pxContext,
+                         niPPP_TX_TASK_PRIORITY, &( pxContext->xTxTaskHandle ) ) != pdPASS )
+        {
+            FreeRTOS_printf( ( "prvPPP_Initialise: failed to create the PPP TX task\n" ) );
+        }
+
+        if( xTaskCreate( prvPPPTask, niPPP_TASK_NAME, niPPP_TASK_STACK_SIZE, ( void * ) pxContext,
+                         niPPP_TASK_PRIORITY, &( pxContext->xTaskHandle ) ) != pdPASS )
+        {
+            FreeRTOS_printf( ( "prvPPP_Initialise: failed to create the PPP task\n" ) );
+        }
+    }
+
+    /* The end-points can only come up when the NCP's have negotiated
+     * their addresses. Until then the IP-task will call here periodically. */
+    if( pxContext->xNetworkUp != pdFALSE )
+    {
+        xResult = pdPASS;
+    }
+    else
+    {
+        pxContext->xOpenRequest = pdTRUE;
+    }
+
+    return xResult;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvPPP_Output( NetworkInterface_t * pxInterface,
+                                 NetworkBufferDescriptor_t * const pxDescriptor,
+                                 BaseType_t xReleaseAfterSend )
+{
+    PPPContext_t * pxContext = ( PPPContext_t * ) pxInterface->pvArgument;
+    BaseType_t xQueued = pdFALSE;
+
+    /* Writing to the serial line takes long, it is left to the TX task. That
+     * task also checks if the NCP of the packet is opened. */
+    if( pxDescriptor->xDataLength > ipSIZE_OF_ETH_HEADER )
+    {
+        const EthernetHeader_t * pxEthernetHeader = ( ( const EthernetHeader_t * ) pxDescriptor->pucEthernetBuffer );
+
+        switch( pxEthernetHeader->usFrameType )
+        {
+            #if ( ipconfigUSE_IPv4 != 0 )
+                case ipARP_FRAME_TYPE:
+                    prvReplyToARP( pxContext, pxDescriptor );
+                    break;
+
+                case ipIPv4_FRAME_TYPE:
+                    prvQueuePacket( pxContext, pxDescriptor, xReleaseAfterSend );
+                    xQueued = pdTRUE;
+                    break;
+            #endif /* if ( ipconfigUSE_IPv4 != 0 ) */
+
+            #if ( ipconfigUSE_IPv6 != 0 )
+                case ipIPv6_FRAME_TYPE:
+
+                    if( prvReplyToNS( pxContext, pxDescriptor ) == pdFALSE )
+                    {
+                        prvQueuePacket( pxContext, pxDescriptor, xReleaseAfterSend );
+                        xQueued = pdTRUE;
+                    }
+
+                    break;
+            #endif /* if ( ipconfigUSE_IPv6 != 0 ) */
+
+            default:
+                /* Nothing else can be sent over PPP. */
+                break;
+        }
+    }
+
+    if( ( xQueued == pdFALSE ) && ( xReleaseAfterSend != pdFALSE ) )
+    {
+        vReleaseNetworkBufferAndDescriptor( pxDescriptor );
+    }
+
+    /* The return value is actually ignored by the IP-stack. */
+    return pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvPPP_GetPhyLinkStatus( NetworkInterface_t * pxInterface )
+{
+    const PPPContext_t * pxContext = ( const PPPContext_t * ) pxInterface->pvArgument;
+
+    return ( pxContext->xLCP.eState == eFsmOpened ) ? pdTRUE : pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+NetworkInterface_t * pxPPP_FillInterfaceDescriptor( BaseType_t xIndex,
+                                                    NetworkInterface_t * pxInterface,
+                                                    const PPPConfig_t * pxConfig )
+{
+    PPPContext_t * pxContext;
+
+/* This function pxPPP_FillInterfaceDescriptor() adds a network-interface.
+ * Make sure that the object pointed to by 'pxInterface'
+ * is declared static or global, and that it will remain to exist. */
+
+    configASSERT( ( xIndex >= 0 ) && ( xIndex < niPPP_MAX_INTERFACES ) );
+    configASSERT( ( pxConfig->pfRead != NULL ) && ( pxConfig->pfWrite != NULL ) );
+
+    pxContext = &( xPPPContexts[ xIndex ] );
+    ( void ) memset( pxContext, 0, sizeof( *pxContext ) );
+    pxContext->pxInterface = pxInterface;
+    ( void ) memcpy( &( pxContext->xConfig ), pxConfig, sizeof( pxContext->xConfig ) );
+    pxContext->ePhase = ePPPDead;
+    /* Allow the first link to start without a hold-off. */
+    pxContext->xDeadTime = xTaskGetTickCount() - pdMS_TO_TICKS( niPPP_HOLDOFF_MS );
+    pxContext->usPeerMRU = pppDEFAULT_MRU;
+    pxContext->xLCP.pxProtocol = &( xLCPProtocol );
+
+    #if ( ipconfigUSE_IPv4 != 0 )
+        pxContext->xIPCP.pxProtocol = &( xIPCPProtocol );
+    #endif
+
+    #if ( ipconfigUSE_IPv6 != 0 )
+        pxContext->xIPV6CP.pxProtocol = &( xIPV6CPProtocol );
+    #endif
+
+    ( void ) memset( pxInterface, '\0', sizeof( *pxInterface ) );
+    pxInterface->pcName = "PPP";                     /* Just for logging, debugging. */
+    pxInterface->pvArgument = ( void * ) pxContext; /* Has only meaning for the driver functions. */
+    pxInterface->pfInitialise = prvPPP_Initialise;
+    pxInterface->pfOutput = prvPPP_Output;
+    pxInterface->pfGetPhyLinkStatus = prvPPP_GetPhyLinkStatus;
+
+    FreeRTOS_AddNetworkInterface( pxInterface );
+
+    return pxInterface;
+}
+/*-----------------------------------------------------------*/
+
+ePPPPhase_t ePPPGetPhase( const NetworkInterface_t * pxInterface )
+{
+    const PPPContext_t * pxContext = ( const PPPContext_t * ) pxInterface->pvArgument;
+
+    return pxContext->ePhase;
+}
+/*-----------------------------------------------------------*/
+
+void vPPPClose( NetworkInterface_t * pxInterface )
+{
+    PPPContext_t * pxContext = ( PPPContext_t * ) pxInterface->pvArgument;
+
+    pxContext->xCloseRequest = pdTRUE;
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,97 @@
+/*
+ * FreeRTOS+TCP <DEVELOPMENT BRANCH>
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+#ifndef PPP_NETWORK_INTERFACE_H
+#define PPP_NETWORK_INTERFACE_H
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+#include "FreeRTOS_Routing.h"
+
+/** @brief The phases of a PPP link, see RFC 1661 section 3.2. */
+typedef enum ePPP_PHASE
+{
+    ePPPDead,         /**< The serial line is not in use. */
+    ePPPEstablish,    /**< LCP is negotiating the link options. */
+    ePPPAuthenticate, /**< Authenticating with PAP or CHAP-MD5. */
+    ePPPNetwork,      /**< IPCP and/or IPV6CP are negotiating or opened. */
+    ePPPTerminate     /**< LCP is closing the link. */
+} ePPPPhase_t;
+
+/** @brief The serial line and the credentials used by a PPP interface. The
+ *         line must already be in data mode, dialling is left to the application. */
+typedef struct xPPP_CONFIG
+{
+    void * pvSerial; /**< Passed as the first parameter to 'pfRead' and 'pfWrite'. */
+
+    /** Read at most 'uxLength' bytes, wait at most 'xTicksToWait' for the first byte.
+     *  Returns the number of bytes read. */
+    size_t ( * pfRead )( void * pvSerial,
+                         uint8_t * pucBuffer,
+                         size_t uxLength,
+                         TickType_t xTicksToWait );
+
+    /** Write all 'uxLength' bytes, returns the number of bytes written. */
+    size_t ( * pfWrite )( void * pvSerial,
+                          const uint8_t * pucData,
+                          size_t uxLength );
+
+    const char * pcUser;     /**< The user name for PAP/CHAP, or NULL when not authenticating. */
+    const char * pcPassword; /**< The PAP password or the CHAP secret. */
+} PPPConfig_t;
+
+/*
+ * Fill in and add a PPP network interface. 'pxConfig' is copied. Add one
+ * IPv4 and/or one IPv6 end-point to the interface, with DHCP and RA disabled:
+ * their addresses are negotiated by IPCP and IPV6CP.
+ */
+NetworkInterface_t * pxPPP_FillInterfaceDescriptor( BaseType_t xIndex,
+                                                    NetworkInterface_t * pxInterface,
+                                                    const PPPConfig_t * pxConfig );
+
+/*
+ * Return the phase of the PPP link of 'pxInterface'.
+ */
+ePPPPhase_t ePPPGetPhase( const NetworkInterface_t * pxInterface );
+
+/*
+ * Ask the peer to terminate the link. The IP-task will try to open the link
+ * again after a network-down event.
+ */
+void vPPPClose( NetworkInterface_t * pxInterface );
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    } /* extern "C" */
+#endif
+/* *INDENT-ON* */
+
+#endif /* PPP_NETWORK_INTERFACE_H */
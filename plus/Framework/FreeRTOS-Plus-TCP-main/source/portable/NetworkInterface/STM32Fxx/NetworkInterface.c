@@ -1116,7 +1116,7 @@ static BaseType_t prvNetworkInterfaceInput( void )
         {
             /* The packet will be accepted, but check first if a new Network Buffer can
              * be obtained. If not, the packet will still be dropped. */
-            pxNewDescriptor = pxGetNetworkBufferWithDescriptor( EMAC_DMA_BUFFER_SIZE, xDescriptorWaitTime );
+            pxNewDescriptor = pxGetNetworkBufferWithClass( EMAC_DMA_BUFFER_SIZE, xDescriptorWaitTime, eBufferClassRX );
 
             if( pxNewDescriptor == NULL )
             {
@@ -1476,6 +1476,8 @@ static void prvEMACHandlerTask( void * pvParameters )
                          &( ulISREvents ),  /* pulNotificationValue */
                          ulMaxBlockTime );
 
+        iptraceEMAC_TASK_LOOP_START( 0 );
+
         if( ( ulISREvents & EMAC_IF_RX_EVENT ) != 0 )
         {
             xResult = prvNetworkInterfaceInput();
@@ -1507,6 +1509,8 @@ static void prvEMACHandlerTask( void * pvParameters )
             }
             #endif /* ( ipconfigSUPPORT_NETWORK_DOWN_EVENT != 0 ) */
         }
+
+        iptraceEMAC_TASK_LOOP_END( 0 );
     }
 }
 /*-----------------------------------------------------------*/
@@ -310,7 +310,7 @@ static uint8_t * pucGetRXBuffer( size_t uxSize )
     NetworkBufferDescriptor_t * pxBufferDescriptor;
     uint8_t * pucReturn = NULL;
 
-    pxBufferDescriptor = pxGetNetworkBufferWithDescriptor( uxSize, uxBlockTimeTicks );
+    pxBufferDescriptor = pxGetNetworkBufferWithClass( uxSize, uxBlockTimeTicks, eBufferClassRX );
 
     if( pxBufferDescriptor != NULL )
     {
@@ -801,13 +801,22 @@ static BaseType_t prvNetworkInterfaceInput( void )
         }
         #endif /* if ( ipconfigZERO_COPY_RX_DRIVER != 0 ) */
 
-        pxBufferDescriptor = pxGetNetworkBufferWithDescriptor( uxLength, 0u );
-
-        if( pxBufferDescriptor == NULL )
+        if( ( data_buffer.buffer != NULL ) &&
+            ( xNetworkInterfaceRxAdmit( pxMyInterface, data_buffer.buffer, uxDataLength ) == pdFALSE ) )
         {
-            /* The event was lost because a network buffer was not available.
-             * Call the standard trace macro to log the occurrence. */
-            iptraceETHERNET_RX_EVENT_LOST();
+            /* Dropped early, the same as when no buffer is available. */
+            pxBufferDescriptor = NULL;
+        }
+        else
+        {
+            pxBufferDescriptor = pxGetNetworkBufferWithClass( uxLength, 0u, eBufferClassRX );
+
+            if( pxBufferDescriptor == NULL )
+            {
+                /* The event was lost because a network buffer was not available.
+                 * Call the standard trace macro to log the occurrence. */
+                iptraceETHERNET_RX_EVENT_LOST();
+            }
         }
 
         #if ( ipconfigZERO_COPY_RX_DRIVER != 0 )
@@ -1131,6 +1140,8 @@ static void prvEMACHandlerTask( void * pvParameters )
 
         ulTaskNotifyTake( pdFALSE, ulMaxBlockTime );
 
+        iptraceEMAC_TASK_LOOP_START( 0 );
+
         /* Wait for the Ethernet MAC interrupt to indicate that another packet
          * has been received. */
         if( ( ulISREvents & EMAC_IF_RX_EVENT ) != 0U )
@@ -1187,6 +1198,8 @@ static void prvEMACHandlerTask( void * pvParameters )
                 prvEthernetUpdateConfig( pdFALSE );
             }
         }
+
+        iptraceEMAC_TASK_LOOP_END( 0 );
     }
 }
 
@@ -103,6 +103,10 @@ static NetworkInterface_t * pxMyInterfaces[ XPAR_XEMACPS_NUM_INSTANCES ];
     #endif
 #endif
 
+/* When nicUSE_UNCACHED_MEMORY is 0, the network buffers are located in cacheable
+ * memory, and the driver will clean or invalidate the cache lines that the DMA
+ * reads or writes. This is much faster for the code that reads or writes the
+ * packets, such as the checksum routines and the TCP stream buffers. */
 #ifndef nicUSE_UNCACHED_MEMORY
     #define nicUSE_UNCACHED_MEMORY    1
 #endif
@@ -466,17 +470,28 @@ static BaseType_t prvGMACWaitLS( BaseType_t xEMACIndex,
 /*-----------------------------------------------------------*/
 
 #if ( nicUSE_UNCACHED_MEMORY == 0 )
+
+/* The back-pointer to the descriptor is stored 'ipBUFFER_PADDING' bytes before
+ * 'pucEthernetBuffer'. It must be located in the first cache line of the buffer,
+ * which is not accessed by the DMA, see EMAC_CACHED_PACKET_SIZE. */
+    #if ( ipBUFFER_PADDING > ( EMAC_CACHE_LINE_SIZE + ipconfigPACKET_FILLER_SIZE ) )
+        #error ipBUFFER_PADDING is too big for cacheable network buffers
+    #endif
+
     void vNetworkInterfaceAllocateRAMToBuffers( NetworkBufferDescriptor_t pxNetworkBuffers[ ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS ] )
     {
-        static uint8_t ucNetworkPackets[ ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS * niBUFFER_1_PACKET_SIZE ] __attribute__( ( aligned( 32 ) ) );
+        static uint8_t ucNetworkPackets[ ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS * EMAC_CACHED_PACKET_SIZE ] __attribute__( ( aligned( EMAC_CACHE_LINE_SIZE ) ) );
         uint8_t * ucRAMBuffer = ucNetworkPackets;
+        uint8_t * pucEthernetBuffer;
         uint32_t ul;
 
         for( ul = 0; ul < ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS; ul++ )
         {
-            pxNetworkBuffers[ ul ].pucEthernetBuffer = ucRAMBuffer + ipBUFFER_PADDING;
-            *( ( unsigned * ) ucRAMBuffer ) = ( unsigned ) ( &( pxNetworkBuffers[ ul ] ) );
-            ucRAMBuffer += niBUFFER_1_PACKET_SIZE;
+            /* The DMA area starts at the second cache line of the buffer. */
+            pucEthernetBuffer = ucRAMBuffer + EMAC_CACHE_LINE_SIZE + ipconfigPACKET_FILLER_SIZE;
+            pxNetworkBuffers[ ul ].pucEthernetBuffer = pucEthernetBuffer;
+            *( ( unsigned * ) ( pucEthernetBuffer - ipBUFFER_PADDING ) ) = ( unsigned ) ( &( pxNetworkBuffers[ ul ] ) );
+            ucRAMBuffer += EMAC_CACHED_PACKET_SIZE;
         }
     }
 #else /* if ( nicUSE_UNCACHED_MEMORY == 0 ) */
@@ -607,6 +622,8 @@ static void prvEMACHandlerTask( void * pvParameters )
             ulTaskNotifyTake( pdFALSE, ulMaxBlockTime );
         }
 
+        iptraceEMAC_TASK_LOOP_START( xEMACIndex );
+
         if( ( pxEMAC_PS->isr_events & EMAC_IF_RX_EVENT ) != 0 )
         {
             pxEMAC_PS->isr_events &= ~EMAC_IF_RX_EVENT;
@@ -655,6 +672,8 @@ static void prvEMACHandlerTask( void * pvParameters )
                 xPhyRemTime = pdMS_TO_TICKS( ipconfigPHY_LS_LOW_CHECK_TIME_MS );
             }
         }
+
+        iptraceEMAC_TASK_LOOP_END( xEMACIndex );
     }
 }
 /*-----------------------------------------------------------*/
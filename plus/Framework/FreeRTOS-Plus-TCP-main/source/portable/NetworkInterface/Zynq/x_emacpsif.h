@@ -78,6 +78,22 @@
     #define EMAC_IF_ERR_EVENT                      4
     #define EMAC_IF_ALL_EVENT                      7
 
+/* The size of a cache line, both in the L1 cache of the Cortex-A9 and in the
+ * PL310 L2 cache. */
+    #define EMAC_CACHE_LINE_SIZE                   32U
+
+/* When the network buffers are located in cacheable memory
+ * ( nicUSE_UNCACHED_MEMORY == 0 ), each buffer starts with one cache line
+ * that is only accessed by the CPU. It holds the pointer back to the
+ * network descriptor. It is followed by the area that the DMA reads or
+ * writes, which starts at a cache line boundary, 'ipconfigPACKET_FILLER_SIZE'
+ * bytes before 'pucEthernetBuffer'. The DMA area has a length of
+ * EMAC_DMA_AREA_SIZE bytes, a multiple of the cache line size. The cache
+ * lines of a DMA area are never shared with other data, so they can be
+ * invalidated without losing data written by the CPU. */
+    #define EMAC_DMA_AREA_SIZE                     1536U
+    #define EMAC_CACHED_PACKET_SIZE                ( EMAC_CACHE_LINE_SIZE + EMAC_DMA_AREA_SIZE )
+
 /* structure within each netif, encapsulating all information required for
  * using a particular temac instance
  */
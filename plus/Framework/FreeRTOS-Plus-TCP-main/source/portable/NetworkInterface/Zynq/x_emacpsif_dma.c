@@ -66,6 +66,7 @@
 #include "FreeRTOS_IP_Private.h"
 #include "FreeRTOS_Routing.h"
 #include "NetworkBufferManagement.h"
+#include "NetworkInterface.h"
 
 #include "Zynq/x_emacpsif.h"
 #include "Zynq/x_topology.h"
@@ -89,7 +90,7 @@
 #endif
 #define TX_OFFSET               ipconfigPACKET_FILLER_SIZE
 
-#define dmaRX_TX_BUFFER_SIZE    1536
+#define dmaRX_TX_BUFFER_SIZE    EMAC_DMA_AREA_SIZE
 
 /* Defined in NetworkInterface.c */
 extern TaskHandle_t xEMACTaskHandles[ XPAR_XEMACPS_NUM_INSTANCES ];
@@ -119,6 +120,9 @@ BaseType_t xMayAcceptPacket( uint8_t * pucEthernetBuffer );
 
 static void prvPassEthMessages( NetworkBufferDescriptor_t * pxDescriptor );
 
+static void prvInvalidateDMAArea( const NetworkBufferDescriptor_t * pxBuffer,
+                                  uint32_t ulLength );
+
 /*
  *  The FreeRTOS+TCP port does not make use of "src/xemacps_bdring.c".
  *  In stead 'struct xemacpsif_s' has a "head" and a "tail" index.
@@ -231,6 +235,35 @@ void emacps_send_handler( void * arg )
     portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
 }
 
+/*
+ * Invalidate the cache lines that hold the first 'ulLength' bytes of the DMA
+ * area of a network buffer. Nothing is done for buffers in uncached memory.
+ * The DMA area of a cacheable buffer starts at a cache line boundary, see
+ * EMAC_CACHED_PACKET_SIZE, so only the lines that the DMA has access to are
+ * affected, and no partial line needs to be flushed.
+ */
+static void prvInvalidateDMAArea( const NetworkBufferDescriptor_t * pxBuffer,
+                                  uint32_t ulLength )
+{
+    uint32_t ulStart;
+    uint32_t ulEnd;
+
+    if( ucIsCachedMemory( pxBuffer->pucEthernetBuffer ) != 0 )
+    {
+        ulStart = ( ( uint32_t ) pxBuffer->pucEthernetBuffer ) - ipconfigPACKET_FILLER_SIZE;
+        configASSERT( ( ulStart & ( EMAC_CACHE_LINE_SIZE - 1U ) ) == 0U );
+
+        if( ulLength > dmaRX_TX_BUFFER_SIZE )
+        {
+            ulLength = dmaRX_TX_BUFFER_SIZE;
+        }
+
+        ulEnd = ( ulStart + ulLength + ( EMAC_CACHE_LINE_SIZE - 1U ) ) & ~( EMAC_CACHE_LINE_SIZE - 1U );
+        Xil_DCacheInvalidateRange( ( INTPTR ) ulStart, ulEnd - ulStart );
+    }
+}
+/*-----------------------------------------------------------*/
+
 static BaseType_t xValidLength( BaseType_t xLength )
 {
     BaseType_t xReturn;
@@ -284,6 +317,7 @@ XStatus emacps_send_message( xemacpsif_s * xemacpsif,
         /* Pass the pointer (and its ownership) directly to DMA. */
         pxDMA_tx_buffers[ xEMACIndex ][ txHead ] = pxBuffer->pucEthernetBuffer;
 
+        /* Only the bytes that the DMA will read need to be written to memory. */
         if( ucIsCachedMemory( pxBuffer->pucEthernetBuffer ) != 0 )
         {
             Xil_DCacheFlushRange( ( INTPTR ) pxBuffer->pucEthernetBuffer, ( u32 ) pxBuffer->xDataLength );
@@ -491,6 +525,10 @@ int emacps_check_rx( xemacpsif_s * xemacpsif,
     int rx_bytes;
     volatile int msgCount = 0;
     int rxHead = xemacpsif->rxHead;
+    int iIndex;
+    int iDescriptor;
+    int iLastDescriptor = 0;
+    int iRunLength = 0;
     BaseType_t xEMACIndex = xemacpsif->emacps.Config.DeviceId;
     BaseType_t xAccepted;
 
@@ -502,27 +540,55 @@ int emacps_check_rx( xemacpsif_s * xemacpsif,
     /* There seems to be an issue (SI# 692601), see comments below. */
     resetrx_on_no_rxdata( xemacpsif );
 
-    /* This FreeRTOS+TCP driver shall be compiled with the option
-     * "ipconfigUSE_LINKED_RX_MESSAGES" enabled.  It allows the driver to send a
-     * chain of RX messages within one message to the IP-task. */
-    for( ; ; )
+    /* The descriptors are handled in runs. First find the descriptors that
+     * have been filled by the DMA, and invalidate the bytes that it has
+     * written, before the CPU looks at them. */
+    iIndex = rxHead;
+
+    while( iRunLength < ipconfigNIC_N_RX_DESC )
     {
-        if( ( ( xemacpsif->rxSegments[ rxHead ].address & XEMACPS_RXBUF_NEW_MASK ) == 0 ) ||
-            ( pxDMA_rx_buffers[ xEMACIndex ][ rxHead ] == NULL ) )
+        if( ( ( xemacpsif->rxSegments[ iIndex ].address & XEMACPS_RXBUF_NEW_MASK ) == 0 ) ||
+            ( pxDMA_rx_buffers[ xEMACIndex ][ iIndex ] == NULL ) )
         {
             break;
         }
 
+        rx_bytes = xemacpsif->rxSegments[ iIndex ].flags & XEMACPS_RXBUF_LEN_MASK;
+        /* The DMA has written 'ipconfigPACKET_FILLER_SIZE' bytes before the packet. */
+        prvInvalidateDMAArea( pxDMA_rx_buffers[ xEMACIndex ][ iIndex ], ( uint32_t ) rx_bytes + ipconfigPACKET_FILLER_SIZE );
+
+        iRunLength++;
+
+        if( ++iIndex == ipconfigNIC_N_RX_DESC )
+        {
+            iIndex = 0;
+        }
+    }
+
+    /* This FreeRTOS+TCP driver shall be compiled with the option
+     * "ipconfigUSE_LINKED_RX_MESSAGES" enabled.  It allows the driver to send a
+     * chain of RX messages within one message to the IP-task. */
+    for( iIndex = 0; iIndex < iRunLength; iIndex++ )
+    {
         pxBuffer = ( NetworkBufferDescriptor_t * ) pxDMA_rx_buffers[ xEMACIndex ][ rxHead ];
         xAccepted = xMayAcceptPacket( pxBuffer->pucEthernetBuffer );
 
+        if( xAccepted != pdFALSE )
+        {
+            /* Under a flood of packets, drop them here, before a
+             * replacement buffer is taken. */
+            xAccepted = xNetworkInterfaceRxAdmit( pxInterface,
+                                                  pxBuffer->pucEthernetBuffer,
+                                                  ( size_t ) ( xemacpsif->rxSegments[ rxHead ].flags & XEMACPS_RXBUF_LEN_MASK ) );
+        }
+
         if( xAccepted == pdFALSE )
         {
             pxNewBuffer = NULL;
         }
         else
         {
-            pxNewBuffer = pxGetNetworkBufferWithDescriptor( dmaRX_TX_BUFFER_SIZE, ( TickType_t ) 0 );
+            pxNewBuffer = pxGetNetworkBufferWithClass( dmaRX_TX_BUFFER_SIZE, ( TickType_t ) 0, eBufferClassRX );
 
             if( pxNewBuffer == NULL )
             {
@@ -532,11 +598,10 @@ int emacps_check_rx( xemacpsif_s * xemacpsif,
             }
         }
 
-        if( pxNewBuffer == NULL )
-        {
-            pxNewBuffer = ( NetworkBufferDescriptor_t * ) pxDMA_rx_buffers[ xEMACIndex ][ rxHead ];
-        }
-        else
+        /* When there is no new buffer, the old buffer stays in place. The CPU
+         * has only read from it, so its cache lines are clean and its DMA area
+         * does not need to be invalidated again. */
+        if( pxNewBuffer != NULL )
         {
             pxBuffer->pxInterface = pxInterface;
             pxBuffer->pxEndPoint = FreeRTOS_MatchingEndpoint( pxInterface, pxBuffer->pucEthernetBuffer );
@@ -550,11 +615,6 @@ int emacps_check_rx( xemacpsif_s * xemacpsif,
 
             pxBuffer->xDataLength = rx_bytes;
 
-            if( ucIsCachedMemory( pxBuffer->pucEthernetBuffer ) != 0 )
-            {
-                Xil_DCacheInvalidateRange( ( ( uint32_t ) pxBuffer->pucEthernetBuffer ) - ipconfigPACKET_FILLER_SIZE, ( unsigned ) rx_bytes );
-            }
-
             /* store it in the receive queue, where it'll be processed by a
              * different handler. */
             iptraceNETWORK_INTERFACE_RECEIVE();
@@ -582,37 +642,51 @@ int emacps_check_rx( xemacpsif_s * xemacpsif,
             #endif /* ipconfigUSE_LINKED_RX_MESSAGES */
 
             msgCount++;
+
+            /* The new buffer may have dirty cache lines, which must be
+             * discarded before the DMA writes to it. */
+            prvInvalidateDMAArea( pxNewBuffer, dmaRX_TX_BUFFER_SIZE );
         }
 
+        rxHead++;
+
+        if( rxHead == ipconfigNIC_N_RX_DESC )
         {
-            if( ucIsCachedMemory( pxNewBuffer->pucEthernetBuffer ) != 0 )
-            {
-                Xil_DCacheInvalidateRange( ( ( uint32_t ) pxNewBuffer->pucEthernetBuffer ) - ipconfigPACKET_FILLER_SIZE, ( uint32_t ) dmaRX_TX_BUFFER_SIZE );
-            }
+            rxHead = 0;
+        }
+    }
 
-            {
-                uint32_t addr = ( ( uint32_t ) pxNewBuffer->pucEthernetBuffer ) & XEMACPS_RXBUF_ADD_MASK;
+    if( iRunLength > 0 )
+    {
+        /* All cache maintenance of the run has completed, now give the
+         * descriptors back to the DMA. */
+        dsb();
 
-                if( rxHead == ( ipconfigNIC_N_RX_DESC - 1 ) )
-                {
-                    addr |= XEMACPS_RXBUF_WRAP_MASK;
-                }
+        iDescriptor = xemacpsif->rxHead;
+
+        for( iIndex = 0; iIndex < iRunLength; iIndex++ )
+        {
+            uint32_t addr = ( ( uint32_t ) pxDMA_rx_buffers[ xEMACIndex ][ iDescriptor ]->pucEthernetBuffer ) & XEMACPS_RXBUF_ADD_MASK;
 
-                /* Clearing 'XEMACPS_RXBUF_NEW_MASK'       0x00000001 *< Used bit.. */
-                xemacpsif->rxSegments[ rxHead ].flags = 0;
-                xemacpsif->rxSegments[ rxHead ].address = addr;
-                /* Make sure that the value has reached the peripheral by reading it back. */
-                ( void ) xemacpsif->rxSegments[ rxHead ].address;
+            if( iDescriptor == ( ipconfigNIC_N_RX_DESC - 1 ) )
+            {
+                addr |= XEMACPS_RXBUF_WRAP_MASK;
             }
-        }
 
-        rxHead++;
+            /* Clearing 'XEMACPS_RXBUF_NEW_MASK'       0x00000001 *< Used bit.. */
+            xemacpsif->rxSegments[ iDescriptor ].flags = 0;
+            xemacpsif->rxSegments[ iDescriptor ].address = addr;
+            iLastDescriptor = iDescriptor;
 
-        if( rxHead == ipconfigNIC_N_RX_DESC )
-        {
-            rxHead = 0;
+            if( ++iDescriptor == ipconfigNIC_N_RX_DESC )
+            {
+                iDescriptor = 0;
+            }
         }
 
+        /* Make sure that the values have reached the peripheral by reading one back. */
+        ( void ) xemacpsif->rxSegments[ iLastDescriptor ].address;
+
         xemacpsif->rxHead = rxHead;
     }
 
@@ -709,11 +783,7 @@ XStatus init_dma( xemacpsif_s * xemacpsif )
         pxDMA_rx_buffers[ xEMACIndex ][ iIndex ] = pxBuffer;
 
         /* Make sure this memory is not in cache for now. */
-        if( ucIsCachedMemory( pxBuffer->pucEthernetBuffer ) != 0 )
-        {
-            Xil_DCacheInvalidateRange( ( ( uint32_t ) pxBuffer->pucEthernetBuffer ) - ipconfigPACKET_FILLER_SIZE,
-                                       ( unsigned ) dmaRX_TX_BUFFER_SIZE );
-        }
+        prvInvalidateDMAArea( pxBuffer, dmaRX_TX_BUFFER_SIZE );
     }
 
     xemacpsif->rxSegments[ ipconfigNIC_N_RX_DESC - 1 ].address |= XEMACPS_RXBUF_WRAP_MASK;
@@ -47,7 +47,9 @@
 #include "FreeRTOS_IP.h"
 #include "FreeRTOS_IP_Private.h"
 #include "NetworkBufferManagement.h"
+#include "NetworkInterface.h"
 #include "FreeRTOS_Stream_Buffer.h"
+#include "FreeRTOS_PacketSocket.h"
 
 /* ========================== Local includes =================================*/
 #include <utils/wait_for_event.h>
@@ -964,9 +966,10 @@ static void prvInterruptSimulatorTask( void * pvParameters )
                      * is ok to call the task level function here, but note that
                      * some buffer implementations cannot be called from a real
                      * interrupt. */
-                    if( xPacketBouncedBack( pucPacketData ) == pdFALSE )
+                    if( ( xPacketBouncedBack( pucPacketData ) == pdFALSE ) &&
+                        ( xNetworkInterfaceRxAdmit( pxMyInterface, pucPacketData, ( size_t ) pxHeader->len ) != pdFALSE ) )
                     {
-                        pxNetworkBuffer = pxGetNetworkBufferWithDescriptor( pxHeader->len, 0 );
+                        pxNetworkBuffer = pxGetNetworkBufferWithClass( pxHeader->len, 0, eBufferClassRX );
                     }
                     else
                     {
@@ -992,6 +995,15 @@ static void prvInterruptSimulatorTask( void * pvParameters )
                             pxNetworkBuffer->pxEndPoint = FreeRTOS_MatchingEndpoint( pxMyInterface, pxNetworkBuffer->pucEthernetBuffer );
                             pxNetworkBuffer->pxEndPoint = pxNetworkEndPoints; /*temporary change for single end point */
 
+                            #if ( ipconfigUSE_PACKET_SOCKETS != 0 )
+                                if( xPacketSocketDriverDeliver( pxNetworkBuffer ) != pdFALSE )
+                                {
+                                    /* A packet socket took the frame, the IP task
+                                     * doesn't need to see it. */
+                                }
+                                else
+                            #endif
+
                             /* Data was received and stored.  Send a message to
                              * the IP task to let it know. */
                             if( xSendEventStructToIPTask( &xRxEvent, ( TickType_t ) 0 ) == pdFAIL )
@@ -41,6 +41,7 @@
 #include "FreeRTOS_DNS.h"
 #include "FreeRTOS_Routing.h"
 #include "FreeRTOS_ND.h"
+#include "FreeRTOS_PacketSocket.h"
 #include "NetworkBufferManagement.h"
 #include "NetworkInterface.h"
 
@@ -102,6 +103,7 @@ NetworkInterface_t * pxLoopback_FillInterfaceDescriptor( BaseType_t xEMACIndex,
     pxInterface->pfInitialise = prvLoopback_Initialise;
     pxInterface->pfOutput = prvLoopback_Output;
     pxInterface->pfGetPhyLinkStatus = prvLoopback_GetPhyLinkStatus;
+    pxInterface->bits.bIsLoopback = pdTRUE_UNSIGNED;
 
     FreeRTOS_AddNetworkInterface( pxInterface );
     xLoopbackInterface = pxInterface;
@@ -124,18 +126,16 @@ static BaseType_t prvLoopback_Output( NetworkInterface_t * pxInterface,
 {
     NetworkBufferDescriptor_t * pxDescriptor = pxGivenDescriptor;
 
-    ( void ) pxInterface;
-
-    IPPacket_t * a = ( IPPacket_t * ) ( pxDescriptor->pucEthernetBuffer );
-
-    if( a->xEthernetHeader.usFrameType == ipIPv4_FRAME_TYPE )
-    {
-        usGenerateProtocolChecksum( pxDescriptor->pucEthernetBuffer, pxDescriptor->xDataLength, pdTRUE );
-    }
-
+    #if ( ipconfigUSE_LOOPBACK_FAST_PATH == 0 )
     {
+        IPPacket_t * a = ( IPPacket_t * ) ( pxDescriptor->pucEthernetBuffer );
         MACAddress_t xMACAddress;
 
+        if( a->xEthernetHeader.usFrameType == ipIPv4_FRAME_TYPE )
+        {
+            usGenerateProtocolChecksum( pxDescriptor->pucEthernetBuffer, pxDescriptor->xDataLength, pdTRUE );
+        }
+
         if( pxDescriptor->pxEndPoint->bits.bIPv6 != 0 )
         {
             #if ( ipconfigUSE_IPv6 != 0 )
@@ -155,6 +155,13 @@ static BaseType_t prvLoopback_Output( NetworkInterface_t * pxInterface,
             #endif
         }
     }
+    #else /* if ( ipconfigUSE_LOOPBACK_FAST_PATH == 0 ) */
+    {
+        /* No checksums are needed: the stack skipped them, and it won't check
+         * packets that come from this interface. The ARP and ND caches are
+         * not used for the MAC address of a loop-back end-point. */
+    }
+    #endif /* ( ipconfigUSE_LOOPBACK_FAST_PATH == 0 ) */
 
     if( bReleaseAfterSend == pdFALSE )
     {
@@ -167,9 +174,20 @@ static BaseType_t prvLoopback_Output( NetworkInterface_t * pxInterface,
     {
         IPStackEvent_t xRxEvent;
 
+        /* The packet is received on the same interface. */
+        pxDescriptor->pxInterface = pxInterface;
+
         xRxEvent.eEventType = eNetworkRxEvent;
         xRxEvent.pvData = ( void * ) pxDescriptor;
 
+        #if ( ipconfigUSE_PACKET_SOCKETS != 0 )
+            if( xPacketSocketDriverDeliver( pxDescriptor ) != pdFALSE )
+            {
+                /* A packet socket received the frame directly. */
+            }
+            else
+        #endif
+
         if( xSendEventStructToIPTask( &xRxEvent, 0u ) != pdTRUE )
         {
             vReleaseNetworkBufferAndDescriptor( pxDescriptor );
@@ -0,0 +1,427 @@
+/*
+ * FreeRTOS+TCP <DEVELOPMENT BRANCH>
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/*
+ * @file deadline_monitor.c
+ * @brief A software watchdog for the IP-task, the EMAC handler tasks and +FAT flushes.
+ * See tools/tcp_utilities/deadline_monitor.md for further description.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include <FreeRTOS.h>
+#include "task.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+
+#include "deadline_monitor.h"
+
+/* The checkpoints, indexed by DeadlineID_t or by an application ID. */
+static DeadlineCheckpoint_t xCheckpoints[ dmonMAX_CHECKPOINTS ];
+
+/* The longest rounds that exceeded their budget, the longest first. */
+static DeadlineOffender_t xOffenders[ dmonHISTORY_LENGTH ];
+static size_t uxOffenderCount = 0U;
+
+/* The I/O managers that own the FAT-flush checkpoints, in the order of
+ * their first flush. */
+static const void * pvFlushOwners[ dmonFAT_DISK_COUNT ];
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Remember a round that exceeded its budget, if it is one of the
+ *        dmonHISTORY_LENGTH longest rounds seen so far.
+ *
+ * @param[in] xID: The checkpoint.
+ * @param[in] ulTag: The tag of the round.
+ * @param[in] ulElapsedUs: The duration of the round.
+ */
+static void prvRecordOffender( BaseType_t xID,
+                               uint32_t ulTag,
+                               uint32_t ulElapsedUs )
+{
+    size_t uxIndex;
+
+    taskENTER_CRITICAL();
+    {
+        /* Find the position in the sorted list. */
+        uxIndex = uxOffenderCount;
+
+        while( ( uxIndex > 0U ) && ( xOffenders[ uxIndex - 1U ].ulElapsedUs < ulElapsedUs ) )
+        {
+            /* Shift the shorter entry down, dropping the last one when the list is full. */
+            if( uxIndex < dmonHISTORY_LENGTH )
+            {
+                xOffenders[ uxIndex ] = xOffenders[ uxIndex - 1U ];
+            }
+
+            uxIndex--;
+        }
+
+        if( uxIndex < dmonHISTORY_LENGTH )
+        {
+            xOffenders[ uxIndex ].xID = xID;
+            xOffenders[ uxIndex ].ulTag = ulTag;
+            xOffenders[ uxIndex ].ulElapsedUs = ulElapsedUs;
+            xOffenders[ uxIndex ].xTickCount = xTaskGetTickCount();
+
+            if( uxOffenderCount < dmonHISTORY_LENGTH )
+            {
+                uxOffenderCount++;
+            }
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Register the built-in checkpoints with their default budgets.
+ *        Call it before the IP-task is started.
+ */
+void vDeadlineMonitorInit( void )
+{
+    static const char * const pcEMACNames[] = { "EMAC0", "EMAC1", "EMAC2", "EMAC3" };
+    static const char * const pcFlushNames[] = { "FAT-flush0", "FAT-flush1", "FAT-flush2", "FAT-flush3" };
+    BaseType_t xIndex;
+
+    ( void ) xDeadlineRegister( eDeadlineIPTask, "IP-task", dmonIP_TASK_BUDGET_US );
+
+    for( xIndex = 0; xIndex < dmonEMAC_COUNT; xIndex++ )
+    {
+        const char * pcName = "EMAC";
+
+        if( xIndex < ( BaseType_t ) ARRAY_SIZE( pcEMACNames ) )
+        {
+            pcName = pcEMACNames[ xIndex ];
+        }
+
+        ( void ) xDeadlineRegister( eDeadlineEMACTask + xIndex, pcName, dmonEMAC_TASK_BUDGET_US );
+    }
+
+    for( xIndex = 0; xIndex < dmonFAT_DISK_COUNT; xIndex++ )
+    {
+        const char * pcName = "FAT-flush";
+
+        if( xIndex < ( BaseType_t ) ARRAY_SIZE( pcFlushNames ) )
+        {
+            pcName = pcFlushNames[ xIndex ];
+        }
+
+        ( void ) xDeadlineRegister( eDeadlineFATFlush + xIndex, pcName, dmonFAT_FLUSH_BUDGET_US );
+    }
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Register a checkpoint, or change the budget of an existing one.
+ *
+ * @param[in] xID: The checkpoint, less than dmonMAX_CHECKPOINTS.
+ * @param[in] pcName: A name used in reports.
+ * @param[in] ulBudgetUs: The maximum time that a round may take, in micro seconds.
+ *
+ * @return pdPASS when the ID is valid, otherwise pdFAIL.
+ */
+BaseType_t xDeadlineRegister( BaseType_t xID,
+                              const char * pcName,
+                              uint32_t ulBudgetUs )
+{
+    BaseType_t xReturn = pdFAIL;
+
+    if( ( xID >= 0 ) && ( xID < dmonMAX_CHECKPOINTS ) && ( pcName != NULL ) )
+    {
+        xCheckpoints[ xID ].ulBudgetUs = ulBudgetUs;
+        xCheckpoints[ xID ].pcName = pcName;
+        xReturn = pdPASS;
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Called by the owning task when it starts a round. It does not take
+ *        any lock: only the owning task writes the round fields.
+ *
+ * @param[in] xID: The checkpoint. Unregistered checkpoints are ignored.
+ * @param[in] ulTag: Stored with the round, e.g. the event being handled.
+ */
+void vDeadlineStart( BaseType_t xID,
+                     uint32_t ulTag )
+{
+    if( ( xID >= 0 ) && ( xID < dmonMAX_CHECKPOINTS ) && ( xCheckpoints[ xID ].pcName != NULL ) )
+    {
+        DeadlineCheckpoint_t * pxCheckpoint = &( xCheckpoints[ xID ] );
+
+        pxCheckpoint->ulTag = ulTag;
+        pxCheckpoint->ulStartUs = dmonGET_TIME_US();
+        pxCheckpoint->xStallReported = pdFALSE;
+        /* Set 'xBusy' last, xDeadlineCheck() reads it first. */
+        pxCheckpoint->xBusy = pdTRUE;
+    }
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Called by the owning task when it ends a round. An end without
+ *        a matching start, like the first call from the IP-task, is ignored.
+ *
+ * @param[in] xID: The checkpoint.
+ */
+void vDeadlineEnd( BaseType_t xID )
+{
+    if( ( xID >= 0 ) && ( xID < dmonMAX_CHECKPOINTS ) && ( xCheckpoints[ xID ].xBusy != pdFALSE ) )
+    {
+        DeadlineCheckpoint_t * pxCheckpoint = &( xCheckpoints[ xID ] );
+        uint32_t ulElapsedUs = dmonGET_TIME_US() - pxCheckpoint->ulStartUs;
+
+        pxCheckpoint->xBusy = pdFALSE;
+        pxCheckpoint->ulRoundCount++;
+
+        if( pxCheckpoint->ulMaxUs < ulElapsedUs )
+        {
+            pxCheckpoint->ulMaxUs = ulElapsedUs;
+        }
+
+        if( ulElapsedUs > pxCheckpoint->ulBudgetUs )
+        {
+            pxCheckpoint->ulOverrunCount++;
+            prvRecordOffender( xID, pxCheckpoint->ulTag, ulElapsedUs );
+
+            #if ( dmonUSE_DEADLINE_HOOK != 0 )
+                {
+                    /* A stall has been reported already. */
+                    if( pxCheckpoint->xStallReported == pdFALSE )
+                    {
+                        vApplicationDeadlineHook( xID, pxCheckpoint, ulElapsedUs, pdFALSE );
+                    }
+                }
+            #endif
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Find the FAT-flush checkpoint of an I/O manager. An I/O manager that
+ *        is seen for the first time gets the next free checkpoint.
+ *
+ * @param[in] pvIOManager: The I/O manager.
+ *
+ * @return The checkpoint, or -1 when all dmonFAT_DISK_COUNT are in use.
+ */
+static BaseType_t prvFlushCheckpoint( const void * pvIOManager )
+{
+    BaseType_t xReturn = -1;
+    BaseType_t xIndex;
+
+    for( xIndex = 0; xIndex < dmonFAT_DISK_COUNT; xIndex++ )
+    {
+        if( pvFlushOwners[ xIndex ] == pvIOManager )
+        {
+            xReturn = eDeadlineFATFlush + xIndex;
+            break;
+        }
+    }
+
+    if( xReturn < 0 )
+    {
+        /* Two disks may be flushed for the first time at once. */
+        taskENTER_CRITICAL();
+        {
+            for( xIndex = 0; xIndex < dmonFAT_DISK_COUNT; xIndex++ )
+            {
+                if( ( pvFlushOwners[ xIndex ] == NULL ) || ( pvFlushOwners[ xIndex ] == pvIOManager ) )
+                {
+                    pvFlushOwners[ xIndex ] = pvIOManager;
+                    xReturn = eDeadlineFATFlush + xIndex;
+                    break;
+                }
+            }
+        }
+        taskEXIT_CRITICAL();
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Called by FF_FlushCache() when it starts. The I/O manager's semaphore
+ *        is held, so each FAT-flush checkpoint has a single writer.
+ *
+ * @param[in] pvIOManager: The I/O manager that is flushed.
+ */
+void vDeadlineFlushStart( const void * pvIOManager )
+{
+    BaseType_t xID = prvFlushCheckpoint( pvIOManager );
+
+    if( xID >= 0 )
+    {
+        vDeadlineStart( xID, 0U );
+    }
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Called by FF_FlushCache() when it is done.
+ *
+ * @param[in] pvIOManager: The I/O manager that was flushed.
+ */
+void vDeadlineFlushEnd( const void * pvIOManager )
+{
+    BaseType_t xID = prvFlushCheckpoint( pvIOManager );
+
+    if( xID >= 0 )
+    {
+        vDeadlineEnd( xID );
+    }
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Look for rounds that have been busy for more than dmonSTALL_FACTOR
+ *        times their budget. Call it periodically from a monitoring task with
+ *        a priority higher than the monitored tasks. Each stall is reported once.
+ *
+ * @return pdPASS when no round is stalled, so the hardware watchdog may be
+ *         kicked, otherwise pdFAIL.
+ */
+BaseType_t xDeadlineCheck( void )
+{
+    BaseType_t xReturn = pdPASS;
+    BaseType_t xID;
+    uint32_t ulNow = dmonGET_TIME_US();
+
+    for( xID = 0; xID < dmonMAX_CHECKPOINTS; xID++ )
+    {
+        DeadlineCheckpoint_t * pxCheckpoint = &( xCheckpoints[ xID ] );
+
+        if( ( pxCheckpoint->pcName != NULL ) && ( pxCheckpoint->xBusy != pdFALSE ) )
+        {
+            uint32_t ulElapsedUs = ulNow - pxCheckpoint->ulStartUs;
+
+            /* The round may have started after 'ulNow' was sampled. */
+            if( ( ulElapsedUs < 0x80000000UL ) &&
+                ( ulElapsedUs > ( pxCheckpoint->ulBudgetUs * dmonSTALL_FACTOR ) ) )
+            {
+                xReturn = pdFAIL;
+
+                if( pxCheckpoint->xStallReported == pdFALSE )
+                {
+                    pxCheckpoint->xStallReported = pdTRUE;
+                    pxCheckpoint->ulStallCount++;
+                    FreeRTOS_printf( ( "xDeadlineCheck: %s stalled for %u us, tag %u\n",
+                                       pxCheckpoint->pcName,
+                                       ( unsigned ) ulElapsedUs,
+                                       ( unsigned ) pxCheckpoint->ulTag ) );
+
+                    #if ( dmonUSE_DEADLINE_HOOK != 0 )
+                        {
+                            vApplicationDeadlineHook( xID, pxCheckpoint, ulElapsedUs, pdTRUE );
+                        }
+                    #endif
+                }
+            }
+        }
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Copy the worst offenders.
+ *
+ * @param[out] pxOffenders: Where the entries are copied to.
+ * @param[in] uxMaxCount: The number of entries that fit in 'pxOffenders'.
+ *
+ * @return The number of entries copied.
+ */
+size_t uxDeadlineGetOffenders( DeadlineOffender_t * pxOffenders,
+                               size_t uxMaxCount )
+{
+    size_t uxCount;
+
+    taskENTER_CRITICAL();
+    {
+        uxCount = ( uxOffenderCount < uxMaxCount ) ? uxOffenderCount : uxMaxCount;
+        ( void ) memcpy( pxOffenders, xOffenders, uxCount * sizeof( xOffenders[ 0 ] ) );
+    }
+    taskEXIT_CRITICAL();
+
+    return uxCount;
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Print the checkpoints and the worst offenders with FreeRTOS_printf().
+ */
+void vDeadlineShow( void )
+{
+    DeadlineOffender_t xCopy[ dmonHISTORY_LENGTH ];
+    size_t uxCount;
+    size_t uxIndex;
+    BaseType_t xID;
+
+    FreeRTOS_printf( ( "%-10s %8s %10s %8s %8s %6s\n", "Name", "Budget", "Rounds", "Max", "Overrun", "Stall" ) );
+
+    for( xID = 0; xID < dmonMAX_CHECKPOINTS; xID++ )
+    {
+        const DeadlineCheckpoint_t * pxCheckpoint = &( xCheckpoints[ xID ] );
+
+        if( pxCheckpoint->pcName != NULL )
+        {
+            FreeRTOS_printf( ( "%-10s %8u %10u %8u %8u %6u\n",
+                               pxCheckpoint->pcName,
+                               ( unsigned ) pxCheckpoint->ulBudgetUs,
+                               ( unsigned ) pxCheckpoint->ulRoundCount,
+                               ( unsigned ) pxCheckpoint->ulMaxUs,
+                               ( unsigned ) pxCheckpoint->ulOverrunCount,
+                               ( unsigned ) pxCheckpoint->ulStallCount ) );
+        }
+    }
+
+    uxCount = uxDeadlineGetOffenders( xCopy, ARRAY_SIZE( xCopy ) );
+
+    for( uxIndex = 0U; uxIndex < uxCount; uxIndex++ )
+    {
+        FreeRTOS_printf( ( "Offender %u: %s took %u us, tag %u, at tick %u\n",
+                           ( unsigned ) uxIndex,
+                           xCheckpoints[ xCopy[ uxIndex ].xID ].pcName,
+                           ( unsigned ) xCopy[ uxIndex ].ulElapsedUs,
+                           ( unsigned ) xCopy[ uxIndex ].ulTag,
+                           ( unsigned ) xCopy[ uxIndex ].xTickCount ) );
+    }
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,197 @@
+/*
+ * FreeRTOS+TCP <DEVELOPMENT BRANCH>
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/*
+ * deadline_monitor.h
+ * A software watchdog that measures how long a task is busy in each round
+ * of its main loop. See tools/tcp_utilities/deadline_monitor.md
+ */
+
+#ifndef DEADLINE_MONITOR_H
+
+    #define DEADLINE_MONITOR_H
+
+    #ifdef __cplusplus
+    extern "C" {
+    #endif
+
+/* The number of checkpoints, including the built-in ones. */
+    #ifndef dmonMAX_CHECKPOINTS
+        #define dmonMAX_CHECKPOINTS    8
+    #endif
+
+/* The number of worst overruns that are remembered. */
+    #ifndef dmonHISTORY_LENGTH
+        #define dmonHISTORY_LENGTH    8
+    #endif
+
+/* The number of EMAC's that have a handler task. */
+    #ifndef dmonEMAC_COUNT
+        #define dmonEMAC_COUNT    2
+    #endif
+
+/* The number of +FAT I/O managers ( disks ) whose flushes are monitored.
+ * Each one gets its own checkpoint, in the order of their first flush. */
+    #ifndef dmonFAT_DISK_COUNT
+        #define dmonFAT_DISK_COUNT    2
+    #endif
+
+/* A round that is still busy after 'dmonSTALL_FACTOR' times its budget is
+ * reported as a stall by xDeadlineCheck(). */
+    #ifndef dmonSTALL_FACTOR
+        #define dmonSTALL_FACTOR    4U
+    #endif
+
+/* The default budgets of the built-in checkpoints, in micro seconds. */
+    #ifndef dmonIP_TASK_BUDGET_US
+        #define dmonIP_TASK_BUDGET_US    20000U
+    #endif
+
+    #ifndef dmonEMAC_TASK_BUDGET_US
+        #define dmonEMAC_TASK_BUDGET_US    10000U
+    #endif
+
+    #ifndef dmonFAT_FLUSH_BUDGET_US
+        #define dmonFAT_FLUSH_BUDGET_US    200000U
+    #endif
+
+/* Returns a 32-bit time stamp in micro seconds. The default has the
+ * resolution of a clock tick. Define it to read a hardware timer when
+ * budgets are shorter than a few clock ticks. */
+    #ifndef dmonGET_TIME_US
+        #define dmonGET_TIME_US()    ( ( uint32_t ) ( xTaskGetTickCount() * ( 1000000UL / configTICK_RATE_HZ ) ) )
+    #endif
+
+/* When defined as 1, the application must provide vApplicationDeadlineHook(). */
+    #ifndef dmonUSE_DEADLINE_HOOK
+        #define dmonUSE_DEADLINE_HOOK    0
+    #endif
+
+    typedef enum xDEADLINE_ID
+    {
+        eDeadlineIPTask = 0,                                        /* The loop in prvProcessIPEventsAndTimers(). */
+        eDeadlineEMACTask,                                          /* The first EMAC handler task. */
+        eDeadlineFATFlush = eDeadlineEMACTask + dmonEMAC_COUNT,     /* FF_FlushCache() of the first I/O manager. */
+        eDeadlineFirstUser = eDeadlineFATFlush + dmonFAT_DISK_COUNT /* The first ID that the application may use. */
+    } DeadlineID_t;
+
+    typedef struct xDEADLINE_CHECKPOINT
+    {
+        const char * pcName;          /* NULL as long as the checkpoint is not registered. */
+        uint32_t ulBudgetUs;          /* The maximum time that a round may take. */
+        volatile uint32_t ulStartUs;  /* The time at which the current round started. */
+        volatile uint32_t ulTag;      /* Passed to vDeadlineStart(), e.g. the IP-task event. */
+        volatile BaseType_t xBusy;    /* True between vDeadlineStart() and vDeadlineEnd(). */
+        BaseType_t xStallReported;    /* The current round was reported as a stall. */
+        uint32_t ulRoundCount;        /* The number of completed rounds. */
+        uint32_t ulOverrunCount;      /* The number of rounds that exceeded the budget. */
+        uint32_t ulStallCount;        /* The number of stalls reported by xDeadlineCheck(). */
+        uint32_t ulMaxUs;             /* The longest round so far. */
+    } DeadlineCheckpoint_t;
+
+    typedef struct xDEADLINE_OFFENDER
+    {
+        BaseType_t xID;               /* The checkpoint. */
+        uint32_t ulTag;               /* The tag of the round. */
+        uint32_t ulElapsedUs;         /* The duration of the round. */
+        TickType_t xTickCount;        /* The time at which it ended. */
+    } DeadlineOffender_t;
+
+/* Register the built-in checkpoints with their default budgets. */
+    void vDeadlineMonitorInit( void );
+
+/* Register a checkpoint, or change its budget. */
+    BaseType_t xDeadlineRegister( BaseType_t xID,
+                                  const char * pcName,
+                                  uint32_t ulBudgetUs );
+
+/* Called by the owning task when it starts and ends a round of its loop. */
+    void vDeadlineStart( BaseType_t xID,
+                         uint32_t ulTag );
+
+    void vDeadlineEnd( BaseType_t xID );
+
+/* Called by FF_FlushCache(). Each I/O manager has its own checkpoint,
+ * because disks may be flushed at the same time. */
+    void vDeadlineFlushStart( const void * pvIOManager );
+
+    void vDeadlineFlushEnd( const void * pvIOManager );
+
+/* Look for stalled rounds. Returns pdFAIL when a round is stalled, in which
+ * case the hardware watchdog should not be kicked. */
+    BaseType_t xDeadlineCheck( void );
+
+/* Copy the worst offenders, the longest round first. */
+    size_t uxDeadlineGetOffenders( DeadlineOffender_t * pxOffenders,
+                                   size_t uxMaxCount );
+
+/* Print the checkpoints and the worst offenders. */
+    void vDeadlineShow( void );
+
+    #if ( dmonUSE_DEADLINE_HOOK != 0 )
+
+/* Provided by the application. Called from vDeadlineEnd() when a round took
+ * too long ( xStalled == pdFALSE ), or from xDeadlineCheck() when a round
+ * has not finished after dmonSTALL_FACTOR times its budget ( xStalled == pdTRUE ).
+ * It may try to recover, or reset the system. */
+        void vApplicationDeadlineHook( BaseType_t xID,
+                                       const DeadlineCheckpoint_t * pxCheckpoint,
+                                       uint32_t ulElapsedUs,
+                                       BaseType_t xStalled );
+    #endif
+
+    #if defined( ipconfigUSE_DEADLINE_MONITOR ) && ( ipconfigUSE_DEADLINE_MONITOR != 0 )
+
+        #define iptraceIP_TASK_LOOP_START( eEvent ) \
+    vDeadlineStart( eDeadlineIPTask, ( uint32_t ) ( eEvent ) )
+
+        #define iptraceIP_TASK_LOOP_END() \
+    vDeadlineEnd( eDeadlineIPTask )
+
+        #define iptraceEMAC_TASK_LOOP_START( xEMACIndex ) \
+    vDeadlineStart( eDeadlineEMACTask + ( xEMACIndex ), 0U )
+
+        #define iptraceEMAC_TASK_LOOP_END( xEMACIndex ) \
+    vDeadlineEnd( eDeadlineEMACTask + ( xEMACIndex ) )
+
+        #define ffconfigTRACE_FLUSH_CACHE_START( pxIOManager ) \
+    vDeadlineFlushStart( pxIOManager )
+
+        #define ffconfigTRACE_FLUSH_CACHE_END( pxIOManager ) \
+    vDeadlineFlushEnd( pxIOManager )
+    #else /* if defined( ipconfigUSE_DEADLINE_MONITOR ) && ( ipconfigUSE_DEADLINE_MONITOR != 0 ) */
+
+/* The header files 'IPTraceMacroDefaults.h' and 'FreeRTOSFATConfigDefaults.h'
+ * will define the default empty macro's. */
+
+    #endif /* ipconfigUSE_DEADLINE_MONITOR != 0 */
+
+    #ifdef __cplusplus
+}         /* extern "C" */
+    #endif
+
+#endif /* DEADLINE_MONITOR_H */
@@ -54,6 +54,11 @@
 
         void vTCPMemStatClose( void );
 
+        #if ( ipconfigUSE_BUFFER_CLASSES != 0 )
+            /* Print the accounting of the network buffer classes. */
+            void vTCPMemStatBufferClasses( void );
+        #endif
+
         #define iptraceMEM_STATS_CREATE( xMemType, pxObject, uxSize ) \
     vTCPMemStatCreate( xMemType, pxObject, uxSize )
 
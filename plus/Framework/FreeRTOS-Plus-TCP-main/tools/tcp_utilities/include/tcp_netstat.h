@@ -103,6 +103,13 @@ typedef struct
 extern BaseType_t vGetMetrics( MetricsType_t * pxMetrics );
 extern void vShowMetrics( const MetricsType_t * pxMetrics );
 
+#if ( ipconfigUSE_IP_COUNTERS != 0 )
+
+/* Print the MIB-II counters of the IP-stack and of all interfaces,
+ * either as CSV or as JSON. */
+    extern void vShowIPCounters( BaseType_t xAsJSON );
+#endif
+
 
 #define iptraceNETWORK_INTERFACE_INPUT( uxDataLength, pucEthernetBuffer ) \
     xInputCounters.uxByteCount += uxDataLength;                           \
@@ -46,6 +46,7 @@
 #include "FreeRTOS_Stream_Buffer.h"
 #include "FreeRTOS_ARP.h"
 #include "FreeRTOS_IP_Private.h"
+#include "NetworkBufferManagement.h"
 
 #include "tcp_mem_stats.h"
 
@@ -446,8 +447,44 @@
             STATS_PRINTF( ( "TCPMemStat,Maximum RAM usage:,,,=SUM(D%d;D%d)\n",
                             xLastHeaderLineNr + 1,
                             xLastLineNr + 1 ) );
+            #if ( ipconfigUSE_BUFFER_CLASSES != 0 )
+                vTCPMemStatBufferClasses();
+            #endif
         }
     }
 /*-----------------------------------------------------------*/
 
+    #if ( ipconfigUSE_BUFFER_CLASSES != 0 )
+        void vTCPMemStatBufferClasses( void )
+        {
+            static const char * const pcClassNames[ eBufferClassCount ] =
+            {
+                "None",
+                "RX",
+                "TCP_TX",
+                "UDP_TX",
+                "Control"
+            };
+            NetworkBufferClassStats_t xStats;
+            BaseType_t xClass;
+
+            /* class;in use;max in use;reserve;limit;granted;refused */
+            STATS_PRINTF( ( "TCPMemStat,BufferClass,InUse,MaxInUse,Reserve,Limit,Granted,Refused\n" ) );
+
+            for( xClass = ( BaseType_t ) eBufferClassRX; xClass < ( BaseType_t ) eBufferClassCount; xClass++ )
+            {
+                vGetNetworkBufferClassStats( ( eNetworkBufferClass_t ) xClass, &( xStats ) );
+                STATS_PRINTF( ( "TCPMemStat,%s,%u,%u,%u,%u,%u,%u\n",
+                                pcClassNames[ xClass ],
+                                ( unsigned ) xStats.uxInUse,
+                                ( unsigned ) xStats.uxMaxInUse,
+                                ( unsigned ) xStats.uxReserve,
+                                ( unsigned ) xStats.uxLimit,
+                                ( unsigned ) xStats.ulGranted,
+                                ( unsigned ) xStats.ulRefused ) );
+            }
+        }
+    #endif /* ipconfigUSE_BUFFER_CLASSES != 0 */
+/*-----------------------------------------------------------*/
+
 #endif /* ( ipconfigUSE_TCP_MEM_STATS != 0 ) */
@@ -28,6 +28,7 @@
 /* Standard includes. */
 #include <stdint.h>
 #include <stdio.h>
+#include <stddef.h>
 
 /* FreeRTOS includes. */
 #include "FreeRTOS.h"
@@ -39,6 +40,7 @@
 #include "FreeRTOS_IP.h"
 #include "FreeRTOS_Sockets.h"
 #include "FreeRTOS_IP_Private.h"
+#include "FreeRTOS_Routing.h"
 
 #include "tcp_netstat.h"
 
@@ -194,3 +196,146 @@ void vShowMetrics( const MetricsType_t * pxMetrics )
                            pxMetrics->xUDPSocketList.xUDPList[ uxIndex ].usLocalPort ) );
     }
 }
+
+#if ( ipconfigUSE_IP_COUNTERS != 0 )
+
+/* Maps a field of a counter struct onto its MIB-II name. */
+    typedef struct xCOUNTER_NAME
+    {
+        const char * pcName;
+        size_t uxOffset;
+    } CounterName_t;
+
+    #define nstatIP_COUNTER( xField, pcName )    { pcName, offsetof( IPCounters_t, xField ) }
+    #define nstatIF_COUNTER( xField, pcName )    { pcName, offsetof( IfCounters_t, xField ) }
+
+    static const CounterName_t xIPCounterNames[] =
+    {
+        nstatIP_COUNTER( ulIpInReceives,      "ipInReceives"      ),
+        nstatIP_COUNTER( ulIpInHdrErrors,     "ipInHdrErrors"     ),
+        nstatIP_COUNTER( ulIpInAddrErrors,    "ipInAddrErrors"    ),
+        nstatIP_COUNTER( ulIpInUnknownProtos, "ipInUnknownProtos" ),
+        nstatIP_COUNTER( ulIpInDelivers,      "ipInDelivers"      ),
+        nstatIP_COUNTER( ulIpOutRequests,     "ipOutRequests"     ),
+        nstatIP_COUNTER( ulIpReasmFails,      "ipReasmFails"      ),
+        nstatIP_COUNTER( ulIcmpInMsgs,        "icmpInMsgs"        ),
+        nstatIP_COUNTER( ulIcmpInErrors,      "icmpInErrors"      ),
+        nstatIP_COUNTER( ulIcmpInEchos,       "icmpInEchos"       ),
+        nstatIP_COUNTER( ulIcmpInEchoReps,    "icmpInEchoReps"    ),
+        nstatIP_COUNTER( ulIcmpOutMsgs,       "icmpOutMsgs"       ),
+        nstatIP_COUNTER( ulIcmpOutEchoReps,   "icmpOutEchoReps"   ),
+        nstatIP_COUNTER( ulUdpInDatagrams,    "udpInDatagrams"    ),
+        nstatIP_COUNTER( ulUdpNoPorts,        "udpNoPorts"        ),
+        nstatIP_COUNTER( ulUdpInErrors,       "udpInErrors"       ),
+        nstatIP_COUNTER( ulUdpOutDatagrams,   "udpOutDatagrams"   ),
+        nstatIP_COUNTER( ulTcpActiveOpens,    "tcpActiveOpens"    ),
+        nstatIP_COUNTER( ulTcpPassiveOpens,   "tcpPassiveOpens"   ),
+        nstatIP_COUNTER( ulTcpAttemptFails,   "tcpAttemptFails"   ),
+        nstatIP_COUNTER( ulTcpEstabResets,    "tcpEstabResets"    ),
+        nstatIP_COUNTER( ulTcpCurrEstab,      "tcpCurrEstab"      ),
+        nstatIP_COUNTER( ulTcpInSegs,         "tcpInSegs"         ),
+        nstatIP_COUNTER( ulTcpOutSegs,        "tcpOutSegs"        ),
+        nstatIP_COUNTER( ulTcpRetransSegs,    "tcpRetransSegs"    ),
+        nstatIP_COUNTER( ulTcpInErrs,         "tcpInErrs"         ),
+        nstatIP_COUNTER( ulTcpOutRsts,        "tcpOutRsts"        )
+    };
+
+    static const CounterName_t xIfCounterNames[] =
+    {
+        nstatIF_COUNTER( ulInOctets,        "ifInOctets"        ),
+        nstatIF_COUNTER( ulInUcastPkts,     "ifInUcastPkts"     ),
+        nstatIF_COUNTER( ulInNUcastPkts,    "ifInNUcastPkts"    ),
+        nstatIF_COUNTER( ulInDiscards,      "ifInDiscards"      ),
+        nstatIF_COUNTER( ulInErrors,        "ifInErrors"        ),
+        nstatIF_COUNTER( ulInUnknownProtos, "ifInUnknownProtos" ),
+        nstatIF_COUNTER( ulOutOctets,       "ifOutOctets"       ),
+        nstatIF_COUNTER( ulOutUcastPkts,    "ifOutUcastPkts"    ),
+        nstatIF_COUNTER( ulOutNUcastPkts,   "ifOutNUcastPkts"   )
+    };
+
+    #define nstatARRAY_SIZE( x )    ( sizeof( x ) / sizeof( ( x )[ 0 ] ) )
+
+/* Print one group of counters, either as CSV lines "scope,name,value", or as
+ * the members of a JSON object. */
+    static void prvShowCounters( const char * pcScope,
+                                 const void * pvCounters,
+                                 const CounterName_t * pxNames,
+                                 size_t uxCount,
+                                 BaseType_t xAsJSON )
+    {
+        size_t uxIndex;
+        const uint8_t * pucCounters = ( const uint8_t * ) pvCounters;
+
+        for( uxIndex = 0; uxIndex < uxCount; uxIndex++ )
+        {
+            uint32_t ulValue;
+
+            memcpy( &ulValue, &( pucCounters[ pxNames[ uxIndex ].uxOffset ] ), sizeof ulValue );
+
+            if( xAsJSON != pdFALSE )
+            {
+                FreeRTOS_printf( ( "    \"%s\": %lu%s\n",
+                                   pxNames[ uxIndex ].pcName,
+                                   ( unsigned long ) ulValue,
+                                   ( uxIndex + 1U < uxCount ) ? "," : "" ) );
+            }
+            else
+            {
+                FreeRTOS_printf( ( "%s,%s,%lu\n",
+                                   pcScope,
+                                   pxNames[ uxIndex ].pcName,
+                                   ( unsigned long ) ulValue ) );
+            }
+        }
+    }
+
+    void vShowIPCounters( BaseType_t xAsJSON )
+    {
+        IPCounters_t xCounters;
+        IfCounters_t xIfCounters;
+        const NetworkInterface_t * pxInterface;
+
+        vGetIPCounters( &xCounters );
+
+        if( xAsJSON != pdFALSE )
+        {
+            FreeRTOS_printf( ( "{\n  \"ip\": {\n" ) );
+        }
+        else
+        {
+            FreeRTOS_printf( ( "scope,counter,value\n" ) );
+        }
+
+        prvShowCounters( "ip", &xCounters, xIPCounterNames, nstatARRAY_SIZE( xIPCounterNames ), xAsJSON );
+
+        if( xAsJSON != pdFALSE )
+        {
+            FreeRTOS_printf( ( "  },\n  \"interfaces\": {\n" ) );
+        }
+
+        for( pxInterface = FreeRTOS_FirstNetworkInterface();
+             pxInterface != NULL;
+             pxInterface = FreeRTOS_NextNetworkInterface( pxInterface ) )
+        {
+            vGetInterfaceCounters( pxInterface, &xIfCounters );
+
+            if( xAsJSON != pdFALSE )
+            {
+                FreeRTOS_printf( ( "   \"%s\": {\n", pxInterface->pcName ) );
+            }
+
+            prvShowCounters( pxInterface->pcName, &xIfCounters, xIfCounterNames, nstatARRAY_SIZE( xIfCounterNames ), xAsJSON );
+
+            if( xAsJSON != pdFALSE )
+            {
+                FreeRTOS_printf( ( "   }%s\n", ( pxInterface->pxNext != NULL ) ? "," : "" ) );
+            }
+        }
+
+        if( xAsJSON != pdFALSE )
+        {
+            FreeRTOS_printf( ( "  }\n}\n" ) );
+        }
+    }
+
+#endif /* ipconfigUSE_IP_COUNTERS != 0 */
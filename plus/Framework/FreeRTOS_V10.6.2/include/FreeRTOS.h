@@ -303,6 +303,10 @@
     #define configUSE_MUTEXES    0
 #endif
 
+#ifndef configUSE_FAST_MUTEXES
+    #define configUSE_FAST_MUTEXES    0
+#endif
+
 #ifndef configUSE_TIMERS
     #define configUSE_TIMERS    0
 #endif
@@ -1023,6 +1027,10 @@
     #error configUSE_MUTEXES must be set to 1 to use recursive mutexes
 #endif
 
+#if ( ( configUSE_FAST_MUTEXES == 1 ) && ( configUSE_MUTEXES != 1 ) )
+    #error configUSE_MUTEXES must be set to 1 to use fast mutexes
+#endif
+
 #ifndef configINITIAL_TICK_COUNT
     #define configINITIAL_TICK_COUNT    0
 #endif
@@ -1394,6 +1402,64 @@ typedef struct xSTATIC_EVENT_GROUP
     #endif
 } StaticEventGroup_t;
 
+/*
+ * In line with software engineering best practice, FreeRTOS implements a strict
+ * data hiding policy, so the fast mutex structure used internally by FreeRTOS
+ * is not accessible to application code.  The StaticFastMutex_t structure
+ * below has the size and alignment of the genuine structure, and is provided
+ * to allow the application writer to statically allocate the memory required
+ * to create a fast mutex.
+ */
+typedef struct xSTATIC_FAST_MUTEX
+{
+    void * pvDummy1;
+    StaticList_t xDummy2;
+    UBaseType_t uxDummy3;
+
+    #if ( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
+        uint8_t ucDummy4;
+    #endif
+} StaticFastMutex_t;
+
+/*
+ * The StaticRWLock_t structure has the size and alignment of the reader-writer
+ * lock structure used internally by FreeRTOS, and is provided to allow the
+ * application writer to statically allocate the memory required to create a
+ * reader-writer lock.
+ */
+typedef struct xSTATIC_RW_LOCK
+{
+    void * pvDummy1;
+    UBaseType_t uxDummy2[ 2 ];
+    StaticList_t xDummy3[ 2 ];
+
+    #if ( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
+        uint8_t ucDummy4;
+    #endif
+} StaticRWLock_t;
+
+/*
+ * The StaticWorkItem_t structure has the size and alignment of the work item
+ * structure used internally by FreeRTOS, and is provided to allow the
+ * application writer to statically allocate the memory required to create a
+ * work item.
+ */
+typedef struct xSTATIC_WORK_ITEM
+{
+    StaticListItem_t xDummy1;
+    TaskFunction_t pvDummy2;
+    void * pvDummy3;
+    TickType_t xDummy4[ 2 ];
+    UBaseType_t uxDummy5;
+    uint32_t ulDummy6;
+    configRUN_TIME_COUNTER_TYPE ulDummy7[ 2 ];
+    TickType_t xDummy8;
+
+    #if ( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
+        uint8_t ucDummy9;
+    #endif
+} StaticWorkItem_t;
+
 /*
  * In line with software engineering best practice, especially when supplying a
  * library that is likely to change in future versions, FreeRTOS implements a
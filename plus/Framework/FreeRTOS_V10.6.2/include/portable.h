@@ -140,6 +140,21 @@ typedef struct HeapRegion
     size_t xSizeInBytes;
 } HeapRegion_t;
 
+/* Attributes of a memory region, used by heap_6.c to decide where an object
+ * is placed. */
+#define portHEAP_ATTR_FAST    ( ( uint32_t ) 0x01U ) /* Tightly coupled or zero wait-state RAM, such as DTCM. */
+#define portHEAP_ATTR_DMA     ( ( uint32_t ) 0x02U ) /* RAM that can be reached by DMA masters, and that is coherent for them. */
+#define portHEAP_ATTR_BULK    ( ( uint32_t ) 0x04U ) /* Large and slower RAM, such as external SDRAM. */
+
+/* Used by heap_6.c to define the start address, size and attributes of each
+ * memory region. */
+typedef struct HeapTaggedRegion
+{
+    uint8_t * pucStartAddress;
+    size_t xSizeInBytes;
+    uint32_t ulAttributes; /* A combination of the portHEAP_ATTR_ bits. */
+} HeapTaggedRegion_t;
+
 /* Used to pass information about the heap out of vPortGetHeapStats(). */
 typedef struct xHeapStats
 {
@@ -171,6 +186,32 @@ void vPortDefineHeapRegions( const HeapRegion_t * const pxHeapRegions ) PRIVILEG
  */
 void vPortGetHeapStats( HeapStats_t * pxHeapStats );
 
+/*
+ * Used to define tagged heap regions for use by heap_6.c.  The array is
+ * terminated by a region that has a size of 0.  The regions must appear in
+ * address order.  Regions that have the same attributes are searched in the
+ * order in which they appear.
+ */
+void vPortDefineTaggedHeapRegions( const HeapTaggedRegion_t * const pxHeapRegions ) PRIVILEGED_FUNCTION;
+
+/*
+ * heap_6.c only: allocate from a region that has all 'ulRequiredAttributes'.
+ * Regions that also have all 'ulPreferredAttributes' are tried first.
+ * pvPortMalloc( xSize ) is the same as pvPortMallocTagged( xSize, 0, 0 ).
+ * Memory is returned with vPortFree().
+ */
+void * pvPortMallocTagged( size_t xWantedSize,
+                           uint32_t ulRequiredAttributes,
+                           uint32_t ulPreferredAttributes ) PRIVILEGED_FUNCTION;
+
+/*
+ * heap_6.c only: fill in the attributes and the statistics of region
+ * 'xRegionIndex'.  Returns pdFAIL when there is no such region.
+ */
+BaseType_t xPortGetTaggedHeapStats( BaseType_t xRegionIndex,
+                                    uint32_t * pulAttributes,
+                                    HeapStats_t * pxHeapStats );
+
 /*
  * Map to the memory management routines required for the port.
  */
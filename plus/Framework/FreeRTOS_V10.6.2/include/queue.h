@@ -57,6 +57,14 @@ typedef struct QueueDefinition   * QueueHandle_t;
  */
 typedef struct QueueDefinition   * QueueSetHandle_t;
 
+/**
+ * Type by which fast mutexes are referenced.  For example, a call to
+ * xSemaphoreCreateFastMutex() returns a FastMutexHandle_t variable that can
+ * then be used as a parameter to xSemaphoreTakeFast() and xSemaphoreGiveFast().
+ */
+struct FastMutexDefinition;
+typedef struct FastMutexDefinition * FastMutexHandle_t;
+
 /**
  * Queue sets can contain both queues and semaphores, so the
  * QueueSetMemberHandle_t is defined as a type to be used where a parameter or
@@ -1503,6 +1511,19 @@ BaseType_t xQueueTakeMutexRecursive( QueueHandle_t xMutex,
                                      TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
 BaseType_t xQueueGiveMutexRecursive( QueueHandle_t xMutex ) PRIVILEGED_FUNCTION;
 
+/*
+ * For internal use only.  Use xSemaphoreCreateFastMutex(),
+ * xSemaphoreTakeFast(), xSemaphoreGiveFast() etc. instead of calling these
+ * functions directly.
+ */
+FastMutexHandle_t xQueueCreateFastMutex( void ) PRIVILEGED_FUNCTION;
+FastMutexHandle_t xQueueCreateFastMutexStatic( StaticFastMutex_t * pxStaticFastMutex ) PRIVILEGED_FUNCTION;
+BaseType_t xQueueFastMutexTake( FastMutexHandle_t xMutex,
+                                TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+BaseType_t xQueueFastMutexGive( FastMutexHandle_t xMutex ) PRIVILEGED_FUNCTION;
+TaskHandle_t xQueueGetFastMutexHolder( FastMutexHandle_t xMutex ) PRIVILEGED_FUNCTION;
+void vQueueDeleteFastMutex( FastMutexHandle_t xMutex ) PRIVILEGED_FUNCTION;
+
 /*
  * Reset a queue back to its original empty state.  The return value is now
  * obsolete and is always set to pdPASS.
@@ -0,0 +1,305 @@
+/*
+ * FreeRTOS Kernel V10.6.2
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+#ifndef RWLOCK_H
+#define RWLOCK_H
+
+#ifndef INC_FREERTOS_H
+    #error "include FreeRTOS.h" must appear in source files before "include rwlock.h"
+#endif
+
+/* FreeRTOS includes. */
+#include "task.h"
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/**
+ * A reader-writer lock protects data that is read often and changed rarely.
+ * Any number of tasks can hold the lock for reading at the same time, while a
+ * task that holds it for writing has exclusive access.
+ *
+ * Writers are preferred: once a task waits for write access, new readers wait
+ * until the writers are done.  When the lock is given while a task waits for
+ * write access, it is handed to that task directly.  The task that holds the
+ * lock for writing
+ * inherits the priority of the tasks that wait for the lock, in the same way
+ * as a mutex holder does.  Tasks that hold the lock for reading are not
+ * tracked and do not inherit a priority.
+ *
+ * Reader-writer locks can not be used from an interrupt.  To share small data
+ * with an interrupt, or to read it without ever blocking, see the sequence
+ * locks below.
+ */
+
+/**
+ * rwlock.h
+ *
+ * Type by which reader-writer locks are referenced.  For example, a call to
+ * xRWLockCreate() returns an RWLockHandle_t variable that can then be used as
+ * a parameter to the other reader-writer lock functions.
+ *
+ * \defgroup RWLockHandle_t RWLockHandle_t
+ * \ingroup RWLock
+ */
+struct RWLockDefinition;
+typedef struct RWLockDefinition * RWLockHandle_t;
+
+/**
+ * rwlock.h
+ *
+ * A sequence lock for a few words of data that are written rarely, possibly
+ * from an interrupt, and read often.  Readers do not block and do not disable
+ * interrupts: they read a sequence number, copy the data, and repeat when the
+ * sequence number shows that a writer was active in the meantime.  Writers
+ * update the data in a short critical section.
+ *
+ * Example usage:
+ * @code{c}
+ * static SeqLock_t xTimeLock = seqLOCK_INITIALISER;
+ * static uint64_t ullTime;
+ *
+ * // In the writer.
+ * vSeqLockWriteBegin( &xTimeLock );
+ * ullTime = ullNewTime;
+ * vSeqLockWriteEnd( &xTimeLock );
+ *
+ * // In a reader.
+ * do
+ * {
+ *     uxSequence = uxSeqLockReadBegin( &xTimeLock );
+ *     ullCopy = ullTime;
+ * } while( xSeqLockReadRetry( &xTimeLock, uxSequence ) != pdFALSE );
+ * @endcode
+ * \defgroup SeqLock_t SeqLock_t
+ * \ingroup RWLock
+ */
+typedef struct xSEQ_LOCK
+{
+    volatile UBaseType_t uxSequence; /**< Odd while a writer is active. */
+} SeqLock_t;
+
+#define seqLOCK_INITIALISER    { 0U }
+
+/**
+ * rwlock.h
+ * @code{c}
+ * RWLockHandle_t xRWLockCreate( void );
+ * @endcode
+ *
+ * Create a new reader-writer lock, using dynamically allocated memory.
+ *
+ * @return If the lock was created then a handle to the lock is returned.  If
+ * there was insufficient FreeRTOS heap available then NULL is returned.
+ *
+ * \defgroup xRWLockCreate xRWLockCreate
+ * \ingroup RWLock
+ */
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+    RWLockHandle_t xRWLockCreate( void ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * rwlock.h
+ * @code{c}
+ * RWLockHandle_t xRWLockCreateStatic( StaticRWLock_t * pxRWLockBuffer );
+ * @endcode
+ *
+ * Create a new reader-writer lock in the memory pointed to by pxRWLockBuffer.
+ *
+ * @param pxRWLockBuffer Must point to a variable of type StaticRWLock_t, which
+ * will be used to hold the lock's data structure.
+ *
+ * @return pxRWLockBuffer cast to a RWLockHandle_t.
+ *
+ * \defgroup xRWLockCreateStatic xRWLockCreateStatic
+ * \ingroup RWLock
+ */
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+    RWLockHandle_t xRWLockCreateStatic( StaticRWLock_t * pxRWLockBuffer ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * rwlock.h
+ * @code{c}
+ * void vRWLockDelete( RWLockHandle_t xRWLock );
+ * @endcode
+ *
+ * Delete a reader-writer lock.  The lock must not be held, and no task may be
+ * waiting for it.
+ *
+ * @param xRWLock The lock being deleted.
+ *
+ * \defgroup vRWLockDelete vRWLockDelete
+ * \ingroup RWLock
+ */
+void vRWLockDelete( RWLockHandle_t xRWLock ) PRIVILEGED_FUNCTION;
+
+/**
+ * rwlock.h
+ * @code{c}
+ * BaseType_t xRWLockTakeRead( RWLockHandle_t xRWLock, TickType_t xTicksToWait );
+ * @endcode
+ *
+ * Obtain the lock for reading.  This succeeds when no task holds the lock for
+ * writing, and no task is waiting to obtain it for writing.  A task may not
+ * take the lock for reading while it holds it already.
+ *
+ * @param xRWLock The lock being obtained.
+ *
+ * @param xTicksToWait The maximum amount of time (specified in 'ticks') to
+ * wait for the lock.  A block time of zero can be used to poll the lock.
+ *
+ * @return pdPASS if the lock was obtained, pdFAIL if xTicksToWait expired.
+ *
+ * \defgroup xRWLockTakeRead xRWLockTakeRead
+ * \ingroup RWLock
+ */
+BaseType_t xRWLockTakeRead( RWLockHandle_t xRWLock,
+                            TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * rwlock.h
+ * @code{c}
+ * void vRWLockGiveRead( RWLockHandle_t xRWLock );
+ * @endcode
+ *
+ * Release the lock after a successful call to xRWLockTakeRead().  When the
+ * last reader gives the lock, a task that waits for write access is unblocked.
+ *
+ * \defgroup vRWLockGiveRead vRWLockGiveRead
+ * \ingroup RWLock
+ */
+void vRWLockGiveRead( RWLockHandle_t xRWLock ) PRIVILEGED_FUNCTION;
+
+/**
+ * rwlock.h
+ * @code{c}
+ * BaseType_t xRWLockTakeWrite( RWLockHandle_t xRWLock, TickType_t xTicksToWait );
+ * @endcode
+ *
+ * Obtain the lock for writing.  This succeeds when no task holds the lock.
+ * While the calling task waits, the task that holds the lock for writing
+ * inherits its priority.
+ *
+ * @param xRWLock The lock being obtained.
+ *
+ * @param xTicksToWait The maximum amount of time (specified in 'ticks') to
+ * wait for the lock.  A block time of zero can be used to poll the lock.
+ *
+ * @return pdPASS if the lock was obtained, pdFAIL if xTicksToWait expired.
+ *
+ * \defgroup xRWLockTakeWrite xRWLockTakeWrite
+ * \ingroup RWLock
+ */
+BaseType_t xRWLockTakeWrite( RWLockHandle_t xRWLock,
+                             TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * rwlock.h
+ * @code{c}
+ * BaseType_t xRWLockGiveWrite( RWLockHandle_t xRWLock );
+ * @endcode
+ *
+ * Release the lock after a successful call to xRWLockTakeWrite().  A task that
+ * waits for write access is unblocked first, otherwise all tasks that wait for
+ * read access are unblocked.
+ *
+ * @return pdPASS if the lock was released, pdFAIL if the calling task does not
+ * hold the lock for writing.
+ *
+ * \defgroup xRWLockGiveWrite xRWLockGiveWrite
+ * \ingroup RWLock
+ */
+BaseType_t xRWLockGiveWrite( RWLockHandle_t xRWLock ) PRIVILEGED_FUNCTION;
+
+/**
+ * rwlock.h
+ * @code{c}
+ * UBaseType_t uxRWLockGetReaderCount( RWLockHandle_t xRWLock );
+ * @endcode
+ *
+ * @return The number of tasks that hold the lock for reading.
+ */
+UBaseType_t uxRWLockGetReaderCount( RWLockHandle_t xRWLock ) PRIVILEGED_FUNCTION;
+
+/**
+ * rwlock.h
+ * @code{c}
+ * TaskHandle_t xRWLockGetWriter( RWLockHandle_t xRWLock );
+ * @endcode
+ *
+ * @return The task that holds the lock for writing, or NULL.
+ */
+TaskHandle_t xRWLockGetWriter( RWLockHandle_t xRWLock ) PRIVILEGED_FUNCTION;
+
+/*
+ * Initialise a sequence lock at run time, see also seqLOCK_INITIALISER.
+ */
+void vSeqLockInitialise( SeqLock_t * pxSeqLock ) PRIVILEGED_FUNCTION;
+
+/*
+ * Start a read, returns the value to be passed to xSeqLockReadRetry().  Can
+ * be called from a task or from an interrupt.
+ */
+UBaseType_t uxSeqLockReadBegin( const SeqLock_t * pxSeqLock ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns pdTRUE when the data read since uxSeqLockReadBegin() may be
+ * inconsistent, and must be read again.  An interrupt that runs above
+ * configMAX_SYSCALL_INTERRUPT_PRIORITY may interrupt a writer, it must not
+ * retry in a loop but use the previous copy of the data instead.
+ */
+BaseType_t xSeqLockReadRetry( const SeqLock_t * pxSeqLock,
+                              UBaseType_t uxSequence ) PRIVILEGED_FUNCTION;
+
+/*
+ * Enclose an update of the data.  Writers are serialised by a critical section,
+ * so the update must be short and must not call API functions.
+ */
+void vSeqLockWriteBegin( SeqLock_t * pxSeqLock ) PRIVILEGED_FUNCTION;
+void vSeqLockWriteEnd( SeqLock_t * pxSeqLock ) PRIVILEGED_FUNCTION;
+
+/*
+ * The same for a writer in an interrupt.  The value returned by
+ * uxSeqLockWriteBeginFromISR() must be passed to vSeqLockWriteEndFromISR().
+ */
+UBaseType_t uxSeqLockWriteBeginFromISR( SeqLock_t * pxSeqLock ) PRIVILEGED_FUNCTION;
+void vSeqLockWriteEndFromISR( SeqLock_t * pxSeqLock,
+                              UBaseType_t uxSavedInterruptStatus ) PRIVILEGED_FUNCTION;
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    }
+#endif
+/* *INDENT-ON* */
+
+#endif /* RWLOCK_H */
@@ -1211,4 +1211,150 @@ typedef QueueHandle_t SemaphoreHandle_t;
     #define xSemaphoreGetStaticBuffer( xSemaphore, ppxSemaphoreBuffer )    xQueueGenericGetStaticBuffers( ( QueueHandle_t ) ( xSemaphore ), NULL, ( ppxSemaphoreBuffer ) )
 #endif /* configSUPPORT_STATIC_ALLOCATION */
 
+/**
+ * semphr.h
+ * @code{c}
+ * FastMutexHandle_t xSemaphoreCreateFastMutex( void );
+ * @endcode
+ *
+ * Creates a fast mutex, and returns a handle by which the mutex can be
+ * referenced.  Only available when configUSE_FAST_MUTEXES is set to 1.
+ *
+ * A fast mutex is a recursive mutex with priority inheritance, like the mutex
+ * created by xSemaphoreCreateRecursiveMutex(), but it is not a queue.  When the
+ * mutex is not contended, xSemaphoreTakeFast() and xSemaphoreGiveFast() update
+ * the mutex with a single compare-and-swap, without entering a critical
+ * section.  The kernel is only entered when a task has to wait for the mutex,
+ * or when a waiting task has to be woken.  Define
+ * portCOMPARE_AND_SWAP_POINTER() in portmacro.h to benefit from it, the
+ * generic version uses a short critical section.
+ *
+ * Fast mutexes can not be used from an interrupt, nor with the queue or
+ * semaphore API.
+ *
+ * @return If the mutex was successfully created then a handle to the created
+ * mutex is returned.  If there was not enough heap to allocate the mutex data
+ * structures then NULL is returned.
+ *
+ * Example usage:
+ * @code{c}
+ * FastMutexHandle_t xMutex;
+ *
+ * void vATask( void * pvParameters )
+ * {
+ *  // Create a fast mutex.
+ *  xMutex = xSemaphoreCreateFastMutex();
+ *
+ *  if( xSemaphoreTakeFast( xMutex, pdMS_TO_TICKS( 10 ) ) == pdPASS )
+ *  {
+ *      // Access the shared resource.
+ *
+ *      xSemaphoreGiveFast( xMutex );
+ *  }
+ * }
+ * @endcode
+ * \defgroup xSemaphoreCreateFastMutex xSemaphoreCreateFastMutex
+ * \ingroup Semaphores
+ */
+#if ( ( configUSE_FAST_MUTEXES == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
+    #define xSemaphoreCreateFastMutex()    xQueueCreateFastMutex()
+#endif
+
+/**
+ * semphr.h
+ * @code{c}
+ * FastMutexHandle_t xSemaphoreCreateFastMutexStatic( StaticFastMutex_t *pxMutexBuffer );
+ * @endcode
+ *
+ * Creates a fast mutex in the memory pointed to by pxMutexBuffer, see
+ * xSemaphoreCreateFastMutex().
+ *
+ * @param pxMutexBuffer Must point to a variable of type StaticFastMutex_t,
+ * which will be used to hold the mutex's data structure.
+ *
+ * @return pxMutexBuffer cast to a FastMutexHandle_t, or NULL if pxMutexBuffer
+ * was NULL.
+ * \defgroup xSemaphoreCreateFastMutexStatic xSemaphoreCreateFastMutexStatic
+ * \ingroup Semaphores
+ */
+#if ( ( configUSE_FAST_MUTEXES == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) )
+    #define xSemaphoreCreateFastMutexStatic( pxMutexBuffer )    xQueueCreateFastMutexStatic( ( pxMutexBuffer ) )
+#endif
+
+/**
+ * semphr.h
+ * @code{c}
+ * BaseType_t xSemaphoreTakeFast( FastMutexHandle_t xMutex, TickType_t xTicksToWait );
+ * @endcode
+ *
+ * Obtain a fast mutex.  The task that holds the mutex can take it again, it
+ * must then call xSemaphoreGiveFast() once for every successful call to
+ * xSemaphoreTakeFast() before the mutex becomes available to other tasks.
+ * While a task waits for the mutex, the task that holds it inherits its
+ * priority.
+ *
+ * @param xMutex A handle to the mutex being obtained.
+ *
+ * @param xTicksToWait The time in ticks to wait for the mutex to become
+ * available.  A block time of zero can be used to poll the mutex.
+ *
+ * @return pdPASS if the mutex was obtained.  pdFAIL if xTicksToWait expired
+ * without the mutex becoming available.
+ * \defgroup xSemaphoreTakeFast xSemaphoreTakeFast
+ * \ingroup Semaphores
+ */
+#if ( configUSE_FAST_MUTEXES == 1 )
+    #define xSemaphoreTakeFast( xMutex, xBlockTime )    xQueueFastMutexTake( ( xMutex ), ( xBlockTime ) )
+#endif
+
+/**
+ * semphr.h
+ * @code{c}
+ * BaseType_t xSemaphoreGiveFast( FastMutexHandle_t xMutex );
+ * @endcode
+ *
+ * Release a fast mutex that was obtained with xSemaphoreTakeFast().  Only the
+ * task that holds the mutex can give it.  If other tasks are waiting for the
+ * mutex then the highest priority one is unblocked, and an inherited priority
+ * is given up.
+ *
+ * @param xMutex A handle to the mutex being released.
+ *
+ * @return pdPASS if the mutex was released.  pdFAIL if the calling task does
+ * not hold the mutex.
+ * \defgroup xSemaphoreGiveFast xSemaphoreGiveFast
+ * \ingroup Semaphores
+ */
+#if ( configUSE_FAST_MUTEXES == 1 )
+    #define xSemaphoreGiveFast( xMutex )    xQueueFastMutexGive( ( xMutex ) )
+#endif
+
+/**
+ * semphr.h
+ * @code{c}
+ * TaskHandle_t xSemaphoreGetFastMutexHolder( FastMutexHandle_t xMutex );
+ * @endcode
+ *
+ * Return the task that holds a fast mutex, or NULL if the mutex is available.
+ * The same restrictions apply as for xSemaphoreGetMutexHolder().
+ */
+#if ( configUSE_FAST_MUTEXES == 1 )
+    #define xSemaphoreGetFastMutexHolder( xMutex )    xQueueGetFastMutexHolder( ( xMutex ) )
+#endif
+
+/**
+ * semphr.h
+ * @code{c}
+ * void vSemaphoreDeleteFast( FastMutexHandle_t xMutex );
+ * @endcode
+ *
+ * Delete a fast mutex.  The mutex must not be held, and no task may be
+ * waiting for it.
+ *
+ * @param xMutex A handle to the mutex to be deleted.
+ */
+#if ( configUSE_FAST_MUTEXES == 1 )
+    #define vSemaphoreDeleteFast( xMutex )    vQueueDeleteFastMutex( ( xMutex ) )
+#endif
+
 #endif /* SEMAPHORE_H */
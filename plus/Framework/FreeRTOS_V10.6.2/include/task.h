@@ -2005,6 +2005,23 @@ void vTaskGetRunTimeStats( char * pcWriteBuffer ) PRIVILEGED_FUNCTION; /*lint !e
 configRUN_TIME_COUNTER_TYPE ulTaskGetRunTimeCounter( const TaskHandle_t xTask ) PRIVILEGED_FUNCTION;
 configRUN_TIME_COUNTER_TYPE ulTaskGetRunTimePercent( const TaskHandle_t xTask ) PRIVILEGED_FUNCTION;
 
+/**
+ * task. h
+ * @code{c}
+ * configRUN_TIME_COUNTER_TYPE ulTaskGetCurrentRunTimeCounter( void );
+ * @endcode
+ *
+ * configGENERATE_RUN_TIME_STATS must be defined as 1 for this function to be
+ * available.  Returns the total execution time of the calling task, like
+ * ulTaskGetRunTimeCounter(), but including the time since the task was last
+ * switched in.  The difference between two calls is the time that the task
+ * actually executed in between.
+ *
+ * \defgroup ulTaskGetCurrentRunTimeCounter ulTaskGetCurrentRunTimeCounter
+ * \ingroup TaskUtils
+ */
+configRUN_TIME_COUNTER_TYPE ulTaskGetCurrentRunTimeCounter( void ) PRIVILEGED_FUNCTION;
+
 /**
  * task. h
  * @code{c}
@@ -3191,6 +3208,15 @@ eSleepModeStatus eTaskConfirmSleepModeStatus( void ) PRIVILEGED_FUNCTION;
  */
 TaskHandle_t pvTaskIncrementMutexHeldCount( void ) PRIVILEGED_FUNCTION;
 
+/*
+ * For internal use only.  Decrement the mutex held count of the calling task
+ * when a fast mutex is given, or when taking it failed, and disinherit an
+ * inherited priority when no more mutexes are held.  Returns pdTRUE if a
+ * context switch is required.  Only enters a critical section when the
+ * priority has to be restored.
+ */
+BaseType_t xTaskDecrementMutexHeldCount( void ) PRIVILEGED_FUNCTION;
+
 /*
  * For internal use only.  Same as vTaskSetTimeOutState(), but without a critical
  * section.
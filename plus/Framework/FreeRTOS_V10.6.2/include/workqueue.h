@@ -0,0 +1,271 @@
+/*
+ * FreeRTOS Kernel V10.6.2
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+#ifndef WORK_QUEUE_H
+#define WORK_QUEUE_H
+
+#ifndef INC_FREERTOS_H
+    #error "include FreeRTOS.h" must appear in source files before "include workqueue.h"
+#endif
+
+/* FreeRTOS includes. */
+#include "task.h"
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/**
+ * A work queue runs functions, called work items, in a pool of worker tasks.
+ * Unlike software timer callbacks and functions pended with
+ * xTimerPendFunctionCall(), which all run one after the other in the timer
+ * service task, the items of a work queue run in parallel in its workers: an
+ * item that blocks only delays the other items when all the workers are busy.
+ * Each work queue has its own workers at its own priority, so create one work
+ * queue per priority level that is needed.
+ *
+ * A work item can be submitted to run as soon as possible or after a delay,
+ * from a task or from an interrupt, and cancelled as long as it did not start.
+ * The number of runs, the execution time and the start latency of every item
+ * are recorded.
+ */
+
+/**
+ * workqueue.h
+ *
+ * Types by which work queues and work items are referenced.
+ *
+ * \defgroup WorkQueueHandle_t WorkQueueHandle_t
+ * \ingroup WorkQueue
+ */
+struct WorkQueueDefinition;
+typedef struct WorkQueueDefinition * WorkQueueHandle_t;
+
+struct WorkItemDefinition;
+typedef struct WorkItemDefinition * WorkItemHandle_t;
+
+/*
+ * Defines the prototype to which work item functions must conform.
+ */
+typedef void (* WorkFunction_t)( void * pvParameter );
+
+/*
+ * The statistics of a work item, see vWorkItemGetStats().  Times are in the
+ * units of the run time stats counter when configGENERATE_RUN_TIME_STATS is 1,
+ * and only count the time that the worker actually executed.  Otherwise they
+ * are the elapsed time in ticks, including the time that the item was blocked
+ * or preempted.
+ */
+typedef struct xWORK_ITEM_STATS
+{
+    uint32_t ulRunCount;                     /**< The number of times that the item ran. */
+    configRUN_TIME_COUNTER_TYPE ulTotalTime; /**< The total execution time of the item. */
+    configRUN_TIME_COUNTER_TYPE ulMaxTime;   /**< The longest execution time of the item. */
+    TickType_t xMaxLatency;                  /**< The longest time in ticks between the item being due and it being started. */
+} WorkItemStats_t;
+
+/**
+ * workqueue.h
+ * @code{c}
+ * WorkQueueHandle_t xWorkQueueCreate( const char * pcName,
+ *                                     UBaseType_t uxWorkers,
+ *                                     configSTACK_DEPTH_TYPE uxStackDepth,
+ *                                     UBaseType_t uxPriority );
+ * @endcode
+ *
+ * Create a work queue and its worker tasks.  A work queue can not be deleted.
+ *
+ * @param pcName The name given to the worker tasks.
+ *
+ * @param uxWorkers The number of worker tasks, which is the number of work
+ * items that can run at the same time.
+ *
+ * @param uxStackDepth The stack size of each worker, in words.
+ *
+ * @param uxPriority The priority at which the work items run.
+ *
+ * @return The handle of the work queue, or NULL when the memory for it or its
+ * workers could not be allocated.
+ *
+ * \defgroup xWorkQueueCreate xWorkQueueCreate
+ * \ingroup WorkQueue
+ */
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+    WorkQueueHandle_t xWorkQueueCreate( const char * pcName,
+                                        UBaseType_t uxWorkers,
+                                        configSTACK_DEPTH_TYPE uxStackDepth,
+                                        UBaseType_t uxPriority ) PRIVILEGED_FUNCTION; /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+#endif
+
+/**
+ * workqueue.h
+ * @code{c}
+ * WorkItemHandle_t xWorkItemCreate( WorkFunction_t pxFunction, void * pvParameter );
+ * WorkItemHandle_t xWorkItemCreateStatic( WorkFunction_t pxFunction,
+ *                                         void * pvParameter,
+ *                                         StaticWorkItem_t * pxWorkItemBuffer );
+ * @endcode
+ *
+ * Create a work item that calls pxFunction( pvParameter ) every time that it
+ * runs.  xWorkItemCreateStatic() uses the memory pointed to by
+ * pxWorkItemBuffer.
+ *
+ * @return The handle of the work item, or NULL when it could not be allocated.
+ *
+ * \defgroup xWorkItemCreate xWorkItemCreate
+ * \ingroup WorkQueue
+ */
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+    WorkItemHandle_t xWorkItemCreate( WorkFunction_t pxFunction,
+                                      void * pvParameter ) PRIVILEGED_FUNCTION;
+#endif
+
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+    WorkItemHandle_t xWorkItemCreateStatic( WorkFunction_t pxFunction,
+                                            void * pvParameter,
+                                            StaticWorkItem_t * pxWorkItemBuffer ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * workqueue.h
+ * @code{c}
+ * void vWorkItemDelete( WorkItemHandle_t xWorkItem );
+ * @endcode
+ *
+ * Delete a work item.  The item must neither be submitted nor running, so it
+ * can not delete itself.
+ *
+ * \defgroup vWorkItemDelete vWorkItemDelete
+ * \ingroup WorkQueue
+ */
+void vWorkItemDelete( WorkItemHandle_t xWorkItem ) PRIVILEGED_FUNCTION;
+
+/**
+ * workqueue.h
+ * @code{c}
+ * BaseType_t xWorkQueueSubmit( WorkQueueHandle_t xWorkQueue,
+ *                              WorkItemHandle_t xWorkItem,
+ *                              TickType_t xDelay );
+ * @endcode
+ *
+ * Submit a work item to a work queue.  The item runs once, as soon as a worker
+ * is available after xDelay ticks.  The function never blocks.  A running item
+ * can be submitted again, also by itself, it may then run in two workers at
+ * the same time.
+ *
+ * @param xWorkQueue The work queue in which the item will run.
+ *
+ * @param xWorkItem The work item.
+ *
+ * @param xDelay The number of ticks before the item becomes due, or zero.
+ *
+ * @return pdPASS if the item was submitted, pdFAIL if it was already
+ * submitted and did not start yet.
+ *
+ * \defgroup xWorkQueueSubmit xWorkQueueSubmit
+ * \ingroup WorkQueue
+ */
+BaseType_t xWorkQueueSubmit( WorkQueueHandle_t xWorkQueue,
+                             WorkItemHandle_t xWorkItem,
+                             TickType_t xDelay ) PRIVILEGED_FUNCTION;
+
+/**
+ * workqueue.h
+ * @code{c}
+ * BaseType_t xWorkQueueSubmitFromISR( WorkQueueHandle_t xWorkQueue,
+ *                                     WorkItemHandle_t xWorkItem,
+ *                                     TickType_t xDelay,
+ *                                     BaseType_t * pxHigherPriorityTaskWoken );
+ * @endcode
+ *
+ * A version of xWorkQueueSubmit() that can be called from an interrupt.
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE when a worker with a priority
+ * above the interrupted task was unblocked, in which case a context switch
+ * should be requested before the interrupt exits.
+ *
+ * \defgroup xWorkQueueSubmitFromISR xWorkQueueSubmitFromISR
+ * \ingroup WorkQueue
+ */
+BaseType_t xWorkQueueSubmitFromISR( WorkQueueHandle_t xWorkQueue,
+                                    WorkItemHandle_t xWorkItem,
+                                    TickType_t xDelay,
+                                    BaseType_t * pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * workqueue.h
+ * @code{c}
+ * BaseType_t xWorkItemCancel( WorkItemHandle_t xWorkItem );
+ * @endcode
+ *
+ * Withdraw a submitted work item that did not start yet.
+ *
+ * @return pdTRUE if the item was withdrawn, pdFALSE if it was not submitted.
+ * Use xWorkItemIsBusy() to find out whether the item is still running.
+ *
+ * \defgroup xWorkItemCancel xWorkItemCancel
+ * \ingroup WorkQueue
+ */
+BaseType_t xWorkItemCancel( WorkItemHandle_t xWorkItem ) PRIVILEGED_FUNCTION;
+
+/**
+ * workqueue.h
+ * @code{c}
+ * BaseType_t xWorkItemIsBusy( WorkItemHandle_t xWorkItem );
+ * @endcode
+ *
+ * @return pdTRUE if the work item is submitted or running, otherwise pdFALSE.
+ *
+ * \defgroup xWorkItemIsBusy xWorkItemIsBusy
+ * \ingroup WorkQueue
+ */
+BaseType_t xWorkItemIsBusy( WorkItemHandle_t xWorkItem ) PRIVILEGED_FUNCTION;
+
+/**
+ * workqueue.h
+ * @code{c}
+ * void vWorkItemGetStats( WorkItemHandle_t xWorkItem, WorkItemStats_t * pxStats );
+ * @endcode
+ *
+ * Obtain the statistics of a work item, see WorkItemStats_t.
+ *
+ * \defgroup vWorkItemGetStats vWorkItemGetStats
+ * \ingroup WorkQueue
+ */
+void vWorkItemGetStats( WorkItemHandle_t xWorkItem,
+                        WorkItemStats_t * pxStats ) PRIVILEGED_FUNCTION;
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    }
+#endif
+/* *INDENT-ON* */
+
+#endif /* WORK_QUEUE_H */
@@ -243,6 +243,41 @@
     }
 /*-----------------------------------------------------------*/
 
+/* Used by the fast mutexes, see queue.c.  The exclusive monitor is cleared
+ * on exception entry and return, so an interrupt or a context switch between
+ * ldrex and strex makes the strex fail and the sequence is retried. */
+    portFORCE_INLINE static BaseType_t xPortCompareAndSwapPointer( void * volatile * ppvDestination,
+                                                                   void * pvExchange,
+                                                                   void * pvComparand )
+    {
+        void * pvCurrent;
+        uint32_t ulFailed;
+        BaseType_t xReturn = pdFALSE;
+
+        do
+        {
+            __asm volatile ( "ldrex %0, [%1]" : "=r" ( pvCurrent ) : "r" ( ppvDestination ) : "memory" );
+
+            if( pvCurrent != pvComparand )
+            {
+                __asm volatile ( "clrex" ::: "memory" );
+                break;
+            }
+
+            __asm volatile ( "strex %0, %2, [%1]" : "=&r" ( ulFailed ) : "r" ( ppvDestination ), "r" ( pvExchange ) : "memory" );
+
+            if( ulFailed == 0UL )
+            {
+                xReturn = pdTRUE;
+            }
+        } while( xReturn == pdFALSE );
+
+        return xReturn;
+    }
+
+    #define portCOMPARE_AND_SWAP_POINTER( ppvDestination, pvExchange, pvComparand )    xPortCompareAndSwapPointer( ( ppvDestination ), ( pvExchange ), ( pvComparand ) )
+/*-----------------------------------------------------------*/
+
     #define portMEMORY_BARRIER()    __asm volatile ( "" ::: "memory" )
 
 /* *INDENT-OFF* */
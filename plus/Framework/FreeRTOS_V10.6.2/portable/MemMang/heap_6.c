@@ -0,0 +1,744 @@
+/*
+ * FreeRTOS Kernel V10.6.2
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * A sample implementation of pvPortMalloc() that, like heap_5.c, allows the
+ * heap to be defined across multiple non-contiguous blocks, and that combines
+ * (coalescences) adjacent memory blocks as they are freed.  In addition, each
+ * region has attributes, such as portHEAP_ATTR_FAST, portHEAP_ATTR_DMA or
+ * portHEAP_ATTR_BULK.  pvPortMallocTagged() lets the caller choose the kind of
+ * memory in which an object will be placed.  Each region has its own list of
+ * free blocks and its own statistics.
+ *
+ * See heap_1.c, heap_2.c, heap_3.c, heap_4.c and heap_5.c for alternative
+ * implementations, and the memory management pages of https://www.FreeRTOS.org
+ * for more information.
+ *
+ * Usage notes:
+ *
+ * vPortDefineTaggedHeapRegions() ***must*** be called before pvPortMalloc().
+ * The array is terminated using a NULL zero sized region definition, and the
+ * regions ***must*** appear in address order from low address to high
+ * address.  For example, on an STM32H7:
+ *
+ * HeapTaggedRegion_t xHeapRegions[] =
+ * {
+ *  { ( uint8_t * ) 0x20000000UL, 0x10000, portHEAP_ATTR_FAST },  << DTCM, not reachable by the Ethernet DMA.
+ *  { ( uint8_t * ) 0x24000000UL, 0x80000, portHEAP_ATTR_DMA },   << AXI SRAM.
+ *  { ( uint8_t * ) 0xC0000000UL, 0x800000, portHEAP_ATTR_BULK }, << External SDRAM.
+ *  { NULL, 0, 0 }                                                << Terminates the array.
+ * };
+ *
+ * vPortDefineTaggedHeapRegions( xHeapRegions );
+ *
+ * pvPortMallocTagged( xSize, portHEAP_ATTR_DMA, 0 ) only returns memory from
+ * the AXI SRAM, while pvPortMallocTagged( xSize, 0, portHEAP_ATTR_FAST )
+ * tries the DTCM first, and then the other regions in the order of the array.
+ * vPortDefineHeapRegions() is also available: its regions get no attributes.
+ */
+#include <stdlib.h>
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+ * all the API functions to use the MPU wrappers.  That should only be done when
+ * task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
+    #error This file must not be used if configSUPPORT_DYNAMIC_ALLOCATION is 0
+#endif
+
+#ifndef configHEAP_CLEAR_MEMORY_ON_FREE
+    #define configHEAP_CLEAR_MEMORY_ON_FREE    0
+#endif
+
+/* The maximum number of regions that can be passed to
+ * vPortDefineTaggedHeapRegions(). */
+#ifndef configHEAP_MAX_TAGGED_REGIONS
+    #define configHEAP_MAX_TAGGED_REGIONS    8
+#endif
+
+/* Block sizes must not get too small. */
+#define heapMINIMUM_BLOCK_SIZE    ( ( size_t ) ( xHeapStructSize << 1 ) )
+
+/* Assumes 8bit bytes! */
+#define heapBITS_PER_BYTE         ( ( size_t ) 8 )
+
+/* Max value that fits in a size_t type. */
+#define heapSIZE_MAX              ( ~( ( size_t ) 0 ) )
+
+/* Check if multiplying a and b will result in overflow. */
+#define heapMULTIPLY_WILL_OVERFLOW( a, b )    ( ( ( a ) > 0 ) && ( ( b ) > ( heapSIZE_MAX / ( a ) ) ) )
+
+/* Check if adding a and b will result in overflow. */
+#define heapADD_WILL_OVERFLOW( a, b )         ( ( a ) > ( heapSIZE_MAX - ( b ) ) )
+
+/* MSB of the xBlockSize member of an BlockLink_t structure is used to track
+ * the allocation status of a block.  When MSB of the xBlockSize member of
+ * an BlockLink_t structure is set then the block belongs to the application.
+ * When the bit is free the block is still part of the free heap space. */
+#define heapBLOCK_ALLOCATED_BITMASK    ( ( ( size_t ) 1 ) << ( ( sizeof( size_t ) * heapBITS_PER_BYTE ) - 1 ) )
+#define heapBLOCK_SIZE_IS_VALID( xBlockSize )    ( ( ( xBlockSize ) & heapBLOCK_ALLOCATED_BITMASK ) == 0 )
+#define heapBLOCK_IS_ALLOCATED( pxBlock )        ( ( ( pxBlock->xBlockSize ) & heapBLOCK_ALLOCATED_BITMASK ) != 0 )
+#define heapALLOCATE_BLOCK( pxBlock )            ( ( pxBlock->xBlockSize ) |= heapBLOCK_ALLOCATED_BITMASK )
+#define heapFREE_BLOCK( pxBlock )                ( ( pxBlock->xBlockSize ) &= ~heapBLOCK_ALLOCATED_BITMASK )
+
+/* Check if a region has all attributes in 'ulMask'. */
+#define heapREGION_HAS( pxRegion, ulMask )    ( ( ( pxRegion )->ulAttributes & ( ulMask ) ) == ( ulMask ) )
+
+/*-----------------------------------------------------------*/
+
+/* Define the linked list structure.  This is used to link free blocks in order
+ * of their memory address. */
+typedef struct A_BLOCK_LINK
+{
+    struct A_BLOCK_LINK * pxNextFreeBlock; /*<< The next free block in the list. */
+    size_t xBlockSize;                     /*<< The size of the free block. */
+} BlockLink_t;
+
+/* The administration of a single region. */
+typedef struct A_HEAP_REGION
+{
+    BlockLink_t xStart;                           /*<< Marks the start of the list of free blocks. */
+    BlockLink_t * pxEnd;                          /*<< Marks the end of the list, it is located at the end of the region. */
+    uint8_t * pucFirstAddress;                    /*<< The first usable address, used to find the region of a block. */
+    uint32_t ulAttributes;                        /*<< A combination of the portHEAP_ATTR_ bits. */
+    size_t xFreeBytesRemaining;                   /*<< The sum of all free blocks in this region. */
+    size_t xMinimumEverFreeBytesRemaining;        /*<< The lowest value of xFreeBytesRemaining. */
+    size_t xNumberOfSuccessfulAllocations;        /*<< The number of blocks allocated from this region. */
+    size_t xNumberOfSuccessfulFrees;              /*<< The number of blocks returned to this region. */
+} HeapRegionControl_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Inserts a block of memory that is being freed into the correct position in
+ * the list of free memory blocks of a region.  The block being freed will be
+ * merged with the block in front it and/or the block behind it if the memory
+ * blocks are adjacent to each other.
+ */
+static void prvInsertBlockIntoFreeList( HeapRegionControl_t * pxRegion,
+                                        BlockLink_t * pxBlockToInsert );
+
+/*
+ * Take a block of 'xWantedSize' bytes from a region.  The size already
+ * includes the BlockLink_t structure and the alignment.
+ */
+static void * prvAllocateFromRegion( HeapRegionControl_t * pxRegion,
+                                     size_t xWantedSize );
+
+/*
+ * Add a region to the heap.  Called by vPortDefineTaggedHeapRegions() and
+ * vPortDefineHeapRegions().
+ */
+static void prvAddRegion( uint8_t * pucStartAddress,
+                          size_t xSizeInBytes,
+                          uint32_t ulAttributes );
+
+/*-----------------------------------------------------------*/
+
+/* The size of the structure placed at the beginning of each allocated memory
+ * block must by correctly byte aligned. */
+static const size_t xHeapStructSize = ( sizeof( BlockLink_t ) + ( ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+/* The regions, in address order. */
+static HeapRegionControl_t xRegions[ configHEAP_MAX_TAGGED_REGIONS ];
+static BaseType_t xRegionCount = 0;
+
+/* The number of free bytes remaining in all regions together. */
+static size_t xFreeBytesRemaining = 0U;
+static size_t xMinimumEverFreeBytesRemaining = 0U;
+
+/*-----------------------------------------------------------*/
+
+void * pvPortMallocTagged( size_t xWantedSize,
+                           uint32_t ulRequiredAttributes,
+                           uint32_t ulPreferredAttributes )
+{
+    void * pvReturn = NULL;
+    size_t xAdditionalRequiredSize;
+    uint32_t ulMask = ulRequiredAttributes | ulPreferredAttributes;
+    BaseType_t xIndex;
+
+    /* The heap must be initialised before the first call to
+     * prvPortMalloc(). */
+    configASSERT( xRegionCount != 0 );
+
+    vTaskSuspendAll();
+    {
+        if( xWantedSize > 0 )
+        {
+            /* The wanted size must be increased so it can contain a BlockLink_t
+             * structure in addition to the requested amount of bytes. */
+            if( heapADD_WILL_OVERFLOW( xWantedSize, xHeapStructSize ) == 0 )
+            {
+                xWantedSize += xHeapStructSize;
+
+                /* Ensure that blocks are always aligned to the required number
+                 * of bytes. */
+                if( ( xWantedSize & portBYTE_ALIGNMENT_MASK ) != 0x00 )
+                {
+                    /* Byte alignment required. */
+                    xAdditionalRequiredSize = portBYTE_ALIGNMENT - ( xWantedSize & portBYTE_ALIGNMENT_MASK );
+
+                    if( heapADD_WILL_OVERFLOW( xWantedSize, xAdditionalRequiredSize ) == 0 )
+                    {
+                        xWantedSize += xAdditionalRequiredSize;
+                    }
+                    else
+                    {
+                        xWantedSize = 0;
+                    }
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                xWantedSize = 0;
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        /* Check the block size we are trying to allocate is not so large that the
+         * top bit is set.  The top bit of the block size member of the BlockLink_t
+         * structure is used to determine who owns the block - the application or
+         * the kernel, so it must be free. */
+        if( ( heapBLOCK_SIZE_IS_VALID( xWantedSize ) != 0 ) && ( xWantedSize > 0 ) )
+        {
+            /* First try the regions that have all the preferred attributes. */
+            for( xIndex = 0; ( xIndex < xRegionCount ) && ( pvReturn == NULL ); xIndex++ )
+            {
+                if( heapREGION_HAS( &( xRegions[ xIndex ] ), ulMask ) )
+                {
+                    pvReturn = prvAllocateFromRegion( &( xRegions[ xIndex ] ), xWantedSize );
+                }
+            }
+
+            /* Then fall back to the regions that only have the required
+             * attributes. */
+            for( xIndex = 0; ( xIndex < xRegionCount ) && ( pvReturn == NULL ) && ( ulMask != ulRequiredAttributes ); xIndex++ )
+            {
+                if( heapREGION_HAS( &( xRegions[ xIndex ] ), ulRequiredAttributes ) &&
+                    !heapREGION_HAS( &( xRegions[ xIndex ] ), ulMask ) )
+                {
+                    pvReturn = prvAllocateFromRegion( &( xRegions[ xIndex ] ), xWantedSize );
+                }
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        traceMALLOC( pvReturn, xWantedSize );
+    }
+    ( void ) xTaskResumeAll();
+
+    #if ( configUSE_MALLOC_FAILED_HOOK == 1 )
+    {
+        if( pvReturn == NULL )
+        {
+            vApplicationMallocFailedHook();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    #endif /* if ( configUSE_MALLOC_FAILED_HOOK == 1 ) */
+
+    return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void * pvPortMalloc( size_t xWantedSize )
+{
+    return pvPortMallocTagged( xWantedSize, 0U, 0U );
+}
+/*-----------------------------------------------------------*/
+
+static void * prvAllocateFromRegion( HeapRegionControl_t * pxRegion,
+                                     size_t xWantedSize )
+{
+    BlockLink_t * pxBlock;
+    BlockLink_t * pxPreviousBlock;
+    BlockLink_t * pxNewBlockLink;
+    void * pvReturn = NULL;
+
+    if( xWantedSize <= pxRegion->xFreeBytesRemaining )
+    {
+        /* Traverse the list from the start (lowest address) block until
+         * one of adequate size is found. */
+        pxPreviousBlock = &( pxRegion->xStart );
+        pxBlock = pxRegion->xStart.pxNextFreeBlock;
+
+        while( ( pxBlock->xBlockSize < xWantedSize ) && ( pxBlock->pxNextFreeBlock != NULL ) )
+        {
+            pxPreviousBlock = pxBlock;
+            pxBlock = pxBlock->pxNextFreeBlock;
+        }
+
+        /* If the end marker was reached then a block of adequate size
+         * was not found. */
+        if( pxBlock != pxRegion->pxEnd )
+        {
+            /* Return the memory space pointed to - jumping over the
+             * BlockLink_t structure at its start. */
+            pvReturn = ( void * ) ( ( ( uint8_t * ) pxPreviousBlock->pxNextFreeBlock ) + xHeapStructSize );
+
+            /* This block is being returned for use so must be taken out
+             * of the list of free blocks. */
+            pxPreviousBlock->pxNextFreeBlock = pxBlock->pxNextFreeBlock;
+
+            /* If the block is larger than required it can be split into
+             * two. */
+            if( ( pxBlock->xBlockSize - xWantedSize ) > heapMINIMUM_BLOCK_SIZE )
+            {
+                /* This block is to be split into two.  Create a new
+                 * block following the number of bytes requested. The void
+                 * cast is used to prevent byte alignment warnings from the
+                 * compiler. */
+                pxNewBlockLink = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xWantedSize );
+
+                /* Calculate the sizes of two blocks split from the
+                 * single block. */
+                pxNewBlockLink->xBlockSize = pxBlock->xBlockSize - xWantedSize;
+                pxBlock->xBlockSize = xWantedSize;
+
+                /* Insert the new block into the list of free blocks. */
+                prvInsertBlockIntoFreeList( pxRegion, pxNewBlockLink );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            pxRegion->xFreeBytesRemaining -= pxBlock->xBlockSize;
+            xFreeBytesRemaining -= pxBlock->xBlockSize;
+
+            if( pxRegion->xFreeBytesRemaining < pxRegion->xMinimumEverFreeBytesRemaining )
+            {
+                pxRegion->xMinimumEverFreeBytesRemaining = pxRegion->xFreeBytesRemaining;
+            }
+
+            if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
+            {
+                xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            /* The block is being returned - it is allocated and owned
+             * by the application and has no "next" block. */
+            heapALLOCATE_BLOCK( pxBlock );
+            pxBlock->pxNextFreeBlock = NULL;
+            pxRegion->xNumberOfSuccessfulAllocations++;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vPortFree( void * pv )
+{
+    uint8_t * puc = ( uint8_t * ) pv;
+    BlockLink_t * pxLink;
+    HeapRegionControl_t * pxRegion = NULL;
+    BaseType_t xIndex;
+
+    if( pv != NULL )
+    {
+        /* The memory being freed will have an BlockLink_t structure immediately
+         * before it. */
+        puc -= xHeapStructSize;
+
+        /* This casting is to keep the compiler from issuing warnings. */
+        pxLink = ( void * ) puc;
+
+        configASSERT( heapBLOCK_IS_ALLOCATED( pxLink ) != 0 );
+        configASSERT( pxLink->pxNextFreeBlock == NULL );
+
+        /* Find the region that contains the block. */
+        for( xIndex = 0; xIndex < xRegionCount; xIndex++ )
+        {
+            if( ( puc >= xRegions[ xIndex ].pucFirstAddress ) &&
+                ( puc < ( uint8_t * ) xRegions[ xIndex ].pxEnd ) )
+            {
+                pxRegion = &( xRegions[ xIndex ] );
+                break;
+            }
+        }
+
+        configASSERT( pxRegion != NULL );
+
+        if( ( heapBLOCK_IS_ALLOCATED( pxLink ) != 0 ) && ( pxRegion != NULL ) )
+        {
+            if( pxLink->pxNextFreeBlock == NULL )
+            {
+                /* The block is being returned to the heap - it is no longer
+                 * allocated. */
+                heapFREE_BLOCK( pxLink );
+                #if ( configHEAP_CLEAR_MEMORY_ON_FREE == 1 )
+                {
+                    ( void ) memset( puc + xHeapStructSize, 0, pxLink->xBlockSize - xHeapStructSize );
+                }
+                #endif
+
+                vTaskSuspendAll();
+                {
+                    /* Add this block to the list of free blocks. */
+                    pxRegion->xFreeBytesRemaining += pxLink->xBlockSize;
+                    xFreeBytesRemaining += pxLink->xBlockSize;
+                    traceFREE( pv, pxLink->xBlockSize );
+                    prvInsertBlockIntoFreeList( pxRegion, ( ( BlockLink_t * ) pxLink ) );
+                    pxRegion->xNumberOfSuccessfulFrees++;
+                }
+                ( void ) xTaskResumeAll();
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetFreeHeapSize( void )
+{
+    return xFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetMinimumEverFreeHeapSize( void )
+{
+    return xMinimumEverFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+void * pvPortCalloc( size_t xNum,
+                     size_t xSize )
+{
+    void * pv = NULL;
+
+    if( heapMULTIPLY_WILL_OVERFLOW( xNum, xSize ) == 0 )
+    {
+        pv = pvPortMalloc( xNum * xSize );
+
+        if( pv != NULL )
+        {
+            ( void ) memset( pv, 0, xNum * xSize );
+        }
+    }
+
+    return pv;
+}
+/*-----------------------------------------------------------*/
+
+static void prvInsertBlockIntoFreeList( HeapRegionControl_t * pxRegion,
+                                        BlockLink_t * pxBlockToInsert )
+{
+    BlockLink_t * pxIterator;
+    uint8_t * puc;
+
+    /* Iterate through the list until a block is found that has a higher address
+     * than the block being inserted. */
+    for( pxIterator = &( pxRegion->xStart ); pxIterator->pxNextFreeBlock < pxBlockToInsert; pxIterator = pxIterator->pxNextFreeBlock )
+    {
+        /* Nothing to do here, just iterate to the right position. */
+    }
+
+    /* Do the block being inserted, and the block it is being inserted after
+     * make a contiguous block of memory? */
+    puc = ( uint8_t * ) pxIterator;
+
+    if( ( puc + pxIterator->xBlockSize ) == ( uint8_t * ) pxBlockToInsert )
+    {
+        pxIterator->xBlockSize += pxBlockToInsert->xBlockSize;
+        pxBlockToInsert = pxIterator;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    /* Do the block being inserted, and the block it is being inserted before
+     * make a contiguous block of memory? */
+    puc = ( uint8_t * ) pxBlockToInsert;
+
+    if( ( puc + pxBlockToInsert->xBlockSize ) == ( uint8_t * ) pxIterator->pxNextFreeBlock )
+    {
+        if( pxIterator->pxNextFreeBlock != pxRegion->pxEnd )
+        {
+            /* Form one big block from the two blocks. */
+            pxBlockToInsert->xBlockSize += pxIterator->pxNextFreeBlock->xBlockSize;
+            pxBlockToInsert->pxNextFreeBlock = pxIterator->pxNextFreeBlock->pxNextFreeBlock;
+        }
+        else
+        {
+            pxBlockToInsert->pxNextFreeBlock = pxRegion->pxEnd;
+        }
+    }
+    else
+    {
+        pxBlockToInsert->pxNextFreeBlock = pxIterator->pxNextFreeBlock;
+    }
+
+    /* If the block being inserted plugged a gab, so was merged with the block
+     * before and the block after, then it's pxNextFreeBlock pointer will have
+     * already been set, and should not be set here as that would make it point
+     * to itself. */
+    if( pxIterator != pxBlockToInsert )
+    {
+        pxIterator->pxNextFreeBlock = pxBlockToInsert;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvAddRegion( uint8_t * pucStartAddress,
+                          size_t xSizeInBytes,
+                          uint32_t ulAttributes )
+{
+    HeapRegionControl_t * pxRegion;
+    BlockLink_t * pxFirstFreeBlockInRegion;
+    portPOINTER_SIZE_TYPE xAlignedHeap;
+    portPOINTER_SIZE_TYPE xAddress;
+    size_t xTotalRegionSize = xSizeInBytes;
+
+    configASSERT( xRegionCount < configHEAP_MAX_TAGGED_REGIONS );
+
+    /* Ensure the heap region starts on a correctly aligned boundary. */
+    xAddress = ( portPOINTER_SIZE_TYPE ) pucStartAddress;
+
+    if( ( xAddress & portBYTE_ALIGNMENT_MASK ) != 0 )
+    {
+        xAddress += ( portBYTE_ALIGNMENT - 1 );
+        xAddress &= ~portBYTE_ALIGNMENT_MASK;
+
+        /* Adjust the size for the bytes lost to alignment. */
+        xTotalRegionSize -= ( size_t ) ( xAddress - ( portPOINTER_SIZE_TYPE ) pucStartAddress );
+    }
+
+    xAlignedHeap = xAddress;
+
+    if( xRegionCount > 0 )
+    {
+        /* Check blocks are passed in with increasing start addresses. */
+        configASSERT( xAddress > ( portPOINTER_SIZE_TYPE ) xRegions[ xRegionCount - 1 ].pxEnd );
+    }
+
+    pxRegion = &( xRegions[ xRegionCount ] );
+    pxRegion->ulAttributes = ulAttributes;
+    pxRegion->pucFirstAddress = ( uint8_t * ) xAlignedHeap;
+
+    /* xStart is used to hold a pointer to the first item in the list of
+     * free blocks.  The void cast is used to prevent compiler warnings. */
+    pxRegion->xStart.pxNextFreeBlock = ( BlockLink_t * ) xAlignedHeap;
+    pxRegion->xStart.xBlockSize = ( size_t ) 0;
+
+    /* pxEnd is used to mark the end of the list of free blocks and is
+     * inserted at the end of the region space. */
+    xAddress = xAlignedHeap + xTotalRegionSize;
+    xAddress -= xHeapStructSize;
+    xAddress &= ~( ( portPOINTER_SIZE_TYPE ) portBYTE_ALIGNMENT_MASK );
+    pxRegion->pxEnd = ( BlockLink_t * ) xAddress;
+    pxRegion->pxEnd->xBlockSize = 0;
+    pxRegion->pxEnd->pxNextFreeBlock = NULL;
+
+    /* To start with there is a single free block in this region that is
+     * sized to take up the entire heap region minus the space taken by the
+     * free block structure. */
+    pxFirstFreeBlockInRegion = ( BlockLink_t * ) xAlignedHeap;
+    pxFirstFreeBlockInRegion->xBlockSize = ( size_t ) ( xAddress - ( portPOINTER_SIZE_TYPE ) pxFirstFreeBlockInRegion );
+    pxFirstFreeBlockInRegion->pxNextFreeBlock = pxRegion->pxEnd;
+
+    pxRegion->xFreeBytesRemaining = pxFirstFreeBlockInRegion->xBlockSize;
+    pxRegion->xMinimumEverFreeBytesRemaining = pxFirstFreeBlockInRegion->xBlockSize;
+    pxRegion->xNumberOfSuccessfulAllocations = 0U;
+    pxRegion->xNumberOfSuccessfulFrees = 0U;
+
+    xFreeBytesRemaining += pxFirstFreeBlockInRegion->xBlockSize;
+    xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+    xRegionCount++;
+}
+/*-----------------------------------------------------------*/
+
+void vPortDefineTaggedHeapRegions( const HeapTaggedRegion_t * const pxHeapRegions )
+{
+    const HeapTaggedRegion_t * pxHeapRegion;
+
+    /* Can only call once! */
+    configASSERT( xRegionCount == 0 );
+
+    for( pxHeapRegion = pxHeapRegions; pxHeapRegion->xSizeInBytes > 0; pxHeapRegion++ )
+    {
+        prvAddRegion( pxHeapRegion->pucStartAddress, pxHeapRegion->xSizeInBytes, pxHeapRegion->ulAttributes );
+    }
+
+    /* Check something was actually defined before it is accessed. */
+    configASSERT( xFreeBytesRemaining );
+}
+/*-----------------------------------------------------------*/
+
+void vPortDefineHeapRegions( const HeapRegion_t * const pxHeapRegions )
+{
+    const HeapRegion_t * pxHeapRegion;
+
+    /* Can only call once! */
+    configASSERT( xRegionCount == 0 );
+
+    for( pxHeapRegion = pxHeapRegions; pxHeapRegion->xSizeInBytes > 0; pxHeapRegion++ )
+    {
+        prvAddRegion( pxHeapRegion->pucStartAddress, pxHeapRegion->xSizeInBytes, 0U );
+    }
+
+    /* Check something was actually defined before it is accessed. */
+    configASSERT( xFreeBytesRemaining );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xPortGetTaggedHeapStats( BaseType_t xRegionIndex,
+                                    uint32_t * pulAttributes,
+                                    HeapStats_t * pxHeapStats )
+{
+    HeapRegionControl_t * pxRegion;
+    BlockLink_t * pxBlock;
+    size_t xBlocks = 0, xMaxSize = 0, xMinSize = portMAX_DELAY; /* portMAX_DELAY used as a portable way of getting the maximum value. */
+    BaseType_t xReturn = pdFAIL;
+
+    if( ( xRegionIndex >= 0 ) && ( xRegionIndex < xRegionCount ) )
+    {
+        pxRegion = &( xRegions[ xRegionIndex ] );
+
+        vTaskSuspendAll();
+        {
+            for( pxBlock = pxRegion->xStart.pxNextFreeBlock; pxBlock != pxRegion->pxEnd; pxBlock = pxBlock->pxNextFreeBlock )
+            {
+                /* Increment the number of blocks and record the largest and the
+                 * smallest block seen so far. */
+                xBlocks++;
+
+                if( pxBlock->xBlockSize > xMaxSize )
+                {
+                    xMaxSize = pxBlock->xBlockSize;
+                }
+
+                if( pxBlock->xBlockSize < xMinSize )
+                {
+                    xMinSize = pxBlock->xBlockSize;
+                }
+            }
+
+            *pulAttributes = pxRegion->ulAttributes;
+            pxHeapStats->xSizeOfLargestFreeBlockInBytes = xMaxSize;
+            pxHeapStats->xSizeOfSmallestFreeBlockInBytes = xMinSize;
+            pxHeapStats->xNumberOfFreeBlocks = xBlocks;
+            pxHeapStats->xAvailableHeapSpaceInBytes = pxRegion->xFreeBytesRemaining;
+            pxHeapStats->xNumberOfSuccessfulAllocations = pxRegion->xNumberOfSuccessfulAllocations;
+            pxHeapStats->xNumberOfSuccessfulFrees = pxRegion->xNumberOfSuccessfulFrees;
+            pxHeapStats->xMinimumEverFreeBytesRemaining = pxRegion->xMinimumEverFreeBytesRemaining;
+        }
+        ( void ) xTaskResumeAll();
+
+        xReturn = pdPASS;
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vPortGetHeapStats( HeapStats_t * pxHeapStats )
+{
+    HeapStats_t xRegionStats;
+    uint32_t ulAttributes;
+    BaseType_t xIndex;
+    size_t xMaxSize = 0, xMinSize = portMAX_DELAY, xBlocks = 0;
+    size_t xAllocations = 0, xFrees = 0;
+
+    /* Combine the statistics of all regions. */
+    for( xIndex = 0; xPortGetTaggedHeapStats( xIndex, &ulAttributes, &xRegionStats ) != pdFAIL; xIndex++ )
+    {
+        xBlocks += xRegionStats.xNumberOfFreeBlocks;
+        xAllocations += xRegionStats.xNumberOfSuccessfulAllocations;
+        xFrees += xRegionStats.xNumberOfSuccessfulFrees;
+
+        if( xRegionStats.xSizeOfLargestFreeBlockInBytes > xMaxSize )
+        {
+            xMaxSize = xRegionStats.xSizeOfLargestFreeBlockInBytes;
+        }
+
+        if( xRegionStats.xSizeOfSmallestFreeBlockInBytes < xMinSize )
+        {
+            xMinSize = xRegionStats.xSizeOfSmallestFreeBlockInBytes;
+        }
+    }
+
+    pxHeapStats->xSizeOfLargestFreeBlockInBytes = xMaxSize;
+    pxHeapStats->xSizeOfSmallestFreeBlockInBytes = xMinSize;
+    pxHeapStats->xNumberOfFreeBlocks = xBlocks;
+
+    taskENTER_CRITICAL();
+    {
+        pxHeapStats->xAvailableHeapSpaceInBytes = xFreeBytesRemaining;
+        pxHeapStats->xNumberOfSuccessfulAllocations = xAllocations;
+        pxHeapStats->xNumberOfSuccessfulFrees = xFrees;
+        pxHeapStats->xMinimumEverFreeBytesRemaining = xMinimumEverFreeBytesRemaining;
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
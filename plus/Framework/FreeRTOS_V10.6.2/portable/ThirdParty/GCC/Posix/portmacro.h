@@ -126,6 +126,10 @@ extern void vPortCancelThread( void *pxTaskToDelete );
  */
 #define portMEMORY_BARRIER() __asm volatile( "" ::: "memory" )
 
+/* Used by the fast mutexes, see queue.c. */
+#define portCOMPARE_AND_SWAP_POINTER( ppvDestination, pvExchange, pvComparand ) \
+    ( __extension__ ( { void * pvExpected = ( pvComparand ); __atomic_compare_exchange_n( ( ppvDestination ), &pvExpected, ( pvExchange ), 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED ) ? pdTRUE : pdFALSE; } ) )
+
 extern unsigned long ulPortGetRunTime( void );
 #define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS() /* no-op */
 #define portGET_RUN_TIME_COUNTER_VALUE()         ulPortGetRunTime()
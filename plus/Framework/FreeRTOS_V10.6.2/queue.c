@@ -42,6 +42,17 @@
     #include "croutine.h"
 #endif
 
+/* Used by the fast mutexes.  Atomically replace *ppvDestination with
+ * pvExchange if it is equal to pvComparand, and return pdTRUE if it was
+ * replaced.  Ports that have an exclusive load/store or compare-and-swap
+ * instruction define it in portmacro.h, the generic version from atomic.h uses
+ * a critical section. */
+#if ( ( configUSE_FAST_MUTEXES == 1 ) && !defined( portCOMPARE_AND_SWAP_POINTER ) )
+    #include "atomic.h"
+    #define portCOMPARE_AND_SWAP_POINTER( ppvDestination, pvExchange, pvComparand ) \
+    ( ( Atomic_CompareAndSwapPointers_p32( ( ppvDestination ), ( pvExchange ), ( pvComparand ) ) == ATOMIC_COMPARE_AND_SWAP_SUCCESS ) ? pdTRUE : pdFALSE )
+#endif
+
 /* Lint e9021, e961 and e750 are suppressed as a MISRA exception justified
  * because the MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined
  * for the header files above, but not in this file, in order to generate the
@@ -138,6 +149,35 @@ typedef xQUEUE Queue_t;
 
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_FAST_MUTEXES == 1 )
+
+/*
+ * Definition of a fast mutex.  pvOwner holds the handle of the task that holds
+ * the mutex, or NULL when the mutex is available, so that an uncontended take
+ * or give is a single compare-and-swap.  Task handles are pointer aligned, bit 0
+ * of pvOwner is set while tasks are waiting for the mutex.  This makes the
+ * compare-and-swap in xQueueFastMutexGive() fail, so that the holder enters
+ * the kernel to unblock a waiting task.
+ */
+    typedef struct FastMutexDefinition
+    {
+        void * volatile pvOwner;          /**< The holder of the mutex, with queueFAST_MUTEX_WAITERS. */
+        List_t xTasksWaiting;             /**< List of tasks that are blocked waiting for the mutex.  Stored in priority order. */
+        UBaseType_t uxRecursiveCallCount; /**< The number of times that the holder took the mutex again. */
+
+        #if ( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
+            uint8_t ucStaticallyAllocated; /**< Set to pdTRUE if the memory used by the mutex was statically allocated to ensure no attempt is made to free the memory. */
+        #endif
+    } FastMutex_t;
+
+    #define queueFAST_MUTEX_WAITERS    ( ( portPOINTER_SIZE_TYPE ) 1U )
+
+/* Obtain the holder of a fast mutex from its pvOwner member. */
+    #define queueFAST_MUTEX_HOLDER( pvOwner )    ( ( TaskHandle_t ) ( ( ( portPOINTER_SIZE_TYPE ) ( pvOwner ) ) & ~queueFAST_MUTEX_WAITERS ) )
+
+#endif /* configUSE_FAST_MUTEXES */
+/*-----------------------------------------------------------*/
+
 /*
  * The queue registry is just a means for kernel aware debuggers to locate
  * queue structures.  It has no other purpose so is an optional component.
@@ -242,6 +282,15 @@ static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength,
  */
     static UBaseType_t prvGetDisinheritPriorityAfterTimeout( const Queue_t * const pxQueue ) PRIVILEGED_FUNCTION;
 #endif
+
+#if ( configUSE_FAST_MUTEXES == 1 )
+    static void prvInitialiseFastMutex( FastMutex_t * pxNewMutex ) PRIVILEGED_FUNCTION;
+
+/*
+ * The same as prvGetDisinheritPriorityAfterTimeout(), for a fast mutex.
+ */
+    static UBaseType_t prvGetFastMutexDisinheritPriority( const FastMutex_t * const pxMutex ) PRIVILEGED_FUNCTION;
+#endif
 /*-----------------------------------------------------------*/
 
 /*
@@ -3146,3 +3195,395 @@ BaseType_t xQueueIsQueueFullFromISR( const QueueHandle_t xQueue )
     }
 
 #endif /* configUSE_QUEUE_SETS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_FAST_MUTEXES == 1 )
+
+    static void prvInitialiseFastMutex( FastMutex_t * pxNewMutex )
+    {
+        pxNewMutex->pvOwner = NULL;
+        pxNewMutex->uxRecursiveCallCount = ( UBaseType_t ) 0U;
+        vListInitialise( &( pxNewMutex->xTasksWaiting ) );
+    }
+
+#endif /* configUSE_FAST_MUTEXES */
+/*-----------------------------------------------------------*/
+
+#if ( ( configUSE_FAST_MUTEXES == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
+
+    FastMutexHandle_t xQueueCreateFastMutex( void )
+    {
+        FastMutex_t * pxNewMutex;
+
+        pxNewMutex = ( FastMutex_t * ) pvPortMalloc( sizeof( FastMutex_t ) ); /*lint !e9087 !e9079 void * is used as this macro is used with malloc() - and malloc() returns void *. */
+
+        if( pxNewMutex != NULL )
+        {
+            prvInitialiseFastMutex( pxNewMutex );
+
+            #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+            {
+                /* Both static and dynamic allocation can be used, so note this
+                 * mutex was allocated dynamically in case it is later deleted. */
+                pxNewMutex->ucStaticallyAllocated = pdFALSE;
+            }
+            #endif /* configSUPPORT_STATIC_ALLOCATION */
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return pxNewMutex;
+    }
+
+#endif /* ( ( configUSE_FAST_MUTEXES == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) ) */
+/*-----------------------------------------------------------*/
+
+#if ( ( configUSE_FAST_MUTEXES == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) )
+
+    FastMutexHandle_t xQueueCreateFastMutexStatic( StaticFastMutex_t * pxStaticFastMutex )
+    {
+        FastMutex_t * pxNewMutex = NULL;
+
+        configASSERT( pxStaticFastMutex );
+
+        #if ( configASSERT_DEFINED == 1 )
+        {
+            /* Sanity check that the size of the structure used to declare a
+             * variable of type StaticFastMutex_t equals the size of the real
+             * fast mutex structure. */
+            volatile size_t xSize = sizeof( StaticFastMutex_t );
+            configASSERT( xSize == sizeof( FastMutex_t ) );
+            ( void ) xSize; /* Keeps lint quiet when configASSERT() is not defined. */
+        }
+        #endif /* configASSERT_DEFINED */
+
+        if( pxStaticFastMutex != NULL )
+        {
+            pxNewMutex = ( FastMutex_t * ) pxStaticFastMutex; /*lint !e740 !e9087 Unusual cast is ok as the structures are designed to have the same alignment, and the size is checked by an assert. */
+            prvInitialiseFastMutex( pxNewMutex );
+
+            #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+            {
+                /* Both static and dynamic allocation can be used, so note this
+                 * mutex was allocated statically in case it is later deleted. */
+                pxNewMutex->ucStaticallyAllocated = pdTRUE;
+            }
+            #endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return pxNewMutex;
+    }
+
+#endif /* ( ( configUSE_FAST_MUTEXES == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) ) */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_FAST_MUTEXES == 1 )
+
+    BaseType_t xQueueFastMutexTake( FastMutexHandle_t xMutex,
+                                    TickType_t xTicksToWait )
+    {
+        FastMutex_t * const pxMutex = xMutex;
+        TaskHandle_t const xCurrentTask = xTaskGetCurrentTaskHandle();
+        void * pvOwner;
+        TimeOut_t xTimeOut;
+        BaseType_t xEntryTimeSet = pdFALSE;
+        BaseType_t xInheritanceOccurred = pdFALSE;
+
+        configASSERT( pxMutex );
+
+        /* Fast mutexes can only be taken by a task. */
+        configASSERT( xCurrentTask );
+
+        /*lint -save -e904 This function relaxes the coding standard somewhat to
+         * allow return statements within the function itself.  This is done in
+         * the interest of execution time efficiency. */
+        if( queueFAST_MUTEX_HOLDER( pxMutex->pvOwner ) == xCurrentTask )
+        {
+            /* The calling task holds the mutex already.  Only the holder
+             * accesses uxRecursiveCallCount. */
+            ( pxMutex->uxRecursiveCallCount )++;
+
+            return pdPASS;
+        }
+
+        /* Count the mutex as held before it can be seen as the holder, the
+         * priority inheritance code checks the count of the holder. */
+        ( void ) pvTaskIncrementMutexHeldCount();
+
+        if( portCOMPARE_AND_SWAP_POINTER( &( pxMutex->pvOwner ), xCurrentTask, NULL ) != pdFALSE )
+        {
+            /* The mutex was available, the kernel was not entered. */
+            return pdPASS;
+        }
+
+        /* The mutex is contended.  It will be counted again when it is
+         * obtained. */
+        ( void ) xTaskDecrementMutexHeldCount();
+
+        /* Cannot block if the scheduler is suspended. */
+        #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+        {
+            configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+        }
+        #endif
+
+        for( ; ; )
+        {
+            taskENTER_CRITICAL();
+            {
+                pvOwner = pxMutex->pvOwner;
+
+                if( queueFAST_MUTEX_HOLDER( pvOwner ) == NULL )
+                {
+                    /* The mutex is available.  Keep the waiters flag set when
+                     * more tasks are waiting, so that the next give will unblock
+                     * one of them. */
+                    if( listLIST_IS_EMPTY( &( pxMutex->xTasksWaiting ) ) == pdFALSE )
+                    {
+                        pxMutex->pvOwner = ( void * ) ( ( ( portPOINTER_SIZE_TYPE ) xCurrentTask ) | queueFAST_MUTEX_WAITERS );
+                    }
+                    else
+                    {
+                        pxMutex->pvOwner = xCurrentTask;
+                    }
+
+                    ( void ) pvTaskIncrementMutexHeldCount();
+                    taskEXIT_CRITICAL();
+
+                    return pdPASS;
+                }
+                else if( ( xTicksToWait == ( TickType_t ) 0 ) ||
+                         ( ( xEntryTimeSet != pdFALSE ) && ( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) != pdFALSE ) ) )
+                {
+                    /* Timed out.  If this task caused the holder to inherit a
+                     * priority then the holder should disinherit it, but only
+                     * down to the priority of the tasks still waiting. */
+                    if( xInheritanceOccurred != pdFALSE )
+                    {
+                        vTaskPriorityDisinheritAfterTimeout( queueFAST_MUTEX_HOLDER( pvOwner ), prvGetFastMutexDisinheritPriority( pxMutex ) );
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    /* When no task is waiting any more, the holder can give the
+                     * mutex without entering the kernel. */
+                    if( listLIST_IS_EMPTY( &( pxMutex->xTasksWaiting ) ) != pdFALSE )
+                    {
+                        pxMutex->pvOwner = queueFAST_MUTEX_HOLDER( pvOwner );
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    taskEXIT_CRITICAL();
+
+                    return pdFAIL;
+                }
+                else
+                {
+                    if( xEntryTimeSet == pdFALSE )
+                    {
+                        vTaskInternalSetTimeOutState( &xTimeOut );
+                        xEntryTimeSet = pdTRUE;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    /* Make the compare-and-swap of the holder fail, so that it
+                     * enters the kernel to unblock this task. */
+                    pxMutex->pvOwner = ( void * ) ( ( ( portPOINTER_SIZE_TYPE ) pvOwner ) | queueFAST_MUTEX_WAITERS );
+
+                    if( xTaskPriorityInherit( queueFAST_MUTEX_HOLDER( pvOwner ) ) != pdFALSE )
+                    {
+                        xInheritanceOccurred = pdTRUE;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    vTaskPlaceOnEventList( &( pxMutex->xTasksWaiting ), xTicksToWait );
+
+                    /* All ports are written to allow a yield in a critical
+                     * section (some will yield immediately, others wait until the
+                     * critical section exits) - but it is not something that
+                     * application code should ever do. */
+                    portYIELD_WITHIN_API();
+                }
+            }
+            taskEXIT_CRITICAL();
+        } /*lint -restore */
+    }
+
+#endif /* configUSE_FAST_MUTEXES */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_FAST_MUTEXES == 1 )
+
+    BaseType_t xQueueFastMutexGive( FastMutexHandle_t xMutex )
+    {
+        FastMutex_t * const pxMutex = xMutex;
+        TaskHandle_t const xCurrentTask = xTaskGetCurrentTaskHandle();
+        BaseType_t xReturn = pdPASS;
+        BaseType_t xYieldRequired = pdFALSE;
+
+        configASSERT( pxMutex );
+
+        if( queueFAST_MUTEX_HOLDER( pxMutex->pvOwner ) != xCurrentTask )
+        {
+            /* Only the holder can give the mutex. */
+            xReturn = pdFAIL;
+        }
+        else if( pxMutex->uxRecursiveCallCount != ( UBaseType_t ) 0U )
+        {
+            ( pxMutex->uxRecursiveCallCount )--;
+        }
+        else if( portCOMPARE_AND_SWAP_POINTER( &( pxMutex->pvOwner ), NULL, xCurrentTask ) != pdFALSE )
+        {
+            /* No task was waiting, the kernel is only entered when an
+             * inherited priority must be given up. */
+            xYieldRequired = xTaskDecrementMutexHeldCount();
+        }
+        else
+        {
+            /* The waiters flag is set. */
+            taskENTER_CRITICAL();
+            {
+                pxMutex->pvOwner = NULL;
+
+                if( listLIST_IS_EMPTY( &( pxMutex->xTasksWaiting ) ) == pdFALSE )
+                {
+                    /* Unblock the highest priority waiting task, it will take
+                     * the mutex when it runs. */
+                    if( xTaskRemoveFromEventList( &( pxMutex->xTasksWaiting ) ) != pdFALSE )
+                    {
+                        xYieldRequired = pdTRUE;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    /* Until then the mutex can be taken by another task, which
+                     * must then enter the kernel to give it. */
+                    if( listLIST_IS_EMPTY( &( pxMutex->xTasksWaiting ) ) == pdFALSE )
+                    {
+                        pxMutex->pvOwner = ( void * ) queueFAST_MUTEX_WAITERS;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                if( xTaskPriorityDisinherit( xCurrentTask ) != pdFALSE )
+                {
+                    xYieldRequired = pdTRUE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            taskEXIT_CRITICAL();
+        }
+
+        if( xYieldRequired != pdFALSE )
+        {
+            queueYIELD_IF_USING_PREEMPTION();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return xReturn;
+    }
+
+#endif /* configUSE_FAST_MUTEXES */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_FAST_MUTEXES == 1 )
+
+    TaskHandle_t xQueueGetFastMutexHolder( FastMutexHandle_t xMutex )
+    {
+        FastMutex_t * const pxMutex = xMutex;
+
+        configASSERT( pxMutex );
+
+        return queueFAST_MUTEX_HOLDER( pxMutex->pvOwner );
+    }
+
+#endif /* configUSE_FAST_MUTEXES */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_FAST_MUTEXES == 1 )
+
+    void vQueueDeleteFastMutex( FastMutexHandle_t xMutex )
+    {
+        FastMutex_t * const pxMutex = xMutex;
+
+        configASSERT( pxMutex );
+
+        /* The mutex must not be held, nor be waited for. */
+        configASSERT( pxMutex->pvOwner == NULL );
+
+        #if ( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) )
+        {
+            vPortFree( pxMutex );
+        }
+        #elif ( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) )
+        {
+            if( pxMutex->ucStaticallyAllocated == ( uint8_t ) pdFALSE )
+            {
+                vPortFree( pxMutex );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        #else
+        {
+            ( void ) pxMutex;
+        }
+        #endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+    }
+
+#endif /* configUSE_FAST_MUTEXES */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_FAST_MUTEXES == 1 )
+
+    static UBaseType_t prvGetFastMutexDisinheritPriority( const FastMutex_t * const pxMutex )
+    {
+        UBaseType_t uxHighestPriorityOfWaitingTasks;
+
+        if( listCURRENT_LIST_LENGTH( &( pxMutex->xTasksWaiting ) ) > 0U )
+        {
+            uxHighestPriorityOfWaitingTasks = ( UBaseType_t ) configMAX_PRIORITIES - ( UBaseType_t ) listGET_ITEM_VALUE_OF_HEAD_ENTRY( &( pxMutex->xTasksWaiting ) );
+        }
+        else
+        {
+            uxHighestPriorityOfWaitingTasks = tskIDLE_PRIORITY;
+        }
+
+        return uxHighestPriorityOfWaitingTasks;
+    }
+
+#endif /* configUSE_FAST_MUTEXES */
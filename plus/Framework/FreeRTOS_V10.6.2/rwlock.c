@@ -0,0 +1,728 @@
+/*
+ * FreeRTOS Kernel V10.6.2
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/* Standard includes. */
+#include <stdlib.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+ * all the API functions to use the MPU wrappers.  That should only be done when
+ * task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "rwlock.h"
+
+/* Lint e961, e750 and e9021 are suppressed as a MISRA exception justified
+ * because the MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined
+ * for the header files above, but not in this file, in order to generate the
+ * correct privileged Vs unprivileged linkage and placement. */
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE /*lint !e961 !e750 !e9021 See comment above. */
+
+#if ( configUSE_PREEMPTION == 0 )
+
+/* If the cooperative scheduler is being used then a yield should not be
+ * performed just because a higher priority task has been woken. */
+    #define rwlockYIELD_IF_USING_PREEMPTION()
+#else
+    #define rwlockYIELD_IF_USING_PREEMPTION()    portYIELD_WITHIN_API()
+#endif
+
+typedef struct RWLockDefinition
+{
+    TaskHandle_t xWriter;            /**< The task that holds the lock for writing, or NULL. */
+    UBaseType_t uxReaders;           /**< The number of tasks that hold the lock for reading. */
+    UBaseType_t uxWritersWaiting;    /**< The number of tasks in xRWLockTakeWrite() that wait for write access, including a task that was unblocked but did not run yet. */
+    List_t xTasksWaitingToRead;      /**< List of tasks that are blocked waiting for read access.  Stored in priority order. */
+    List_t xTasksWaitingToWrite;     /**< List of tasks that are blocked waiting for write access.  Stored in priority order. */
+
+    #if ( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
+        uint8_t ucStaticallyAllocated; /**< Set to pdTRUE if the lock is statically allocated to ensure no attempt is made to free the memory. */
+    #endif
+} RWLock_t;
+
+/*-----------------------------------------------------------*/
+
+static void prvInitialiseRWLock( RWLock_t * pxRWLock ) PRIVILEGED_FUNCTION;
+
+/*
+ * Block the calling task on pxList until the lock is given or xTicksToWait
+ * expires.  Must be called from a critical section.
+ */
+static void prvBlockOnRWLock( RWLock_t * pxRWLock,
+                              List_t * pxList,
+                              TickType_t xTicksToWait,
+                              BaseType_t * pxInheritanceOccurred ) PRIVILEGED_FUNCTION;
+
+/*
+ * Called when a waiting task timed out.  If the task caused the writer to
+ * inherit its priority, the writer disinherits down to the priority of the
+ * highest priority task that is still waiting.  Must be called from a critical
+ * section.
+ */
+static void prvTimedOut( const RWLock_t * pxRWLock,
+                         BaseType_t xInheritanceOccurred ) PRIVILEGED_FUNCTION;
+
+/*
+ * Give the lock to the highest priority task that waits for write access, and
+ * unblock it.  Returns pdTRUE if that task has a priority above the calling
+ * task.  Must be called from a critical section.
+ */
+static BaseType_t prvHandToWriter( RWLock_t * pxRWLock ) PRIVILEGED_FUNCTION;
+
+/*
+ * Unblock all the tasks that wait for read access.  Returns pdTRUE if one of
+ * them has a priority above the calling task.
+ */
+static BaseType_t prvUnblockReaders( RWLock_t * pxRWLock ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+static void prvInitialiseRWLock( RWLock_t * pxRWLock )
+{
+    pxRWLock->xWriter = NULL;
+    pxRWLock->uxReaders = ( UBaseType_t ) 0U;
+    pxRWLock->uxWritersWaiting = ( UBaseType_t ) 0U;
+    vListInitialise( &( pxRWLock->xTasksWaitingToRead ) );
+    vListInitialise( &( pxRWLock->xTasksWaitingToWrite ) );
+}
+/*-----------------------------------------------------------*/
+
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+
+    RWLockHandle_t xRWLockCreateStatic( StaticRWLock_t * pxRWLockBuffer )
+    {
+        RWLock_t * pxRWLock;
+
+        /* A StaticRWLock_t object must be provided. */
+        configASSERT( pxRWLockBuffer );
+
+        #if ( configASSERT_DEFINED == 1 )
+        {
+            /* Sanity check that the size of the structure used to declare a
+             * variable of type StaticRWLock_t equals the size of the real
+             * reader-writer lock structure. */
+            volatile size_t xSize = sizeof( StaticRWLock_t );
+            configASSERT( xSize == sizeof( RWLock_t ) );
+        } /*lint !e529 xSize is referenced if configASSERT() is defined. */
+        #endif /* configASSERT_DEFINED */
+
+        pxRWLock = ( RWLock_t * ) pxRWLockBuffer; /*lint !e740 !e9087 RWLock_t and StaticRWLock_t are deliberately aliased for data hiding purposes and guaranteed to have the same size and alignment requirement - checked by configASSERT(). */
+
+        if( pxRWLock != NULL )
+        {
+            prvInitialiseRWLock( pxRWLock );
+
+            #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+            {
+                /* Both static and dynamic allocation can be used, so note that
+                 * this lock was created statically in case it is later
+                 * deleted. */
+                pxRWLock->ucStaticallyAllocated = pdTRUE;
+            }
+            #endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return pxRWLock;
+    }
+
+#endif /* configSUPPORT_STATIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+    RWLockHandle_t xRWLockCreate( void )
+    {
+        RWLock_t * pxRWLock;
+
+        pxRWLock = ( RWLock_t * ) pvPortMalloc( sizeof( RWLock_t ) ); /*lint !e9087 !e9079 see comment above. */
+
+        if( pxRWLock != NULL )
+        {
+            prvInitialiseRWLock( pxRWLock );
+
+            #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+            {
+                /* Both static and dynamic allocation can be used, so note this
+                 * lock was allocated dynamically in case it is later deleted. */
+                pxRWLock->ucStaticallyAllocated = pdFALSE;
+            }
+            #endif /* configSUPPORT_STATIC_ALLOCATION */
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return pxRWLock;
+    }
+
+#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+void vRWLockDelete( RWLockHandle_t xRWLock )
+{
+    RWLock_t * pxRWLock = xRWLock;
+
+    configASSERT( pxRWLock );
+
+    /* The lock must not be in use. */
+    configASSERT( ( pxRWLock->xWriter == NULL ) && ( pxRWLock->uxReaders == ( UBaseType_t ) 0U ) );
+    configASSERT( listLIST_IS_EMPTY( &( pxRWLock->xTasksWaitingToRead ) ) != pdFALSE );
+    configASSERT( listLIST_IS_EMPTY( &( pxRWLock->xTasksWaitingToWrite ) ) != pdFALSE );
+
+    #if ( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) )
+    {
+        /* The lock can only have been allocated dynamically - free it
+         * again. */
+        vPortFree( pxRWLock );
+    }
+    #elif ( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) )
+    {
+        /* The lock could have been allocated statically or dynamically, so
+         * check before attempting to free the memory. */
+        if( pxRWLock->ucStaticallyAllocated == ( uint8_t ) pdFALSE )
+        {
+            vPortFree( pxRWLock );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    #else /* if ( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) ) */
+    {
+        ( void ) pxRWLock;
+    }
+    #endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xRWLockTakeRead( RWLockHandle_t xRWLock,
+                            TickType_t xTicksToWait )
+{
+    RWLock_t * const pxRWLock = xRWLock;
+    TimeOut_t xTimeOut;
+    BaseType_t xEntryTimeSet = pdFALSE;
+    BaseType_t xInheritanceOccurred = pdFALSE;
+    BaseType_t xReturn;
+
+    configASSERT( pxRWLock );
+
+    /* Cannot block if the scheduler is suspended. */
+    #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+    {
+        configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+    }
+    #endif
+
+    for( ; ; )
+    {
+        taskENTER_CRITICAL();
+        {
+            /* Tasks that wait for write access are served first. */
+            if( ( pxRWLock->xWriter == NULL ) &&
+                ( pxRWLock->uxWritersWaiting == ( UBaseType_t ) 0U ) )
+            {
+                ( pxRWLock->uxReaders )++;
+                xReturn = pdPASS;
+            }
+            else if( ( xTicksToWait == ( TickType_t ) 0 ) ||
+                     ( ( xEntryTimeSet != pdFALSE ) && ( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) != pdFALSE ) ) )
+            {
+                prvTimedOut( pxRWLock, xInheritanceOccurred );
+                xReturn = pdFAIL;
+            }
+            else
+            {
+                if( xEntryTimeSet == pdFALSE )
+                {
+                    vTaskInternalSetTimeOutState( &xTimeOut );
+                    xEntryTimeSet = pdTRUE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                prvBlockOnRWLock( pxRWLock, &( pxRWLock->xTasksWaitingToRead ), xTicksToWait, &xInheritanceOccurred );
+                xReturn = errQUEUE_BLOCKED;
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        if( xReturn != errQUEUE_BLOCKED )
+        {
+            break;
+        }
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vRWLockGiveRead( RWLockHandle_t xRWLock )
+{
+    RWLock_t * const pxRWLock = xRWLock;
+    BaseType_t xYieldRequired = pdFALSE;
+
+    configASSERT( pxRWLock );
+
+    taskENTER_CRITICAL();
+    {
+        configASSERT( pxRWLock->uxReaders != ( UBaseType_t ) 0U );
+        ( pxRWLock->uxReaders )--;
+
+        if( ( pxRWLock->uxReaders == ( UBaseType_t ) 0U ) &&
+            ( listLIST_IS_EMPTY( &( pxRWLock->xTasksWaitingToWrite ) ) == pdFALSE ) )
+        {
+            xYieldRequired = prvHandToWriter( pxRWLock );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    if( xYieldRequired != pdFALSE )
+    {
+        rwlockYIELD_IF_USING_PREEMPTION();
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xRWLockTakeWrite( RWLockHandle_t xRWLock,
+                             TickType_t xTicksToWait )
+{
+    RWLock_t * const pxRWLock = xRWLock;
+    TaskHandle_t const xCurrentTask = xTaskGetCurrentTaskHandle();
+    TimeOut_t xTimeOut;
+    BaseType_t xEntryTimeSet = pdFALSE;
+    BaseType_t xInheritanceOccurred = pdFALSE;
+    BaseType_t xReturn;
+
+    configASSERT( pxRWLock );
+
+    /* The lock is not recursive. */
+    configASSERT( pxRWLock->xWriter != xCurrentTask );
+
+    /* Cannot block if the scheduler is suspended. */
+    #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+    {
+        configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+    }
+    #endif
+
+    for( ; ; )
+    {
+        taskENTER_CRITICAL();
+        {
+            if( pxRWLock->xWriter == xCurrentTask )
+            {
+                /* The lock was handed over while this task was waiting.  Now
+                 * that it runs, it is counted as a mutex holder. */
+                #if ( configUSE_MUTEXES == 1 )
+                {
+                    ( void ) pvTaskIncrementMutexHeldCount();
+                }
+                #endif
+
+                ( pxRWLock->uxWritersWaiting )--;
+                xReturn = pdPASS;
+            }
+            else if( ( pxRWLock->xWriter == NULL ) && ( pxRWLock->uxReaders == ( UBaseType_t ) 0U ) )
+            {
+                #if ( configUSE_MUTEXES == 1 )
+                {
+                    /* The writer is counted as a mutex holder for the purpose
+                     * of priority inheritance. */
+                    pxRWLock->xWriter = pvTaskIncrementMutexHeldCount();
+                }
+                #else
+                {
+                    pxRWLock->xWriter = xCurrentTask;
+                }
+                #endif
+
+                if( xEntryTimeSet != pdFALSE )
+                {
+                    ( pxRWLock->uxWritersWaiting )--;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                xReturn = pdPASS;
+            }
+            else if( ( xTicksToWait == ( TickType_t ) 0 ) ||
+                     ( ( xEntryTimeSet != pdFALSE ) && ( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) != pdFALSE ) ) )
+            {
+                prvTimedOut( pxRWLock, xInheritanceOccurred );
+
+                if( xEntryTimeSet != pdFALSE )
+                {
+                    ( pxRWLock->uxWritersWaiting )--;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                /* Readers that waited because of this task may proceed when no
+                 * other task waits for write access. */
+                if( ( pxRWLock->xWriter == NULL ) &&
+                    ( pxRWLock->uxWritersWaiting == ( UBaseType_t ) 0U ) )
+                {
+                    if( prvUnblockReaders( pxRWLock ) != pdFALSE )
+                    {
+                        rwlockYIELD_IF_USING_PREEMPTION();
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                xReturn = pdFAIL;
+            }
+            else
+            {
+                if( xEntryTimeSet == pdFALSE )
+                {
+                    vTaskInternalSetTimeOutState( &xTimeOut );
+                    xEntryTimeSet = pdTRUE;
+
+                    /* From now on, new readers wait until this task got the
+                     * lock or gave up. */
+                    ( pxRWLock->uxWritersWaiting )++;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                prvBlockOnRWLock( pxRWLock, &( pxRWLock->xTasksWaitingToWrite ), xTicksToWait, &xInheritanceOccurred );
+                xReturn = errQUEUE_BLOCKED;
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        if( xReturn != errQUEUE_BLOCKED )
+        {
+            break;
+        }
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xRWLockGiveWrite( RWLockHandle_t xRWLock )
+{
+    RWLock_t * const pxRWLock = xRWLock;
+    BaseType_t xReturn = pdPASS;
+    BaseType_t xYieldRequired = pdFALSE;
+
+    configASSERT( pxRWLock );
+
+    taskENTER_CRITICAL();
+    {
+        if( pxRWLock->xWriter != xTaskGetCurrentTaskHandle() )
+        {
+            /* Only the writer can give the lock. */
+            xReturn = pdFAIL;
+        }
+        else
+        {
+            pxRWLock->xWriter = NULL;
+
+            /* Writers are preferred, otherwise all the readers can proceed
+             * once no writer is on its way. */
+            if( listLIST_IS_EMPTY( &( pxRWLock->xTasksWaitingToWrite ) ) == pdFALSE )
+            {
+                xYieldRequired = prvHandToWriter( pxRWLock );
+            }
+            else if( pxRWLock->uxWritersWaiting == ( UBaseType_t ) 0U )
+            {
+                xYieldRequired = prvUnblockReaders( pxRWLock );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            #if ( configUSE_MUTEXES == 1 )
+            {
+                if( xTaskPriorityDisinherit( xTaskGetCurrentTaskHandle() ) != pdFALSE )
+                {
+                    xYieldRequired = pdTRUE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            #endif /* configUSE_MUTEXES */
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    if( xYieldRequired != pdFALSE )
+    {
+        rwlockYIELD_IF_USING_PREEMPTION();
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxRWLockGetReaderCount( RWLockHandle_t xRWLock )
+{
+    RWLock_t const * pxRWLock = xRWLock;
+
+    configASSERT( pxRWLock );
+
+    return pxRWLock->uxReaders;
+}
+/*-----------------------------------------------------------*/
+
+TaskHandle_t xRWLockGetWriter( RWLockHandle_t xRWLock )
+{
+    RWLock_t const * pxRWLock = xRWLock;
+
+    configASSERT( pxRWLock );
+
+    return pxRWLock->xWriter;
+}
+/*-----------------------------------------------------------*/
+
+static void prvBlockOnRWLock( RWLock_t * pxRWLock,
+                              List_t * pxList,
+                              TickType_t xTicksToWait,
+                              BaseType_t * pxInheritanceOccurred )
+{
+    #if ( configUSE_MUTEXES == 1 )
+    {
+        /* A writer inherits the priority of the waiting tasks.  Readers are
+         * not tracked, so they can not inherit a priority. */
+        if( xTaskPriorityInherit( pxRWLock->xWriter ) != pdFALSE )
+        {
+            *pxInheritanceOccurred = pdTRUE;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    #else
+    {
+        ( void ) pxRWLock;
+        ( void ) pxInheritanceOccurred;
+    }
+    #endif /* configUSE_MUTEXES */
+
+    vTaskPlaceOnEventList( pxList, xTicksToWait );
+
+    /* All ports are written to allow a yield in a critical section (some will
+     * yield immediately, others wait until the critical section exits) - but it
+     * is not something that application code should ever do. */
+    portYIELD_WITHIN_API();
+}
+/*-----------------------------------------------------------*/
+
+static void prvTimedOut( const RWLock_t * pxRWLock,
+                         BaseType_t xInheritanceOccurred )
+{
+    #if ( configUSE_MUTEXES == 1 )
+    {
+        UBaseType_t uxHighestPriority = tskIDLE_PRIORITY;
+        UBaseType_t uxPriority;
+
+        if( xInheritanceOccurred != pdFALSE )
+        {
+            /* The waiting lists are stored in priority order, the highest
+             * priority task is at the head. */
+            if( listCURRENT_LIST_LENGTH( &( pxRWLock->xTasksWaitingToRead ) ) > 0U )
+            {
+                uxHighestPriority = ( UBaseType_t ) configMAX_PRIORITIES - ( UBaseType_t ) listGET_ITEM_VALUE_OF_HEAD_ENTRY( &( pxRWLock->xTasksWaitingToRead ) );
+            }
+
+            if( listCURRENT_LIST_LENGTH( &( pxRWLock->xTasksWaitingToWrite ) ) > 0U )
+            {
+                uxPriority = ( UBaseType_t ) configMAX_PRIORITIES - ( UBaseType_t ) listGET_ITEM_VALUE_OF_HEAD_ENTRY( &( pxRWLock->xTasksWaitingToWrite ) );
+
+                if( uxPriority > uxHighestPriority )
+                {
+                    uxHighestPriority = uxPriority;
+                }
+            }
+
+            vTaskPriorityDisinheritAfterTimeout( pxRWLock->xWriter, uxHighestPriority );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    #else
+    {
+        ( void ) pxRWLock;
+        ( void ) xInheritanceOccurred;
+    }
+    #endif /* configUSE_MUTEXES */
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvHandToWriter( RWLock_t * pxRWLock )
+{
+    /* The lock is taken on behalf of the waiting task before it is unblocked,
+     * so that no other task can take it in the meantime.  The waiting list is
+     * stored in priority order. */
+    pxRWLock->xWriter = ( TaskHandle_t ) listGET_OWNER_OF_HEAD_ENTRY( &( pxRWLock->xTasksWaitingToWrite ) ); /*lint !e9079 The owner of an event list item is the TCB of the task. */
+
+    return xTaskRemoveFromEventList( &( pxRWLock->xTasksWaitingToWrite ) );
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvUnblockReaders( RWLock_t * pxRWLock )
+{
+    BaseType_t xReturn = pdFALSE;
+
+    while( listLIST_IS_EMPTY( &( pxRWLock->xTasksWaitingToRead ) ) == pdFALSE )
+    {
+        if( xTaskRemoveFromEventList( &( pxRWLock->xTasksWaitingToRead ) ) != pdFALSE )
+        {
+            xReturn = pdTRUE;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vSeqLockInitialise( SeqLock_t * pxSeqLock )
+{
+    configASSERT( pxSeqLock );
+
+    pxSeqLock->uxSequence = ( UBaseType_t ) 0U;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxSeqLockReadBegin( const SeqLock_t * pxSeqLock )
+{
+    UBaseType_t uxSequence = pxSeqLock->uxSequence;
+
+    /* The data must be read after the sequence number. */
+    portMEMORY_BARRIER();
+
+    return uxSequence;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xSeqLockReadRetry( const SeqLock_t * pxSeqLock,
+                              UBaseType_t uxSequence )
+{
+    BaseType_t xReturn = pdFALSE;
+
+    /* The data must be read before the sequence number. */
+    portMEMORY_BARRIER();
+
+    /* An odd sequence number means that a writer was active. */
+    if( ( ( uxSequence & ( UBaseType_t ) 1U ) != ( UBaseType_t ) 0U ) ||
+        ( pxSeqLock->uxSequence != uxSequence ) )
+    {
+        xReturn = pdTRUE;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vSeqLockWriteBegin( SeqLock_t * pxSeqLock )
+{
+    taskENTER_CRITICAL();
+    ( pxSeqLock->uxSequence )++;
+    portMEMORY_BARRIER();
+}
+/*-----------------------------------------------------------*/
+
+void vSeqLockWriteEnd( SeqLock_t * pxSeqLock )
+{
+    portMEMORY_BARRIER();
+    ( pxSeqLock->uxSequence )++;
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxSeqLockWriteBeginFromISR( SeqLock_t * pxSeqLock )
+{
+    UBaseType_t uxSavedInterruptStatus;
+
+    uxSavedInterruptStatus = ( UBaseType_t ) taskENTER_CRITICAL_FROM_ISR();
+    ( pxSeqLock->uxSequence )++;
+    portMEMORY_BARRIER();
+
+    return uxSavedInterruptStatus;
+}
+/*-----------------------------------------------------------*/
+
+void vSeqLockWriteEndFromISR( SeqLock_t * pxSeqLock,
+                              UBaseType_t uxSavedInterruptStatus )
+{
+    portMEMORY_BARRIER();
+    ( pxSeqLock->uxSequence )++;
+    taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+}
+/*-----------------------------------------------------------*/
@@ -4754,6 +4754,38 @@ TickType_t uxTaskResetEventItemValue( void )
 #endif /* configUSE_MUTEXES */
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_FAST_MUTEXES == 1 )
+
+    BaseType_t xTaskDecrementMutexHeldCount( void )
+    {
+        BaseType_t xReturn = pdFALSE;
+
+        configASSERT( pxCurrentTCB->uxMutexesHeld );
+
+        /* Only the running task modifies its own mutex held count, other tasks
+         * only read it, so a critical section is not needed unless an
+         * inherited priority has to be given up.  The priority can only be
+         * raised by a task that waits for a mutex that this task holds, in which
+         * case the count remains above zero. */
+        if( pxCurrentTCB->uxPriority == pxCurrentTCB->uxBasePriority )
+        {
+            ( pxCurrentTCB->uxMutexesHeld )--;
+        }
+        else
+        {
+            taskENTER_CRITICAL();
+            {
+                xReturn = xTaskPriorityDisinherit( pxCurrentTCB );
+            }
+            taskEXIT_CRITICAL();
+        }
+
+        return xReturn;
+    }
+
+#endif /* configUSE_FAST_MUTEXES */
+/*-----------------------------------------------------------*/
+
 #if ( configUSE_TASK_NOTIFICATIONS == 1 )
 
     uint32_t ulTaskGenericNotifyTake( UBaseType_t uxIndexToWait,
@@ -5337,6 +5369,41 @@ TickType_t uxTaskResetEventItemValue( void )
 #endif
 /*-----------------------------------------------------------*/
 
+#if ( configGENERATE_RUN_TIME_STATS == 1 )
+
+    configRUN_TIME_COUNTER_TYPE ulTaskGetCurrentRunTimeCounter( void )
+    {
+        configRUN_TIME_COUNTER_TYPE ulNow, ulReturn;
+
+        taskENTER_CRITICAL();
+        {
+            #ifdef portALT_GET_RUN_TIME_COUNTER_VALUE
+                portALT_GET_RUN_TIME_COUNTER_VALUE( ulNow );
+            #else
+                ulNow = ( configRUN_TIME_COUNTER_TYPE ) portGET_RUN_TIME_COUNTER_VALUE();
+            #endif
+
+            ulReturn = pxCurrentTCB->ulRunTimeCounter;
+
+            /* Add the time since the task was switched in, in the same way as
+             * vTaskSwitchContext() does. */
+            if( ulNow > ulTaskSwitchedInTime )
+            {
+                ulReturn += ( ulNow - ulTaskSwitchedInTime );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        return ulReturn;
+    }
+
+#endif /* configGENERATE_RUN_TIME_STATS */
+/*-----------------------------------------------------------*/
+
 #if ( configGENERATE_RUN_TIME_STATS == 1 )
 
     configRUN_TIME_COUNTER_TYPE ulTaskGetRunTimePercent( const TaskHandle_t xTask )
@@ -0,0 +1,93 @@
+/*
+ * FreeRTOS Kernel V10.6.2
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+/* Configuration of the host benchmarks in this directory, which run on the
+ * POSIX port.  See README.md. */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define configUSE_PREEMPTION                       1
+#define configUSE_IDLE_HOOK                        0
+#define configUSE_TICK_HOOK                        0
+#define configTICK_RATE_HZ                         1000
+#define configMINIMAL_STACK_SIZE                   4096
+#define configTOTAL_HEAP_SIZE                      ( 1024 * 1024 )
+#define configMAX_TASK_NAME_LEN                    16
+#define configMAX_PRIORITIES                       7
+#define configUSE_TRACE_FACILITY                   1
+#define configUSE_16_BIT_TICKS                     0
+#define configIDLE_SHOULD_YIELD                    1
+#define configUSE_MUTEXES                          1
+#define configUSE_RECURSIVE_MUTEXES                1
+#define configUSE_COUNTING_SEMAPHORES              1
+#define configUSE_FAST_MUTEXES                     1
+#define configQUEUE_REGISTRY_SIZE                  10
+#define configUSE_TASK_NOTIFICATIONS               1
+#define configNUM_THREAD_LOCAL_STORAGE_POINTERS    4
+#define configSUPPORT_STATIC_ALLOCATION            1
+#define configSUPPORT_DYNAMIC_ALLOCATION           1
+#define configUSE_MALLOC_FAILED_HOOK               0
+#define configCHECK_FOR_STACK_OVERFLOW             0
+#define configUSE_APPLICATION_TASK_TAG             0
+
+#define configUSE_TIMERS                           1
+#define configTIMER_TASK_PRIORITY                  5
+#define configTIMER_QUEUE_LENGTH                   20
+#define configTIMER_TASK_STACK_DEPTH               configMINIMAL_STACK_SIZE
+
+/* The work queue statistics use the run time counter.  The POSIX port provides
+ * it: the user CPU time of the process, in clock ticks. */
+#define configGENERATE_RUN_TIME_STATS              1
+
+#define INCLUDE_vTaskPrioritySet                   1
+#define INCLUDE_uxTaskPriorityGet                  1
+#define INCLUDE_vTaskDelete                        1
+#define INCLUDE_vTaskSuspend                       1
+#define INCLUDE_xTaskDelayUntil                    1
+#define INCLUDE_vTaskDelay                         1
+#define INCLUDE_xTaskGetSchedulerState             1
+#define INCLUDE_xTaskGetCurrentTaskHandle          1
+#define INCLUDE_xTaskGetIdleTaskHandle             1
+#define INCLUDE_xTimerPendFunctionCall             1
+#define INCLUDE_xTaskAbortDelay                    1
+#define INCLUDE_xSemaphoreGetMutexHolder           1
+#define INCLUDE_eTaskGetState                      1
+
+/* A failed check ends the benchmark with exit code 2. */
+#define configASSERT( x )                                          \
+    if( ( x ) == 0 )                                               \
+    {                                                              \
+        printf( "Check failed: %s:%d\n", __FILE__, __LINE__ );     \
+        exit( 2 );                                                 \
+    }
+
+#endif /* FREERTOS_CONFIG_H */
@@ -0,0 +1,200 @@
+/*
+ * FreeRTOS Kernel V10.6.2
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * Host benchmark of the fast mutexes ( configUSE_FAST_MUTEXES ) on the POSIX
+ * port.  See README.md for how to build and run it.
+ *
+ * - Measures an uncontended take+give of a fast mutex and of a queue mutex.
+ * - Checks priority inheritance, recursion, and disinheritance after a
+ *   time-out.
+ * - Lets four tasks of two priorities contend for one fast mutex.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+/* The number of take+give pairs that are timed. */
+#define benchUNCONTENDED_LOOPS    2000000UL
+
+/* The number of tasks that contend for one mutex. */
+#define benchCONTENDERS           4
+
+static FastMutexHandle_t xFastMutex = NULL;
+static StaticFastMutex_t xFastMutexBuffer;
+static SemaphoreHandle_t xQueueMutex = NULL;
+static volatile uint32_t ulContendedCount = 0U;
+static volatile BaseType_t xStopContenders = pdFALSE;
+/*-----------------------------------------------------------*/
+
+static double prvSeconds( void )
+{
+    struct timespec xNow;
+
+    clock_gettime( CLOCK_MONOTONIC, &xNow );
+
+    return ( double ) xNow.tv_sec + ( ( double ) xNow.tv_nsec * 1e-9 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvContenderTask( void * pvParameters )
+{
+    FastMutexHandle_t xMutex = ( FastMutexHandle_t ) pvParameters;
+
+    for( ; ; )
+    {
+        configASSERT( xSemaphoreTakeFast( xMutex, portMAX_DELAY ) == pdPASS );
+        ulContendedCount++;
+        /* Block while holding the mutex, so the other tasks must wait. */
+        vTaskDelay( 1 );
+        configASSERT( xSemaphoreGiveFast( xMutex ) == pdPASS );
+
+        if( xStopContenders != pdFALSE )
+        {
+            vTaskSuspend( NULL );
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvLowPriorityHolderTask( void * pvParameters )
+{
+    ( void ) pvParameters;
+
+    /* Take the mutex twice, then wait for the benchmark task to block on it. */
+    configASSERT( xSemaphoreTakeFast( xFastMutex, 0 ) == pdPASS );
+    configASSERT( xSemaphoreTakeFast( xFastMutex, 0 ) == pdPASS );
+    vTaskSuspend( NULL );
+
+    /* The benchmark task, at priority 3, waits for the mutex now. */
+    configASSERT( uxTaskPriorityGet( NULL ) == 3 );
+    configASSERT( xSemaphoreGiveFast( xFastMutex ) == pdPASS );
+    configASSERT( uxTaskPriorityGet( NULL ) == 3 );
+    configASSERT( xSemaphoreGiveFast( xFastMutex ) == pdPASS );
+    configASSERT( uxTaskPriorityGet( NULL ) == 1 );
+    printf( "priority inheritance ok\n" );
+    vTaskSuspend( NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvBenchmarkTask( void * pvParameters )
+{
+    TaskHandle_t xLowTask;
+    TaskHandle_t xContenders[ benchCONTENDERS ];
+    FastMutexHandle_t xContended;
+    double dStart, dMiddle, dEnd;
+    uint32_t ulIndex;
+
+    ( void ) pvParameters;
+
+    xFastMutex = xSemaphoreCreateFastMutexStatic( &xFastMutexBuffer );
+    xQueueMutex = xSemaphoreCreateMutex();
+    configASSERT( ( xFastMutex != NULL ) && ( xQueueMutex != NULL ) );
+
+    /* Uncontended. */
+    dStart = prvSeconds();
+
+    for( ulIndex = 0U; ulIndex < benchUNCONTENDED_LOOPS; ulIndex++ )
+    {
+        ( void ) xSemaphoreTakeFast( xFastMutex, portMAX_DELAY );
+        ( void ) xSemaphoreGiveFast( xFastMutex );
+    }
+
+    dMiddle = prvSeconds();
+
+    for( ulIndex = 0U; ulIndex < benchUNCONTENDED_LOOPS; ulIndex++ )
+    {
+        ( void ) xSemaphoreTake( xQueueMutex, portMAX_DELAY );
+        ( void ) xSemaphoreGive( xQueueMutex );
+    }
+
+    dEnd = prvSeconds();
+
+    printf( "uncontended: fast mutex %.1f ns, queue mutex %.1f ns per take+give\n",
+            ( dMiddle - dStart ) * 1e9 / ( double ) benchUNCONTENDED_LOOPS,
+            ( dEnd - dMiddle ) * 1e9 / ( double ) benchUNCONTENDED_LOOPS );
+    configASSERT( xSemaphoreGetFastMutexHolder( xFastMutex ) == NULL );
+    configASSERT( xSemaphoreGiveFast( xFastMutex ) == pdFAIL );
+
+    /* Priority inheritance, and disinheritance after a time-out. */
+    xTaskCreate( prvLowPriorityHolderTask, "Low", configMINIMAL_STACK_SIZE, NULL, 1, &xLowTask );
+    vTaskDelay( 10 );
+    configASSERT( xSemaphoreGetFastMutexHolder( xFastMutex ) == xLowTask );
+    configASSERT( xSemaphoreTakeFast( xFastMutex, 5 ) == pdFAIL );
+    configASSERT( uxTaskPriorityGet( xLowTask ) == 1 );
+    vTaskResume( xLowTask );
+    configASSERT( xSemaphoreTakeFast( xFastMutex, portMAX_DELAY ) == pdPASS );
+    configASSERT( xSemaphoreGetFastMutexHolder( xFastMutex ) == xTaskGetCurrentTaskHandle() );
+    configASSERT( xSemaphoreGiveFast( xFastMutex ) == pdPASS );
+    vTaskDelay( 10 );
+
+    /* Contended. */
+    xContended = xSemaphoreCreateFastMutex();
+    configASSERT( xContended != NULL );
+    dStart = prvSeconds();
+
+    for( ulIndex = 0U; ulIndex < benchCONTENDERS; ulIndex++ )
+    {
+        xTaskCreate( prvContenderTask, "Contender", configMINIMAL_STACK_SIZE, ( void * ) xContended, 1U + ( ulIndex % 2U ), &( xContenders[ ulIndex ] ) );
+    }
+
+    vTaskDelay( pdMS_TO_TICKS( 1000 ) );
+    xStopContenders = pdTRUE;
+    vTaskDelay( pdMS_TO_TICKS( 100 ) );
+    dEnd = prvSeconds();
+
+    printf( "contended: %u take+give with blocking in %.2f s\n", ( unsigned ) ulContendedCount, dEnd - dStart );
+    configASSERT( xSemaphoreGetFastMutexHolder( xContended ) == NULL );
+
+    for( ulIndex = 0U; ulIndex < benchCONTENDERS; ulIndex++ )
+    {
+        vTaskDelete( xContenders[ ulIndex ] );
+    }
+
+    vSemaphoreDeleteFast( xContended );
+
+    printf( "done\n" );
+    exit( 0 );
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+    xTaskCreate( prvBenchmarkTask, "Benchmark", configMINIMAL_STACK_SIZE * 4, NULL, 3, NULL );
+    vTaskStartScheduler();
+
+    return 1;
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,313 @@
+/*
+ * FreeRTOS Kernel V10.6.2
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * Host benchmark of the reader-writer locks and sequence locks ( rwlock.c ) on
+ * the POSIX port.  See README.md for how to build and run it.
+ *
+ * - Checks inheritance towards the writer, time-outs, and that a writer that
+ *   was handed the lock keeps it before it runs.
+ * - Counts the reads and writes of 1 to 8 readers and one writer in half a
+ *   second, first with a reader-writer lock, then with a mutex.
+ * - Checks that a sequence lock reader sees consistent data.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <stdlib.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "rwlock.h"
+
+/* The size of the table that the writer updates and the readers check. */
+#define benchTABLE_SIZE     8
+
+/* The most readers that run at once. */
+#define benchMAX_READERS    8
+
+static RWLockHandle_t xRWLock = NULL;
+static SemaphoreHandle_t xMutex = NULL;
+static volatile uint32_t ulTable[ benchTABLE_SIZE ];
+static volatile uint32_t ulReads = 0U;
+static volatile uint32_t ulWrites = 0U;
+static volatile BaseType_t xUseRWLock = pdTRUE;
+static volatile BaseType_t xStopTasks = pdFALSE;
+static SeqLock_t xSeqLock = seqLOCK_INITIALISER;
+static volatile uint32_t ulSeqFirst = 0U;
+static volatile uint32_t ulSeqSecond = 0U;
+/*-----------------------------------------------------------*/
+
+static void prvReaderTask( void * pvParameters )
+{
+    uint32_t ulFirst;
+    volatile uint32_t ulDelay;
+    size_t uxIndex;
+
+    ( void ) pvParameters;
+
+    for( ; ; )
+    {
+        if( xStopTasks != pdFALSE )
+        {
+            vTaskSuspend( NULL );
+        }
+
+        if( xUseRWLock != pdFALSE )
+        {
+            configASSERT( xRWLockTakeRead( xRWLock, portMAX_DELAY ) == pdPASS );
+        }
+        else
+        {
+            configASSERT( xSemaphoreTake( xMutex, portMAX_DELAY ) == pdPASS );
+        }
+
+        ulFirst = ulTable[ 0 ];
+
+        for( uxIndex = 0U; uxIndex < benchTABLE_SIZE; uxIndex++ )
+        {
+            configASSERT( ulTable[ uxIndex ] == ulFirst );
+        }
+
+        /* Hold the lock for a while, like a real reader would. */
+        for( ulDelay = 0U; ulDelay < 2000U; ulDelay++ )
+        {
+        }
+
+        if( xUseRWLock != pdFALSE )
+        {
+            configASSERT( xRWLockGetWriter( xRWLock ) == NULL );
+            vRWLockGiveRead( xRWLock );
+        }
+        else
+        {
+            ( void ) xSemaphoreGive( xMutex );
+        }
+
+        ulReads++;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvWriterTask( void * pvParameters )
+{
+    size_t uxIndex;
+
+    ( void ) pvParameters;
+
+    for( ; ; )
+    {
+        if( xStopTasks != pdFALSE )
+        {
+            vTaskSuspend( NULL );
+        }
+
+        if( xUseRWLock != pdFALSE )
+        {
+            configASSERT( xRWLockTakeWrite( xRWLock, portMAX_DELAY ) == pdPASS );
+            configASSERT( uxRWLockGetReaderCount( xRWLock ) == 0U );
+        }
+        else
+        {
+            configASSERT( xSemaphoreTake( xMutex, portMAX_DELAY ) == pdPASS );
+        }
+
+        for( uxIndex = 0U; uxIndex < benchTABLE_SIZE; uxIndex++ )
+        {
+            ulTable[ uxIndex ]++;
+        }
+
+        if( xUseRWLock != pdFALSE )
+        {
+            configASSERT( xRWLockGiveWrite( xRWLock ) == pdPASS );
+        }
+        else
+        {
+            ( void ) xSemaphoreGive( xMutex );
+        }
+
+        ulWrites++;
+        vTaskDelay( 5 );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvLowPriorityWriterTask( void * pvParameters )
+{
+    ( void ) pvParameters;
+
+    configASSERT( xRWLockTakeWrite( xRWLock, 0 ) == pdPASS );
+    vTaskSuspend( NULL );
+
+    /* The benchmark task, at priority 4, waits for read access now. */
+    configASSERT( uxTaskPriorityGet( NULL ) == 4 );
+    configASSERT( xRWLockGiveWrite( xRWLock ) == pdPASS );
+    configASSERT( uxTaskPriorityGet( NULL ) == 1 );
+    vTaskSuspend( NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvHandedOverWriterTask( void * pvParameters )
+{
+    ( void ) pvParameters;
+
+    configASSERT( xRWLockTakeWrite( xRWLock, portMAX_DELAY ) == pdPASS );
+    configASSERT( xRWLockGiveWrite( xRWLock ) == pdPASS );
+    vTaskSuspend( NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckSemantics( void )
+{
+    TaskHandle_t xLowTask;
+    TaskHandle_t xWriterTask;
+
+    /* Inheritance towards the writer, and disinheritance after a time-out. */
+    xTaskCreate( prvLowPriorityWriterTask, "LowWriter", configMINIMAL_STACK_SIZE, NULL, 1, &xLowTask );
+    vTaskDelay( 5 );
+    configASSERT( xRWLockTakeRead( xRWLock, 3 ) == pdFAIL );
+    configASSERT( uxTaskPriorityGet( xLowTask ) == 1 );
+    vTaskResume( xLowTask );
+    configASSERT( xRWLockTakeRead( xRWLock, portMAX_DELAY ) == pdPASS );
+
+    /* Recursive reads, and a writer that times out. */
+    configASSERT( xRWLockTakeRead( xRWLock, 0 ) == pdPASS );
+    configASSERT( uxRWLockGetReaderCount( xRWLock ) == 2U );
+    configASSERT( xRWLockTakeWrite( xRWLock, 2 ) == pdFAIL );
+    vRWLockGiveRead( xRWLock );
+    vRWLockGiveRead( xRWLock );
+    configASSERT( xRWLockTakeWrite( xRWLock, 0 ) == pdPASS );
+    configASSERT( xRWLockGiveWrite( xRWLock ) == pdPASS );
+    configASSERT( xRWLockGiveWrite( xRWLock ) == pdFAIL );
+
+    /* The last reader hands the lock to the waiting writer, so a reader that
+     * comes before the writer runs must wait. */
+    configASSERT( xRWLockTakeRead( xRWLock, 0 ) == pdPASS );
+    xTaskCreate( prvHandedOverWriterTask, "Writer", configMINIMAL_STACK_SIZE, NULL, 3, &xWriterTask );
+    vTaskDelay( 2 );
+    vRWLockGiveRead( xRWLock );
+    configASSERT( xRWLockGetWriter( xRWLock ) == xWriterTask );
+    configASSERT( xRWLockTakeRead( xRWLock, 0 ) == pdFAIL );
+    configASSERT( xRWLockTakeRead( xRWLock, 5 ) == pdPASS );
+    vRWLockGiveRead( xRWLock );
+
+    vTaskDelete( xWriterTask );
+    vTaskDelete( xLowTask );
+    printf( "rwlock semantics ok\n" );
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckSeqLock( void )
+{
+    uint32_t ulIndex, ulSequence, ulFirst, ulSecond;
+
+    for( ulIndex = 0U; ulIndex < 1000U; ulIndex++ )
+    {
+        vSeqLockWriteBegin( &xSeqLock );
+        ulSeqFirst = ulIndex;
+        ulSeqSecond = ulIndex;
+        vSeqLockWriteEnd( &xSeqLock );
+
+        do
+        {
+            ulSequence = uxSeqLockReadBegin( &xSeqLock );
+            ulFirst = ulSeqFirst;
+            ulSecond = ulSeqSecond;
+        } while( xSeqLockReadRetry( &xSeqLock, ulSequence ) != pdFALSE );
+
+        configASSERT( ulFirst == ulSecond );
+    }
+
+    configASSERT( xSeqLock.uxSequence == 2000U );
+    printf( "seqlock ok\n" );
+}
+/*-----------------------------------------------------------*/
+
+static void prvBenchmarkTask( void * pvParameters )
+{
+    TaskHandle_t xTasks[ benchMAX_READERS + 1 ];
+    BaseType_t xMode, xReaders, xIndex;
+
+    ( void ) pvParameters;
+
+    xRWLock = xRWLockCreate();
+    xMutex = xSemaphoreCreateMutex();
+    configASSERT( ( xRWLock != NULL ) && ( xMutex != NULL ) );
+
+    prvCheckSemantics();
+
+    for( xMode = pdTRUE; xMode >= pdFALSE; xMode-- )
+    {
+        for( xReaders = 1; xReaders <= benchMAX_READERS; xReaders *= 2 )
+        {
+            xUseRWLock = xMode;
+            xStopTasks = pdFALSE;
+            ulReads = 0U;
+            ulWrites = 0U;
+
+            for( xIndex = 0; xIndex < xReaders; xIndex++ )
+            {
+                xTaskCreate( prvReaderTask, "Reader", configMINIMAL_STACK_SIZE, NULL, 2, &( xTasks[ xIndex ] ) );
+            }
+
+            xTaskCreate( prvWriterTask, "Writer", configMINIMAL_STACK_SIZE, NULL, 2, &( xTasks[ xReaders ] ) );
+
+            vTaskDelay( pdMS_TO_TICKS( 500 ) );
+            xStopTasks = pdTRUE;
+            vTaskDelay( pdMS_TO_TICKS( 50 ) );
+
+            printf( "%s readers=%d: %u reads, %u writes in 0.5 s\n",
+                    ( xMode != pdFALSE ) ? "rwlock" : "mutex ",
+                    ( int ) xReaders, ( unsigned ) ulReads, ( unsigned ) ulWrites );
+
+            for( xIndex = 0; xIndex <= xReaders; xIndex++ )
+            {
+                vTaskDelete( xTasks[ xIndex ] );
+            }
+
+            vTaskDelay( 10 );
+        }
+    }
+
+    prvCheckSeqLock();
+
+    printf( "done\n" );
+    exit( 0 );
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+    xTaskCreate( prvBenchmarkTask, "Benchmark", configMINIMAL_STACK_SIZE * 4, NULL, 4, NULL );
+    vTaskStartScheduler();
+
+    return 1;
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,254 @@
+/*
+ * FreeRTOS Kernel V10.6.2
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * Host benchmark of the work queues ( workqueue.c ) on the POSIX port.  See
+ * README.md for how to build and run it.
+ *
+ * - Submits six functions that block for 20 ticks, then a short one, through
+ *   xTimerPendFunctionCall(), and again to a work queue with four workers, and
+ *   prints after how many ticks the short one ran.
+ * - Checks delayed, cancelled and double submissions, and submission from an
+ *   interrupt, and prints the statistics of some work items.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <stdlib.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+#include "workqueue.h"
+
+/* The number of functions that block, and how long each one blocks. */
+#define benchBLOCKING_ITEMS    6
+#define benchBLOCK_TICKS       20
+
+/* The number of worker tasks of the work queue. */
+#define benchWORKERS           4
+
+static volatile TickType_t xQuickRanAt = 0U;
+static volatile TickType_t xDelayedRanAt = 0U;
+static volatile TickType_t xCancelledRanAt = 0U;
+/*-----------------------------------------------------------*/
+
+static void prvBlockingPended( void * pvParameter1,
+                               uint32_t ulParameter2 )
+{
+    ( void ) pvParameter1;
+    ( void ) ulParameter2;
+
+    vTaskDelay( benchBLOCK_TICKS );
+}
+/*-----------------------------------------------------------*/
+
+static void prvQuickPended( void * pvParameter1,
+                            uint32_t ulParameter2 )
+{
+    ( void ) pvParameter1;
+    ( void ) ulParameter2;
+
+    xQuickRanAt = xTaskGetTickCount();
+}
+/*-----------------------------------------------------------*/
+
+static void prvBlockingWork( void * pvParameter )
+{
+    ( void ) pvParameter;
+
+    vTaskDelay( benchBLOCK_TICKS );
+}
+/*-----------------------------------------------------------*/
+
+static void prvQuickWork( void * pvParameter )
+{
+    ( void ) pvParameter;
+
+    xQuickRanAt = xTaskGetTickCount();
+}
+/*-----------------------------------------------------------*/
+
+static void prvDelayedWork( void * pvParameter )
+{
+    ( void ) pvParameter;
+
+    xDelayedRanAt = xTaskGetTickCount();
+}
+/*-----------------------------------------------------------*/
+
+static void prvCancelledWork( void * pvParameter )
+{
+    ( void ) pvParameter;
+
+    xCancelledRanAt = xTaskGetTickCount();
+}
+/*-----------------------------------------------------------*/
+
+static void prvBusyWork( void * pvParameter )
+{
+    volatile uint32_t ulCount;
+
+    ( void ) pvParameter;
+
+    for( ulCount = 0U; ulCount < 50000000U; ulCount++ )
+    {
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvPrintStats( const char * pcName,
+                           WorkItemHandle_t xWorkItem )
+{
+    WorkItemStats_t xStats;
+
+    vWorkItemGetStats( xWorkItem, &xStats );
+    printf( "%s: runs %u, total time %u, max time %u, max latency %u ticks\n",
+            pcName,
+            ( unsigned ) xStats.ulRunCount,
+            ( unsigned ) xStats.ulTotalTime,
+            ( unsigned ) xStats.ulMaxTime,
+            ( unsigned ) xStats.xMaxLatency );
+}
+/*-----------------------------------------------------------*/
+
+static void prvBenchmarkTask( void * pvParameters )
+{
+    static StaticWorkItem_t xQuickBuffer;
+    WorkQueueHandle_t xWorkQueue;
+    WorkItemHandle_t xBlocking[ benchBLOCKING_ITEMS ];
+    WorkItemHandle_t xQuick, xDelayed, xCancelled, xBusy;
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    UBaseType_t uxSavedInterruptStatus;
+    TickType_t xStart;
+    BaseType_t xIndex;
+
+    ( void ) pvParameters;
+
+    /* The timer task runs the pended functions one after the other. */
+    xStart = xTaskGetTickCount();
+
+    for( xIndex = 0; xIndex < benchBLOCKING_ITEMS; xIndex++ )
+    {
+        configASSERT( xTimerPendFunctionCall( prvBlockingPended, NULL, 0U, portMAX_DELAY ) == pdPASS );
+    }
+
+    configASSERT( xTimerPendFunctionCall( prvQuickPended, NULL, 0U, portMAX_DELAY ) == pdPASS );
+    vTaskDelay( ( benchBLOCKING_ITEMS + 4 ) * benchBLOCK_TICKS );
+    printf( "timer task: the short function ran after %u ticks\n", ( unsigned ) ( xQuickRanAt - xStart ) );
+
+    /* The same functions on a work queue. */
+    xWorkQueue = xWorkQueueCreate( "Bench", benchWORKERS, configMINIMAL_STACK_SIZE, 4 );
+    configASSERT( xWorkQueue != NULL );
+
+    for( xIndex = 0; xIndex < benchBLOCKING_ITEMS; xIndex++ )
+    {
+        xBlocking[ xIndex ] = xWorkItemCreate( prvBlockingWork, NULL );
+        configASSERT( xBlocking[ xIndex ] != NULL );
+    }
+
+    xQuick = xWorkItemCreateStatic( prvQuickWork, NULL, &xQuickBuffer );
+    configASSERT( xQuick != NULL );
+    xStart = xTaskGetTickCount();
+
+    for( xIndex = 0; xIndex < benchBLOCKING_ITEMS; xIndex++ )
+    {
+        configASSERT( xWorkQueueSubmit( xWorkQueue, xBlocking[ xIndex ], 0U ) == pdPASS );
+    }
+
+    configASSERT( xWorkQueueSubmit( xWorkQueue, xQuick, 0U ) == pdPASS );
+    vTaskDelay( 5 * benchBLOCK_TICKS );
+    printf( "work queue, %d workers: the short item ran after %u ticks\n", benchWORKERS, ( unsigned ) ( xQuickRanAt - xStart ) );
+    prvPrintStats( "short item", xQuick );
+    prvPrintStats( "last blocking item", xBlocking[ benchBLOCKING_ITEMS - 1 ] );
+
+    /* A delayed item, one that is cancelled, and a double submission. */
+    xDelayed = xWorkItemCreate( prvDelayedWork, NULL );
+    xCancelled = xWorkItemCreate( prvCancelledWork, NULL );
+    configASSERT( ( xDelayed != NULL ) && ( xCancelled != NULL ) );
+    xStart = xTaskGetTickCount();
+    configASSERT( xWorkQueueSubmit( xWorkQueue, xDelayed, 50U ) == pdPASS );
+    configASSERT( xWorkQueueSubmit( xWorkQueue, xDelayed, 50U ) == pdFAIL );
+    configASSERT( xWorkQueueSubmit( xWorkQueue, xCancelled, 30U ) == pdPASS );
+    configASSERT( xWorkItemIsBusy( xCancelled ) == pdTRUE );
+    vTaskDelay( 10 );
+    configASSERT( xWorkItemCancel( xCancelled ) == pdTRUE );
+    configASSERT( xWorkItemCancel( xCancelled ) == pdFALSE );
+    vTaskDelay( 80 );
+    printf( "delayed item ran after %u ticks ( 50 asked ), cancelled item ran: %s\n",
+            ( unsigned ) ( xDelayedRanAt - xStart ),
+            ( xCancelledRanAt != 0U ) ? "yes" : "no" );
+    configASSERT( xCancelledRanAt == 0U );
+
+    /* Submission from an interrupt, simulated with a critical section. */
+    xQuickRanAt = 0U;
+    uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    configASSERT( xWorkQueueSubmitFromISR( xWorkQueue, xQuick, 0U, &xHigherPriorityTaskWoken ) == pdPASS );
+    taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+    portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+    vTaskDelay( 5 );
+    printf( "submitted from an interrupt: ran %s\n", ( xQuickRanAt != 0U ) ? "yes" : "no" );
+    configASSERT( xQuickRanAt != 0U );
+
+    /* The execution time of an item that keeps the CPU busy, in the units of the
+     * run time counter. */
+    xBusy = xWorkItemCreate( prvBusyWork, NULL );
+    configASSERT( xBusy != NULL );
+
+    for( xIndex = 0; xIndex < 5; xIndex++ )
+    {
+        configASSERT( xWorkQueueSubmit( xWorkQueue, xBusy, 0U ) == pdPASS );
+        vTaskDelay( 200 );
+    }
+
+    prvPrintStats( "busy item", xBusy );
+
+    for( xIndex = 0; xIndex < benchBLOCKING_ITEMS; xIndex++ )
+    {
+        vWorkItemDelete( xBlocking[ xIndex ] );
+    }
+
+    vWorkItemDelete( xQuick );
+    vWorkItemDelete( xDelayed );
+    vWorkItemDelete( xCancelled );
+    vWorkItemDelete( xBusy );
+
+    printf( "done\n" );
+    exit( 0 );
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+    xTaskCreate( prvBenchmarkTask, "Benchmark", configMINIMAL_STACK_SIZE * 2, NULL, 3, NULL );
+    vTaskStartScheduler();
+
+    return 1;
+}
+/*-----------------------------------------------------------*/
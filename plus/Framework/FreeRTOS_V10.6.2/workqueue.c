@@ -0,0 +1,618 @@
+/*
+ * FreeRTOS Kernel V10.6.2
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/* Standard includes. */
+#include <stdlib.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+ * all the API functions to use the MPU wrappers.  That should only be done when
+ * task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "workqueue.h"
+
+/* Lint e961, e750 and e9021 are suppressed as a MISRA exception justified
+ * because the MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined
+ * for the header files above, but not in this file, in order to generate the
+ * correct privileged Vs unprivileged linkage and placement. */
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE /*lint !e961 !e750 !e9021 See comment above. */
+
+/* The time base of the work item statistics, see WorkItemStats_t. */
+#if ( configGENERATE_RUN_TIME_STATS == 1 )
+    #define workqueueGET_TIME()    ulTaskGetCurrentRunTimeCounter()
+#else
+    #define workqueueGET_TIME()    ( ( configRUN_TIME_COUNTER_TYPE ) xTaskGetTickCount() )
+#endif
+
+typedef struct WorkItemDefinition
+{
+    ListItem_t xListItem;                    /**< Links the item into the pending or the delayed list of a work queue while it is submitted. */
+    WorkFunction_t pxFunction;               /**< The function that is called when the item runs. */
+    void * pvParameter;                      /**< The parameter passed to pxFunction. */
+    TickType_t xSubmitTime;                  /**< The tick count at which the item was submitted. */
+    TickType_t xDelay;                       /**< The number of ticks after xSubmitTime at which the item is due. */
+    UBaseType_t uxRunning;                   /**< The number of workers that are running the item. */
+    uint32_t ulRunCount;                     /**< See WorkItemStats_t. */
+    configRUN_TIME_COUNTER_TYPE ulTotalTime; /**< See WorkItemStats_t. */
+    configRUN_TIME_COUNTER_TYPE ulMaxTime;   /**< See WorkItemStats_t. */
+    TickType_t xMaxLatency;                  /**< See WorkItemStats_t. */
+
+    #if ( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
+        uint8_t ucStaticallyAllocated; /**< Set to pdTRUE if the item is statically allocated to ensure no attempt is made to free the memory. */
+    #endif
+} WorkItem_t;
+
+typedef struct WorkQueueDefinition
+{
+    List_t xPendingItems; /**< The items that are due, in the order in which they became due. */
+    List_t xDelayedItems; /**< The items that are not due yet, unsorted. */
+    List_t xIdleWorkers;  /**< The workers that are blocked waiting for an item. */
+} WorkQueue_t;
+
+/*-----------------------------------------------------------*/
+
+static void prvInitialiseWorkItem( WorkItem_t * pxWorkItem,
+                                   WorkFunction_t pxFunction,
+                                   void * pvParameter ) PRIVILEGED_FUNCTION;
+
+/*
+ * Add an item to a work queue and unblock an idle worker, which also makes an
+ * idle worker recalculate its block time when a delayed item was added.
+ * Returns pdFAIL if the item is already submitted.  Must be called from a
+ * critical section.
+ */
+static BaseType_t prvSubmit( WorkQueue_t * pxWorkQueue,
+                             WorkItem_t * pxWorkItem,
+                             TickType_t xDelay,
+                             BaseType_t * pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/*
+ * Move the delayed items that are due to the pending list.  Returns the number
+ * of ticks until the next delayed item is due, or portMAX_DELAY if there is
+ * none.  The delayed list is scanned, it is expected to be short.  Must be
+ * called from a critical section.
+ */
+static TickType_t prvCheckDelayedItems( WorkQueue_t * pxWorkQueue ) PRIVILEGED_FUNCTION;
+
+/*
+ * The task that runs the work items.  Every work queue has uxWorkers of them.
+ */
+static portTASK_FUNCTION_PROTO( prvWorkerTask, pvParameters ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+    WorkQueueHandle_t xWorkQueueCreate( const char * pcName,
+                                        UBaseType_t uxWorkers,
+                                        configSTACK_DEPTH_TYPE uxStackDepth,
+                                        UBaseType_t uxPriority ) /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+    {
+        WorkQueue_t * pxWorkQueue;
+        TaskHandle_t * pxWorkers;
+        UBaseType_t uxIndex;
+        BaseType_t xResult = pdPASS;
+
+        configASSERT( uxWorkers > ( UBaseType_t ) 0U );
+        configASSERT( uxPriority < ( UBaseType_t ) configMAX_PRIORITIES );
+
+        pxWorkQueue = ( WorkQueue_t * ) pvPortMalloc( sizeof( WorkQueue_t ) ); /*lint !e9087 !e9079 see comment above. */
+
+        /* The handles are only needed to clean up when a worker can not be
+         * created. */
+        pxWorkers = ( TaskHandle_t * ) pvPortMalloc( sizeof( TaskHandle_t ) * ( size_t ) uxWorkers ); /*lint !e9087 !e9079 see comment above. */
+
+        if( ( pxWorkQueue != NULL ) && ( pxWorkers != NULL ) )
+        {
+            vListInitialise( &( pxWorkQueue->xPendingItems ) );
+            vListInitialise( &( pxWorkQueue->xDelayedItems ) );
+            vListInitialise( &( pxWorkQueue->xIdleWorkers ) );
+
+            for( uxIndex = ( UBaseType_t ) 0U; uxIndex < uxWorkers; uxIndex++ )
+            {
+                xResult = xTaskCreate( prvWorkerTask, pcName, uxStackDepth, ( void * ) pxWorkQueue, uxPriority, &( pxWorkers[ uxIndex ] ) );
+
+                if( xResult != pdPASS )
+                {
+                    break;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+
+            if( xResult != pdPASS )
+            {
+                /* A worker that was created may be blocked on xIdleWorkers,
+                 * deleting it also removes it from that list. */
+                while( uxIndex > ( UBaseType_t ) 0U )
+                {
+                    uxIndex--;
+                    vTaskDelete( pxWorkers[ uxIndex ] );
+                }
+
+                vPortFree( pxWorkQueue );
+                pxWorkQueue = NULL;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            vPortFree( pxWorkQueue );
+            pxWorkQueue = NULL;
+        }
+
+        vPortFree( pxWorkers );
+
+        return pxWorkQueue;
+    }
+
+#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+static void prvInitialiseWorkItem( WorkItem_t * pxWorkItem,
+                                   WorkFunction_t pxFunction,
+                                   void * pvParameter )
+{
+    configASSERT( pxFunction );
+
+    vListInitialiseItem( &( pxWorkItem->xListItem ) );
+    listSET_LIST_ITEM_OWNER( &( pxWorkItem->xListItem ), pxWorkItem );
+    pxWorkItem->pxFunction = pxFunction;
+    pxWorkItem->pvParameter = pvParameter;
+    pxWorkItem->xSubmitTime = ( TickType_t ) 0U;
+    pxWorkItem->xDelay = ( TickType_t ) 0U;
+    pxWorkItem->uxRunning = ( UBaseType_t ) 0U;
+    pxWorkItem->ulRunCount = 0U;
+    pxWorkItem->ulTotalTime = ( configRUN_TIME_COUNTER_TYPE ) 0U;
+    pxWorkItem->ulMaxTime = ( configRUN_TIME_COUNTER_TYPE ) 0U;
+    pxWorkItem->xMaxLatency = ( TickType_t ) 0U;
+}
+/*-----------------------------------------------------------*/
+
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+
+    WorkItemHandle_t xWorkItemCreateStatic( WorkFunction_t pxFunction,
+                                            void * pvParameter,
+                                            StaticWorkItem_t * pxWorkItemBuffer )
+    {
+        WorkItem_t * pxWorkItem;
+
+        /* A StaticWorkItem_t object must be provided. */
+        configASSERT( pxWorkItemBuffer );
+
+        #if ( configASSERT_DEFINED == 1 )
+        {
+            /* Sanity check that the size of the structure used to declare a
+             * variable of type StaticWorkItem_t equals the size of the real
+             * work item structure. */
+            volatile size_t xSize = sizeof( StaticWorkItem_t );
+            configASSERT( xSize == sizeof( WorkItem_t ) );
+        } /*lint !e529 xSize is referenced if configASSERT() is defined. */
+        #endif /* configASSERT_DEFINED */
+
+        pxWorkItem = ( WorkItem_t * ) pxWorkItemBuffer; /*lint !e740 !e9087 WorkItem_t and StaticWorkItem_t are deliberately aliased for data hiding purposes and guaranteed to have the same size and alignment requirement - checked by configASSERT(). */
+
+        if( pxWorkItem != NULL )
+        {
+            prvInitialiseWorkItem( pxWorkItem, pxFunction, pvParameter );
+
+            #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+            {
+                /* Both static and dynamic allocation can be used, so note that
+                 * this item was created statically in case it is later
+                 * deleted. */
+                pxWorkItem->ucStaticallyAllocated = pdTRUE;
+            }
+            #endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return pxWorkItem;
+    }
+
+#endif /* configSUPPORT_STATIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+    WorkItemHandle_t xWorkItemCreate( WorkFunction_t pxFunction,
+                                      void * pvParameter )
+    {
+        WorkItem_t * pxWorkItem;
+
+        pxWorkItem = ( WorkItem_t * ) pvPortMalloc( sizeof( WorkItem_t ) ); /*lint !e9087 !e9079 see comment above. */
+
+        if( pxWorkItem != NULL )
+        {
+            prvInitialiseWorkItem( pxWorkItem, pxFunction, pvParameter );
+
+            #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+            {
+                /* Both static and dynamic allocation can be used, so note this
+                 * item was allocated dynamically in case it is later deleted. */
+                pxWorkItem->ucStaticallyAllocated = pdFALSE;
+            }
+            #endif /* configSUPPORT_STATIC_ALLOCATION */
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return pxWorkItem;
+    }
+
+#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+void vWorkItemDelete( WorkItemHandle_t xWorkItem )
+{
+    WorkItem_t * pxWorkItem = xWorkItem;
+
+    configASSERT( pxWorkItem );
+
+    /* The item must not be in use. */
+    configASSERT( xWorkItemIsBusy( pxWorkItem ) == pdFALSE );
+
+    #if ( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) )
+    {
+        /* The item can only have been allocated dynamically - free it
+         * again. */
+        vPortFree( pxWorkItem );
+    }
+    #elif ( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) )
+    {
+        /* The item could have been allocated statically or dynamically, so
+         * check before attempting to free the memory. */
+        if( pxWorkItem->ucStaticallyAllocated == ( uint8_t ) pdFALSE )
+        {
+            vPortFree( pxWorkItem );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    #else /* if ( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) ) */
+    {
+        ( void ) pxWorkItem;
+    }
+    #endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvSubmit( WorkQueue_t * pxWorkQueue,
+                             WorkItem_t * pxWorkItem,
+                             TickType_t xDelay,
+                             BaseType_t * pxHigherPriorityTaskWoken )
+{
+    BaseType_t xReturn;
+
+    if( listLIST_ITEM_CONTAINER( &( pxWorkItem->xListItem ) ) == NULL )
+    {
+        pxWorkItem->xSubmitTime = xTaskGetTickCountFromISR();
+        pxWorkItem->xDelay = xDelay;
+
+        if( xDelay == ( TickType_t ) 0U )
+        {
+            vListInsertEnd( &( pxWorkQueue->xPendingItems ), &( pxWorkItem->xListItem ) );
+        }
+        else
+        {
+            vListInsertEnd( &( pxWorkQueue->xDelayedItems ), &( pxWorkItem->xListItem ) );
+        }
+
+        if( listLIST_IS_EMPTY( &( pxWorkQueue->xIdleWorkers ) ) == pdFALSE )
+        {
+            if( xTaskRemoveFromEventList( &( pxWorkQueue->xIdleWorkers ) ) != pdFALSE )
+            {
+                *pxHigherPriorityTaskWoken = pdTRUE;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            /* All the workers are busy, the first one that becomes idle
+             * will find the item. */
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        xReturn = pdPASS;
+    }
+    else
+    {
+        xReturn = pdFAIL;
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xWorkQueueSubmit( WorkQueueHandle_t xWorkQueue,
+                             WorkItemHandle_t xWorkItem,
+                             TickType_t xDelay )
+{
+    BaseType_t xReturn;
+    BaseType_t xYieldRequired = pdFALSE;
+
+    configASSERT( xWorkQueue );
+    configASSERT( xWorkItem );
+
+    taskENTER_CRITICAL();
+    {
+        xReturn = prvSubmit( xWorkQueue, xWorkItem, xDelay, &xYieldRequired );
+    }
+    taskEXIT_CRITICAL();
+
+    if( xYieldRequired != pdFALSE )
+    {
+        taskYIELD();
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xWorkQueueSubmitFromISR( WorkQueueHandle_t xWorkQueue,
+                                    WorkItemHandle_t xWorkItem,
+                                    TickType_t xDelay,
+                                    BaseType_t * pxHigherPriorityTaskWoken )
+{
+    BaseType_t xReturn;
+    BaseType_t xTaskWoken = pdFALSE;
+    UBaseType_t uxSavedInterruptStatus;
+
+    configASSERT( xWorkQueue );
+    configASSERT( xWorkItem );
+
+    /* RTOS ports that support interrupt nesting have the concept of a maximum
+     * system call (or maximum API call) interrupt priority, see
+     * portASSERT_IF_INTERRUPT_PRIORITY_INVALID() in queue.c. */
+    portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+    uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    {
+        xReturn = prvSubmit( xWorkQueue, xWorkItem, xDelay, &xTaskWoken );
+    }
+    taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+    if( ( xTaskWoken != pdFALSE ) && ( pxHigherPriorityTaskWoken != NULL ) )
+    {
+        *pxHigherPriorityTaskWoken = pdTRUE;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xWorkItemCancel( WorkItemHandle_t xWorkItem )
+{
+    WorkItem_t * const pxWorkItem = xWorkItem;
+    BaseType_t xReturn;
+
+    configASSERT( pxWorkItem );
+
+    taskENTER_CRITICAL();
+    {
+        if( listLIST_ITEM_CONTAINER( &( pxWorkItem->xListItem ) ) != NULL )
+        {
+            ( void ) uxListRemove( &( pxWorkItem->xListItem ) );
+            xReturn = pdTRUE;
+        }
+        else
+        {
+            xReturn = pdFALSE;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xWorkItemIsBusy( WorkItemHandle_t xWorkItem )
+{
+    const WorkItem_t * const pxWorkItem = xWorkItem;
+    BaseType_t xReturn;
+
+    configASSERT( pxWorkItem );
+
+    taskENTER_CRITICAL();
+    {
+        if( ( listLIST_ITEM_CONTAINER( &( pxWorkItem->xListItem ) ) != NULL ) ||
+            ( pxWorkItem->uxRunning != ( UBaseType_t ) 0U ) )
+        {
+            xReturn = pdTRUE;
+        }
+        else
+        {
+            xReturn = pdFALSE;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vWorkItemGetStats( WorkItemHandle_t xWorkItem,
+                        WorkItemStats_t * pxStats )
+{
+    const WorkItem_t * const pxWorkItem = xWorkItem;
+
+    configASSERT( pxWorkItem );
+    configASSERT( pxStats );
+
+    taskENTER_CRITICAL();
+    {
+        pxStats->ulRunCount = pxWorkItem->ulRunCount;
+        pxStats->ulTotalTime = pxWorkItem->ulTotalTime;
+        pxStats->ulMaxTime = pxWorkItem->ulMaxTime;
+        pxStats->xMaxLatency = pxWorkItem->xMaxLatency;
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+static TickType_t prvCheckDelayedItems( WorkQueue_t * pxWorkQueue )
+{
+    const TickType_t xNow = xTaskGetTickCount();
+    TickType_t xNextDue = portMAX_DELAY;
+    TickType_t xElapsed;
+    ListItem_t * pxIterator;
+    ListItem_t * pxNext;
+    WorkItem_t * pxWorkItem;
+    const ListItem_t * const pxEnd = listGET_END_MARKER( &( pxWorkQueue->xDelayedItems ) );
+
+    for( pxIterator = listGET_HEAD_ENTRY( &( pxWorkQueue->xDelayedItems ) ); pxIterator != pxEnd; pxIterator = pxNext )
+    {
+        pxNext = listGET_NEXT( pxIterator );
+        pxWorkItem = ( WorkItem_t * ) listGET_LIST_ITEM_OWNER( pxIterator ); /*lint !e9087 !e9079 void * is used as the owner of list items. */
+
+        /* Unsigned arithmetic keeps this correct when the tick count
+         * overflows. */
+        xElapsed = xNow - pxWorkItem->xSubmitTime;
+
+        if( xElapsed >= pxWorkItem->xDelay )
+        {
+            ( void ) uxListRemove( pxIterator );
+            vListInsertEnd( &( pxWorkQueue->xPendingItems ), pxIterator );
+        }
+        else if( ( pxWorkItem->xDelay - xElapsed ) < xNextDue )
+        {
+            xNextDue = pxWorkItem->xDelay - xElapsed;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+
+    return xNextDue;
+}
+/*-----------------------------------------------------------*/
+
+static portTASK_FUNCTION( prvWorkerTask, pvParameters )
+{
+    WorkQueue_t * const pxWorkQueue = ( WorkQueue_t * ) pvParameters;
+    WorkItem_t * pxWorkItem;
+    TickType_t xTicksToWait;
+    TickType_t xLatency;
+    configRUN_TIME_COUNTER_TYPE ulStart;
+    configRUN_TIME_COUNTER_TYPE ulTime;
+
+    for( ; ; )
+    {
+        pxWorkItem = NULL;
+
+        taskENTER_CRITICAL();
+        {
+            xTicksToWait = prvCheckDelayedItems( pxWorkQueue );
+
+            if( listLIST_IS_EMPTY( &( pxWorkQueue->xPendingItems ) ) == pdFALSE )
+            {
+                pxWorkItem = ( WorkItem_t * ) listGET_OWNER_OF_HEAD_ENTRY( &( pxWorkQueue->xPendingItems ) ); /*lint !e9087 !e9079 void * is used as the owner of list items. */
+                ( void ) uxListRemove( &( pxWorkItem->xListItem ) );
+                ( pxWorkItem->uxRunning )++;
+
+                xLatency = ( xTaskGetTickCount() - pxWorkItem->xSubmitTime ) - pxWorkItem->xDelay;
+
+                if( xLatency > pxWorkItem->xMaxLatency )
+                {
+                    pxWorkItem->xMaxLatency = xLatency;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                /* Wait until an item is submitted or the next delayed item is
+                 * due.  All ports are written to allow a yield in a critical
+                 * section (some will yield immediately, others wait until the
+                 * critical section exits) - but it is not something that
+                 * application code should ever do. */
+                vTaskPlaceOnEventList( &( pxWorkQueue->xIdleWorkers ), xTicksToWait );
+                portYIELD_WITHIN_API();
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        if( pxWorkItem != NULL )
+        {
+            ulStart = workqueueGET_TIME();
+            pxWorkItem->pxFunction( pxWorkItem->pvParameter );
+            ulTime = workqueueGET_TIME() - ulStart;
+
+            taskENTER_CRITICAL();
+            {
+                ( pxWorkItem->uxRunning )--;
+                ( pxWorkItem->ulRunCount )++;
+                pxWorkItem->ulTotalTime += ulTime;
+
+                if( ulTime > pxWorkItem->ulMaxTime )
+                {
+                    pxWorkItem->ulMaxTime = ulTime;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            taskEXIT_CRITICAL();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+}
+/*-----------------------------------------------------------*/
@@ -340,6 +340,7 @@ ifeq ($(ipconfigUSE_HTTP),true)
 
 	C_SRCS += \
 		$(PROTOCOLS_PATH)/Common/FreeRTOS_TCP_server.c \
+		$(PROTOCOLS_PATH)/Common/FreeRTOS_server_utils.c \
 		$(PROTOCOLS_PATH)/HTTP/FreeRTOS_HTTP_server.c \
 		$(PROTOCOLS_PATH)/HTTP/FreeRTOS_HTTP_commands.c \
 		$(PROTOCOLS_PATH)/FTP/FreeRTOS_FTP_server.c \